@@ -13,6 +13,7 @@
 #include <shogun/features/HashedDocDotFeatures.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/lib/NGramTokenizer.h>
+#include <shogun/lib/SGStringList.h>
 #include <shogun/mathematics/Math.h>
 
 using namespace shogun;
@@ -50,6 +51,14 @@ int main(int argv, char** argc)
 		CHashedDocDotFeatures* feats = new CHashedDocDotFeatures(b, string_feats, tzer);
 		feats->benchmark_dense_dot_range();
 		feats->benchmark_add_to_dense_vector();
+
+		SG_SPRINT("Hashing the documents once\n");
+		feats->precompute_hashes();
+		SG_SPRINT("Precomputed representation takes %lld bytes\n",
+				(long long int) feats->get_precomputed_bytes());
+		feats->benchmark_dense_dot_range();
+		feats->benchmark_add_to_dense_vector();
+		SG_UNREF(feats);
 	}
 	exit_shogun();
 }
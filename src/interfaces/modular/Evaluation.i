@@ -29,6 +29,7 @@
 %rename(MeanSquaredLogError) CMeanSquaredLogError;
 %rename(ROCEvaluation) CROCEvaluation;
 %rename(PRCEvaluation) CPRCEvaluation;
+%rename(AUCAccumulator) CAUCAccumulator;
 %rename(AccuracyMeasure) CAccuracyMeasure;
 %rename(ErrorRateMeasure) CErrorRateMeasure;
 %rename(BALMeasure) CBALMeasure;
@@ -68,6 +69,7 @@
 %include <shogun/evaluation/MeanSquaredLogError.h>
 %include <shogun/evaluation/ROCEvaluation.h>
 %include <shogun/evaluation/PRCEvaluation.h>
+%include <shogun/evaluation/AUCAccumulator.h>
 %include <shogun/evaluation/MachineEvaluation.h>
 %include <shogun/evaluation/CrossValidation.h>
 %include <shogun/evaluation/SplittingStrategy.h>
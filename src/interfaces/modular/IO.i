@@ -18,6 +18,7 @@
 %rename(StreamingAsciiFile) CStreamingAsciiFile;
 %rename(StreamingVwFile) CStreamingVwFile;
 %rename(StreamingVwCacheFile) CStreamingVwCacheFile;
+%rename(StreamingChunkedFile) CStreamingChunkedFile;
 %rename(StreamingFileFromFeatures) CStreamingFileFromFeatures;
 %rename(BinaryFile) CBinaryFile;
 %rename(HDF5File) CHDF5File;
@@ -126,6 +127,21 @@ namespace shogun
 %include <shogun/io/streaming/StreamingVwCacheFile.h>
 %include <shogun/io/BinaryFile.h>
 %include <shogun/io/HDF5File.h>
+%include <shogun/io/streaming/StreamingChunkedFile.h>
+
+/* Template Class StreamingHDF5File */
+%include <shogun/io/streaming/StreamingHDF5File.h>
+#ifdef HAVE_HDF5
+namespace shogun
+{
+#ifdef USE_FLOAT32
+    %template(StreamingHDF5ShortRealFile) CStreamingHDF5File<float32_t>;
+#endif
+#ifdef USE_FLOAT64
+    %template(StreamingHDF5RealFile) CStreamingHDF5File<float64_t>;
+#endif
+}
+#endif
 %include <shogun/io/SerializableFile.h>
 %include <shogun/io/SerializableAsciiFile.h>
 %include <shogun/io/SerializableHdf5File.h>
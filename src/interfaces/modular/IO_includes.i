@@ -15,6 +15,8 @@
 #include <shogun/io/streaming/StreamingVwCacheFile.h>
 #include <shogun/io/BinaryFile.h>
 #include <shogun/io/HDF5File.h>
+#include <shogun/io/streaming/StreamingChunkedFile.h>
+#include <shogun/io/streaming/StreamingHDF5File.h>
 #include <shogun/io/SerializableFile.h>
 #include <shogun/io/SerializableAsciiFile.h>
 #include <shogun/io/SerializableHdf5File.h>
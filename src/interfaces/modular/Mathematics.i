@@ -67,6 +67,20 @@ namespace shogun
 #endif
 }
 
+/* Preconditioners */
+%include <shogun/mathematics/linalg/linop/JacobiPreconditioner.h>
+namespace shogun
+{
+#ifdef USE_FLOAT64
+    %template(RealJacobiPreconditioner) CJacobiPreconditioner<float64_t>;
+#endif
+#ifdef USE_COMPLEX128
+    %template(ComplexJacobiPreconditioner) CJacobiPreconditioner<complex128_t>;
+#endif
+}
+
+%rename(IncompleteCholeskyPreconditioner) CIncompleteCholeskyPreconditioner;
+
 /* Operator functions */
 %include <shogun/mathematics/linalg/ratapprox/opfunc/OperatorFunction.h>
 namespace shogun
@@ -123,6 +137,7 @@ namespace shogun
 
 %rename(EigenSolver) CEigenSolver;
 %rename(LanczosEigenSolver) CLanczosEigenSolver;
+%rename(BlockLanczosEigenSolver) CBlockLanczosEigenSolver;
 
 %rename(LogDetEstimator) CLogDetEstimator;
 #endif // HAVE_EIGEN3
@@ -141,6 +156,8 @@ namespace shogun
 %include <shogun/mathematics/linalg/linop/MatrixOperator.h>
 %include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
 %include <shogun/mathematics/linalg/linop/DenseMatrixOperator.h>
+%include <shogun/mathematics/linalg/linop/JacobiPreconditioner.h>
+%include <shogun/mathematics/linalg/linop/IncompleteCholeskyPreconditioner.h>
 
 %include <shogun/mathematics/linalg/ratapprox/opfunc/OperatorFunction.h>
 %include <shogun/mathematics/linalg/ratapprox/opfunc/RationalApproximation.h>
@@ -158,5 +175,6 @@ namespace shogun
 
 %include <shogun/mathematics/linalg/eigsolver/EigenSolver.h>
 %include <shogun/mathematics/linalg/eigsolver/LanczosEigenSolver.h>
+%include <shogun/mathematics/linalg/eigsolver/BlockLanczosEigenSolver.h>
 
 %include <shogun/mathematics/linalg/ratapprox/logdet/LogDetEstimator.h>
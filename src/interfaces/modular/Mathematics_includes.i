@@ -12,6 +12,8 @@
 #include <shogun/mathematics/linalg/linop/MatrixOperator.h>
 #include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
 #include <shogun/mathematics/linalg/linop/DenseMatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/JacobiPreconditioner.h>
+#include <shogun/mathematics/linalg/linop/IncompleteCholeskyPreconditioner.h>
 
 #include <shogun/mathematics/linalg/ratapprox/opfunc/OperatorFunction.h>
 #include <shogun/mathematics/linalg/ratapprox/opfunc/RationalApproximation.h>
@@ -29,6 +31,7 @@
 
 #include <shogun/mathematics/linalg/eigsolver/EigenSolver.h>
 #include <shogun/mathematics/linalg/eigsolver/LanczosEigenSolver.h>
+#include <shogun/mathematics/linalg/eigsolver/BlockLanczosEigenSolver.h>
 
 #include <shogun/mathematics/linalg/ratapprox/logdet/LogDetEstimator.h>
 %}
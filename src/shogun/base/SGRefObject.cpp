@@ -30,8 +30,9 @@ SGRefObject::SGRefObject()
 SGRefObject::SGRefObject(const SGRefObject& orig)
 {
 	init();
-	m_refcount = orig.m_refcount;
-	SG_REF(this);
+	m_refcount = new RefCount(0);
+
+	SG_SGCDEBUG("SGRefObject copied (%p)\n", this)
 }
 
 SGRefObject::~SGRefObject()
@@ -45,14 +46,14 @@ int32_t SGRefObject::ref()
 {
 	int32_t count = m_refcount->ref();
 	SG_SGCDEBUG("ref() refcount %ld obj %s (%p) increased\n", count, this->get_name(), this)
-	return m_refcount->ref_count();
+	return count;
 }
 
 int32_t SGRefObject::ref_count()
 {
 	int32_t count = m_refcount->ref_count();
 	SG_SGCDEBUG("ref_count(): refcount %d, obj %s (%p)\n", count, this->get_name(), this)
-	return m_refcount->ref_count();
+	return count;
 }
 
 int32_t SGRefObject::unref()
@@ -67,7 +68,7 @@ int32_t SGRefObject::unref()
 	else
 	{
 		SG_SGCDEBUG("unref() refcount %ld obj %s (%p) decreased\n", count, this->get_name(), this)
-		return m_refcount->ref_count();
+		return count;
 	}
 }
 #endif //USE_REFERENCE_COUNTING
@@ -49,7 +49,8 @@ public:
 	/** default constructor */
 	SGRefObject();
 
-	/** copy constructor */
+	/** copy constructor, the copy has its own reference count (starting
+	 * at 0 as for new objects) */
 	SGRefObject(const SGRefObject& orig);
 
 	/** destructor */
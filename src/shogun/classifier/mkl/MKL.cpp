@@ -15,6 +15,7 @@
 #include <shogun/classifier/mkl/MKL.h>
 #include <shogun/classifier/svm/LibSVM.h>
 #include <shogun/kernel/CombinedKernel.h>
+#include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
 
 using namespace shogun;
 
@@ -586,10 +587,25 @@ void CMKL::elasticnet_dual(float64_t *ff, float64_t *gg, float64_t *hh,
 	}
 }
 
+SGVector<float64_t> CMKL::compute_subkernel_quadratic_forms()
+{
+	int32_t n=get_num_support_vectors();
+	SGVector<int32_t> sv_idx(n);
+	SGVector<float64_t> sv_alpha(n);
+
+	for (int32_t i=0; i<n; i++)
+	{
+		sv_idx[i]=get_support_vector(i);
+		sv_alpha[i]=get_alpha(i);
+	}
+
+	return ((CCombinedKernel*) kernel)->compute_subkernel_quadratic_forms(n,
+			sv_idx.vector, sv_alpha.vector);
+}
+
 // assumes that all constraints are satisfied
 float64_t CMKL::compute_elasticnet_dual_objective()
 {
-	int32_t n=get_num_support_vectors();
 	int32_t num_kernels = kernel->get_num_subkernels();
 	float64_t mkl_obj=0;
 
@@ -599,30 +615,15 @@ float64_t CMKL::compute_elasticnet_dual_objective()
 		float64_t* nm = SG_MALLOC(float64_t, num_kernels);
 		float64_t del=0;
 
+		SGVector<float64_t> sums=compute_subkernel_quadratic_forms();
 
-		int32_t k=0;
-		for (index_t k_idx=0; k_idx<((CCombinedKernel*) kernel)->get_num_kernels(); k_idx++)
+		int32_t k;
+		for (k=0; k<sums.vlen; k++)
 		{
-			CKernel* kn = ((CCombinedKernel*) kernel)->get_kernel(k_idx);
-			float64_t sum=0;
-			for (int32_t i=0; i<n; i++)
-			{
-				int32_t ii=get_support_vector(i);
-
-				for (int32_t j=0; j<n; j++)
-				{
-					int32_t jj=get_support_vector(j);
-					sum+=get_alpha(i)*get_alpha(j)*kn->kernel(ii,jj);
-				}
-			}
-			nm[k]= CMath::pow(sum, 0.5);
+			nm[k]= CMath::pow(sums[k], 0.5);
 			del = CMath::max(del, nm[k]);
 
 			// SG_PRINT("nm[%d]=%f\n",k,nm[k])
-			k++;
-
-
-			SG_UNREF(kn);
 		}
 		// initial delta
 		del = del/CMath::sqrt(2*(1-ent_lambda));
@@ -1495,6 +1496,35 @@ void CMKL::compute_sum_beta(float64_t* sumw)
 		sumw[i]=0;
 	}
 
+	/* all subkernels at once, unless the weights are appended or the
+	 * combined kernel has a normalizer of its own */
+	if (kernel->get_kernel_type()==K_COMBINED &&
+			!((CCombinedKernel*) kernel)->get_append_subkernel_weights())
+	{
+		CKernelNormalizer* n=kernel->get_normalizer();
+		bool identity=dynamic_cast<CIdentityKernelNormalizer*>(n)!=NULL;
+		SG_UNREF(n);
+
+		if (identity)
+		{
+			SGVector<int32_t> sv_idx(nsv);
+			SGVector<float64_t> sv_alpha(nsv);
+			for (int32_t i=0; i<nsv; i++)
+			{
+				sv_idx[i]=svm->get_support_vector(i);
+				sv_alpha[i]=svm->get_alpha(i);
+			}
+
+			SGVector<float64_t> forms=((CCombinedKernel*) kernel)->
+				compute_subkernel_quadratic_forms(nsv, sv_idx.vector, sv_alpha.vector);
+			for (int32_t i=0; i<num_kernels; i++)
+				sumw[i]=0.5*forms[i];
+
+			mkl_iterations++;
+			return;
+		}
+	}
+
 	for (int32_t n=0; n<num_kernels; n++)
 	{
 		beta.vector[n]=1.0;
@@ -1529,32 +1559,20 @@ float64_t CMKL::compute_mkl_dual_objective()
 		return compute_elasticnet_dual_objective();
 	}
 
-	int32_t n=get_num_support_vectors();
 	float64_t mkl_obj=0;
 
 	if (m_labels && kernel && kernel->get_kernel_type() == K_COMBINED)
 	{
-		for (index_t k_idx=0; k_idx<((CCombinedKernel*) kernel)->get_num_kernels(); k_idx++)
-		{
-			CKernel* kn = ((CCombinedKernel*) kernel)->get_kernel(k_idx);
-			float64_t sum=0;
-			for (int32_t i=0; i<n; i++)
-			{
-				int32_t ii=get_support_vector(i);
+		SGVector<float64_t> sums=compute_subkernel_quadratic_forms();
 
-				for (int32_t j=0; j<n; j++)
-				{
-					int32_t jj=get_support_vector(j);
-					sum+=get_alpha(i)*get_alpha(j)*kn->kernel(ii,jj);
-				}
-			}
+		for (int32_t k=0; k<sums.vlen; k++)
+		{
+			float64_t sum=sums[k];
 
 			if (mkl_norm==1.0)
 				mkl_obj = CMath::max(mkl_obj, sum);
 			else
 				mkl_obj += CMath::pow(sum, mkl_norm/(mkl_norm-1));
-
-			SG_UNREF(kn);
 		}
 
 		if (mkl_norm==1.0)
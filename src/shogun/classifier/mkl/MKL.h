@@ -202,6 +202,13 @@ class CMKL : public CSVM
 		 */
 		float64_t compute_elasticnet_dual_objective();
 
+		/** compute alpha'*K_j*alpha over the support vectors for each
+		 * kernel j of the combined kernel in one fused pass
+		 *
+		 * @return vector holding the value for each kernel
+		 */
+		SGVector<float64_t> compute_subkernel_quadratic_forms();
+
 		/** set mkl epsilon (optimization accuracy for kernel weights)
 		 *
 		 * @param eps new weight_epsilon
@@ -240,9 +240,37 @@ void CMKLMulticlass::addingweightsstep( const std::vector<float64_t> &
 
 
 	normweightssquared.resize(numkernels);
-	for (int32_t ind=0; ind < numkernels; ++ind )
+	CCombinedKernel* ker=dynamic_cast<CCombinedKernel *>(m_kernel);
+	if (numkernels==ker->get_num_kernels())
 	{
-		normweightssquared[ind]=getsquarenormofprimalcoefficients( ind );
+		// all kernels in one fused pass per class
+		std::fill(normweightssquared.begin(), normweightssquared.end(), 0.0);
+		for (int32_t classindex=0; classindex< ((CMulticlassLabels*) m_labels)->get_num_classes();
+				++classindex)
+		{
+			CSVM * sm=svm->get_svm(classindex);
+			int32_t nsv=sm->get_num_support_vectors();
+			SGVector<int32_t> svind(nsv);
+			SGVector<float64_t> alphas(nsv);
+			for (int32_t i=0; i < nsv; ++i)
+			{
+				svind[i]=sm->get_support_vector(i);
+				alphas[i]=sm->get_alpha(i);
+			}
+			SG_UNREF(sm);
+
+			SGVector<float64_t> forms=ker->compute_subkernel_quadratic_forms(
+					nsv, svind.vector, alphas.vector);
+			for (int32_t ind=0; ind < numkernels; ++ind)
+				normweightssquared[ind]+=forms[ind];
+		}
+	}
+	else
+	{
+		for (int32_t ind=0; ind < numkernels; ++ind )
+		{
+			normweightssquared[ind]=getsquarenormofprimalcoefficients( ind );
+		}
 	}
 
 	lpw->addconstraint(normweightssquared,sumofsignfreealphas);
@@ -200,11 +200,12 @@ int CSVMOcas::add_new_cut(
 	float64_t* new_a = o->tmp_a_buf;
 	memset(new_a, 0, sizeof(float64_t)*nDim);
 
-	for(i=0; i < cut_length; i++)
-	{
-		f->add_to_dense_vec(y[new_cut[i]], new_cut[i], new_a, nDim);
+	/* accumulated in parallel, one dense buffer per thread */
+	f->add_to_dense_vec_subset((int32_t*) new_cut, cut_length, y, new_a, nDim);
 
-		if (o->use_bias)
+	if (o->use_bias)
+	{
+		for(i=0; i < cut_length; i++)
 			c_bias[nSel]+=y[new_cut[i]];
 	}
 
@@ -241,13 +242,15 @@ int CSVMOcas::add_new_cut(
 
 	new_col_H[nSel] = sq_norm_a;
 
-	for(i=0; i < nSel; i++)
+	/* products with the previous cuts are independent of each other */
+	#pragma omp parallel for num_threads(o->parallel->get_num_threads()) schedule(dynamic, 16)
+	for(int32_t k=0; k < (int32_t) nSel; k++)
 	{
-		float64_t tmp = c_bias[nSel]*c_bias[i];
-		for(j=0; j < c_nzd[i]; j++)
-			tmp += new_a[c_idx[i][j]]*c_val[i][j];
+		float64_t tmp = c_bias[nSel]*c_bias[k];
+		for(uint32_t l=0; l < c_nzd[k]; l++)
+			tmp += new_a[c_idx[k][l]]*c_val[k][l];
 
-		new_col_H[i] = tmp;
+		new_col_H[k] = tmp;
 	}
 	//CMath::display_vector(new_col_H, nSel+1, "new_col_H");
 	//CMath::display_vector((int32_t*) c_idx[nSel], (int32_t) nz_dims, "c_idx");
@@ -424,8 +424,9 @@ int CWDSVMOcas::add_new_cut(
 	}
 
 	// insert new_a into the last column of sparse_A
-	for(i=0; i < nSel; i++)
-		new_col_H[i] = SGVector<float32_t>::dot(new_a, cuts[i], nDim) + c_bias[nSel]*c_bias[i];
+	#pragma omp parallel for num_threads(o->parallel->get_num_threads())
+	for(int32_t k=0; k < (int32_t) nSel; k++)
+		new_col_H[k] = SGVector<float32_t>::dot(new_a, cuts[k], nDim) + c_bias[nSel]*c_bias[k];
 	new_col_H[nSel] = SGVector<float32_t>::dot(new_a, new_a, nDim) + CMath::sq(c_bias[nSel]);
 
 	cuts[nSel]=new_a;
@@ -624,14 +625,26 @@ void CWDSVMOcas::compute_W(
 	float64_t old_bias=o->bias;
 	float64_t bias=0;
 
-	for (uint32_t i=0; i<nSel; i++)
+	// W is split into blocks, every block sweeps over all the cuts
+	const int32_t block_size = 4096;
+	const int32_t num_blocks = (nDim+block_size-1)/block_size;
+
+	#pragma omp parallel for num_threads(o->parallel->get_num_threads())
+	for (int32_t b=0; b<num_blocks; b++)
 	{
-		if (alpha[i] > 0)
-			SGVector<float32_t>::vec1_plus_scalar_times_vec2(W, (float32_t) alpha[i], cuts[i], nDim);
+		int32_t start = b*block_size;
+		int32_t len = CMath::min(block_size, (int32_t) nDim-start);
 
-		bias += c_bias[i]*alpha[i];
+		for (uint32_t i=0; i<nSel; i++)
+		{
+			if (alpha[i] > 0)
+				SGVector<float32_t>::vec1_plus_scalar_times_vec2(&W[start], (float32_t) alpha[i], &cuts[i][start], len);
+		}
 	}
 
+	for (uint32_t i=0; i<nSel; i++)
+		bias += c_bias[i]*alpha[i];
+
 	*sq_norm_W = SGVector<float32_t>::dot(W,W, nDim) +CMath::sq(bias);
 	*dp_WoldW = SGVector<float32_t>::dot(W,oldW, nDim) + bias*old_bias;;
 	//SG_PRINT("nSel=%d sq_norm_W=%f dp_WoldW=%f\n", nSel, *sq_norm_W, *dp_WoldW)
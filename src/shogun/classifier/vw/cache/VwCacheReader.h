@@ -25,11 +25,13 @@ namespace shogun
 {
 
 /// Enum EVwCacheType specifies the type of
-/// cache used, either C_NATIVE or C_PROTOBUF.
+/// cache used, either C_NATIVE, C_PROTOBUF or C_MMAP.
+/// C_MMAP caches are memory-mapped and read without copying.
 enum EVwCacheType
 {
 	C_NATIVE = 0,
-	C_PROTOBUF = 1
+	C_PROTOBUF = 1,
+	C_MMAP = 2
 };
 
 /** @brief Base class from which all cache readers for VW
@@ -0,0 +1,191 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Copyright (C) 2011 Berlin Institute of Technology and Max-Planck-Society.
+ */
+
+#include <shogun/classifier/vw/cache/VwMmapCacheReader.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace shogun;
+
+CVwMmapCacheReader::CVwMmapCacheReader()
+	: CVwCacheReader()
+{
+	init();
+}
+
+CVwMmapCacheReader::CVwMmapCacheReader(char * fname, CVwEnvironment* env_to_use)
+	: CVwCacheReader(fname, env_to_use)
+{
+	init();
+	check_cache_metadata();
+}
+
+CVwMmapCacheReader::CVwMmapCacheReader(int32_t f, CVwEnvironment* env_to_use)
+	: CVwCacheReader(f, env_to_use)
+{
+	init();
+	check_cache_metadata();
+}
+
+CVwMmapCacheReader::~CVwMmapCacheReader()
+{
+	unmap_file();
+}
+
+void CVwMmapCacheReader::set_file(int32_t f)
+{
+	unmap_file();
+
+	fd = f;
+	check_cache_metadata();
+}
+
+void CVwMmapCacheReader::init()
+{
+	map_begin = NULL;
+	map_end = NULL;
+	cursor = NULL;
+}
+
+void CVwMmapCacheReader::map_file()
+{
+	struct stat st;
+	if (fstat(fd, &st) < 0)
+		SG_SERROR("Could not determine size of cache file!\n")
+
+	if (st.st_size == 0)
+		SG_SERROR("Cache file is empty!\n")
+
+	// Private and writable, so that in-place changes to the
+	// features are copy-on-write and never reach the file
+	void* p = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if (p == MAP_FAILED)
+		SG_SERROR("Could not memory-map the cache file!\n")
+
+	madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+	map_begin = (char*) p;
+	map_end = map_begin + st.st_size;
+	cursor = map_begin;
+}
+
+void CVwMmapCacheReader::unmap_file()
+{
+	if (map_begin)
+		munmap(map_begin, map_end - map_begin);
+
+	init();
+}
+
+void CVwMmapCacheReader::check_cache_metadata()
+{
+	// Remapping discards pages modified during the last pass
+	unmap_file();
+	map_file();
+
+	const char* vw_version = env->vw_version;
+	vw_size_t numbits = env->num_bits;
+
+	char* c = cursor;
+	if (map_end - c < (ptrdiff_t) (sizeof(uint32_t) + sizeof(vw_size_t)))
+		SG_SERROR("Cache file is truncated!\n")
+
+	if (*(uint32_t*)c != vw_mmap_cache_magic)
+		SG_SERROR("Not a memory-mappable VW cache file!\n")
+	c += sizeof(uint32_t);
+
+	vw_size_t v_length = *(vw_size_t*)c;
+	c += sizeof(vw_size_t);
+	if (v_length > 29)
+		SG_SERROR("Cache version too long, cache file is probably invalid.\n")
+
+	if (map_end - c < (ptrdiff_t) (v_length + sizeof(vw_size_t)))
+		SG_SERROR("Cache file is truncated!\n")
+
+	if (strncmp(c, vw_version, v_length) != 0)
+		SG_SERROR("Cache has possibly incompatible version!\n")
+	c += v_length;
+
+	vw_size_t cache_numbits = *(vw_size_t*)c;
+	c += sizeof(vw_size_t);
+	if (cache_numbits != numbits)
+		SG_SERROR("Bug encountered in caching! Bits used for weight in cache: %d.\n", cache_numbits)
+
+	cursor = map_begin + CVwMmapCacheWriter::align(c - map_begin);
+}
+
+bool CVwMmapCacheReader::read_cached_example(VwExample* const ae)
+{
+	char* c = cursor;
+	vw_size_t head_size = 3*sizeof(float32_t) + 3*sizeof(vw_size_t);
+	if (map_end - c < (ptrdiff_t) head_size)
+		return false;
+
+	VwLabel* ld = ae->ld;
+	ld->label = *(float32_t*)c;
+	c += sizeof(float32_t);
+	set_minmax(ld->label);
+	ld->weight = *(float32_t*)c;
+	c += sizeof(float32_t);
+	ld->initial = *(float32_t*)c;
+	c += sizeof(float32_t);
+
+	vw_size_t tag_size = *(vw_size_t*)c;
+	c += sizeof(vw_size_t);
+	vw_size_t num_indices = *(vw_size_t*)c;
+	c += sizeof(vw_size_t);
+	ae->sorted = *(vw_size_t*)c != 0;
+	c += sizeof(vw_size_t);
+
+	if (map_end - c < (ptrdiff_t) tag_size)
+		SG_SERROR("Truncated example! Wanted %d bytes!\n", tag_size)
+
+	ae->tag.erase();
+	ae->tag.push_many(c, tag_size);
+	c = map_begin + CVwMmapCacheWriter::align(c + tag_size - map_begin);
+
+	for (; num_indices > 0; num_indices--)
+	{
+		vw_size_t ns_head = 2*sizeof(vw_size_t) + sizeof(float64_t);
+		if (map_end - c < (ptrdiff_t) ns_head)
+			SG_SERROR("Truncated example! %d < %d bytes expected.\n",
+				  (int32_t) (map_end - c), ns_head);
+
+		vw_size_t index = *(vw_size_t*)c;
+		c += sizeof(vw_size_t);
+		if (index > 255)
+			SG_SERROR("Invalid namespace index %d in cache!\n", index)
+
+		vw_size_t num_feat = *(vw_size_t*)c;
+		c += sizeof(vw_size_t);
+		ae->sum_feat_sq[index] = *(float64_t*)c;
+		c += sizeof(float64_t);
+
+		vw_size_t storage = num_feat*sizeof(VwFeature);
+		if (map_end - c < (ptrdiff_t) storage)
+			SG_SERROR("Truncated example! Wanted %d bytes!\n", storage)
+
+		VwFeature* begin = (VwFeature*) c;
+		VwFeature* end = begin + num_feat;
+		c += storage;
+
+		ae->indices.push(index);
+
+		// The constant feature is appended to this namespace later
+		// on, so it has to live in storage owned by the example
+		if (index == constant_namespace)
+			ae->atomics[index].push_many(begin, num_feat);
+		else
+			ae->map_atomics(index, begin, end);
+	}
+
+	cursor = c;
+	return true;
+}
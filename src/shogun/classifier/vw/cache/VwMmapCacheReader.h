@@ -0,0 +1,117 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Copyright (C) 2011 Berlin Institute of Technology and Max-Planck-Society.
+ */
+
+#ifndef _VW_MMAPCACHE_READ_H__
+#define _VW_MMAPCACHE_READ_H__
+
+#include <shogun/classifier/vw/cache/VwCacheReader.h>
+#include <shogun/classifier/vw/cache/VwMmapCacheWriter.h>
+
+namespace shogun
+{
+
+/** @brief Class CVwMmapCacheReader reads a cache produced by
+ * CVwMmapCacheWriter by memory-mapping the file.
+ *
+ * Features are not copied: the atomics of the example being
+ * read are set to point directly into the mapping (see
+ * VwExample::map_atomics()), and are handed back when the
+ * example is reset before being reused from the parser's ring.
+ *
+ * The mapping is private, so in-place modifications of the
+ * features made during setup of an example (eg. scaling of the
+ * weight indices by the stride) never reach the file. It is
+ * recreated whenever the stream is reset, so that every pass
+ * starts from the cached values again.
+ */
+class CVwMmapCacheReader: public CVwCacheReader
+{
+public:
+	/**
+	 * Default constructor
+	 */
+	CVwMmapCacheReader();
+
+	/**
+	 * Constructor, opens a file whose name is specified
+	 *
+	 * @param fname file name
+	 * @param env_to_use Environment to use
+	 */
+	CVwMmapCacheReader(char * fname, CVwEnvironment* env_to_use);
+
+	/**
+	 * Constructor, passed a file descriptor
+	 *
+	 * @param f descriptor of opened file
+	 * @param env_to_use Environment to use
+	 */
+	CVwMmapCacheReader(int32_t f, CVwEnvironment* env_to_use);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~CVwMmapCacheReader();
+
+	/**
+	 * Set the file descriptor to use
+	 *
+	 * @param f descriptor of cache file
+	 */
+	virtual void set_file(int32_t f);
+
+	/**
+	 * Read one cached example
+	 *
+	 * @return example as VwExample*
+	 */
+	virtual bool read_cached_example(VwExample* const ae);
+
+	/**
+	 * (Re)map the cache file and check whether it is readable.
+	 * Reading restarts at the first example.
+	 */
+	void check_cache_metadata();
+
+	/**
+	 * Return the name of the object.
+	 *
+	 * @return VwMmapCacheReader
+	 */
+	virtual const char* get_name() const { return "VwMmapCacheReader"; }
+
+private:
+	/**
+	 * Initialize members
+	 */
+	void init();
+
+	/**
+	 * Map the whole cache file into memory
+	 */
+	void map_file();
+
+	/**
+	 * Release the mapping, if any
+	 */
+	void unmap_file();
+
+protected:
+	/// Start of the mapped file
+	char* map_begin;
+
+	/// End of the mapped file
+	char* map_end;
+
+	/// Position of the next example in the mapping
+	char* cursor;
+};
+
+}
+#endif // _VW_MMAPCACHE_READ_H__
@@ -0,0 +1,124 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Copyright (C) 2011 Berlin Institute of Technology and Max-Planck-Society.
+ */
+
+#include <shogun/classifier/vw/cache/VwMmapCacheWriter.h>
+
+using namespace shogun;
+
+CVwMmapCacheWriter::CVwMmapCacheWriter()
+	: CVwCacheWriter()
+{
+}
+
+CVwMmapCacheWriter::CVwMmapCacheWriter(char * fname, CVwEnvironment* env_to_use)
+	: CVwCacheWriter(fname, env_to_use)
+{
+	buf.use_file(fd);
+
+	write_header();
+}
+
+CVwMmapCacheWriter::~CVwMmapCacheWriter()
+{
+	buf.flush();
+	buf.close_file();
+}
+
+void CVwMmapCacheWriter::set_file(int32_t f)
+{
+	if (fd > 0)
+	{
+		buf.flush();
+		buf.close_file();
+	}
+
+	fd = f;
+	buf.use_file(fd);
+
+	write_header();
+}
+
+void CVwMmapCacheWriter::write_header()
+{
+	const char* vw_version = env->vw_version;
+	vw_size_t numbits = env->num_bits;
+	vw_size_t v_length = env->v_length;
+
+	vw_size_t header_size = sizeof(vw_mmap_cache_magic) + sizeof(vw_size_t)
+		+ v_length + sizeof(vw_size_t);
+	char* header = SG_CALLOC(char, align(header_size));
+	char* c = header;
+
+	*(uint32_t*)c = vw_mmap_cache_magic;
+	c += sizeof(uint32_t);
+	*(vw_size_t*)c = v_length;
+	c += sizeof(vw_size_t);
+	memcpy(c, vw_version, v_length);
+	c += v_length;
+	*(vw_size_t*)c = numbits;
+
+	if (buf.write_file(header, align(header_size)) != (ssize_t) align(header_size))
+	{
+		SG_FREE(header);
+		SG_ERROR("Error writing cache header!\n")
+	}
+	SG_FREE(header);
+}
+
+void CVwMmapCacheWriter::output_features(vw_size_t index, VwFeature* begin,
+		VwFeature* end, float64_t sum_feat_sq)
+{
+	char* c;
+	vw_size_t num_feat = end - begin;
+	vw_size_t storage = 2*sizeof(vw_size_t) + sizeof(float64_t)
+		+ num_feat*sizeof(VwFeature);
+
+	buf.buf_write(c, storage);
+	*(vw_size_t*)c = index;
+	c += sizeof(vw_size_t);
+	*(vw_size_t*)c = num_feat;
+	c += sizeof(vw_size_t);
+	*(float64_t*)c = sum_feat_sq;
+	c += sizeof(float64_t);
+	memcpy(c, begin, num_feat*sizeof(VwFeature));
+	c += num_feat*sizeof(VwFeature);
+
+	buf.set(c);
+}
+
+void CVwMmapCacheWriter::cache_example(VwExample* &ex)
+{
+	char* c;
+	vw_size_t tag_size = ex->tag.index();
+	vw_size_t storage = align(3*sizeof(float32_t) + 3*sizeof(vw_size_t) + tag_size);
+
+	buf.buf_write(c, storage);
+	memset(c, 0, storage);
+	char* start = c;
+
+	*(float32_t*)c = ex->ld->label;
+	c += sizeof(float32_t);
+	*(float32_t*)c = ex->ld->weight;
+	c += sizeof(float32_t);
+	*(float32_t*)c = ex->ld->initial;
+	c += sizeof(float32_t);
+	*(vw_size_t*)c = tag_size;
+	c += sizeof(vw_size_t);
+	*(vw_size_t*)c = ex->indices.index();
+	c += sizeof(vw_size_t);
+	*(vw_size_t*)c = ex->sorted ? 1 : 0;
+	c += sizeof(vw_size_t);
+	memcpy(c, ex->tag.begin, tag_size);
+
+	buf.set(start + storage);
+
+	for (vw_size_t* b = ex->indices.begin; b != ex->indices.end; b++)
+		output_features(*b, ex->atomics[*b].begin, ex->atomics[*b].end,
+				ex->sum_feat_sq[*b]);
+}
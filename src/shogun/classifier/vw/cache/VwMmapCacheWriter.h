@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Copyright (C) 2011 Berlin Institute of Technology and Max-Planck-Society.
+ */
+
+#ifndef _VW_MMAPCACHE_WRITE_H__
+#define _VW_MMAPCACHE_WRITE_H__
+
+#include <shogun/classifier/vw/cache/VwCacheWriter.h>
+
+namespace shogun
+{
+
+/// Magic number at the start of a C_MMAP cache file
+const uint32_t vw_mmap_cache_magic = 0x434d5756;
+
+/** @brief Class CVwMmapCacheWriter writes a cache which can be
+ * memory-mapped and read in place by CVwMmapCacheReader.
+ *
+ * Unlike the native cache, features are not compressed; every
+ * namespace is stored as a plain, aligned array of VwFeature
+ * objects together with its sum of squared feature values, so
+ * the reader never has to decode or copy them. The cache is
+ * therefore larger than a native one, but reading it back in
+ * further passes costs little more than touching the pages.
+ *
+ * Layout, every block starting at an 8-byte boundary:
+ * - header: magic, version length, version, number of bits
+ * - per example: label, weight, initial, tag size, number of
+ *   namespaces, flags, followed by the tag
+ * - per namespace: index, number of features, sum of squares,
+ *   followed by the features
+ */
+class CVwMmapCacheWriter: public CVwCacheWriter
+{
+public:
+	/**
+	 * Default constructor
+	 */
+	CVwMmapCacheWriter();
+
+	/**
+	 * Constructor, opens a file whose name is specified
+	 *
+	 * @param fname file name
+	 * @param env_to_use Environment to use
+	 */
+	CVwMmapCacheWriter(char * fname, CVwEnvironment* env_to_use);
+
+	/**
+	 * Destructor
+	 */
+	virtual ~CVwMmapCacheWriter();
+
+	/**
+	 * Set the file descriptor to use
+	 *
+	 * @param f descriptor of cache file
+	 */
+	virtual void set_file(int32_t f);
+
+	/**
+	 * Cache one example
+	 *
+	 * @param ex example to write to cache
+	 */
+	virtual void cache_example(VwExample* &ex);
+
+	/**
+	 * Return the name of the object.
+	 *
+	 * @return VwMmapCacheWriter
+	 */
+	virtual const char* get_name() const { return "VwMmapCacheWriter"; }
+
+	/**
+	 * Round a size up to the alignment of blocks in the cache
+	 *
+	 * @param size size in bytes
+	 *
+	 * @return aligned size
+	 */
+	static inline vw_size_t align(vw_size_t size)
+	{
+		return (size + 7) & ~((vw_size_t) 7);
+	}
+
+private:
+	/**
+	 * Write the header of the cache.
+	 * Includes magic, version and weight bits information.
+	 */
+	void write_header();
+
+	/**
+	 * Write the features of one namespace into the buffer
+	 *
+	 * @param index namespace index
+	 * @param begin first feature
+	 * @param end pointer to end of features
+	 * @param sum_feat_sq sum of squares of the feature values
+	 */
+	void output_features(vw_size_t index, VwFeature* begin, VwFeature* end,
+			float64_t sum_feat_sq);
+
+protected:
+	/// IOBuffer used for writing
+	CIOBuffer buf;
+};
+
+}
+#endif // _VW_MMAPCACHE_WRITE_H__
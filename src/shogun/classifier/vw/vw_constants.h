@@ -29,6 +29,9 @@ const int32_t quadratic_constant = 27942141;
 /// Constant used to access the constant feature
 const int32_t constant_hash = 11650396;
 
+/// Namespace index the constant feature is added to
+const vw_size_t constant_namespace = 128;
+
 /// Seed for hash
 const uint32_t hash_base = 97562527;
 
@@ -20,13 +20,17 @@ VwExample::VwExample(): tag(), indices(), atomics(),
 			num_features(0), pass(0),
 			final_prediction(0.), loss(0),
 			eta_round(0.), global_weight(0),
-			example_t(0), total_sum_feat_sq(1), sorted(false)
+			example_t(0), total_sum_feat_sq(1), sorted(false),
+			num_mapped(0)
 {
 	ld = new VwLabel();
+	for (int32_t i = 0; i < 256; i++)
+		mapped[i] = false;
 }
 
 VwExample::~VwExample()
 {
+	unmap_atomics();
 	if (ld)
 		delete ld;
 }
@@ -42,6 +46,8 @@ void VwExample::reset_members()
 	final_prediction = 0;
 	loss = 0;
 
+	unmap_atomics();
+
 	for (vw_size_t* i = indices.begin; i != indices.end; i++)
 	{
 		atomics[*i].erase();
@@ -51,3 +57,39 @@ void VwExample::reset_members()
 	indices.erase();
 	tag.erase();
 }
+
+void VwExample::map_atomics(vw_size_t index, VwFeature* begin, VwFeature* end)
+{
+	if (!mapped[index])
+	{
+		owned_atomics[index].begin = atomics[index].begin;
+		owned_atomics[index].end = atomics[index].end;
+		owned_atomics[index].end_array = atomics[index].end_array;
+		mapped[index] = true;
+		num_mapped++;
+	}
+
+	atomics[index].begin = begin;
+	atomics[index].end = end;
+	atomics[index].end_array = end;
+}
+
+void VwExample::unmap_atomics()
+{
+	for (int32_t i = 0; i < 256 && num_mapped > 0; i++)
+	{
+		if (!mapped[i])
+			continue;
+
+		atomics[i].begin = owned_atomics[i].begin;
+		atomics[i].end = owned_atomics[i].begin;
+		atomics[i].end_array = owned_atomics[i].end_array;
+
+		// The storage is owned by atomics again
+		owned_atomics[i].begin = NULL;
+		owned_atomics[i].end = NULL;
+		owned_atomics[i].end_array = NULL;
+		mapped[i] = false;
+		num_mapped--;
+	}
+}
@@ -72,6 +72,27 @@ public:
 	 */
 	void reset_members();
 
+	/**
+	 * Make the features of a namespace a read-only view of
+	 * externally owned memory, eg. a memory-mapped cache.
+	 *
+	 * The storage owned by the example is kept aside and
+	 * restored by unmap_atomics(), which is called from
+	 * reset_members(). Features of a mapped namespace must
+	 * not be pushed to.
+	 *
+	 * @param index namespace index
+	 * @param begin first feature
+	 * @param end pointer to end of features
+	 */
+	void map_atomics(vw_size_t index, VwFeature* begin, VwFeature* end);
+
+	/**
+	 * Restore the owned storage of all namespaces whose features
+	 * were mapped through map_atomics()
+	 */
+	void unmap_atomics();
+
 public:
 	/// Label object
 	VwLabel* ld;
@@ -107,6 +128,14 @@ public:
 	vw_size_t example_counter;
 	/// Whether features are sorted by weight index
 	bool sorted;
+
+private:
+	/// Whether atomics of a namespace point into external memory
+	bool mapped[256];
+	/// Number of namespaces currently mapped
+	vw_size_t num_mapped;
+	/// Owned storage of mapped namespaces, kept aside while mapped
+	v_array<VwFeature> owned_atomics[256];
 };
 
 }
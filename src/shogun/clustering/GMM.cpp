@@ -25,6 +25,35 @@
 using namespace shogun;
 using namespace std;
 
+/* number of vectors processed together by the E- and M-steps */
+#define GMM_BLOCK_SIZE 256
+
+/* log(sum(exp(values))) shifted by the largest value to avoid underflow */
+static float64_t log_sum_exp(const float64_t* values, int32_t len)
+{
+	float64_t max_value=-CMath::INFTY;
+	for (int32_t i=0; i<len; i++)
+		max_value=CMath::max(max_value, values[i]);
+
+	if (max_value==-CMath::INFTY)
+		return max_value;
+
+	float64_t sum=0;
+	for (int32_t i=0; i<len; i++)
+		sum+=CMath::exp(values[i]-max_value);
+
+	return max_value+CMath::log(sum);
+}
+
+/* copy vectors start,...,start+num-1 into the columns of block */
+static void get_block(CDotFeatures* data, index_t start, index_t num, float64_t* block)
+{
+	int32_t num_dim=data->get_dim_feature_space();
+	memset(block, 0, sizeof(float64_t)*num_dim*num);
+	for (index_t i=0; i<num; i++)
+		data->add_to_dense_vec(1, start+i, block+int64_t(i)*num_dim, num_dim);
+}
+
 CGMM::CGMM() : CDistribution(), m_components(),	m_coefficients()
 {
 	register_params();
@@ -133,68 +162,162 @@ float64_t CGMM::train_em(float64_t min_cov, int32_t max_iter, float64_t min_chan
 	CDotFeatures* dotdata=(CDotFeatures *) features;
 	int32_t num_vectors=dotdata->get_num_vectors();
 
-	SGMatrix<float64_t> alpha;
-
 	/* compute initialization via kmeans if none is present */
 	if (m_components[0]->get_mean().vector==NULL)
-	{
-		CKMeans* init_k_means=new CKMeans(int32_t(m_components.size()), new CEuclideanDistance());
-		init_k_means->train(dotdata);
-		SGMatrix<float64_t> init_means=init_k_means->get_cluster_centers();
+		kmeans_init(min_cov);
 
-		alpha=alpha_init(init_means);
-
-		SG_UNREF(init_k_means);
-
-		max_likelihood(alpha, min_cov);
-	}
-	else
-		alpha=SGMatrix<float64_t>(num_vectors,int32_t(m_components.size()));
+	SGMatrix<float64_t> alpha(num_vectors,int32_t(m_components.size()));
 
 	int32_t iter=0;
 	float64_t log_likelihood_prev=0;
 	float64_t log_likelihood_cur=0;
-	float64_t* logPxy=SG_MALLOC(float64_t, num_vectors*m_components.size());
-	float64_t* logPx=SG_MALLOC(float64_t, num_vectors);
-	//float64_t* logPost=SG_MALLOC(float64_t, num_vectors*m_components.vlen);
 
 	while (iter<max_iter)
 	{
 		log_likelihood_prev=log_likelihood_cur;
-		log_likelihood_cur=0;
+		log_likelihood_cur=expectation(0, alpha);
 
-		for (int32_t i=0; i<num_vectors; i++)
+		if (iter>0 && log_likelihood_cur-log_likelihood_prev<min_change)
+			break;
+
+		max_likelihood(alpha, min_cov);
+
+		iter++;
+	}
+
+	return log_likelihood_cur;
+}
+
+float64_t CGMM::train_em_minibatch(int32_t batch_size, int32_t num_epochs, float64_t min_cov, float64_t kappa)
+{
+	if (!features)
+		SG_ERROR("No features to train on.\n")
+
+	REQUIRE(batch_size>0, "Batch size (%d) must be positive\n", batch_size)
+	REQUIRE(kappa>0.5 && kappa<=1, "Step size decay (%f) must be in (0.5,1]\n", kappa)
+
+	CDotFeatures* dotdata=(CDotFeatures *) features;
+	int32_t num_vectors=dotdata->get_num_vectors();
+	int32_t num_dim=dotdata->get_dim_feature_space();
+	int32_t num_components=m_components.size();
+
+	if (m_components[0]->get_mean().vector==NULL)
+		kmeans_init(min_cov);
+
+	/* running statistics, normalized by the number of vectors they
+	 * summarize, initialized from the current parameters */
+	SGVector<index_t> cov_offset=get_cov_offset(num_dim);
+	SGVector<float64_t> alpha_sums(num_components);
+	SGMatrix<float64_t> means(num_dim, num_components);
+	SGVector<float64_t> cov_sums(cov_offset[num_components]);
+	for (int32_t j=0; j<num_components; j++)
+	{
+		alpha_sums[j]=m_coefficients[j];
+		memcpy(means.get_column_vector(j), m_components[j]->get_mean().vector, num_dim*sizeof(float64_t));
+
+		float64_t* cov_sum=cov_sums.vector+cov_offset[j];
+		switch (m_components[j]->get_cov_type())
 		{
-			logPx[i]=0;
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
-			for (int32_t j=0; j<int32_t(m_components.size()); j++)
+			case FULL:
 			{
-				logPxy[i*m_components.size()+j]=m_components[j]->compute_log_PDF(v)+CMath::log(m_coefficients[j]);
-				logPx[i]+=CMath::exp(logPxy[i*m_components.size()+j]);
+				SGMatrix<float64_t> cov=m_components[j]->get_cov();
+				for (int32_t k=0; k<num_dim*num_dim; k++)
+					cov_sum[k]=alpha_sums[j]*cov.matrix[k];
+				break;
 			}
+			case DIAG:
+				for (int32_t k=0; k<num_dim; k++)
+					cov_sum[k]=alpha_sums[j]*m_components[j]->get_d().vector[k];
+				break;
+			case SPHERICAL:
+				cov_sum[0]=alpha_sums[j]*m_components[j]->get_d().vector[0]*num_dim;
+				break;
+		}
+	}
 
-			logPx[i]=CMath::log(logPx[i]);
-			log_likelihood_cur+=logPx[i];
+	SGVector<float64_t> batch_alpha_sums(num_components);
+	SGMatrix<float64_t> batch_means(num_dim, num_components);
+	SGVector<float64_t> batch_cov_sums(cov_offset[num_components]);
 
-			for (int32_t j=0; j<int32_t(m_components.size()); j++)
+	float64_t log_likelihood=0;
+	int32_t step=0;
+	for (int32_t epoch=0; epoch<num_epochs; epoch++)
+	{
+		log_likelihood=0;
+		for (index_t start=0; start<num_vectors; start+=batch_size)
+		{
+			index_t num=CMath::min(batch_size, num_vectors-start);
+			SGMatrix<float64_t> alpha(num, num_components);
+			log_likelihood+=expectation(start, alpha);
+			compute_statistics(start, alpha, cov_offset, batch_alpha_sums, batch_means, batch_cov_sums);
+
+			float64_t eta=CMath::pow(step+2.0, -kappa);
+			for (int32_t j=0; j<num_components; j++)
 			{
-				//logPost[i*m_components.vlen+j]=logPxy[i*m_components.vlen+j]-logPx[i];
-				alpha.matrix[i*m_components.size()+j]=CMath::exp(logPxy[i*m_components.size()+j]-logPx[i]);
+				float64_t* mean=means.get_column_vector(j);
+				float64_t* cov_sum=cov_sums.vector+cov_offset[j];
+				index_t cov_size=cov_offset[j+1]-cov_offset[j];
+				float64_t old_weight=(1-eta)*alpha_sums[j];
+				float64_t batch_weight=eta*batch_alpha_sums[j]/num;
+
+				for (index_t k=0; k<cov_size; k++)
+					cov_sum[k]*=1-eta;
+				alpha_sums[j]=old_weight+batch_weight;
+
+				/* the means of a component without any vector are undefined */
+				if (batch_weight==0)
+					continue;
+
+				const float64_t* batch_mean=batch_means.get_column_vector(j);
+				const float64_t* batch_cov_sum=batch_cov_sums.vector+cov_offset[j];
+				for (index_t k=0; k<cov_size; k++)
+					cov_sum[k]+=eta*batch_cov_sum[k]/num;
+
+				/* scatter between the old and the batch mean, as when pooling
+				 * the (centered) second moments of two samples */
+				float64_t between=old_weight*batch_weight/alpha_sums[j];
+				switch (m_components[j]->get_cov_type())
+				{
+					case FULL:
+						for (int32_t c=0; c<num_dim; c++)
+						{
+							for (int32_t r=0; r<num_dim; r++)
+								cov_sum[c*num_dim+r]+=between*(mean[r]-batch_mean[r])*(mean[c]-batch_mean[c]);
+						}
+						break;
+					case DIAG:
+						for (int32_t k=0; k<num_dim; k++)
+							cov_sum[k]+=between*(mean[k]-batch_mean[k])*(mean[k]-batch_mean[k]);
+						break;
+					case SPHERICAL:
+						for (int32_t k=0; k<num_dim; k++)
+							cov_sum[0]+=between*(mean[k]-batch_mean[k])*(mean[k]-batch_mean[k]);
+						break;
+				}
+
+				for (int32_t k=0; k<num_dim; k++)
+					mean[k]=(old_weight*mean[k]+batch_weight*batch_mean[k])/alpha_sums[j];
 			}
+
+			set_statistics(cov_offset, alpha_sums, means, cov_sums, min_cov);
+			step++;
 		}
+	}
 
-		if (iter>0 && log_likelihood_cur-log_likelihood_prev<min_change)
-			break;
+	return log_likelihood;
+}
 
-		max_likelihood(alpha, min_cov);
+void CGMM::kmeans_init(float64_t min_cov)
+{
+	CKMeans* init_k_means=new CKMeans(int32_t(m_components.size()), new CEuclideanDistance());
+	init_k_means->train(features);
+	SGMatrix<float64_t> init_means=init_k_means->get_cluster_centers();
 
-		iter++;
-	}
+	SGMatrix<float64_t> alpha=alpha_init(init_means);
 
-	SG_FREE(logPxy);
-	SG_FREE(logPx);
+	SG_UNREF(init_k_means);
 
-	return log_likelihood_cur;
+	max_likelihood(alpha, min_cov);
 }
 
 float64_t CGMM::train_smem(int32_t max_iter, int32_t max_cand, float64_t min_cov, int32_t max_em_iter, float64_t min_change)
@@ -227,17 +350,10 @@ float64_t CGMM::train_smem(int32_t max_iter, int32_t max_cand, float64_t min_cov
 		memset(logPostSum, 0, m_components.size()*sizeof(float64_t));
 		memset(logPostSum2, 0, m_components.size()*sizeof(float64_t));
 		memset(logPostSumSum, 0, (m_components.size()*(m_components.size()-1)/2)*sizeof(float64_t));
+		compute_log_joint(m_components, m_coefficients, 0, num_vectors, logPxy);
 		for (int32_t i=0; i<num_vectors; i++)
 		{
-			logPx[i]=0;
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
-			for (int32_t j=0; j<int32_t(m_components.size()); j++)
-			{
-				logPxy[i*m_components.size()+j]=m_components[j]->compute_log_PDF(v)+CMath::log(m_coefficients[j]);
-				logPx[i]+=CMath::exp(logPxy[i*m_components.size()+j]);
-			}
-
-			logPx[i]=CMath::log(logPx[i]);
+			logPx[i]=log_sum_exp(logPxy+i*m_components.size(), m_components.size());
 
 			for (int32_t j=0; j<int32_t(m_components.size()); j++)
 			{
@@ -345,23 +461,34 @@ void CGMM::partial_em(int32_t comp1, int32_t comp2, int32_t comp3, float64_t min
 	float64_t* init_logPx_fix=SG_MALLOC(float64_t, num_vectors);
 	float64_t* post_add=SG_MALLOC(float64_t, num_vectors);
 
+	int32_t num_components=m_components.size();
+	compute_log_joint(m_components, m_coefficients, 0, num_vectors, init_logPxy);
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
 	for (int32_t i=0; i<num_vectors; i++)
 	{
-		init_logPx[i]=0;
-		init_logPx_fix[i]=0;
+		const float64_t* logPxy_i=init_logPxy+i*num_components;
+		init_logPx[i]=log_sum_exp(logPxy_i, num_components);
 
-		SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
-		for (int32_t j=0; j<int32_t(m_components.size()); j++)
+		/* log of the summed joint probabilities of the untouched components */
+		float64_t max_fix=-CMath::INFTY;
+		for (int32_t j=0; j<num_components; j++)
 		{
-			init_logPxy[i*m_components.size()+j]=m_components[j]->compute_log_PDF(v)+CMath::log(m_coefficients[j]);
-			init_logPx[i]+=CMath::exp(init_logPxy[i*m_components.size()+j]);
 			if (j!=comp1 && j!=comp2 && j!=comp3)
+				max_fix=CMath::max(max_fix, logPxy_i[j]);
+		}
+		init_logPx_fix[i]=max_fix;
+		if (max_fix!=-CMath::INFTY)
+		{
+			float64_t sum_fix=0;
+			for (int32_t j=0; j<num_components; j++)
 			{
-				init_logPx_fix[i]+=CMath::exp(init_logPxy[i*m_components.size()+j]);
+				if (j!=comp1 && j!=comp2 && j!=comp3)
+					sum_fix+=CMath::exp(logPxy_i[j]-max_fix);
 			}
+			init_logPx_fix[i]+=CMath::log(sum_fix);
 		}
 
-		init_logPx[i]=CMath::log(init_logPx[i]);
 		post_add[i]=CMath::log(CMath::exp(init_logPxy[i*m_components.size()+comp1]-init_logPx[i])+
 					CMath::exp(init_logPxy[i*m_components.size()+comp2]-init_logPx[i])+
 					CMath::exp(init_logPxy[i*m_components.size()+comp3]-init_logPx[i]));
@@ -466,33 +593,27 @@ void CGMM::partial_em(int32_t comp1, int32_t comp2, int32_t comp3, float64_t min
 	SGMatrix<float64_t> alpha(num_vectors, 3);
 	float64_t* logPxy=SG_MALLOC(float64_t, num_vectors*3);
 	float64_t* logPx=SG_MALLOC(float64_t, num_vectors);
-	//float64_t* logPost=SG_MALLOC(float64_t, num_vectors*m_components.vlen);
 
 	while (iter<max_em_iter)
 	{
 		log_likelihood_prev=log_likelihood_cur;
 		log_likelihood_cur=0;
 
+		compute_log_joint(components, coefficients, 0, num_vectors, logPxy);
+
+#pragma omp parallel for num_threads(parallel->get_num_threads())
 		for (int32_t i=0; i<num_vectors; i++)
 		{
-			logPx[i]=0;
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(i);
-			for (int32_t j=0; j<3; j++)
-			{
-				logPxy[i*3+j]=components[j]->compute_log_PDF(v)+CMath::log(coefficients[j]);
-				logPx[i]+=CMath::exp(logPxy[i*3+j]);
-			}
-
-			logPx[i]=CMath::log(logPx[i]+init_logPx_fix[i]);
-			log_likelihood_cur+=logPx[i];
+			float64_t logPxy_i[4]={logPxy[i*3], logPxy[i*3+1], logPxy[i*3+2], init_logPx_fix[i]};
+			logPx[i]=log_sum_exp(logPxy_i, 4);
 
 			for (int32_t j=0; j<3; j++)
-			{
-				//logPost[i*m_components.vlen+j]=logPxy[i*m_components.vlen+j]-logPx[i];
 				alpha.matrix[i*3+j]=CMath::exp(logPxy[i*3+j]-logPx[i]+post_add[i]);
-			}
 		}
 
+		for (int32_t i=0; i<num_vectors; i++)
+			log_likelihood_cur+=logPx[i];
+
 		if (iter>0 && log_likelihood_cur-log_likelihood_prev<min_change)
 			break;
 
@@ -521,76 +642,266 @@ void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 	CDotFeatures* dotdata=(CDotFeatures *) features;
 	int32_t num_dim=dotdata->get_dim_feature_space();
 
-	float64_t alpha_sum;
-	float64_t alpha_sum_sum=0;
-	float64_t* mean_sum;
-	float64_t* cov_sum=NULL;
+	SGVector<index_t> cov_offset=get_cov_offset(num_dim);
+	SGVector<float64_t> alpha_sums(alpha.num_cols);
+	SGMatrix<float64_t> means(num_dim, alpha.num_cols);
+	SGVector<float64_t> cov_sums(cov_offset[alpha.num_cols]);
+
+	compute_statistics(0, alpha, cov_offset, alpha_sums, means, cov_sums);
+	set_statistics(cov_offset, alpha_sums, means, cov_sums, min_cov);
+}
+
+void CGMM::compute_log_joint(const vector<CGaussian*>& components,
+		SGVector<float64_t> coefficients, index_t start, index_t num,
+		float64_t* logPxy)
+{
+	CDotFeatures* dotdata=(CDotFeatures *) features;
+	int32_t num_dim=dotdata->get_dim_feature_space();
+	int32_t num_components=components.size();
+	index_t num_blocks=(num+GMM_BLOCK_SIZE-1)/GMM_BLOCK_SIZE;
 
-	for (int32_t i=0; i<alpha.num_cols; i++)
+	SGVector<float64_t> log_coef(num_components);
+	for (int32_t j=0; j<num_components; j++)
+		log_coef[j]=CMath::log(coefficients[j]);
+
+#pragma omp parallel for num_threads(parallel->get_num_threads()) schedule(dynamic)
+	for (index_t b=0; b<num_blocks; b++)
 	{
-		alpha_sum=0;
-		mean_sum=SG_MALLOC(float64_t, num_dim);
-		memset(mean_sum, 0, num_dim*sizeof(float64_t));
+		index_t block_start=b*GMM_BLOCK_SIZE;
+		index_t block_size=CMath::min(GMM_BLOCK_SIZE, num-block_start);
+		SGMatrix<float64_t> block(num_dim, block_size);
+		get_block(dotdata, start+block_start, block_size, block.matrix);
 
-		for (int32_t j=0; j<alpha.num_rows; j++)
+		for (int32_t j=0; j<num_components; j++)
 		{
-			alpha_sum+=alpha.matrix[j*alpha.num_cols+i];
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(j);
-			SGVector<float64_t>::add(mean_sum, alpha.matrix[j*alpha.num_cols+i], v.vector, 1, mean_sum, v.vlen);
+			SGVector<float64_t> log_pdf=components[j]->compute_log_PDF(block);
+			for (index_t i=0; i<block_size; i++)
+				logPxy[(block_start+i)*num_components+j]=log_pdf[i]+log_coef[j];
 		}
+	}
+}
 
-		for (int32_t j=0; j<num_dim; j++)
-			mean_sum[j]/=alpha_sum;
+float64_t CGMM::expectation(index_t start, SGMatrix<float64_t> alpha)
+{
+	int32_t num_components=m_components.size();
+	index_t num=alpha.num_rows;
+	float64_t* logPxy=SG_MALLOC(float64_t, num*num_components);
+	float64_t* logPx=SG_MALLOC(float64_t, num);
 
-		m_components[i]->set_mean(SGVector<float64_t>(mean_sum, num_dim));
+	compute_log_joint(m_components, m_coefficients, start, num, logPxy);
 
-		ECovType cov_type=m_components[i]->get_cov_type();
+#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (index_t i=0; i<num; i++)
+	{
+		logPx[i]=log_sum_exp(logPxy+i*num_components, num_components);
 
-		if (cov_type==FULL)
-		{
-			cov_sum=SG_MALLOC(float64_t, num_dim*num_dim);
-			memset(cov_sum, 0, num_dim*num_dim*sizeof(float64_t));
-		}
-		else if(cov_type==DIAG)
+		for (int32_t j=0; j<num_components; j++)
+			alpha.matrix[i*num_components+j]=CMath::exp(logPxy[i*num_components+j]-logPx[i]);
+	}
+
+	/* summed in a fixed order to not depend on the number of threads */
+	float64_t log_likelihood=0;
+	for (index_t i=0; i<num; i++)
+		log_likelihood+=logPx[i];
+
+	SG_FREE(logPxy);
+	SG_FREE(logPx);
+
+	return log_likelihood;
+}
+
+SGVector<index_t> CGMM::get_cov_offset(int32_t num_dim)
+{
+	SGVector<index_t> cov_offset(m_components.size()+1);
+	cov_offset[0]=0;
+	for (int32_t i=0; i<int32_t(m_components.size()); i++)
+	{
+		switch (m_components[i]->get_cov_type())
 		{
-			cov_sum=SG_MALLOC(float64_t, num_dim);
-			memset(cov_sum, 0, num_dim*sizeof(float64_t));
+			case FULL:
+				cov_offset[i+1]=cov_offset[i]+num_dim*num_dim;
+				break;
+			case DIAG:
+				cov_offset[i+1]=cov_offset[i]+num_dim;
+				break;
+			case SPHERICAL:
+				cov_offset[i+1]=cov_offset[i]+1;
+				break;
 		}
-		else if(cov_type==SPHERICAL)
+	}
+
+	return cov_offset;
+}
+
+void CGMM::compute_statistics(index_t start, SGMatrix<float64_t> alpha,
+		SGVector<index_t> cov_offset, SGVector<float64_t> alpha_sums,
+		SGMatrix<float64_t> means, SGVector<float64_t> cov_sums)
+{
+	CDotFeatures* dotdata=(CDotFeatures *) features;
+	int32_t num_dim=dotdata->get_dim_feature_space();
+	int32_t num_components=alpha.num_cols;
+	index_t num_blocks=(alpha.num_rows+GMM_BLOCK_SIZE-1)/GMM_BLOCK_SIZE;
+	int32_t num_threads=CMath::max(1, CMath::min(parallel->get_num_threads(), num_blocks));
+
+	/* each thread sums a contiguous range of blocks, the partial sums
+	 * are reduced in a fixed order to not depend on the scheduling */
+	SGMatrix<float64_t> thread_alpha_sums(num_components, num_threads);
+	SGMatrix<float64_t> thread_means(num_dim*num_components, num_threads);
+	SGMatrix<float64_t> thread_cov_sums(cov_offset[num_components], num_threads);
+	thread_alpha_sums.zero();
+	thread_means.zero();
+	thread_cov_sums.zero();
+
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		float64_t* block=SG_MALLOC(float64_t, num_dim*GMM_BLOCK_SIZE);
+		float64_t* t_alpha_sums=thread_alpha_sums.get_column_vector(t);
+		float64_t* t_means=thread_means.get_column_vector(t);
+
+		for (index_t b=num_blocks*t/num_threads; b<num_blocks*(t+1)/num_threads; b++)
 		{
-			cov_sum=SG_MALLOC(float64_t, 1);
-			cov_sum[0]=0;
+			index_t block_start=b*GMM_BLOCK_SIZE;
+			index_t block_size=CMath::min(GMM_BLOCK_SIZE, alpha.num_rows-block_start);
+			const float64_t* block_alpha=alpha.matrix+block_start*num_components;
+			get_block(dotdata, start+block_start, block_size, block);
+
+			for (index_t i=0; i<block_size; i++)
+			{
+				for (int32_t j=0; j<num_components; j++)
+					t_alpha_sums[j]+=block_alpha[i*num_components+j];
+			}
+
+			/* weighted sums of the vectors of all components at once */
+			cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, num_dim,
+						num_components, block_size, 1, block, num_dim,
+						block_alpha, num_components, 1, t_means, num_dim);
 		}
 
-		for (int32_t j=0; j<alpha.num_rows; j++)
+		SG_FREE(block);
+	}
+
+	alpha_sums.zero();
+	means.zero();
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		for (int32_t j=0; j<num_components; j++)
+			alpha_sums[j]+=thread_alpha_sums(j, t);
+		for (int32_t k=0; k<num_dim*num_components; k++)
+			means.matrix[k]+=thread_means(k, t);
+	}
+
+	for (int32_t j=0; j<num_components; j++)
+	{
+		for (int32_t k=0; k<num_dim; k++)
+			means(k, j)/=alpha_sums[j];
+	}
+
+#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		float64_t* block=SG_MALLOC(float64_t, num_dim*GMM_BLOCK_SIZE);
+		float64_t* difference=SG_MALLOC(float64_t, num_dim*GMM_BLOCK_SIZE);
+		float64_t* t_cov_sums=thread_cov_sums.get_column_vector(t);
+
+		for (index_t b=num_blocks*t/num_threads; b<num_blocks*(t+1)/num_threads; b++)
 		{
-			SGVector<float64_t> v=dotdata->get_computed_dot_feature_vector(j);
-			SGVector<float64_t>::add(v.vector, 1, v.vector, -1, mean_sum, v.vlen);
+			index_t block_start=b*GMM_BLOCK_SIZE;
+			index_t block_size=CMath::min(GMM_BLOCK_SIZE, alpha.num_rows-block_start);
+			const float64_t* block_alpha=alpha.matrix+block_start*num_components;
+			get_block(dotdata, start+block_start, block_size, block);
 
-			switch (cov_type)
+			for (int32_t j=0; j<num_components; j++)
 			{
-				case FULL:
-					cblas_dger(CblasRowMajor, num_dim, num_dim, alpha.matrix[j*alpha.num_cols+i], v.vector, 1, v.vector,
-								 1, (double*) cov_sum, num_dim);
-
-					break;
-				case DIAG:
-					for (int32_t k=0; k<num_dim; k++)
-						cov_sum[k]+=v.vector[k]*v.vector[k]*alpha.matrix[j*alpha.num_cols+i];
+				const float64_t* mean=means.get_column_vector(j);
+				float64_t* cov_sum=t_cov_sums+cov_offset[j];
+				ECovType cov_type=m_components[j]->get_cov_type();
 
-					break;
-				case SPHERICAL:
-					float64_t temp=0;
+				for (index_t i=0; i<block_size; i++)
+				{
+					float64_t a=block_alpha[i*num_components+j];
+					const float64_t* point=block+i*num_dim;
 
-					for (int32_t k=0; k<num_dim; k++)
-						temp+=v.vector[k]*v.vector[k];
+					switch (cov_type)
+					{
+						case FULL:
+						{
+							/* scaled such that the products sum up weighted */
+							float64_t* diff=difference+i*num_dim;
+							float64_t scale=CMath::sqrt(a);
+							for (int32_t k=0; k<num_dim; k++)
+								diff[k]=(point[k]-mean[k])*scale;
+							break;
+						}
+						case DIAG:
+							for (int32_t k=0; k<num_dim; k++)
+								cov_sum[k]+=a*(point[k]-mean[k])*(point[k]-mean[k]);
+							break;
+						case SPHERICAL:
+						{
+							float64_t temp=0;
+							for (int32_t k=0; k<num_dim; k++)
+								temp+=(point[k]-mean[k])*(point[k]-mean[k]);
+							cov_sum[0]+=a*temp;
+							break;
+						}
+					}
+				}
 
-					cov_sum[0]+=temp*alpha.matrix[j*alpha.num_cols+i];
-					break;
+				if (cov_type==FULL)
+				{
+					cblas_dsyrk(CblasColMajor, CblasUpper, CblasNoTrans, num_dim,
+								block_size, 1, difference, num_dim, 1, cov_sum, num_dim);
+				}
 			}
 		}
 
-		switch (cov_type)
+		SG_FREE(block);
+		SG_FREE(difference);
+	}
+
+	cov_sums.zero();
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		for (index_t k=0; k<cov_offset[num_components]; k++)
+			cov_sums[k]+=thread_cov_sums(k, t);
+	}
+
+	/* only the upper triangle of full covariances was summed */
+	for (int32_t j=0; j<num_components; j++)
+	{
+		if (m_components[j]->get_cov_type()!=FULL)
+			continue;
+
+		float64_t* cov_sum=cov_sums.vector+cov_offset[j];
+		for (int32_t c=0; c<num_dim; c++)
+		{
+			for (int32_t r=0; r<c; r++)
+				cov_sum[r*num_dim+c]=cov_sum[c*num_dim+r];
+		}
+	}
+}
+
+void CGMM::set_statistics(SGVector<index_t> cov_offset,
+		SGVector<float64_t> alpha_sums, SGMatrix<float64_t> means,
+		SGVector<float64_t> cov_sums, float64_t min_cov)
+{
+	int32_t num_dim=means.num_rows;
+	float64_t alpha_sum_sum=0;
+
+	for (int32_t i=0; i<means.num_cols; i++)
+	{
+		float64_t alpha_sum=alpha_sums[i];
+
+		float64_t* mean_sum=SG_MALLOC(float64_t, num_dim);
+		memcpy(mean_sum, means.get_column_vector(i), num_dim*sizeof(float64_t));
+		m_components[i]->set_mean(SGVector<float64_t>(mean_sum, num_dim));
+
+		index_t cov_size=cov_offset[i+1]-cov_offset[i];
+		float64_t* cov_sum=SG_MALLOC(float64_t, cov_size);
+		memcpy(cov_sum, cov_sums.vector+cov_offset[i], cov_size*sizeof(float64_t));
+
+		switch (m_components[i]->get_cov_type())
 		{
 			case FULL:
 				for (int32_t j=0; j<num_dim*num_dim; j++)
@@ -628,7 +939,7 @@ void CGMM::max_likelihood(SGMatrix<float64_t> alpha, float64_t min_cov)
 		alpha_sum_sum+=alpha_sum;
 	}
 
-	for (int32_t i=0; i<alpha.num_cols; i++)
+	for (int32_t i=0; i<means.num_cols; i++)
 		m_coefficients.vector[i]/=alpha_sum_sum;
 }
 
@@ -80,6 +80,28 @@ class CGMM : public CDistribution
 		float64_t train_em(float64_t min_cov=1e-9, int32_t max_iter=1000,
 				float64_t min_change=1e-9);
 
+		/** learn model using mini-batch (stepwise) EM
+		 *
+		 * The training data is traversed in batches of consecutive vectors.
+		 * After the E-step on a batch, the running sufficient statistics
+		 * are interpolated with those of the batch using the step size
+		 * \f$(t+2)^{-\kappa}\f$ and the parameters are updated from them,
+		 * so every update touches only batch_size vectors (Cappe and
+		 * Moulines: On-line expectation-maximization algorithm for latent
+		 * data models, 2009). If the model has no parameters yet, it is
+		 * initialized by k-means on the training data as in train_em(...).
+		 *
+		 * @param batch_size number of vectors per update
+		 * @param num_epochs number of passes over the training data
+		 * @param min_cov minimum covariance
+		 * @param kappa step size decay (in (0.5,1])
+		 *
+		 * @return log likelihood of the batches of the last pass (each
+		 * computed before its update)
+		 */
+		float64_t train_em_minibatch(int32_t batch_size=256, int32_t num_epochs=10,
+				float64_t min_cov=1e-9, float64_t kappa=0.6);
+
 		/** learn model using SMEM
 		 *
 		 * @param max_iter maximum SMEM iterations
@@ -229,6 +251,12 @@ class CGMM : public CDistribution
 		 */
 		SGMatrix<float64_t> alpha_init(SGMatrix<float64_t> init_means);
 
+		/** initialize parameters by k-means clustering of the training data
+		 *
+		 * @param min_cov minimum covariance
+		 */
+		void kmeans_init(float64_t min_cov);
+
 		/** Initialize parameters for serialization */
 		void register_params();
 
@@ -244,6 +272,61 @@ class CGMM : public CDistribution
 		void partial_em(int32_t comp1, int32_t comp2, int32_t comp3,
 				float64_t min_cov, int32_t max_em_iter, float64_t min_change);
 
+		/** compute log(coefficients[j]*p(x_i|components[j])) for a range of
+		 * the training vectors, in parallel over blocks of vectors
+		 *
+		 * @param components Gaussian components
+		 * @param coefficients mixing coefficients
+		 * @param start index of first vector
+		 * @param num number of vectors
+		 * @param logPxy log joint probabilities (num x number of components, row-major)
+		 */
+		void compute_log_joint(const vector<CGaussian*>& components,
+				SGVector<float64_t> coefficients, index_t start, index_t num,
+				float64_t* logPxy);
+
+		/** E-step on a range of the training vectors
+		 *
+		 * @param start index of first vector
+		 * @param alpha point assignment, one row per vector of the range
+		 *
+		 * @return log likelihood of the range
+		 */
+		float64_t expectation(index_t start, SGMatrix<float64_t> alpha);
+
+		/** weighted sufficient statistics of a range of the training
+		 * vectors, summed in parallel over blocks of vectors
+		 *
+		 * @param start index of first vector
+		 * @param alpha point assignment, one row per vector of the range
+		 * @param cov_offset offsets of the components' covariance sums
+		 * @param alpha_sums sums of the assignments of each component
+		 * @param means weighted means (one per column)
+		 * @param cov_sums weighted sums of (outer) products of differences
+		 * to the means (for a spherical covariance summed over dimensions)
+		 */
+		void compute_statistics(index_t start, SGMatrix<float64_t> alpha,
+				SGVector<index_t> cov_offset, SGVector<float64_t> alpha_sums,
+				SGMatrix<float64_t> means, SGVector<float64_t> cov_sums);
+
+		/** update parameters from sufficient statistics
+		 *
+		 * @param cov_offset offsets of the components' covariance sums
+		 * @param alpha_sums sums of the assignments of each component
+		 * @param means weighted means (one per column)
+		 * @param cov_sums weighted sums of (outer) products of differences
+		 * to the means
+		 * @param min_cov minimum covariance
+		 */
+		void set_statistics(SGVector<index_t> cov_offset,
+				SGVector<float64_t> alpha_sums, SGMatrix<float64_t> means,
+				SGVector<float64_t> cov_sums, float64_t min_cov);
+
+		/** @return offsets of the components' covariance sums (the last
+		 * element is the total size)
+		 */
+		SGVector<index_t> get_cov_offset(int32_t num_dim);
+
 	protected:
 		/** Mixture components */
 		vector<CGaussian*> m_components;
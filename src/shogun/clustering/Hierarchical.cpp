@@ -15,31 +15,252 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/base/Parallel.h>
 
-#ifdef HAVE_PTHREAD
-#include <pthread.h>
-#endif
+#include <shogun/features/DenseFeatures.h>
+
+#include <vector>
+#include <algorithm>
 
 using namespace shogun;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
-struct pair
+/** Ward linkage clusters represented by their centroids */
+struct ward_clusters
+{
+	/** dissimilarity of clusters a and b (squared Ward distance) */
+	inline float64_t dissimilarity(int32_t a, int32_t b) const
+	{
+		const float64_t* ca=centroids+int64_t(a)*dim;
+		const float64_t* cb=centroids+int64_t(b)*dim;
+		float64_t sq=0;
+		for (int32_t k=0; k<dim; k++)
+			sq+=(ca[k]-cb[k])*(ca[k]-cb[k]);
+		return 2.0*sizes[a]*sizes[b]/(sizes[a]+sizes[b])*sq;
+	}
+
+	/** merge cluster b into cluster a */
+	inline void merge(int32_t a, int32_t b, const std::vector<int32_t>& active,
+			int32_t num_threads)
+	{
+		float64_t* ca=centroids+int64_t(a)*dim;
+		const float64_t* cb=centroids+int64_t(b)*dim;
+		for (int32_t k=0; k<dim; k++)
+			ca[k]=(sizes[a]*ca[k]+sizes[b]*cb[k])/(sizes[a]+sizes[b]);
+		sizes[a]+=sizes[b];
+	}
+
+	/** linkage of a dissimilarity */
+	inline float64_t linkage(float64_t dissimilarity) const
+	{
+		return CMath::sqrt(dissimilarity);
+	}
+
+	/** dimension */
+	int32_t dim;
+	/** centroids (dim x num) */
+	float64_t* centroids;
+	/** cluster sizes */
+	int32_t* sizes;
+};
+
+/** clusters with stored (condensed) matrix of pairwise linkages */
+struct matrix_clusters
+{
+	/** stored linkage of clusters a and b */
+	inline float64_t& at(int32_t a, int32_t b)
+	{
+		if (a>b)
+			CMath::swap(a, b);
+		return dists[int64_t(a)*num-int64_t(a)*(a+1)/2+b-a-1];
+	}
+
+	/** dissimilarity of clusters a and b */
+	inline float64_t dissimilarity(int32_t a, int32_t b)
+	{
+		return at(a, b);
+	}
+
+	/** merge cluster b into cluster a, updating the linkages by the
+	 * Lance-Williams formula */
+	inline void merge(int32_t a, int32_t b, const std::vector<int32_t>& active,
+			int32_t num_threads)
+	{
+		const float64_t d_ab=at(a, b);
+		const float64_t n_a=sizes[a];
+		const float64_t n_b=sizes[b];
+		const int32_t num_active=active.size();
+
+#pragma omp parallel for num_threads(num_threads)
+		for (int32_t i=0; i<num_active; i++)
+		{
+			int32_t k=active[i];
+			if (k==a || k==b)
+				continue;
+
+			float64_t d_ak=at(a, k);
+			float64_t d_bk=at(b, k);
+			float64_t n_k=sizes[k];
+			switch (type)
+			{
+				case COMPLETE_LINKAGE:
+					at(a, k)=CMath::max(d_ak, d_bk);
+					break;
+				case AVERAGE_LINKAGE:
+					at(a, k)=(n_a*d_ak+n_b*d_bk)/(n_a+n_b);
+					break;
+				case WARD_LINKAGE:
+					at(a, k)=((n_a+n_k)*d_ak+(n_b+n_k)*d_bk-n_k*d_ab)/(n_a+n_b+n_k);
+					break;
+				default:
+					break;
+			}
+		}
+		sizes[a]+=sizes[b];
+	}
+
+	/** linkage of a dissimilarity */
+	inline float64_t linkage(float64_t dissimilarity) const
+	{
+		return type==WARD_LINKAGE ? CMath::sqrt(dissimilarity) : dissimilarity;
+	}
+
+	/** number of objects */
+	int32_t num;
+	/** linkage */
+	ELinkage type;
+	/** linkages of pairs of clusters (squared for Ward linkage) */
+	float64_t* dists;
+	/** cluster sizes */
+	int32_t* sizes;
+};
+
+/** compares merges by distance */
+struct merge_order
 {
-	/** index 1 */
-	int32_t idx1;
-	/** index 2 */
-	int32_t idx2;
+	/** @return whether merge i is done before merge j */
+	inline bool operator()(int32_t i, int32_t j) const
+	{
+		return dists[i]<dists[j];
+	}
+
+	/** merge distances */
+	const float64_t* dists;
 };
+
+/** nearest neighbor chain algorithm: follows nearest neighbors from any
+ * cluster until two clusters are each others nearest neighbors, which are
+ * merged. For reducible linkages the rest of the chain stays valid. */
+template <class Clusters>
+static void nn_chain(Clusters& clusters, int32_t num, int32_t num_threads,
+		int32_t* merge_points, float64_t* merge_dists)
+{
+	std::vector<int32_t> active(num);
+	std::vector<int32_t> position(num);
+	for (int32_t i=0; i<num; i++)
+	{
+		active[i]=i;
+		position[i]=i;
+	}
+
+	std::vector<int32_t> chain;
+	chain.reserve(num);
+
+	for (int32_t l=0; l<num-1; l++)
+	{
+		while (true)
+		{
+			if (chain.empty())
+				chain.push_back(active[0]);
+
+			const int32_t a=chain.back();
+			const int32_t prev=chain.size()>1 ? chain[chain.size()-2] : -1;
+			const int32_t num_active=active.size();
+
+			/* the previous cluster of the chain wins ties so the chain
+			 * can't run into a cycle */
+			float64_t best=prev>=0 ? clusters.dissimilarity(a, prev) : CMath::INFTY;
+			int32_t best_index=prev;
+
+#pragma omp parallel num_threads(num_threads)
+			{
+				float64_t thread_best=CMath::INFTY;
+				int32_t thread_index=-1;
+
+#pragma omp for
+				for (int32_t i=0; i<num_active; i++)
+				{
+					int32_t c=active[i];
+					if (c==a || c==prev)
+						continue;
+
+					float64_t d=clusters.dissimilarity(a, c);
+					if (thread_index<0 || d<thread_best || (d==thread_best && c<thread_index))
+					{
+						thread_best=d;
+						thread_index=c;
+					}
+				}
+
+#pragma omp critical
+				{
+					if (thread_index>=0 && (best_index<0 || thread_best<best ||
+							(thread_best==best && best_index!=prev && thread_index<best_index)))
+					{
+						best=thread_best;
+						best_index=thread_index;
+					}
+				}
+			}
+
+			if (best_index!=prev)
+			{
+				chain.push_back(best_index);
+				continue;
+			}
+
+			chain.pop_back();
+			chain.pop_back();
+
+			merge_points[2*l]=a;
+			merge_points[2*l+1]=prev;
+			merge_dists[l]=clusters.linkage(best);
+
+			clusters.merge(a, prev, active, num_threads);
+			int32_t last=active.back();
+			active[position[prev]]=last;
+			position[last]=position[prev];
+			active.pop_back();
+			break;
+		}
+	}
+}
+
+/** root of the tree of i, compressing the path */
+static int32_t find_root(int32_t* parent, int32_t i)
+{
+	int32_t root=i;
+	while (parent[root]!=root)
+		root=parent[root];
+
+	while (parent[i]!=root)
+	{
+		int32_t next=parent[i];
+		parent[i]=root;
+		i=next;
+	}
+
+	return root;
+}
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 CHierarchical::CHierarchical()
-: CDistanceMachine(), merges(3), dimensions(0), assignment(NULL),
-	table_size(0), pairs(NULL), merge_distance(NULL)
+: CDistanceMachine(), merges(3), linkage(SINGLE_LINKAGE), dimensions(0),
+	assignment(NULL), table_size(0), pairs(NULL), merge_distance(NULL)
 {
 }
 
-CHierarchical::CHierarchical(int32_t merges_, CDistance* d)
-: CDistanceMachine(), merges(merges_), dimensions(0), assignment(NULL),
-	table_size(0), pairs(NULL), merge_distance(NULL)
+CHierarchical::CHierarchical(int32_t merges_, CDistance* d, ELinkage l)
+: CDistanceMachine(), merges(merges_), linkage(l), dimensions(0),
+	assignment(NULL), table_size(0), pairs(NULL), merge_distance(NULL)
 {
 	set_distance(d);
 }
@@ -69,8 +290,6 @@ bool CHierarchical::train_machine(CFeatures* data)
 	int32_t num=lhs->get_num_vectors();
 	ASSERT(num>0)
 
-	const int32_t num_pairs=num*(num-1)/2;
-
 	SG_FREE(merge_distance);
 	merge_distance=SG_MALLOC(float64_t, num);
 	SGVector<float64_t>::fill_vector(merge_distance, num, -1.0);
@@ -83,76 +302,197 @@ bool CHierarchical::train_machine(CFeatures* data)
 	pairs=SG_MALLOC(int32_t, 2*num);
 	SGVector<int32_t>::fill_vector(pairs, 2*num, -1);
 
-	pair* index=SG_MALLOC(pair, num_pairs);
-	float64_t* distances=SG_MALLOC(float64_t, num_pairs);
+	int32_t* merge_points=SG_MALLOC(int32_t, 2*num);
+	float64_t* merge_dists=SG_MALLOC(float64_t, num);
 
-	int32_t offs=0;
-	for (int32_t i=0; i<num; i++)
-	{
-		for (int32_t j=i+1; j<num; j++)
-		{
-			distances[offs]=distance->distance(i,j);
-			index[offs].idx1=i;
-			index[offs].idx2=j;
-			offs++;					//offs=i*(i+1)/2+j
-		}
-		SG_PROGRESS(i, 0, num-1)
-	}
+	if (linkage==SINGLE_LINKAGE)
+		minimum_spanning_tree(num, merge_points, merge_dists);
+	else
+		nearest_neighbor_chain(num, merge_points, merge_dists);
 
-	CMath::qsort_index<float64_t,pair>(distances, index, (num-1)*num/2);
-	//CMath::display_vector(distances, (num-1)*num/2, "dists");
+	store_merges(num, merge_points, merge_dists);
 
-	int32_t k=-1;
-	int32_t l=0;
-	for (; l<num && (num-l)>=merges && k<num_pairs-1; l++)
-	{
-		while (k<num_pairs-1)
-		{
-			k++;
+	SG_FREE(merge_points);
+	SG_FREE(merge_dists);
 
-			int32_t i=index[k].idx1;
-			int32_t j=index[k].idx2;
-			int32_t c1=assignment[i];
-			int32_t c2=assignment[j];
+	assignment_size=num;
+	ASSERT(table_size>0)
+	SG_UNREF(lhs)
 
-			if (c1==c2)
-				continue;
+	return true;
+}
+
+void CHierarchical::minimum_spanning_tree(int32_t num, int32_t* merge_points,
+		float64_t* merge_dists)
+{
+	int32_t num_threads=parallel->get_num_threads();
+
+	/* distance of each object outside of the tree to the tree and the
+	 * object of the tree it is closest to */
+	SGVector<float64_t> tree_dist(num);
+	SGVector<int32_t> nearest(num);
+	tree_dist.set_const(CMath::INFTY);
+	nearest.set_const(0);
 
-			SG_PROGRESS(k, 0, num_pairs-1)
+	std::vector<int32_t> remaining(num>0 ? num-1 : 0);
+	for (int32_t i=1; i<num; i++)
+		remaining[i-1]=i;
 
-			if (c1<c2)
+	int32_t added=0;
+	for (int32_t l=0; l<num-1; l++)
+	{
+		const int32_t num_remaining=remaining.size();
+		float64_t best=CMath::INFTY;
+		int32_t best_pos=-1;
+
+#pragma omp parallel num_threads(num_threads)
+		{
+			float64_t thread_best=CMath::INFTY;
+			int32_t thread_pos=-1;
+
+#pragma omp for
+			for (int32_t i=0; i<num_remaining; i++)
 			{
-				pairs[2*l]=c1;
-				pairs[2*l+1]=c2;
+				int32_t j=remaining[i];
+				float64_t d=distance->distance(added, j);
+				if (d<tree_dist[j])
+				{
+					tree_dist[j]=d;
+					nearest[j]=added;
+				}
+
+				if (thread_pos<0 || tree_dist[j]<thread_best ||
+						(tree_dist[j]==thread_best && j<remaining[thread_pos]))
+				{
+					thread_best=tree_dist[j];
+					thread_pos=i;
+				}
 			}
-			else
+
+#pragma omp critical
 			{
-				pairs[2*l]=c2;
-				pairs[2*l+1]=c1;
+				if (thread_pos>=0 && (best_pos<0 || thread_best<best ||
+						(thread_best==best && remaining[thread_pos]<remaining[best_pos])))
+				{
+					best=thread_best;
+					best_pos=thread_pos;
+				}
 			}
-			merge_distance[l]=distances[k];
+		}
 
-			int32_t c=num+l;
-			for (int32_t m=0; m<num; m++)
+		added=remaining[best_pos];
+		merge_points[2*l]=nearest[added];
+		merge_points[2*l+1]=added;
+		merge_dists[l]=best;
+
+		remaining[best_pos]=remaining.back();
+		remaining.pop_back();
+
+		SG_PROGRESS(l, 0, num-1)
+	}
+}
+
+void CHierarchical::nearest_neighbor_chain(int32_t num, int32_t* merge_points,
+		float64_t* merge_dists)
+{
+	int32_t num_threads=parallel->get_num_threads();
+	CFeatures* lhs=distance->get_lhs();
+
+	SGVector<int32_t> sizes(num);
+	sizes.set_const(1);
+
+	if (linkage==WARD_LINKAGE && distance->get_distance_type()==D_EUCLIDEAN &&
+			lhs->get_feature_class()==C_DENSE && lhs->get_feature_type()==F_DREAL)
+	{
+		CDenseFeatures<float64_t>* dense=(CDenseFeatures<float64_t>*) lhs;
+		int32_t dim=dense->get_num_features();
+		SGMatrix<float64_t> centroids(dim, num);
+		for (int32_t i=0; i<num; i++)
+		{
+			SGVector<float64_t> vec=dense->get_feature_vector(i);
+			memcpy(centroids.get_column_vector(i), vec.vector, dim*sizeof(float64_t));
+			dense->free_feature_vector(vec, i);
+		}
+
+		ward_clusters clusters;
+		clusters.dim=dim;
+		clusters.centroids=centroids.matrix;
+		clusters.sizes=sizes.vector;
+		nn_chain(clusters, num, num_threads, merge_points, merge_dists);
+	}
+	else
+	{
+		float64_t* dists=SG_MALLOC(float64_t, int64_t(num)*(num-1)/2);
+
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+		for (int32_t i=0; i<num; i++)
+		{
+			float64_t* row=dists+int64_t(i)*num-int64_t(i)*(i+1)/2-i-1;
+			for (int32_t j=i+1; j<num; j++)
 			{
-				if (assignment[m] == c1 || assignment[m] == c2)
-					assignment[m] = c;
+				float64_t d=distance->distance(i, j);
+				row[j]=linkage==WARD_LINKAGE ? d*d : d;
 			}
-#ifdef DEBUG_HIERARCHICAL
-			SG_PRINT("l=%04i i=%04i j=%04i c1=%+04d c2=%+04d c=%+04d dist=%6.6f\n", l,i,j, c1,c2,c, merge_distance[l])
-#endif
-			break;
 		}
+
+		matrix_clusters clusters;
+		clusters.num=num;
+		clusters.type=linkage;
+		clusters.dists=dists;
+		clusters.sizes=sizes.vector;
+		nn_chain(clusters, num, num_threads, merge_points, merge_dists);
+
+		SG_FREE(dists);
 	}
 
-	assignment_size=num;
-	table_size=l-1;
-	ASSERT(table_size>0)
-	SG_FREE(distances);
-	SG_FREE(index);
-	SG_UNREF(lhs)
+	SG_UNREF(lhs);
+}
 
-	return true;
+void CHierarchical::store_merges(int32_t num, const int32_t* merge_points,
+		const float64_t* merge_dists)
+{
+	/* merges are found in arbitrary order but the linkages are monotonic,
+	 * so sorting them (stable, to keep merges of equal distance after
+	 * those they depend on) yields the dendrogram */
+	std::vector<int32_t> order(num>0 ? num-1 : 0);
+	for (int32_t l=0; l<num-1; l++)
+		order[l]=l;
+	merge_order compare;
+	compare.dists=merge_dists;
+	std::stable_sort(order.begin(), order.end(), compare);
+
+	/* merges up to the requested number of clusters define the assignment */
+	const int32_t num_assigned=CMath::min(num-1, num-merges+1);
+	table_size=CMath::min(num-1, num-merges);
+
+	SGVector<int32_t> parent(num);
+	SGVector<int32_t> cluster(num);
+	parent.range_fill();
+	cluster.range_fill();
+
+	for (int32_t l=0; l<num-1; l++)
+	{
+		int32_t root1=find_root(parent.vector, merge_points[2*order[l]]);
+		int32_t root2=find_root(parent.vector, merge_points[2*order[l]+1]);
+		int32_t c1=cluster[root1];
+		int32_t c2=cluster[root2];
+
+		pairs[2*l]=CMath::min(c1, c2);
+		pairs[2*l+1]=CMath::max(c1, c2);
+		merge_distance[l]=merge_dists[order[l]];
+
+		parent[root2]=root1;
+		cluster[root1]=num+l;
+
+		if (l==num_assigned-1)
+		{
+			for (int32_t m=0; m<num; m++)
+				assignment[m]=cluster[find_root(parent.vector, m)];
+		}
+#ifdef DEBUG_HIERARCHICAL
+		SG_PRINT("l=%04i c1=%+04d c2=%+04d c=%+04d dist=%6.6f\n", l, c1, c2, num+l, merge_distance[l])
+#endif
+	}
 }
 
 bool CHierarchical::load(FILE* srcfile)
@@ -190,6 +530,26 @@ SGMatrix<int32_t> CHierarchical::get_cluster_pairs()
 	return SGMatrix<int32_t>(pairs,2,merges, false);
 }
 
+SGMatrix<float64_t> CHierarchical::get_dendrogram()
+{
+	ASSERT(pairs)
+	int32_t num=assignment_size;
+	SGMatrix<float64_t> dendrogram(4, num-1);
+	SGVector<int32_t> sizes(2*num-1);
+	sizes.set_const(1);
+
+	for (int32_t l=0; l<num-1; l++)
+	{
+		sizes[num+l]=sizes[pairs[2*l]]+sizes[pairs[2*l+1]];
+		dendrogram(0, l)=pairs[2*l];
+		dendrogram(1, l)=pairs[2*l+1];
+		dendrogram(2, l)=merge_distance[l];
+		dendrogram(3, l)=sizes[num+l];
+	}
+
+	return dendrogram;
+}
+
 
 void CHierarchical::store_model_features()
 {
@@ -21,11 +21,24 @@ namespace shogun
 {
 class CDistanceMachine;
 
-/** @brief Agglomerative hierarchical single linkage clustering.
+/** linkage, i.e. distance between clusters */
+enum ELinkage
+{
+	/** minimum distance of the elements */
+	SINGLE_LINKAGE,
+	/** maximum distance of the elements */
+	COMPLETE_LINKAGE,
+	/** average distance of the elements */
+	AVERAGE_LINKAGE,
+	/** increase of the within-cluster variance (Ward's method) */
+	WARD_LINKAGE
+};
+
+/** @brief Agglomerative hierarchical clustering.
  *
  * Starting with each object being assigned to its own cluster clusters are
- * iteratively merged.  Here the clusters are merged whose elements have
- * minimum distance, i.e.  the clusters A and B that obtain
+ * iteratively merged.  Here the clusters with minimum linkage are merged,
+ * for single linkage (the default) the clusters A and B that obtain
  *
  * \f[
  * \min\{d({\bf x},{\bf x'}): {\bf x}\in {\cal A},{\bf x'}\in {\cal B}\}
@@ -33,6 +46,16 @@ class CDistanceMachine;
  *
  * are merged.
  *
+ * Single linkage clustering is obtained from a minimum spanning tree
+ * grown by Prim's algorithm, which works with any distance and needs
+ * O(n) memory. Complete, average and Ward linkage use the nearest
+ * neighbor chain algorithm (Murtagh: A survey of recent advances in
+ * hierarchical clustering algorithms, 1983). Ward linkage on dense real
+ * valued features with euclidean distance only keeps the cluster centroids,
+ * otherwise the distances of all pairs of clusters are stored (n(n-1)/2
+ * values) and updated by the Lance-Williams formula. All distances are
+ * computed in parallel.
+ *
  * cf e.g. http://en.wikipedia.org/wiki/Data_clustering*/
 class CHierarchical : public CDistanceMachine
 {
@@ -44,8 +67,9 @@ class CHierarchical : public CDistanceMachine
 		 *
 		 * @param merges the merges
 		 * @param d distance
+		 * @param l linkage
 		 */
-		CHierarchical(int32_t merges, CDistance* d);
+		CHierarchical(int32_t merges, CDistance* d, ELinkage l=SINGLE_LINKAGE);
 		virtual ~CHierarchical();
 
 		/** problem type */
@@ -87,6 +111,24 @@ class CHierarchical : public CDistanceMachine
 		 */
 		int32_t get_merges();
 
+		/** set linkage
+		 *
+		 * @param l new linkage
+		 */
+		inline void set_linkage(ELinkage l)
+		{
+			linkage=l;
+		}
+
+		/** get linkage
+		 *
+		 * @return linkage
+		 */
+		inline ELinkage get_linkage()
+		{
+			return linkage;
+		}
+
 		/** get assignment
 		 *
 		 */
@@ -102,6 +144,17 @@ class CHierarchical : public CDistanceMachine
 		 */
 		SGMatrix<int32_t> get_cluster_pairs();
 
+		/** get the full dendrogram
+		 *
+		 * Column l describes the l-th merge: the two merged clusters, the
+		 * distance at which they are merged and the number of objects of
+		 * the new cluster. Objects are clusters 0,...,n-1, the l-th merge
+		 * creates cluster n+l.
+		 *
+		 * @return dendrogram (4 x n-1)
+		 */
+		SGMatrix<float64_t> get_dendrogram();
+
 		/** @return object name */
 		virtual const char* get_name() const { return "Hierarchical"; }
 
@@ -123,10 +176,41 @@ class CHierarchical : public CDistanceMachine
 
 		virtual bool train_require_labels() const { return false; }
 
+		/** single linkage merges from the edges of a minimum spanning tree
+		 *
+		 * @param num number of objects
+		 * @param merge_points objects of the merged clusters (2 x num-1)
+		 * @param merge_dists merge distances
+		 */
+		void minimum_spanning_tree(int32_t num, int32_t* merge_points,
+				float64_t* merge_dists);
+
+		/** complete, average or Ward linkage merges by the nearest neighbor
+		 * chain algorithm
+		 *
+		 * @param num number of objects
+		 * @param merge_points objects of the merged clusters (2 x num-1)
+		 * @param merge_dists merge distances
+		 */
+		void nearest_neighbor_chain(int32_t num, int32_t* merge_points,
+				float64_t* merge_dists);
+
+		/** sort merges by distance and store them as merges of clusters
+		 *
+		 * @param num number of objects
+		 * @param merge_points objects of the merged clusters (2 x num-1)
+		 * @param merge_dists merge distances
+		 */
+		void store_merges(int32_t num, const int32_t* merge_points,
+				const float64_t* merge_dists);
+
 	protected:
 		/// the number of merges in hierarchical clustering
 		int32_t merges;
 
+		/// linkage
+		ELinkage linkage;
+
 		/// number of dimensions
 		int32_t dimensions;
 
@@ -22,6 +22,7 @@ CEmbeddingConverter::CEmbeddingConverter()
 	m_target_dim = 1;
 	m_distance = new CEuclideanDistance();
 	m_kernel = new CLinearKernel();
+	m_approximate_neighbors = false;
 
 	init();
 }
@@ -74,6 +75,16 @@ CKernel* CEmbeddingConverter::get_kernel() const
 	return m_kernel;
 }
 
+void CEmbeddingConverter::set_approximate_neighbors(bool approximate)
+{
+	m_approximate_neighbors = approximate;
+}
+
+bool CEmbeddingConverter::get_approximate_neighbors() const
+{
+	return m_approximate_neighbors;
+}
+
 void CEmbeddingConverter::init()
 {
 	SG_ADD(&m_target_dim, "target_dim",
@@ -82,5 +93,7 @@ void CEmbeddingConverter::init()
 	    "distance to be used for embedding", MS_AVAILABLE);
 	SG_ADD((CSGObject**)&m_kernel, "kernel", "kernel to be used for embedding",
 	    MS_AVAILABLE);
+	SG_ADD(&m_approximate_neighbors, "approximate_neighbors",
+	    "whether neighbors may be found approximately", MS_NOT_AVAILABLE);
 }
 }
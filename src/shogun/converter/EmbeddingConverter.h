@@ -81,6 +81,18 @@ public:
 	 */
 	CKernel* get_kernel() const;
 
+	/** setter for approximate neighbors search, which only has effect
+	 * for methods relying on a neighborhood graph when it is computed
+	 * on dense features w.r.t. euclidean distance or linear kernel
+	 * @param approximate whether neighbors may be found approximately
+	 */
+	void set_approximate_neighbors(bool approximate);
+
+	/** getter for approximate neighbors search
+	 * @return whether neighbors may be found approximately
+	 */
+	bool get_approximate_neighbors() const;
+
 	virtual const char* get_name() const { return "EmbeddingConverter"; };
 
 protected:
@@ -98,6 +110,9 @@ protected:
 
 	/** kernel to be used */
 	CKernel* m_kernel;
+
+	/** whether neighbors may be found approximately */
+	bool m_approximate_neighbors;
 };
 }
 
@@ -99,8 +99,14 @@ CFeatures* CHashedDocConverter::apply(CFeatures* features)
 }
 
 SGSparseVector<float64_t> CHashedDocConverter::apply(SGVector<char> document)
+{
+	return apply(document, tokenizer);
+}
+
+SGSparseVector<float64_t> CHashedDocConverter::apply(SGVector<char> document, CTokenizer* tzer)
 {
 	ASSERT(document.size()>0)
+	ASSERT(tzer)
 	const int32_t array_size = 1024*1024;
 	/** the array will contain all the hashes generated from the tokens */
 	CDynamicArray<uint32_t> hashed_indices(array_size);
@@ -118,20 +124,20 @@ SGSparseVector<float64_t> CHashedDocConverter::apply(SGVector<char> document)
 
 	/** Reading n+s-1 tokens */
 	const int32_t seed = 0xdeadbeaf;
-	tokenizer->set_text(document);
+	tzer->set_text(document);
 	index_t token_start = 0;
-	while (hashes_end<ngrams-1+tokens_to_skip && tokenizer->has_next())
+	while (hashes_end<ngrams-1+tokens_to_skip && tzer->has_next())
 	{
-		index_t end = tokenizer->next_token_idx(token_start);
+		index_t end = tzer->next_token_idx(token_start);
 		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &document.vector[token_start],
 				end-token_start, seed);
 		cached_hashes[hashes_end++] = token_hash;
 	}
 
 	/** Reading token and storing index to hashed_indices */
-	while (tokenizer->has_next())
+	while (tzer->has_next())
 	{
-		index_t end = tokenizer->next_token_idx(token_start);
+		index_t end = tzer->next_token_idx(token_start);
 		uint32_t token_hash = CHash::MurmurHash3((uint8_t* ) &document.vector[token_start],
 				end-token_start, seed);
 		cached_hashes[hashes_end] = token_hash;
@@ -62,6 +62,7 @@ CDenseFeatures<float64_t>* CIsomap::embed_distance(CDistance* distance)
 	}
 	parameters.n_neighbors = m_k;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.distance = distance;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
 	return embedding;
@@ -66,6 +66,7 @@ CDenseFeatures<float64_t>* CKernelLocallyLinearEmbedding::embed_kernel(CKernel*
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_KERNEL_LOCALLY_LINEAR_EMBEDDING;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.kernel = kernel;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
 	return embedding;
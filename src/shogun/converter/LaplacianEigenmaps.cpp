@@ -87,6 +87,7 @@ CDenseFeatures<float64_t>* CLaplacianEigenmaps::embed_distance(CDistance* distan
 	parameters.gaussian_kernel_width = m_tau;
 	parameters.method = SHOGUN_LAPLACIAN_EIGENMAPS;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.distance = distance;
 	return tapkee_embed(parameters);
 }
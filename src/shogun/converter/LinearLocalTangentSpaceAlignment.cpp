@@ -38,6 +38,7 @@ CFeatures* CLinearLocalTangentSpaceAlignment::apply(CFeatures* features)
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_LINEAR_LOCAL_TANGENT_SPACE_ALIGNMENT;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.kernel = kernel;
 	parameters.features = (CDotFeatures*)features;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
@@ -38,6 +38,7 @@ CFeatures* CLocalTangentSpaceAlignment::apply(CFeatures* features)
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_LOCAL_TANGENT_SPACE_ALIGNMENT;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.kernel = kernel;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
 	SG_UNREF(kernel);
@@ -38,6 +38,7 @@ CFeatures* CLocalityPreservingProjections::apply(CFeatures* features)
 	parameters.gaussian_kernel_width = m_tau;
 	parameters.method = SHOGUN_LOCALITY_PRESERVING_PROJECTIONS;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.distance = m_distance;
 	parameters.features = (CDotFeatures*)features;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
@@ -87,6 +87,7 @@ CFeatures* CLocallyLinearEmbedding::apply(CFeatures* features)
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_LOCALLY_LINEAR_EMBEDDING;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.kernel = kernel;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
 	SG_UNREF(kernel);
@@ -93,6 +93,7 @@ CFeatures* CManifoldSculpting::apply(CFeatures* features)
 
 	parameters.method = SHOGUN_MANIFOLD_SCULPTING;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
 
 	SG_UNREF(euclidean_distance);
@@ -39,6 +39,7 @@ CFeatures* CNeighborhoodPreservingEmbedding::apply(CFeatures* features)
 	parameters.eigenshift = m_nullspace_shift;
 	parameters.method = SHOGUN_NEIGHBORHOOD_PRESERVING_EMBEDDING;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.kernel = kernel;
 	parameters.features = (CDotFeatures*)features;
 	CDenseFeatures<float64_t>* embedding = tapkee_embed(parameters);
@@ -143,6 +143,7 @@ CDenseFeatures< float64_t >* CStochasticProximityEmbedding::embed_distance(CDist
 	parameters.n_neighbors = m_k;
 	parameters.method = SHOGUN_STOCHASTIC_PROXIMITY_EMBEDDING;
 	parameters.target_dimension = m_target_dim;
+	parameters.approximate_neighbors = m_approximate_neighbors;
 	parameters.spe_num_updates = m_nupdates;
 	parameters.spe_tolerance = m_tolerance;
 	parameters.distance = distance;
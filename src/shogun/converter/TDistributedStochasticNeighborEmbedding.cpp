@@ -21,6 +21,8 @@ CTDistributedStochasticNeighborEmbedding::CTDistributedStochasticNeighborEmbeddi
 	// Default values
 	m_perplexity = 30.0;
 	m_theta = 0.5;
+	m_single_precision = false;
+	m_min_gradient_norm = 0.0;
 	init();
 }
 
@@ -28,6 +30,10 @@ void CTDistributedStochasticNeighborEmbedding::init()
 {
 	SG_ADD(&m_perplexity, "perplexity", "perplexity", MS_NOT_AVAILABLE);
 	SG_ADD(&m_theta, "theta", "learning rate", MS_NOT_AVAILABLE);
+	SG_ADD(&m_single_precision, "single_precision",
+		"whether the gradient is computed in single precision", MS_NOT_AVAILABLE);
+	SG_ADD(&m_min_gradient_norm, "min_gradient_norm", "minimal gradient norm",
+		MS_NOT_AVAILABLE);
 }
 
 CTDistributedStochasticNeighborEmbedding::~CTDistributedStochasticNeighborEmbedding()
@@ -60,11 +66,33 @@ float64_t CTDistributedStochasticNeighborEmbedding::get_perplexity() const
 	return m_perplexity;
 }
 
+void CTDistributedStochasticNeighborEmbedding::set_single_precision(const bool single_precision)
+{
+	m_single_precision = single_precision;
+}
+
+bool CTDistributedStochasticNeighborEmbedding::get_single_precision() const
+{
+	return m_single_precision;
+}
+
+void CTDistributedStochasticNeighborEmbedding::set_min_gradient_norm(const float64_t min_gradient_norm)
+{
+	m_min_gradient_norm = min_gradient_norm;
+}
+
+float64_t CTDistributedStochasticNeighborEmbedding::get_min_gradient_norm() const
+{
+	return m_min_gradient_norm;
+}
+
 CFeatures* CTDistributedStochasticNeighborEmbedding::apply(CFeatures* features)
 {
 	TAPKEE_PARAMETERS_FOR_SHOGUN parameters;
 	parameters.sne_theta = m_theta;
 	parameters.sne_perplexity = m_perplexity;
+	parameters.sne_single_precision = m_single_precision;
+	parameters.sne_min_gradient_norm = m_min_gradient_norm;
 	parameters.features = (CDotFeatures*)features;
 
 	parameters.method = SHOGUN_TDISTRIBUTED_STOCHASTIC_NEIGHBOR_EMBEDDING;
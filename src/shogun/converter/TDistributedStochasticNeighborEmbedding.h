@@ -68,6 +68,32 @@ public:
 	 */
 	float64_t get_perplexity() const;
 
+	/** setter for single precision, which makes the Barnes-Hut
+	 * approximation of the gradient be computed with 32-bit floats
+	 *
+	 * @param single_precision whether to use single precision
+	 */
+	void set_single_precision(const bool single_precision);
+
+	/** getter for single precision
+	 *
+	 * @return whether single precision is used
+	 */
+	bool get_single_precision() const;
+
+	/** setter for the minimal gradient norm, optimization stops
+	 * early once the norm of the gradient is lower than that
+	 *
+	 * @param min_gradient_norm minimal gradient norm
+	 */
+	void set_min_gradient_norm(const float64_t min_gradient_norm);
+
+	/** getter for the minimal gradient norm
+	 *
+	 * @return minimal gradient norm
+	 */
+	float64_t get_min_gradient_norm() const;
+
 private:
 
 	/** default init */
@@ -81,6 +107,12 @@ private:
 	/** perplexity */
 	float64_t m_perplexity;
 
+	/** whether the gradient is computed in single precision */
+	bool m_single_precision;
+
+	/** minimal gradient norm */
+	float64_t m_min_gradient_norm;
+
 }; /* class CTDistributedStochasticNeighborEmbedding */
 
 } /* namespace shogun */
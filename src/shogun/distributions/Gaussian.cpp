@@ -149,6 +149,65 @@ float64_t CGaussian::compute_log_PDF(SGVector<float64_t> point)
 	return -0.5*answer;
 }
 
+SGVector<float64_t> CGaussian::compute_log_PDF(SGMatrix<float64_t> points)
+{
+	ASSERT(m_mean.vector && m_d.vector)
+	ASSERT(points.num_rows == m_mean.vlen)
+	const int32_t num_dim=m_mean.vlen;
+	const index_t num_points=points.num_cols;
+
+	SGVector<float64_t> answer(num_points);
+	SGVector<float64_t> inv_d(num_dim);
+	for (int32_t i=0; i<num_dim; i++)
+		inv_d[i]=1.0/m_d.vector[m_cov_type==SPHERICAL ? 0 : i];
+
+	if (m_cov_type==FULL)
+	{
+		float64_t* difference=SG_MALLOC(float64_t, int64_t(num_dim)*num_points);
+		for (index_t j=0; j<num_points; j++)
+		{
+			const float64_t* point=points.matrix+int64_t(j)*num_dim;
+			float64_t* diff=difference+int64_t(j)*num_dim;
+			for (int32_t i=0; i<num_dim; i++)
+				diff[i]=point[i]-m_mean.vector[i];
+		}
+
+		/* rows of m_u are the eigenvectors */
+		float64_t* projected=SG_MALLOC(float64_t, int64_t(num_dim)*num_points);
+		cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, num_dim, num_points,
+					num_dim, 1, m_u.matrix, num_dim, difference, num_dim, 0,
+					projected, num_dim);
+
+		for (index_t j=0; j<num_points; j++)
+		{
+			const float64_t* proj=projected+int64_t(j)*num_dim;
+			float64_t quad=0;
+			for (int32_t i=0; i<num_dim; i++)
+				quad+=proj[i]*proj[i]*inv_d[i];
+			answer[j]=-0.5*(m_constant+quad);
+		}
+
+		SG_FREE(projected);
+		SG_FREE(difference);
+	}
+	else
+	{
+		for (index_t j=0; j<num_points; j++)
+		{
+			const float64_t* point=points.matrix+int64_t(j)*num_dim;
+			float64_t quad=0;
+			for (int32_t i=0; i<num_dim; i++)
+			{
+				const float64_t diff=point[i]-m_mean.vector[i];
+				quad+=diff*diff*inv_d[i];
+			}
+			answer[j]=-0.5*(m_constant+quad);
+		}
+	}
+
+	return answer;
+}
+
 SGVector<float64_t> CGaussian::get_mean()
 {
 	return m_mean;
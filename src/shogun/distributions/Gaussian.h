@@ -116,6 +116,17 @@ class CGaussian : public CDistribution
 		 */
 		virtual float64_t compute_log_PDF(SGVector<float64_t> point);
 
+		/** compute log PDF of several points at once
+		 *
+		 * Projections onto the eigenvectors of a full covariance are done
+		 * by a single matrix product, diagonal and spherical covariances
+		 * only need one (vectorized) pass over the points.
+		 *
+		 * @param points points for which to compute the log PDF (one per column)
+		 * @return computed log PDFs
+		 */
+		SGVector<float64_t> compute_log_PDF(SGMatrix<float64_t> points);
+
 		/** get mean
 		 *
 		 * @return mean
@@ -0,0 +1,226 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/evaluation/AUCAccumulator.h>
+#include <shogun/labels/Labels.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/base/Parameter.h>
+
+using namespace shogun;
+
+CAUCAccumulator::CAUCAccumulator() : CSGObject()
+{
+	init(-1.0, 1.0, 1000);
+}
+
+CAUCAccumulator::CAUCAccumulator(float64_t min_value, float64_t max_value,
+		int32_t num_bins) : CSGObject()
+{
+	init(min_value, max_value, num_bins);
+}
+
+CAUCAccumulator::~CAUCAccumulator()
+{
+}
+
+void CAUCAccumulator::init(float64_t min_value, float64_t max_value,
+		int32_t num_bins)
+{
+	REQUIRE(min_value<max_value, "%s: Range of outputs [%f,%f] is empty\n",
+			get_name(), min_value, max_value);
+	REQUIRE(num_bins>0, "%s: Number of bins must be positive, given %d\n",
+			get_name(), num_bins);
+
+	m_min_value=min_value;
+	m_max_value=max_value;
+	m_num_bins=num_bins;
+	m_scale=num_bins/(max_value-min_value);
+	m_positives=SGVector<int64_t>(num_bins);
+	m_negatives=SGVector<int64_t>(num_bins);
+	reset();
+
+	SG_ADD(&m_min_value, "min_value", "Lower end of the range of outputs",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_max_value, "max_value", "Upper end of the range of outputs",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_bins, "num_bins", "Number of bins", MS_NOT_AVAILABLE);
+	SG_ADD(&m_scale, "scale", "Number of bins per unit of outputs",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_positives, "positives", "Number of positive outputs per bin",
+			MS_NOT_AVAILABLE);
+	SG_ADD(&m_negatives, "negatives", "Number of negative outputs per bin",
+			MS_NOT_AVAILABLE);
+}
+
+void CAUCAccumulator::add(CLabels* predicted, CLabels* ground_truth)
+{
+	ASSERT(predicted && ground_truth)
+	ASSERT(predicted->get_num_labels()==ground_truth->get_num_labels())
+	ASSERT(predicted->get_label_type()==LT_BINARY)
+	ASSERT(ground_truth->get_label_type()==LT_BINARY)
+	ground_truth->ensure_valid();
+
+	int32_t length=predicted->get_num_labels();
+	int32_t num_threads=CMath::max(1, CMath::min(parallel->get_num_threads(),
+			length/m_num_bins));
+
+	// one pair of histograms per contiguous range of outputs, added in order
+	SGMatrix<int64_t> counts(2*m_num_bins, num_threads);
+	counts.zero();
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		int64_t* negatives=counts.get_column_vector(t);
+		int64_t* positives=negatives+m_num_bins;
+		int32_t begin=int64_t(length)*t/num_threads;
+		int32_t end=int64_t(length)*(t+1)/num_threads;
+		for (int32_t i=begin; i<end; i++)
+		{
+			int32_t bin=get_bin(predicted->get_value(i));
+			if (ground_truth->get_value(i)>0)
+				positives[bin]++;
+			else
+				negatives[bin]++;
+		}
+	}
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		for (int32_t b=0; b<m_num_bins; b++)
+		{
+			m_negatives[b]+=counts(b, t);
+			m_positives[b]+=counts(m_num_bins+b, t);
+		}
+	}
+}
+
+void CAUCAccumulator::merge(CAUCAccumulator* other)
+{
+	REQUIRE(other, "%s::merge(): Other accumulator is NULL\n", get_name());
+	REQUIRE(other->m_num_bins==m_num_bins && other->m_min_value==m_min_value &&
+			other->m_max_value==m_max_value, "%s::merge(): Bins of accumulators "
+			"differ\n", get_name());
+
+	for (int32_t b=0; b<m_num_bins; b++)
+	{
+		m_positives[b]+=other->m_positives[b];
+		m_negatives[b]+=other->m_negatives[b];
+	}
+}
+
+void CAUCAccumulator::reset()
+{
+	m_positives.zero();
+	m_negatives.zero();
+}
+
+int64_t CAUCAccumulator::get_num_positives() const
+{
+	int64_t pos_count=0;
+	for (int32_t b=0; b<m_num_bins; b++)
+		pos_count+=m_positives[b];
+
+	return pos_count;
+}
+
+int64_t CAUCAccumulator::get_num_negatives() const
+{
+	int64_t neg_count=0;
+	for (int32_t b=0; b<m_num_bins; b++)
+		neg_count+=m_negatives[b];
+
+	return neg_count;
+}
+
+float64_t CAUCAccumulator::get_auROC() const
+{
+	int64_t pos_count=get_num_positives();
+	int64_t neg_count=get_num_negatives();
+	REQUIRE(pos_count>0 && neg_count>0, "%s::get_auROC(): Both positive and "
+			"negative outputs are needed\n", get_name());
+
+	// trapezoids from the largest outputs on, twice their area in counts
+	float64_t area=0.0;
+	int64_t tp=0;
+	for (int32_t b=m_num_bins-1; b>=0; b--)
+	{
+		area+=float64_t(m_negatives[b])*(2*tp+m_positives[b]);
+		tp+=m_positives[b];
+	}
+
+	return 0.5*area/(float64_t(pos_count)*neg_count);
+}
+
+float64_t CAUCAccumulator::get_auPRC() const
+{
+	SGMatrix<float64_t> graph=get_PRC();
+	return CMath::area_under_curve(graph.matrix, graph.num_cols, true);
+}
+
+SGMatrix<float64_t> CAUCAccumulator::get_ROC() const
+{
+	int64_t pos_count=get_num_positives();
+	int64_t neg_count=get_num_negatives();
+	REQUIRE(pos_count>0 && neg_count>0, "%s::get_ROC(): Both positive and "
+			"negative outputs are needed\n", get_name());
+
+	SGMatrix<float64_t> graph(2, m_num_bins+1);
+	graph(0, 0)=0.0;
+	graph(1, 0)=0.0;
+
+	int64_t tp=0;
+	int64_t fp=0;
+	for (int32_t b=m_num_bins-1, j=1; b>=0; b--, j++)
+	{
+		tp+=m_positives[b];
+		fp+=m_negatives[b];
+		graph(0, j)=float64_t(fp)/neg_count;
+		graph(1, j)=float64_t(tp)/pos_count;
+	}
+
+	return graph;
+}
+
+SGMatrix<float64_t> CAUCAccumulator::get_PRC() const
+{
+	int64_t pos_count=get_num_positives();
+	REQUIRE(pos_count>0, "%s::get_PRC(): Positive outputs are needed\n",
+			get_name());
+
+	int32_t num_points=0;
+	for (int32_t b=0; b<m_num_bins; b++)
+		num_points+=(m_positives[b]+m_negatives[b])>0;
+
+	// precision (x) and recall (y) after the outputs of each bin
+	SGMatrix<float64_t> graph(2, num_points);
+	int64_t tp=0;
+	int64_t count=0;
+	for (int32_t b=m_num_bins-1, j=0; b>=0; b--)
+	{
+		if (m_positives[b]+m_negatives[b]==0)
+			continue;
+
+		tp+=m_positives[b];
+		count+=m_positives[b]+m_negatives[b];
+		graph(0, j)=float64_t(tp)/count;
+		graph(1, j)=float64_t(tp)/pos_count;
+		j++;
+	}
+
+	return graph;
+}
+
+SGVector<float64_t> CAUCAccumulator::get_thresholds() const
+{
+	SGVector<float64_t> thresholds(m_num_bins);
+	for (int32_t b=m_num_bins-1, j=0; b>=0; b--, j++)
+		thresholds[j]=m_min_value+b/m_scale;
+
+	return thresholds;
+}
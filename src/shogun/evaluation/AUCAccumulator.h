@@ -0,0 +1,147 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef AUCACCUMULATOR_H_
+#define AUCACCUMULATOR_H_
+
+#include <shogun/lib/config.h>
+#include <shogun/base/SGObject.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+
+namespace shogun
+{
+
+class CLabels;
+
+/** @brief Class AUCAccumulator computes approximate areas under ROC and PRC
+ * curves of binary outputs in constant memory.
+ *
+ * Outputs are counted in a fixed number of equally wide bins over a given
+ * range of outputs, separately for positive and negative ground truth.
+ * Outputs outside the range are counted in the first or last bin. Outputs in
+ * the same bin are treated as equal, so that the areas are exact if no bin
+ * holds two different outputs of a positive and a negative example.
+ *
+ * Accumulators with the same bins can be merged, e.g. the accumulators of
+ * several cross-validation folds or of parts of a stream of outputs.
+ */
+class CAUCAccumulator: public CSGObject
+{
+public:
+	/** default constructor, 1000 bins over [-1,1] */
+	CAUCAccumulator();
+
+	/** constructor
+	 *
+	 * @param min_value lower end of the range of outputs
+	 * @param max_value upper end of the range of outputs
+	 * @param num_bins number of bins
+	 */
+	CAUCAccumulator(float64_t min_value, float64_t max_value,
+			int32_t num_bins=1000);
+
+	/** destructor */
+	virtual ~CAUCAccumulator();
+
+	/** get name */
+	virtual const char* get_name() const { return "AUCAccumulator"; };
+
+	/** add one output
+	 *
+	 * @param value predicted value
+	 * @param positive whether the ground truth is positive
+	 */
+	inline void add(float64_t value, bool positive)
+	{
+		if (positive)
+			m_positives[get_bin(value)]++;
+		else
+			m_negatives[get_bin(value)]++;
+	}
+
+	/** add outputs, in parallel
+	 *
+	 * @param predicted binary labels
+	 * @param ground_truth binary labels assumed to be correct
+	 */
+	void add(CLabels* predicted, CLabels* ground_truth);
+
+	/** add counts of another accumulator with the same bins
+	 *
+	 * @param other accumulator
+	 */
+	void merge(CAUCAccumulator* other);
+
+	/** remove all outputs */
+	void reset();
+
+	/** @return area under ROC curve of outputs added so far */
+	float64_t get_auROC() const;
+
+	/** @return area under PRC curve of outputs added so far */
+	float64_t get_auPRC() const;
+
+	/** @return ROC graph with one point per bin and the point (0,0) */
+	SGMatrix<float64_t> get_ROC() const;
+
+	/** @return PRC graph with one point per non-empty bin */
+	SGMatrix<float64_t> get_PRC() const;
+
+	/** @return thresholds, lower ends of the bins, corresponding to points
+	 * on the ROC graph after (0,0)
+	 */
+	SGVector<float64_t> get_thresholds() const;
+
+	/** @return number of positive outputs added */
+	int64_t get_num_positives() const;
+
+	/** @return number of negative outputs added */
+	int64_t get_num_negatives() const;
+
+	/** @return number of bins */
+	int32_t get_num_bins() const { return m_num_bins; }
+
+protected:
+	/** @return bin of predicted value */
+	inline int32_t get_bin(float64_t value) const
+	{
+		float64_t bin=(value-m_min_value)*m_scale;
+		if (!(bin>=0))
+			return 0;
+		if (bin>=m_num_bins)
+			return m_num_bins-1;
+		return int32_t(bin);
+	}
+
+private:
+	/** initialize with default values and register params */
+	void init(float64_t min_value, float64_t max_value, int32_t num_bins);
+
+protected:
+	/** lower end of the range of outputs */
+	float64_t m_min_value;
+
+	/** upper end of the range of outputs */
+	float64_t m_max_value;
+
+	/** number of bins */
+	int32_t m_num_bins;
+
+	/** number of bins per unit of outputs */
+	float64_t m_scale;
+
+	/** number of positive outputs per bin */
+	SGVector<int64_t> m_positives;
+
+	/** number of negative outputs per bin */
+	SGVector<int64_t> m_negatives;
+};
+
+}
+
+#endif /* AUCACCUMULATOR_H_ */
@@ -0,0 +1,33 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/evaluation/BinaryClassEvaluation.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parallel.h>
+
+using namespace shogun;
+
+SGVector<uint64_t> CBinaryClassEvaluation::sort_by_value(CLabels* predicted,
+		CLabels* ground_truth, SGVector<uint8_t>& positive)
+{
+	int32_t length=predicted->get_num_labels();
+
+	SGVector<uint64_t> keys(length);
+	positive=SGVector<uint8_t>(length);
+
+	#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t i=0; i<length; i++)
+	{
+		keys[i]=value_to_key(predicted->get_value(i));
+		positive[i]=ground_truth->get_value(i)>0;
+	}
+
+	CMath::lsd_radix_sort_index(keys.vector, positive.vector, length,
+			parallel->get_num_threads());
+
+	return keys;
+}
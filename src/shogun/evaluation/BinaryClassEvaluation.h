@@ -13,6 +13,9 @@
 
 #include <shogun/evaluation/Evaluation.h>
 #include <shogun/labels/BinaryLabels.h>
+#include <shogun/mathematics/Math.h>
+
+#include <string.h>
 
 namespace shogun
 {
@@ -41,6 +44,37 @@ public:
 	 * @return evaluation result
 	 */
 	virtual float64_t evaluate(CLabels* predicted, CLabels* ground_truth) = 0;
+
+protected:
+	/** sort examples by their predicted values in descending order, using
+	 * the parallel LSD radix sort CMath::lsd_radix_sort_index on the bits
+	 * of the values, which is stable and needs neither indices nor
+	 * comparisons
+	 *
+	 * @param predicted labels
+	 * @param ground_truth labels assumed to be correct
+	 * @param positive is set to whether the ground truth of each example in
+	 * sorted order is positive
+	 * @return sort keys of the examples in sorted order, see key_to_value
+	 */
+	SGVector<uint64_t> sort_by_value(CLabels* predicted, CLabels* ground_truth,
+			SGVector<uint8_t>& positive);
+
+	/** @return predicted value of sort key returned by sort_by_value */
+	static inline float64_t key_to_value(uint64_t key)
+	{
+		key=~key;
+		uint64_t bits=key>>63 ? key^(uint64_t(1)<<63) : ~key;
+		float64_t value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	/** @return sort key of predicted value, which orders larger values first */
+	static inline uint64_t value_to_key(float64_t value)
+	{
+		return ~CMath::radix_key(value);
+	}
 };
 
 }
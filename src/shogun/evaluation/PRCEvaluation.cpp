@@ -34,60 +34,80 @@ float64_t CPRCEvaluation::evaluate(CLabels* predicted, CLabels* ground_truth)
 	// total number of positive labels in predicted
 	int32_t pos_count=0;
 
-	// initialize number of labels and labels
-	SGVector<float64_t> orig_labels = predicted->get_values();
-	int32_t length = orig_labels.vlen;
-	float64_t* labels = SGVector<float64_t>::clone_vector(orig_labels.vector, length);
+	// sort predicted labels descending along with ground truth
+	SGVector<uint8_t> positive;
+	SGVector<uint64_t> keys=sort_by_value(predicted, ground_truth, positive);
+	int32_t length=keys.vlen;
 
-	// get indexes for sort
-	int32_t* idxs = SG_MALLOC(int32_t, length);
-	for(i=0; i<length; i++)
-		idxs[i] = i;
-
-	// sort indexes by labels ascending
-	CMath::qsort_backward_index(labels,idxs,length);
+	// number of points of the returned curve, one per example for the
+	// full curve
+	int32_t num_graph_points=length;
+	if (m_num_curve_points>1 && m_num_curve_points<length)
+		num_graph_points=m_num_curve_points;
 
 	// clean and initialize graph and auPRC
-	SG_FREE(labels);
-	m_PRC_graph = SGMatrix<float64_t>(2,length);
-	m_thresholds = SGVector<float64_t>(length);
+	m_PRC_graph = SGMatrix<float64_t>(2,num_graph_points);
+	m_thresholds = SGVector<float64_t>(num_graph_points);
 	m_auPRC = 0.0;
 
 	// get total numbers of positive and negative labels
 	for (i=0; i<length; i++)
-	{
-		if (ground_truth->get_value(i) > 0)
-			pos_count++;
-	}
+		pos_count+=positive[i];
 
 	// assure number of positive examples is >0
 	ASSERT(pos_count>0)
 
-	// create PRC curve
+	// create PRC curve and calc auPRC using area under curve
+	float64_t precision=0.0;
+	float64_t recall=0.0;
+	int32_t graph_point=0;
 	for (i=0; i<length; i++)
 	{
 		// update number of true positive examples
-		if (ground_truth->get_value(idxs[i]) > 0)
+		if (positive[i])
 			tp += 1.0;
 
-		// precision (x)
-		m_PRC_graph[2*i] = tp/float64_t(i+1);
-		// recall (y)
-		m_PRC_graph[2*i+1] = tp/float64_t(pos_count);
-
-		m_thresholds[i]= predicted->get_value(idxs[i]);
+		float64_t last_precision=precision;
+		float64_t last_recall=recall;
+		precision=tp/float64_t(i+1);
+		recall=tp/float64_t(pos_count);
+
+		if (i>0)
+			m_auPRC+=0.5*(recall-last_recall)*(precision+last_precision);
+
+		// keep every point of the full curve or evenly spaced ones
+		if (num_graph_points==length ||
+			int64_t(graph_point)*(length-1)/(num_graph_points-1)==i)
+		{
+			// precision (x)
+			m_PRC_graph[2*graph_point] = precision;
+			// recall (y)
+			m_PRC_graph[2*graph_point+1] = recall;
+
+			m_thresholds[graph_point]=key_to_value(keys[i]);
+			graph_point++;
+		}
 	}
 
-	// calc auRPC using area under curve
-	m_auPRC = CMath::area_under_curve(m_PRC_graph.matrix,length,true);
-
 	// set computed indicator
 	m_computed = true;
 
-	SG_FREE(idxs);
 	return m_auPRC;
 }
 
+void CPRCEvaluation::set_num_curve_points(int32_t num_curve_points)
+{
+	REQUIRE(num_curve_points==0 || num_curve_points>1, "%s::set_num_curve_points(): "
+			"Number of points must be 0 or at least 2, given %d\n", get_name(),
+			num_curve_points);
+	m_num_curve_points=num_curve_points;
+}
+
+int32_t CPRCEvaluation::get_num_curve_points() const
+{
+	return m_num_curve_points;
+}
+
 SGMatrix<float64_t> CPRCEvaluation::get_PRC()
 {
 	if (!m_computed)
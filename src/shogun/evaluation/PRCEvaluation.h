@@ -21,13 +21,17 @@ class CLabels;
 /** @brief Class PRCEvaluation used to evaluate PRC
  * (Precision Recall Curve) and an area under PRC curve (auPRC).
  *
+ * Outputs are sorted with a parallel radix sort and auPRC is computed in the
+ * same pass as the graph, which can be reduced to a given number of points
+ * (see set_num_curve_points). For outputs which do not fit into memory or
+ * have to be combined see CAUCAccumulator.
  */
 class CPRCEvaluation: public CBinaryClassEvaluation
 {
 public:
 	/** constructor */
 	CPRCEvaluation() :
-		CBinaryClassEvaluation(), m_computed(false)
+		CBinaryClassEvaluation(), m_num_curve_points(0), m_computed(false)
 	{
 		m_PRC_graph = SGMatrix<float64_t>();
 		m_thresholds = SGVector<float64_t>();
@@ -67,6 +71,17 @@ public:
 	 */
 	SGVector<float64_t> get_thresholds();
 
+	/** set number of points of the PRC graph, evenly spaced over the points
+	 * of the full graph including its first and last point. auPRC is always
+	 * computed from the full graph.
+	 *
+	 * @param num_curve_points number of points, 0 for the full graph
+	 */
+	void set_num_curve_points(int32_t num_curve_points);
+
+	/** @return number of points of the PRC graph, 0 for the full graph */
+	int32_t get_num_curve_points() const;
+
 protected:
 
 	/** 2-d array used to store PRC graph */
@@ -78,6 +93,9 @@ protected:
 	/** area under PRC graph */
 	float64_t m_auPRC;
 
+	/** number of points of the PRC graph, 0 for the full graph */
+	int32_t m_num_curve_points;
+
 	/** indicator of PRC and auPRC being computed already */
 	bool m_computed;
 };
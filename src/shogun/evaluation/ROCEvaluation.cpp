@@ -30,57 +30,24 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 	ASSERT(ground_truth->get_label_type()==LT_BINARY)
 	ground_truth->ensure_valid();
 
-	// assume threshold as negative infinity
-	float64_t threshold = CMath::ALMOST_NEG_INFTY;
-	// false positive rate
-	float64_t fp = 0.0;
-	// true positive rate
-	float64_t tp=0.0;
-
 	int32_t i;
-	// total number of positive labels in predicted
-	int32_t pos_count=0;
-	int32_t neg_count=0;
-
-	// initialize number of labels and labels
-	SGVector<float64_t> orig_labels(predicted->get_num_labels());
-	int32_t length = orig_labels.vlen;
-	for (i=0; i<length; i++)
-		orig_labels[i] = predicted->get_value(i);
-	float64_t* labels = SGVector<float64_t>::clone_vector(orig_labels.vector, length);
+	int32_t length=predicted->get_num_labels();
 
-	// get sorted indexes
-	SGVector<int32_t> idxs(length);
-	for(i=0; i<length; i++)
-		idxs[i] = i;
+	// sort predicted labels descending along with ground truth
+	SGVector<uint8_t> positive;
+	SGVector<uint64_t> keys=sort_by_value(predicted, ground_truth, positive);
 
-	CMath::qsort_backward_index(labels,idxs.vector,idxs.vlen);
-
-	// number of different predicted labels
-	int32_t diff_count=1;
-
-	// get number of different labels
-	for (i=0; i<length-1; i++)
+	// number of different predicted labels and total number of positive
+	// labels
+	int32_t diff_count=length>0 ? 1 : 0;
+	int64_t pos_count=0;
+	for (i=0; i<length; i++)
 	{
-		if (labels[i] != labels[i+1])
+		if (i>0 && keys[i]!=keys[i-1])
 			diff_count++;
+		pos_count+=positive[i];
 	}
-
-	SG_FREE(labels);
-
-	// initialize graph and auROC
-	m_ROC_graph = SGMatrix<float64_t>(2,diff_count+1);
-	m_thresholds = SGVector<float64_t>(length);
-	m_auROC = 0.0;
-
-	// get total numbers of positive and negative labels
-	for(i=0; i<length; i++)
-	{
-		if (ground_truth->get_value(i) >= 0)
-			pos_count++;
-		else
-			neg_count++;
-	}
+	int64_t neg_count=length-pos_count;
 
 	// assure both number of positive and negative examples is >0
 	REQUIRE(pos_count>0, "%s::evaluate_roc(): Number of positive labels is "
@@ -88,42 +55,82 @@ float64_t CROCEvaluation::evaluate_roc(CLabels* predicted, CLabels* ground_truth
 	REQUIRE(neg_count>0, "%s::evaluate_roc(): Number of negative labels is "
 			"zero, ROC fails!\n", get_name());
 
-	int32_t j = 0;
-	float64_t label;
+	// number of points of the full curve, which ends with (1,1), and of the
+	// returned curve
+	int32_t num_points=diff_count+1;
+	int32_t num_graph_points=num_points;
+	if (m_num_curve_points>1 && m_num_curve_points<num_points)
+		num_graph_points=m_num_curve_points;
 
-	// create ROC curve and calculate auROC
-	for(i=0; i<length; i++)
+	// initialize graph and auROC
+	m_ROC_graph=SGMatrix<float64_t>(2, num_graph_points);
+	m_thresholds=SGVector<float64_t>(
+			num_graph_points==num_points ? length : num_graph_points);
+
+	// false and true positives so far, twice the area under the curve of
+	// these counts is an integer
+	int64_t fp=0;
+	int64_t tp=0;
+	int64_t area=0;
+	int32_t point=0;
+	int32_t graph_point=0;
+
+	// create ROC curve and calculate auROC, one point before the examples
+	// of each predicted label
+	for (i=0; i<=length; i++)
 	{
-		label = predicted->get_value(idxs[i]);
-
-		if (label != threshold)
+		if (i==length || i==0 || keys[i]!=keys[i-1])
 		{
-			threshold = label;
-			m_ROC_graph[2*j] = fp/neg_count;
-			m_ROC_graph[2*j+1] = tp/pos_count;
-			j++;
+			// keep every point of the full curve or evenly spaced ones
+			if (int64_t(graph_point)*(num_points-1)/(num_graph_points-1)==point)
+			{
+				m_ROC_graph(0, graph_point)=float64_t(fp)/neg_count;
+				m_ROC_graph(1, graph_point)=float64_t(tp)/pos_count;
+				if (num_graph_points!=num_points)
+				{
+					m_thresholds[graph_point]=i<length ?
+						key_to_value(keys[i]) : CMath::ALMOST_NEG_INFTY;
+				}
+				graph_point++;
+			}
+			point++;
+
+			// add the trapezoid of the examples with this predicted label
+			int64_t group_tp=0;
+			int32_t j=i;
+			for (; j<length && keys[j]==keys[i]; j++)
+				group_tp+=positive[j];
+			int64_t group_fp=(j-i)-group_tp;
+			area+=group_fp*(2*tp+group_tp);
+			tp+=group_tp;
+			fp+=group_fp;
 		}
 
-		m_thresholds[i]=threshold;
-
-		if (ground_truth->get_value(idxs[i]) > 0)
-			tp+=1.0;
-		else
-			fp+=1.0;
+		if (i<length && num_graph_points==num_points)
+			m_thresholds[i]=key_to_value(keys[i]);
 	}
 
-	// add (1,1) to ROC curve
-	m_ROC_graph[2*diff_count] = 1.0;
-	m_ROC_graph[2*diff_count+1] = 1.0;
-
 	// calc auROC using area under curve
-	m_auROC = CMath::area_under_curve(m_ROC_graph.matrix,diff_count+1,false);
+	m_auROC=0.5*float64_t(area)/(float64_t(pos_count)*neg_count);
 
 	m_computed = true;
 
 	return m_auROC;
 }
 
+void CROCEvaluation::set_num_curve_points(int32_t num_curve_points)
+{
+	REQUIRE(num_curve_points==0 || num_curve_points>1, "%s::set_num_curve_points(): "
+			"Number of points must be 0 or at least 2, given %d\n", get_name(),
+			num_curve_points);
+	m_num_curve_points=num_curve_points;
+}
+
+int32_t CROCEvaluation::get_num_curve_points() const
+{
+	return m_num_curve_points;
+}
+
 SGMatrix<float64_t> CROCEvaluation::get_ROC()
 {
 	if (!m_computed)
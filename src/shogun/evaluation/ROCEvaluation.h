@@ -26,13 +26,18 @@ class CLabels;
  *
  * Fawcett, Tom (2004) ROC Graphs:
  * Notes and Practical Considerations for Researchers; Machine Learning, 2004
+ *
+ * Outputs are sorted with a parallel radix sort and auROC is computed exactly
+ * in the same pass as the graph, which can be reduced to a given number of
+ * points (see set_num_curve_points). For outputs which do not fit into memory
+ * or have to be combined see CAUCAccumulator.
  */
 class CROCEvaluation: public CBinaryClassEvaluation
 {
 public:
 	/** constructor */
 	CROCEvaluation() :
-		CBinaryClassEvaluation(), m_computed(false)
+		CBinaryClassEvaluation(), m_num_curve_points(0), m_computed(false)
 	{
 		m_ROC_graph = SGMatrix<float64_t>();
 		m_thresholds = SGVector<float64_t>();
@@ -71,6 +76,18 @@ public:
 	 */
 	SGVector<float64_t> get_thresholds();
 
+	/** set number of points of the ROC graph, evenly spaced over the points
+	 * of the full graph including its first and last point. auROC is always
+	 * computed from the full graph. If set, get_thresholds returns one
+	 * threshold per point.
+	 *
+	 * @param num_curve_points number of points, 0 for the full graph
+	 */
+	void set_num_curve_points(int32_t num_curve_points);
+
+	/** @return number of points of the ROC graph, 0 for the full graph */
+	int32_t get_num_curve_points() const;
+
 protected:
 
 	/** evaluate ROC and auROC
@@ -91,6 +108,9 @@ protected:
 	/** area under ROC graph */
 	float64_t m_auROC;
 
+	/** number of points of the ROC graph, 0 for the full graph */
+	int32_t m_num_curve_points;
+
 	/** indicator of ROC and auROC being computed already */
 	bool m_computed;
 };
@@ -197,10 +197,9 @@ template<class ST> void CDenseFeatures<ST>::free_feature_vector(ST* feat_vec, in
 		SG_FREE(feat_vec);
 }
 
-template<class ST> void CDenseFeatures<ST>::free_feature_vector(SGVector<ST> vec, int32_t num)
+template<class ST> void CDenseFeatures<ST>::free_feature_vector(const SGVector<ST>& vec, int32_t num)
 {
 	free_feature_vector(vec.vector, num, false);
-	vec=SGVector<ST>();
 }
 
 template<class ST> void CDenseFeatures<ST>::vector_subset(int32_t* idx, int32_t idx_len)
@@ -36,6 +36,15 @@ struct DF_THREAD_PARAM
 	float64_t bias;
 	bool progress;
 };
+
+struct DF_REDUCE_THREAD_PARAM
+{
+	float64_t* vec;
+	float64_t** buffers;
+	int32_t num_buffers;
+	int32_t start;
+	int32_t stop;
+};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 
@@ -281,6 +290,163 @@ void* CDotFeatures::dense_dot_range_helper(void* p)
 	return NULL;
 }
 
+void CDotFeatures::add_to_dense_vec_subset(int32_t* sub_index, int32_t num,
+		float64_t* alphas, float64_t* vec, int32_t dim)
+{
+	ASSERT(sub_index)
+	ASSERT(vec)
+	ASSERT(num>=0)
+
+	int32_t num_threads=parallel->get_num_threads();
+	ASSERT(num_threads>0)
+
+	// every thread needs a full accumulator, so only use as many
+	// threads as there are vectors
+	num_threads=CMath::max(1, CMath::min(num_threads, num));
+
+	CSignal::clear_cancel();
+
+#ifdef HAVE_PTHREAD
+	if (num_threads < 2)
+	{
+#endif
+		DF_THREAD_PARAM params;
+		params.df=this;
+		params.sub_index=sub_index;
+		params.output=NULL;
+		params.start=0;
+		params.stop=num;
+		params.alphas=alphas;
+		params.vec=vec;
+		params.dim=dim;
+		params.bias=0;
+		params.progress=false;
+		add_to_dense_vec_subset_helper((void*) &params);
+#ifdef HAVE_PTHREAD
+	}
+	else
+	{
+		pthread_t* threads = SG_MALLOC(pthread_t, num_threads-1);
+		DF_THREAD_PARAM* params = SG_MALLOC(DF_THREAD_PARAM, num_threads);
+		float64_t** buffers = SG_MALLOC(float64_t*, num_threads-1);
+		int32_t step= num/num_threads;
+
+		int32_t t;
+
+		for (t=0; t<num_threads-1; t++)
+		{
+			buffers[t] = SG_CALLOC(float64_t, dim);
+			params[t].df = this;
+			params[t].sub_index=sub_index;
+			params[t].output = NULL;
+			params[t].start = t*step;
+			params[t].stop = (t+1)*step;
+			params[t].alphas=alphas;
+			params[t].vec=buffers[t];
+			params[t].dim=dim;
+			params[t].bias=0;
+			params[t].progress = false;
+			pthread_create(&threads[t], NULL,
+					CDotFeatures::add_to_dense_vec_subset_helper, (void*)&params[t]);
+		}
+
+		// the calling thread accumulates into vec directly
+		params[t].df = this;
+		params[t].sub_index=sub_index;
+		params[t].output = NULL;
+		params[t].start = t*step;
+		params[t].stop = num;
+		params[t].alphas=alphas;
+		params[t].vec=vec;
+		params[t].dim=dim;
+		params[t].bias=0;
+		params[t].progress = false;
+		add_to_dense_vec_subset_helper((void*) &params[t]);
+
+		for (t=0; t<num_threads-1; t++)
+			pthread_join(threads[t], NULL);
+
+		// reduction, parallel over dimensions
+		DF_REDUCE_THREAD_PARAM* reduce_params = SG_MALLOC(DF_REDUCE_THREAD_PARAM, num_threads);
+		int32_t dim_step = dim/num_threads;
+
+		for (t=0; t<num_threads; t++)
+		{
+			reduce_params[t].vec = vec;
+			reduce_params[t].buffers = buffers;
+			reduce_params[t].num_buffers = num_threads-1;
+			reduce_params[t].start = t*dim_step;
+			reduce_params[t].stop = (t==num_threads-1) ? dim : (t+1)*dim_step;
+		}
+
+		for (t=0; t<num_threads-1; t++)
+		{
+			pthread_create(&threads[t], NULL,
+					CDotFeatures::reduce_dense_vec_helper, (void*)&reduce_params[t]);
+		}
+		reduce_dense_vec_helper((void*) &reduce_params[t]);
+
+		for (t=0; t<num_threads-1; t++)
+			pthread_join(threads[t], NULL);
+
+		for (t=0; t<num_threads-1; t++)
+			SG_FREE(buffers[t]);
+
+		SG_FREE(reduce_params);
+		SG_FREE(buffers);
+		SG_FREE(params);
+		SG_FREE(threads);
+	}
+#endif
+
+#ifndef WIN32
+		if ( CSignal::cancel_computations() )
+			SG_INFO("prematurely stopped.           \n")
+#endif
+}
+
+void* CDotFeatures::add_to_dense_vec_subset_helper(void* p)
+{
+	DF_THREAD_PARAM* par=(DF_THREAD_PARAM*) p;
+	CDotFeatures* df=par->df;
+	int32_t* sub_index=par->sub_index;
+	int32_t start=par->start;
+	int32_t stop=par->stop;
+	float64_t* alphas=par->alphas;
+	float64_t* vec=par->vec;
+	int32_t dim=par->dim;
+
+#ifdef WIN32
+	for (int32_t i=start; i<stop; i++)
+#else
+	for (int32_t i=start; i<stop &&
+			!CSignal::cancel_computations(); i++)
+#endif
+	{
+		if (alphas)
+			df->add_to_dense_vec(alphas[sub_index[i]], sub_index[i], vec, dim);
+		else
+			df->add_to_dense_vec(1.0, sub_index[i], vec, dim);
+	}
+
+	return NULL;
+}
+
+void* CDotFeatures::reduce_dense_vec_helper(void* p)
+{
+	DF_REDUCE_THREAD_PARAM* par=(DF_REDUCE_THREAD_PARAM*) p;
+	float64_t* vec=par->vec;
+
+	for (int32_t b=0; b<par->num_buffers; b++)
+	{
+		float64_t* buf=par->buffers[b];
+		for (int32_t j=par->start; j<par->stop; j++)
+			vec[j]+=buf[j];
+	}
+
+	return NULL;
+}
+
 SGMatrix<float64_t> CDotFeatures::get_computed_dot_feature_matrix()
 {
 
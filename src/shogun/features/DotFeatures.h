@@ -135,6 +135,33 @@ class CDotFeatures : public CFeatures
 		 * called by the threads created in dense_dot_range */
 		static void* dense_dot_range_helper(void* p);
 
+		/** Add a weighted sum of a subset of vectors to a dense vector
+		 * vec += sum_i alphas[sub_index[i]] * sparse[sub_index[i]]
+		 *
+		 * The subset is split across threads, each of which accumulates
+		 * into its own dense buffer of length dim; the buffers are summed
+		 * up into vec afterwards. For a fixed number of threads the result
+		 * is deterministic.
+		 *
+		 * @param sub_index index of vectors to add
+		 * @param num length of index
+		 * @param alphas scalars to multiply with, may be NULL
+		 * @param vec dense vector to add to
+		 * @param dim length of the dense vector
+		 */
+		virtual void add_to_dense_vec_subset(int32_t* sub_index, int32_t num,
+				float64_t* alphas, float64_t* vec, int32_t dim);
+
+		/** Add a weighted sum of a subset of vectors to a dense vector.
+		 * This function is called by the threads created in
+		 * add_to_dense_vec_subset */
+		static void* add_to_dense_vec_subset_helper(void* p);
+
+		/** Sum up per-thread accumulators for a range of dimensions.
+		 * This function is called by the threads created in
+		 * add_to_dense_vec_subset */
+		static void* reduce_dense_vec_helper(void* p);
+
 		/** get number of non-zero features in vector
 		 *
 		 * (in case accurate estimates are too expensive overestimating is OK)
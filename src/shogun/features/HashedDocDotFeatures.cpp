@@ -11,10 +11,73 @@
 #include <shogun/features/HashedDocDotFeatures.h>
 #include <shogun/lib/DelimiterTokenizer.h>
 #include <shogun/lib/Hash.h>
+#include <shogun/lib/ShogunException.h>
 #include <shogun/mathematics/Math.h>
 
+#include <string.h>
+
 namespace shogun
 {
+/* append the hashed indices of all tokens and n-grams of a document,
+ * in the order dense_dot() visits them */
+static void hash_document(SGVector<char> sv, CTokenizer* local_tzer, int32_t num_bits,
+	int32_t ngrams, int32_t tokens_to_skip, uint32_t*& indices, int64_t& num_indices,
+	int64_t& capacity)
+{
+	SGVector<uint32_t> hashes(ngrams+tokens_to_skip);
+	index_t hashes_start = 0;
+	index_t hashes_end = 0;
+	index_t len = hashes.vlen - 1;
+	SGVector<index_t> hashed_indices((ngrams-1)*(tokens_to_skip+1) + 1);
+
+	const int32_t seed = 0xdeadbeaf;
+	local_tzer->set_text(sv);
+	index_t start = 0;
+	while (hashes_end<ngrams-1+tokens_to_skip && local_tzer->has_next())
+	{
+		index_t end = local_tzer->next_token_idx(start);
+		hashes[hashes_end++] = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
+	}
+
+	while (true)
+	{
+		index_t num_hashed;
+		if (local_tzer->has_next())
+		{
+			index_t end = local_tzer->next_token_idx(start);
+			hashes[hashes_end] = CHash::MurmurHash3((uint8_t* ) &sv.vector[start], end-start, seed);
+			CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start, len, hashed_indices,
+					num_bits, ngrams, tokens_to_skip);
+			num_hashed = hashed_indices.vlen;
+
+			hashes_end++;
+			if (hashes_end==hashes.vlen)
+				hashes_end = 0;
+		}
+		else if (ngrams>1 && hashes_start!=hashes_end)
+		{
+			len--;
+			num_hashed = CHashedDocConverter::generate_ngram_hashes(hashes, hashes_start,
+					len, hashed_indices, num_bits, ngrams, tokens_to_skip);
+		}
+		else
+			break;
+
+		if (num_indices+num_hashed>capacity)
+		{
+			int64_t new_capacity = CMath::max(2*capacity, num_indices+num_hashed+1024);
+			indices = SG_REALLOC(uint32_t, indices, capacity, new_capacity);
+			capacity = new_capacity;
+		}
+		for (index_t i=0; i<num_hashed; i++)
+			indices[num_indices++] = hashed_indices[i];
+
+		hashes_start++;
+		if (hashes_start==hashes.vlen)
+			hashes_start = 0;
+	}
+}
+
 CHashedDocDotFeatures::CHashedDocDotFeatures(int32_t hash_bits, CStringFeatures<char>* docs,
 	CTokenizer* tzer, bool normalize, int32_t n_grams, int32_t skips, int32_t size) : CDotFeatures(size)
 {
@@ -32,6 +95,20 @@ CHashedDocDotFeatures::CHashedDocDotFeatures(const CHashedDocDotFeatures& orig)
 {
 	init(orig.num_bits, orig.doc_collection, orig.tokenizer, orig.should_normalize,
 			orig.ngrams, orig.tokens_to_skip);
+
+	if (orig.has_precomputed_hashes())
+	{
+		int32_t num_vectors = get_num_vectors();
+		int64_t num_indices = orig.hash_offsets[num_vectors];
+		charge_precomputed_bytes(orig.precomputed_bytes);
+		hash_offsets = SG_MALLOC(int64_t, num_vectors+1);
+		hash_indices = SG_MALLOC(uint32_t, num_indices);
+		doc_norms = SG_MALLOC(float64_t, num_vectors);
+		memcpy(hash_offsets, orig.hash_offsets, sizeof(int64_t)*(num_vectors+1));
+		memcpy(hash_indices, orig.hash_indices, sizeof(uint32_t)*num_indices);
+		memcpy(doc_norms, orig.doc_norms, sizeof(float64_t)*num_vectors);
+		precomputed_bytes = orig.precomputed_bytes;
+	}
 }
 
 CHashedDocDotFeatures::CHashedDocDotFeatures(CFile* loader)
@@ -48,6 +125,10 @@ void CHashedDocDotFeatures::init(int32_t hash_bits, CStringFeatures<char>* docs,
 	doc_collection = docs;
 	tokenizer = tzer;
 	should_normalize = normalize;
+	hash_offsets = NULL;
+	hash_indices = NULL;
+	doc_norms = NULL;
+	precomputed_bytes = 0;
 
 	if (!tokenizer)
 	{
@@ -73,6 +154,7 @@ void CHashedDocDotFeatures::init(int32_t hash_bits, CStringFeatures<char>* docs,
 
 CHashedDocDotFeatures::~CHashedDocDotFeatures()
 {
+	free_precomputed_hashes();
 	SG_UNREF(doc_collection);
 	SG_UNREF(tokenizer);
 }
@@ -114,6 +196,14 @@ float64_t CHashedDocDotFeatures::dense_dot(int32_t vec_idx1, const float64_t* ve
 {
 	ASSERT(vec2_len == CMath::pow(2,num_bits))
 
+	if (hash_offsets)
+	{
+		float64_t result = 0;
+		for (int64_t i=hash_offsets[vec_idx1]; i<hash_offsets[vec_idx1+1]; i++)
+			result += vec2[hash_indices[i]];
+		return should_normalize ? result / doc_norms[vec_idx1] : result;
+	}
+
 	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
 
 	/** this vector will maintain the current n+k active tokens
@@ -191,6 +281,14 @@ void CHashedDocDotFeatures::add_to_dense_vec(float64_t alpha, int32_t vec_idx1,
 	if (abs_val)
 		alpha = CMath::abs(alpha);
 
+	if (hash_offsets)
+	{
+		const float64_t value = should_normalize ? alpha / doc_norms[vec_idx1] : alpha;
+		for (int64_t i=hash_offsets[vec_idx1]; i<hash_offsets[vec_idx1+1]; i++)
+			vec2[hash_indices[i]] += value;
+		return;
+	}
+
 	SGVector<char> sv = doc_collection->get_feature_vector(vec_idx1);
 	const float64_t value = should_normalize ? alpha / CMath::sqrt((float64_t) sv.size()) : alpha;
 
@@ -268,10 +366,124 @@ uint32_t CHashedDocDotFeatures::calculate_token_hash(char* token,
 
 void CHashedDocDotFeatures::set_doc_collection(CStringFeatures<char>* docs)
 {
+	free_precomputed_hashes();
 	SG_UNREF(doc_collection);
 	doc_collection = docs;
 }
 
+void CHashedDocDotFeatures::precompute_hashes()
+{
+	free_precomputed_hashes();
+
+	int32_t num_vectors = get_num_vectors();
+	int32_t num_threads = CMath::max(1, CMath::min(parallel->get_num_threads(), num_vectors));
+	int64_t* offsets = SG_MALLOC(int64_t, num_vectors+1);
+	float64_t* norms = SG_MALLOC(float64_t, num_vectors);
+	uint32_t** thread_indices = SG_CALLOC(uint32_t*, num_threads);
+
+	/* each thread hashes a contiguous block of documents into its own
+	 * buffer and records the number of indices of each document */
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		CTokenizer* local_tzer = tokenizer->get_copy();
+		int64_t num_indices = 0;
+		int64_t capacity = 0;
+		int32_t first = (int64_t) num_vectors*t/num_threads;
+		int32_t last = (int64_t) num_vectors*(t+1)/num_threads;
+		for (int32_t i=first; i<last; i++)
+		{
+			SGVector<char> sv = doc_collection->get_feature_vector(i);
+			int64_t doc_start = num_indices;
+			hash_document(sv, local_tzer, num_bits, ngrams, tokens_to_skip,
+					thread_indices[t], num_indices, capacity);
+			offsets[i+1] = num_indices-doc_start;
+			norms[i] = CMath::sqrt((float64_t) sv.size());
+			doc_collection->free_feature_vector(sv, i);
+		}
+		SG_UNREF(local_tzer);
+	}
+
+	offsets[0] = 0;
+	for (int32_t i=0; i<num_vectors; i++)
+		offsets[i+1] += offsets[i];
+
+	int64_t bytes = sizeof(int64_t)*(num_vectors+1) + sizeof(uint32_t)*offsets[num_vectors] +
+		sizeof(float64_t)*num_vectors;
+	try
+	{
+		charge_precomputed_bytes(bytes);
+	}
+	catch (ShogunException& e)
+	{
+		for (int32_t t=0; t<num_threads; t++)
+			SG_FREE(thread_indices[t]);
+		SG_FREE(thread_indices);
+		SG_FREE(offsets);
+		SG_FREE(norms);
+		throw;
+	}
+
+	hash_offsets = SG_MALLOC(int64_t, num_vectors+1);
+	hash_indices = SG_MALLOC(uint32_t, offsets[num_vectors]);
+	doc_norms = SG_MALLOC(float64_t, num_vectors);
+	precomputed_bytes = bytes;
+	memcpy(hash_offsets, offsets, sizeof(int64_t)*(num_vectors+1));
+	memcpy(doc_norms, norms, sizeof(float64_t)*num_vectors);
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		int32_t first = (int64_t) num_vectors*t/num_threads;
+		int32_t last = (int64_t) num_vectors*(t+1)/num_threads;
+		memcpy(hash_indices+offsets[first], thread_indices[t],
+				sizeof(uint32_t)*(offsets[last]-offsets[first]));
+		SG_FREE(thread_indices[t]);
+	}
+
+	SG_FREE(thread_indices);
+	SG_FREE(offsets);
+	SG_FREE(norms);
+
+	SG_DEBUG("Precomputed %lld hashed indices of %d documents (%lld bytes)\n",
+			(long long int) hash_offsets[num_vectors], num_vectors,
+			(long long int) get_precomputed_bytes())
+}
+
+void CHashedDocDotFeatures::free_precomputed_hashes()
+{
+	get_memory_counter()->release(precomputed_bytes);
+	precomputed_bytes = 0;
+
+	SG_FREE(hash_offsets);
+	SG_FREE(hash_indices);
+	SG_FREE(doc_norms);
+	hash_offsets = NULL;
+	hash_indices = NULL;
+	doc_norms = NULL;
+}
+
+int64_t CHashedDocDotFeatures::get_precomputed_bytes() const
+{
+	return precomputed_bytes;
+}
+
+void CHashedDocDotFeatures::charge_precomputed_bytes(int64_t bytes)
+{
+	SGMemoryCounter* counter = get_memory_counter();
+	if (!counter->charge(bytes))
+	{
+		SG_ERROR("Out of memory error, precomputing %lld bytes exceeds the limit of %s.\n",
+				(long long int) bytes, counter->get_name())
+	}
+}
+
+SGMemoryCounter* CHashedDocDotFeatures::get_memory_counter()
+{
+	static SGMemoryCounter counter("HashedDocDotFeatures");
+	return &counter;
+}
+
 int32_t CHashedDocDotFeatures::get_nnz_features_for_vector(int32_t num)
 {
 	SGVector<char> sv = doc_collection->get_feature_vector(num);
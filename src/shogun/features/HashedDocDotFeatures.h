@@ -15,6 +15,7 @@
 #include <shogun/features/StringFeatures.h>
 #include <shogun/converter/HashedDocConverter.h>
 #include <shogun/lib/Tokenizer.h>
+#include <shogun/lib/Allocator.h>
 
 namespace shogun {
 template<class ST> class CStringFeatures;
@@ -190,10 +191,41 @@ public:
 	static uint32_t calculate_token_hash(char* token, int32_t length,
 			int32_t num_bits, uint32_t seed);
 
+	/** Hash all documents once, in parallel, into a compressed sparse row
+	 * representation. dense_dot() and add_to_dense_vec() then read the
+	 * hashed indices instead of tokenizing and hashing the documents on
+	 * every call, which pays off for solvers making many passes.
+	 *
+	 * Every token and n-gram takes 4 bytes, stored in document order, so
+	 * results are identical to those computed on the fly. The memory is
+	 * charged to get_memory_counter() (whether or not a SGPoolAllocator is
+	 * installed) and an error is raised if this would exceed its limit.
+	 * Changing the document collection discards the representation.
+	 */
+	void precompute_hashes();
+
+	/** free the precomputed representation, documents are hashed on the
+	 * fly again */
+	void free_precomputed_hashes();
+
+	/** @return whether documents have been hashed by precompute_hashes() */
+	bool has_precomputed_hashes() const { return hash_offsets!=NULL; }
+
+	/** @return number of bytes of the precomputed representation */
+	int64_t get_precomputed_bytes() const;
+
+	/** @return memory counter the precomputed representations of all
+	 * CHashedDocDotFeatures are charged to */
+	static SGMemoryCounter* get_memory_counter();
+
 private:
 	void init(int32_t hash_bits, CStringFeatures<char>* docs, CTokenizer* tzer,
 		bool normalize, int32_t n_grams, int32_t skips);
 
+	/** charge bytes of a precomputed representation to the memory counter,
+	 * raising an error if its limit would be exceeded */
+	void charge_precomputed_bytes(int64_t bytes);
+
 protected:
 	/** the document collection*/
 	CStringFeatures<char>* doc_collection;
@@ -212,6 +244,19 @@ protected:
 
 	/** tokens to skip when combining tokens */
 	int32_t tokens_to_skip;
+
+	/** offsets of the documents' hashed indices (num_vectors+1), NULL
+	 * if they have not been precomputed */
+	int64_t* hash_offsets;
+
+	/** hashed indices of all documents */
+	uint32_t* hash_indices;
+
+	/** normalization constants of all documents */
+	float64_t* doc_norms;
+
+	/** number of bytes of the precomputed representation */
+	int64_t precomputed_bytes;
 };
 }
 
@@ -372,7 +372,7 @@ template<class ST> void CStringFeatures<ST>::free_feature_vector(ST* feat_vec, i
 		SG_FREE(feat_vec);
 }
 
-template<class ST> void CStringFeatures<ST>::free_feature_vector(SGVector<ST> feat_vec, int32_t num)
+template<class ST> void CStringFeatures<ST>::free_feature_vector(const SGVector<ST>& feat_vec, int32_t num)
 {
 	if (num>=get_num_vectors())
 	{
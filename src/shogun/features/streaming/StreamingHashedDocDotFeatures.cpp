@@ -12,6 +12,8 @@
 #include <shogun/features/HashedDocDotFeatures.h>
 #include <shogun/mathematics/Math.h>
 
+#include <string.h>
+
 using namespace shogun;
 
 CStreamingHashedDocDotFeatures::CStreamingHashedDocDotFeatures(CStreamingFile* file,
@@ -71,6 +73,12 @@ void CStreamingHashedDocDotFeatures::init(CStreamingFile* file, bool is_labelled
 
 	set_read_functions();
 	parser.set_free_vector_after_release(false);
+
+	hashing_batch_size = 1;
+	batch_length = 0;
+	batch_index = 0;
+	SG_ADD(&hashing_batch_size, "hashing_batch_size", "Number of examples hashed together",
+		MS_NOT_AVAILABLE);
 }
 
 CStreamingHashedDocDotFeatures::~CStreamingHashedDocDotFeatures()
@@ -152,6 +160,17 @@ void CStreamingHashedDocDotFeatures::end_parser()
 
 bool CStreamingHashedDocDotFeatures::get_next_example()
 {
+	if (hashing_batch_size>1)
+	{
+		if (batch_index==batch_length && !get_next_batch())
+			return false;
+
+		current_vector = batch_vectors[batch_index];
+		current_label = batch_labels[batch_index];
+		batch_index++;
+		return true;
+	}
+
 	SGVector<char> tmp;
 	if (parser.get_next_example(tmp.vector,
 		tmp.vlen, current_label))
@@ -164,9 +183,55 @@ bool CStreamingHashedDocDotFeatures::get_next_example()
 	return false;
 }
 
+bool CStreamingHashedDocDotFeatures::get_next_batch()
+{
+	/* the batch size may have been set through the parameter framework
+	 * (e.g. when loading), bypassing set_hashing_batch_size */
+	if (batch_labels.vlen!=hashing_batch_size ||
+			batch_vectors.num_vectors!=hashing_batch_size)
+	{
+		batch_vectors = SGSparseMatrix<float64_t>(get_dim_feature_space(),
+				hashing_batch_size);
+		batch_labels = SGVector<float64_t>(hashing_batch_size);
+	}
+
+	/* copy the documents, so that the parser can reuse its buffers while
+	 * they are hashed */
+	SGVector<char>* docs = SG_MALLOC(SGVector<char>, hashing_batch_size);
+	batch_length = 0;
+	batch_index = 0;
+
+	SGVector<char> tmp;
+	while (batch_length<hashing_batch_size &&
+			parser.get_next_example(tmp.vector, tmp.vlen, batch_labels[batch_length]))
+	{
+		ASSERT(tmp.vector)
+		ASSERT(tmp.vlen > 0)
+		docs[batch_length] = SGVector<char>(tmp.vlen);
+		memcpy(docs[batch_length].vector, tmp.vector, tmp.vlen);
+		parser.finalize_example();
+		batch_length++;
+	}
+
+	int32_t num_threads = CMath::max(1, CMath::min(parallel->get_num_threads(), batch_length));
+	#pragma omp parallel num_threads(num_threads)
+	{
+		CTokenizer* local_tzer = tokenizer->get_copy();
+		#pragma omp for schedule(dynamic, 16)
+		for (int32_t i=0; i<batch_length; i++)
+			batch_vectors[i] = converter->apply(docs[i], local_tzer);
+		SG_UNREF(local_tzer);
+	}
+
+	SG_FREE(docs);
+	return batch_length>0;
+}
+
 void CStreamingHashedDocDotFeatures::release_example()
 {
-	parser.finalize_example();
+	/* examples of a batch have been given back to the parser already */
+	if (hashing_batch_size<=1)
+		parser.finalize_example();
 }
 
 int32_t CStreamingHashedDocDotFeatures::get_num_features()
@@ -208,3 +273,15 @@ void CStreamingHashedDocDotFeatures::set_k_skip_n_grams(int32_t k, int32_t n)
 {
 	converter->set_k_skip_n_grams(k, n);
 }
+
+void CStreamingHashedDocDotFeatures::set_hashing_batch_size(int32_t size)
+{
+	REQUIRE(size>0, "Batch size must be positive (%d)\n", size)
+	REQUIRE(batch_index==batch_length, "Cannot change batch size within a batch\n")
+
+	hashing_batch_size = size;
+	batch_vectors = SGSparseMatrix<float64_t>(get_dim_feature_space(), size);
+	batch_labels = SGVector<float64_t>(size);
+	batch_length = 0;
+	batch_index = 0;
+}
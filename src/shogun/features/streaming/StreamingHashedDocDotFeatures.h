@@ -16,6 +16,7 @@
 #include <shogun/converter/HashedDocConverter.h>
 #include <shogun/io/streaming/InputParser.h>
 #include <shogun/io/streaming/StreamingFileFromStringFeatures.h>
+#include <shogun/lib/SGSparseMatrix.h>
 
 namespace shogun
 {
@@ -232,10 +233,29 @@ public:
 	 */
 	void set_k_skip_n_grams(int32_t k, int32_t n);
 
+	/** Set the number of examples that are taken from the parser at once
+	 * and hashed in parallel by the threads of the parallel object.
+	 * get_next_example() then returns the hashed examples of a batch one
+	 * by one. With a batch size of 1 (the default) each example is
+	 * hashed on demand by the calling thread.
+	 *
+	 * @param size number of examples per batch
+	 */
+	void set_hashing_batch_size(int32_t size);
+
+	/** @return number of examples hashed together */
+	int32_t get_hashing_batch_size() const { return hashing_batch_size; }
+
 private:
 	void init(CStreamingFile* file, bool is_labelled, int32_t size, CTokenizer* tzer,
 		int32_t bits, bool normalize, int32_t n_grams, int32_t skips);
 
+	/** take the next batch of examples from the parser and hash them
+	 *
+	 * @return whether there was at least one example
+	 */
+	bool get_next_batch();
+
 protected:
 
 	/** number of bits for the target dimension */
@@ -255,6 +275,21 @@ protected:
 
 	/** The current example's label */
 	float64_t current_label;
+
+	/** Number of examples hashed together */
+	int32_t hashing_batch_size;
+
+	/** Hashed examples of the current batch */
+	SGSparseMatrix<float64_t> batch_vectors;
+
+	/** Labels of the current batch */
+	SGVector<float64_t> batch_labels;
+
+	/** Number of examples in the current batch */
+	int32_t batch_length;
+
+	/** Index of the next example of the current batch */
+	int32_t batch_index;
 };
 }
 
@@ -198,7 +198,6 @@ void CStreamingVwFeatures::setup_example(VwExample* ae)
 	}
 
 	// Add constant feature
-	vw_size_t constant_namespace = 128;
 	VwFeature temp = {1,constant_hash & env->mask};
 	ae->indices.push(constant_namespace);
 	ae->atomics[constant_namespace].push(temp);
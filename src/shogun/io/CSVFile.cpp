@@ -9,8 +9,11 @@
 
 #include <shogun/io/CSVFile.h>
 
+#include <shogun/io/LineChunks.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/Time.h>
+#include <shogun/mathematics/Math.h>
 
 using namespace shogun;
 
@@ -174,51 +177,126 @@ GET_VECTOR(read_long, int64_t)
 GET_VECTOR(read_ulong, uint64_t)
 #undef GET_VECTOR
 
+template <class T>
+void CCSVFile::load_matrix(T*& matrix, int32_t& num_feat, int32_t& num_vec)
+{
+	CTime timer;
+	m_line_reader->reset();
+
+	int32_t num_threads=parallel->get_num_threads();
+	SGLineChunks chunks(file);
+	chunks.skip_lines(m_num_to_skip);
+	chunks.split(num_threads);
+	int32_t num_chunks=chunks.get_num_chunks();
+
+	/* index of the first line of each chunk */
+	SGVector<int64_t> offsets(num_chunks+1);
+	offsets[0]=0;
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t c=0; c<num_chunks; c++)
+		offsets[c+1]=SGLineChunks::count_lines(chunks.get_begin(c), chunks.get_end(c));
+	for (int32_t c=0; c<num_chunks; c++)
+		offsets[c+1]+=offsets[c];
+
+	REQUIRE(offsets[num_chunks]<=INT32_MAX,
+		"Too many lines (%lld) in file %s\n", offsets[num_chunks], filename);
+	int32_t num_lines=offsets[num_chunks];
+
+	const bool* delimiters=m_tokenizer->delimiters.vector;
+
+	/* the first line determines the number of tokens */
+	int32_t num_tokens=0;
+	const char* first=chunks.get_begin(0);
+	const char* first_end=SGLineChunks::next_line(first, chunks.get_end(num_chunks-1));
+	for (const char* p=first; first_end && p<first_end; num_tokens++)
+	{
+		while (p<first_end && delimiters[(uint8_t) *p])
+			p++;
+		if (p==first_end)
+			break;
+		while (p<first_end && !delimiters[(uint8_t) *p])
+			p++;
+	}
+
+	matrix=SG_MALLOC(T, int64_t(num_lines)*num_tokens);
+
+	/* first line of each chunk with too few tokens */
+	SGVector<int64_t> bad_lines(num_chunks);
+	bad_lines.set_const(-1);
+
+	SG_SET_LOCALE_C;
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t c=0; c<num_chunks; c++)
+	{
+		int64_t line_idx=offsets[c];
+		const char* line=chunks.get_begin(c);
+		const char* end=chunks.get_end(c);
+		const char* line_end;
+
+		while ((line_end=SGLineChunks::next_line(line, end)))
+		{
+			const char* token=line;
+			for (int32_t i=0; i<num_tokens; i++)
+			{
+				while (token<line_end && delimiters[(uint8_t) *token])
+					token++;
+				const char* token_end=token;
+				while (token_end<line_end && !delimiters[(uint8_t) *token_end])
+					token_end++;
+
+				if (token==token_end && bad_lines[c]<0)
+					bad_lines[c]=line_idx;
+
+				T value=0;
+				SGLineChunks::parse(token, token_end, value);
+				if (!is_data_transposed)
+					matrix[i+line_idx*num_tokens]=value;
+				else
+					matrix[line_idx+int64_t(i)*num_lines]=value;
+
+				token=token_end;
+			}
+
+			line_idx++;
+			line=line_end;
+		}
+	}
+
+	SG_RESET_LOCALE;
+
+	for (int32_t c=0; c<num_chunks; c++)
+	{
+		if (bad_lines[c]>=0)
+		{
+			SG_FREE(matrix);
+			matrix=NULL;
+			SG_ERROR("Line %lld of file %s has less than %d values\n",
+				bad_lines[c]+m_num_to_skip+1, filename, num_tokens);
+		}
+	}
+
+	if (!is_data_transposed)
+	{
+		num_feat=num_tokens;
+		num_vec=num_lines;
+	}
+	else
+	{
+		num_feat=num_lines;
+		num_vec=num_tokens;
+	}
+
+	float64_t seconds=CMath::max(timer.cur_time_diff(), 1e-9);
+	float64_t megabytes=chunks.get_num_bytes()/1048576.0;
+	SG_INFO("read %d lines (%.1f MB) of file %s in %.2f seconds (%.1f MB/s)\n",
+		num_lines, megabytes, filename, seconds, megabytes/seconds)
+}
+
 #define GET_MATRIX(read_func, sg_type) \
 void CCSVFile::get_matrix(sg_type*& matrix, int32_t& num_feat, int32_t& num_vec) \
 { \
-	int32_t num_lines=0; \
-	int32_t num_tokens=-1; \
-	int32_t current_line_idx=0; \
-	SGVector<char> line; \
-	\
-	skip_lines(m_num_to_skip); \
-	num_lines=get_stats(num_tokens); \
-	\
-	SG_SET_LOCALE_C; \
-	\
-	matrix=SG_MALLOC(sg_type, num_lines*num_tokens); \
-	skip_lines(m_num_to_skip); \
-	while (m_line_reader->has_next()) \
-	{ \
-		line=m_line_reader->read_line(); \
-		m_parser->set_text(line); \
-		\
-		for (int32_t i=0; i<num_tokens; i++) \
-		{ \
-			if (!m_parser->has_next()) \
-				return; \
-			\
-			if (!is_data_transposed) \
-				matrix[i+current_line_idx*num_tokens]=m_parser->read_func(); \
-			else \
-				matrix[current_line_idx+i*num_tokens]=m_parser->read_func(); \
-		} \
-		current_line_idx++; \
-	} \
-	\
-	SG_RESET_LOCALE; \
-	\
-	if (!is_data_transposed) \
-	{ \
-		num_feat=num_tokens; \
-		num_vec=num_lines; \
-	} \
-	else \
-	{ \
-		num_feat=num_lines; \
-		num_vec=num_tokens; \
-	} \
+	load_matrix(matrix, num_feat, num_vec); \
 }
 
 GET_MATRIX(read_char, int8_t)
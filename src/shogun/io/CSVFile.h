@@ -107,6 +107,9 @@ public:
 	 * These functions are used when loading matrices from e.g. file
 	 * and return the matrices and its dimensions num_feat and num_vec
 	 * by reference
+	 *
+	 * The file is split into line aligned chunks which are parsed in
+	 * parallel (see SGLineChunks).
 	 */
 	//@{
 	virtual void get_matrix(
@@ -389,6 +392,15 @@ private:
 	/** skip m_num_skipped lines */
 	void skip_lines(int32_t num_lines);
 
+	/** read matrix in parallel
+	 *
+	 * @param matrix matrix
+	 * @param num_feat number of features
+	 * @param num_vec number of vectors
+	 */
+	template <class T>
+	void load_matrix(T*& matrix, int32_t& num_feat, int32_t& num_vec);
+
 private:
 	/** object for reading lines from file */
 	CLineReader* m_line_reader;
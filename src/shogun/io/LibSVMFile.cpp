@@ -9,9 +9,13 @@
 
 #include <shogun/io/LibSVMFile.h>
 
+#include <shogun/io/LineChunks.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGSparseVector.h>
-#include <shogun/base/DynArray.h>
+#include <shogun/lib/Time.h>
+#include <shogun/mathematics/Math.h>
+
+#include <string.h>
 
 using namespace shogun;
 
@@ -96,73 +100,131 @@ GET_SPARSE_MATRIX(read_long, int64_t)
 GET_SPARSE_MATRIX(read_ulong, uint64_t)
 #undef GET_SPARSE_MATRIX
 
+static inline bool is_whitespace(char c)
+{
+	return c==' ' || c=='\t';
+}
+
+template <class T>
+void CLibSVMFile::load_sparse_matrix(SGSparseVector<T>*& matrix, int32_t& num_feat,
+		int32_t& num_vec, float64_t*& labels, bool load_labels)
+{
+	CTime timer;
+	m_line_reader->reset();
+
+	int32_t num_threads=parallel->get_num_threads();
+	SGLineChunks chunks(file);
+	chunks.split(num_threads);
+	int32_t num_chunks=chunks.get_num_chunks();
+
+	/* index of the first vector of each chunk */
+	SGVector<int64_t> offsets(num_chunks+1);
+	offsets[0]=0;
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t c=0; c<num_chunks; c++)
+		offsets[c+1]=SGLineChunks::count_lines(chunks.get_begin(c), chunks.get_end(c));
+	for (int32_t c=0; c<num_chunks; c++)
+		offsets[c+1]+=offsets[c];
+
+	REQUIRE(offsets[num_chunks]<=INT32_MAX,
+		"Too many lines (%lld) in file %s\n", offsets[num_chunks], filename);
+	num_vec=offsets[num_chunks];
+
+	matrix=SG_MALLOC(SGSparseVector<T>, num_vec);
+	if (load_labels)
+		labels=SG_MALLOC(float64_t, num_vec);
+
+	SGVector<int32_t> max_index(num_chunks);
+	max_index.zero();
+	const char delimiter=m_delimiter;
+
+	SG_SET_LOCALE_C;
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t c=0; c<num_chunks; c++)
+	{
+		int64_t line_idx=offsets[c];
+		const char* line=chunks.get_begin(c);
+		const char* end=chunks.get_end(c);
+		const char* line_end;
+
+		while ((line_end=SGLineChunks::next_line(line, end)))
+		{
+			const char* p=line;
+			while (p<line_end && is_whitespace(*p))
+				p++;
+			const char* token_end=p;
+			while (token_end<line_end && !is_whitespace(*token_end))
+				token_end++;
+
+			if (load_labels)
+			{
+				float64_t label=0;
+				SGLineChunks::parse(p, token_end, label);
+				labels[line_idx]=label;
+				p=token_end;
+			}
+			else if (!memchr(p, delimiter, token_end-p))
+				p=token_end;
+
+			int32_t num_entries=0;
+			for (const char* q=p; q<line_end; num_entries++)
+			{
+				while (q<line_end && is_whitespace(*q))
+					q++;
+				if (q==line_end)
+					break;
+				while (q<line_end && !is_whitespace(*q))
+					q++;
+			}
+
+			SGSparseVector<T> vec(num_entries);
+			for (int32_t i=0; i<num_entries; i++)
+			{
+				while (is_whitespace(*p))
+					p++;
+				token_end=p;
+				while (token_end<line_end && !is_whitespace(*token_end))
+					token_end++;
+
+				int32_t feat_index=0;
+				const char* q=SGLineChunks::parse(p, token_end, feat_index);
+
+				T entry=0;
+				if (q<token_end && *q==delimiter)
+					SGLineChunks::parse(q+1, token_end, entry);
+
+				if (feat_index>max_index[c])
+					max_index[c]=feat_index;
+
+				vec.features[i].feat_index=feat_index-1;
+				vec.features[i].entry=entry;
+				p=token_end;
+			}
+
+			matrix[line_idx]=vec;
+			line_idx++;
+			line=line_end;
+		}
+	}
+
+	SG_RESET_LOCALE;
+
+	num_feat=0;
+	for (int32_t c=0; c<num_chunks; c++)
+		num_feat=CMath::max(num_feat, max_index[c]);
+
+	float64_t seconds=CMath::max(timer.cur_time_diff(), 1e-9);
+	float64_t megabytes=chunks.get_num_bytes()/1048576.0;
+	SG_INFO("read %d vectors (%.1f MB) of file %s in %.2f seconds (%.1f MB/s)\n",
+		num_vec, megabytes, filename, seconds, megabytes/seconds)
+}
+
 #define GET_LABELED_SPARSE_MATRIX(read_func, sg_type) \
 void CLibSVMFile::get_sparse_matrix(SGSparseVector<sg_type>*& matrix, int32_t& num_feat, int32_t& num_vec, \
 					float64_t*& labels, bool load_labels) \
 { \
-	num_feat=0; \
-	\
-	SG_INFO("counting line numbers in file %s\n", filename) \
-	num_vec=get_num_lines(); \
-	\
-	int32_t current_line_ind=0; \
-	SGVector<char> line; \
-	\
-	int32_t num_entries=0; \
-	DynArray<SGVector<char> > entries; \
-	\
-	matrix=SG_MALLOC(SGSparseVector<sg_type>, num_vec); \
-	if (load_labels) \
-		labels=SG_MALLOC(float64_t, num_vec); \
-	\
-	SG_SET_LOCALE_C; \
-	\
-	while (m_line_reader->has_next()) \
-	{ \
-		num_entries=0; \
-		entries.reset(SGVector<char>(false)); \
-		line=m_line_reader->read_line(); \
-		\
-		m_parser->set_tokenizer(m_whitespace_tokenizer); \
-		m_parser->set_text(line); \
-		\
-		if (load_labels && m_parser->has_next()) \
-			labels[current_line_ind]=m_parser->read_real(); \
-		\
-		while (m_parser->has_next()) \
-		{ \
-			entries.push_back(m_parser->read_string()); \
-			num_entries++; \
-		} \
-		\
-		matrix[current_line_ind]=SGSparseVector<sg_type>(num_entries); \
-		for (int32_t i=0; i<num_entries; i++) \
-		{ \
-			m_parser->set_tokenizer(m_delimiter_tokenizer); \
-			m_parser->set_text(entries[i]); \
-			\
-			int32_t feat_index=0; \
-			if (m_parser->has_next()) \
-				feat_index=m_parser->read_int(); \
-			\
-			sg_type entry=0; \
-			if (m_parser->has_next()) \
-				entry=m_parser->read_func(); \
-			\
-			if (feat_index>num_feat) \
-				num_feat=feat_index; \
-			\
-			matrix[current_line_ind].features[i].feat_index=feat_index-1; \
-			matrix[current_line_ind].features[i].entry=entry; \
-		} \
-		\
-		current_line_ind++; \
-		SG_PROGRESS(current_line_ind, 0, num_vec, 1, "LOADING:\t") \
-	} \
-	\
-	SG_RESET_LOCALE; \
-	\
-	SG_INFO("file successfully read\n") \
+	load_sparse_matrix(matrix, num_feat, num_vec, labels, load_labels); \
 }
 
 GET_LABELED_SPARSE_MATRIX(read_bool, bool)
@@ -241,16 +303,3 @@ SET_LABELED_SPARSE_MATRIX(".16Lg", floatmax_t)
 SET_LABELED_SPARSE_MATRIX(SCNi16, int16_t)
 SET_LABELED_SPARSE_MATRIX(SCNu16, uint16_t)
 #undef SET_LABELED_SPARSE_MATRIX
-
-int32_t CLibSVMFile::get_num_lines()
-{
-	int32_t num_lines=0;
-	while (m_line_reader->has_next())
-	{
-		m_line_reader->skip_line();
-		num_lines++;
-	}
-	m_line_reader->reset();
-
-	return num_lines;
-}
@@ -172,6 +172,10 @@ public:
 	 * These functions are used when loading sparse matrices from e.g. file
 	 * and return the sparse matrices and its dimensions num_feat and num_vec
 	 * by reference
+	 *
+	 * The file is split into line aligned chunks which are parsed in
+	 * parallel (see SGLineChunks). If labels aren't loaded, a leading
+	 * label is skipped.
 	 */
 	//@{
 	virtual void get_sparse_matrix(
@@ -444,8 +448,17 @@ private:
 	/** class initialization */
 	void init_with_defaults();
 
-	/** get number of lines */
-	int32_t get_num_lines();
+	/** read sparse matrix in parallel
+	 *
+	 * @param matrix matrix
+	 * @param num_feat number of features
+	 * @param num_vec number of vectors
+	 * @param labels labels
+	 * @param load_labels whether to load labels
+	 */
+	template <class T>
+	void load_sparse_matrix(SGSparseVector<T>*& matrix, int32_t& num_feat,
+			int32_t& num_vec, float64_t*& labels, bool load_labels);
 
 private:
 	/** delimiter for index and data in sparse entries */
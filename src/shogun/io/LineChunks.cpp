@@ -0,0 +1,355 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/io/LineChunks.h>
+#include <shogun/lib/memory.h>
+#include <shogun/mathematics/Math.h>
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+using namespace shogun;
+
+/* powers of ten which are exactly representable as float64_t */
+static const float64_t powers_of_ten[]=
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool is_digit(char c)
+{
+	return c>='0' && c<='9';
+}
+
+template <class T> static T convert(const char* str, char** end);
+
+template <> float64_t convert<float64_t>(const char* str, char** end)
+{
+	return strtod(str, end);
+}
+
+template <> floatmax_t convert<floatmax_t>(const char* str, char** end)
+{
+#ifdef HAVE_STRTOLD
+	return strtold(str, end);
+#else
+	return strtod(str, end);
+#endif
+}
+
+template <> int64_t convert<int64_t>(const char* str, char** end)
+{
+	return strtoll(str, end, 10);
+}
+
+template <> uint64_t convert<uint64_t>(const char* str, char** end)
+{
+	return strtoull(str, end, 10);
+}
+
+/* convert with the C library, which needs a zero terminated copy */
+template <class T>
+static const char* parse_with_libc(const char* begin, const char* end, T& value)
+{
+	const char* token_end=begin;
+	while (token_end<end && (isalnum((uint8_t) *token_end) || *token_end=='+' ||
+				*token_end=='-' || *token_end=='.'))
+		token_end++;
+
+	size_t len=token_end-begin;
+	char local[64];
+	char* str=len<sizeof(local) ? local : SG_MALLOC(char, len+1);
+	memcpy(str, begin, len);
+	str[len]=0;
+
+	char* str_end=str;
+	value=convert<T>(str, &str_end);
+	const char* result=begin+(str_end-str);
+
+	if (str!=local)
+		SG_FREE(str);
+
+	return result;
+}
+
+static const char* parse_real(const char* begin, const char* end, float64_t& value)
+{
+	const char* p=begin;
+	bool negative=false;
+	if (p<end && (*p=='-' || *p=='+'))
+	{
+		negative=*p=='-';
+		p++;
+	}
+
+	/* significant digits and decimal exponent */
+	uint64_t mantissa=0;
+	int32_t num_digits=0;
+	int32_t exponent=0;
+	bool any_digits=false;
+
+	for (; p<end && is_digit(*p); p++)
+	{
+		any_digits=true;
+		if (num_digits<19)
+		{
+			mantissa=10*mantissa+(*p-'0');
+			if (mantissa)
+				num_digits++;
+		}
+		else
+			exponent++;
+	}
+
+	if (p<end && *p=='.')
+	{
+		for (p++; p<end && is_digit(*p); p++)
+		{
+			any_digits=true;
+			if (num_digits<19)
+			{
+				mantissa=10*mantissa+(*p-'0');
+				if (mantissa)
+					num_digits++;
+				exponent--;
+			}
+		}
+	}
+
+	/* nan, inf or no number */
+	if (!any_digits)
+		return parse_with_libc(begin, end, value);
+
+	if (p<end && (*p=='e' || *p=='E'))
+	{
+		const char* q=p+1;
+		bool negative_exponent=false;
+		if (q<end && (*q=='-' || *q=='+'))
+		{
+			negative_exponent=*q=='-';
+			q++;
+		}
+
+		if (q<end && is_digit(*q))
+		{
+			int32_t e=0;
+			for (; q<end && is_digit(*q); q++)
+			{
+				if (e<100000)
+					e=10*e+(*q-'0');
+			}
+			exponent+=negative_exponent ? -e : e;
+			p=q;
+		}
+	}
+
+	/* the mantissa and the power of ten are exact, so is their
+	 * correctly rounded product or quotient */
+	if (num_digits>15 || exponent<-22 || exponent>22)
+		return parse_with_libc(begin, end, value);
+
+	value=(float64_t) mantissa;
+	if (exponent<0)
+		value/=powers_of_ten[-exponent];
+	else
+		value*=powers_of_ten[exponent];
+
+	if (negative)
+		value=-value;
+
+	return p;
+}
+
+template <class T>
+static const char* parse_integer(const char* begin, const char* end, T& value)
+{
+	const char* p=begin;
+	bool negative=false;
+	if (p<end && (*p=='-' || *p=='+'))
+	{
+		negative=*p=='-';
+		p++;
+	}
+
+	uint64_t x=0;
+	int32_t num_digits=0;
+	for (; p<end && is_digit(*p); p++, num_digits++)
+		x=10*x+(*p-'0');
+
+	/* possible overflow or an unsigned number with sign */
+	if (num_digits==0 || num_digits>18 || (negative && T(-1)>0))
+		return parse_with_libc(begin, end, value);
+
+	value=negative ? -T(x) : T(x);
+	return p;
+}
+
+SGLineChunks::SGLineChunks(FILE* file)
+: data(NULL), size(0), mapped(false), begin(NULL), num_chunks(0), bounds(NULL)
+{
+	struct stat file_stat;
+	int fd=fileno(file);
+	bool regular=fd>=0 && fstat(fd, &file_stat)==0 && S_ISREG(file_stat.st_mode);
+
+	if (regular && file_stat.st_size>0)
+	{
+		void* address=mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (address!=MAP_FAILED)
+		{
+			data=(char*) address;
+			size=file_stat.st_size;
+			mapped=true;
+
+			/* leave the stream at its end, as reading it would */
+			fseek(file, 0, SEEK_END);
+			fgetc(file);
+		}
+	}
+
+	if (!mapped)
+	{
+		if (regular)
+			fseek(file, 0, SEEK_SET);
+
+		int64_t capacity=0;
+		while (!feof(file) && !ferror(file))
+		{
+			if (size==capacity)
+			{
+				int64_t new_capacity=CMath::max(2*capacity, int64_t(1<<20));
+				data=SG_REALLOC(char, data, capacity, new_capacity);
+				capacity=new_capacity;
+			}
+			size+=fread(data+size, 1, capacity-size, file);
+		}
+	}
+
+	begin=data;
+	split(1);
+}
+
+SGLineChunks::~SGLineChunks()
+{
+	if (mapped)
+		munmap(data, size);
+	else
+		SG_FREE(data);
+
+	SG_FREE(bounds);
+}
+
+const char* SGLineChunks::next_line(const char*& line, const char* end)
+{
+	while (line<end)
+	{
+		const char* line_end=(const char*) memchr(line, '\n', end-line);
+		if (!line_end)
+			line_end=end;
+
+		const char* content_end=line_end;
+		if (content_end>line && content_end[-1]=='\r')
+			content_end--;
+
+		if (content_end>line)
+			return content_end;
+
+		line=line_end<end ? line_end+1 : end;
+	}
+
+	return NULL;
+}
+
+int64_t SGLineChunks::count_lines(const char* begin, const char* end)
+{
+	int64_t num_lines=0;
+	const char* line=begin;
+	const char* line_end;
+	while ((line_end=next_line(line, end)))
+	{
+		num_lines++;
+		line=line_end;
+	}
+
+	return num_lines;
+}
+
+void SGLineChunks::skip_lines(int32_t num_lines)
+{
+	const char* end=data+size;
+	for (int32_t i=0; i<num_lines; i++)
+	{
+		const char* line_end=next_line(begin, end);
+		if (!line_end)
+			break;
+		begin=line_end;
+	}
+
+	split(num_chunks);
+}
+
+void SGLineChunks::split(int32_t n)
+{
+	SG_FREE(bounds);
+	num_chunks=CMath::max(n, 1);
+	bounds=SG_MALLOC(const char*, num_chunks+1);
+
+	const char* end=data+size;
+	bounds[0]=begin;
+	for (int32_t i=1; i<num_chunks; i++)
+	{
+		const char* target=CMath::max(begin+(end-begin)*i/num_chunks, bounds[i-1]);
+		const char* line_end=(const char*) memchr(target, '\n', end-target);
+		bounds[i]=line_end ? line_end+1 : end;
+	}
+	bounds[num_chunks]=end;
+}
+
+const char* SGLineChunks::parse(const char* begin, const char* end, int64_t& value)
+{
+	return parse_integer(begin, end, value);
+}
+
+const char* SGLineChunks::parse(const char* begin, const char* end, uint64_t& value)
+{
+	return parse_integer(begin, end, value);
+}
+
+const char* SGLineChunks::parse(const char* begin, const char* end, float64_t& value)
+{
+	return parse_real(begin, end, value);
+}
+
+const char* SGLineChunks::parse(const char* begin, const char* end, floatmax_t& value)
+{
+	return parse_with_libc(begin, end, value);
+}
+
+/* types the C library converts with strtod, as CParser does */
+#define PARSE_AS_REAL(sg_type) \
+const char* SGLineChunks::parse(const char* begin, const char* end, sg_type& value) \
+{ \
+	float64_t x=0; \
+	const char* p=parse_real(begin, end, x); \
+	value=(sg_type) x; \
+	return p; \
+}
+
+PARSE_AS_REAL(bool)
+PARSE_AS_REAL(char)
+PARSE_AS_REAL(int8_t)
+PARSE_AS_REAL(uint8_t)
+PARSE_AS_REAL(int16_t)
+PARSE_AS_REAL(uint16_t)
+PARSE_AS_REAL(int32_t)
+PARSE_AS_REAL(uint32_t)
+PARSE_AS_REAL(float32_t)
+#undef PARSE_AS_REAL
@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef __LINECHUNKS_H__
+#define __LINECHUNKS_H__
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/common.h>
+
+#include <stdio.h>
+
+namespace shogun
+{
+
+/** @brief Contents of a text file split into line aligned chunks which can
+ * be parsed in parallel.
+ *
+ * Regular files are memory mapped, other streams (e.g. pipes) are read into
+ * memory. Lines are separated by '\\n', an optional trailing '\\r' is
+ * ignored and empty lines are skipped, as CLineReader does.
+ *
+ * The parse() functions convert the number at the beginning of a range
+ * like strtod/strtoll do, but without requiring a terminating zero and
+ * without strtod in the common case: decimals with up to 15 significant
+ * digits and small exponents are converted exactly from their integer
+ * mantissa, others fall back to the C library.
+ */
+class SGLineChunks
+{
+public:
+	/** constructor, maps the file from its beginning and leaves the
+	 * stream at its end
+	 *
+	 * @param file stream
+	 */
+	SGLineChunks(FILE* file);
+
+	/** destructor, unmaps the file */
+	~SGLineChunks();
+
+	/** skip non-empty lines at the beginning
+	 *
+	 * @param num_lines number of lines
+	 */
+	void skip_lines(int32_t num_lines);
+
+	/** split remaining contents into chunks, each starting at a line
+	 *
+	 * @param num_chunks number of chunks (usually the number of threads)
+	 */
+	void split(int32_t num_chunks);
+
+	/** @return number of chunks */
+	int32_t get_num_chunks() const { return num_chunks; }
+
+	/** @return first character of chunk */
+	const char* get_begin(int32_t chunk) const { return bounds[chunk]; }
+
+	/** @return end of chunk */
+	const char* get_end(int32_t chunk) const { return bounds[chunk+1]; }
+
+	/** @return number of bytes in the file */
+	int64_t get_num_bytes() const { return size; }
+
+	/** find next line
+	 *
+	 * @param line beginning of the search, set to the next non-empty line
+	 * @param end end of the range
+	 * @return end of the line (without '\\r') or NULL if there is none
+	 */
+	static const char* next_line(const char*& line, const char* end);
+
+	/** @return number of non-empty lines in range */
+	static int64_t count_lines(const char* begin, const char* end);
+
+	/** @name Number Parsing Functions
+	 *
+	 * Parse the number at the beginning of [begin,end)
+	 *
+	 * @param begin beginning of the number
+	 * @param end end of the range
+	 * @param value parsed value, 0 if there is no number
+	 * @return end of the number, begin if there is no number
+	 */
+	//@{
+	static const char* parse(const char* begin, const char* end, bool& value);
+	static const char* parse(const char* begin, const char* end, char& value);
+	static const char* parse(const char* begin, const char* end, int8_t& value);
+	static const char* parse(const char* begin, const char* end, uint8_t& value);
+	static const char* parse(const char* begin, const char* end, int16_t& value);
+	static const char* parse(const char* begin, const char* end, uint16_t& value);
+	static const char* parse(const char* begin, const char* end, int32_t& value);
+	static const char* parse(const char* begin, const char* end, uint32_t& value);
+	static const char* parse(const char* begin, const char* end, int64_t& value);
+	static const char* parse(const char* begin, const char* end, uint64_t& value);
+	static const char* parse(const char* begin, const char* end, float32_t& value);
+	static const char* parse(const char* begin, const char* end, float64_t& value);
+	static const char* parse(const char* begin, const char* end, floatmax_t& value);
+	//@}
+
+private:
+	/** contents */
+	char* data;
+	/** number of bytes */
+	int64_t size;
+	/** whether data is memory mapped */
+	bool mapped;
+	/** beginning of the remaining contents */
+	const char* begin;
+	/** number of chunks */
+	int32_t num_chunks;
+	/** chunk boundaries */
+	const char** bounds;
+};
+
+}
+#endif /* __LINECHUNKS_H__ */
@@ -37,6 +37,8 @@ namespace shogun
  */
 class CProtobufFile : public CFile
 {
+	template <class T> friend class CStreamingProtobufFile;
+
 public:
 	/** default constructor */
 	CProtobufFile();
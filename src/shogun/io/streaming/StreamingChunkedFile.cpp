@@ -0,0 +1,130 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/io/streaming/StreamingChunkedFile.h>
+#include <shogun/lib/ShogunException.h>
+
+#include <string.h>
+
+using namespace shogun;
+
+CStreamingChunkedFile::CStreamingChunkedFile() : CStreamingFile()
+{
+	init();
+}
+
+CStreamingChunkedFile::~CStreamingChunkedFile()
+{
+	stop_read_ahead();
+}
+
+void CStreamingChunkedFile::init()
+{
+	m_current_slot=1;
+	m_read_in_background=true;
+	m_reading_ahead=false;
+	m_read_ahead_ok=false;
+	m_read_ahead_error=NULL;
+}
+
+void* CStreamingChunkedFile::read_ahead_helper(void* file)
+{
+	CStreamingChunkedFile* chunked_file=(CStreamingChunkedFile*) file;
+
+	// errors are raised again by the thread waiting for the chunk
+	try
+	{
+		chunked_file->m_read_ahead_ok=
+			chunked_file->read_chunk(1-chunked_file->m_current_slot);
+	}
+	catch (ShogunException& e)
+	{
+		chunked_file->m_read_ahead_ok=false;
+		chunked_file->m_read_ahead_error=get_strdup(e.get_exception_string());
+	}
+
+	return NULL;
+}
+
+void CStreamingChunkedFile::set_read_in_background(bool background)
+{
+	REQUIRE(!m_reading_ahead, "Cannot change how chunks are read while "
+			"reading ahead\n")
+	m_read_in_background=background;
+}
+
+bool CStreamingChunkedFile::get_read_in_background() const
+{
+#ifdef HAVE_PTHREAD
+	return m_read_in_background;
+#else
+	return false;
+#endif
+}
+
+void CStreamingChunkedFile::start_read_ahead()
+{
+	stop_read_ahead();
+
+	m_reading_ahead=true;
+#ifdef HAVE_PTHREAD
+	if (m_read_in_background && pthread_create(&m_read_ahead_thread, NULL, read_ahead_helper, this))
+	{
+		m_reading_ahead=false;
+		SG_ERROR("Could not create read ahead thread\n")
+	}
+#endif
+}
+
+bool CStreamingChunkedFile::next_chunk()
+{
+	if (!m_reading_ahead)
+		return false;
+
+	if (get_read_in_background())
+	{
+#ifdef HAVE_PTHREAD
+		pthread_join(m_read_ahead_thread, NULL);
+#endif
+	}
+	else
+		read_ahead_helper(this);
+	m_reading_ahead=false;
+
+	if (m_read_ahead_error)
+	{
+		char error[1024];
+		strncpy(error, m_read_ahead_error, sizeof(error)-1);
+		error[sizeof(error)-1]='\0';
+		SG_FREE(m_read_ahead_error);
+		m_read_ahead_error=NULL;
+		SG_ERROR("Error reading chunk from file: %s", error)
+	}
+
+	if (!m_read_ahead_ok)
+		return false;
+
+	m_current_slot=1-m_current_slot;
+	start_read_ahead();
+
+	return true;
+}
+
+void CStreamingChunkedFile::stop_read_ahead()
+{
+	if (!m_reading_ahead)
+		return;
+
+#ifdef HAVE_PTHREAD
+	if (m_read_in_background)
+		pthread_join(m_read_ahead_thread, NULL);
+#endif
+	m_reading_ahead=false;
+
+	SG_FREE(m_read_ahead_error);
+	m_read_ahead_error=NULL;
+}
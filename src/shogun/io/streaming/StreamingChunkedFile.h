@@ -0,0 +1,109 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef __STREAMING_CHUNKED_FILE_H__
+#define __STREAMING_CHUNKED_FILE_H__
+
+#include <shogun/lib/config.h>
+#include <shogun/io/streaming/StreamingFile.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+namespace shogun
+{
+/** @brief Base class for streaming files that read their input in chunks
+ * of many vectors, e.g. HDF5 hyperslabs or protobuf chunk messages.
+ *
+ * Two chunks are kept in memory. While vectors are returned from the
+ * current chunk, the next one is read ahead in a background thread, so
+ * that file I/O overlaps with parsing and learning. Without pthreads, or
+ * if the derived class disables it because its library must not be called
+ * from another thread (see set_read_in_background), the next chunk is read
+ * when the current one is exhausted.
+ *
+ * Derived classes implement read_chunk, which reads the next chunk of the
+ * file into one of two buffer slots, and return vectors from the slot
+ * given by get_current_slot. They have to call start_read_ahead once the
+ * file is opened and stop_read_ahead in their destructor.
+ */
+class CStreamingChunkedFile: public CStreamingFile
+{
+public:
+	/** default constructor */
+	CStreamingChunkedFile();
+
+	/** destructor */
+	virtual ~CStreamingChunkedFile();
+
+	/** @return object name */
+	virtual const char* get_name() const { return "StreamingChunkedFile"; }
+
+protected:
+	/** reads the next chunk of the file into a buffer slot, called from
+	 * the read ahead thread or, when reading synchronously, from next_chunk
+	 *
+	 * @param slot buffer slot, 0 or 1
+	 * @return whether a chunk was read, false at the end of the file
+	 */
+	virtual bool read_chunk(int32_t slot)=0;
+
+	/** starts reading the next chunk in the background */
+	void start_read_ahead();
+
+	/** waits for the chunk read ahead and makes it the current one, then
+	 * starts reading the next chunk
+	 *
+	 * @return whether there was a next chunk, false at the end of the file
+	 */
+	bool next_chunk();
+
+	/** waits for the chunk being read ahead, if any, and discards it */
+	void stop_read_ahead();
+
+	/** @return buffer slot of the current chunk */
+	int32_t get_current_slot() const { return m_current_slot; }
+
+	/** sets whether chunks are read ahead in a background thread or
+	 * synchronously when needed, to be called before start_read_ahead
+	 *
+	 * @param background whether to read in the background
+	 */
+	void set_read_in_background(bool background);
+
+	/** @return whether chunks are read ahead in a background thread */
+	bool get_read_in_background() const;
+
+private:
+	/** reads a chunk in the background thread */
+	static void* read_ahead_helper(void* file);
+
+	/** init */
+	void init();
+
+	/** buffer slot of the current chunk */
+	int32_t m_current_slot;
+
+	/** whether chunks are read in a background thread */
+	bool m_read_in_background;
+
+	/** whether a chunk is being read ahead */
+	bool m_reading_ahead;
+
+	/** whether the chunk read ahead was read */
+	bool m_read_ahead_ok;
+
+	/** error message of reading ahead, NULL on success */
+	char* m_read_ahead_error;
+
+#ifdef HAVE_PTHREAD
+	/** read ahead thread */
+	pthread_t m_read_ahead_thread;
+#endif
+};
+}
+#endif //__STREAMING_CHUNKED_FILE_H__
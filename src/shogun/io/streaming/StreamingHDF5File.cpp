@@ -0,0 +1,470 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_HDF5
+#include <shogun/io/streaming/StreamingHDF5File.h>
+#include <shogun/mathematics/Math.h>
+
+#include <string.h>
+
+namespace shogun
+{
+
+#define NATIVE_TYPE(sg_type, h5_type)								\
+template<> hid_t CStreamingHDF5File<sg_type>::get_native_type()	\
+{																	\
+	return h5_type;													\
+}
+
+NATIVE_TYPE(char, H5T_NATIVE_CHAR)
+NATIVE_TYPE(int8_t, H5T_NATIVE_INT8)
+NATIVE_TYPE(uint8_t, H5T_NATIVE_UINT8)
+NATIVE_TYPE(int16_t, H5T_NATIVE_INT16)
+NATIVE_TYPE(uint16_t, H5T_NATIVE_UINT16)
+NATIVE_TYPE(int32_t, H5T_NATIVE_INT32)
+NATIVE_TYPE(uint32_t, H5T_NATIVE_UINT32)
+NATIVE_TYPE(int64_t, H5T_NATIVE_INT64)
+NATIVE_TYPE(uint64_t, H5T_NATIVE_UINT64)
+NATIVE_TYPE(float32_t, H5T_NATIVE_FLOAT)
+NATIVE_TYPE(float64_t, H5T_NATIVE_DOUBLE)
+NATIVE_TYPE(floatmax_t, H5T_NATIVE_LDOUBLE)
+#undef NATIVE_TYPE
+
+/* the unsigned type of the size of bool, as in CHDF5File */
+template<> hid_t CStreamingHDF5File<bool>::get_native_type()
+{
+	switch (sizeof(bool))
+	{
+		case 1:
+			return H5T_NATIVE_UCHAR;
+		case 2:
+			return H5T_NATIVE_UINT16;
+		case 4:
+			return H5T_NATIVE_UINT32;
+		case 8:
+			return H5T_NATIVE_UINT64;
+		default:
+			SG_SERROR("Boolean type not supported on this platform\n")
+	}
+
+	return -1;
+}
+
+template<class T>
+CStreamingHDF5File<T>::CStreamingHDF5File() : CStreamingChunkedFile()
+{
+	init();
+}
+
+template<class T>
+CStreamingHDF5File<T>::CStreamingHDF5File(const char* fname,
+		const char* name, const char* label_name, int32_t chunk_size)
+	: CStreamingChunkedFile()
+{
+	init();
+
+	REQUIRE(fname, "File name is NULL!\n")
+	REQUIRE(name, "Dataset name is NULL!\n")
+	REQUIRE(chunk_size>0, "Chunk size (%d) should be positive\n", chunk_size)
+
+	task='r';
+	filename=get_strdup(fname);
+	m_chunk_size=chunk_size;
+
+	H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+	m_h5file=H5Fopen(fname, H5F_ACC_RDONLY, H5P_DEFAULT);
+	if (m_h5file<0)
+		SG_ERROR("Could not open file '%s'\n", fname)
+
+	m_data=H5Dopen2(m_h5file, name, H5P_DEFAULT);
+	if (m_data<0)
+	{
+		hid_t group=H5Gopen2(m_h5file, name, H5P_DEFAULT);
+		if (group<0)
+		{
+			close_handles();
+			SG_ERROR("Could not open dataset or group '%s'\n", name)
+		}
+
+		m_data=H5Dopen2(group, "data", H5P_DEFAULT);
+		m_indices=H5Dopen2(group, "indices", H5P_DEFAULT);
+		m_indptr=H5Dopen2(group, "indptr", H5P_DEFAULT);
+		H5Gclose(group);
+
+		if (m_data<0 || m_indices<0 || m_indptr<0)
+		{
+			close_handles();
+			SG_ERROR("Group '%s' should contain the datasets indptr, indices "
+					"and data\n", name)
+		}
+		if (get_num_elements(m_indices)!=get_num_elements(m_data))
+		{
+			close_handles();
+			SG_ERROR("Datasets indices and data of group '%s' differ in "
+					"size\n", name)
+		}
+
+		m_is_sparse=true;
+		m_num_vectors=get_num_elements(m_indptr)-1;
+	}
+	else
+	{
+		hid_t dataspace=H5Dget_space(m_data);
+		int32_t ndims=H5Sget_simple_extent_ndims(dataspace);
+		hsize_t dims[2]={0, 0};
+		if (ndims==2)
+			H5Sget_simple_extent_dims(dataspace, dims, NULL);
+		H5Sclose(dataspace);
+
+		if (ndims!=2)
+		{
+			close_handles();
+			SG_ERROR("Dataset '%s' is not a 2-dimensional matrix\n", name)
+		}
+
+		m_num_features=dims[0];
+		m_num_vectors=dims[1];
+	}
+
+	if (label_name)
+	{
+		m_labels=H5Dopen2(m_h5file, label_name, H5P_DEFAULT);
+		if (m_labels<0)
+		{
+			close_handles();
+			SG_ERROR("Could not open labels dataset '%s'\n", label_name)
+		}
+
+		const int64_t num_labels=get_num_elements(m_labels);
+		if (num_labels!=m_num_vectors)
+		{
+			close_handles();
+			SG_ERROR("Number of labels (%d) should be number of vectors (%d)\n",
+					(int32_t) num_labels, m_num_vectors)
+		}
+	}
+
+	// the read ahead thread would call HDF5 concurrently with the caller
+	set_read_in_background(is_library_threadsafe());
+
+	SG_DEBUG("Streaming %d %s vectors from '%s' in chunks of %d%s\n",
+			m_num_vectors, m_is_sparse ? "sparse" : "dense", fname, m_chunk_size,
+			get_read_in_background() ? "" : " without reading ahead")
+
+	start_read_ahead();
+}
+
+template<class T>
+CStreamingHDF5File<T>::~CStreamingHDF5File()
+{
+	stop_read_ahead();
+	close_handles();
+}
+
+template<class T>
+void CStreamingHDF5File<T>::close_handles()
+{
+	if (m_labels>=0)
+		H5Dclose(m_labels);
+	if (m_indptr>=0)
+		H5Dclose(m_indptr);
+	if (m_indices>=0)
+		H5Dclose(m_indices);
+	if (m_data>=0)
+		H5Dclose(m_data);
+	if (m_h5file>=0)
+		H5Fclose(m_h5file);
+
+	m_labels=-1;
+	m_indptr=-1;
+	m_indices=-1;
+	m_data=-1;
+	m_h5file=-1;
+}
+
+template<class T>
+bool CStreamingHDF5File<T>::is_library_threadsafe()
+{
+#if H5_VERSION_GE(1,8,16)
+	hbool_t is_threadsafe=false;
+	if (H5is_library_threadsafe(&is_threadsafe)<0)
+		return false;
+
+	return is_threadsafe;
+#elif defined(H5_HAVE_THREADSAFE)
+	return true;
+#else
+	return false;
+#endif
+}
+
+template<class T>
+void CStreamingHDF5File<T>::init()
+{
+	m_h5file=-1;
+	m_data=-1;
+	m_indices=-1;
+	m_indptr=-1;
+	m_labels=-1;
+	m_is_sparse=false;
+	m_num_features=0;
+	m_num_vectors=0;
+	m_chunk_size=1024;
+	m_next_vector=0;
+	m_vector_in_chunk=0;
+	m_chunk_num_vectors[0]=0;
+	m_chunk_num_vectors[1]=0;
+
+	set_generic<T>();
+}
+
+template<class T>
+void CStreamingHDF5File<T>::reset_stream()
+{
+	stop_read_ahead();
+
+	m_next_vector=0;
+	m_vector_in_chunk=0;
+	m_chunk_num_vectors[0]=0;
+	m_chunk_num_vectors[1]=0;
+
+	start_read_ahead();
+}
+
+template<class T>
+int64_t CStreamingHDF5File<T>::get_num_elements(hid_t dataset)
+{
+	hid_t dataspace=H5Dget_space(dataset);
+	int64_t num_elements=H5Sget_simple_extent_npoints(dataspace);
+	H5Sclose(dataspace);
+
+	return num_elements;
+}
+
+template<class T>
+void CStreamingHDF5File<T>::read_elements(hid_t dataset, hid_t mem_type,
+		int64_t begin, int64_t end, void* dest)
+{
+	if (end<=begin)
+		return;
+
+	hid_t file_space=H5Dget_space(dataset);
+	int32_t ndims=H5Sget_simple_extent_ndims(file_space);
+	if (ndims!=1 && ndims!=2)
+	{
+		H5Sclose(file_space);
+		SG_ERROR("Dataset has %d dimensions, 1 or 2 expected\n", ndims)
+	}
+
+	hsize_t dims[2]={0, 1};
+	H5Sget_simple_extent_dims(file_space, dims, NULL);
+	const hsize_t row_len=ndims==2 ? dims[1] : dims[0];
+
+	// elements are stored row after row, so the range is the end of a row,
+	// whole rows and the beginning of a row. hyperslabs are always read in
+	// storage order
+	H5Sselect_none(file_space);
+	for (hsize_t pos=begin; pos<(hsize_t) end; )
+	{
+		hsize_t start[2]={pos/row_len, pos%row_len};
+		hsize_t count[2]={1, 0};
+		if (start[1]>0 || end-pos<row_len)
+			count[1]=CMath::min(row_len-start[1], end-pos);
+		else
+		{
+			count[0]=(end-pos)/row_len;
+			count[1]=row_len;
+		}
+
+		if (ndims==2)
+			H5Sselect_hyperslab(file_space, H5S_SELECT_OR, start, NULL, count, NULL);
+		else
+			H5Sselect_hyperslab(file_space, H5S_SELECT_OR, start+1, NULL, count+1, NULL);
+
+		pos+=count[0]*count[1];
+	}
+
+	hsize_t num_elements=end-begin;
+	hid_t mem_space=H5Screate_simple(1, &num_elements, NULL);
+	herr_t status=H5Dread(dataset, mem_type, mem_space, file_space,
+			H5P_DEFAULT, dest);
+	H5Sclose(mem_space);
+	H5Sclose(file_space);
+
+	if (status<0)
+		SG_ERROR("Error reading elements %lld to %lld\n",
+				(long long int) begin, (long long int) (end-1))
+}
+
+template<class T>
+bool CStreamingHDF5File<T>::read_chunk(int32_t slot)
+{
+	const int32_t num_vectors=CMath::min(m_chunk_size, m_num_vectors-m_next_vector);
+	if (num_vectors<=0)
+		return false;
+
+	if (m_is_sparse)
+	{
+		if (m_chunk_indptr[slot].vlen<num_vectors+1)
+			m_chunk_indptr[slot]=SGVector<int64_t>(num_vectors+1);
+
+		int64_t* indptr=m_chunk_indptr[slot].vector;
+		read_elements(m_indptr, H5T_NATIVE_INT64, m_next_vector,
+				m_next_vector+num_vectors+1, indptr);
+
+		const int64_t begin=indptr[0];
+		const int64_t end=indptr[num_vectors];
+		for (int32_t i=0; i<=num_vectors; i++)
+		{
+			indptr[i]-=begin;
+			REQUIRE(indptr[i]>=0 && indptr[i]<=end-begin && (i==0 ||
+					indptr[i]>=indptr[i-1]), "Offsets of sparse vectors %d "
+					"to %d are not increasing\n", m_next_vector,
+					m_next_vector+num_vectors-1)
+		}
+
+		if (m_chunk_data[slot].vlen<end-begin)
+		{
+			m_chunk_indices[slot]=SGVector<index_t>(end-begin);
+			m_chunk_data[slot]=SGVector<T>(end-begin);
+		}
+		read_elements(m_indices, H5T_NATIVE_INT32, begin, end,
+				m_chunk_indices[slot].vector);
+		read_elements(m_data, get_native_type(), begin, end,
+				m_chunk_data[slot].vector);
+	}
+	else
+	{
+		const int64_t begin=int64_t(m_next_vector)*m_num_features;
+		const int64_t end=begin+int64_t(num_vectors)*m_num_features;
+
+		if (m_chunk_data[slot].vlen<end-begin)
+			m_chunk_data[slot]=SGVector<T>(end-begin);
+		read_elements(m_data, get_native_type(), begin, end,
+				m_chunk_data[slot].vector);
+	}
+
+	if (m_labels>=0)
+	{
+		if (m_chunk_labels[slot].vlen<num_vectors)
+			m_chunk_labels[slot]=SGVector<float64_t>(num_vectors);
+		read_elements(m_labels, H5T_NATIVE_DOUBLE, m_next_vector,
+				m_next_vector+num_vectors, m_chunk_labels[slot].vector);
+	}
+
+	m_chunk_num_vectors[slot]=num_vectors;
+	m_next_vector+=num_vectors;
+
+	return true;
+}
+
+template<class T>
+bool CStreamingHDF5File<T>::next_vector()
+{
+	if (m_vector_in_chunk+1<m_chunk_num_vectors[get_current_slot()])
+	{
+		m_vector_in_chunk++;
+		return true;
+	}
+
+	if (!next_chunk())
+		return false;
+
+	m_vector_in_chunk=0;
+	return true;
+}
+
+template<class T>
+float64_t CStreamingHDF5File<T>::get_label()
+{
+	REQUIRE(m_labels>=0, "No labels dataset given!\n")
+	return m_chunk_labels[get_current_slot()][m_vector_in_chunk];
+}
+
+template<class T>
+void CStreamingHDF5File<T>::get_vector(T*& vector, int32_t& len)
+{
+	REQUIRE(!m_is_sparse, "File holds sparse vectors!\n")
+
+	if (!next_vector())
+	{
+		vector=NULL;
+		len=-1;
+		return;
+	}
+
+	if (len<m_num_features)
+		vector=SG_REALLOC(T, vector, len, m_num_features);
+
+	memcpy(vector, m_chunk_data[get_current_slot()].vector+
+			int64_t(m_vector_in_chunk)*m_num_features, sizeof(T)*m_num_features);
+	len=m_num_features;
+}
+
+template<class T>
+void CStreamingHDF5File<T>::get_vector_and_label(T*& vector, int32_t& len,
+		float64_t& label)
+{
+	get_vector(vector, len);
+	if (len>=0)
+		label=get_label();
+}
+
+template<class T>
+void CStreamingHDF5File<T>::get_sparse_vector(SGSparseVectorEntry<T>*& vector,
+		int32_t& len)
+{
+	REQUIRE(m_is_sparse, "File holds dense vectors!\n")
+
+	if (!next_vector())
+	{
+		vector=NULL;
+		len=-1;
+		return;
+	}
+
+	const int32_t slot=get_current_slot();
+	const int64_t begin=m_chunk_indptr[slot][m_vector_in_chunk];
+	const int32_t num_entries=m_chunk_indptr[slot][m_vector_in_chunk+1]-begin;
+
+	if (len<num_entries)
+		vector=SG_REALLOC(SGSparseVectorEntry<T>, vector, len, num_entries);
+
+	for (int32_t i=0; i<num_entries; i++)
+	{
+		vector[i].feat_index=m_chunk_indices[slot][begin+i];
+		vector[i].entry=m_chunk_data[slot][begin+i];
+	}
+	len=num_entries;
+}
+
+template<class T>
+void CStreamingHDF5File<T>::get_sparse_vector_and_label(
+		SGSparseVectorEntry<T>*& vector, int32_t& len, float64_t& label)
+{
+	get_sparse_vector(vector, len);
+	if (len>=0)
+		label=get_label();
+}
+
+template class CStreamingHDF5File<bool>;
+template class CStreamingHDF5File<char>;
+template class CStreamingHDF5File<int8_t>;
+template class CStreamingHDF5File<uint8_t>;
+template class CStreamingHDF5File<int16_t>;
+template class CStreamingHDF5File<uint16_t>;
+template class CStreamingHDF5File<int32_t>;
+template class CStreamingHDF5File<uint32_t>;
+template class CStreamingHDF5File<int64_t>;
+template class CStreamingHDF5File<uint64_t>;
+template class CStreamingHDF5File<float32_t>;
+template class CStreamingHDF5File<float64_t>;
+template class CStreamingHDF5File<floatmax_t>;
+}
+#endif // HAVE_HDF5
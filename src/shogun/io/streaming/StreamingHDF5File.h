@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef __STREAMING_HDF5_FILE_H__
+#define __STREAMING_HDF5_FILE_H__
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_HDF5
+#include <shogun/lib/SGVector.h>
+#include <shogun/io/streaming/StreamingChunkedFile.h>
+#include <hdf5.h>
+
+namespace shogun
+{
+/** @brief Streaming access to dense or sparse matrices in HDF5 files,
+ * for use with CStreamingDenseFeatures and CStreamingSparseFeatures.
+ *
+ * Vectors are read in chunks of chunk_size vectors, each chunk being one
+ * hyperslab of the datasets, while the next chunk is read ahead (see
+ * CStreamingChunkedFile). Only two chunks are in memory at any time, so
+ * matrices larger than memory can be streamed.
+ *
+ * A dense matrix is a dataset of dimensions num_features x num_vectors
+ * holding the vectors one after another, as written by
+ * CHDF5File::set_matrix. A sparse matrix is a group of the datasets
+ * "indptr" (num_vectors+1 offsets), "indices" (feature indices) and "data"
+ * (entries) in compressed sparse column layout, i.e. the entries of vector
+ * i are at positions indptr[i] to indptr[i+1]-1. Labels are an optional
+ * dataset of num_vectors values.
+ *
+ * Values are converted to type T by the HDF5 library. Unless the HDF5
+ * library is thread-safe, chunks are read synchronously rather than in the
+ * background, since HDF5 may then be called from one thread only.
+ */
+template <class T> class CStreamingHDF5File: public CStreamingChunkedFile
+{
+public:
+	/** default constructor */
+	CStreamingHDF5File();
+
+	/** constructor
+	 *
+	 * @param fname name of HDF5 file
+	 * @param name name of the dense dataset or sparse group
+	 * (e.g. "x" or "/path/to/x")
+	 * @param label_name name of labels dataset, NULL if not labelled
+	 * @param chunk_size number of vectors read at once
+	 */
+	CStreamingHDF5File(const char* fname, const char* name,
+			const char* label_name=NULL, int32_t chunk_size=1024);
+
+	/** destructor */
+	virtual ~CStreamingHDF5File();
+
+	/** read next dense vector
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len length of vector, -1 at the end of the file
+	 */
+	virtual void get_vector(T*& vector, int32_t& len);
+
+	/** read next dense vector and its label
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len length of vector, -1 at the end of the file
+	 * @param label label
+	 */
+	virtual void get_vector_and_label(T*& vector, int32_t& len,
+			float64_t& label);
+
+	/** read next sparse vector
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len number of entries, -1 at the end of the file
+	 */
+	virtual void get_sparse_vector(SGSparseVectorEntry<T>*& vector,
+			int32_t& len);
+
+	/** read next sparse vector and its label
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len number of entries, -1 at the end of the file
+	 * @param label label
+	 */
+	virtual void get_sparse_vector_and_label(SGSparseVectorEntry<T>*& vector,
+			int32_t& len, float64_t& label);
+
+	/** @return true, the stream can be reset */
+	virtual bool is_seekable() { return true; }
+
+	/** reset the stream to the first vector */
+	virtual void reset_stream();
+
+	/** @return number of vectors in the file */
+	int32_t get_num_vectors() const { return m_num_vectors; }
+
+	/** @return whether the file holds sparse vectors */
+	bool is_sparse() const { return m_is_sparse; }
+
+	/** @return object name */
+	virtual const char* get_name() const { return "StreamingHDF5File"; }
+
+protected:
+	/** reads the next chunk_size vectors
+	 *
+	 * @param slot buffer slot
+	 * @return false at the end of the file
+	 */
+	virtual bool read_chunk(int32_t slot);
+
+private:
+	/** init */
+	void init();
+
+	/** closes all open datasets and the file */
+	void close_handles();
+
+	/** @return whether the HDF5 library may be called from several threads */
+	static bool is_library_threadsafe();
+
+	/** @return HDF5 memory type of T */
+	static hid_t get_native_type();
+
+	/** @return number of elements of a dataset */
+	static int64_t get_num_elements(hid_t dataset);
+
+	/** reads elements begin to end-1 of a dataset in the order in which
+	 * they are stored, from a one or two dimensional dataset
+	 *
+	 * @param dataset dataset
+	 * @param mem_type memory type of dest
+	 * @param begin first element
+	 * @param end one past last element
+	 * @param dest destination
+	 */
+	void read_elements(hid_t dataset, hid_t mem_type, int64_t begin,
+			int64_t end, void* dest);
+
+	/** moves to the next vector, reading the next chunk if needed
+	 *
+	 * @return false at the end of the file
+	 */
+	bool next_vector();
+
+	/** @return label of the current vector */
+	float64_t get_label();
+
+protected:
+	/** HDF5 file */
+	hid_t m_h5file;
+
+	/** entries dataset */
+	hid_t m_data;
+
+	/** feature indices dataset of sparse vectors */
+	hid_t m_indices;
+
+	/** offsets dataset of sparse vectors */
+	hid_t m_indptr;
+
+	/** labels dataset */
+	hid_t m_labels;
+
+	/** whether vectors are sparse */
+	bool m_is_sparse;
+
+	/** number of features of dense vectors */
+	int32_t m_num_features;
+
+	/** number of vectors */
+	int32_t m_num_vectors;
+
+	/** number of vectors per chunk */
+	int32_t m_chunk_size;
+
+	/** first vector of the next chunk to be read */
+	int32_t m_next_vector;
+
+	/** current vector within the current chunk */
+	int32_t m_vector_in_chunk;
+
+	/** number of vectors of the chunks */
+	int32_t m_chunk_num_vectors[2];
+
+	/** entries of the chunks */
+	SGVector<T> m_chunk_data[2];
+
+	/** feature indices of the sparse chunks */
+	SGVector<index_t> m_chunk_indices[2];
+
+	/** offsets of the sparse vectors of the chunks */
+	SGVector<int64_t> m_chunk_indptr[2];
+
+	/** labels of the chunks */
+	SGVector<float64_t> m_chunk_labels[2];
+};
+}
+#endif // HAVE_HDF5
+#endif //__STREAMING_HDF5_FILE_H__
@@ -0,0 +1,401 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_PROTOBUF
+#include <shogun/io/streaming/StreamingProtobufFile.h>
+#include <shogun/mathematics/Math.h>
+
+#include <string.h>
+
+namespace shogun
+{
+
+/* enlarges buffer to hold at least len elements, keeping the first used */
+template <class S>
+static void ensure_capacity(SGVector<S>& buffer, int32_t used, int32_t len)
+{
+	if (buffer.vlen>=len)
+		return;
+
+	SGVector<S> enlarged(CMath::max(len, 2*buffer.vlen));
+	if (used>0)
+		memcpy(enlarged.vector, buffer.vector, sizeof(S)*used);
+	buffer=enlarged;
+}
+
+/* chunk message types as in CProtobufFile::read_memory_block */
+#define READ_DATA_MESSAGE(chunk_type, sg_type) \
+template<> int32_t CStreamingProtobufFile<sg_type>::read_data_message( \
+		SGVector<sg_type>& buffer, int32_t offset) \
+{ \
+	chunk_type chunk; \
+	m_file->read_message(chunk); \
+	\
+	const int32_t num=chunk.data_size(); \
+	ensure_capacity(buffer, offset, offset+num); \
+	for (int32_t i=0; i<num; i++) \
+		buffer[offset+i]=chunk.data(i); \
+	\
+	return num; \
+}
+
+READ_DATA_MESSAGE(BoolChunk, bool)
+READ_DATA_MESSAGE(Int32Chunk, int8_t)
+READ_DATA_MESSAGE(UInt32Chunk, uint8_t)
+READ_DATA_MESSAGE(UInt32Chunk, char)
+READ_DATA_MESSAGE(Int32Chunk, int32_t)
+READ_DATA_MESSAGE(UInt32Chunk, uint32_t)
+READ_DATA_MESSAGE(Float32Chunk, float32_t)
+READ_DATA_MESSAGE(Float64Chunk, float64_t)
+READ_DATA_MESSAGE(Float64Chunk, floatmax_t)
+READ_DATA_MESSAGE(Int32Chunk, int16_t)
+READ_DATA_MESSAGE(UInt32Chunk, uint16_t)
+READ_DATA_MESSAGE(Int64Chunk, int64_t)
+READ_DATA_MESSAGE(UInt64Chunk, uint64_t)
+#undef READ_DATA_MESSAGE
+
+template<class T>
+CStreamingProtobufFile<T>::CStreamingProtobufFile() : CStreamingChunkedFile()
+{
+	init();
+}
+
+template<class T>
+CStreamingProtobufFile<T>::CStreamingProtobufFile(const char* fname,
+		const char* label_fname) : CStreamingChunkedFile()
+{
+	init();
+
+	REQUIRE(fname, "File name is NULL!\n")
+
+	task='r';
+	filename=get_strdup(fname);
+
+	m_file=new CProtobufFile(fname, 'r');
+	SG_REF(m_file);
+
+	ShogunVersion header;
+	m_file->read_message(header);
+	REQUIRE(header.version()==m_file->version, "File '%s' has version %d, "
+			"%d expected\n", fname, header.version(), m_file->version)
+
+	if (header.data_type()==ShogunVersion::MATRIX)
+	{
+		MatrixHeader data_header=m_file->read_matrix_header();
+		m_num_features=data_header.num_cols();
+		m_num_vectors=data_header.num_rows();
+		m_elements_left=int64_t(m_num_features)*m_num_vectors;
+	}
+	else if (header.data_type()==ShogunVersion::SPARSE_MATRIX)
+	{
+		SparseMatrixHeader data_header=m_file->read_sparse_matrix_header();
+		m_is_sparse=true;
+		m_num_features=data_header.num_features();
+		m_num_vectors=data_header.num_vectors();
+		REQUIRE(data_header.num_feat_entries_size()==m_num_vectors,
+				"Header of file '%s' has %d vector lengths for %d vectors\n",
+				fname, data_header.num_feat_entries_size(), m_num_vectors)
+
+		m_num_feat_entries=SGVector<int32_t>(m_num_vectors);
+		m_elements_left=0;
+		for (int32_t i=0; i<m_num_vectors; i++)
+		{
+			m_num_feat_entries[i]=data_header.num_feat_entries(i);
+			m_elements_left+=m_num_feat_entries[i];
+		}
+	}
+	else
+		SG_ERROR("File '%s' holds neither a matrix nor a sparse matrix\n", fname)
+
+	if (label_fname)
+	{
+		m_label_file=new CProtobufFile(label_fname, 'r');
+		SG_REF(m_label_file);
+
+		m_label_file->read_and_validate_global_header(ShogunVersion::VECTOR);
+		VectorHeader label_header=m_label_file->read_vector_header();
+		REQUIRE((int32_t) label_header.len()==m_num_vectors, "Number of labels (%d) "
+				"should be number of vectors (%d)\n", label_header.len(),
+				m_num_vectors)
+	}
+
+	SG_DEBUG("Streaming %d %s vectors from '%s'\n", m_num_vectors,
+			m_is_sparse ? "sparse" : "dense", fname)
+
+	start_read_ahead();
+}
+
+template<class T>
+CStreamingProtobufFile<T>::~CStreamingProtobufFile()
+{
+	stop_read_ahead();
+
+	SG_UNREF(m_label_file);
+	SG_UNREF(m_file);
+}
+
+template<class T>
+void CStreamingProtobufFile<T>::init()
+{
+	m_file=NULL;
+	m_label_file=NULL;
+	m_is_sparse=false;
+	m_num_features=0;
+	m_num_vectors=0;
+	m_elements_left=0;
+	m_next_vector=0;
+	m_num_pending=0;
+	m_label_pos=0;
+	m_label_buffer_len=0;
+	m_vector_in_chunk=0;
+	m_chunk_num_vectors[0]=0;
+	m_chunk_num_vectors[1]=0;
+
+	set_generic<T>();
+}
+
+template<class T>
+int32_t CStreamingProtobufFile<T>::read_index_message(
+		SGVector<index_t>& buffer, int32_t offset)
+{
+	UInt64Chunk chunk;
+	m_file->read_message(chunk);
+
+	const int32_t num=chunk.data_size();
+	ensure_capacity(buffer, offset, offset+num);
+	for (int32_t i=0; i<num; i++)
+	{
+		REQUIRE(chunk.data(i)<(uint64_t) m_num_features, "Feature index %ld "
+				"should be less than number of features (%d)\n",
+				(int64_t) chunk.data(i), m_num_features)
+		buffer[offset+i]=chunk.data(i);
+	}
+
+	return num;
+}
+
+template<class T>
+int32_t CStreamingProtobufFile<T>::get_vector_length(int32_t i) const
+{
+	return m_is_sparse ? m_num_feat_entries[i] : m_num_features;
+}
+
+template<class T>
+void CStreamingProtobufFile<T>::read_labels(int32_t slot, int32_t num)
+{
+	if (!m_label_file)
+		return;
+
+	ensure_capacity(m_chunk_labels[slot], 0, num);
+	for (int32_t i=0; i<num; i++)
+	{
+		if (m_label_pos==m_label_buffer_len)
+		{
+			Float64Chunk chunk;
+			m_label_file->read_message(chunk);
+
+			m_label_buffer_len=chunk.data_size();
+			ensure_capacity(m_label_buffer, 0, m_label_buffer_len);
+			for (int32_t j=0; j<m_label_buffer_len; j++)
+				m_label_buffer[j]=chunk.data(j);
+			m_label_pos=0;
+		}
+
+		m_chunk_labels[slot][i]=m_label_buffer[m_label_pos++];
+	}
+}
+
+template<class T>
+bool CStreamingProtobufFile<T>::read_chunk(int32_t slot)
+{
+	if (m_next_vector>=m_num_vectors)
+		return false;
+
+	SGVector<T>& data=m_chunk_data[slot];
+	SGVector<index_t>& indices=m_chunk_indices[slot];
+	SGVector<int64_t>& indptr=m_chunk_indptr[slot];
+
+	// the incomplete vector left by the previous message comes first
+	int32_t num_elements=m_num_pending;
+	if (num_elements>0)
+	{
+		ensure_capacity(data, 0, num_elements);
+		memcpy(data.vector, m_pending_data.vector, sizeof(T)*num_elements);
+		if (m_is_sparse)
+		{
+			ensure_capacity(indices, 0, num_elements);
+			memcpy(indices.vector, m_pending_indices.vector,
+					sizeof(index_t)*num_elements);
+		}
+	}
+
+	ensure_capacity(indptr, 0, 1);
+	indptr[0]=0;
+
+	int32_t num_vectors=0;
+	while (true)
+	{
+		while (m_next_vector<m_num_vectors &&
+				indptr[num_vectors]+get_vector_length(m_next_vector)<=num_elements)
+		{
+			ensure_capacity(indptr, num_vectors+1, num_vectors+2);
+			indptr[num_vectors+1]=indptr[num_vectors]+
+				get_vector_length(m_next_vector);
+			num_vectors++;
+			m_next_vector++;
+		}
+
+		if (num_vectors>0)
+			break;
+
+		REQUIRE(m_elements_left>0, "Unexpected end of file '%s' at vector %d\n",
+				filename, m_next_vector)
+
+		// one message, or one pair of index and entry messages
+		int32_t num_read=0;
+		if (m_is_sparse)
+		{
+			num_read=read_index_message(indices, num_elements);
+			REQUIRE(read_data_message(data, num_elements)==num_read,
+					"Index and entry messages differ in size\n")
+		}
+		else
+			num_read=read_data_message(data, num_elements);
+
+		REQUIRE(num_read>0 && num_read<=m_elements_left, "File '%s' holds "
+				"more elements than its header states\n", filename)
+		m_elements_left-=num_read;
+		num_elements+=num_read;
+	}
+
+	m_num_pending=num_elements-indptr[num_vectors];
+	if (m_num_pending>0)
+	{
+		ensure_capacity(m_pending_data, 0, m_num_pending);
+		memcpy(m_pending_data.vector, data.vector+indptr[num_vectors],
+				sizeof(T)*m_num_pending);
+		if (m_is_sparse)
+		{
+			ensure_capacity(m_pending_indices, 0, m_num_pending);
+			memcpy(m_pending_indices.vector, indices.vector+indptr[num_vectors],
+					sizeof(index_t)*m_num_pending);
+		}
+	}
+
+	read_labels(slot, num_vectors);
+	m_chunk_num_vectors[slot]=num_vectors;
+
+	return true;
+}
+
+template<class T>
+bool CStreamingProtobufFile<T>::next_vector()
+{
+	if (m_vector_in_chunk+1<m_chunk_num_vectors[get_current_slot()])
+	{
+		m_vector_in_chunk++;
+		return true;
+	}
+
+	if (!next_chunk())
+		return false;
+
+	m_vector_in_chunk=0;
+	return true;
+}
+
+template<class T>
+float64_t CStreamingProtobufFile<T>::get_label()
+{
+	REQUIRE(m_label_file, "No label file given!\n")
+	return m_chunk_labels[get_current_slot()][m_vector_in_chunk];
+}
+
+template<class T>
+void CStreamingProtobufFile<T>::get_vector(T*& vector, int32_t& len)
+{
+	REQUIRE(!m_is_sparse, "File holds sparse vectors!\n")
+
+	if (!next_vector())
+	{
+		vector=NULL;
+		len=-1;
+		return;
+	}
+
+	if (len<m_num_features)
+		vector=SG_REALLOC(T, vector, len, m_num_features);
+
+	const int32_t slot=get_current_slot();
+	memcpy(vector, m_chunk_data[slot].vector+m_chunk_indptr[slot][m_vector_in_chunk],
+			sizeof(T)*m_num_features);
+	len=m_num_features;
+}
+
+template<class T>
+void CStreamingProtobufFile<T>::get_vector_and_label(T*& vector, int32_t& len,
+		float64_t& label)
+{
+	get_vector(vector, len);
+	if (len>=0)
+		label=get_label();
+}
+
+template<class T>
+void CStreamingProtobufFile<T>::get_sparse_vector(
+		SGSparseVectorEntry<T>*& vector, int32_t& len)
+{
+	REQUIRE(m_is_sparse, "File holds dense vectors!\n")
+
+	if (!next_vector())
+	{
+		vector=NULL;
+		len=-1;
+		return;
+	}
+
+	const int32_t slot=get_current_slot();
+	const int64_t begin=m_chunk_indptr[slot][m_vector_in_chunk];
+	const int32_t num_entries=m_chunk_indptr[slot][m_vector_in_chunk+1]-begin;
+
+	if (len<num_entries)
+		vector=SG_REALLOC(SGSparseVectorEntry<T>, vector, len, num_entries);
+
+	for (int32_t i=0; i<num_entries; i++)
+	{
+		vector[i].feat_index=m_chunk_indices[slot][begin+i];
+		vector[i].entry=m_chunk_data[slot][begin+i];
+	}
+	len=num_entries;
+}
+
+template<class T>
+void CStreamingProtobufFile<T>::get_sparse_vector_and_label(
+		SGSparseVectorEntry<T>*& vector, int32_t& len, float64_t& label)
+{
+	get_sparse_vector(vector, len);
+	if (len>=0)
+		label=get_label();
+}
+
+template class CStreamingProtobufFile<bool>;
+template class CStreamingProtobufFile<char>;
+template class CStreamingProtobufFile<int8_t>;
+template class CStreamingProtobufFile<uint8_t>;
+template class CStreamingProtobufFile<int16_t>;
+template class CStreamingProtobufFile<uint16_t>;
+template class CStreamingProtobufFile<int32_t>;
+template class CStreamingProtobufFile<uint32_t>;
+template class CStreamingProtobufFile<int64_t>;
+template class CStreamingProtobufFile<uint64_t>;
+template class CStreamingProtobufFile<float32_t>;
+template class CStreamingProtobufFile<float64_t>;
+template class CStreamingProtobufFile<floatmax_t>;
+}
+#endif // HAVE_PROTOBUF
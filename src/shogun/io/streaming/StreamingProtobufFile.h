@@ -0,0 +1,202 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+#ifndef __STREAMING_PROTOBUF_FILE_H__
+#define __STREAMING_PROTOBUF_FILE_H__
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_PROTOBUF
+#include <shogun/lib/SGVector.h>
+#include <shogun/io/ProtobufFile.h>
+#include <shogun/io/streaming/StreamingChunkedFile.h>
+
+namespace shogun
+{
+/** @brief Streaming access to dense or sparse matrices in protobuf files,
+ * for use with CStreamingDenseFeatures and CStreamingSparseFeatures.
+ *
+ * Reads matrices written by CProtobufFile::set_matrix or
+ * CProtobufFile::set_sparse_matrix without loading them into memory. Each
+ * chunk message of the file (one message, or a pair of index and entry
+ * messages for sparse matrices) is decoded into the vectors completed by
+ * it, while the next message is read ahead (see CStreamingChunkedFile).
+ * Vectors may span several messages.
+ *
+ * Labels are read from a second protobuf file holding a vector of
+ * num_vectors values, as written by CProtobufFile::set_vector.
+ */
+template <class T> class CStreamingProtobufFile: public CStreamingChunkedFile
+{
+public:
+	/** default constructor */
+	CStreamingProtobufFile();
+
+	/** constructor
+	 *
+	 * @param fname name of protobuf file with the matrix
+	 * @param label_fname name of protobuf file with the labels,
+	 * NULL if not labelled
+	 */
+	CStreamingProtobufFile(const char* fname, const char* label_fname=NULL);
+
+	/** destructor */
+	virtual ~CStreamingProtobufFile();
+
+	/** read next dense vector
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len length of vector, -1 at the end of the file
+	 */
+	virtual void get_vector(T*& vector, int32_t& len);
+
+	/** read next dense vector and its label
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len length of vector, -1 at the end of the file
+	 * @param label label
+	 */
+	virtual void get_vector_and_label(T*& vector, int32_t& len,
+			float64_t& label);
+
+	/** read next sparse vector
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len number of entries, -1 at the end of the file
+	 */
+	virtual void get_sparse_vector(SGSparseVectorEntry<T>*& vector,
+			int32_t& len);
+
+	/** read next sparse vector and its label
+	 *
+	 * @param vector vector, reallocated if shorter than the vector read
+	 * @param len number of entries, -1 at the end of the file
+	 * @param label label
+	 */
+	virtual void get_sparse_vector_and_label(SGSparseVectorEntry<T>*& vector,
+			int32_t& len, float64_t& label);
+
+	/** @return number of vectors in the file */
+	int32_t get_num_vectors() const { return m_num_vectors; }
+
+	/** @return number of features */
+	int32_t get_num_features() const { return m_num_features; }
+
+	/** @return whether the file holds sparse vectors */
+	bool is_sparse() const { return m_is_sparse; }
+
+	/** @return object name */
+	virtual const char* get_name() const { return "StreamingProtobufFile"; }
+
+protected:
+	/** reads chunk messages until at least one vector is complete
+	 *
+	 * @param slot buffer slot
+	 * @return false at the end of the file
+	 */
+	virtual bool read_chunk(int32_t slot);
+
+private:
+	/** init */
+	void init();
+
+	/** reads one data chunk message and appends its elements to buffer,
+	 * which is enlarged if needed
+	 *
+	 * @param buffer buffer
+	 * @param offset number of elements already in buffer
+	 * @return number of elements appended
+	 */
+	int32_t read_data_message(SGVector<T>& buffer, int32_t offset);
+
+	/** reads one feature index chunk message and appends its elements to
+	 * buffer, which is enlarged if needed
+	 *
+	 * @param buffer buffer
+	 * @param offset number of elements already in buffer
+	 * @return number of elements appended
+	 */
+	int32_t read_index_message(SGVector<index_t>& buffer, int32_t offset);
+
+	/** @return number of elements of vector i */
+	int32_t get_vector_length(int32_t i) const;
+
+	/** reads the labels of the next num vectors into slot */
+	void read_labels(int32_t slot, int32_t num);
+
+	/** moves to the next vector, reading the next chunk if needed
+	 *
+	 * @return false at the end of the file
+	 */
+	bool next_vector();
+
+	/** @return label of the current vector */
+	float64_t get_label();
+
+protected:
+	/** file with the matrix */
+	CProtobufFile* m_file;
+
+	/** file with the labels */
+	CProtobufFile* m_label_file;
+
+	/** whether vectors are sparse */
+	bool m_is_sparse;
+
+	/** number of features */
+	int32_t m_num_features;
+
+	/** number of vectors */
+	int32_t m_num_vectors;
+
+	/** number of entries of each sparse vector */
+	SGVector<int32_t> m_num_feat_entries;
+
+	/** number of elements not read from the file yet */
+	int64_t m_elements_left;
+
+	/** first vector not decoded yet */
+	int32_t m_next_vector;
+
+	/** elements of an incomplete vector at the end of the last message */
+	SGVector<T> m_pending_data;
+
+	/** feature indices of an incomplete sparse vector */
+	SGVector<index_t> m_pending_indices;
+
+	/** number of pending elements */
+	int32_t m_num_pending;
+
+	/** labels read from the label file but not assigned to vectors yet */
+	SGVector<float64_t> m_label_buffer;
+
+	/** next label in the label buffer */
+	int32_t m_label_pos;
+
+	/** number of labels in the label buffer */
+	int32_t m_label_buffer_len;
+
+	/** current vector within the current chunk */
+	int32_t m_vector_in_chunk;
+
+	/** number of vectors of the chunks */
+	int32_t m_chunk_num_vectors[2];
+
+	/** entries of the chunks */
+	SGVector<T> m_chunk_data[2];
+
+	/** feature indices of the sparse chunks */
+	SGVector<index_t> m_chunk_indices[2];
+
+	/** offsets of the vectors of the chunks */
+	SGVector<int64_t> m_chunk_indptr[2];
+
+	/** labels of the chunks */
+	SGVector<float64_t> m_chunk_labels[2];
+};
+}
+#endif // HAVE_PROTOBUF
+#endif //__STREAMING_PROTOBUF_FILE_H__
@@ -65,6 +65,9 @@ void CStreamingVwCacheFile::set_env(CVwEnvironment* env_to_use)
 	case C_NATIVE:
 		cache_reader = new CVwNativeCacheReader(buf->working_file, env);
 		return;
+	case C_MMAP:
+		cache_reader = new CVwMmapCacheReader(buf->working_file, env);
+		return;
 	case C_PROTOBUF:
 		SG_ERROR("Protocol buffers cache support is not implemented yet!\n")
 	}
@@ -79,6 +82,8 @@ void CStreamingVwCacheFile::reset_stream()
 	// Recheck the cache so the parser can directly proceed with the examples
 	if (cache_format == C_NATIVE)
 		((CVwNativeCacheReader*) cache_reader)->check_cache_metadata();
+	else if (cache_format == C_MMAP)
+		((CVwMmapCacheReader*) cache_reader)->check_cache_metadata();
 }
 
 void CStreamingVwCacheFile::init(EVwCacheType cache_type)
@@ -94,6 +99,12 @@ void CStreamingVwCacheFile::init(EVwCacheType cache_type)
 		else
 			cache_reader=NULL;
 		return;
+	case C_MMAP:
+		if (buf)
+			cache_reader = new CVwMmapCacheReader(buf->working_file, env);
+		else
+			cache_reader=NULL;
+		return;
 	case C_PROTOBUF:
 		SG_ERROR("Protocol buffers cache support is not implemented yet!\n")
 	}
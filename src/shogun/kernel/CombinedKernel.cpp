@@ -17,6 +17,7 @@
 #include <shogun/kernel/Kernel.h>
 #include <shogun/kernel/CombinedKernel.h>
 #include <shogun/kernel/CustomKernel.h>
+#include <shogun/kernel/GaussianKernel.h>
 #include <shogun/features/CombinedFeatures.h>
 #include <string.h>
 
@@ -24,6 +25,10 @@
 #include <pthread.h>
 #endif
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 using namespace shogun;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -58,6 +63,7 @@ CCombinedKernel::~CCombinedKernel()
 	subkernel_weights_buffer=NULL;
 
 	cleanup();
+	clear_fused_order();
 	SG_UNREF(kernel_array);
 
 	SG_INFO("Combined kernel deleted (%p).\n", this)
@@ -165,6 +171,7 @@ bool CCombinedKernel::init(CFeatures* l, CFeatures* r)
 		SG_ERROR("CombinedKernel: Number of features/kernels does not match - bailing out\n")
 
 	init_normalizer();
+	init_fused_order();
 	initialized=true;
 	return true;
 }
@@ -172,6 +179,7 @@ bool CCombinedKernel::init(CFeatures* l, CFeatures* r)
 void CCombinedKernel::remove_lhs()
 {
 	delete_optimization();
+	clear_fused_order();
 
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -189,6 +197,7 @@ void CCombinedKernel::remove_lhs()
 void CCombinedKernel::remove_rhs()
 {
 	delete_optimization();
+	clear_fused_order();
 
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -206,6 +215,7 @@ void CCombinedKernel::remove_rhs()
 void CCombinedKernel::remove_lhs_and_rhs()
 {
 	delete_optimization();
+	clear_fused_order();
 
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -232,6 +242,7 @@ void CCombinedKernel::cleanup()
 	}
 
 	delete_optimization();
+	clear_fused_order();
 
 	CKernel::cleanup();
 
@@ -255,6 +266,9 @@ void CCombinedKernel::list_kernels()
 
 float64_t CCombinedKernel::compute(int32_t x, int32_t y)
 {
+	if (fused_kernels)
+		return compute_fused(x, y, NULL, NULL);
+
 	float64_t result=0;
 	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
 	{
@@ -267,6 +281,232 @@ float64_t CCombinedKernel::compute(int32_t x, int32_t y)
 	return result;
 }
 
+float64_t CCombinedKernel::compute_fused(int32_t x, int32_t y,
+		float64_t* values, const bool* mask)
+{
+	ASSERT(fused_kernels)
+
+	float64_t result=0;
+	float64_t sq_dist=0;
+	int32_t current_group=-1;
+
+	for (index_t i=0; i<fused_order.vlen; i++)
+	{
+		index_t k_idx=fused_order[i];
+		CKernel* k=fused_kernels[i];
+		float64_t w=k->get_combined_kernel_weight();
+
+		if (mask && !mask[k_idx])
+		{
+			if (values)
+				values[k_idx]=0;
+			continue;
+		}
+
+		if (w==0 && !values)
+			continue;
+
+		float64_t value;
+		if (fused_group[i]>=0)
+		{
+			CGaussianKernel* g=(CGaussianKernel*) k;
+
+			// kernels of a group are consecutive in the fused order
+			if (fused_group[i]!=current_group)
+			{
+				sq_dist=g->compute_squared_distance(x, y);
+				current_group=fused_group[i];
+			}
+			value=g->kernel_from_squared_distance(sq_dist, x, y);
+		}
+		else
+			value=k->kernel(x, y);
+
+		if (values)
+			values[k_idx]=value;
+		result+=w*value;
+	}
+
+	return result;
+}
+
+void CCombinedKernel::init_fused_order()
+{
+	clear_fused_order();
+
+	int32_t num_kernels=get_num_kernels();
+	if (num_kernels==0)
+		return;
+
+	CKernel** kernels=SG_MALLOC(CKernel*, num_kernels);
+	CFeatures** lhs_feat=SG_MALLOC(CFeatures*, num_kernels);
+	CFeatures** rhs_feat=SG_MALLOC(CFeatures*, num_kernels);
+	bool* placed=SG_CALLOC(bool, num_kernels);
+
+	for (index_t k_idx=0; k_idx<num_kernels; k_idx++)
+	{
+		CKernel* k=get_kernel(k_idx);
+		kernels[k_idx]=k;
+		lhs_feat[k_idx]=NULL;
+		rhs_feat[k_idx]=NULL;
+
+		if (k->get_kernel_type()==K_GAUSSIAN &&
+				dynamic_cast<CGaussianKernel*>(k) && k->has_features())
+		{
+			lhs_feat[k_idx]=k->get_lhs();
+			rhs_feat[k_idx]=k->get_rhs();
+			// features are kept alive by the kernel itself
+			SG_UNREF(lhs_feat[k_idx]);
+			SG_UNREF(rhs_feat[k_idx]);
+		}
+		SG_UNREF(k);
+	}
+
+	fused_order=SGVector<int32_t>(num_kernels);
+	fused_group=SGVector<int32_t>(num_kernels);
+	fused_kernels=SG_MALLOC(CKernel*, num_kernels);
+
+	int32_t pos=0;
+	int32_t num_groups=0;
+	for (index_t k_idx=0; k_idx<num_kernels; k_idx++)
+	{
+		if (placed[k_idx])
+			continue;
+
+		int32_t group=-1;
+		if (lhs_feat[k_idx])
+		{
+			for (index_t j=k_idx+1; j<num_kernels; j++)
+			{
+				if (lhs_feat[j]==lhs_feat[k_idx] && rhs_feat[j]==rhs_feat[k_idx])
+				{
+					group=num_groups;
+					break;
+				}
+			}
+		}
+
+		fused_order[pos]=k_idx;
+		fused_group[pos]=group;
+		fused_kernels[pos]=kernels[k_idx];
+		placed[k_idx]=true;
+		pos++;
+
+		if (group<0)
+			continue;
+
+		for (index_t j=k_idx+1; j<num_kernels; j++)
+		{
+			if (!placed[j] && lhs_feat[j]==lhs_feat[k_idx] &&
+					rhs_feat[j]==rhs_feat[k_idx])
+			{
+				fused_order[pos]=j;
+				fused_group[pos]=group;
+				fused_kernels[pos]=kernels[j];
+				placed[j]=true;
+				pos++;
+			}
+		}
+		num_groups++;
+	}
+	ASSERT(pos==num_kernels)
+
+	if (num_groups)
+		SG_DEBUG("%d groups of gaussian kernels share distance computations\n", num_groups)
+
+	SG_FREE(placed);
+	SG_FREE(rhs_feat);
+	SG_FREE(lhs_feat);
+	SG_FREE(kernels);
+}
+
+void CCombinedKernel::clear_fused_order()
+{
+	SG_FREE(fused_kernels);
+	fused_kernels=NULL;
+	fused_order=SGVector<int32_t>();
+	fused_group=SGVector<int32_t>();
+}
+
+void CCombinedKernel::compute_subkernel_rows(int32_t idx_a, int32_t num,
+		int32_t* idx_b, float64_t* block)
+{
+	ASSERT(block)
+	ASSERT(idx_b || num==0)
+
+	int32_t num_kernels=get_num_kernels();
+
+	if (fused_kernels)
+	{
+		for (int32_t j=0; j<num; j++)
+			compute_fused(idx_a, idx_b[j], &block[int64_t(j)*num_kernels], NULL);
+	}
+	else
+	{
+		for (index_t k_idx=0; k_idx<num_kernels; k_idx++)
+		{
+			CKernel* k=get_kernel(k_idx);
+			for (int32_t j=0; j<num; j++)
+				block[int64_t(j)*num_kernels+k_idx]=k->kernel(idx_a, idx_b[j]);
+			SG_UNREF(k);
+		}
+	}
+}
+
+SGVector<float64_t> CCombinedKernel::compute_subkernel_quadratic_forms(
+		int32_t num, int32_t* idx, float64_t* alpha)
+{
+	ASSERT(idx || num==0)
+	ASSERT(alpha || num==0)
+
+	int32_t num_kernels=get_num_kernels();
+	SGVector<float64_t> result(num_kernels);
+	result.zero();
+
+	if (num==0 || num_kernels==0)
+		return result;
+
+	int32_t num_threads=CMath::min(parallel->get_num_threads(), num);
+	ASSERT(num_threads>0)
+
+	float64_t* sums=SG_CALLOC(float64_t, int64_t(num_threads)*num_kernels);
+
+	#pragma omp parallel num_threads(num_threads)
+	{
+		int32_t t=0;
+#ifdef _OPENMP
+		t=omp_get_thread_num();
+#endif
+		float64_t* block=SG_MALLOC(float64_t, int64_t(num)*num_kernels);
+		float64_t* sum=&sums[int64_t(t)*num_kernels];
+
+		#pragma omp for schedule(dynamic, 1)
+		for (int32_t i=0; i<num; i++)
+		{
+			compute_subkernel_rows(idx[i], num, idx, block);
+
+			for (int32_t j=0; j<num; j++)
+			{
+				float64_t a=alpha[i]*alpha[j];
+				float64_t* b=&block[int64_t(j)*num_kernels];
+				for (int32_t k=0; k<num_kernels; k++)
+					sum[k]+=a*b[k];
+			}
+		}
+
+		SG_FREE(block);
+	}
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		for (int32_t k=0; k<num_kernels; k++)
+			result[k]+=sums[int64_t(t)*num_kernels+k];
+	}
+	SG_FREE(sums);
+
+	return result;
+}
+
 bool CCombinedKernel::init_optimization(
 	int32_t count, int32_t *IDX, float64_t *weights)
 {
@@ -353,8 +593,41 @@ void CCombinedKernel::compute_batch(
 	//make sure we start cleanly
 	delete_optimization();
 
-	for (index_t k_idx=0; k_idx<get_num_kernels(); k_idx++)
+	/* kernels that are neither batch evaluated nor optimized are all
+	 * computed in one pass, sharing the work on common features */
+	int32_t num_kernels=get_num_kernels();
+	bool* fused=SG_CALLOC(bool, num_kernels);
+	int32_t num_fused=0;
+
+	if (fused_kernels)
 	{
+		for (index_t k_idx=0; k_idx<num_kernels; k_idx++)
+		{
+			CKernel* k = get_kernel(k_idx);
+			if (!k->has_property(KP_BATCHEVALUATION) &&
+					!k->has_property(KP_LINADD) &&
+					k->get_combined_kernel_weight()!=0)
+			{
+				fused[k_idx]=true;
+				num_fused++;
+			}
+			SG_UNREF(k);
+		}
+
+		if (num_fused>1)
+			fused_compute_batch(num_vec, vec_idx, result, num_suppvec, IDX, weights, fused);
+		else
+		{
+			memset(fused, 0, sizeof(bool)*num_kernels);
+			num_fused=0;
+		}
+	}
+
+	for (index_t k_idx=0; k_idx<num_kernels; k_idx++)
+	{
+		if (fused[k_idx])
+			continue;
+
 		CKernel* k = get_kernel(k_idx);
 		if (k && k->has_property(KP_BATCHEVALUATION))
 		{
@@ -366,11 +639,30 @@ void CCombinedKernel::compute_batch(
 
 		SG_UNREF(k);
 	}
+	SG_FREE(fused);
 
 	//clean up
 	delete_optimization();
 }
 
+void CCombinedKernel::fused_compute_batch(int32_t num_vec, int32_t* vec_idx,
+		float64_t* result, int32_t num_suppvec, int32_t* IDX,
+		float64_t* weights, const bool* mask)
+{
+	ASSERT(IDX!=NULL || num_suppvec==0)
+	ASSERT(weights!=NULL || num_suppvec==0)
+
+	#pragma omp parallel for num_threads(parallel->get_num_threads()) schedule(dynamic, 16)
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		float64_t sub_result=0;
+		for (int32_t j=0; j<num_suppvec; j++)
+			sub_result += weights[j] * compute_fused(IDX[j], vec_idx[i], NULL, mask);
+
+		result[i] += sub_result;
+	}
+}
+
 void* CCombinedKernel::compute_optimized_kernel_helper(void* p)
 {
 	S_THREAD_PARAM_COMBINED_KERNEL* params= (S_THREAD_PARAM_COMBINED_KERNEL*) p;
@@ -764,6 +1056,7 @@ void CCombinedKernel::init()
 	sv_weight=NULL;
 	subkernel_weights_buffer=NULL;
 	initialized=false;
+	fused_kernels=NULL;
 
 	properties |= KP_LINADD | KP_KERNCOMBINATION | KP_BATCHEVALUATION;
 	kernel_array=new CDynamicObjectArray();
@@ -149,6 +149,7 @@ class CCombinedKernel : public CKernel
 			if (!(k->has_property(KP_LINADD)))
 				unset_property(KP_LINADD);
 
+			clear_fused_order();
 			return kernel_array->insert_element(k, idx);
 		}
 
@@ -165,6 +166,7 @@ class CCombinedKernel : public CKernel
 			if (!(k->has_property(KP_LINADD)))
 				unset_property(KP_LINADD);
 
+			clear_fused_order();
 			int n = get_num_kernels();
 			kernel_array->push_back(k);
 			return n+1==get_num_kernels();
@@ -178,6 +180,7 @@ class CCombinedKernel : public CKernel
 		 */
 		inline bool delete_kernel(int32_t idx)
 		{
+			clear_fused_order();
 			bool succesful_deletion = kernel_array->delete_element(idx);
 
 			if (get_num_kernels()==0)
@@ -396,6 +399,38 @@ class CCombinedKernel : public CKernel
 		*/
 		static CList* combine_kernels(CList* kernel_list);
 
+		/** compute the values of all contained kernels between one vector
+		 * on the left-hand side and a number of vectors on the right-hand
+		 * side at once. Gaussian kernels of different widths that were
+		 * initialised on the same features share a single distance
+		 * computation per pair of vectors.
+		 *
+		 * The values are not multiplied by the combined kernel weights;
+		 * the normalizer of each kernel is applied, as in
+		 * CKernel::kernel(). Safe to be called from several threads.
+		 *
+		 * @param idx_a index of vector on left-hand side
+		 * @param num number of vectors on right-hand side
+		 * @param idx_b indices of vectors on right-hand side
+		 * @param block column-major num_kernels x num block receiving
+		 * the value of kernel k for idx_b[j] at block[j*num_kernels+k]
+		 */
+		void compute_subkernel_rows(int32_t idx_a, int32_t num,
+				int32_t* idx_b, float64_t* block);
+
+		/** compute alpha^T K_k alpha restricted to the vectors in idx for
+		 * all contained kernels k in one pass, parallelised over the rows
+		 * of the kernel matrices. This is the quantity required by MKL for
+		 * the update of the kernel weights.
+		 *
+		 * @param num number of vectors
+		 * @param idx indices of vectors (used for both lhs and rhs)
+		 * @param alpha coefficients of vectors
+		 * @return vector of length num_kernels with the quadratic forms
+		 */
+		SGVector<float64_t> compute_subkernel_quadratic_forms(int32_t num,
+				int32_t* idx, float64_t* alpha);
+
 	protected:
 		/** compute kernel function
 		 *
@@ -405,6 +440,45 @@ class CCombinedKernel : public CKernel
 		 */
 		virtual float64_t compute(int32_t x, int32_t y);
 
+		/** compute the kernel values of all contained kernels for vectors
+		 * x and y using the fused evaluation order
+		 *
+		 * @param x x
+		 * @param y y
+		 * @param values if not NULL, receives the (unweighted) value of
+		 * every kernel, also of kernels with zero weight
+		 * @param mask if not NULL, only kernels with mask set are computed
+		 * @return weighted sum of the computed kernel values
+		 */
+		float64_t compute_fused(int32_t x, int32_t y, float64_t* values,
+				const bool* mask);
+
+		/** determine the order in which compute_fused() visits the kernels:
+		 * gaussian kernels on the same lhs and rhs features are grouped so
+		 * that they can share the squared distance of two vectors
+		 */
+		void init_fused_order();
+
+		/** invalidate the fused evaluation order, eg. when kernels are
+		 * added or removed, until the next call to init()
+		 */
+		void clear_fused_order();
+
+		/** compute the contribution of the kernels in mask to compute_batch
+		 * in a single parallel pass
+		 *
+		 * @param num_vec number of vectors
+		 * @param vec_idx indices of vectors
+		 * @param result result is added to this array
+		 * @param num_suppvec number of support vectors
+		 * @param IDX support vector indices
+		 * @param weights support vector weights
+		 * @param mask kernels to be considered
+		 */
+		void fused_compute_batch(int32_t num_vec, int32_t* vec_idx,
+				float64_t* result, int32_t num_suppvec, int32_t* IDX,
+				float64_t* weights, const bool* mask);
+
 		/** adjust the variables num_lhs, num_rhs and initialized
 		 * based on the kernel to be appended/inserted
 		 *
@@ -467,6 +541,13 @@ class CCombinedKernel : public CKernel
 		bool append_subkernel_weights;
 		/** whether kernel is ready to be used */
 		bool initialized;
+		/** order in which compute_fused() visits the kernels */
+		SGVector<int32_t> fused_order;
+		/** for every position in fused_order, the group of kernels sharing
+		 * squared distances it belongs to, or -1 */
+		SGVector<int32_t> fused_group;
+		/** kernels in fused_order (not referenced, owned by kernel_array) */
+		CKernel** fused_kernels;
 };
 }
 #endif /* _COMBINEDKERNEL_H__ */
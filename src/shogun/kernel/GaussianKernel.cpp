@@ -105,19 +105,31 @@ bool CGaussianKernel::init(CFeatures* l, CFeatures* r)
 }
 
 float64_t CGaussianKernel::compute(int32_t idx_a, int32_t idx_b)
+{
+	return compute_from_squared_distance(compute_squared_distance(idx_a, idx_b));
+}
+
+float64_t CGaussianKernel::compute_squared_distance(int32_t idx_a, int32_t idx_b)
+{
+	return sq_lhs[idx_a]+sq_rhs[idx_b]-2*CDotKernel::compute(idx_a, idx_b);
+}
+
+float64_t CGaussianKernel::kernel_from_squared_distance(float64_t sq_dist,
+		int32_t idx_a, int32_t idx_b)
+{
+	return normalizer->normalize(compute_from_squared_distance(sq_dist),
+			idx_a, idx_b);
+}
+
+float64_t CGaussianKernel::compute_from_squared_distance(float64_t result)
 {
 	if (!m_compact)
-	{
-		float64_t result=sq_lhs[idx_a]+sq_rhs[idx_b]
-				-2*CDotKernel::compute(idx_a, idx_b);
 		return CMath::exp(-result/width);
-	}
 
 	int32_t len_features, power;
 	len_features=((CDenseFeatures<float64_t>*) lhs)->get_num_features();
 	power=(len_features%2==0) ? (len_features+1):len_features;
 
-	float64_t result=sq_lhs[idx_a]+sq_rhs[idx_b]-2*CDotKernel::compute(idx_a,idx_b);
 	float64_t result_multiplier=1-(sqrt(result/width))/3;
 
 	if (result_multiplier<=0)
@@ -134,6 +134,28 @@ class CGaussianKernel: public CDotKernel
 		virtual SGMatrix<float64_t> get_parameter_gradient(
 				const TParameter* param, index_t index=-1);
 
+		/** compute the squared distance between two feature vectors,
+		 * which is the only part of the kernel that touches the features
+		 *
+		 * @param idx_a index of vector on left-hand side
+		 * @param idx_b index of vector on right-hand side
+		 * @return squared distance of vectors a and b
+		 */
+		float64_t compute_squared_distance(int32_t idx_a, int32_t idx_b);
+
+		/** compute the (normalized) kernel value from a squared distance
+		 * obtained by compute_squared_distance(). This allows gaussian
+		 * kernels of different widths on the same features to share the
+		 * distance computation, see CCombinedKernel.
+		 *
+		 * @param sq_dist squared distance of vectors a and b
+		 * @param idx_a index of vector on left-hand side
+		 * @param idx_b index of vector on right-hand side
+		 * @return kernel value, as returned by kernel(idx_a, idx_b)
+		 */
+		float64_t kernel_from_squared_distance(float64_t sq_dist,
+				int32_t idx_a, int32_t idx_b);
+
 	protected:
 		/** compute kernel function for features a and b
 		 * idx_{a,b} denote the index of the feature vectors
@@ -153,6 +175,13 @@ class CGaussianKernel: public CDotKernel
 		 */
 		virtual void load_serializable_post() throw (ShogunException);
 
+		/** compute the unnormalized kernel value from a squared distance
+		 *
+		 * @param sq_dist squared distance of two vectors
+		 * @return kernel value
+		 */
+		float64_t compute_from_squared_distance(float64_t sq_dist);
+
 	private:
 		/** helper function to compute quadratic terms in
 		 * (a-b)^2 (== a^2+b^2-2ab)
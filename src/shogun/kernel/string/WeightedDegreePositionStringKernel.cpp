@@ -268,6 +268,13 @@ bool CWeightedDegreePositionStringKernel::init_optimization(
 	if (tree_num<0)
 		SG_DEBUG("initializing CWeightedDegreePositionStringKernel optimization\n")
 
+	if (tree_num<0 && !use_poim_tries && parallel->get_num_threads()>1)
+	{
+		add_examples_to_trees(p_count, IDX, alphas);
+		set_is_initialized(true);
+		return true;
+	}
+
 	for (int32_t i=0; i<p_count; i++)
 	{
 		if (tree_num<0)
@@ -746,6 +753,98 @@ void CWeightedDegreePositionStringKernel::add_example_to_single_tree(
 	tree_initialized=true ;
 }
 
+void CWeightedDegreePositionStringKernel::add_examples_to_trees(
+	int32_t count, int32_t* IDX, float64_t* alphas)
+{
+	ASSERT(position_weights_lhs==NULL)
+	ASSERT(position_weights_rhs==NULL)
+	ASSERT(alphabet)
+	ASSERT(alphabet->get_alphabet()==DNA || alphabet->get_alphabet()==RNA)
+	ASSERT(max_mismatch==0)
+
+	if (opt_type!=SLOWBUTMEMEFFICIENT && opt_type!=FASTBUTMEMHUNGRY)
+		SG_ERROR("unknown optimization type\n")
+	if (opt_type==FASTBUTMEMHUNGRY)
+		ASSERT(!tries.get_use_compact_terminal_nodes())
+
+	CStringFeatures<char>* lhs_feat=(CStringFeatures<char>*) lhs;
+	int32_t num_threads=CMath::max(1, CMath::min(parallel->get_num_threads(), seq_length));
+	int32_t window=(opt_type==FASTBUTMEMHUNGRY) ? max_shift : 0;
+
+	// every thread builds the trees of a range of positions. the shifted
+	// examples are added to each tree in the same order as by
+	// add_example_to_tree, i.e. first those shifted from the left, then
+	// those starting at the tree's position
+	CTrie<DNATrie>** thread_tries=SG_MALLOC(CTrie<DNATrie>*, num_threads);
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		thread_tries[t]=new CTrie<DNATrie>(degree);
+		SG_REF(thread_tries[t]);
+		thread_tries[t]->set_weights_in_tree(tries.get_weights_in_tree());
+		thread_tries[t]->create(seq_length, tries.get_use_compact_terminal_nodes());
+	}
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		CTrie<DNATrie>* trie=thread_tries[t];
+		int32_t begin=int64_t(t)*seq_length/num_threads;
+		int32_t end=int64_t(t+1)*seq_length/num_threads;
+		int32_t* vec=SG_MALLOC(int32_t, seq_length);
+
+		for (int32_t i=0; i<count; i++)
+		{
+			if (t==0 && (i % (count/10+1)) == 0)
+				SG_PROGRESS(i, 0, count)
+
+			int32_t len=0;
+			bool free_vec;
+			char* char_vec=lhs_feat->get_feature_vector(IDX[i], len, free_vec);
+			ASSERT(len<=seq_length)
+
+			for (int32_t k=CMath::max(0, begin-window);
+					k<CMath::min(len, end+window+degree); k++)
+			{
+				vec[k]=alphabet->remap_to_bin(char_vec[k]);
+			}
+			lhs_feat->free_feature_vector(char_vec, IDX[i], free_vec);
+
+			for (int32_t k=begin; k<CMath::min(len, end); k++)
+			{
+				for (int32_t j=CMath::max(0, k-window); j<k; j++)
+				{
+					int32_t s=k-j;
+					if (s>shift[j])
+						continue;
+
+					float64_t alpha_pw=normalizer->normalize_lhs(alphas[i]/(2.0*s), IDX[i]);
+					trie->add_to_trie(k, -s, vec, alpha_pw, weights, (length!=0));
+				}
+
+				int32_t max_s=(opt_type==FASTBUTMEMHUNGRY) ? shift[k] : 0;
+				for (int32_t s=max_s; s>=0; s--)
+				{
+					float64_t alpha_pw=normalizer->normalize_lhs((s==0) ? (alphas[i]) : (alphas[i]/(2.0*s)), IDX[i]);
+					trie->add_to_trie(k, s, vec, alpha_pw, weights, (length!=0));
+				}
+			}
+		}
+
+		SG_FREE(vec);
+	}
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		tries.copy_trees(*thread_tries[t], int64_t(t)*seq_length/num_threads,
+			int64_t(t+1)*seq_length/num_threads);
+		SG_UNREF(thread_tries[t]);
+	}
+	SG_FREE(thread_tries);
+
+	SG_DONE()
+	tree_initialized=true;
+}
+
 float64_t CWeightedDegreePositionStringKernel::compute_by_tree(int32_t idx)
 {
 	ASSERT(position_weights_lhs==NULL)
@@ -619,6 +619,19 @@ class CWeightedDegreePositionStringKernel: public CStringKernel<char>
 		void add_example_to_single_tree(
 			int32_t idx, float64_t weight, int32_t tree_num);
 
+		/** add examples to all trees in parallel
+		 *
+		 * Each thread builds the trees of a range of positions in a trie of
+		 * its own, which are then copied into tries. The result is the
+		 * same as adding the examples one after another.
+		 *
+		 * @param count number of examples
+		 * @param IDX indices of examples
+		 * @param weights weights of examples
+		 */
+		void add_examples_to_trees(
+			int32_t count, int32_t* IDX, float64_t* weights);
+
 		/** compute kernel function for features a and b
 		 * idx_{a,b} denote the index of the feature vectors
 		 * in the corresponding feature object
@@ -213,6 +213,13 @@ bool CWeightedDegreeStringKernel::init_optimization(int32_t count, int32_t* IDX,
 	if (tree_num<0)
 		SG_DEBUG("initializing CWeightedDegreeStringKernel optimization\n")
 
+	if (tree_num<0 && parallel->get_num_threads()>1)
+	{
+		add_examples_to_trees(count, IDX, alphas);
+		set_is_initialized(true);
+		return true;
+	}
+
 	for (int32_t i=0; i<count; i++)
 	{
 		if (tree_num<0)
@@ -511,6 +518,80 @@ void CWeightedDegreeStringKernel::add_example_to_single_tree_mismatch(
 }
 
 
+void CWeightedDegreeStringKernel::add_examples_to_trees(
+	int32_t count, int32_t* IDX, float64_t* alphas)
+{
+	ASSERT(tries)
+	ASSERT(alphabet)
+	ASSERT(alphabet->get_alphabet()==DNA || alphabet->get_alphabet()==RNA)
+
+	CStringFeatures<char>* lhs_feat=(CStringFeatures<char>*) lhs;
+	int32_t num_threads=CMath::max(1, CMath::min(parallel->get_num_threads(), seq_length));
+
+	// every thread builds the trees of a range of positions, all examples
+	// are added to them in the same order as by add_example_to_tree
+	CTrie<DNATrie>** thread_tries=SG_MALLOC(CTrie<DNATrie>*, num_threads);
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		thread_tries[t]=new CTrie<DNATrie>(degree);
+		SG_REF(thread_tries[t]);
+		thread_tries[t]->set_weights_in_tree(tries->get_weights_in_tree());
+		thread_tries[t]->create(seq_length, tries->get_use_compact_terminal_nodes());
+	}
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		CTrie<DNATrie>* trie=thread_tries[t];
+		int32_t begin=int64_t(t)*seq_length/num_threads;
+		int32_t end=int64_t(t+1)*seq_length/num_threads;
+		int32_t* vec=SG_MALLOC(int32_t, seq_length);
+
+		for (int32_t i=0; i<count; i++)
+		{
+			if (t==0 && (i % (count/10+1)) == 0)
+				SG_PROGRESS(i, 0, count)
+
+			if (alphas[i]==0.0)
+				continue;
+
+			int32_t len=0;
+			bool free_vec;
+			char* char_vec=lhs_feat->get_feature_vector(IDX[i], len, free_vec);
+			ASSERT(len<=seq_length)
+
+			for (int32_t k=begin; k<CMath::min(len, end+degree); k++)
+				vec[k]=alphabet->remap_to_bin(char_vec[k]);
+			lhs_feat->free_feature_vector(char_vec, IDX[i], free_vec);
+
+			float64_t alpha=normalizer->normalize_lhs(alphas[i], IDX[i]);
+			for (int32_t k=begin; k<CMath::min(len, end); k++)
+			{
+				if (max_mismatch==0)
+					trie->add_to_trie(k, 0, vec, alpha, weights, (length!=0));
+				else
+				{
+					trie->add_example_to_tree_mismatch_recursion(NO_CHILD, k,
+						alpha, &vec[k], len-k, 0, 0, max_mismatch, weights);
+				}
+			}
+		}
+
+		SG_FREE(vec);
+	}
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		tries->copy_trees(*thread_tries[t], int64_t(t)*seq_length/num_threads,
+			int64_t(t+1)*seq_length/num_threads);
+		SG_UNREF(thread_tries[t]);
+	}
+	SG_FREE(thread_tries);
+
+	SG_DONE()
+	tree_initialized=true;
+}
+
 float64_t CWeightedDegreeStringKernel::compute_by_tree(int32_t idx)
 {
 	ASSERT(alphabet)
@@ -638,6 +638,19 @@ class CWeightedDegreeStringKernel: public CStringKernel<char>
 		void add_example_to_single_tree_mismatch(
 			int32_t idx, float64_t weight, int32_t tree_num);
 
+		/** add examples to all trees in parallel
+		 *
+		 * Each thread builds the trees of a range of positions in a trie of
+		 * its own, which are then copied into tries. The result is the
+		 * same as adding the examples one after another.
+		 *
+		 * @param count number of examples
+		 * @param IDX indices of examples
+		 * @param weights weights of examples
+		 */
+		void add_examples_to_trees(
+			int32_t count, int32_t* IDX, float64_t* weights);
+
 		/** compute by tree
 		 *
 		 * @param idx index
@@ -0,0 +1,830 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/Allocator.h>
+#include <shogun/lib/ShogunException.h>
+#include <shogun/io/SGIO.h>
+#include <shogun/lib/memory.h>
+#include <shogun/mathematics/Math.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#ifdef HAVE_CXX11
+#define SG_THREAD_LOCAL thread_local
+#else
+#define SG_THREAD_LOCAL __thread
+#endif
+
+using namespace shogun;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/** header in front of each block of a SGPoolAllocator */
+struct block_header
+{
+	/** requested size */
+	uint64_t size;
+	/** distance of the header to the start of the malloc'ed memory */
+	uint16_t offset;
+	/** size class or NOT_POOLED */
+	uint8_t size_class;
+	/** index of the charged counter */
+	uint8_t counter;
+	/** BLOCK_MAGIC */
+	uint32_t magic;
+};
+
+/** blocks of a thread */
+struct SGPoolAllocator::ThreadCache
+{
+	/** id of the allocator the blocks belong to */
+	uint64_t owner_id;
+	/** free lists */
+	FreeList lists[MAX_CLASSES];
+};
+
+#ifdef HAVE_CXX11_ATOMIC
+typedef std::atomic<void*> atomic_ptr;
+
+static inline void* atomic_load(const atomic_ptr& p)
+{
+	return p.load(std::memory_order_acquire);
+}
+
+static inline void atomic_store(atomic_ptr& p, void* x)
+{
+	p.store(x, std::memory_order_release);
+}
+#else
+typedef void* volatile atomic_ptr;
+
+static inline void* atomic_load(const atomic_ptr& p)
+{
+	void* x=p;
+	__sync_synchronize();
+	return x;
+}
+
+static inline void atomic_store(atomic_ptr& p, void* x)
+{
+	__sync_synchronize();
+	p=x;
+}
+#endif
+
+/* the region map covers 48 bit addresses in regions of 64KB, with a root
+ * of 2^16 leaves of 2^16 regions each */
+#define REGION_BITS 16
+#define REGION_SIZE (size_t(1)<<REGION_BITS)
+#define LEAF_BITS 16
+#define ROOT_BITS 16
+
+/** map of the regions of slabs and large blocks */
+struct SGPoolAllocator::RegionMap
+{
+	/** leaves (arrays of 2^LEAF_BITS atomic_ptr), created on demand */
+	atomic_ptr root[size_t(1)<<ROOT_BITS];
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#define BLOCK_MAGIC 0x53474d42
+#define NOT_POOLED 255
+/* value of slab regions in the region map, large blocks store their
+ * address */
+#define SLAB_REGION ((void*) 1)
+#define HEADER_SIZE sizeof(block_header)
+/* blocks moved between a thread and the depot at once */
+#define POOL_BATCH 32
+#define MAX_LIVE_ALLOCATORS 64
+
+#define get_header(ptr) ((block_header*) (ptr)-1)
+
+/* next free block, stored behind the header of a free block */
+#define next_free(block) (*(void**) ((char*) (block)+HEADER_SIZE))
+
+static SG_THREAD_LOCAL SGPoolAllocator::ThreadCache* thread_cache=NULL;
+static SG_THREAD_LOCAL uint8_t current_counter=0;
+
+/* pool allocators alive and registered counters */
+static CLock registry_lock;
+static SGPoolAllocator* live_allocators[MAX_LIVE_ALLOCATORS];
+static uint64_t live_ids[MAX_LIVE_ALLOCATORS];
+static uint64_t next_allocator_id=1;
+static SGMemoryCounter* counters[256];
+
+#ifdef HAVE_PTHREAD
+static pthread_key_t thread_cache_key;
+static pthread_once_t thread_cache_key_once=PTHREAD_ONCE_INIT;
+#endif
+
+#ifdef HAVE_CXX11_ATOMIC
+static inline int64_t atomic_add(std::atomic<int64_t>& value, int64_t delta)
+{
+	return value.fetch_add(delta, std::memory_order_relaxed)+delta;
+}
+
+static inline int64_t atomic_get(const std::atomic<int64_t>& value)
+{
+	return value.load(std::memory_order_relaxed);
+}
+
+static inline void atomic_set(std::atomic<int64_t>& value, int64_t x)
+{
+	value.store(x, std::memory_order_relaxed);
+}
+
+static inline void atomic_max(std::atomic<int64_t>& value, int64_t x)
+{
+	int64_t old=value.load(std::memory_order_relaxed);
+	while (old<x && !value.compare_exchange_weak(old, x, std::memory_order_relaxed));
+}
+#else
+static inline int64_t atomic_add(volatile int64_t& value, int64_t delta)
+{
+	return __sync_add_and_fetch(&value, delta);
+}
+
+static inline int64_t atomic_get(const volatile int64_t& value)
+{
+	return value;
+}
+
+static inline void atomic_set(volatile int64_t& value, int64_t x)
+{
+	value=x;
+}
+
+static inline void atomic_max(volatile int64_t& value, int64_t x)
+{
+	int64_t old=value;
+	while (old<x)
+	{
+		int64_t previous=__sync_val_compare_and_swap(&value, old, x);
+		if (previous==old)
+			break;
+		old=previous;
+	}
+}
+#endif
+
+static inline size_t align_up(size_t x, size_t alignment)
+{
+	return (x+alignment-1) & ~(alignment-1);
+}
+
+SGPoolAllocator::SGPoolAllocator(size_t max_pooled_size)
+: SGAllocator(), num_classes(0), max_pooled(0), slab_size(REGION_SIZE),
+	num_slabs(0), slabs(NULL), num_blocks(0)
+{
+	region_map=(RegionMap*) calloc(1, sizeof(RegionMap));
+	if (!region_map)
+		throw ShogunException("Out of memory error, allocating region map of PoolAllocator.\n");
+
+	/* sizes grow by a quarter of the last power of two, so at most 20% of a
+	 * block are lost to rounding */
+	size_t total=2*HEADER_SIZE;
+	while (max_pooled_size>0 && total<=max_pooled_size+HEADER_SIZE &&
+			num_classes<MAX_CLASSES && total<=slab_size/4)
+	{
+		class_size[num_classes++]=total;
+		size_t power=1;
+		while (2*power<=total)
+			power*=2;
+		total+=CMath::max(size_t(HEADER_SIZE), power/4);
+	}
+	if (num_classes>0)
+		max_pooled=class_size[num_classes-1];
+
+	memset(depot, 0, sizeof(depot));
+
+	registry_lock.lock();
+	id=next_allocator_id++;
+	for (int32_t i=0; i<MAX_LIVE_ALLOCATORS; i++)
+	{
+		if (!live_allocators[i])
+		{
+			live_allocators[i]=this;
+			live_ids[i]=id;
+			break;
+		}
+	}
+	registry_lock.unlock();
+}
+
+SGPoolAllocator::~SGPoolAllocator()
+{
+	registry_lock.lock();
+	for (int32_t i=0; i<MAX_LIVE_ALLOCATORS; i++)
+	{
+		if (live_allocators[i]==this)
+		{
+			live_allocators[i]=NULL;
+			live_ids[i]=0;
+		}
+	}
+	registry_lock.unlock();
+
+	int64_t blocks_in_use=get_num_blocks();
+	if (get_global_allocator()==this)
+	{
+		if (blocks_in_use>0)
+		{
+			/* the blocks would be passed to free() after uninstalling */
+			fprintf(stderr, "%s destroyed while installed with %lld blocks in use\n",
+				get_name(), (long long int) blocks_in_use);
+			abort();
+		}
+		set_global_allocator(NULL);
+	}
+
+	if (blocks_in_use>0)
+	{
+		/* slabs and large blocks in use are kept */
+		SG_SWARNING("%s destroyed with %lld blocks in use, their memory is not released\n",
+			get_name(), (long long int) blocks_in_use);
+	}
+	else
+	{
+		/* blocks cached by threads are dropped when the threads notice the
+		 * allocator is gone */
+		while (slabs)
+		{
+			void* next=*(void**) slabs;
+			free(slabs);
+			slabs=next;
+		}
+	}
+
+	for (size_t i=0; i<(size_t(1)<<ROOT_BITS); i++)
+		free(atomic_load(region_map->root[i]));
+	free(region_map);
+}
+
+void* SGPoolAllocator::get_region(const void* ptr) const
+{
+	size_t address=(size_t) ptr;
+	if (address>>(REGION_BITS+LEAF_BITS+ROOT_BITS))
+		return NULL;
+
+	atomic_ptr* leaf=(atomic_ptr*) atomic_load(
+		region_map->root[address>>(REGION_BITS+LEAF_BITS)]);
+	if (!leaf)
+		return NULL;
+
+	return atomic_load(leaf[(address>>REGION_BITS) & ((size_t(1)<<LEAF_BITS)-1)]);
+}
+
+bool SGPoolAllocator::set_region(const void* start, void* value)
+{
+	size_t address=(size_t) start;
+	if (address>>(REGION_BITS+LEAF_BITS+ROOT_BITS))
+		return false;
+
+	atomic_ptr& root=region_map->root[address>>(REGION_BITS+LEAF_BITS)];
+	atomic_ptr* leaf=(atomic_ptr*) atomic_load(root);
+	if (!leaf)
+	{
+		if (!value)
+			return true;
+
+		leaf=(atomic_ptr*) calloc(size_t(1)<<LEAF_BITS, sizeof(atomic_ptr));
+		if (!leaf)
+			return false;
+		atomic_store(root, leaf);
+	}
+
+	atomic_store(leaf[(address>>REGION_BITS) & ((size_t(1)<<LEAF_BITS)-1)], value);
+	return true;
+}
+
+int32_t SGPoolAllocator::get_size_class(size_t total_size) const
+{
+	if (total_size>max_pooled)
+		return -1;
+
+	int32_t low=0;
+	int32_t high=num_classes-1;
+	while (low<high)
+	{
+		int32_t middle=(low+high)/2;
+		if (class_size[middle]<total_size)
+			low=middle+1;
+		else
+			high=middle;
+	}
+
+	return low;
+}
+
+uint8_t SGPoolAllocator::charge(size_t size)
+{
+	SGMemoryCounter* total=get_total_memory_counter();
+	SGMemoryCounter* counter=SGMemoryCounter::get_counter(current_counter);
+
+	SGMemoryCounter* exceeded=NULL;
+	if (!total->charge(size))
+		exceeded=total;
+	else if (counter && !counter->charge(size))
+	{
+		total->release(size);
+		exceeded=counter;
+	}
+
+	if (exceeded)
+	{
+		const size_t buf_len=128;
+		char buf[buf_len];
+		size_t written=snprintf(buf, buf_len,
+			"Out of memory error, allocating %lld bytes exceeds the limit of %s.\n",
+			(long long int) size, exceeded->get_name());
+		if (written<buf_len)
+			throw ShogunException(buf);
+		else
+			throw ShogunException("Out of memory error, memory limit exceeded.\n");
+	}
+
+	return counter ? current_counter : 0;
+}
+
+void SGPoolAllocator::release(size_t size, uint8_t counter)
+{
+	get_total_memory_counter()->release(size);
+	SGMemoryCounter* c=SGMemoryCounter::get_counter(counter);
+	if (c)
+		c->release(size);
+}
+
+void SGPoolAllocator::release_thread_cache(void* cache)
+{
+	ThreadCache* c=(ThreadCache*) cache;
+	registry_lock.lock();
+	for (int32_t i=0; i<MAX_LIVE_ALLOCATORS; i++)
+	{
+		if (live_allocators[i] && live_ids[i]==c->owner_id)
+			live_allocators[i]->flush_all(c);
+	}
+	registry_lock.unlock();
+	free(c);
+
+	if (thread_cache==c)
+		thread_cache=NULL;
+}
+
+#ifdef HAVE_PTHREAD
+static void release_cache(void* cache)
+{
+	SGPoolAllocator::release_thread_cache(cache);
+}
+
+static void create_thread_cache_key()
+{
+	pthread_key_create(&thread_cache_key, release_cache);
+}
+#endif
+
+SGPoolAllocator::ThreadCache* SGPoolAllocator::get_thread_cache()
+{
+	ThreadCache* cache=thread_cache;
+	if (cache && cache->owner_id==id)
+		return cache;
+
+	if (!cache)
+	{
+		cache=(ThreadCache*) calloc(1, sizeof(ThreadCache));
+		if (!cache)
+			return NULL;
+		thread_cache=cache;
+#ifdef HAVE_PTHREAD
+		pthread_once(&thread_cache_key_once, create_thread_cache_key);
+		pthread_setspecific(thread_cache_key, cache);
+#endif
+	}
+	else
+	{
+		/* a thread caches the blocks of one allocator at a time */
+		registry_lock.lock();
+		for (int32_t i=0; i<MAX_LIVE_ALLOCATORS; i++)
+		{
+			if (live_allocators[i] && live_ids[i]==cache->owner_id)
+				live_allocators[i]->flush_all(cache);
+		}
+		registry_lock.unlock();
+		memset(cache->lists, 0, sizeof(cache->lists));
+	}
+
+	cache->owner_id=id;
+	return cache;
+}
+
+void SGPoolAllocator::refill(FreeList& list, int32_t size_class)
+{
+	lock.lock();
+	FreeList& shared=depot[size_class];
+	if (shared.count>0)
+	{
+		while (shared.head && list.count<POOL_BATCH)
+		{
+			void* block=shared.head;
+			shared.head=next_free(block);
+			shared.count--;
+			next_free(block)=list.head;
+			list.head=block;
+			list.count++;
+		}
+		lock.unlock();
+		return;
+	}
+
+	/* slabs fill a region each */
+	char* slab=NULL;
+	if (posix_memalign((void**) &slab, REGION_SIZE, slab_size))
+		slab=NULL;
+	if (!slab || !set_region(slab, SLAB_REGION))
+	{
+		free(slab);
+		lock.unlock();
+		return;
+	}
+	*(void**) slab=slabs;
+	slabs=slab;
+	num_slabs++;
+	lock.unlock();
+
+	size_t block_size=class_size[size_class];
+	for (size_t start=HEADER_SIZE; start+block_size<=slab_size; start+=block_size)
+	{
+		void* block=slab+start;
+		next_free(block)=list.head;
+		list.head=block;
+		list.count++;
+	}
+}
+
+void SGPoolAllocator::flush(FreeList& list, int32_t size_class, int32_t keep)
+{
+	lock.lock();
+	FreeList& shared=depot[size_class];
+	while (list.count>keep)
+	{
+		void* block=list.head;
+		list.head=next_free(block);
+		list.count--;
+		next_free(block)=shared.head;
+		shared.head=block;
+		shared.count++;
+	}
+	lock.unlock();
+}
+
+void SGPoolAllocator::flush_all(ThreadCache* cache)
+{
+	for (int32_t i=0; i<num_classes; i++)
+		flush(cache->lists[i], i, 0);
+}
+
+void* SGPoolAllocator::allocate(size_t size, size_t alignment)
+{
+	if (alignment<HEADER_SIZE)
+		alignment=HEADER_SIZE;
+	if (alignment & (alignment-1) || alignment>(1<<15))
+		return NULL;
+
+	uint8_t counter=charge(size);
+
+	int32_t size_class=alignment==HEADER_SIZE ? get_size_class(size+HEADER_SIZE) : -1;
+	if (size_class>=0)
+	{
+		ThreadCache* cache=get_thread_cache();
+		if (cache)
+		{
+			FreeList& list=cache->lists[size_class];
+			if (!list.head)
+				refill(list, size_class);
+
+			if (list.head)
+			{
+				block_header* header=(block_header*) list.head;
+				list.head=next_free(header);
+				list.count--;
+
+				header->size=size;
+				header->offset=0;
+				header->size_class=size_class;
+				header->counter=counter;
+				header->magic=BLOCK_MAGIC;
+				atomic_add(num_blocks, 1);
+				return header+1;
+			}
+		}
+	}
+
+	/* blocks which aren't pooled start a region of their own, with room to
+	 * place the header such that the block is aligned. The block stays in
+	 * the first region as alignment is less than the region size */
+	size_t padding=alignment>HEADER_SIZE ? alignment : 0;
+	char* memory=NULL;
+	if (size>size_t(-1)-HEADER_SIZE-padding ||
+			posix_memalign((void**) &memory, REGION_SIZE, size+HEADER_SIZE+padding))
+	{
+		release(size, counter);
+		return NULL;
+	}
+
+	char* block=(char*) align_up((size_t) memory+HEADER_SIZE, alignment);
+	lock.lock();
+	bool recorded=set_region(memory, block);
+	lock.unlock();
+	if (!recorded)
+	{
+		free(memory);
+		release(size, counter);
+		return NULL;
+	}
+
+	block_header* header=get_header(block);
+	header->size=size;
+	header->offset=(char*) header-memory;
+	header->size_class=NOT_POOLED;
+	header->counter=counter;
+	header->magic=BLOCK_MAGIC;
+	atomic_add(num_blocks, 1);
+
+	return block;
+}
+
+void* SGPoolAllocator::reallocate(void* ptr, size_t size)
+{
+	if (!ptr)
+		return allocate(size);
+
+	block_header* header=get_header(ptr);
+	if (header->size_class!=NOT_POOLED)
+	{
+		/* the block is large enough already */
+		if (size+HEADER_SIZE<=class_size[header->size_class] &&
+				size+HEADER_SIZE>class_size[header->size_class]/2)
+		{
+			release(header->size, header->counter);
+			header->counter=charge(size);
+			header->size=size;
+			return ptr;
+		}
+	}
+
+	void* block=allocate(size);
+	if (block)
+	{
+		memcpy(block, ptr, CMath::min(size_t(header->size), size));
+		deallocate(ptr);
+	}
+	return block;
+}
+
+void SGPoolAllocator::deallocate(void* ptr)
+{
+	if (!ptr)
+		return;
+
+	block_header* header=get_header(ptr);
+	release(header->size, header->counter);
+	header->magic=0;
+	atomic_add(num_blocks, -1);
+
+	if (header->size_class==NOT_POOLED)
+	{
+		char* memory=(char*) header-header->offset;
+		lock.lock();
+		set_region(memory, NULL);
+		lock.unlock();
+		free(memory);
+		return;
+	}
+
+	int32_t size_class=header->size_class;
+	ThreadCache* cache=get_thread_cache();
+	if (!cache)
+	{
+		lock.lock();
+		next_free(header)=depot[size_class].head;
+		depot[size_class].head=header;
+		depot[size_class].count++;
+		lock.unlock();
+		return;
+	}
+
+	FreeList& list=cache->lists[size_class];
+	next_free(header)=list.head;
+	list.head=header;
+	list.count++;
+
+	if (list.count>2*POOL_BATCH)
+		flush(list, size_class, POOL_BATCH);
+}
+
+bool SGPoolAllocator::owns(void* ptr)
+{
+	if (!ptr || ((size_t) ptr & (HEADER_SIZE-1)))
+		return false;
+
+	/* slab regions only hold pooled blocks, other regions the one block
+	 * recorded for them */
+	void* region=get_region(ptr);
+	return region==SLAB_REGION || (region && region==ptr);
+}
+
+int64_t SGPoolAllocator::get_num_blocks() const
+{
+	return atomic_get(num_blocks);
+}
+
+size_t SGPoolAllocator::get_block_size(void* ptr)
+{
+	return get_header(ptr)->size;
+}
+
+SGMemoryCounter::SGMemoryCounter(const char* n, int64_t l)
+: name(n), limit(l), bytes(0), peak_bytes(0), num_allocations(0), index(0)
+{
+	registry_lock.lock();
+	for (int32_t i=1; i<256; i++)
+	{
+		if (!counters[i])
+		{
+			counters[i]=this;
+			index=i;
+			break;
+		}
+	}
+	registry_lock.unlock();
+}
+
+SGMemoryCounter::~SGMemoryCounter()
+{
+	registry_lock.lock();
+	if (index)
+		counters[index]=NULL;
+	registry_lock.unlock();
+}
+
+int64_t SGMemoryCounter::get_bytes() const
+{
+	return atomic_get(bytes);
+}
+
+int64_t SGMemoryCounter::get_peak_bytes() const
+{
+	return atomic_get(peak_bytes);
+}
+
+int64_t SGMemoryCounter::get_num_allocations() const
+{
+	return atomic_get(num_allocations);
+}
+
+void SGMemoryCounter::reset_peak()
+{
+	atomic_set(peak_bytes, atomic_get(bytes));
+}
+
+bool SGMemoryCounter::charge(int64_t size)
+{
+	int64_t now=atomic_add(bytes, size);
+	if (limit>0 && now>limit)
+	{
+		atomic_add(bytes, -size);
+		return false;
+	}
+
+	atomic_add(num_allocations, 1);
+	atomic_max(peak_bytes, now);
+	return true;
+}
+
+void SGMemoryCounter::release(int64_t size)
+{
+	atomic_add(bytes, -size);
+}
+
+SGMemoryCounter* SGMemoryCounter::get_counter(uint8_t index)
+{
+	return index ? counters[index] : NULL;
+}
+
+uint8_t SGMemoryCounter::get_current_index()
+{
+	return current_counter;
+}
+
+SGMemoryCounterScope::SGMemoryCounterScope(SGMemoryCounter* counter)
+: previous(current_counter)
+{
+	current_counter=counter ? counter->index : 0;
+}
+
+SGMemoryCounterScope::~SGMemoryCounterScope()
+{
+	current_counter=previous;
+}
+
+SGMemoryCounter* shogun::get_total_memory_counter()
+{
+	static SGMemoryCounter total("total");
+	return &total;
+}
+
+SGArena::SGArena(size_t size)
+: chunk_size(size), chunks(NULL), sizes(NULL), num_chunks(0), max_chunks(0),
+	current(0), offset(0), used(0)
+{
+}
+
+SGArena::~SGArena()
+{
+	for (int32_t i=0; i<num_chunks; i++)
+		SG_FREE(chunks[i]);
+	SG_FREE(chunks);
+	SG_FREE(sizes);
+}
+
+void* SGArena::allocate(size_t size, size_t alignment)
+{
+	while (true)
+	{
+		if (current<num_chunks)
+		{
+			size_t start=align_up((size_t) chunks[current]+offset, alignment)-
+				(size_t) chunks[current];
+			if (start+size<=sizes[current])
+			{
+				offset=start+size;
+				used+=size;
+				return chunks[current]+start;
+			}
+
+			if (current+1<num_chunks)
+			{
+				current++;
+				offset=0;
+				continue;
+			}
+		}
+
+		if (num_chunks==max_chunks)
+		{
+			int32_t new_max=CMath::max(2*max_chunks, 8);
+			chunks=SG_REALLOC(char*, chunks, max_chunks, new_max);
+			sizes=SG_REALLOC(size_t, sizes, max_chunks, new_max);
+			max_chunks=new_max;
+		}
+
+		sizes[num_chunks]=CMath::max(chunk_size, size+alignment);
+		chunks[num_chunks]=SG_MALLOC(char, sizes[num_chunks]);
+		current=num_chunks++;
+		offset=0;
+	}
+}
+
+void SGArena::reset()
+{
+	current=0;
+	offset=0;
+	used=0;
+}
+
+size_t SGArena::get_used() const
+{
+	return used;
+}
+
+size_t SGArena::get_capacity() const
+{
+	size_t capacity=0;
+	for (int32_t i=0; i<num_chunks; i++)
+		capacity+=sizes[i];
+	return capacity;
+}
+
+SGArena::Mark SGArena::get_mark() const
+{
+	Mark mark;
+	mark.chunk=current;
+	mark.offset=offset;
+	mark.used=used;
+	return mark;
+}
+
+void SGArena::rewind(const Mark& mark)
+{
+	current=mark.chunk;
+	offset=mark.offset;
+	used=mark.used;
+}
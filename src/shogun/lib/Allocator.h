@@ -0,0 +1,455 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef __ALLOCATOR_H__
+#define __ALLOCATOR_H__
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/common.h>
+#include <shogun/lib/Lock.h>
+
+#include <stddef.h>
+
+#ifdef HAVE_CXX11_ATOMIC
+#include <atomic>
+#endif
+
+namespace shogun
+{
+class SGMemoryCounter;
+
+/** @brief Interface of the allocators behind SG_MALLOC, SG_CALLOC,
+ * SG_REALLOC, SG_ALIGNED_MALLOC and SG_FREE.
+ *
+ * An allocator is installed by set_global_allocator(). Without one, memory
+ * is obtained from malloc (or jemalloc/tcmalloc if shogun was configured to
+ * use them). Blocks have to be freed by the allocator that allocated them,
+ * blocks the installed allocator doesn't own (see owns()) are passed to
+ * free(). Hence an allocator can't be uninstalled while any of its blocks
+ * are alive (see get_num_blocks()).
+ */
+class SGAllocator
+{
+public:
+	/** destructor */
+	virtual ~SGAllocator() {}
+
+	/** allocate memory
+	 *
+	 * @param size number of bytes
+	 * @param alignment alignment of the block (power of two), 0 for the
+	 * default alignment of malloc
+	 * @return block or NULL if out of memory
+	 */
+	virtual void* allocate(size_t size, size_t alignment=0)=0;
+
+	/** change the size of a block, the alignment is not preserved
+	 *
+	 * @param ptr block (may be NULL)
+	 * @param size new number of bytes
+	 * @return new block or NULL if out of memory
+	 */
+	virtual void* reallocate(void* ptr, size_t size)=0;
+
+	/** free block
+	 *
+	 * @param ptr block
+	 */
+	virtual void deallocate(void* ptr)=0;
+
+	/** whether the block was allocated by this allocator. This is called
+	 * for every block freed while the allocator is installed, so it must
+	 * not access memory the allocator doesn't own
+	 *
+	 * @param ptr any pointer returned by an allocator or malloc
+	 * @return whether the block was allocated by this allocator
+	 */
+	virtual bool owns(void* ptr)=0;
+
+	/** @return number of blocks allocated and not freed yet */
+	virtual int64_t get_num_blocks() const=0;
+
+	/** @return name of allocator */
+	virtual const char* get_name() const=0;
+};
+
+/** @brief Allocator keeping blocks of up to a few KB in thread-local pools.
+ *
+ * Small blocks are rounded up to one of a few size classes and carved from
+ * slabs of 64KB. Freed blocks go to a free list of the freeing thread, so
+ * the common case of allocating and freeing takes no lock. Lists growing
+ * too long and the lists of exiting threads are returned to a shared depot
+ * which threads refill from in batches. Slabs are only released when the
+ * allocator is destroyed, which avoids the fragmentation of many small
+ * short-lived blocks in long running processes.
+ *
+ * Slabs and larger blocks are placed at the start of 64KB aligned regions,
+ * which are recorded in a two-level map of the address space. Ownership of
+ * a pointer is looked up there, without reading any memory near the
+ * pointer.
+ *
+ * Each block carries a 16 byte header with its size, which also allows to
+ * account it: all allocations are charged to the total counter
+ * (get_total_memory_counter()) and to the counter of the allocating thread
+ * if a SGMemoryCounterScope is active.
+ */
+class SGPoolAllocator : public SGAllocator
+{
+public:
+	/** constructor
+	 *
+	 * @param max_pooled_size largest block (in bytes) kept in the pools,
+	 * 0 to only use the accounting
+	 */
+	SGPoolAllocator(size_t max_pooled_size=4096);
+
+	/** destructor, releases all slabs unless blocks are still in use.
+	 * The allocator must not be installed when it has blocks in use.
+	 */
+	virtual ~SGPoolAllocator();
+
+	virtual void* allocate(size_t size, size_t alignment=0);
+	virtual void* reallocate(void* ptr, size_t size);
+	virtual void deallocate(void* ptr);
+	virtual bool owns(void* ptr);
+	virtual int64_t get_num_blocks() const;
+
+	/** @return size of block */
+	static size_t get_block_size(void* ptr);
+
+	/** @return number of bytes held by slabs */
+	size_t get_slab_bytes() const { return num_slabs*slab_size; }
+
+	/** @return name of allocator */
+	virtual const char* get_name() const { return "PoolAllocator"; }
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** free list of a size class */
+	struct FreeList
+	{
+		/** first free block */
+		void* head;
+		/** number of blocks in the list */
+		int32_t count;
+	};
+
+	/** blocks of a thread */
+	struct ThreadCache;
+
+	/** map of the regions of slabs and large blocks */
+	struct RegionMap;
+
+	/** maximum number of size classes */
+	static const int32_t MAX_CLASSES=64;
+
+	/** release the cache of an exiting thread */
+	static void release_thread_cache(void* cache);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+private:
+	/** @return size class of a block of total_size bytes (header
+	 * included) or -1 if it isn't pooled */
+	inline int32_t get_size_class(size_t total_size) const;
+
+	/** @return cache of the calling thread, bound to this allocator */
+	ThreadCache* get_thread_cache();
+
+	/** fill free list of size class from the depot or a new slab */
+	void refill(FreeList& list, int32_t size_class);
+
+	/** return free list of size class to the depot up to keep blocks */
+	void flush(FreeList& list, int32_t size_class, int32_t keep);
+
+	/** return all blocks of the thread cache to the depot */
+	void flush_all(ThreadCache* cache);
+
+	/** @return value of the region containing ptr in the region map,
+	 * NULL if the region isn't owned */
+	void* get_region(const void* ptr) const;
+
+	/** set value of the region starting at start, lock has to be held
+	 *
+	 * @param start start of region
+	 * @param value value, NULL to remove the region
+	 * @return false if the map couldn't be extended
+	 */
+	bool set_region(const void* start, void* value);
+
+	/** charge allocation to the counters, throwing if a limit is exceeded
+	 *
+	 * @return index of the charged thread counter
+	 */
+	static uint8_t charge(size_t size);
+
+	/** release allocation from the counters */
+	static void release(size_t size, uint8_t counter);
+
+private:
+	/** unique id of this allocator */
+	uint64_t id;
+	/** number of size classes */
+	int32_t num_classes;
+	/** total block size (header included) of each size class */
+	size_t class_size[MAX_CLASSES];
+	/** largest pooled total block size */
+	size_t max_pooled;
+	/** slab size */
+	size_t slab_size;
+	/** number of slabs */
+	size_t num_slabs;
+	/** slabs (linked through their first bytes) */
+	void* slabs;
+	/** shared free lists */
+	FreeList depot[MAX_CLASSES];
+	/** regions of slabs and large blocks */
+	RegionMap* region_map;
+#ifdef HAVE_CXX11_ATOMIC
+	/** number of blocks in use */
+	std::atomic<int64_t> num_blocks;
+#else
+	/** number of blocks in use */
+	volatile int64_t num_blocks;
+#endif
+	/** lock of depot, slabs and region map */
+	CLock lock;
+};
+
+/** @brief Counter of the bytes and number of allocations of a subsystem.
+ *
+ * Allocations are charged to the counter of the allocating thread (see
+ * SGMemoryCounterScope) and to the total counter. Setting a limit makes
+ * allocations which would exceed it throw an out of memory exception.
+ * Counting needs an allocator keeping track of block sizes, i.e. a
+ * SGPoolAllocator. Counters should be kept until their blocks are freed.
+ */
+class SGMemoryCounter
+{
+public:
+	/** constructor
+	 *
+	 * @param name name of the subsystem
+	 * @param limit maximum number of bytes (0 for no limit)
+	 */
+	SGMemoryCounter(const char* name, int64_t limit=0);
+
+	/** destructor */
+	~SGMemoryCounter();
+
+	/** @return name */
+	const char* get_name() const { return name; }
+
+	/** @return number of bytes currently allocated */
+	int64_t get_bytes() const;
+
+	/** @return maximum number of bytes allocated at any time */
+	int64_t get_peak_bytes() const;
+
+	/** @return number of allocations */
+	int64_t get_num_allocations() const;
+
+	/** set limit
+	 *
+	 * @param l maximum number of bytes (0 for no limit)
+	 */
+	void set_limit(int64_t l) { limit=l; }
+
+	/** @return limit */
+	int64_t get_limit() const { return limit; }
+
+	/** reset peak to the current number of bytes */
+	void reset_peak();
+
+	/** charge allocation
+	 *
+	 * @param size number of bytes
+	 * @return false (nothing charged) if the limit would be exceeded
+	 */
+	bool charge(int64_t size);
+
+	/** release allocation
+	 *
+	 * @param size number of bytes
+	 */
+	void release(int64_t size);
+
+	/** @return counter with the given index (registered counters have
+	 * indices 1,...,255) */
+	static SGMemoryCounter* get_counter(uint8_t index);
+
+	/** @return index of the counter of the calling thread (0 for none) */
+	static uint8_t get_current_index();
+
+	/** @return index of the counter */
+	uint8_t get_index() const { return index; }
+
+private:
+	/** name */
+	const char* name;
+	/** limit */
+	int64_t limit;
+#ifdef HAVE_CXX11_ATOMIC
+	/** number of bytes */
+	std::atomic<int64_t> bytes;
+	/** peak number of bytes */
+	std::atomic<int64_t> peak_bytes;
+	/** number of allocations */
+	std::atomic<int64_t> num_allocations;
+#else
+	/** number of bytes */
+	volatile int64_t bytes;
+	/** peak number of bytes */
+	volatile int64_t peak_bytes;
+	/** number of allocations */
+	volatile int64_t num_allocations;
+#endif
+	/** index in the registry */
+	uint8_t index;
+
+	friend class SGMemoryCounterScope;
+};
+
+/** @brief Charges the allocations of the calling thread to a counter while
+ * in scope.
+ *
+ * Scopes can be nested, the innermost counter is charged.
+ */
+class SGMemoryCounterScope
+{
+public:
+	/** constructor
+	 *
+	 * @param counter counter to charge
+	 */
+	SGMemoryCounterScope(SGMemoryCounter* counter);
+
+	/** destructor, restores the previous counter */
+	~SGMemoryCounterScope();
+
+private:
+	/** index of the previous counter */
+	uint8_t previous;
+};
+
+/** @brief Arena for short-lived scratch memory.
+ *
+ * Memory is handed out from large chunks by incrementing an offset and
+ * only given back all at once, either by reset() or at the end of a
+ * SGArenaScope. Chunks are kept for reuse, so a solver doing the same
+ * per-iteration allocations only allocates in its first iteration.
+ */
+class SGArena
+{
+public:
+	/** constructor
+	 *
+	 * @param chunk_size size of chunks in bytes
+	 */
+	SGArena(size_t chunk_size=1<<20);
+
+	/** destructor, frees all chunks */
+	~SGArena();
+
+	/** allocate memory
+	 *
+	 * @param size number of bytes
+	 * @param alignment alignment (power of two)
+	 * @return memory valid until reset or end of the enclosing scope
+	 */
+	void* allocate(size_t size, size_t alignment=16);
+
+	/** allocate array
+	 *
+	 * @param len number of elements
+	 * @return uninitialized array
+	 */
+	template <class T> T* allocate(index_t len)
+	{
+		return (T*) allocate(sizeof(T)*len, sizeof(T)>16 ? 32 : 16);
+	}
+
+	/** give back all memory (chunks are kept) */
+	void reset();
+
+	/** @return number of bytes handed out */
+	size_t get_used() const;
+
+	/** @return number of bytes in chunks */
+	size_t get_capacity() const;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+	/** position in the arena */
+	struct Mark
+	{
+		/** index of chunk */
+		int32_t chunk;
+		/** offset in chunk */
+		size_t offset;
+		/** bytes handed out */
+		size_t used;
+	};
+
+	/** @return current position */
+	Mark get_mark() const;
+
+	/** give back memory allocated after the position */
+	void rewind(const Mark& mark);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+private:
+	/** size of chunks */
+	size_t chunk_size;
+	/** chunks */
+	char** chunks;
+	/** sizes of chunks */
+	size_t* sizes;
+	/** number of chunks */
+	int32_t num_chunks;
+	/** capacity of chunks array */
+	int32_t max_chunks;
+	/** current chunk */
+	int32_t current;
+	/** offset in current chunk */
+	size_t offset;
+	/** bytes handed out */
+	size_t used;
+};
+
+/** @brief Gives back the memory allocated from an arena while in scope. */
+class SGArenaScope
+{
+public:
+	/** constructor
+	 *
+	 * @param a arena
+	 */
+	SGArenaScope(SGArena& a) : arena(a), mark(a.get_mark()) {}
+
+	/** destructor */
+	~SGArenaScope() { arena.rewind(mark); }
+
+private:
+	/** arena */
+	SGArena& arena;
+	/** position at construction */
+	SGArena::Mark mark;
+};
+
+/** install allocator used by SG_MALLOC and friends. This must not be
+ * called while other threads allocate memory. An error is raised if the
+ * installed allocator still has blocks in use.
+ *
+ * @param allocator allocator, NULL for malloc
+ */
+void set_global_allocator(SGAllocator* allocator);
+
+/** @return installed allocator (NULL for malloc) */
+SGAllocator* get_global_allocator();
+
+/** @return counter of all accounted allocations */
+SGMemoryCounter* get_total_memory_counter();
+}
+#endif // __ALLOCATOR_H__
@@ -12,6 +12,10 @@ namespace shogun
 {
 /** brief This class implements a thread-safe counter used for
  * reference counting.
+ *
+ * The counter is lock-free: it is a std::atomic when available, or
+ * uses the atomic builtins of GCC compatible compilers otherwise. Only
+ * if neither is available a lock is taken on each operation.
  */
 class RefCount
 {
@@ -26,23 +30,65 @@ public:
 	 *
 	 * @return the new reference count
 	 */
-	int32_t ref();
+	inline int32_t ref()
+	{
+#ifdef HAVE_CXX11_ATOMIC
+		// a new reference can only be obtained through an existing one,
+		// so no ordering is required here
+		return rc.fetch_add(1, std::memory_order_relaxed)+1;
+#elif defined(__GNUC__)
+		return __sync_add_and_fetch(&rc, 1);
+#else
+		lock.lock();
+		int32_t count = ++rc;
+		lock.unlock();
+		return count;
+#endif
+	}
 
 	/** Decrease reference count
 	 *
 	 * @return the new reference count
 	 */
-	int32_t unref();
+	inline int32_t unref()
+	{
+#ifdef HAVE_CXX11_ATOMIC
+		// all accesses through the released reference have to happen
+		// before the object is destroyed by whoever sees the count drop to 0
+		return rc.fetch_sub(1, std::memory_order_acq_rel)-1;
+#elif defined(__GNUC__)
+		return __sync_sub_and_fetch(&rc, 1);
+#else
+		lock.lock();
+		int32_t count = --rc;
+		lock.unlock();
+		return count;
+#endif
+	}
 
 	/** Get the reference count
 	 *
 	 * @return the reference count
 	 */
-	int32_t ref_count();
+	inline int32_t ref_count()
+	{
+#ifdef HAVE_CXX11_ATOMIC
+		return rc.load(std::memory_order_acquire);
+#elif defined(__GNUC__)
+		return __sync_add_and_fetch(&rc, 0);
+#else
+		lock.lock();
+		int32_t count = rc;
+		lock.unlock();
+		return count;
+#endif
+	}
 
 	/** reference count */
 #ifdef HAVE_CXX11_ATOMIC
-    volatile std::atomic<int> rc;
+	std::atomic<int32_t> rc;
+#elif defined(__GNUC__)
+	volatile int32_t rc;
 #else
 	int32_t rc;
 
@@ -19,6 +19,7 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/lapack.h>
 #include <shogun/lib/SGMatrixList.h>
+#include <utility>
 
 namespace shogun {
 
@@ -52,6 +53,29 @@ SGMatrix<T>::SGMatrix(const SGMatrix &orig) : SGReferencedData(orig)
 	copy_data(orig);
 }
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+template<class T>
+SGMatrix<T>::SGMatrix(SGMatrix&& orig) : SGReferencedData(std::move(orig))
+{
+	copy_data(orig);
+	orig.init_data();
+}
+
+template<class T>
+SGMatrix<T>& SGMatrix<T>::operator=(const SGMatrix& orig)
+{
+	SGReferencedData::operator=(orig);
+	return *this;
+}
+
+template<class T>
+SGMatrix<T>& SGMatrix<T>::operator=(SGMatrix&& orig)
+{
+	SGReferencedData::operator=(std::move(orig));
+	return *this;
+}
+#endif
+
 template <class T>
 SGMatrix<T>::~SGMatrix()
 {
@@ -43,6 +43,19 @@ template<class T> class SGMatrix : public SGReferencedData
 		/** copy constructor */
 		SGMatrix(const SGMatrix &orig);
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+		/** move constructor, takes over data and reference of orig
+		 * leaving it empty
+		 */
+		SGMatrix(SGMatrix&& orig);
+
+		/** copy assignment operator */
+		SGMatrix& operator=(const SGMatrix& orig);
+
+		/** move assignment operator */
+		SGMatrix& operator=(SGMatrix&& orig);
+#endif
+
 		/** empty destructor */
 		virtual ~SGMatrix();
 
@@ -36,6 +36,26 @@ SGReferencedData& SGReferencedData::operator= (const SGReferencedData &orig)
 	return *this;
 }
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+SGReferencedData::SGReferencedData(SGReferencedData&& orig) : m_refcount(orig.m_refcount)
+{
+	orig.m_refcount = NULL;
+}
+
+SGReferencedData& SGReferencedData::operator= (SGReferencedData&& orig)
+{
+	if (this == &orig)
+		return *this;
+
+	unref();
+	copy_data(orig);
+	m_refcount = orig.m_refcount;
+	orig.m_refcount = NULL;
+	orig.init_data();
+	return *this;
+}
+#endif
+
 SGReferencedData::~SGReferencedData()
 {
 	delete m_refcount;
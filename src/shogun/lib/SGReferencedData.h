@@ -28,6 +28,22 @@ class SGReferencedData
 		/** override assignment operator to increase refcount on assignments */
 		SGReferencedData& operator= (const SGReferencedData &orig);
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+		/** move constructor, takes over the reference of orig without
+		 * changing the refcount
+		 *
+		 * NOTE: derived classes have to take over the data and
+		 * call init_data() of orig.
+		 */
+		SGReferencedData(SGReferencedData&& orig);
+
+		/** move assignment operator, releases the own reference and
+		 * takes over the one of orig (leaving orig empty) without
+		 * changing its refcount
+		 */
+		SGReferencedData& operator= (SGReferencedData&& orig);
+#endif
+
 		/** empty destructor
 		 *
 		 * NOTE: unref() has to be called in derived classes
@@ -2,6 +2,7 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/mathematics/Math.h>
 #include <shogun/io/File.h>
+#include <utility>
 
 namespace shogun {
 
@@ -34,6 +35,29 @@ SGSparseVector<T>::SGSparseVector(const SGSparseVector& orig) :
 	copy_data(orig);
 }
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+template<class T>
+SGSparseVector<T>::SGSparseVector(SGSparseVector&& orig) : SGReferencedData(std::move(orig))
+{
+	copy_data(orig);
+	orig.init_data();
+}
+
+template<class T>
+SGSparseVector<T>& SGSparseVector<T>::operator=(const SGSparseVector& orig)
+{
+	SGReferencedData::operator=(orig);
+	return *this;
+}
+
+template<class T>
+SGSparseVector<T>& SGSparseVector<T>::operator=(SGSparseVector&& orig)
+{
+	SGReferencedData::operator=(std::move(orig));
+	return *this;
+}
+#endif
+
 template <class T>
 SGSparseVector<T>::~SGSparseVector()
 {
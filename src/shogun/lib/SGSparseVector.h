@@ -57,6 +57,19 @@ public:
 	/** copy constructor */
 	SGSparseVector(const SGSparseVector& orig);
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+	/** move constructor, takes over data and reference of orig
+	 * leaving it empty
+	 */
+	SGSparseVector(SGSparseVector&& orig);
+
+	/** copy assignment operator */
+	SGSparseVector& operator=(const SGSparseVector& orig);
+
+	/** move assignment operator */
+	SGSparseVector& operator=(SGSparseVector&& orig);
+#endif
+
 	virtual ~SGSparseVector();
 
 	/** compute the dot product between dense weights and a sparse feature vector
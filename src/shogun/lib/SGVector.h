@@ -41,6 +41,19 @@ template<class T> class SGVector : public SGReferencedData
 		/** copy constructor */
 		SGVector(const SGVector &orig);
 
+#if defined(HAVE_CXX11) && !defined(SWIG)
+		/** move constructor, takes over data and reference of orig
+		 * leaving it empty
+		 */
+		SGVector(SGVector&& orig);
+
+		/** copy assignment operator */
+		SGVector& operator=(const SGVector& orig);
+
+		/** move assignment operator */
+		SGVector& operator=(SGVector&& orig);
+#endif
+
 		/** wrapper for the copy constructor useful for SWIG interfaces
 		 *
 		 * @param orig vector to set
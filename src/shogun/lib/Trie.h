@@ -238,6 +238,21 @@ IGNORE_IN_CLASSLIST template <class Trie> class CTrie : public CSGObject
 		 */
 		void delete_trees(bool p_use_compact_terminal_nodes=true);
 
+		/** copy the trees of positions begin to end-1 from another trie of
+		 * the same degree and length, replacing the (empty) trees of this
+		 * trie at these positions
+		 *
+		 * Used to merge tries that were built in parallel for disjoint
+		 * ranges of positions. Nodes are copied depth first, so each tree
+		 * ends up in one contiguous block of memory, which makes lookups
+		 * more cache friendly than in a trie built example by example.
+		 *
+		 * @param other trie to copy from
+		 * @param begin first position
+		 * @param end one past last position
+		 */
+		void copy_trees(const CTrie & other, int32_t begin, int32_t end);
+
 		/** add to trie
 		 *
 		 * @param i i
@@ -624,6 +639,17 @@ IGNORE_IN_CLASSLIST template <class Trie> class CTrie : public CSGObject
 			const float64_t valS, const float64_t valL, const float64_t valR,
 			const int32_t debug);
 
+		/** copy subtree helper
+		 *
+		 * @param node node of this trie to copy to
+		 * @param other trie to copy from
+		 * @param other_node node of other trie
+		 * @param depth depth of the node
+		 */
+		void copy_subtree(
+			int32_t node, const CTrie & other, int32_t other_node,
+			int32_t depth);
+
 		/** @return object name */
 		virtual const char* get_name() const { return "Trie"; }
 
@@ -1180,6 +1206,51 @@ template <class Trie> void CTrie<Trie>::delete_trees(
 	use_compact_terminal_nodes=p_use_compact_terminal_nodes ;
 }
 
+template <class Trie> void CTrie<Trie>::copy_trees(
+	const CTrie<Trie> & other, int32_t begin, int32_t end)
+{
+	REQUIRE(other.degree==degree && other.length==length,
+		"Degree (%d) and length (%d) of tries should match (%d, %d)\n",
+		other.degree, other.length, degree, length)
+	REQUIRE(begin>=0 && end<=length, "Positions %d to %d out of range\n",
+		begin, end-1)
+
+	for (int32_t i=begin; i<end; i++)
+		copy_subtree(trees[i], other, other.trees[i], 0);
+}
+
+template <class Trie> void CTrie<Trie>::copy_subtree(
+	int32_t node, const CTrie<Trie> & other, int32_t other_node,
+	int32_t depth)
+{
+	TreeMem[node]=other.TreeMem[other_node];
+
+	// nodes of the last level hold child weights instead of children
+	if (depth>=degree-1)
+		return;
+
+	for (int32_t q=0; q<4; q++)
+	{
+		int32_t child=other.TreeMem[other_node].children[q];
+		if (child==NO_CHILD)
+			continue;
+
+		// TreeMem may be reallocated by get_node
+		int32_t tmp=get_node();
+		if (child<0)
+		{
+			// compact node storing the rest of a sequence
+			TreeMem[tmp]=other.TreeMem[-child];
+			TreeMem[node].children[q]=-tmp;
+		}
+		else
+		{
+			TreeMem[node].children[q]=tmp;
+			copy_subtree(tmp, other, child, depth+1);
+		}
+	}
+}
+
 	template <class Trie>
 float64_t CTrie<Trie>::compute_abs_weights_tree(int32_t tree, int32_t depth)
 {
@@ -16,6 +16,7 @@
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/base/SGObject.h>
+#include <shogun/lib/Allocator.h>
 
 #include <string.h>
 
@@ -190,19 +191,68 @@ void operator delete[](void *p) throw()
 
 namespace shogun
 {
+/* allocator behind SG_MALLOC and friends, NULL for malloc */
+#ifdef HAVE_CXX11_ATOMIC
+static std::atomic<SGAllocator*> sg_allocator(NULL);
+#else
+static SGAllocator* volatile sg_allocator=NULL;
+#endif
+
+static inline SGAllocator* current_allocator()
+{
+#ifdef HAVE_CXX11_ATOMIC
+	return sg_allocator.load(std::memory_order_acquire);
+#else
+	SGAllocator* allocator=sg_allocator;
+	__sync_synchronize();
+	return allocator;
+#endif
+}
+
+void set_global_allocator(SGAllocator* allocator)
+{
+	SGAllocator* current=current_allocator();
+	if (current==allocator)
+		return;
+
+	/* blocks of the current allocator would be passed to free() */
+	REQUIRE(!current || current->get_num_blocks()==0,
+		"Cannot replace %s, it has %lld blocks in use\n", current->get_name(),
+		(long long int) current->get_num_blocks())
+
+#ifdef HAVE_CXX11_ATOMIC
+	sg_allocator.store(allocator, std::memory_order_release);
+#else
+	__sync_synchronize();
+	sg_allocator=allocator;
+#endif
+}
+
+SGAllocator* get_global_allocator()
+{
+	return current_allocator();
+}
+
 void* sg_malloc(size_t size
 #ifdef TRACE_MEMORY_ALLOCS
 		, const char* file, int line
 #endif
 )
 {
+	void* p;
+	SGAllocator* allocator=current_allocator();
+	if (allocator)
+		p=allocator->allocate(size);
+	else
+	{
 #if defined(USE_JEMALLOC)
-	void* p=je_malloc(size);
+		p=je_malloc(size);
 #elif defined(USE_TCMALLOC)
-	void *p=tc_malloc(size);
+		p=tc_malloc(size);
 #else
-	void* p=malloc(size);
+		p=malloc(size);
 #endif
+	}
 #ifdef TRACE_MEMORY_ALLOCS
 	if (sg_mallocs)
 		sg_mallocs->add(p, MemoryBlock(p,size, file, line));
@@ -229,13 +279,26 @@ void* sg_calloc(size_t num, size_t size
 #endif
 )
 {
+	void* p;
+	SGAllocator* allocator=current_allocator();
+	if (allocator)
+	{
+		p=NULL;
+		if (!size || num<=size_t(-1)/size)
+			p=allocator->allocate(num*size);
+		if (p)
+			memset(p, 0, num*size);
+	}
+	else
+	{
 #if defined(USE_JEMALLOC)
-	void* p=je_calloc(num, size);
+		p=je_calloc(num, size);
 #elif defined(USE_TCMALLOC)
-	void* p=tc_calloc(num, size);
+		p=tc_calloc(num, size);
 #else
-	void* p=calloc(num, size);
+		p=calloc(num, size);
 #endif
+	}
 
 #ifdef TRACE_MEMORY_ALLOCS
 	if (sg_mallocs)
@@ -266,6 +329,13 @@ void  sg_free(void* ptr)
 		sg_mallocs->remove(ptr);
 #endif
 
+	SGAllocator* allocator=current_allocator();
+	if (allocator && allocator->owns(ptr))
+	{
+		allocator->deallocate(ptr);
+		return;
+	}
+
 #if defined(USE_JEMALLOC)
 	je_free(ptr);
 #elif defined(USE_TCMALLOC)
@@ -281,13 +351,21 @@ void* sg_realloc(void* ptr, size_t size
 #endif
 )
 {
+	void* p;
+	/* blocks allocated before the allocator was installed stay with malloc */
+	SGAllocator* allocator=current_allocator();
+	if (allocator && (!ptr || allocator->owns(ptr)))
+		p=allocator->reallocate(ptr, size);
+	else
+	{
 #if defined(USE_JEMALLOC)
-	void* p=je_realloc(ptr, size);
+		p=je_realloc(ptr, size);
 #elif defined(USE_TCMALLOC)
-	void* p=tc_realloc(ptr, size);
+		p=tc_realloc(ptr, size);
 #else
-	void* p=realloc(ptr, size);
+		p=realloc(ptr, size);
 #endif
+	}
 
 #ifdef TRACE_MEMORY_ALLOCS
 	if (sg_mallocs)
@@ -312,6 +390,51 @@ void* sg_realloc(void* ptr, size_t size
 	return p;
 }
 
+void* sg_aligned_malloc(size_t size, size_t alignment
+#ifdef TRACE_MEMORY_ALLOCS
+		, const char* file, int line
+#endif
+)
+{
+	void* p=NULL;
+	SGAllocator* allocator=current_allocator();
+	if (allocator)
+		p=allocator->allocate(size, alignment);
+	else
+	{
+		if (alignment<sizeof(void*))
+			alignment=sizeof(void*);
+#if defined(USE_JEMALLOC)
+		if (je_posix_memalign(&p, alignment, size))
+#elif defined(USE_TCMALLOC)
+		if (tc_posix_memalign(&p, alignment, size))
+#else
+		if (posix_memalign(&p, alignment, size))
+#endif
+			p=NULL;
+	}
+
+#ifdef TRACE_MEMORY_ALLOCS
+	if (sg_mallocs)
+		sg_mallocs->add(p, MemoryBlock(p,size, file, line));
+#endif
+
+	if (!p)
+	{
+		const size_t buf_len=128;
+		char buf[buf_len];
+		size_t written=snprintf(buf, buf_len,
+			"Out of memory error, tried to allocate %lld bytes aligned to %lld bytes.\n",
+			(long long int) size, (long long int) alignment);
+		if (written<buf_len)
+			throw ShogunException(buf);
+		else
+			throw ShogunException("Out of memory error using posix_memalign.\n");
+	}
+
+	return p;
+}
+
 #ifdef TRACE_MEMORY_ALLOCS
 void list_memory_allocs()
 {
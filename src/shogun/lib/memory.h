@@ -20,7 +20,10 @@
 
 #include <new>
 
-/* wrappers for malloc, free, realloc, calloc */
+/* wrappers for malloc, free, realloc, calloc, posix_memalign
+ *
+ * memory is taken from the allocator installed by
+ * shogun::set_global_allocator() (see Allocator.h) if there is one */
 
 /* overload new() / delete */
 void* operator new(size_t size) throw (std::bad_alloc);
@@ -34,12 +37,14 @@ void operator delete[](void *p) throw();
 #define SG_MALLOC(type, len) sg_generic_malloc<type>(size_t(len), __FILE__, __LINE__)
 #define SG_CALLOC(type, len) sg_generic_calloc<type>(size_t(len), __FILE__, __LINE__)
 #define SG_REALLOC(type, ptr, old_len, len) sg_generic_realloc<type>(ptr, size_t(old_len), size_t(len), __FILE__, __LINE__)
+#define SG_ALIGNED_MALLOC(type, len, alignment) sg_generic_aligned_malloc<type>(size_t(len), size_t(alignment), __FILE__, __LINE__)
 #define SG_FREE(ptr) sg_generic_free(ptr)
 #else //TRACE_MEMORY_ALLOCS
 
 #define SG_MALLOC(type, len) sg_generic_malloc<type>(size_t(len))
 #define SG_CALLOC(type, len) sg_generic_calloc<type>(size_t(len))
 #define SG_REALLOC(type, ptr, old_len, len) sg_generic_realloc<type>(ptr, size_t(old_len), size_t(len))
+#define SG_ALIGNED_MALLOC(type, len, alignment) sg_generic_aligned_malloc<type>(size_t(len), size_t(alignment))
 #define SG_FREE(ptr) sg_generic_free(ptr)
 #endif //TRACE_MEMORY_ALLOCS
 
@@ -68,6 +73,12 @@ template <class T> T* sg_generic_realloc(T* ptr, size_t old_len, size_t len, con
 	return (T*) sg_realloc(ptr, sizeof(T)*len, file, line);
 }
 
+void* sg_aligned_malloc(size_t size, size_t alignment, const char* file, int line);
+template <class T> T* sg_generic_aligned_malloc(size_t len, size_t alignment, const char* file, int line)
+{
+	return (T*) sg_aligned_malloc(sizeof(T)*len, alignment, file, line);
+}
+
 void  sg_free(void* ptr);
 template <class T> void sg_generic_free(T* ptr)
 {
@@ -86,6 +97,12 @@ template <class T> T* sg_generic_realloc(T* ptr, size_t old_len, size_t len)
 	return (T*) sg_realloc(ptr, sizeof(T)*len);
 }
 
+void* sg_aligned_malloc(size_t size, size_t alignment);
+template <class T> T* sg_generic_aligned_malloc(size_t len, size_t alignment)
+{
+	return (T*) sg_aligned_malloc(sizeof(T)*len, alignment);
+}
+
 void* sg_calloc(size_t num, size_t size);
 template <class T> T* sg_generic_calloc(size_t len)
 {
@@ -349,7 +349,8 @@ namespace tapkee
 			 * that has been made (it is called with an argument in range [0,1],
 			 * where 0 means 0% progress and 1 means 100% progress).
 			 *
-			 * Is not supported yet thus won't be used.
+			 * Currently, it is only called by
+			 * @ref tapkee::tDistributedStochasticNeighborEmbedding.
 			 *
 			 * The corresponding value should have type
 			 * @code void (*)(double) @endcode
@@ -364,11 +365,14 @@ namespace tapkee
 			 * computations were cancelled (the function should return
 			 * true if computations were cancelled).
 			 *
-			 * Currently, it is called only once when
-			 * method is starting to work.
+			 * Currently, it is called once when method is
+			 * starting to work and every iteration of
+			 * @ref tapkee::tDistributedStochasticNeighborEmbedding.
 			 *
 			 * If function returns true the library immediately
-			 * throws @ref tapkee::cancelled_exception.
+			 * throws @ref tapkee::cancelled_exception, except for
+			 * t-SNE which stops and returns the embedding obtained
+			 * so far.
 			 *
 			 * The corresponding value should have type
 			 * @code bool (*)() @endcode
@@ -400,6 +404,29 @@ namespace tapkee
 			 */
 			const ParameterKeyword<ScalarType> sne_theta("SNE theta", 0.5);
 
+			/** The keyword for the value that indicates whether
+			 * the Barnes-Hut approximation of the t-SNE gradient should
+			 * be computed in single precision.
+			 *
+			 * Used by @ref tapkee::tDistributedStochasticNeighborEmbedding.
+			 *
+			 * Default value is false.
+			 *
+			 * The corresponding value should have type bool.
+			 */
+			const ParameterKeyword<bool> sne_single_precision("SNE single precision", false);
+
+			/** The keyword for the value that stores the norm of
+			 * the gradient below which t-SNE stops optimizing.
+			 *
+			 * Used by @ref tapkee::tDistributedStochasticNeighborEmbedding.
+			 *
+			 * Default value is 0.0 (i.e. all the iterations are done).
+			 *
+			 * The corresponding value should have type @ref tapkee::ScalarType.
+			 */
+			const ParameterKeyword<ScalarType> sne_min_gradient_norm("SNE minimal gradient norm", 0.0);
+
 			/** The keyword for the value that stores the squishingRate
 			 * parameter of the Manifold Sculpting algorithm.
 			 *
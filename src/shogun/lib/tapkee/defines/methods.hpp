@@ -102,7 +102,17 @@ namespace tapkee
 		//! \f$ O(N N \log k) \f$ time complexity.
 		//! Recommended to be used only in debug purposes.
 		Brute,
-		VpTree
+		VpTree,
+		//! Brute force method working on feature vectors rather than
+		//! distance or kernel callbacks: euclidean distances are computed
+		//! in blocks using matrix products and in parallel. Requires
+		//! the features callback and is only exact when neighbors w.r.t.
+		//! the used distance or kernel are the euclidean ones.
+		BlockedBrute,
+		//! Approximate method working on feature vectors: random projection
+		//! trees refined by NN-descent, close to linear time complexity.
+		//! Same requirements as @ref BlockedBrute apply.
+		NNDescent
 #ifdef TAPKEE_USE_LGPL_COVERTREE
 		//! Covertree-based method with approximate \f$ O(\log N) \f$ time complexity.
 		//! Recommended to be used as a default method.
@@ -50,7 +50,8 @@ public:
 	double hw;
 	double hh;
 
-	bool containsPoint(double point[])
+	template <typename T>
+	bool containsPoint(const T point[])
 	{
 		if(x - hw > point[0]) return false;
 		if(x + hw < point[0]) return false;
@@ -62,6 +63,8 @@ public:
 };
 
 
+//! Quadtree over 2d points of type T, used to approximate repulsive forces
+template <typename T>
 class QuadTree
 {
 
@@ -69,9 +72,6 @@ class QuadTree
 	static const int QT_NO_DIMS = 2;
 	static const int QT_NODE_CAPACITY = 1;
 
-	// A buffer we use when doing force computations
-	double buff[QT_NO_DIMS];
-
 	// Properties of this node in the tree
 	QuadTree* parent;
 	bool is_leaf;
@@ -82,8 +82,8 @@ class QuadTree
 	Cell boundary;
 
 	// Indices in this quad tree node, corresponding center-of-mass, and list of all children
-	double* data;
-	double center_of_mass[QT_NO_DIMS];
+	T* data;
+	T center_of_mass[QT_NO_DIMS];
 	int index[QT_NODE_CAPACITY];
 
 	// Children
@@ -95,7 +95,7 @@ class QuadTree
 public:
 
 	// Default constructor for quadtree -- build tree, too!
-	QuadTree(double* inp_data, int N) :
+	QuadTree(T* inp_data, int N) :
 		parent(NULL), is_leaf(false), size(0), cum_size(0), boundary(), data(NULL),
 		northWest(NULL), northEast(NULL), southWest(NULL), southEast(NULL)
 	{
@@ -120,7 +120,7 @@ public:
 	}
 
 	// Constructor for quadtree with particular size and parent -- build the tree, too!
-	QuadTree(double* inp_data, double inp_x, double inp_y, double inp_hw, double inp_hh) :
+	QuadTree(T* inp_data, double inp_x, double inp_y, double inp_hw, double inp_hh) :
 		parent(NULL), is_leaf(false), size(0), cum_size(0), boundary(), data(NULL),
 		northWest(NULL), northEast(NULL), southWest(NULL), southEast(NULL)
 	{
@@ -128,7 +128,7 @@ public:
 	}
 
 	// Constructor for quadtree with particular size and parent -- build the tree, too!
-	QuadTree(double* inp_data, int N, double inp_x, double inp_y, double inp_hw, double inp_hh) :
+	QuadTree(T* inp_data, int N, double inp_x, double inp_y, double inp_hw, double inp_hh) :
 		parent(NULL), is_leaf(false), size(0), cum_size(0), boundary(), data(NULL),
 		northWest(NULL), northEast(NULL), southWest(NULL), southEast(NULL)
 	{
@@ -137,7 +137,7 @@ public:
 	}
 
 	// Constructor for quadtree with particular size (do not fill the tree)
-	QuadTree(QuadTree* inp_parent, double* inp_data, int N, double inp_x, double inp_y, double inp_hw, double inp_hh) :
+	QuadTree(QuadTree* inp_parent, T* inp_data, int N, double inp_x, double inp_y, double inp_hw, double inp_hh) :
 		parent(NULL), is_leaf(false), size(0), cum_size(0), boundary(), data(NULL),
 		northWest(NULL), northEast(NULL), southWest(NULL), southEast(NULL)
 	{
@@ -146,7 +146,7 @@ public:
 	}
 
 	// Constructor for quadtree with particular size and parent (do not fill the tree)
-	QuadTree(QuadTree* inp_parent, double* inp_data, double inp_x, double inp_y, double inp_hw, double inp_hh) :
+	QuadTree(QuadTree* inp_parent, T* inp_data, double inp_x, double inp_y, double inp_hw, double inp_hh) :
 		parent(NULL), is_leaf(false), size(0), cum_size(0), boundary(), data(NULL),
 		northWest(NULL), northEast(NULL), southWest(NULL), southEast(NULL)
 	{
@@ -162,7 +162,7 @@ public:
 		delete southEast;
 	}
 
-	void setData(double* inp_data)
+	void setData(T* inp_data)
 	{
 		data = inp_data;
 	}
@@ -178,7 +178,7 @@ public:
 	bool insert(int new_index)
 	{
 		// Ignore objects which do not belong in this quad tree
-		double* point = data + new_index * QT_NO_DIMS;
+		T* point = data + new_index * QT_NO_DIMS;
 		if(!boundary.containsPoint(point))
 			return false;
 
@@ -248,7 +248,7 @@ public:
 	bool isCorrect()
 	{
 		for(int n = 0; n < size; n++) {
-			double* point = data + index[n] * QT_NO_DIMS;
+			T* point = data + index[n] * QT_NO_DIMS;
 			if(!boundary.containsPoint(point)) return false;
 		}
 		if(!is_leaf) return northWest->isCorrect() &&
@@ -263,7 +263,7 @@ public:
 	{
 		for(int n = 0; n < size; n++) {
 			// Check whether point is erroneous
-			double* point = data + index[n] * QT_NO_DIMS;
+			T* point = data + index[n] * QT_NO_DIMS;
 			if(!boundary.containsPoint(point)) {
 
 				// Remove erroneous point
@@ -311,15 +311,17 @@ public:
 		                             southEast->getDepth()));
 	}
 
-	// Compute non-edge forces using Barnes-Hut algorithm
-	void computeNonEdgeForces(int point_index, double theta, double neg_f[], double* sum_Q)
+	// Compute non-edge forces using Barnes-Hut algorithm, safe to be called
+	// concurrently for different points as the tree is only read
+	void computeNonEdgeForces(int point_index, double theta, T neg_f[], double* sum_Q) const
 	{
 
 		// Make sure that we spend no time on empty nodes or self-interactions
 		if(cum_size == 0 || (is_leaf && size == 1 && index[0] == point_index)) return;
 
 		// Compute distance between point and center-of-mass
-		double D = .0;
+		T buff[QT_NO_DIMS];
+		T D = .0;
 		int ind = point_index * QT_NO_DIMS;
 		for(int d = 0; d < QT_NO_DIMS; d++) buff[d]  = data[ind + d];
 		for(int d = 0; d < QT_NO_DIMS; d++) buff[d] -= center_of_mass[d];
@@ -329,9 +331,9 @@ public:
 		if(is_leaf || std::max(boundary.hh, boundary.hw)/sqrt(D) < theta) {
 
 			// Compute and add t-SNE force between point and current node
-			double Q = 1.0 / (1.0 + D);
+			T Q = 1 / (1 + D);
 			*sum_Q += cum_size * Q;
-			double mult = cum_size * Q * Q;
+			T mult = cum_size * Q * Q;
 			for(int d = 0; d < QT_NO_DIMS; d++) neg_f[d] += mult * buff[d];
 		}
 		else {
@@ -344,23 +346,23 @@ public:
 		}
 	}
 
-	// Computes edge forces
-	void computeEdgeForces(int* row_P, int* col_P, double* val_P, int N, double* pos_f)
+	// Computes edge forces, rows of the graph in parallel
+	void computeEdgeForces(int* row_P, int* col_P, T* val_P, int N, T* pos_f) const
 	{
 		// Loop over all edges in the graph
-		int ind1, ind2;
-		double D;
+#pragma omp parallel for schedule(dynamic,256)
 		for(int n = 0; n < N; n++) {
-			ind1 = n * QT_NO_DIMS;
+			T buff[QT_NO_DIMS];
+			int ind1 = n * QT_NO_DIMS;
 			for(int i = row_P[n]; i < row_P[n + 1]; i++) {
 
 				// Compute pairwise distance and Q-value
-				D = .0;
-				ind2 = col_P[i] * QT_NO_DIMS;
+				T D = .0;
+				int ind2 = col_P[i] * QT_NO_DIMS;
 				for(int d = 0; d < QT_NO_DIMS; d++) buff[d]  = data[ind1 + d];
 				for(int d = 0; d < QT_NO_DIMS; d++) buff[d] -= data[ind2 + d];
 				for(int d = 0; d < QT_NO_DIMS; d++) D += buff[d] * buff[d];
-				D = val_P[i] / (1.0 + D);
+				D = val_P[i] / (1 + D);
 
 				// Sum positive force
 				for(int d = 0; d < QT_NO_DIMS; d++) pos_f[ind1 + d] += D * buff[d];
@@ -379,7 +381,7 @@ public:
 		if(is_leaf) {
 			printf("Leaf node; data = [");
 			for(int i = 0; i < size; i++) {
-				double* point = data + index[i] * QT_NO_DIMS;
+				T* point = data + index[i] * QT_NO_DIMS;
 				for(int d = 0; d < QT_NO_DIMS; d++) printf("%f, ", point[d]);
 				printf(" (index = %d)", index[i]);
 				if(i < size - 1) printf("\n");
@@ -402,7 +404,7 @@ private:
 	QuadTree(const QuadTree&);
 	QuadTree& operator=(const QuadTree&);
 
-	void init(QuadTree* inp_parent, double* inp_data, double inp_x, double inp_y, double inp_hw, double inp_hh)
+	void init(QuadTree* inp_parent, T* inp_data, double inp_x, double inp_y, double inp_hw, double inp_hh)
 	{
 		parent = inp_parent;
 		data = inp_data;
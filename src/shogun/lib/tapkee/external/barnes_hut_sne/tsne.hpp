@@ -35,6 +35,7 @@
 /* Tapkee includes */
 #include <shogun/lib/tapkee/utils/logging.hpp>
 #include <shogun/lib/tapkee/utils/time.hpp>
+#include <shogun/lib/tapkee/parameters/context.hpp>
 #include <shogun/lib/tapkee/external/barnes_hut_sne/quadtree.hpp>
 #include <shogun/lib/tapkee/external/barnes_hut_sne/vptree.hpp>
 /* End of Tapkee includes */
@@ -45,6 +46,8 @@
 #include <stdio.h>
 #include <cstring>
 #include <time.h>
+#include <vector>
+#include <sstream>
 
 //! Namespace containing implementation of t-SNE algorithm
 namespace tsne
@@ -55,7 +58,22 @@ static inline double sign(double x) { return (x == .0 ? .0 : (x < .0 ? -1.0 : 1.
 class TSNE
 {
 public:
-	void run(double* X, int N, int D, double* Y, int no_dims, double perplexity, double theta)
+	/** Embeds N vectors of dimension D stored in X into Y, with the
+	 * exact algorithm if theta is zero and with Barnes-Hut-SNE otherwise.
+	 *
+	 * All the phases (input similarities, neighbors search and both the
+	 * attractive and repulsive forces) are computed in parallel. The
+	 * Barnes-Hut gradient may be computed in single precision, which
+	 * halves the memory traffic of the optimization.
+	 *
+	 * Progress is reported through the context, which is checked for
+	 * cancellation every iteration: the embedding obtained so far is
+	 * kept then. Optimization also stops early once the norm of the
+	 * gradient drops below min_gradient_norm.
+	 */
+	void run(double* X, int N, int D, double* Y, int no_dims, double perplexity, double theta,
+	         bool single_precision=false, double min_gradient_norm=.0,
+	         const tapkee::tapkee_internal::Context* context=NULL)
 	{
 		// Determine whether we are using an exact algorithm
 		bool exact = (theta == .0) ? true : false;
@@ -64,26 +82,10 @@ public:
 		else
 			tapkee::LoggingSingleton::instance().message_info("Using Barnes-Hut-SNE algorithm");
 
-		// Set learning parameters
-		float total_time = .0;
-		clock_t start, end;
-		int max_iter = 1000, stop_lying_iter = 250, mom_switch_iter = 250;
-		double momentum = .5, final_momentum = .8;
-		double eta = 200.0;
-
-		// Allocate some memory
-		double* dY    = (double*) malloc(N * no_dims * sizeof(double));
-		double* uY    = (double*) malloc(N * no_dims * sizeof(double));
-		double* gains = (double*) malloc(N * no_dims * sizeof(double));
-		if(dY == NULL || uY == NULL || gains == NULL) { printf("Memory allocation failed!\n"); exit(1); }
-		for(int i = 0; i < N * no_dims; i++)    uY[i] =  .0;
-		for(int i = 0; i < N * no_dims; i++) gains[i] = 1.0;
-
 		// Normalize input data (to prevent numerical problems)
-		double* P=NULL; int* row_P; int* col_P; double* val_P;
+		double* P=NULL; int* row_P=NULL; int* col_P=NULL; double* val_P=NULL;
 		{
-			tapkee::tapkee_internal::timed_context context("Input similarities computation");
-			start = clock();
+			tapkee::tapkee_internal::timed_context context_timer("Input similarities computation");
 			zeroMean(X, N, D);
 			double max_X = .0;
 			for(int i = 0; i < N * D; i++) {
@@ -124,72 +126,24 @@ public:
 				for(int i = 0; i < row_P[N]; i++) val_P[i] /= sum_P;
 			}
 
-			// Lie about the P-values
-			if(exact) { for(int i = 0; i < N * N; i++)        P[i] *= 12.0; }
-			else {      for(int i = 0; i < row_P[N]; i++) val_P[i] *= 12.0; }
-
 			// Initialize solution (randomly)
 			for(int i = 0; i < N * no_dims; i++) Y[i] = tapkee::gaussian_random() * .0001;
 		}
 
 		{
-			tapkee::tapkee_internal::timed_context context("Main t-SNE loop");
-			for(int iter = 0; iter < max_iter; iter++) {
-
-				// Compute (approximate) gradient
-				if(exact) computeExactGradient(P, Y, N, no_dims, dY);
-				else computeGradient(P, row_P, col_P, val_P, Y, N, no_dims, dY, theta);
-
-				// Update gains
-				for(int i = 0; i < N * no_dims; i++) gains[i] = (sign(dY[i]) != sign(uY[i])) ? (gains[i] + .2) : (gains[i] * .8);
-				for(int i = 0; i < N * no_dims; i++) if(gains[i] < .01) gains[i] = .01;
-
-				// Perform gradient update (with momentum and gains)
-				for(int i = 0; i < N * no_dims; i++) uY[i] = momentum * uY[i] - eta * gains[i] * dY[i];
-				for(int i = 0; i < N * no_dims; i++)  Y[i] = Y[i] + uY[i];
-
-				// Make solution zero-mean
-				zeroMean(Y, N, no_dims);
-
-				// Stop lying about the P-values after a while, and switch momentum
-				if(iter == stop_lying_iter) {
-					if(exact) { for(int i = 0; i < N * N; i++)        P[i] /= 12.0; }
-					else      { for(int i = 0; i < row_P[N]; i++) val_P[i] /= 12.0; }
-				}
-				if(iter == mom_switch_iter) momentum = final_momentum;
-
-				// Print out progress
-				/*
-				if((iter > 0) && ((iter % 50 == 0) || (iter == max_iter - 1))) {
-					end = clock();
-					double C = .0;
-					if(exact) C = evaluateError(P, Y, N);
-					else      C = evaluateError(row_P, col_P, val_P, Y, N, theta);  // doing approximate computation here!
-					if(iter == 0)
-					{
-						//printf("Iteration %d: error is %f\n", iter + 1, C);
-					}
-					else
-					{
-						total_time += (float) (end - start) / CLOCKS_PER_SEC;
-						//printf("Iteration %d: error is %f (50 iterations in %4.2f seconds)\n", iter, C, (float) (end - start) / CLOCKS_PER_SEC);
-					}
-					start = clock();
-				}
-				*/
-			}
-			end = clock(); total_time += (float) (end - start) / CLOCKS_PER_SEC;
+			tapkee::tapkee_internal::timed_context context_timer("Main t-SNE loop");
+			if (single_precision && !exact)
+				optimize<float>(P, row_P, col_P, val_P, Y, N, no_dims, theta, min_gradient_norm, context);
+			else
+				optimize<double>(P, row_P, col_P, val_P, Y, N, no_dims, theta, min_gradient_norm, context);
+		}
 
-			// Clean up memory
-			free(dY);
-			free(uY);
-			free(gains);
-			if(exact) free(P);
-			else {
-				free(row_P); row_P = NULL;
-				free(col_P); col_P = NULL;
-				free(val_P); val_P = NULL;
-			}
+		// Clean up memory
+		if(exact) free(P);
+		else {
+			free(row_P); row_P = NULL;
+			free(col_P); col_P = NULL;
+			free(val_P); val_P = NULL;
 		}
 	}
 
@@ -281,123 +235,204 @@ public:
 
 private:
 
-	void computeGradient(double* /*P*/, int* inp_row_P, int* inp_col_P, double* inp_val_P, double* Y, int N, int D, double* dC, double theta)
+	template <typename T>
+	void optimize(double* P, int* row_P, int* col_P, double* inp_val_P, double* inp_Y,
+	              int N, int no_dims, double theta, double min_gradient_norm,
+	              const tapkee::tapkee_internal::Context* context)
 	{
-		// Construct quadtree on current map
-		QuadTree* tree = new QuadTree(Y, N);
+		bool exact = (P != NULL);
+
+		// Set learning parameters
+		int max_iter = 1000, stop_lying_iter = 250, mom_switch_iter = 250;
+		T momentum = .5, final_momentum = .8;
+		T eta = 200.0;
+
+		// Working copies in the precision of the optimization
+		std::vector<T> Y(inp_Y, inp_Y + N * no_dims);
+		std::vector<T> dY(N * no_dims);
+		std::vector<T> uY(N * no_dims, .0);
+		std::vector<T> gains(N * no_dims, 1.0);
+		std::vector<T> val_P;
+		if(!exact) val_P.assign(inp_val_P, inp_val_P + row_P[N]);
+
+		// Lie about the P-values
+		if(exact) { for(int i = 0; i < N * N; i++)        P[i] *= 12.0; }
+		else {      for(int i = 0; i < row_P[N]; i++) val_P[i] *= 12.0; }
+
+		for(int iter = 0; iter < max_iter; iter++) {
+
+			// Compute (approximate) gradient
+			if(exact) computeExactGradient(P, &Y[0], N, no_dims, &dY[0]);
+			else computeGradient(row_P, col_P, &val_P[0], &Y[0], N, no_dims, &dY[0], theta);
+
+			// Update gains and perform gradient update (with momentum and gains)
+			double gradient_norm = .0;
+#pragma omp parallel for reduction(+:gradient_norm)
+			for(int i = 0; i < N * no_dims; i++) {
+				gains[i] = (sign(dY[i]) != sign(uY[i])) ? (gains[i] + .2) : (gains[i] * .8);
+				if(gains[i] < .01) gains[i] = .01;
+				uY[i] = momentum * uY[i] - eta * gains[i] * dY[i];
+				Y[i] = Y[i] + uY[i];
+				gradient_norm += dY[i] * dY[i];
+			}
+			gradient_norm = sqrt(gradient_norm);
+
+			// Make solution zero-mean
+			zeroMean(&Y[0], N, no_dims);
 
-		// Compute all terms required for t-SNE gradient
+			// Stop lying about the P-values after a while, and switch momentum
+			if(iter == stop_lying_iter) {
+				if(exact) { for(int i = 0; i < N * N; i++)        P[i] /= 12.0; }
+				else      { for(int i = 0; i < row_P[N]; i++) val_P[i] /= 12.0; }
+			}
+			if(iter == mom_switch_iter) momentum = final_momentum;
+
+			// Print out progress
+			if(context) context->report_progress((double) (iter + 1) / max_iter);
+			if(tapkee::LoggingSingleton::instance().is_debug_enabled() &&
+			   ((iter > 0) && ((iter % 50 == 0) || (iter == max_iter - 1)))) {
+				double C = .0;
+				if(exact) C = evaluateError(P, &Y[0], N);
+				else      C = evaluateError(row_P, col_P, &val_P[0], &Y[0], N, theta);  // doing approximate computation here!
+				std::stringstream ss;
+				ss << "Iteration " << iter << ": error is " << C << ", gradient norm is " << gradient_norm;
+				tapkee::LoggingSingleton::instance().message_debug(ss.str());
+			}
+
+			// Stop early when converged (only once the P-values are not exaggerated) or cancelled
+			if(iter > stop_lying_iter && gradient_norm < min_gradient_norm) {
+				std::stringstream ss;
+				ss << "t-SNE converged after " << iter + 1 << " iterations";
+				tapkee::LoggingSingleton::instance().message_info(ss.str());
+				break;
+			}
+			if(context && context->is_cancelled()) {
+				std::stringstream ss;
+				ss << "t-SNE cancelled after " << iter + 1 << " iterations";
+				tapkee::LoggingSingleton::instance().message_warning(ss.str());
+				break;
+			}
+		}
+
+		for(int i = 0; i < N * no_dims; i++) inp_Y[i] = Y[i];
+	}
+
+	template <typename T>
+	void computeGradient(int* inp_row_P, int* inp_col_P, T* inp_val_P, T* Y, int N, int D, T* dC, double theta)
+	{
+		// Construct quadtree on current map
+		QuadTree<T> tree(Y, N);
+
+		// Compute all terms required for t-SNE gradient, every point
+		// accumulates its own forces and the normalization is summed
+		// per thread
+		std::vector<T> pos_f(N * D, .0);
+		std::vector<T> neg_f(N * D, .0);
+		tree.computeEdgeForces(inp_row_P, inp_col_P, inp_val_P, N, &pos_f[0]);
 		double sum_Q = .0;
-		double* pos_f = (double*) calloc(N * D, sizeof(double));
-		double* neg_f = (double*) calloc(N * D, sizeof(double));
-		if(pos_f == NULL || neg_f == NULL) { printf("Memory allocation failed!\n"); exit(1); }
-		tree->computeEdgeForces(inp_row_P, inp_col_P, inp_val_P, N, pos_f);
-		for(int n = 0; n < N; n++) tree->computeNonEdgeForces(n, theta, neg_f + n * D, &sum_Q);
+#pragma omp parallel for reduction(+:sum_Q) schedule(dynamic,256)
+		for(int n = 0; n < N; n++) {
+			double point_sum_Q = .0;
+			tree.computeNonEdgeForces(n, theta, &neg_f[n * D], &point_sum_Q);
+			sum_Q += point_sum_Q;
+		}
 
 		// Compute final t-SNE gradient
+#pragma omp parallel for
 		for(int i = 0; i < N * D; i++) {
 			dC[i] = pos_f[i] - (neg_f[i] / sum_Q);
 		}
-		free(pos_f);
-		free(neg_f);
-		delete tree;
 	}
 
-	void computeExactGradient(double* P, double* Y, int N, int D, double* dC)
+	template <typename T>
+	void computeExactGradient(double* P, T* Y, int N, int D, T* dC)
 	{
-		// Make sure the current gradient contains zeros
-		for(int i = 0; i < N * D; i++) dC[i] = 0.0;
-
-		// Compute the squared Euclidean distance matrix
-		double* DD = (double*) malloc(N * N * sizeof(double));
-		if(DD == NULL) { printf("Memory allocation failed!\n"); exit(1); }
-		computeSquaredEuclideanDistance(Y, N, D, DD);
-
 		// Compute Q-matrix and normalization sum
-		double* Q    = (double*) malloc(N * N * sizeof(double));
-		if(Q == NULL) { printf("Memory allocation failed!\n"); exit(1); }
+		std::vector<T> Q(N * N, .0);
 		double sum_Q = .0;
+#pragma omp parallel for reduction(+:sum_Q)
 		for(int n = 0; n < N; n++) {
 			for(int m = 0; m < N; m++) {
 				if(n != m) {
-					Q[n * N + m] = 1 / (1 + DD[n * N + m]);
+					T DD = .0;
+					for(int d = 0; d < D; d++) DD += (Y[n * D + d] - Y[m * D + d]) * (Y[n * D + d] - Y[m * D + d]);
+					Q[n * N + m] = 1 / (1 + DD);
 					sum_Q += Q[n * N + m];
 				}
 			}
 		}
 
 		// Perform the computation of the gradient
+#pragma omp parallel for
 		for(int n = 0; n < N; n++) {
+			for(int d = 0; d < D; d++) dC[n * D + d] = 0.0;
 			for(int m = 0; m < N; m++) {
 				if(n != m) {
-					double mult = (P[n * N + m] - (Q[n * N + m] / sum_Q)) * Q[n * N + m];
+					T mult = (P[n * N + m] - (Q[n * N + m] / sum_Q)) * Q[n * N + m];
 					for(int d = 0; d < D; d++) {
 						dC[n * D + d] += (Y[n * D + d] - Y[m * D + d]) * mult;
 					}
 				}
 			}
 		}
-
-		// Free memory
-		free(DD); DD = NULL;
-		free(Q);  Q  = NULL;
 	}
 
-	double evaluateError(double* P, double* Y, int N)
+	template <typename T>
+	double evaluateError(double* P, T* Y, int N)
 	{
-		// Compute the squared Euclidean distance matrix
-		double* DD = (double*) malloc(N * N * sizeof(double));
-		double* Q = (double*) malloc(N * N * sizeof(double));
-		if(DD == NULL || Q == NULL) { printf("Memory allocation failed!\n"); exit(1); }
-		computeSquaredEuclideanDistance(Y, N, 2, DD);
+		const int NO_DIMS = 2;
 
 		// Compute Q-matrix and normalization sum
+		std::vector<double> Q(N * N);
 		double sum_Q = DBL_MIN;
+#pragma omp parallel for reduction(+:sum_Q)
 		for(int n = 0; n < N; n++) {
 			for(int m = 0; m < N; m++) {
 				if(n != m) {
-					Q[n * N + m] = 1 / (1 + DD[n * N + m]);
+					double DD = .0;
+					for(int d = 0; d < NO_DIMS; d++) DD += (Y[n * NO_DIMS + d] - Y[m * NO_DIMS + d]) * (Y[n * NO_DIMS + d] - Y[m * NO_DIMS + d]);
+					Q[n * N + m] = 1 / (1 + DD);
 					sum_Q += Q[n * N + m];
 				}
 				else Q[n * N + m] = DBL_MIN;
 			}
 		}
-		for(int i = 0; i < N * N; i++) Q[i] /= sum_Q;
 
 		// Sum t-SNE error
 		double C = .0;
+#pragma omp parallel for reduction(+:C)
 		for(int n = 0; n < N; n++) {
 			for(int m = 0; m < N; m++) {
-				C += P[n * N + m] * log((P[n * N + m] + 1e-9) / (Q[n * N + m] + 1e-9));
+				C += P[n * N + m] * log((P[n * N + m] + 1e-9) / (Q[n * N + m] / sum_Q + 1e-9));
 			}
 		}
-
-		// Clean up memory
-		free(DD);
-		free(Q);
 		return C;
 	}
 
-	double evaluateError(int* row_P, int* col_P, double* val_P, double* Y, int N, double theta)
+	template <typename T>
+	double evaluateError(int* row_P, int* col_P, T* val_P, T* Y, int N, double theta)
 	{
 		// Get estimate of normalization term
 		const int QT_NO_DIMS = 2;
-		QuadTree* tree = new QuadTree(Y, N);
-		double buff[QT_NO_DIMS] = {.0, .0};
+		QuadTree<T> tree(Y, N);
 		double sum_Q = .0;
-		for(int n = 0; n < N; n++) tree->computeNonEdgeForces(n, theta, buff, &sum_Q);
+#pragma omp parallel for reduction(+:sum_Q)
+		for(int n = 0; n < N; n++) {
+			T buff[QT_NO_DIMS] = {.0, .0};
+			double point_sum_Q = .0;
+			tree.computeNonEdgeForces(n, theta, buff, &point_sum_Q);
+			sum_Q += point_sum_Q;
+		}
 
 		// Loop over all edges to compute t-SNE error
-		int ind1, ind2;
-		double C = .0, Q;
+		double C = .0;
+#pragma omp parallel for reduction(+:C)
 		for(int n = 0; n < N; n++) {
-			ind1 = n * QT_NO_DIMS;
+			int ind1 = n * QT_NO_DIMS;
 			for(int i = row_P[n]; i < row_P[n + 1]; i++) {
-				Q = .0;
-				ind2 = col_P[i] * QT_NO_DIMS;
-				for(int d = 0; d < QT_NO_DIMS; d++) buff[d]  = Y[ind1 + d];
-				for(int d = 0; d < QT_NO_DIMS; d++) buff[d] -= Y[ind2 + d];
-				for(int d = 0; d < QT_NO_DIMS; d++) Q += buff[d] * buff[d];
+				double Q = .0;
+				int ind2 = col_P[i] * QT_NO_DIMS;
+				for(int d = 0; d < QT_NO_DIMS; d++) Q += (Y[ind1 + d] - Y[ind2 + d]) * (Y[ind1 + d] - Y[ind2 + d]);
 				Q = (1.0 / (1.0 + Q)) / sum_Q;
 				C += val_P[i] * log((val_P[i] + FLT_MIN) / (Q + FLT_MIN));
 			}
@@ -405,11 +440,11 @@ private:
 		return C;
 	}
 
-	void zeroMean(double* X, int N, int D)
+	template <typename T>
+	void zeroMean(T* X, int N, int D)
 	{
 		// Compute data mean
-		double* mean = (double*) calloc(D, sizeof(double));
-		if(mean == NULL) { printf("Memory allocation failed!\n"); exit(1); }
+		std::vector<double> mean(D, .0);
 		for(int n = 0; n < N; n++) {
 			for(int d = 0; d < D; d++) {
 				mean[d] += X[n * D + d];
@@ -425,7 +460,6 @@ private:
 				X[n * D + d] -= mean[d];
 			}
 		}
-		free(mean); mean = NULL;
 	}
 
 	void computeGaussianPerplexity(double* X, int N, int D, double* P, double perplexity)
@@ -435,7 +469,8 @@ private:
 		if(DD == NULL) { printf("Memory allocation failed!\n"); exit(1); }
 		computeSquaredEuclideanDistance(X, N, D, DD);
 
-		// Compute the Gaussian kernel row by row
+		// Compute the Gaussian kernel row by row, rows in parallel
+#pragma omp parallel for schedule(dynamic,64)
 		for(int n = 0; n < N; n++) {
 
 			// Initialize some variables
@@ -507,8 +542,6 @@ private:
 		int* row_P = *_row_P;
 		int* col_P = *_col_P;
 		double* val_P = *_val_P;
-		double* cur_P = (double*) malloc((N - 1) * sizeof(double));
-		if(cur_P == NULL) { printf("Memory allocation failed!\n"); exit(1); }
 		row_P[0] = 0;
 		for(int n = 0; n < N; n++) row_P[n + 1] = row_P[n] + K;
 
@@ -518,77 +551,80 @@ private:
 		for(int n = 0; n < N; n++) obj_X[n] = DataPoint(D, n, X + n * D);
 		tree->create(obj_X);
 
-		// Loop over all points to find nearest neighbors
-		//printf("Building tree...\n");
-		std::vector<DataPoint> indices;
-		std::vector<double> distances;
-		for(int n = 0; n < N; n++) {
-
-			//if(n % 10000 == 0) printf(" - point %d of %d\n", n, N);
-
-			// Find nearest neighbors
-			indices.clear();
-			distances.clear();
-			tree->search(obj_X[n], K + 1, &indices, &distances);
-
-			// Initialize some variables for binary search
-			bool found = false;
-			double beta = 1.0;
-			double min_beta = -DBL_MAX;
-			double max_beta =  DBL_MAX;
-			double tol = 1e-5;
-
-			// Iterate until we found a good perplexity
-			int iter = 0; double sum_P;
-			while(!found && iter < 200) {
-
-				// Compute Gaussian kernel row
-				for(int m = 0; m < K; m++) cur_P[m] = exp(-beta * distances[m + 1]);
-
-				// Compute entropy of current row
-				sum_P = DBL_MIN;
-				for(int m = 0; m < K; m++) sum_P += cur_P[m];
-				double H = .0;
-				for(int m = 0; m < K; m++) H += beta * (distances[m + 1] * cur_P[m]);
-				H = (H / sum_P) + log(sum_P);
-
-				// Evaluate whether the entropy is within the tolerance level
-				double Hdiff = H - log(perplexity);
-				if(Hdiff < tol && -Hdiff < tol) {
-					found = true;
-				}
-				else {
-					if(Hdiff > 0) {
-						min_beta = beta;
-						if(max_beta == DBL_MAX || max_beta == -DBL_MAX)
-							beta *= 2.0;
-						else
-							beta = (beta + max_beta) / 2.0;
+		// Loop over all points to find nearest neighbors, every thread
+		// searching the shared tree and filling rows of its own points
+#pragma omp parallel
+		{
+			std::vector<DataPoint> indices;
+			std::vector<double> distances;
+			std::vector<double> cur_P(K);
+#pragma omp for schedule(dynamic,64)
+			for(int n = 0; n < N; n++) {
+
+				// Find nearest neighbors
+				indices.clear();
+				distances.clear();
+				tree->search(obj_X[n], K + 1, &indices, &distances);
+				for(int m = 0; m < K + 1; m++) distances[m] *= distances[m];
+
+				// Initialize some variables for binary search
+				bool found = false;
+				double beta = 1.0;
+				double min_beta = -DBL_MAX;
+				double max_beta =  DBL_MAX;
+				double tol = 1e-5;
+
+				// Iterate until we found a good perplexity
+				int iter = 0; double sum_P;
+				while(!found && iter < 200) {
+
+					// Compute Gaussian kernel row
+					for(int m = 0; m < K; m++) cur_P[m] = exp(-beta * distances[m + 1]);
+
+					// Compute entropy of current row
+					sum_P = DBL_MIN;
+					for(int m = 0; m < K; m++) sum_P += cur_P[m];
+					double H = .0;
+					for(int m = 0; m < K; m++) H += beta * (distances[m + 1] * cur_P[m]);
+					H = (H / sum_P) + log(sum_P);
+
+					// Evaluate whether the entropy is within the tolerance level
+					double Hdiff = H - log(perplexity);
+					if(Hdiff < tol && -Hdiff < tol) {
+						found = true;
 					}
 					else {
-						max_beta = beta;
-						if(min_beta == -DBL_MAX || min_beta == DBL_MAX)
-							beta /= 2.0;
-						else
-							beta = (beta + min_beta) / 2.0;
+						if(Hdiff > 0) {
+							min_beta = beta;
+							if(max_beta == DBL_MAX || max_beta == -DBL_MAX)
+								beta *= 2.0;
+							else
+								beta = (beta + max_beta) / 2.0;
+						}
+						else {
+							max_beta = beta;
+							if(min_beta == -DBL_MAX || min_beta == DBL_MAX)
+								beta /= 2.0;
+							else
+								beta = (beta + min_beta) / 2.0;
+						}
 					}
-				}
 
-				// Update iteration counter
-				iter++;
-			}
+					// Update iteration counter
+					iter++;
+				}
 
-			// Row-normalize current row of P and store in matrix
-			for(int m = 0; m < K; m++) cur_P[m] /= sum_P;
-			for(int m = 0; m < K; m++) {
-				col_P[row_P[n] + m] = indices[m + 1].index();
-				val_P[row_P[n] + m] = cur_P[m];
+				// Row-normalize current row of P and store in matrix
+				for(int m = 0; m < K; m++) cur_P[m] /= sum_P;
+				for(int m = 0; m < K; m++) {
+					col_P[row_P[n] + m] = indices[m + 1].index();
+					val_P[row_P[n] + m] = cur_P[m];
+				}
 			}
 		}
 
 		// Clean up memory
 		obj_X.clear();
-		free(cur_P);
 		delete tree;
 	}
 
@@ -771,7 +807,7 @@ private:
 		}
 		Eigen::Map<Eigen::MatrixXd> DD_map(DD,N,N);
 		Eigen::Map<Eigen::MatrixXd> X_map(X,D,N);
-		DD_map.noalias() = -2.0*X_map.transpose()*X_map;
+		DD_map.noalias() -= 2.0*X_map.transpose()*X_map;
 
 		//cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, N, N, D, -2.0, X, D, X, D, 1.0, DD, N);
 		free(dataSums); dataSums = NULL;
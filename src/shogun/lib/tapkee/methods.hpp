@@ -53,7 +53,7 @@ public:
 		eigen_method(), neighbors_method(), eigenshift(), traceshift(),
 		check_connectivity(), n_neighbors(), width(), timesteps(),
 		ratio(), max_iteration(), tolerance(), n_updates(), perplexity(),
-		theta(), squishing_rate(), global_strategy(), epsilon(), target_dimension(),
+		theta(), single_precision(), min_gradient_norm(), squishing_rate(), global_strategy(), epsilon(), target_dimension(),
 		n_vectors(0), current_dimension(0)
 	{
 		n_vectors = (end-begin);
@@ -80,6 +80,8 @@ public:
 		tolerance = parameters(keywords::spe_tolerance).checked().positive();
 		n_updates = parameters(keywords::spe_num_updates).checked().positive();
 		theta = parameters(keywords::sne_theta).checked().nonNegative();
+		single_precision = parameters(keywords::sne_single_precision);
+		min_gradient_norm = parameters(keywords::sne_min_gradient_norm).checked().nonNegative();
 		squishing_rate = parameters(keywords::squishing_rate);
 		global_strategy = parameters(keywords::spe_global_strategy);
 		epsilon = parameters(keywords::fa_epsilon).checked().nonNegative();
@@ -176,6 +178,8 @@ private:
 	Parameter n_updates;
 	Parameter perplexity;
 	Parameter theta;
+	Parameter single_precision;
+	Parameter min_gradient_norm;
 	Parameter squishing_rate;
 	Parameter global_strategy;
 	Parameter epsilon;
@@ -187,6 +191,17 @@ private:
 	template<class Distance>
 	Neighbors findNeighborsWith(Distance d)
 	{
+		NeighborsMethod method = neighbors_method;
+		if (is_feature_based(method))
+		{
+			if (is_dummy<FeaturesCallback>::value)
+				throw wrong_parameter_error(get_neighbors_method_name(method) +
+				                            " neighbors computation method requires the features callback");
+
+			DenseMatrix feature_matrix =
+				dense_matrix_from_features(features, current_dimension, begin, end);
+			return find_neighbors_of_features(method,begin,end,feature_matrix,n_neighbors,check_connectivity);
+		}
 		return find_neighbors(neighbors_method,begin,end,d,n_neighbors,check_connectivity);
 	}
 
@@ -489,7 +504,8 @@ private:
 
 		DenseMatrix embedding(static_cast<IndexType>(target_dimension),n_vectors);
 		tsne::TSNE tsne;
-		tsne.run(data.data(),n_vectors,current_dimension,embedding.data(),target_dimension,perplexity,theta);
+		tsne.run(data.data(),n_vectors,current_dimension,embedding.data(),target_dimension,perplexity,theta,
+		         single_precision,min_gradient_norm,&context);
 
 		return TapkeeOutput(embedding.transpose(), unimplementedProjectingFunction());
 	}
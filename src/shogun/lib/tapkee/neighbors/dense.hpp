@@ -0,0 +1,335 @@
+/* This software is distributed under BSD 3-clause license (see LICENSE file).
+ *
+ * Copyright (c) 2012-2013 Sergey Lisitsyn
+ */
+
+#ifndef TAPKEE_NEIGHBORS_DENSE_H_
+#define TAPKEE_NEIGHBORS_DENSE_H_
+
+/* Tapkee includes */
+#include <shogun/lib/tapkee/defines.hpp>
+#include <shogun/lib/tapkee/utils/time.hpp>
+/* End of Tapkee includes */
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <limits>
+
+namespace tapkee
+{
+namespace tapkee_internal
+{
+
+struct NeighborRecord
+{
+	NeighborRecord(ScalarType d, IndexType i) : distance(d), index(i), fresh(true) { }
+	inline bool operator<(const NeighborRecord& other) const
+	{
+		return distance < other.distance;
+	}
+	ScalarType distance;
+	IndexType index;
+	//! whether the record was added since the last NN-descent iteration
+	bool fresh;
+};
+
+//! Bounded max-heap keeping the k closest candidates seen so far
+class NeighborsHeap
+{
+public:
+	NeighborsHeap() : records(), capacity(0) { }
+	explicit NeighborsHeap(IndexType k) : records(), capacity(k)
+	{
+		records.reserve(k);
+	}
+
+	inline ScalarType worst() const
+	{
+		if (static_cast<IndexType>(records.size()) < capacity)
+			return std::numeric_limits<ScalarType>::max();
+		return records.front().distance;
+	}
+
+	inline bool contains(IndexType index) const
+	{
+		for (std::vector<NeighborRecord>::const_iterator it=records.begin(); it!=records.end(); ++it)
+		{
+			if (it->index == index)
+				return true;
+		}
+		return false;
+	}
+
+	inline bool push(ScalarType distance, IndexType index)
+	{
+		if (distance >= worst())
+			return false;
+
+		if (static_cast<IndexType>(records.size()) == capacity)
+		{
+			std::pop_heap(records.begin(),records.end());
+			records.pop_back();
+		}
+		records.push_back(NeighborRecord(distance,index));
+		std::push_heap(records.begin(),records.end());
+		return true;
+	}
+
+	//! indices of the candidates, closest first
+	LocalNeighbors sorted_indices() const
+	{
+		std::vector<NeighborRecord> sorted(records);
+		std::sort(sorted.begin(),sorted.end());
+		LocalNeighbors local_neighbors;
+		local_neighbors.reserve(sorted.size());
+		for (std::vector<NeighborRecord>::const_iterator it=sorted.begin(); it!=sorted.end(); ++it)
+			local_neighbors.push_back(it->index);
+		return local_neighbors;
+	}
+
+	std::vector<NeighborRecord> records;
+	IndexType capacity;
+};
+
+/** Exact neighbors search on feature vectors stored in columns of
+ * the data matrix. Squared euclidean distances are obtained block-wise
+ * as \f$ \|x\|^2 + \|y\|^2 - 2 X^\top Y \f$, so most of the work is
+ * done by (vectorized) matrix products. Blocks of query vectors are
+ * processed in parallel.
+ */
+inline Neighbors find_neighbors_blocked_impl(const DenseMatrix& data, IndexType k)
+{
+	timed_context context("Blocked brute force neighbors search");
+
+	const IndexType n_vectors = data.cols();
+	const IndexType block_size = 256;
+	const IndexType n_blocks = (n_vectors+block_size-1)/block_size;
+	const DenseVector norms = data.colwise().squaredNorm().transpose();
+
+	Neighbors neighbors(n_vectors);
+
+#pragma omp parallel shared(neighbors)
+	{
+		DenseMatrix products(block_size,block_size);
+		std::vector<NeighborsHeap> heaps;
+
+#pragma omp for schedule(dynamic)
+		for (IndexType query_block=0; query_block<n_blocks; ++query_block)
+		{
+			const IndexType query_begin = query_block*block_size;
+			const IndexType query_size = std::min(block_size,n_vectors-query_begin);
+			heaps.assign(query_size,NeighborsHeap(k));
+
+			for (IndexType reference_begin=0; reference_begin<n_vectors; reference_begin+=block_size)
+			{
+				const IndexType reference_size = std::min(block_size,n_vectors-reference_begin);
+				products.topLeftCorner(reference_size,query_size).noalias() =
+					data.middleCols(reference_begin,reference_size).transpose()*
+					data.middleCols(query_begin,query_size);
+
+				for (IndexType q=0; q<query_size; ++q)
+				{
+					const IndexType query = query_begin+q;
+					NeighborsHeap& heap = heaps[q];
+					for (IndexType r=0; r<reference_size; ++r)
+					{
+						const IndexType reference = reference_begin+r;
+						if (reference == query)
+							continue;
+						heap.push(norms(query)+norms(reference)-2*products(r,q),reference);
+					}
+				}
+			}
+
+			for (IndexType q=0; q<query_size; ++q)
+				neighbors[query_begin+q] = heaps[q].sorted_indices();
+		}
+	}
+
+	return neighbors;
+}
+
+/** Splits vectors of the range by random hyperplanes (each one
+ * separating two randomly chosen vectors of the range) until
+ * at most leaf_size vectors are left, storing the leaves' ranges.
+ */
+inline void random_projection_tree_leaves(const DenseMatrix& data, std::vector<IndexType>& order,
+                                          IndexType leaf_size,
+                                          std::vector<std::pair<IndexType,IndexType> >& leaves)
+{
+	std::vector<std::pair<IndexType,IndexType> > ranges;
+	ranges.push_back(std::make_pair(static_cast<IndexType>(0),static_cast<IndexType>(order.size())));
+	DenseVector normal(data.rows());
+	std::vector<IndexType> left, right;
+
+	while (!ranges.empty())
+	{
+		const IndexType begin = ranges.back().first;
+		const IndexType end = ranges.back().second;
+		ranges.pop_back();
+
+		if (end-begin <= leaf_size)
+		{
+			leaves.push_back(std::make_pair(begin,end));
+			continue;
+		}
+
+		const IndexType a = order[begin+uniform_random_index_bounded(end-begin)];
+		const IndexType b = order[begin+uniform_random_index_bounded(end-begin)];
+		normal = data.col(a)-data.col(b);
+		const ScalarType offset = normal.dot(data.col(a)+data.col(b))/2;
+
+		left.clear();
+		right.clear();
+		for (IndexType i=begin; i<end; ++i)
+		{
+			if (normal.dot(data.col(order[i])) > offset)
+				left.push_back(order[i]);
+			else
+				right.push_back(order[i]);
+		}
+		// duplicated vectors can't be separated by a hyperplane
+		// so the range is split in halves then
+		IndexType middle = begin+(end-begin)/2;
+		if (!left.empty() && !right.empty())
+		{
+			std::copy(left.begin(),left.end(),order.begin()+begin);
+			std::copy(right.begin(),right.end(),order.begin()+begin+left.size());
+			middle = begin+left.size();
+		}
+		ranges.push_back(std::make_pair(begin,middle));
+		ranges.push_back(std::make_pair(middle,end));
+	}
+}
+
+/** Approximate neighbors search on feature vectors stored in columns
+ * of the data matrix.
+ *
+ * Neighbors are initialized with the vectors sharing a leaf in any
+ * of a few random projection trees and refined by NN-descent
+ * (Dong, Charikar, Li: Efficient K-Nearest Neighbor Graph Construction
+ * for Generic Similarity Measures, 2011) which relies on a neighbor of
+ * a neighbor being likely a neighbor as well. Each iteration only joins
+ * pairs where at least one of the links is new. Vectors are processed in
+ * parallel, each thread only ever updating the neighbors of its vectors.
+ */
+inline Neighbors find_neighbors_nndescent_impl(const DenseMatrix& data, IndexType k,
+                                               IndexType n_trees=4, IndexType max_iteration=10,
+                                               ScalarType termination_ratio=0.001)
+{
+	timed_context context("Random projection forest and NN-descent based neighbors search");
+
+	const IndexType n_vectors = data.cols();
+	const IndexType leaf_size = std::max(2*(k+1),static_cast<IndexType>(16));
+	std::vector<NeighborsHeap> heaps(n_vectors,NeighborsHeap(k));
+
+	for (IndexType t=0; t<n_trees; ++t)
+	{
+		std::vector<IndexType> order(n_vectors);
+		for (IndexType i=0; i<n_vectors; ++i)
+			order[i] = i;
+
+		std::vector<std::pair<IndexType,IndexType> > leaves;
+		random_projection_tree_leaves(data,order,leaf_size,leaves);
+		const IndexType n_leaves = leaves.size();
+
+		// every vector lies in exactly one leaf of the tree
+#pragma omp parallel for shared(heaps,order,leaves) schedule(dynamic)
+		for (IndexType l=0; l<n_leaves; ++l)
+		{
+			for (IndexType i=leaves[l].first; i<leaves[l].second; ++i)
+			{
+				for (IndexType j=i+1; j<leaves[l].second; ++j)
+				{
+					const IndexType u = order[i];
+					const IndexType v = order[j];
+					const ScalarType d = (data.col(u)-data.col(v)).squaredNorm();
+					if (!heaps[u].contains(v))
+						heaps[u].push(d,v);
+					if (!heaps[v].contains(u))
+						heaps[v].push(d,u);
+				}
+			}
+		}
+	}
+
+	std::vector<LocalNeighbors> new_candidates(n_vectors), old_candidates(n_vectors);
+	std::vector<IndexType> n_new_links(n_vectors), n_old_links(n_vectors);
+	for (IndexType iteration=0; iteration<max_iteration; ++iteration)
+	{
+		for (IndexType i=0; i<n_vectors; ++i)
+		{
+			new_candidates[i].clear();
+			old_candidates[i].clear();
+			for (std::vector<NeighborRecord>::iterator it=heaps[i].records.begin();
+					it!=heaps[i].records.end(); ++it)
+			{
+				LocalNeighbors& candidates = it->fresh ? new_candidates[i] : old_candidates[i];
+				candidates.push_back(it->index);
+				it->fresh = false;
+			}
+			n_new_links[i] = new_candidates[i].size();
+			n_old_links[i] = old_candidates[i].size();
+		}
+		// reverse links, appended after the n_*_links forward ones
+		for (IndexType i=0; i<n_vectors; ++i)
+		{
+			for (IndexType j=0; j<n_new_links[i]; ++j)
+			{
+				LocalNeighbors& candidates = new_candidates[new_candidates[i][j]];
+				if (static_cast<IndexType>(candidates.size()) < 2*k &&
+				    std::find(candidates.begin(),candidates.end(),i) == candidates.end())
+					candidates.push_back(i);
+			}
+			for (IndexType j=0; j<n_old_links[i]; ++j)
+			{
+				LocalNeighbors& candidates = old_candidates[old_candidates[i][j]];
+				if (static_cast<IndexType>(candidates.size()) < 2*k &&
+				    std::find(candidates.begin(),candidates.end(),i) == candidates.end())
+					candidates.push_back(i);
+			}
+		}
+
+		IndexType n_updates = 0;
+#pragma omp parallel for shared(heaps,new_candidates,old_candidates) reduction(+:n_updates) schedule(dynamic,64)
+		for (IndexType i=0; i<n_vectors; ++i)
+		{
+			NeighborsHeap& heap = heaps[i];
+			for (int fresh=1; fresh>=0; --fresh)
+			{
+				const LocalNeighbors& links = fresh ? new_candidates[i] : old_candidates[i];
+				for (LocalNeighbors::const_iterator u=links.begin(); u!=links.end(); ++u)
+				{
+					// old links were already joined with old links of their neighbors
+					for (int fresh_of_neighbor=1; fresh_of_neighbor>=1-fresh; --fresh_of_neighbor)
+					{
+						const LocalNeighbors& candidates = fresh_of_neighbor ?
+							new_candidates[*u] : old_candidates[*u];
+						for (LocalNeighbors::const_iterator v=candidates.begin(); v!=candidates.end(); ++v)
+						{
+							if (*v == i || heap.contains(*v))
+								continue;
+							if (heap.push((data.col(i)-data.col(*v)).squaredNorm(),*v))
+								n_updates++;
+						}
+					}
+				}
+			}
+		}
+
+		if (n_updates <= termination_ratio*n_vectors*k)
+			break;
+	}
+
+	Neighbors neighbors(n_vectors);
+	for (IndexType i=0; i<n_vectors; ++i)
+		neighbors[i] = heaps[i].sorted_indices();
+
+	return neighbors;
+}
+
+}
+}
+
+#endif
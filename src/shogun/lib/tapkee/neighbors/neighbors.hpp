@@ -13,6 +13,7 @@
 #endif
 #include <shogun/lib/tapkee/neighbors/connected.hpp>
 #include <shogun/lib/tapkee/neighbors/vptree.hpp>
+#include <shogun/lib/tapkee/neighbors/dense.hpp>
 /* End of Tapkee includes */
 
 #include <vector>
@@ -189,6 +190,10 @@ Neighbors find_neighbors(NeighborsMethod method, const RandomAccessIterator& beg
 #ifdef TAPKEE_USE_LGPL_COVERTREE
 		case CoverTree: neighbors = find_neighbors_covertree_impl(begin,end,callback,k); break;
 #endif
+		case BlockedBrute:
+		case NNDescent:
+			throw wrong_parameter_error(get_neighbors_method_name(method) +
+			                            " neighbors computation method requires feature vectors");
 		default: break;
 	}
 
@@ -200,6 +205,41 @@ Neighbors find_neighbors(NeighborsMethod method, const RandomAccessIterator& beg
 	return neighbors;
 }
 
+inline bool is_feature_based(NeighborsMethod method)
+{
+	return (method == BlockedBrute) || (method == NNDescent);
+}
+
+template <class RandomAccessIterator>
+Neighbors find_neighbors_of_features(NeighborsMethod method, const RandomAccessIterator& begin,
+                                     const RandomAccessIterator& end, const DenseMatrix& feature_matrix,
+                                     IndexType k, bool check_connectivity)
+{
+	if (k > static_cast<IndexType>(end-begin-1))
+	{
+		LoggingSingleton::instance().message_warning("Number of neighbors is greater than number of objects to embed. "
+		                                             "Using greatest possible number of neighbors.");
+		k = static_cast<IndexType>(end-begin-1);
+	}
+	LoggingSingleton::instance().message_info("Using the " + get_neighbors_method_name(method) + " neighbors computation method.");
+	Neighbors neighbors;
+	switch (method)
+	{
+		case BlockedBrute: neighbors = find_neighbors_blocked_impl(feature_matrix,k); break;
+		case NNDescent: neighbors = find_neighbors_nndescent_impl(feature_matrix,k); break;
+		default:
+			throw wrong_parameter_error(get_neighbors_method_name(method) +
+			                            " neighbors computation method doesn't work on feature vectors");
+	}
+
+	if (check_connectivity)
+	{
+		if (!is_connected(begin,end,neighbors))
+			LoggingSingleton::instance().message_warning("The neighborhood graph is not connected.");
+	}
+	return neighbors;
+}
+
 } // End of namespace tapkee
 } // End of namespace tapkee_internal
 
@@ -32,7 +32,9 @@ const ParametersSet defaults = (
 	tapkee::keywords::cancel_function = tapkee::keywords::by_default,
 	tapkee::keywords::sne_perplexity = tapkee::keywords::by_default,
 	tapkee::keywords::squishing_rate = tapkee::keywords::by_default,
-	tapkee::keywords::sne_theta = tapkee::keywords::by_default);
+	tapkee::keywords::sne_theta = tapkee::keywords::by_default,
+	tapkee::keywords::sne_single_precision = tapkee::keywords::by_default,
+	tapkee::keywords::sne_min_gradient_norm = tapkee::keywords::by_default);
 
 }
 
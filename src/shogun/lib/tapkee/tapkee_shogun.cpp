@@ -22,6 +22,8 @@
 #define TAPKEE_USE_LGPL_COVERTREE
 #include <shogun/lib/tapkee/tapkee.hpp>
 #include <shogun/lib/tapkee/callbacks/pimpl_callbacks.hpp>
+#include <shogun/kernel/normalizer/IdentityKernelNormalizer.h>
+#include <shogun/lib/Signal.h>
 
 using namespace shogun;
 
@@ -69,6 +71,53 @@ struct ShogunFeatureVectorCallback
 };
 
 
+static void tapkee_progress(double x)
+{
+	SG_SPROGRESS(x, 0.0, 1.0)
+}
+
+static bool tapkee_cancel()
+{
+	return CSignal::cancel_computations();
+}
+
+/** Returns the dense features neighbors w.r.t. the kernel or distance
+ * (the kernel takes precedence as kernel based methods search neighbors
+ * with it) are the euclidean neighbors of, if there are such, or NULL.
+ * Neighbors can be searched on the feature matrix then.
+ */
+static CDotFeatures* get_euclidean_features(CKernel* kernel, CDistance* distance)
+{
+	CFeatures* lhs = NULL;
+	CFeatures* rhs = NULL;
+	if (kernel)
+	{
+		CKernelNormalizer* normalizer = kernel->get_normalizer();
+		bool identity = dynamic_cast<CIdentityKernelNormalizer*>(normalizer)!=NULL;
+		SG_UNREF(normalizer);
+		if (kernel->get_kernel_type()!=K_LINEAR || !identity)
+			return NULL;
+
+		lhs = kernel->get_lhs();
+		rhs = kernel->get_rhs();
+	}
+	else if (distance)
+	{
+		if (distance->get_distance_type()!=D_EUCLIDEAN)
+			return NULL;
+
+		lhs = distance->get_lhs();
+		rhs = distance->get_rhs();
+	}
+
+	bool dense = lhs && lhs==rhs && lhs->get_feature_class()==C_DENSE &&
+		lhs->get_feature_type()==F_DREAL;
+	SG_UNREF(lhs);
+	SG_UNREF(rhs);
+
+	return dense ? (CDotFeatures*)lhs : NULL;
+}
+
 CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_FOR_SHOGUN& parameters)
 {
 	tapkee::LoggingSingleton::instance().set_logger_impl(new ShogunLoggerImplementation);
@@ -77,7 +126,6 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 
 	pimpl_kernel_callback<CKernel> kernel_callback(parameters.kernel);
 	pimpl_distance_callback<CDistance> distance_callback(parameters.distance);
-	ShogunFeatureVectorCallback features_callback(parameters.features);
 
 	tapkee::DimensionReductionMethod method;
 #ifdef HAVE_ARPACK
@@ -157,6 +205,25 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 			break;
 	}
 
+	// neighbors w.r.t. euclidean distance on dense features are
+	// searched on the feature matrix directly rather than through
+	// the callbacks, in parallel and optionally approximately
+	CDotFeatures* features = parameters.features;
+	CDotFeatures* euclidean_features =
+		get_euclidean_features(parameters.kernel, parameters.distance);
+	if (euclidean_features && (!features || features==euclidean_features))
+	{
+		features = euclidean_features;
+		neighbors_method = parameters.approximate_neighbors ?
+			tapkee::NNDescent : tapkee::BlockedBrute;
+	}
+	else if (parameters.approximate_neighbors)
+	{
+		SG_SWARNING("Approximate neighbors search requires euclidean distance "
+				"or linear kernel on dense real valued features, using exact search\n")
+	}
+	ShogunFeatureVectorCallback features_callback(features);
+
 	std::vector<int32_t> indices(N);
 	for (size_t i=0; i<N; i++)
 		indices[i] = i;
@@ -178,11 +245,23 @@ CDenseFeatures<float64_t>* shogun::tapkee_embed(const shogun::TAPKEE_PARAMETERS_
 		 tapkee::keywords::fa_epsilon = parameters.fa_epsilon,
 		 tapkee::keywords::sne_perplexity = parameters.sne_perplexity,
 		 tapkee::keywords::sne_theta = parameters.sne_theta,
+		 tapkee::keywords::sne_single_precision = parameters.sne_single_precision,
+		 tapkee::keywords::sne_min_gradient_norm = parameters.sne_min_gradient_norm,
+		 tapkee::keywords::progress_function = tapkee_progress,
+		 tapkee::keywords::cancel_function = tapkee_cancel,
 		 tapkee::keywords::squishing_rate = parameters.squishing_rate
 		 );
 
-	tapkee::TapkeeOutput output = tapkee::embed(indices.begin(),indices.end(),
-			kernel_callback,distance_callback,features_callback,parameters_set);
+	tapkee::TapkeeOutput output;
+	try
+	{
+		output = tapkee::embed(indices.begin(),indices.end(),
+				kernel_callback,distance_callback,features_callback,parameters_set);
+	}
+	catch (const tapkee::cancelled_exception&)
+	{
+		SG_SERROR("Embedding was cancelled\n")
+	}
 	tapkee::DenseMatrix result_embedding = output.embedding;
 	// destroy projecting function
 	output.projection.clear();
@@ -53,7 +53,9 @@ struct TAPKEE_PARAMETERS_FOR_SHOGUN
 		gaussian_kernel_width(1.0), spe_tolerance(1e-5),
 		spe_global_strategy(false), max_iteration(100),
 		fa_epsilon(1e-5), sne_theta(0.5),
-		sne_perplexity(30.0), squishing_rate(0.99),
+		sne_perplexity(30.0), sne_single_precision(false),
+		sne_min_gradient_norm(0.0), squishing_rate(0.99),
+		approximate_neighbors(false),
 		kernel(NULL), distance(NULL), features(NULL)
 	{
 	}
@@ -71,7 +73,13 @@ struct TAPKEE_PARAMETERS_FOR_SHOGUN
 	float64_t fa_epsilon;
 	float64_t sne_theta;
 	float64_t sne_perplexity;
+	bool sne_single_precision;
+	float64_t sne_min_gradient_norm;
 	float64_t squishing_rate;
+	/** whether the neighborhood graph may be computed approximately,
+	 * only has effect when neighbors are searched on dense features
+	 */
+	bool approximate_neighbors;
 	CKernel* kernel;
 	CDistance* distance;
 	CDotFeatures* features;
@@ -10,6 +10,8 @@
 
 #include <shogun/machine/BaggingMachine.h>
 #include <shogun/base/Parameter.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/Random.h>
 
 using namespace shogun;
 
@@ -121,51 +123,84 @@ bool CBaggingMachine::train_machine(CFeatures* data)
 	SG_UNREF(m_oob_indices);
 	m_oob_indices = new CDynamicObjectArray();
 
-	/*
-	  TODO: enable multi-threaded learning. This requires views support
-		on CFeatures
-	#pragma omp parallel for num_threads(parallel->get_num_threads())
-	*/
+	/* every bag draws its vectors with a generator of its own, so that the
+	 * bags do not depend on the number of threads used for training */
+	SGVector<uint32_t> seeds(m_num_bags);
 	for (int32_t i = 0; i < m_num_bags; ++i)
+		seeds[i] = (uint32_t) CMath::random();
+
+	int32_t num_concurrent = parallel->get_num_threads();
+	if (m_max_concurrent_bags > 0)
+		num_concurrent = CMath::min(num_concurrent, m_max_concurrent_bags);
+	num_concurrent = CMath::min(num_concurrent, m_num_bags);
+
+	CMachine** machines = SG_MALLOC(CMachine*, num_concurrent);
+	CFeatures** features = SG_MALLOC(CFeatures*, num_concurrent);
+	SGVector<index_t>* idx = new SGVector<index_t>[num_concurrent];
+
+	for (int32_t first = 0; first < m_num_bags; first += num_concurrent)
 	{
-		CMachine* c = dynamic_cast<CMachine*>(m_machine->clone());
-		ASSERT(c != NULL);
-		SGVector<index_t> idx(m_bag_size);
-		idx.random(0, m_features->get_num_vectors()-1);
-		m_labels->add_subset(idx);
-		/* TODO:
-		   if it's a binary labeling ensure that
-		   there's always samples of both classes
-		if ((m_labels->get_label_type() == LT_BINARY))
+		int32_t num = CMath::min(num_concurrent, m_num_bags - first);
+
+		/* cloning and creating the views touches shared objects, so it
+		 * is done here; the views do not share subsets with each other */
+		for (int32_t i = 0; i < num; ++i)
 		{
-			while (true) {
-				if (!m_labels->ensure_valid()) {
-					m_labels->remove_subset();
-					idx.random(0, m_features->get_num_vectors());
-					m_labels->add_subset(idx);
-					continue;
-				}
-				break;
-			}
+			machines[i] = dynamic_cast<CMachine*>(m_machine->clone());
+			ASSERT(machines[i] != NULL);
+			idx[i] = get_bag_indices(seeds[first + i]);
+			/* TODO:
+			   if it's a binary labeling ensure that
+			   there's always samples of both classes
+			 */
+			CLabels* labels = dynamic_cast<CLabels*>(m_labels->clone());
+			ASSERT(labels != NULL);
+			labels->add_subset(idx[i]);
+			machines[i]->set_labels(labels);
+			SG_UNREF(labels);
+
+			features[i] = m_features->duplicate();
+			SG_REF(features[i]);
+			features[i]->add_subset(idx[i]);
+		}
+
+		#pragma omp parallel for num_threads(num) schedule(dynamic, 1)
+		for (int32_t i = 0; i < num; ++i)
+			machines[i]->train(features[i]);
+
+		for (int32_t i = 0; i < num; ++i)
+		{
+			SG_UNREF(features[i]);
+
+			// get out of bag indexes
+			CDynamicArray<index_t>* oob = get_oob_indices(idx[i]);
+			m_oob_indices->push_back(oob);
+
+			// add trained machine to bag array
+			m_bags->append_element(machines[i]);
+			SG_UNREF(machines[i]);
 		}
-		*/
-		m_features->add_subset(idx);
-		c->set_labels(m_labels);
-		c->train(m_features);
-		m_features->remove_subset();
-		m_labels->remove_subset();
-
-		// get out of bag indexes
-		CDynamicArray<index_t>* oob = get_oob_indices(idx);
-		m_oob_indices->push_back(oob);
-
-		// add trained machine to bag array
-		m_bags->append_element(c);
 	}
 
+	delete[] idx;
+	SG_FREE(features);
+	SG_FREE(machines);
+
 	return true;
 }
 
+SGVector<index_t> CBaggingMachine::get_bag_indices(uint32_t seed) const
+{
+	CRandom rng(seed);
+	int32_t num_vectors = m_features->get_num_vectors();
+
+	SGVector<index_t> idx(m_bag_size);
+	for (index_t i = 0; i < idx.vlen; ++i)
+		idx[i] = rng.random(0, num_vectors-1);
+
+	return idx;
+}
+
 void CBaggingMachine::register_parameters()
 {
 	SG_ADD((CSGObject**)&m_features, "features", "Train features for bagging",
@@ -179,6 +214,8 @@ void CBaggingMachine::register_parameters()
 			MS_NOT_AVAILABLE);
 	SG_ADD((CSGObject**)&m_oob_indices, "oob_indices",
 			"OOB indices for each machine", MS_NOT_AVAILABLE);
+	SG_ADD(&m_max_concurrent_bags, "max_concurrent_bags",
+			"Maximum number of bags trained concurrently", MS_NOT_AVAILABLE);
 }
 
 void CBaggingMachine::set_num_bags(int32_t num_bags)
@@ -201,6 +238,17 @@ int32_t CBaggingMachine::get_bag_size() const
 	return m_bag_size;
 }
 
+void CBaggingMachine::set_max_concurrent_bags(int32_t max_bags)
+{
+	REQUIRE(max_bags >= 0, "Maximum number of concurrent bags must not be negative\n");
+	m_max_concurrent_bags = max_bags;
+}
+
+int32_t CBaggingMachine::get_max_concurrent_bags() const
+{
+	return m_max_concurrent_bags;
+}
+
 CMachine* CBaggingMachine::get_machine() const
 {
 	SG_REF(m_machine);
@@ -225,6 +273,7 @@ void CBaggingMachine::init()
 	m_bag_size = 0;
 	m_all_oob_idx = SGVector<bool>();
 	m_oob_indices = NULL;
+	m_max_concurrent_bags = 0;
 }
 
 void CBaggingMachine::set_combination_rule(CCombinationRule* rule)
@@ -251,33 +300,44 @@ float64_t CBaggingMachine::get_oob_error(CEvaluation* eval) const
 	else
 		output.set_const(NAN);
 
-	/* TODO: add parallel support of applying the OOBs
-	  only possible when add_subset is thread-safe
-	#pragma omp parallel for num_threads(parallel->get_num_threads())
-	*/
-	for (index_t i = 0; i < m_bags->get_num_elements(); i++)
+	index_t num_bags = m_bags->get_num_elements();
+	CFeatures** features = SG_MALLOC(CFeatures*, num_bags);
+	SGVector<index_t>* oob = new SGVector<index_t>[num_bags];
+
+	/* every bag is applied to a view of the features of its own */
+	for (index_t i = 0; i < num_bags; i++)
 	{
-		CMachine* m = dynamic_cast<CMachine*>(m_bags->get_element(i));
 		CDynamicArray<index_t>* current_oob
 			= dynamic_cast<CDynamicArray<index_t>*>(m_oob_indices->get_element(i));
 
-		SGVector<index_t> oob(current_oob->get_array(), current_oob->get_num_elements(), false);
-		oob.display_vector();
-		m_features->add_subset(oob);
+		oob[i] = SGVector<index_t>(current_oob->get_num_elements());
+		memcpy(oob[i].vector, current_oob->get_array(), sizeof(index_t)*oob[i].vlen);
+		SG_UNREF(current_oob);
+
+		features[i] = m_features->duplicate();
+		SG_REF(features[i]);
+		features[i]->add_subset(oob[i]);
+	}
 
-		CLabels* l = m->apply(m_features);
+	#pragma omp parallel for num_threads(parallel->get_num_threads()) schedule(dynamic, 1)
+	for (index_t i = 0; i < num_bags; i++)
+	{
+		CMachine* m = dynamic_cast<CMachine*>(m_bags->get_element(i));
+		CLabels* l = m->apply(features[i]);
 		SGVector<float64_t> lv = l->get_values();
 
 		// assign the values in the matrix (NAN) that are in-bag!
-		for (index_t j = 0; j < oob.vlen; j++)
-			output(oob[j], i) = lv[j];
+		for (index_t j = 0; j < oob[i].vlen; j++)
+			output(oob[i][j], i) = lv[j];
 
-		m_features->remove_subset();
-		SG_UNREF(current_oob);
 		SG_UNREF(m);
 		SG_UNREF(l);
 	}
-	output.display_matrix();
+
+	for (index_t i = 0; i < num_bags; i++)
+		SG_UNREF(features[i]);
+	SG_FREE(features);
+	delete[] oob;
 
 	DynArray<index_t> idx;
 	for (index_t i = 0; i < m_features->get_num_vectors(); i++)
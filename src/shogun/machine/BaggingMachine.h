@@ -100,6 +100,25 @@ namespace shogun
 			 */
 			CCombinationRule* get_combination_rule() const;
 
+			/**
+			 * Set the maximum number of bags that are trained concurrently.
+			 * Every bag in training holds its own view of the features, a
+			 * copy of the labels and the machine being trained, so this
+			 * bounds the memory used during training.
+			 *
+			 * @param max_bags maximum number of bags in training at once,
+			 * 0 to use as many as there are threads
+			 */
+			void set_max_concurrent_bags(int32_t max_bags);
+
+			/**
+			 * Get the maximum number of bags that are trained concurrently
+			 *
+			 * @return maximum number of bags in training at once, 0 if
+			 * only limited by the number of threads
+			 */
+			int32_t get_max_concurrent_bags() const;
+
 			/** get classifier type
 			 *
 			 * @return classifier type CT_BAGGING
@@ -143,6 +162,14 @@ namespace shogun
 
 			void clear_oob_indicies();
 
+			/**
+			 * draw the indices of a bag with replacement
+			 *
+			 * @param seed seed of the random generator used for this bag
+			 * @return indices of the feature vectors in the bag
+			 */
+			SGVector<index_t> get_bag_indices(uint32_t seed) const;
+
 		private:
 			/** bags array */
 			CDynamicObjectArray* m_bags;
@@ -167,6 +194,9 @@ namespace shogun
 
 			/** array of oob indices */
 			CDynamicObjectArray* m_oob_indices;
+
+			/** maximum number of bags trained concurrently */
+			int32_t m_max_concurrent_bags;
 	};
 }
 
@@ -168,6 +168,96 @@ class CLinearMulticlassMachine : public CMulticlassMachine
 		 */
 		virtual void store_model_features() {}
 
+		/** clone the base machine without its features and labels, and
+		 * give it a view of the features with the subset of its own
+		 *
+		 * @param subset subset of the training data, may be empty
+		 * @return untrained linear machine or NULL if cloning failed
+		 */
+		virtual CMachine* get_machine_for_parallel_train(SGVector<index_t> subset)
+		{
+			CLinearMachine* machine=(CLinearMachine*) m_machine;
+			CLabels* labels=machine->get_labels();
+			CDotFeatures* features=machine->get_features();
+
+			/* detach data, so that only the machine itself is cloned */
+			machine->set_labels(NULL);
+			machine->set_features(NULL);
+			CLinearMachine* copy=(CLinearMachine*) machine->clone();
+			machine->set_features(features);
+			machine->set_labels(labels);
+			SG_UNREF(features);
+			SG_UNREF(labels);
+
+			if (!copy)
+				return NULL;
+
+			if (subset.vlen)
+			{
+				/* duplicates share the feature data, but subsets are not
+				 * shared between them */
+				CDotFeatures* view=(CDotFeatures*) m_features->duplicate();
+				view->add_subset(subset);
+				copy->set_features(view);
+			}
+			else
+				copy->set_features(m_features);
+
+			return copy;
+		}
+
+		/** compute the outputs of all machines in blocks of vectors, so
+		 * that a block stays in cache while all machines are applied to
+		 * it. Blocks are processed in parallel.
+		 *
+		 * @param outputs array receiving the outputs of every machine
+		 * @param num_machines number of machines
+		 */
+		virtual void get_all_submachine_outputs(CBinaryLabels** outputs,
+				int32_t num_machines)
+		{
+			ASSERT(m_features)
+			const int32_t block_size=256;
+			int32_t num_vectors=m_features->get_num_vectors();
+			int32_t num_blocks=(num_vectors+block_size-1)/block_size;
+
+			SGVector<float64_t>* w=new SGVector<float64_t>[num_machines];
+			SGVector<float64_t>* values=new SGVector<float64_t>[num_machines];
+			SGVector<float64_t> bias(num_machines);
+
+			for (int32_t j=0; j<num_machines; j++)
+			{
+				CLinearMachine* machine=(CLinearMachine*) m_machines->get_element(j);
+				w[j]=machine->get_w();
+				ASSERT(w[j].vlen==m_features->get_dim_feature_space())
+				bias[j]=machine->get_bias();
+				values[j]=SGVector<float64_t>(num_vectors);
+				SG_UNREF(machine);
+			}
+
+			#pragma omp parallel for num_threads(parallel->get_num_threads())
+			for (int32_t b=0; b<num_blocks; b++)
+			{
+				int32_t start=b*block_size;
+				int32_t end=CMath::min(start+block_size, num_vectors);
+
+				for (int32_t j=0; j<num_machines; j++)
+				{
+					for (int32_t i=start; i<end; i++)
+					{
+						values[j][i]=m_features->dense_dot(i, w[j].vector,
+								w[j].vlen)+bias[j];
+					}
+				}
+			}
+
+			for (int32_t j=0; j<num_machines; j++)
+				outputs[j]=new CBinaryLabels(values[j]);
+
+			delete[] values;
+			delete[] w;
+		}
+
 	protected:
 
 		/** features */
@@ -23,7 +23,7 @@ using namespace shogun;
 
 CMulticlassMachine::CMulticlassMachine()
 : CBaseMulticlassMachine(), m_multiclass_strategy(new CMulticlassOneVsRestStrategy()),
-	m_machine(NULL)
+	m_machine(NULL), m_max_concurrent_machines(0)
 {
 	SG_REF(m_multiclass_strategy);
 	register_parameters();
@@ -32,7 +32,8 @@ CMulticlassMachine::CMulticlassMachine()
 CMulticlassMachine::CMulticlassMachine(
 		CMulticlassStrategy *strategy,
 		CMachine* machine, CLabels* labs)
-: CBaseMulticlassMachine(), m_multiclass_strategy(strategy)
+: CBaseMulticlassMachine(), m_multiclass_strategy(strategy),
+	m_max_concurrent_machines(0)
 {
 	SG_REF(strategy);
 	set_labels(labs);
@@ -61,6 +62,8 @@ void CMulticlassMachine::register_parameters()
 {
 	SG_ADD((CSGObject**)&m_multiclass_strategy,"m_multiclass_type", "Multiclass strategy", MS_NOT_AVAILABLE);
 	SG_ADD((CSGObject**)&m_machine, "m_machine", "The base machine", MS_NOT_AVAILABLE);
+	SG_ADD(&m_max_concurrent_machines, "m_max_concurrent_machines",
+			"Maximum number of submachines trained concurrently", MS_NOT_AVAILABLE);
 }
 
 void CMulticlassMachine::init_strategy()
@@ -78,6 +81,13 @@ CBinaryLabels* CMulticlassMachine::get_submachine_outputs(int32_t i)
 	return output;
 }
 
+void CMulticlassMachine::get_all_submachine_outputs(CBinaryLabels** outputs,
+		int32_t num_machines)
+{
+	for (int32_t i=0; i<num_machines; ++i)
+		outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
+}
+
 float64_t CMulticlassMachine::get_submachine_output(int32_t i, int32_t num)
 {
 	CMachine *machine = get_machine(i);
@@ -128,10 +138,10 @@ CMulticlassLabels* CMulticlassMachine::apply_multiclass(CFeatures* data)
 		SGVector<float64_t> As(num_machines);
 		SGVector<float64_t> Bs(num_machines);
 
+		get_all_submachine_outputs(outputs, num_machines);
+
 		for (int32_t i=0; i<num_machines; ++i)
 		{
-			outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
-
 			if (heuris==OVA_SOFTMAX)
 			{
 				CStatistics::SigmoidParamters params = CStatistics::fit_sigmoid(outputs[i]->get_values());
@@ -216,8 +226,7 @@ CMulticlassMultipleOutputLabels* CMulticlassMachine::apply_multiclass_multiple_o
 		CMulticlassMultipleOutputLabels* result=new CMulticlassMultipleOutputLabels(num_vectors);
 		CBinaryLabels** outputs=SG_MALLOC(CBinaryLabels*, num_machines);
 
-		for (int32_t i=0; i < num_machines; ++i)
-			outputs[i] = (CBinaryLabels*) get_submachine_outputs(i);
+		get_all_submachine_outputs(outputs, num_machines);
 
 		SGVector<float64_t> output_for_i(num_machines);
 		for (int32_t i=0; i<num_vectors; i++)
@@ -256,6 +265,14 @@ bool CMulticlassMachine::train_machine(CFeatures* data)
 	m_machine->set_labels(train_labels);
 
 	m_multiclass_strategy->train_start(CLabelsFactory::to_multiclass(m_labels), train_labels);
+
+	int32_t num_concurrent=parallel->get_num_threads();
+	if (m_max_concurrent_machines>0)
+		num_concurrent=CMath::min(num_concurrent, m_max_concurrent_machines);
+
+	if (num_concurrent>1)
+		train_machines_parallel(train_labels, num_concurrent);
+
 	while (m_multiclass_strategy->train_has_more())
 	{
 		SGVector<index_t> subset=m_multiclass_strategy->train_prepare_next();
@@ -281,6 +298,69 @@ bool CMulticlassMachine::train_machine(CFeatures* data)
 	return true;
 }
 
+void CMulticlassMachine::train_machines_parallel(CBinaryLabels* train_labels,
+		int32_t num_concurrent)
+{
+	CMachine** machines=SG_MALLOC(CMachine*, num_concurrent);
+	bool* trained=SG_MALLOC(bool, num_concurrent);
+
+	while (m_multiclass_strategy->train_has_more())
+	{
+		/* prepare a batch of problems, each with its own labels and
+		 * machine, as the strategy reuses train_labels for every one */
+		int32_t num=0;
+		for (; num<num_concurrent && m_multiclass_strategy->train_has_more(); num++)
+		{
+			SGVector<index_t> subset=m_multiclass_strategy->train_prepare_next();
+			machines[num]=get_machine_for_parallel_train(subset);
+			trained[num]=false;
+
+			if (subset.vlen)
+				train_labels->add_subset(subset);
+
+			if (machines[num])
+				machines[num]->set_labels(new CBinaryLabels(train_labels->get_labels_copy()));
+			else
+			{
+				/* train the usual way, keeping the order of the machines */
+				if (subset.vlen)
+					add_machine_subset(subset);
+
+				m_machine->train();
+				machines[num]=get_machine_from_trained(m_machine);
+				SG_REF(machines[num]);
+				trained[num]=true;
+
+				if (subset.vlen)
+					remove_machine_subset();
+			}
+
+			if (subset.vlen)
+				train_labels->remove_subset();
+		}
+
+		#pragma omp parallel for num_threads(num_concurrent) schedule(dynamic, 1)
+		for (int32_t i=0; i<num; i++)
+		{
+			if (!trained[i])
+				machines[i]->train();
+		}
+
+		for (int32_t i=0; i<num; i++)
+		{
+			if (trained[i])
+				m_machines->push_back(machines[i]);
+			else
+				m_machines->push_back(get_machine_from_trained(machines[i]));
+
+			SG_UNREF(machines[i]);
+		}
+	}
+
+	SG_FREE(trained);
+	SG_FREE(machines);
+}
+
 float64_t CMulticlassMachine::apply_one(int32_t vec_idx)
 {
 	init_machines_for_apply(NULL);
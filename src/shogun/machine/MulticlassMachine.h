@@ -153,6 +153,31 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 			m_multiclass_strategy->set_prob_heuris_type(prob_heuris);
 		}
 
+		/** set the maximum number of submachines trained concurrently.
+		 * Every submachine in training holds its own copy of the base
+		 * machine and of the training labels, so this bounds the memory
+		 * used for training in addition to the number of threads.
+		 *
+		 * @param max_machines maximum number of concurrently trained
+		 * submachines, 0 to use as many as there are threads
+		 */
+		inline void set_max_concurrent_machines(int32_t max_machines)
+		{
+			REQUIRE(max_machines>=0, "Maximum number of concurrent machines "
+					"must not be negative\n");
+			m_max_concurrent_machines=max_machines;
+		}
+
+		/** get the maximum number of submachines trained concurrently
+		 *
+		 * @return maximum number of concurrently trained submachines,
+		 * 0 if only limited by the number of threads
+		 */
+		inline int32_t get_max_concurrent_machines() const
+		{
+			return m_max_concurrent_machines;
+		}
+
 	protected:
 		/** init strategy */
 		void init_strategy();
@@ -163,6 +188,39 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 		/** train machine */
 		virtual bool train_machine(CFeatures* data = NULL);
 
+		/** train the submachines of the strategy in batches of
+		 * num_concurrent machines, which are trained in parallel
+		 *
+		 * @param train_labels labels the strategy prepares problems in
+		 * @param num_concurrent number of machines trained at once
+		 */
+		void train_machines_parallel(CBinaryLabels* train_labels,
+				int32_t num_concurrent);
+
+		/** create an independent copy of the base machine that trains on
+		 * the given subset of the training data, sharing the feature data
+		 * with the base machine but not its state. Used to train several
+		 * submachines at once.
+		 *
+		 * @param subset subset of the training data, may be empty
+		 * @return untrained machine (SG_REF'ed) or NULL if the machine
+		 * can not be trained concurrently, in which case it is trained
+		 * the usual way
+		 */
+		virtual CMachine* get_machine_for_parallel_train(SGVector<index_t> subset)
+		{
+			return NULL;
+		}
+
+		/** compute the outputs of all submachines on the current data
+		 *
+		 * @param outputs array of num_machines entries receiving the
+		 * outputs of every submachine
+		 * @param num_machines number of submachines
+		 */
+		virtual void get_all_submachine_outputs(CBinaryLabels** outputs,
+				int32_t num_machines);
+
 		/** abstract init machine for training method */
 		virtual bool init_machine_for_train(CFeatures* data) = 0;
 
@@ -204,6 +262,9 @@ class CMulticlassMachine : public CBaseMulticlassMachine
 
 		/** machine */
 		CMachine* m_machine;
+
+		/** maximum number of submachines trained concurrently */
+		int32_t m_max_concurrent_machines;
 };
 }
 #endif
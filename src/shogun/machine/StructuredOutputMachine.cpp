@@ -11,6 +11,7 @@
  */
 
 #include <shogun/machine/StructuredOutputMachine.h>
+#include <shogun/mathematics/Math.h>
 
 using namespace shogun;
 
@@ -109,22 +110,78 @@ float64_t CStructuredOutputMachine::risk_nslack_margin_rescale(float64_t* subgra
 	}
 	SG_UNREF(features);
 
-	float64_t R = 0.0;
-	for (int32_t i=0; i<dim; i++)
-		subgrad[i] = 0;
+	float64_t R = 0.0, delta = 0.0;
+	sum_argmax_results(SGVector<float64_t>(W,dim,false), from, to, subgrad, R, delta);
 
+	return R;
+}
+
+/** adds up results of loss-augmented inference for the examples in [from,to) */
+static void add_argmax_results(CStructuredModel* model, SGVector<float64_t> w,
+		int32_t from, int32_t to, float64_t* psi_diff, float64_t& score, float64_t& delta)
+{
+	int32_t dim = w.vlen;
 	for (int32_t i=from; i<to; i++)
 	{
-		CResultSet* result = m_model->argmax(SGVector<float64_t>(W,dim,false), i, true);
-		SGVector<float64_t> psi_pred = result->psi_pred;
-		SGVector<float64_t> psi_truth = result->psi_truth;
-		SGVector<float64_t>::vec1_plus_scalar_times_vec2(subgrad, 1.0, psi_pred.vector, dim);
-		SGVector<float64_t>::vec1_plus_scalar_times_vec2(subgrad, -1.0, psi_truth.vector, dim);
-		R += result->score;
+		CResultSet* result = model->argmax(w, i, true);
+		SGVector<float64_t>::vec1_plus_scalar_times_vec2(psi_diff, 1.0, result->psi_pred.vector, dim);
+		SGVector<float64_t>::vec1_plus_scalar_times_vec2(psi_diff, -1.0, result->psi_truth.vector, dim);
+		score += result->score;
+		delta += result->delta;
 		SG_UNREF(result);
 	}
+}
 
-	return R;
+void CStructuredOutputMachine::sum_argmax_results(SGVector<float64_t> w, int32_t from, int32_t to,
+		float64_t* psi_diff, float64_t& score, float64_t& delta)
+{
+	int32_t dim = m_model->get_dim();
+	SGVector<float64_t>::fill_vector(psi_diff, dim, 0.0);
+	score = 0.0;
+	delta = 0.0;
+
+	if (from>=to)
+		return;
+
+	int32_t num_threads = 1;
+	if (m_model->is_argmax_thread_safe())
+		num_threads = CMath::min(parallel->get_num_threads(), to-from-1);
+
+	if (num_threads<=1)
+	{
+		add_argmax_results(m_model, w, from, to, psi_diff, score, delta);
+		return;
+	}
+
+	// the first example is done alone, so that the model can set up
+	// anything depending on w before it is called concurrently
+	add_argmax_results(m_model, w, from, from+1, psi_diff, score, delta);
+	from++;
+
+	SGMatrix<float64_t> chunk_psi_diff(dim, num_threads);
+	SGVector<float64_t> chunk_score(num_threads);
+	SGVector<float64_t> chunk_delta(num_threads);
+	chunk_psi_diff.zero();
+	chunk_score.zero();
+	chunk_delta.zero();
+
+	int64_t num_examples = to-from;
+	#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		int32_t chunk_from = from+num_examples*t/num_threads;
+		int32_t chunk_to = from+num_examples*(t+1)/num_threads;
+		add_argmax_results(m_model, w, chunk_from, chunk_to,
+				chunk_psi_diff.get_column_vector(t), chunk_score[t], chunk_delta[t]);
+	}
+
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		SGVector<float64_t>::vec1_plus_scalar_times_vec2(psi_diff, 1.0,
+				chunk_psi_diff.get_column_vector(t), dim);
+		score += chunk_score[t];
+		delta += chunk_delta[t];
+	}
 }
 
 float64_t CStructuredOutputMachine::risk_nslack_slack_rescale(float64_t* subgrad, float64_t* W, TMultipleCPinfo* info)
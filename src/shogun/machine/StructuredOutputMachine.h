@@ -200,6 +200,25 @@ class CStructuredOutputMachine : public CMachine
 		 */
 		virtual float64_t risk_customized_formulation(float64_t* subgrad, float64_t* W, TMultipleCPinfo* info=0);
 
+		/** runs loss-augmented inference for the examples in [from,to) and
+		 * sums up its results
+		 *
+		 * If the model allows it (see CStructuredModel::is_argmax_thread_safe)
+		 * the examples are split in contiguous chunks among threads, each
+		 * summing into its own buffers. The buffers are then summed up in a
+		 * fixed order, so the result only depends on the number of threads.
+		 *
+		 * @param w weight vector
+		 * @param from first example
+		 * @param to one past the last example
+		 * @param psi_diff (of model dimension) sum of
+		 * \f$ \Psi(x_i, \hat{y}_i) - \Psi(x_i, y_i) \f$
+		 * @param score sum of scores of the predictions
+		 * @param delta sum of losses of the predictions
+		 */
+		void sum_argmax_results(SGVector<float64_t> w, int32_t from, int32_t to,
+				float64_t* psi_diff, float64_t& score, float64_t& delta);
+
 	private:
 		/** register class members */
 		void register_parameters();
@@ -32,6 +32,7 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include <float.h>
 #include <sys/types.h>
 #ifndef _WIN32
@@ -1130,6 +1131,154 @@ class CMath : public CSGObject
 			SG_SERROR("CMath::nmin():: Not supported for complex128_t\n");
 		}
 
+		/** @name Parallel Sort and Select Functions
+		 *
+		 * Sorting and selection for large arrays, parallel over num_threads
+		 * threads. An index array (e.g. 0..size-1) is permuted along with
+		 * the sorted array.
+		 */
+		//@{
+		/** sorts output ascending with a parallel merge sort: ranges of
+		 * the array are sorted by qsort_index, then merged pairwise, where
+		 * every merge is split evenly between the threads
+		 *
+		 * @param output array to sort
+		 * @param index array permuted along with output
+		 * @param size length of the arrays
+		 * @param num_threads number of threads
+		 */
+		template <class T1, class T2>
+			static void parallel_sort_index(T1* output, T2* index, index_t size,
+				int32_t num_threads);
+
+		/** sorts keys ascending with a stable LSD radix sort over 11 bit
+		 * digits, parallel over ranges of the array. Works for all integer
+		 * and floating point types (see radix_key), digits which all keys
+		 * share are skipped.
+		 *
+		 * @param keys array to sort
+		 * @param index array permuted along with keys, may be NULL
+		 * @param size length of the arrays
+		 * @param num_threads number of threads
+		 */
+		template <class T1, class T2>
+			static void lsd_radix_sort_index(T1* keys, T2* index, index_t size,
+				int32_t num_threads);
+
+		/** sorts keys ascending with a stable LSD radix sort, see
+		 * lsd_radix_sort_index
+		 *
+		 * @param keys array to sort
+		 * @param size length of the array
+		 * @param num_threads number of threads
+		 */
+		template <class T>
+			static void lsd_radix_sort(T* keys, index_t size, int32_t num_threads)
+			{
+				lsd_radix_sort_index(keys, (uint8_t*) NULL, size, num_threads);
+			}
+
+		/** reorders output such that its n-th element is the one that would
+		 * be there if output was sorted ascending, elements before it are not
+		 * larger and elements after it not smaller (like std::nth_element),
+		 * using quickselect with parallel three-way partitions
+		 *
+		 * @param output array to reorder
+		 * @param index array permuted along with output, may be NULL
+		 * @param size length of the arrays
+		 * @param n position of the element to select
+		 * @param num_threads number of threads
+		 */
+		template <class T1, class T2>
+			static void parallel_nth_element_index(T1* output, T2* index,
+				index_t size, index_t n, int32_t num_threads);
+
+		/** reorders output such that its n-th element is the one that would
+		 * be there if output was sorted ascending, see
+		 * parallel_nth_element_index
+		 *
+		 * @param output array to reorder
+		 * @param size length of the array
+		 * @param n position of the element to select
+		 * @param num_threads number of threads
+		 */
+		template <class T>
+			static void parallel_nth_element(T* output, index_t size, index_t n,
+				int32_t num_threads)
+			{
+				parallel_nth_element_index(output, (uint8_t*) NULL, size, n,
+					num_threads);
+			}
+
+		/** puts the k smallest elements of output in ascending order at its
+		 * beginning (top-k selection), the remaining elements follow in
+		 * arbitrary order
+		 *
+		 * @param output array to reorder
+		 * @param index array permuted along with output
+		 * @param size length of the arrays
+		 * @param k number of smallest elements
+		 * @param num_threads number of threads
+		 */
+		template <class T1, class T2>
+			static void partial_sort_index(T1* output, T2* index, index_t size,
+				index_t k, int32_t num_threads)
+			{
+				if (k<=0 || size<=1)
+					return;
+
+				if (k<size)
+					parallel_nth_element_index(output, index, size, k-1, num_threads);
+				else
+					k=size;
+
+				parallel_sort_index(output, index, k, num_threads);
+			}
+
+		/** merges the sorted ranges a and b (a first on ties) into out, or
+		 * the part of the merge from position k_begin to k_end, used by
+		 * parallel_sort_index
+		 */
+		template <class T1, class T2>
+			static void merge_sorted_ranges(const T1* a, const T2* a_index,
+				index_t a_len, const T1* b, const T2* b_index, index_t b_len,
+				T1* out, T2* out_index, index_t k_begin, index_t k_end);
+
+		/** @return unsigned integer whose order is the order of the value,
+		 * used by lsd_radix_sort_index
+		 */
+		static inline uint8_t radix_key(uint8_t value) { return value; }
+		static inline uint16_t radix_key(uint16_t value) { return value; }
+		static inline uint32_t radix_key(uint32_t value) { return value; }
+		static inline uint64_t radix_key(uint64_t value) { return value; }
+		static inline uint8_t radix_key(char value) { return uint8_t(value)^0x80U; }
+		static inline uint8_t radix_key(int8_t value) { return uint8_t(value)^0x80U; }
+		static inline uint16_t radix_key(int16_t value) { return uint16_t(value)^0x8000U; }
+		static inline uint32_t radix_key(int32_t value) { return uint32_t(value)^0x80000000U; }
+		static inline uint64_t radix_key(int64_t value)
+		{
+			return uint64_t(value)^(uint64_t(1)<<63);
+		}
+		static inline uint32_t radix_key(float32_t value)
+		{
+			// -0 and 0 are equal
+			if (value==0.0f)
+				value=0.0f;
+			uint32_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			return bits>>31 ? ~bits : bits^0x80000000U;
+		}
+		static inline uint64_t radix_key(float64_t value)
+		{
+			// -0 and 0 are equal
+			if (value==0.0)
+				value=0.0;
+			uint64_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+			return bits>>63 ? ~bits : bits^(uint64_t(1)<<63);
+		}
+		//@}
+
 
 
 		/* finds an element in a sorted array via binary search
@@ -1635,11 +1784,342 @@ void CMath::qsort_backward_index(T1* output, T2* index, int32_t size)
 	template <class T>
 void CMath::nmin(float64_t* output, T* index, int32_t size, int32_t n)
 {
-	if (6*n*size<13*size*CMath::log(size))
-		for (int32_t i=0; i<n; i++)
-			min(&output[i], &index[i], size-i) ;
-	else
-		qsort_index(output, index, size) ;
+	partial_sort_index(output, index, size, n, 1);
+}
+
+	template <class T1,class T2>
+void CMath::merge_sorted_ranges(const T1* a, const T2* a_index, index_t a_len,
+	const T1* b, const T2* b_index, index_t b_len, T1* out, T2* out_index,
+	index_t k_begin, index_t k_end)
+{
+	// number of elements of a among the first k of the merge
+	index_t co_rank[2];
+	index_t ks[2]={k_begin, k_end};
+	for (int32_t r=0; r<2; r++)
+	{
+		index_t k=ks[r];
+		index_t lo=CMath::max(index_t(0), k-b_len);
+		index_t hi=CMath::min(k, a_len);
+		while (lo<hi)
+		{
+			index_t i=lo+(hi-lo)/2;
+			if (i<a_len && k-i>0 && !(b[k-i-1]<a[i]))
+				lo=i+1;
+			else
+				hi=i;
+		}
+		co_rank[r]=lo;
+	}
+
+	index_t i=co_rank[0];
+	index_t j=k_begin-co_rank[0];
+	for (index_t k=k_begin; k<k_end; k++)
+	{
+		if (j>=b_len || (i<a_len && !(b[j]<a[i])))
+		{
+			out[k]=a[i];
+			if (out_index)
+				out_index[k]=a_index[i];
+			i++;
+		}
+		else
+		{
+			out[k]=b[j];
+			if (out_index)
+				out_index[k]=b_index[j];
+			j++;
+		}
+	}
+}
+
+	template <class T1,class T2>
+void CMath::parallel_sort_index(T1* output, T2* index, index_t size,
+	int32_t num_threads)
+{
+	// at least 2^14 elements per range
+	num_threads=CMath::max(1, CMath::min(num_threads, size>>14));
+	if (num_threads==1)
+	{
+		qsort_index(output, index, size);
+		return;
+	}
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; t++)
+	{
+		index_t begin=int64_t(size)*t/num_threads;
+		index_t end=int64_t(size)*(t+1)/num_threads;
+		qsort_index(output+begin, index+begin, end-begin);
+	}
+
+	T1* output_buffer=SG_MALLOC(T1, size);
+	T2* index_buffer=SG_MALLOC(T2, size);
+	T1* src=output;
+	T2* src_index=index;
+	T1* dst=output_buffer;
+	T2* dst_index=index_buffer;
+
+	// merge pairs of runs of width ranges, each merge split into pieces
+	// such that all threads have the same share of the round
+	for (int32_t width=1; width<num_threads; width*=2)
+	{
+		int32_t num_merges=(num_threads+2*width-1)/(2*width);
+		int32_t num_pieces=CMath::max(1, num_threads/num_merges);
+
+		#pragma omp parallel for num_threads(num_threads)
+		for (int32_t p=0; p<num_merges*num_pieces; p++)
+		{
+			int32_t m=p/num_pieces;
+			int32_t piece=p%num_pieces;
+			index_t a_begin=int64_t(size)*(2*m*width)/num_threads;
+			index_t b_begin=int64_t(size)*CMath::min(num_threads,
+					(2*m+1)*width)/num_threads;
+			index_t b_end=int64_t(size)*CMath::min(num_threads,
+					(2*m+2)*width)/num_threads;
+			index_t len=b_end-a_begin;
+
+			merge_sorted_ranges(src+a_begin, src_index+a_begin,
+				b_begin-a_begin, src+b_begin, src_index+b_begin, b_end-b_begin,
+				dst+a_begin, dst_index+a_begin,
+				index_t(int64_t(len)*piece/num_pieces),
+				index_t(int64_t(len)*(piece+1)/num_pieces));
+		}
+
+		swap(src, dst);
+		swap(src_index, dst_index);
+	}
+
+	if (src!=output)
+	{
+		#pragma omp parallel for num_threads(num_threads)
+		for (int32_t t=0; t<num_threads; t++)
+		{
+			index_t begin=int64_t(size)*t/num_threads;
+			index_t end=int64_t(size)*(t+1)/num_threads;
+			memcpy(output+begin, src+begin, sizeof(T1)*(end-begin));
+			memcpy(index+begin, src_index+begin, sizeof(T2)*(end-begin));
+		}
+	}
+
+	SG_FREE(output_buffer);
+	SG_FREE(index_buffer);
+}
+
+	template <class T1,class T2>
+void CMath::lsd_radix_sort_index(T1* keys, T2* index, index_t size,
+	int32_t num_threads)
+{
+	const int32_t radix_bits=11;
+	const int32_t num_buckets=1<<radix_bits;
+	const int32_t num_bits=8*sizeof(radix_key(keys[0]));
+
+	// at least 4 elements per bucket and range
+	num_threads=CMath::max(1, CMath::min(num_threads, size/(4*num_buckets)));
+
+	T1* keys_buffer=SG_MALLOC(T1, size);
+	T2* index_buffer=index ? SG_MALLOC(T2, size) : NULL;
+	int64_t* offsets=SG_MALLOC(int64_t, int64_t(num_buckets)*num_threads);
+	T1* src=keys;
+	T2* src_index=index;
+	T1* dst=keys_buffer;
+	T2* dst_index=index_buffer;
+
+	for (int32_t shift=0; shift<num_bits; shift+=radix_bits)
+	{
+		memset(offsets, 0, sizeof(int64_t)*num_buckets*num_threads);
+
+		// histogram of digits per contiguous range
+		#pragma omp parallel for num_threads(num_threads)
+		for (int32_t t=0; t<num_threads; t++)
+		{
+			int64_t* count=offsets+int64_t(t)*num_buckets;
+			index_t begin=int64_t(size)*t/num_threads;
+			index_t end=int64_t(size)*(t+1)/num_threads;
+			for (index_t i=begin; i<end; i++)
+				count[(uint64_t(radix_key(src[i]))>>shift)&(num_buckets-1)]++;
+		}
+
+		// exclusive prefix sums in digit major, range minor order
+		bool all_equal=false;
+		int64_t total=0;
+		for (int32_t d=0; d<num_buckets; d++)
+		{
+			int64_t digit_count=0;
+			for (int32_t t=0; t<num_threads; t++)
+			{
+				int64_t count=offsets[int64_t(t)*num_buckets+d];
+				offsets[int64_t(t)*num_buckets+d]=total;
+				total+=count;
+				digit_count+=count;
+			}
+			all_equal|=digit_count==size;
+		}
+
+		// a digit which all keys share doesn't change the order
+		if (all_equal)
+			continue;
+
+		// stable scatter, each range after the ones before it
+		#pragma omp parallel for num_threads(num_threads)
+		for (int32_t t=0; t<num_threads; t++)
+		{
+			int64_t* offset=offsets+int64_t(t)*num_buckets;
+			index_t begin=int64_t(size)*t/num_threads;
+			index_t end=int64_t(size)*(t+1)/num_threads;
+			for (index_t i=begin; i<end; i++)
+			{
+				int64_t j=offset[(uint64_t(radix_key(src[i]))>>shift)&(num_buckets-1)]++;
+				dst[j]=src[i];
+				if (dst_index)
+					dst_index[j]=src_index[i];
+			}
+		}
+
+		swap(src, dst);
+		swap(src_index, dst_index);
+	}
+
+	if (src!=keys)
+	{
+		memcpy(keys, src, sizeof(T1)*size);
+		if (index)
+			memcpy(index, src_index, sizeof(T2)*size);
+	}
+
+	SG_FREE(keys_buffer);
+	SG_FREE(index_buffer);
+	SG_FREE(offsets);
+}
+
+	template <class T1,class T2>
+void CMath::parallel_nth_element_index(T1* output, T2* index, index_t size,
+	index_t n, int32_t num_threads)
+{
+	if (n<0 || n>=size)
+		return;
+
+	T1* output_buffer=NULL;
+	T2* index_buffer=NULL;
+	int64_t* counts=NULL;
+
+	// the part of the array which contains the n-th element
+	index_t begin=0;
+	index_t end=size;
+	while (end-begin>16)
+	{
+		index_t len=end-begin;
+		T1* values=output+begin;
+		T2* values_index=index ? index+begin : NULL;
+
+		// median of three as pivot
+		T1 a=values[0];
+		T1 b=values[len/2];
+		T1 c=values[len-1];
+		T1 pivot=a<b ? (b<c ? b : (a<c ? c : a)) : (a<c ? a : (b<c ? c : b));
+
+		int32_t threads=CMath::max(1, CMath::min(num_threads, len>>14));
+
+		if (!output_buffer)
+		{
+			output_buffer=SG_MALLOC(T1, size);
+			index_buffer=index ? SG_MALLOC(T2, size) : NULL;
+			counts=SG_MALLOC(int64_t, 3*int64_t(num_threads));
+		}
+
+		// number of smaller, equal and larger elements per range
+		#pragma omp parallel for num_threads(threads)
+		for (int32_t t=0; t<threads; t++)
+		{
+			index_t range_begin=int64_t(len)*t/threads;
+			index_t range_end=int64_t(len)*(t+1)/threads;
+			int64_t less=0;
+			int64_t equal=0;
+			for (index_t i=range_begin; i<range_end; i++)
+			{
+				less+=values[i]<pivot;
+				equal+=!(values[i]<pivot) && !(pivot<values[i]);
+			}
+			counts[3*t]=less;
+			counts[3*t+1]=equal;
+			counts[3*t+2]=(range_end-range_begin)-less-equal;
+		}
+
+		int64_t num_less=0;
+		int64_t num_equal=0;
+		for (int32_t t=0; t<threads; t++)
+		{
+			num_less+=counts[3*t];
+			num_equal+=counts[3*t+1];
+		}
+
+		// offsets of the ranges in the three parts
+		int64_t offset[3]={0, num_less, num_less+num_equal};
+		for (int32_t t=0; t<threads; t++)
+		{
+			for (int32_t part=0; part<3; part++)
+			{
+				int64_t count=counts[3*t+part];
+				counts[3*t+part]=offset[part];
+				offset[part]+=count;
+			}
+		}
+
+		// three-way partition into the buffer and back
+		#pragma omp parallel for num_threads(threads)
+		for (int32_t t=0; t<threads; t++)
+		{
+			index_t range_begin=int64_t(len)*t/threads;
+			index_t range_end=int64_t(len)*(t+1)/threads;
+			int64_t* offsets=counts+3*t;
+			for (index_t i=range_begin; i<range_end; i++)
+			{
+				int32_t part=values[i]<pivot ? 0 : (pivot<values[i] ? 2 : 1);
+				int64_t j=offsets[part]++;
+				output_buffer[j]=values[i];
+				if (values_index)
+					index_buffer[j]=values_index[i];
+			}
+		}
+
+		#pragma omp parallel for num_threads(threads)
+		for (int32_t t=0; t<threads; t++)
+		{
+			index_t range_begin=int64_t(len)*t/threads;
+			index_t range_end=int64_t(len)*(t+1)/threads;
+			memcpy(values+range_begin, output_buffer+range_begin,
+				sizeof(T1)*(range_end-range_begin));
+			if (values_index)
+			{
+				memcpy(values_index+range_begin, index_buffer+range_begin,
+					sizeof(T2)*(range_end-range_begin));
+			}
+		}
+
+		if (n<begin+num_less)
+			end=begin+num_less;
+		else if (n<begin+num_less+num_equal)
+		{
+			begin=end;
+			break;
+		}
+		else
+			begin+=num_less+num_equal;
+	}
+
+	// insertion sort of the small remaining part
+	for (index_t i=begin+1; i<end; i++)
+	{
+		for (index_t j=i; j>begin && output[j]<output[j-1]; j--)
+		{
+			swap(output[j], output[j-1]);
+			if (index)
+				swap(index[j], index[j-1]);
+		}
+	}
+
+	SG_FREE(output_buffer);
+	SG_FREE(index_buffer);
+	SG_FREE(counts);
 }
 
 /* move the smallest entry in the array to the beginning */
@@ -15,6 +15,7 @@
 
 #include <shogun/mathematics/Statistics.h>
 #include <shogun/mathematics/Math.h>
+#include <shogun/base/init.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGSparseMatrix.h>
@@ -49,72 +50,12 @@ float64_t CStatistics::median(SGVector<float64_t> values, bool modify,
 	float64_t result;
 	if (modify)
 	{
-		/* use QuickSelect method
-		 * This Quickselect routine is based on the algorithm described in
-		 * "Numerical recipes in C", Second Edition,
-		 * Cambridge University Press, 1992, Section 8.5, ISBN 0-521-43108-5
-		 * This code by Nicolas Devillard - 1998. Public domain.
-		 * Adapted to SHOGUN by Heiko Strathmann
-		 */
-		int32_t low;
-		int32_t high;
-		int32_t median;
-		int32_t middle;
-		int32_t l;
-		int32_t h;
-
-		low=0;
-		high=values.vlen-1;
-		median=(low+high)/2;
-
-		while (true)
-		{
-			if (high<=low)
-			{
-				result=values[median];
-				break;
-			}
-
-			if (high==low+1)
-			{
-				if (values[low]>values[high])
-					CMath::CMath::swap(values[low], values[high]);
-				result=values[median];
-				break;
-			}
-
-			middle=(low+high)/2;
-			if (values[middle]>values[high])
-				CMath::swap(values[middle], values[high]);
-			if (values[low]>values[high])
-				CMath::swap(values[low], values[high]);
-			if (values[middle]>values[low])
-				CMath::swap(values[middle], values[low]);
-
-			CMath::swap(values[middle], values[low+1]);
-
-			l=low+1;
-			h=high;
-			for (;;)
-			{
-				do
-					l++;
-				while (values[low]>values[l]);
-				do
-					h--;
-				while (values[h]>values[low]);
-				if (h<l)
-					break;
-				CMath::swap(values[l], values[h]);
-			}
-
-			CMath::swap(values[low], values[h]);
-			if (h<=median)
-				low=l;
-			if (h>=median)
-				high=h-1;
-		}
-
+		/* use parallel quickselect, the lower median is the element at
+		 * position (len-1)/2 of the sorted vector */
+		index_t median=(values.vlen-1)/2;
+		CMath::parallel_nth_element(values.vector, values.vlen, median,
+				shogun::get_global_parallel()->get_num_threads());
+		result=values[median];
 	}
 	else
 	{
@@ -0,0 +1,307 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/common.h>
+
+#ifdef HAVE_EIGEN3
+
+#include <shogun/base/Parameter.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/linalg/linop/LinearOperator.h>
+#include <shogun/mathematics/linalg/eigsolver/BlockLanczosEigenSolver.h>
+
+using namespace Eigen;
+
+namespace shogun
+{
+
+CBlockLanczosEigenSolver::CBlockLanczosEigenSolver()
+	: CEigenSolver()
+{
+	init();
+}
+
+CBlockLanczosEigenSolver::CBlockLanczosEigenSolver(
+	CLinearOperator<float64_t>* linear_operator)
+	: CEigenSolver(linear_operator)
+{
+	init();
+}
+
+void CBlockLanczosEigenSolver::init()
+{
+	m_num_eigenpairs=10;
+	m_compute_largest=true;
+	m_block_size=4;
+	m_max_basis_size=0;
+	m_max_iteration_limit=1000;
+	m_relative_tolerence=1E-10;
+	m_num_restarts=0;
+
+	SG_ADD(&m_num_eigenpairs, "num_eigenpairs",
+		"Number of eigenpairs to be computed", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_compute_largest, "compute_largest",
+		"Whether the largest eigenpairs are computed", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_block_size, "block_size",
+		"Number of vectors the operator is applied to at once",
+		MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_max_basis_size, "max_basis_size",
+		"Maximum number of basis vectors before a restart", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_max_iteration_limit, "max_iteration_limit",
+		"Maximum number of restarts", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_relative_tolerence, "relative_tolerence",
+		"Relative tolerence of solver", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_eigenvalues, "eigenvalues", "Computed eigenvalues",
+		MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_eigenvectors, "eigenvectors", "Computed eigenvectors",
+		MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_num_restarts, "num_restarts",
+		"Number of restarts of the last compute", MS_NOT_AVAILABLE);
+}
+
+CBlockLanczosEigenSolver::~CBlockLanczosEigenSolver()
+{
+}
+
+/* orthogonalizes the block W=AV_j against the first num_cols columns of the
+ * orthonormal basis V and orthonormalizes it, such that W=VC+QR before */
+static void next_block(const MatrixXd& V, index_t num_cols, MatrixXd& W,
+	MatrixXd& C, MatrixXd& Q, MatrixXd& R)
+{
+	const float64_t scale=W.norm();
+
+	// classical Gram-Schmidt, repeated once for orthogonality to working
+	// precision
+	C.noalias()=V.leftCols(num_cols).transpose()*W;
+	W.noalias()-=V.leftCols(num_cols)*C;
+	MatrixXd C_i=V.leftCols(num_cols).transpose()*W;
+	W.noalias()-=V.leftCols(num_cols)*C_i;
+	C+=C_i;
+
+	HouseholderQR<MatrixXd> qr(W);
+	Q=qr.householderQ()*MatrixXd::Identity(W.rows(), W.cols());
+	R.noalias()=Q.transpose()*W;
+
+	// directions in which the Krylov subspace is invariant are continued
+	// with random vectors orthogonal to the basis
+	MatrixXd W_random=W;
+	bool deflated=false;
+	for (index_t i=0; i<R.rows(); ++i)
+	{
+		if (CMath::abs(R(i,i))<=1E-12*scale)
+		{
+			for (index_t j=0; j<W.rows(); ++j)
+				W_random(j,i)=CMath::randn_double();
+			deflated=true;
+		}
+	}
+
+	if (deflated)
+	{
+		for (index_t i=0; i<2; ++i)
+		{
+			C_i.noalias()=V.leftCols(num_cols).transpose()*W_random;
+			W_random.noalias()-=V.leftCols(num_cols)*C_i;
+		}
+
+		qr.compute(W_random);
+		Q=qr.householderQ()*MatrixXd::Identity(W.rows(), W.cols());
+		R.noalias()=Q.transpose()*W;
+	}
+}
+
+void CBlockLanczosEigenSolver::compute_dense()
+{
+	const index_t n=m_linear_operator->get_dimension();
+	const index_t k=m_num_eigenpairs;
+
+	SGMatrix<float64_t> identity(n, n);
+	identity.zero();
+	for (index_t i=0; i<n; ++i)
+		identity(i,i)=1.0;
+
+	SGMatrix<float64_t> A=m_linear_operator->apply_block(identity);
+	Map<MatrixXd> map_A(A.matrix, n, n);
+
+	SelfAdjointEigenSolver<MatrixXd> eig(0.5*(map_A+map_A.transpose()));
+
+	m_eigenvalues=SGVector<float64_t>(k);
+	m_eigenvectors=SGMatrix<float64_t>(n, k);
+	Map<MatrixXd> X(m_eigenvectors.matrix, n, k);
+
+	for (index_t i=0; i<k; ++i)
+	{
+		const index_t j=m_compute_largest ? n-1-i : i;
+		m_eigenvalues[i]=eig.eigenvalues()[j];
+		X.col(i)=eig.eigenvectors().col(j);
+	}
+}
+
+void CBlockLanczosEigenSolver::compute()
+{
+	SG_DEBUG("Entering\n");
+
+	REQUIRE(m_linear_operator, "Operator is NULL!\n");
+
+	const index_t n=m_linear_operator->get_dimension();
+	const index_t k=m_num_eigenpairs;
+	const index_t b=m_block_size;
+
+	REQUIRE(k>0 && k<=n, "Number of eigenpairs (%d) should be in [1,%d]\n",
+		k, n);
+	REQUIRE(b>0, "Block size (%d) should be positive\n", b);
+
+	index_t m=m_max_basis_size>0 ? m_max_basis_size : 3*k+2*b;
+	REQUIRE(m>=k+b, "Maximum basis size (%d) should be at least the number "
+		"of eigenpairs plus the block size (%d)\n", m, k+b);
+
+	// the basis grows by whole blocks
+	m=(m+b-1)/b*b;
+
+	m_num_restarts=0;
+
+	if (m>=n)
+	{
+		SG_DEBUG("Dimension %d does not exceed basis size %d, computing "
+			"dense eigendecomposition\n", n, m);
+		compute_dense();
+	}
+	else
+	{
+		// number of Ritz vectors kept on restart, such that the basis is
+		// filled by whole blocks again
+		const index_t l=m-CMath::max((m-k)/(2*b), 1)*b;
+
+		// the basis and the residual block after it, random initial block
+		// drawn from the shogun RNG, so that results follow its seed
+		MatrixXd V(n, m+b);
+		MatrixXd V0(n, b);
+		for (index_t j=0; j<n*b; ++j)
+			V0.data()[j]=CMath::randn_double();
+		HouseholderQR<MatrixXd> qr(V0);
+		V.leftCols(b)=qr.householderQ()*MatrixXd::Identity(n, b);
+
+		// projection of the operator onto the basis
+		MatrixXd H=MatrixXd::Zero(m, m);
+		MatrixXd C, Q, R;
+		SelfAdjointEigenSolver<MatrixXd> eig;
+		index_t cur=0;
+
+		while (true)
+		{
+			// extend the basis block by block
+			for (; cur<m; cur+=b)
+			{
+				SGMatrix<float64_t> V_j(V.data()+int64_t(cur)*n, n, b, false);
+				SGMatrix<float64_t> AV_j=m_linear_operator->apply_block(V_j);
+				MatrixXd W=Map<MatrixXd>(AV_j.matrix, n, b);
+
+				next_block(V, cur+b, W, C, Q, R);
+				V.middleCols(cur+b, b)=Q;
+
+				H.block(0, cur, cur+b, b)=C;
+				H.block(cur, 0, b, cur+b)=C.transpose();
+				if (cur+b<m)
+				{
+					H.block(cur+b, cur, b, b)=R;
+					H.block(cur, cur+b, b, b)=R.transpose();
+				}
+			}
+
+			// Ritz pairs, the residual of (theta, Vy) is the last residual
+			// block times the last block of y
+			eig.compute(H);
+			const VectorXd& theta=eig.eigenvalues();
+			const MatrixXd& Y=eig.eigenvectors();
+			const float64_t norm_estimate=CMath::max(CMath::abs(theta[0]),
+				CMath::abs(theta[m-1]));
+
+			index_t num_converged=0;
+			for (index_t i=0; i<k; ++i)
+			{
+				const index_t j=m_compute_largest ? m-1-i : i;
+				const float64_t residual_norm=(R*Y.col(j).tail(b)).norm();
+				if (residual_norm<=m_relative_tolerence*norm_estimate)
+					num_converged++;
+			}
+
+			SG_DEBUG("Restart %d, %d of %d Ritz pairs converged\n",
+				m_num_restarts, num_converged, k);
+
+			if (num_converged==k || m_num_restarts>=m_max_iteration_limit)
+			{
+				if (num_converged<k)
+					SG_WARNING("Did not converge!\n");
+
+				m_eigenvalues=SGVector<float64_t>(k);
+				m_eigenvectors=SGMatrix<float64_t>(n, k);
+				Map<MatrixXd> X(m_eigenvectors.matrix, n, k);
+
+				MatrixXd Y_k(m, k);
+				for (index_t i=0; i<k; ++i)
+				{
+					const index_t j=m_compute_largest ? m-1-i : i;
+					m_eigenvalues[i]=theta[j];
+					Y_k.col(i)=Y.col(j);
+				}
+				X.noalias()=V.leftCols(m)*Y_k;
+				break;
+			}
+
+			// thick restart with the l most wanted Ritz vectors followed by
+			// the residual block, the projection becomes an arrowhead matrix
+			MatrixXd Y_l(m, l);
+			VectorXd theta_l(l);
+			for (index_t i=0; i<l; ++i)
+			{
+				const index_t j=m_compute_largest ? m-1-i : i;
+				theta_l[i]=theta[j];
+				Y_l.col(i)=Y.col(j);
+			}
+
+			MatrixXd X=V.leftCols(m)*Y_l;
+			V.leftCols(l)=X;
+			V.middleCols(l, b)=V.middleCols(m, b);
+
+			MatrixXd S=R*Y_l.bottomRows(b);
+			H.setZero();
+			H.topLeftCorner(l, l).diagonal()=theta_l;
+			H.block(l, 0, b, l)=S;
+			H.block(0, l, l, b)=S.transpose();
+
+			cur=l;
+			m_num_restarts++;
+		}
+
+		SG_INFO("Computed %d eigenpairs with %d restarts\n", k, m_num_restarts);
+	}
+
+	if (m_compute_largest)
+	{
+		m_max_eigenvalue=m_eigenvalues[0];
+		m_is_computed_max=true;
+	}
+	else
+	{
+		m_min_eigenvalue=m_eigenvalues[0];
+		m_is_computed_min=true;
+	}
+
+	SG_DEBUG("Leaving\n");
+}
+
+}
+#endif // HAVE_EIGEN3
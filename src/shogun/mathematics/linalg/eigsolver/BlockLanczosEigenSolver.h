@@ -0,0 +1,207 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef BLOCK_LANCZOS_EIGEN_SOLVER_H_
+#define BLOCK_LANCZOS_EIGEN_SOLVER_H_
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_EIGEN3
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/mathematics/linalg/eigsolver/EigenSolver.h>
+
+namespace shogun
+{
+template<class T> class CLinearOperator;
+
+/** @brief Class that computes a few extremal eigenpairs of a real valued,
+ * self-adjoint linear operator using the thick-restart block Lanczos
+ * algorithm.
+ *
+ * The operator is applied to blocks of vectors at once via
+ * CLinearOperator::apply_block, which the sparse and dense matrix operators
+ * compute in parallel. The Krylov basis is fully reorthogonalized. When it
+ * reaches its maximum size, the Ritz pairs are computed and, unless they have
+ * converged, the basis is restarted with the most wanted Ritz vectors and the
+ * last residual block (Wu, Simon, "Thick-Restart Lanczos Method for Large
+ * Symmetric Eigenvalue Problems". SIAM Journal on Matrix Analysis and
+ * Applications, Vol. 22, No. 2, 2000).
+ *
+ * A Ritz pair \f$(\theta,x)\f$ has converged once
+ * \f$\|Ax-\theta x\|\leq\epsilon\|A\|\f$, \f$\|A\|\f$ being estimated by the
+ * largest Ritz value in magnitude. Operators whose dimension does not exceed
+ * the maximum basis size are decomposed densely. Eigenvalues whose
+ * multiplicity exceeds the block size may be found fewer times than they
+ * occur.
+ *
+ * compute() also sets the maximum (or minimum) eigenvalue of CEigenSolver.
+ */
+class CBlockLanczosEigenSolver : public CEigenSolver
+{
+public:
+	/** default constructor */
+	CBlockLanczosEigenSolver();
+
+	/**
+	 * constructor
+	 *
+	 * @param linear_operator self-adjoint linear operator whose eigenpairs
+	 * are to be found
+	 */
+	CBlockLanczosEigenSolver(CLinearOperator<float64_t>* linear_operator);
+
+	/** destructor */
+	virtual ~CBlockLanczosEigenSolver();
+
+	/**
+	 * compute method for computing the eigenpairs of a real valued linear
+	 * operator
+	 */
+	virtual void compute();
+
+	/** @param num_eigenpairs number of eigenpairs to be computed */
+	void set_num_eigenpairs(index_t num_eigenpairs)
+	{
+		m_num_eigenpairs=num_eigenpairs;
+	}
+
+	/** @return number of eigenpairs to be computed */
+	const index_t get_num_eigenpairs() const
+	{
+		return m_num_eigenpairs;
+	}
+
+	/** @param largest whether the largest (or else the smallest)
+	 * eigenpairs are computed */
+	void set_compute_largest(bool largest)
+	{
+		m_compute_largest=largest;
+	}
+
+	/** @return whether the largest eigenpairs are computed */
+	const bool get_compute_largest() const
+	{
+		return m_compute_largest;
+	}
+
+	/** @param block_size number of vectors the operator is applied to
+	 * at once */
+	void set_block_size(index_t block_size)
+	{
+		m_block_size=block_size;
+	}
+
+	/** @return block size */
+	const index_t get_block_size() const
+	{
+		return m_block_size;
+	}
+
+	/** @param max_basis_size maximum number of basis vectors before a
+	 * restart, 0 chooses three times the number of eigenpairs plus two
+	 * blocks */
+	void set_max_basis_size(index_t max_basis_size)
+	{
+		m_max_basis_size=max_basis_size;
+	}
+
+	/** @return maximum basis size */
+	const index_t get_max_basis_size() const
+	{
+		return m_max_basis_size;
+	}
+
+	/** @param max_iteration_limit maximum number of restarts */
+	void set_max_iteration_limit(int64_t max_iteration_limit)
+	{
+		m_max_iteration_limit=max_iteration_limit;
+	}
+
+	/** @return maximum number of restarts */
+	const int64_t get_max_iteration_limit() const
+	{
+		return m_max_iteration_limit;
+	}
+
+	/** @param relative_tolerence to be set */
+	void set_relative_tolerence(float64_t relative_tolerence)
+	{
+		m_relative_tolerence=relative_tolerence;
+	}
+
+	/** @return relative tolerence */
+	const float64_t get_relative_tolerence() const
+	{
+		return m_relative_tolerence;
+	}
+
+	/** @return the computed eigenvalues, the most extremal first */
+	SGVector<float64_t> get_eigenvalues() const
+	{
+		return m_eigenvalues;
+	}
+
+	/** @return the computed eigenvectors, one per column in the order of
+	 * the eigenvalues */
+	SGMatrix<float64_t> get_eigenvectors() const
+	{
+		return m_eigenvectors;
+	}
+
+	/** @return number of restarts the last compute needed */
+	const index_t get_num_restarts() const
+	{
+		return m_num_restarts;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const
+	{
+		return "BlockLanczosEigenSolver";
+	}
+
+private:
+	/** computes all eigenpairs of the densely formed operator */
+	void compute_dense();
+
+	/** number of eigenpairs */
+	index_t m_num_eigenpairs;
+
+	/** whether to compute the largest eigenpairs */
+	bool m_compute_largest;
+
+	/** block size */
+	index_t m_block_size;
+
+	/** maximum basis size */
+	index_t m_max_basis_size;
+
+	/** maximum number of restarts */
+	int64_t m_max_iteration_limit;
+
+	/** relative tolerence */
+	float64_t m_relative_tolerence;
+
+	/** computed eigenvalues */
+	SGVector<float64_t> m_eigenvalues;
+
+	/** computed eigenvectors */
+	SGMatrix<float64_t> m_eigenvectors;
+
+	/** number of restarts of the last compute */
+	index_t m_num_restarts;
+
+	/** register params and initialize with default values */
+	void init();
+
+};
+
+}
+
+#endif // HAVE_EIGEN3
+#endif // BLOCK_LANCZOS_EIGEN_SOLVER_H_
@@ -137,9 +137,51 @@ SGVector<T> CDenseMatrixOperator<T>::apply(SGVector<T> b) const
 		return result;
 	}
 
+template<class T>
+SGMatrix<T> CDenseMatrixOperator<T>::apply_block(SGMatrix<T> b) const
+	{
+		REQUIRE(m_operator.matrix, "Operator not initialized!\n");
+		REQUIRE(this->get_dimension()==b.num_rows,
+			"Number of rows of matrix must be equal to the "
+			"number of cols of the operator!\n");
+
+		typedef Matrix<T, Dynamic, Dynamic> MatrixXt;
+
+		Map<MatrixXt> _b(b.matrix, b.num_rows, b.num_cols);
+		Map<MatrixXt> _op(m_operator.matrix, m_operator.num_rows,
+			m_operator.num_cols);
+
+		SGMatrix<T> result(m_operator.num_rows, b.num_cols);
+		Map<MatrixXt> _result(result.matrix, result.num_rows, result.num_cols);
+
+		const index_t num_rows=m_operator.num_rows;
+		const int32_t num_threads=this->parallel->get_num_threads();
+		#pragma omp parallel for num_threads(num_threads)
+		for (int32_t t=0; t<num_threads; ++t)
+		{
+			const index_t begin=int64_t(num_rows)*t/num_threads;
+			const index_t end=int64_t(num_rows)*(t+1)/num_threads;
+
+			if (end>begin)
+			{
+				_result.middleRows(begin, end-begin).noalias()
+					=_op.middleRows(begin, end-begin)*_b;
+			}
+		}
+
+		return result;
+	}
+
 #define UNDEFINED(type) \
 template<> \
 SGVector<type> CDenseMatrixOperator<type>::apply(SGVector<type> b) const \
+	{	\
+		SG_SERROR("Not supported for %s\n", #type);\
+		return b; \
+	} \
+\
+template<> \
+SGMatrix<type> CDenseMatrixOperator<type>::apply_block(SGMatrix<type> b) const \
 	{	\
 		SG_SERROR("Not supported for %s\n", #type);\
 		return b; \
@@ -60,6 +60,15 @@ public:
 	 */
 	virtual SGVector<T> apply(SGVector<T> b) const;
 
+	/**
+	 * method that applies the dense-matrix linear operator to all columns
+	 * of a matrix, each thread computing a range of rows of the result
+	 *
+	 * @param b the matrix to whose columns the linear operator applies
+	 * @return the result matrix
+	 */
+	virtual SGMatrix<T> apply_block(SGMatrix<T> b) const;
+
 	/**
 	 * method that sets the main diagonal of the matrix
 	 *
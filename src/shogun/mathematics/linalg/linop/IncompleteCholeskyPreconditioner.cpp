@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/lib/SGSparseVector.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/IncompleteCholeskyPreconditioner.h>
+
+namespace shogun
+{
+
+CIncompleteCholeskyPreconditioner::CIncompleteCholeskyPreconditioner()
+	: CLinearOperator<float64_t>()
+{
+	init();
+}
+
+CIncompleteCholeskyPreconditioner::CIncompleteCholeskyPreconditioner(
+	CSparseMatrixOperator<float64_t>* op)
+	: CLinearOperator<float64_t>()
+{
+	init();
+
+	REQUIRE(op, "Operator is NULL!\n");
+
+	SGSparseMatrix<float64_t> A=op->get_matrix_operator();
+	REQUIRE(A.sparse_matrix, "Operator not initialized!\n");
+	REQUIRE(A.num_vectors==A.num_features, "Operator is not square! "
+		"[%d vs %d]\n", A.num_vectors, A.num_features);
+
+	const index_t n=A.num_vectors;
+
+	// the lower triangle of each row, the diagonal entry goes last
+	m_row_offsets=SGVector<index_t>(n+1);
+	m_row_offsets[0]=0;
+	for (index_t i=0; i<n; ++i)
+	{
+		index_t num_lower=0;
+		for (index_t k=0; k<A[i].num_feat_entries; ++k)
+			num_lower+=A[i].features[k].feat_index<i;
+		m_row_offsets[i+1]=m_row_offsets[i]+num_lower+1;
+	}
+
+	const index_t nnz=m_row_offsets[n];
+	m_indices=SGVector<index_t>(nnz);
+	SGVector<float64_t> a(nnz);
+
+	for (index_t i=0; i<n; ++i)
+	{
+		const index_t diag=m_row_offsets[i+1]-1;
+		index_t pos=m_row_offsets[i];
+		a[diag]=0.0;
+
+		for (index_t k=0; k<A[i].num_feat_entries; ++k)
+		{
+			const index_t j=A[i].features[k].feat_index;
+			if (j<i)
+			{
+				m_indices[pos]=j;
+				a[pos++]=A[i].features[k].entry;
+			}
+			else if (j==i)
+				a[diag]+=A[i].features[k].entry;
+		}
+
+		REQUIRE(a[diag]>0.0, "Diagonal entry %d is not positive!\n", i);
+		m_indices[diag]=i;
+
+		CMath::qsort_index(m_indices.vector+m_row_offsets[i],
+			a.vector+m_row_offsets[i], diag-m_row_offsets[i]);
+	}
+
+	m_values=SGVector<float64_t>(nnz);
+	m_shift=0.0;
+	if (!factorize(a, m_shift))
+	{
+		for (m_shift=1E-3; !factorize(a, m_shift); m_shift*=2)
+			REQUIRE(m_shift<1E10, "Incomplete Cholesky factorization failed!\n");
+
+		SG_INFO("Incomplete Cholesky factorization needed diagonal shift %f\n",
+			m_shift);
+	}
+
+	m_dimension=n;
+}
+
+void CIncompleteCholeskyPreconditioner::init()
+{
+	m_shift=0.0;
+
+	m_parameters->add(&m_row_offsets, "row_offsets",
+		"Offsets of the rows of the factor");
+	m_parameters->add(&m_indices, "indices",
+		"Column indices of the entries of the factor");
+	m_parameters->add(&m_values, "values", "Entries of the factor");
+	m_parameters->add(&m_shift, "shift",
+		"Diagonal shift of the factorized matrix");
+}
+
+CIncompleteCholeskyPreconditioner::~CIncompleteCholeskyPreconditioner()
+{
+}
+
+bool CIncompleteCholeskyPreconditioner::factorize(const SGVector<float64_t>& a,
+	float64_t shift)
+{
+	const index_t n=m_row_offsets.vlen-1;
+	const index_t* indices=m_indices.vector;
+	float64_t* L=m_values.vector;
+
+	for (index_t i=0; i<n; ++i)
+	{
+		const index_t begin=m_row_offsets[i];
+		const index_t diag=m_row_offsets[i+1]-1;
+		float64_t pivot=a[diag]*(1.0+shift);
+
+		for (index_t p=begin; p<diag; ++p)
+		{
+			// L_{ik}=(A_{ik}-\sum_{j<k}L_{ij}L_{kj})/L_{kk}, where the sum
+			// runs over the common pattern of rows i and k
+			const index_t k=indices[p];
+			const index_t k_diag=m_row_offsets[k+1]-1;
+			float64_t sum=a[p];
+
+			index_t q=begin;
+			index_t r=m_row_offsets[k];
+			while (q<p && r<k_diag)
+			{
+				if (indices[q]<indices[r])
+					q++;
+				else if (indices[q]>indices[r])
+					r++;
+				else
+					sum-=L[q++]*L[r++];
+			}
+
+			L[p]=sum/L[k_diag];
+			pivot-=L[p]*L[p];
+		}
+
+		if (!(pivot>0.0))
+			return false;
+
+		L[diag]=CMath::sqrt(pivot);
+	}
+
+	return true;
+}
+
+SGVector<float64_t> CIncompleteCholeskyPreconditioner::apply(
+	SGVector<float64_t> b) const
+{
+	REQUIRE(m_values.vector, "Preconditioner not initialized!\n");
+	REQUIRE(m_dimension==b.vlen, "Dimension mismatch! [%d vs %d]\n",
+		m_dimension, b.vlen);
+
+	const index_t n=b.vlen;
+	const index_t* indices=m_indices.vector;
+	const float64_t* L=m_values.vector;
+
+	// forward substitution Ly=b
+	SGVector<float64_t> result(n);
+	for (index_t i=0; i<n; ++i)
+	{
+		const index_t diag=m_row_offsets[i+1]-1;
+		float64_t sum=b[i];
+		for (index_t p=m_row_offsets[i]; p<diag; ++p)
+			sum-=L[p]*result[indices[p]];
+		result[i]=sum/L[diag];
+	}
+
+	// backward substitution L^{T}x=y, the columns of L^{T} are the rows of L
+	for (index_t i=n-1; i>=0; --i)
+	{
+		const index_t diag=m_row_offsets[i+1]-1;
+		result[i]/=L[diag];
+		for (index_t p=m_row_offsets[i]; p<diag; ++p)
+			result[indices[p]]-=L[p]*result[i];
+	}
+
+	return result;
+}
+
+}
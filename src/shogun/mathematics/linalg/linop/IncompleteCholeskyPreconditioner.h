@@ -0,0 +1,108 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef INCOMPLETE_CHOLESKY_PRECONDITIONER_H_
+#define INCOMPLETE_CHOLESKY_PRECONDITIONER_H_
+
+#include <shogun/lib/config.h>
+#include <shogun/mathematics/linalg/linop/LinearOperator.h>
+
+namespace shogun
+{
+template<class T> class CSparseMatrixOperator;
+
+/** @brief Class that represents the zero fill-in incomplete Cholesky
+ * preconditioner IC(0) of a sparse symmetric positive-definite matrix
+ * operator \f$A\f$, for use with CConjugateGradientSolver (see
+ * CIterativeLinearSolver::set_preconditioner).
+ *
+ * The lower triangular factor \f$L\f$ has the sparsity pattern of the lower
+ * triangle of \f$A\f$ and \f$LL^{T}\approx A\f$. Its apply method computes
+ * \f$M^{-1}b=L^{-T}L^{-1}b\f$ by forward and backward substitution. Only the
+ * lower triangle of \f$A\f$ is read.
+ *
+ * The factorization of some positive-definite matrices breaks down with
+ * non-positive pivots. Then the factorization of \f$A+\alpha
+ * \text{diag}(A)\f$ is computed instead, with \f$\alpha\f$ increased until
+ * it succeeds.
+ */
+class CIncompleteCholeskyPreconditioner : public CLinearOperator<float64_t>
+{
+
+public:
+	/** default constructor */
+	CIncompleteCholeskyPreconditioner();
+
+	/**
+	 * constructor, computes the factorization
+	 *
+	 * @param op the sparse matrix operator to be factorized, which must have
+	 * positive diagonal entries
+	 */
+	explicit CIncompleteCholeskyPreconditioner(
+		CSparseMatrixOperator<float64_t>* op);
+
+	/** destructor */
+	virtual ~CIncompleteCholeskyPreconditioner();
+
+	/**
+	 * method that applies \f$L^{-T}L^{-1}\f$ to a vector
+	 *
+	 * @param b the vector to which the preconditioner applies
+	 * @return the result vector
+	 */
+	virtual SGVector<float64_t> apply(SGVector<float64_t> b) const;
+
+	/** @return the diagonal shift \f$\alpha\f$ the factorization needed */
+	float64_t get_shift() const
+	{
+		return m_shift;
+	}
+
+	/** @return number of nonzero entries of the factor */
+	index_t get_num_nonzeros() const
+	{
+		return m_values.vlen;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const
+	{
+		return "IncompleteCholeskyPreconditioner";
+	}
+
+private:
+	/**
+	 * computes the factor of \f$A+\alpha\text{diag}(A)\f$ in m_values
+	 *
+	 * @param a the entries of the lower triangle of A, in the layout of
+	 * m_values
+	 * @param shift \f$\alpha\f$
+	 * @return whether all pivots were positive
+	 */
+	bool factorize(const SGVector<float64_t>& a, float64_t shift);
+
+	/** initialize with default values and register params */
+	void init();
+
+	/** offsets of the rows of the factor in m_indices and m_values, rows
+	 * are sorted by column and end with the diagonal entry */
+	SGVector<index_t> m_row_offsets;
+
+	/** column indices of the nonzero entries of the factor */
+	SGVector<index_t> m_indices;
+
+	/** nonzero entries of the factor */
+	SGVector<float64_t> m_values;
+
+	/** the diagonal shift of the factorized matrix */
+	float64_t m_shift;
+};
+
+}
+
+#endif // INCOMPLETE_CHOLESKY_PRECONDITIONER_H_
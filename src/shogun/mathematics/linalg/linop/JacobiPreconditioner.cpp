@@ -0,0 +1,95 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/base/Parameter.h>
+#include <shogun/mathematics/linalg/linop/MatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/JacobiPreconditioner.h>
+
+namespace shogun
+{
+
+template<class T>
+CJacobiPreconditioner<T>::CJacobiPreconditioner()
+	: CLinearOperator<T>()
+	{
+		init();
+	}
+
+template<class T>
+CJacobiPreconditioner<T>::CJacobiPreconditioner(CMatrixOperator<T>* op)
+	: CLinearOperator<T>()
+	{
+		init();
+
+		REQUIRE(op, "Operator is NULL!\n");
+
+		SGVector<T> diag=op->get_diagonal();
+		REQUIRE(diag.vlen==op->get_dimension(), "Operator is not square!\n");
+
+		m_inverse_diagonal=SGVector<T>(diag.vlen);
+		for (index_t i=0; i<diag.vlen; ++i)
+		{
+			REQUIRE(diag[i]!=static_cast<T>(0), "Diagonal entry %d is zero!\n", i);
+			m_inverse_diagonal[i]=static_cast<T>(1)/diag[i];
+		}
+
+		this->m_dimension=diag.vlen;
+	}
+
+template<class T>
+void CJacobiPreconditioner<T>::init()
+	{
+		CSGObject::set_generic<T>();
+
+		this->m_parameters->add(&m_inverse_diagonal, "inverse_diagonal",
+			"The inverse of the diagonal of the operator");
+	}
+
+template<class T>
+CJacobiPreconditioner<T>::~CJacobiPreconditioner()
+	{
+	}
+
+template<class T>
+SGVector<T> CJacobiPreconditioner<T>::apply(SGVector<T> b) const
+	{
+		REQUIRE(m_inverse_diagonal.vector, "Preconditioner not initialized!\n");
+		REQUIRE(m_inverse_diagonal.vlen==b.vlen, "Dimension mismatch! "
+			"[%d vs %d]\n", m_inverse_diagonal.vlen, b.vlen);
+
+		SGVector<T> result(b.vlen);
+		#pragma omp parallel for num_threads(this->parallel->get_num_threads())
+		for (index_t i=0; i<b.vlen; ++i)
+			result[i]=m_inverse_diagonal[i]*b[i];
+
+		return result;
+	}
+
+template<>
+SGVector<bool> CJacobiPreconditioner<bool>::apply(SGVector<bool> b) const
+	{
+		SG_SERROR("Not supported for bool\n");
+		return b;
+	}
+
+template class CJacobiPreconditioner<bool>;
+template class CJacobiPreconditioner<char>;
+template class CJacobiPreconditioner<int8_t>;
+template class CJacobiPreconditioner<uint8_t>;
+template class CJacobiPreconditioner<int16_t>;
+template class CJacobiPreconditioner<uint16_t>;
+template class CJacobiPreconditioner<int32_t>;
+template class CJacobiPreconditioner<uint32_t>;
+template class CJacobiPreconditioner<int64_t>;
+template class CJacobiPreconditioner<uint64_t>;
+template class CJacobiPreconditioner<float32_t>;
+template class CJacobiPreconditioner<float64_t>;
+template class CJacobiPreconditioner<floatmax_t>;
+template class CJacobiPreconditioner<complex128_t>;
+}
@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef JACOBI_PRECONDITIONER_H_
+#define JACOBI_PRECONDITIONER_H_
+
+#include <shogun/lib/config.h>
+#include <shogun/mathematics/linalg/linop/LinearOperator.h>
+
+namespace shogun
+{
+template<class T> class CMatrixOperator;
+
+/** @brief Class that represents the Jacobi (diagonal) preconditioner of a
+ * matrix operator \f$A\f$, i.e. the linear operator
+ * \f$M^{-1}=\text{diag}(A)^{-1}\f$, for use with the iterative linear
+ * solvers (see CIterativeLinearSolver::set_preconditioner).
+ */
+template<class T> class CJacobiPreconditioner : public CLinearOperator<T>
+{
+/** this class has support for complex128_t */
+typedef bool supports_complex128_t;
+
+public:
+	/** default constructor */
+	CJacobiPreconditioner();
+
+	/**
+	 * constructor
+	 *
+	 * @param op the matrix operator whose diagonal is used, which must not
+	 * have zeros on its diagonal
+	 */
+	explicit CJacobiPreconditioner(CMatrixOperator<T>* op);
+
+	/** destructor */
+	virtual ~CJacobiPreconditioner();
+
+	/**
+	 * method that scales each entry of a vector with the inverse of the
+	 * corresponding diagonal entry
+	 *
+	 * @param b the vector to which the preconditioner applies
+	 * @return the result vector
+	 */
+	virtual SGVector<T> apply(SGVector<T> b) const;
+
+	/** @return the inverse of the diagonal */
+	SGVector<T> get_inverse_diagonal() const
+	{
+		return m_inverse_diagonal;
+	}
+
+	/** @return object name */
+	virtual const char* get_name() const
+	{
+		return "JacobiPreconditioner";
+	}
+
+private:
+	/** the inverse of the diagonal */
+	SGVector<T> m_inverse_diagonal;
+
+	/** initialize with default values and register params */
+	void init();
+};
+
+}
+
+#endif // JACOBI_PRECONDITIONER_H_
@@ -13,10 +13,13 @@
 #include <shogun/lib/config.h>
 #include <shogun/base/SGObject.h>
 #include <shogun/base/Parameter.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+
+#include <string.h>
 
 namespace shogun
 {
-template<class T> class SGVector;
 
 /** @brief Abstract template base class that represents a linear operator,
  *  e.g. a matrix
@@ -68,6 +71,29 @@ public:
 	 */
 	virtual SGVector<T> apply(SGVector<T> b) const = 0;
 
+	/**
+	 * method that applies the linear operator to every column of a matrix.
+	 * This default applies it column by column, operators which can apply
+	 * it to all columns in one pass override it.
+	 *
+	 * @param b the matrix to whose columns the linear operator applies
+	 * @return the result matrix
+	 */
+	virtual SGMatrix<T> apply_block(SGMatrix<T> b) const
+	{
+		SGMatrix<T> result;
+		for (index_t i=0; i<b.num_cols; ++i)
+		{
+			SGVector<T> col=apply(SGVector<T>(b.get_column_vector(i),
+				b.num_rows, false));
+			if (i==0)
+				result=SGMatrix<T>(col.vlen, b.num_cols);
+			memcpy(result.get_column_vector(i), col.vector, sizeof(T)*col.vlen);
+		}
+
+		return result;
+	}
+
 	/** @return object name */
 	virtual const char* get_name() const
 	{
@@ -9,6 +9,7 @@
 
 #include <shogun/lib/config.h>
 #include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/SGSparseMatrix.h>
 #include <shogun/lib/SGSparseVector.h>
 #include <shogun/base/Parameter.h>
@@ -234,8 +235,73 @@ SGVector<T> CSparseMatrixOperator<T>::apply(SGVector<T> b) const
 			"Number of rows of vector must be equal to the "
 			"number of cols of the operator!\n");
 
-		SGVector<T> result(m_operator.num_vectors);
-		result=m_operator*b;
+		const index_t num_rows=m_operator.num_vectors;
+		const T* in=b.vector;
+
+		// rows are independent, dynamic scheduling balances rows with
+		// very different numbers of nonzeros
+		SGVector<T> result(num_rows);
+		#pragma omp parallel for num_threads(this->parallel->get_num_threads()) \
+			schedule(dynamic, 256)
+		for (index_t i=0; i<num_rows; ++i)
+		{
+			const SGSparseVector<T>& row=m_operator.sparse_matrix[i];
+			T sum=static_cast<T>(0);
+			for (index_t k=0; k<row.num_feat_entries; ++k)
+				sum+=in[row.features[k].feat_index]*row.features[k].entry;
+			result[i]=sum;
+		}
+
+		return result;
+	}
+
+template<class T>
+SGMatrix<T> CSparseMatrixOperator<T>::apply_block(SGMatrix<T> b) const
+	{
+		REQUIRE(m_operator.sparse_matrix, "Operator not initialized!\n");
+		REQUIRE(this->get_dimension()==b.num_rows,
+			"Number of rows of matrix must be equal to the "
+			"number of cols of the operator!\n");
+
+		const index_t num_rows=m_operator.num_vectors;
+		const index_t num_cols=b.num_cols;
+		const int32_t num_threads=this->parallel->get_num_threads();
+
+		// rows of b are stored contiguously, so that each nonzero
+		// reads the entries of all columns from the same cache lines
+		SGVector<T> b_rows(b.num_rows*num_cols);
+		#pragma omp parallel for num_threads(num_threads)
+		for (index_t i=0; i<b.num_rows; ++i)
+		{
+			for (index_t j=0; j<num_cols; ++j)
+				b_rows[i*num_cols+j]=b(i, j);
+		}
+
+		SGVector<T> result_rows(num_rows*num_cols);
+		#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 64)
+		for (index_t i=0; i<num_rows; ++i)
+		{
+			T* out=result_rows.vector+i*num_cols;
+			for (index_t j=0; j<num_cols; ++j)
+				out[j]=static_cast<T>(0);
+
+			const SGSparseVector<T>& row=m_operator.sparse_matrix[i];
+			for (index_t k=0; k<row.num_feat_entries; ++k)
+			{
+				const T entry=row.features[k].entry;
+				const T* in=b_rows.vector+row.features[k].feat_index*num_cols;
+				for (index_t j=0; j<num_cols; ++j)
+					out[j]+=entry*in[j];
+			}
+		}
+
+		SGMatrix<T> result(num_rows, num_cols);
+		#pragma omp parallel for num_threads(num_threads)
+		for (index_t i=0; i<num_rows; ++i)
+		{
+			for (index_t j=0; j<num_cols; ++j)
+				result(i, j)=result_rows[i*num_cols+j];
+		}
 
 		return result;
 	}
@@ -243,6 +309,13 @@ SGVector<T> CSparseMatrixOperator<T>::apply(SGVector<T> b) const
 #define UNDEFINED(type) \
 template<> \
 SGVector<type> CSparseMatrixOperator<type>::apply(SGVector<type> b) const \
+	{	\
+		SG_SERROR("Not supported for %s\n", #type);\
+		return b; \
+	} \
+\
+template<> \
+SGMatrix<type> CSparseMatrixOperator<type>::apply_block(SGMatrix<type> b) const \
 	{	\
 		SG_SERROR("Not supported for %s\n", #type);\
 		return b; \
@@ -18,6 +18,7 @@
 namespace shogun
 {
 template<class T> class SGVector;
+template<class T> class SGMatrix;
 template<class T> class SGSparseMatrix;
 
 /** @brief Struct that represents the sparsity structure of the Sparse Matrix
@@ -122,13 +123,24 @@ public:
 	~CSparseMatrixOperator();
 
 	/**
-	 * method that applies the sparse-matrix linear operator to a vector
+	 * method that applies the sparse-matrix linear operator to a vector,
+	 * in parallel over the rows of the sparse matrix
 	 *
 	 * @param b the vector to which the linear operator applies
 	 * @return the result vector
 	 */
 	virtual SGVector<T> apply(SGVector<T> b) const;
 
+	/**
+	 * method that applies the sparse-matrix linear operator to all columns
+	 * of a matrix in one pass over the sparse matrix, in parallel over its
+	 * rows
+	 *
+	 * @param b the matrix to whose columns the linear operator applies
+	 * @return the result matrix
+	 */
+	virtual SGMatrix<T> apply_block(SGMatrix<T> b) const;
+
 	/**
 	 * method that sets the main diagonal of the matrix
 	 *
@@ -12,6 +12,7 @@
 #ifdef HAVE_EIGEN3
 
 #include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/Time.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/Math.h>
@@ -24,6 +25,42 @@ using namespace Eigen;
 namespace shogun
 {
 
+/** dot products of pairs of columns of X and Y with n rows, summed over
+ * contiguous row ranges per thread and then in order, so that the result
+ * does not depend on scheduling
+ */
+static void column_dots(const float64_t* X, const SGVector<index_t>& x_cols,
+	const float64_t* Y, const SGVector<index_t>& y_cols, index_t n,
+	SGVector<float64_t>& dots, int32_t num_threads)
+{
+	const index_t m=x_cols.vlen;
+	SGMatrix<float64_t> partial(m, num_threads);
+	partial.zero();
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (int32_t t=0; t<num_threads; ++t)
+	{
+		const index_t begin=int64_t(n)*t/num_threads;
+		const index_t end=int64_t(n)*(t+1)/num_threads;
+		for (index_t j=0; j<m; ++j)
+		{
+			const float64_t* x=X+int64_t(x_cols[j])*n;
+			const float64_t* y=Y+int64_t(y_cols[j])*n;
+			float64_t sum=0.0;
+			for (index_t i=begin; i<end; ++i)
+				sum+=x[i]*y[i];
+			partial(j, t)=sum;
+		}
+	}
+
+	for (index_t j=0; j<m; ++j)
+	{
+		dots[j]=0.0;
+		for (int32_t t=0; t<num_threads; ++t)
+			dots[j]+=partial(j, t);
+	}
+}
+
 CCGMShiftedFamilySolver::CCGMShiftedFamilySolver()
 	: CIterativeShiftedLinearFamilySolver<float64_t, complex128_t>()
 {
@@ -63,6 +100,8 @@ SGVector<complex128_t> CCGMShiftedFamilySolver::solve_shifted_weighted(
 	REQUIRE(weights.vector,"Weights are not initialized!\n");
 	REQUIRE(shifts.vlen==weights.vlen, "Number of shifts and number of "
 		"weights are not equal! [%d vs %d]\n", shifts.vlen, weights.vlen);
+	REQUIRE(!m_preconditioner, "Preconditioning is not supported, the "
+		"Krylov subspace of the preconditioned system is not shift invariant!\n");
 
 	// the solution matrix, one column per shift, initial guess 0 for all
 	MatrixXcd x_sh=MatrixXcd::Zero(b.vlen, shifts.vlen);
@@ -186,6 +225,10 @@ SGVector<complex128_t> CCGMShiftedFamilySolver::solve_shifted_weighted(
 	if (!it.succeeded(r))
 		SG_WARNING("Did not converge!\n");
 
+	m_num_iterations=it.get_iter_info().iteration_count;
+	m_residual_norm=it.get_iter_info().residual_norm;
+	m_convergence_rate=it.get_convergence_rate();
+
 	SG_INFO("Iteration took %ld times, residual norm=%.20lf, time elapsed=%lf\n",
 		it.get_iter_info().iteration_count, it.get_iter_info().residual_norm, elapsed);
 
@@ -201,5 +244,286 @@ SGVector<complex128_t> CCGMShiftedFamilySolver::solve_shifted_weighted(
 	return result;
 }
 
+SGMatrix<complex128_t> CCGMShiftedFamilySolver::solve_shifted_weighted_block(
+	CLinearOperator<float64_t>* A, SGMatrix<float64_t> B,
+	SGVector<complex128_t> shifts, SGVector<complex128_t> weights)
+{
+	SG_DEBUG("Entering\n");
+
+	// sanity check
+	REQUIRE(A, "Operator is NULL!\n");
+	REQUIRE(A->get_dimension()==B.num_rows, "Dimension mismatch! [%d vs %d]\n",
+		A->get_dimension(), B.num_rows);
+	REQUIRE(shifts.vector,"Shifts are not initialized!\n");
+	REQUIRE(weights.vector,"Weights are not initialized!\n");
+	REQUIRE(shifts.vlen==weights.vlen, "Number of shifts and number of "
+		"weights are not equal! [%d vs %d]\n", shifts.vlen, weights.vlen);
+	REQUIRE(!m_preconditioner, "Preconditioning is not supported, the "
+		"Krylov subspace of the preconditioned system is not shift invariant!\n");
+
+	const index_t n=B.num_rows;
+	const index_t k=B.num_cols;
+	const index_t num_shifts=shifts.vlen;
+	const int32_t num_threads=parallel->get_num_threads();
+
+	// the solution and shifted directions, num_shifts columns per vector,
+	// initial guess 0 for all
+	SGMatrix<complex128_t> x_sh(n, num_shifts*k);
+	SGMatrix<complex128_t> p_sh(n, num_shifts*k);
+	x_sh.zero();
+
+	// residuals r_0=b and non-shifted directions p_0=r_0
+	SGMatrix<float64_t> r(n, k);
+	SGMatrix<float64_t> p(n, k);
+	memcpy(r.matrix, B.matrix, sizeof(float64_t)*n*k);
+	memcpy(p.matrix, B.matrix, sizeof(float64_t)*n*k);
+
+	#pragma omp parallel for num_threads(num_threads)
+	for (index_t i=0; i<n; ++i)
+	{
+		for (index_t c=0; c<k; ++c)
+		{
+			for (index_t s=0; s<num_shifts; ++s)
+				p_sh(i, c*num_shifts+s)=r(i, c);
+		}
+	}
+
+	// non shifted quantities per vector
+	SGVector<index_t> all_cols(k);
+	all_cols.range_fill();
+	SGVector<float64_t> r_norm2(k);
+	column_dots(r.matrix, all_cols, r.matrix, all_cols, n, r_norm2, num_threads);
+
+	SGVector<float64_t> beta_old(k);
+	SGVector<float64_t> alpha(k);
+	SGVector<float64_t> beta(k);
+	SGVector<float64_t> tolerence(k);
+	beta_old.set_const(1.0);
+	alpha.set_const(1.0);
+
+	// shifted quantities, one column per vector
+	SGMatrix<complex128_t> alpha_sh(num_shifts, k);
+	SGMatrix<complex128_t> beta_sh(num_shifts, k);
+	SGMatrix<complex128_t> zeta_sh_old(num_shifts, k);
+	SGMatrix<complex128_t> zeta_sh_cur(num_shifts, k);
+	SGMatrix<complex128_t> zeta_sh_new(num_shifts, k);
+	zeta_sh_old.set_const(1.0);
+	zeta_sh_cur.set_const(1.0);
+
+	// vectors which are still iterated, as IterativeSolverIterator does
+	SGVector<bool> active(k);
+	index_t num_active=0;
+	for (index_t c=0; c<k; ++c)
+	{
+		tolerence[c]=m_absolute_tolerence
+			+m_relative_tolerence*CMath::sqrt(r_norm2[c]);
+		active[c]=CMath::sqrt(r_norm2[c])>=tolerence[c]
+			&& m_max_iteration_limit>0;
+		num_active+=active[c];
+	}
+
+	// start the timer
+	CTime time;
+	time.start();
+
+	// set the residuals to zero
+	if (m_store_residuals)
+		m_residuals.set_const(0.0);
+
+	index_t iteration_count=0;
+	while (num_active>0)
+	{
+		// columns of the active vectors, and of their products with A
+		SGVector<index_t> cols(num_active);
+		SGVector<index_t> block_cols(num_active);
+		for (index_t c=0, j=0; c<k; ++c)
+		{
+			if (active[c])
+			{
+				cols[j]=c;
+				block_cols[j]=j;
+				++j;
+			}
+		}
+
+		if (m_store_residuals)
+		{
+			float64_t residual_norm=0.0;
+			for (index_t j=0; j<num_active; ++j)
+				residual_norm=CMath::max(residual_norm, CMath::sqrt(r_norm2[cols[j]]));
+			m_residuals[iteration_count]=residual_norm;
+		}
+
+		SG_DEBUG("CG iteration %d, %d vectors active\n", iteration_count,
+			num_active);
+
+		// apply linear operator to all active direction vectors at once
+		SGMatrix<float64_t> p_block=p;
+		if (num_active<k)
+		{
+			p_block=SGMatrix<float64_t>(n, num_active);
+			for (index_t j=0; j<num_active; ++j)
+			{
+				memcpy(p_block.get_column_vector(j), p.get_column_vector(cols[j]),
+					sizeof(float64_t)*n);
+			}
+		}
+		SGMatrix<float64_t> Ap=A->apply_block(p_block);
+
+		// compute p^{T}Ap, if zero, failure
+		SGVector<float64_t> p_dot_Ap(num_active);
+		column_dots(p.matrix, cols, Ap.matrix, block_cols, n, p_dot_Ap,
+			num_threads);
+
+		for (index_t j=0; j<num_active; ++j)
+		{
+			const index_t c=cols[j];
+
+			// compute the beta parameter of CG_M, zero for failed vectors
+			// so that the updates below leave them unchanged
+			if (p_dot_Ap[j]==0.0)
+			{
+				beta[c]=0.0;
+				SGVector<complex128_t>(beta_sh.get_column_vector(c),
+					num_shifts, false).set_const(0.0);
+				continue;
+			}
+			beta[c]=-r_norm2[c]/p_dot_Ap[j];
+
+			// compute the zeta-shifted and beta-shifted parameters of CG_M
+			SGVector<complex128_t> zeta_new(zeta_sh_new.get_column_vector(c),
+				num_shifts, false);
+			SGVector<complex128_t> beta_sh_c(beta_sh.get_column_vector(c),
+				num_shifts, false);
+
+			compute_zeta_sh_new(SGVector<complex128_t>(
+				zeta_sh_old.get_column_vector(c), num_shifts, false),
+				SGVector<complex128_t>(zeta_sh_cur.get_column_vector(c),
+				num_shifts, false), shifts, beta_old[c], beta[c], alpha[c],
+				zeta_new);
+
+			compute_beta_sh(zeta_new, SGVector<complex128_t>(
+				zeta_sh_cur.get_column_vector(c), num_shifts, false), beta[c],
+				beta_sh_c);
+		}
+
+		// update the solution vectors and residuals
+		#pragma omp parallel for num_threads(num_threads)
+		for (index_t i=0; i<n; ++i)
+		{
+			for (index_t j=0; j<num_active; ++j)
+			{
+				const index_t c=cols[j];
+				for (index_t s=0; s<num_shifts; ++s)
+					x_sh(i, c*num_shifts+s)-=beta_sh(s, c)*p_sh(i, c*num_shifts+s);
+
+				// r_{i}=r_{i-1}+\beta_{i}Ap
+				r(i, c)+=beta[c]*Ap(i, j);
+			}
+		}
+
+		// compute new ||r||_{2}, if zero, converged
+		SGVector<float64_t> r_norm2_i(num_active);
+		column_dots(r.matrix, cols, r.matrix, cols, n, r_norm2_i, num_threads);
+
+		for (index_t j=0; j<num_active; ++j)
+		{
+			const index_t c=cols[j];
+			if (p_dot_Ap[j]==0.0 || r_norm2_i[j]==0.0)
+			{
+				active[c]=false;
+				continue;
+			}
+
+			// compute the alpha parameter of CG_M
+			alpha[c]=r_norm2_i[j]/r_norm2[c];
+
+			// update ||r||_{2}
+			r_norm2[c]=r_norm2_i[j];
+
+			SGVector<complex128_t> alpha_sh_c(alpha_sh.get_column_vector(c),
+				num_shifts, false);
+
+			compute_alpha_sh(SGVector<complex128_t>(
+				zeta_sh_new.get_column_vector(c), num_shifts, false),
+				SGVector<complex128_t>(zeta_sh_cur.get_column_vector(c),
+				num_shifts, false), SGVector<complex128_t>(
+				beta_sh.get_column_vector(c), num_shifts, false), beta[c],
+				alpha[c], alpha_sh_c);
+		}
+
+		// update directions
+		#pragma omp parallel for num_threads(num_threads)
+		for (index_t i=0; i<n; ++i)
+		{
+			for (index_t j=0; j<num_active; ++j)
+			{
+				const index_t c=cols[j];
+				if (!active[c])
+					continue;
+
+				p(i, c)=r(i, c)+alpha[c]*p(i, c);
+				for (index_t s=0; s<num_shifts; ++s)
+				{
+					complex128_t& p_sh_i=p_sh(i, c*num_shifts+s);
+					p_sh_i=alpha_sh(s, c)*p_sh_i+zeta_sh_new(s, c)*r(i, c);
+				}
+			}
+		}
+
+		// update parameters and check convergence
+		++iteration_count;
+		num_active=0;
+		for (index_t j=0; j<cols.vlen; ++j)
+		{
+			const index_t c=cols[j];
+			if (!active[c])
+				continue;
+
+			for (index_t s=0; s<num_shifts; ++s)
+			{
+				zeta_sh_old(s, c)=zeta_sh_cur(s, c);
+				zeta_sh_cur(s, c)=zeta_sh_new(s, c);
+			}
+			beta_old[c]=beta[c];
+
+			active[c]=CMath::sqrt(r_norm2[c])>=tolerence[c]
+				&& iteration_count<m_max_iteration_limit;
+			num_active+=active[c];
+		}
+	}
+
+	float64_t elapsed=time.cur_time_diff();
+
+	SG_INFO("Iteration took %d times for %d vectors, time elapsed=%lf\n",
+		iteration_count, k, elapsed);
+
+	// compute the final result vectors multiplied by weights
+	SGMatrix<complex128_t> result(n, k);
+	#pragma omp parallel for num_threads(num_threads)
+	for (index_t i=0; i<n; ++i)
+	{
+		for (index_t c=0; c<k; ++c)
+		{
+			result(i, c)=0.0;
+			for (index_t s=0; s<num_shifts; ++s)
+				result(i, c)+=x_sh(i, c*num_shifts+s)*weights[s];
+		}
+	}
+
+	for (index_t c=0; c<k; ++c)
+	{
+		// recompute the true residual norm, as the single vector solver does
+		float64_t residual_norm2=0.0;
+		for (index_t i=0; i<n; ++i)
+			residual_norm2+=r(i, c)*r(i, c);
+		if (CMath::sqrt(residual_norm2)>=tolerence[c])
+			SG_WARNING("Did not converge for vector %d!\n", c);
+	}
+
+	SG_DEBUG("Leaving\n");
+	return result;
+}
+
 }
 #endif // HAVE_EIGEN3
@@ -19,12 +19,16 @@ namespace shogun
 {
 template<class T> class CLinearOperator;
 template<class T> class SGVector;
+template<class T> class SGMatrix;
 
 /**
  * @brief class that uses conjugate gradient method for solving a shifted
  * linear system family where the linear opeator is real valued and symmetric
  * positive definite, the vector is real valued, but the shifts are complex
  *
+ * Preconditioners are not supported, since the Krylov subspace of a
+ * preconditioned system is not invariant under the shifts.
+ *
  * Note: The implementation of solve_shifted_weighted has been adapted from the
  * open source library Krylstat (https://github.com/Froskekongen/KRYLSTAT/),
  * written by Erlend Aune, under GPL2+
@@ -68,6 +72,27 @@ public:
 		CLinearOperator<float64_t>* A, SGVector<float64_t> b,
 		SGVector<complex128_t> shifts, SGVector<complex128_t> weights);
 
+	/**
+	 * method that solves the shifted family of linear systems for every
+	 * column of a matrix, e.g. a block of probing vectors. The columns
+	 * run CG-M simultaneously, so that each iteration applies the operator
+	 * to all search directions at once (see
+	 * CLinearOperator::apply_block) and the vector updates are parallel
+	 * over rows. Each column keeps its own CG-M scalars and stops on its
+	 * own tolerance, so the result for each column is the one of
+	 * solve_shifted_weighted.
+	 *
+	 * @param A the linear operator of the system
+	 * @param B the matrix whose columns are the vectors of the systems
+	 * @param shifts the shifts of the shifted system
+	 * @param weights the weights to be multiplied with each solution for each
+	 * shift
+	 * @return the matrix whose columns are the weighted sums of solutions
+	 */
+	virtual SGMatrix<complex128_t> solve_shifted_weighted_block(
+		CLinearOperator<float64_t>* A, SGMatrix<float64_t> B,
+		SGVector<complex128_t> shifts, SGVector<complex128_t> weights);
+
 	/** @return object name */
 	virtual const char* get_name() const
 	{
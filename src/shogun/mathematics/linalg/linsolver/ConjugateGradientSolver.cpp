@@ -23,6 +23,15 @@ using namespace Eigen;
 namespace shogun
 {
 
+/** applies the preconditioner M to the residual r, z=M^{-1}r */
+static void apply_preconditioner(CLinearOperator<float64_t>* M, const VectorXd& r,
+	VectorXd& z)
+{
+	SGVector<float64_t> r_(const_cast<float64_t*>(r.data()), r.size(), false);
+	SGVector<float64_t> z_=M->apply(r_);
+	z=Map<VectorXd>(z_.vector, z_.vlen);
+}
+
 CConjugateGradientSolver::CConjugateGradientSolver()
 	: CIterativeLinearSolver<float64_t>()
 {
@@ -64,15 +73,22 @@ SGVector<float64_t> CConjugateGradientSolver::solve(
 	// residual r_i=b-Ax_i, here x_0=[0], so r_0=b
 	VectorXd r=b_map;
 
-	// initial direction is same as residual
-	p=r;
+	// preconditioned residual z_i=M^{-1}r_i, the residual itself if there
+	// is no preconditioner
+	VectorXd z_;
+	const VectorXd& z=m_preconditioner ? z_ : r;
+	if (m_preconditioner)
+		apply_preconditioner(m_preconditioner, r, z_);
+
+	// initial direction is same as preconditioned residual
+	p=z;
 
 	// the iterator for this iterative solver
 	IterativeSolverIterator<float64_t> it(b_map, m_max_iteration_limit,
 		m_relative_tolerence, m_absolute_tolerence);
 
 	// CG iteration begins
-	float64_t r_norm2=r.dot(r);
+	float64_t r_dot_z=r.dot(z);
 
 	// start the timer
 	CTime time;
@@ -104,7 +120,7 @@ SGVector<float64_t> CConjugateGradientSolver::solve(
 			break;
 
 		// compute the alpha parameter of CG
-		float64_t alpha=r_norm2/p_dot_Ap;
+		float64_t alpha=r_dot_z/p_dot_Ap;
 
 		// update the solution vector and residual
 		// x_{i}=x_{i-1}+\alpha_{i}p
@@ -113,17 +129,22 @@ SGVector<float64_t> CConjugateGradientSolver::solve(
 		// r_{i}=r_{i-1}-\alpha_{i}p
 		r-=alpha*Ap;
 
-		// compute new ||r||_{2}, if zero, converged
-		float64_t r_norm2_i=r.dot(r);
-		if (r_norm2_i==0.0)
+		// z_{i}=M^{-1}r_{i}
+		if (m_preconditioner)
+			apply_preconditioner(m_preconditioner, r, z_);
+
+		// compute new r^{T}z, which is ||r||_{2} without preconditioner,
+		// if zero, converged
+		float64_t r_dot_z_i=r.dot(z);
+		if (r_dot_z_i==0.0)
 			break;
 
 		// compute the beta parameter of CG
-		float64_t beta=r_norm2_i/r_norm2;
+		float64_t beta=r_dot_z_i/r_dot_z;
 
-		// update direction, and ||r||_{2}
-		r_norm2=r_norm2_i;
-		p=r+beta*p;
+		// update direction, and r^{T}z
+		r_dot_z=r_dot_z_i;
+		p=z+beta*p;
 	}
 
 	float64_t elapsed=time.cur_time_diff();
@@ -131,6 +152,10 @@ SGVector<float64_t> CConjugateGradientSolver::solve(
 	if (!it.succeeded(r))
 		SG_WARNING("Did not converge!\n");
 
+	m_num_iterations=it.get_iter_info().iteration_count;
+	m_residual_norm=it.get_iter_info().residual_norm;
+	m_convergence_rate=it.get_convergence_rate();
+
 	SG_INFO("Iteration took %ld times, residual norm=%.20lf, time elapsed=%lf\n",
 		it.get_iter_info().iteration_count, it.get_iter_info().residual_norm, elapsed);
 
@@ -24,6 +24,9 @@ template<class T> class SGVector;
  * @brief class that uses conjugate gradient method of solving a linear system
  * involving a real valued linear operator and vector. Useful for large sparse
  * systems involving sparse symmetric and positive-definite matrices.
+ *
+ * With a preconditioner, which has to be symmetric positive-definite as
+ * well, the preconditioned conjugate gradient method is used.
  */
 class CConjugateGradientSolver : public CIterativeLinearSolver<float64_t, float64_t>
 {
@@ -23,6 +23,15 @@ using namespace Eigen;
 namespace shogun
 {
 
+/** applies the preconditioner M to the residual r, z=M^{-1}r */
+static void apply_preconditioner(CLinearOperator<complex128_t>* M, const VectorXcd& r,
+	VectorXcd& z)
+{
+	SGVector<complex128_t> r_(const_cast<complex128_t*>(r.data()), r.size(), false);
+	SGVector<complex128_t> z_=M->apply(r_);
+	z=Map<VectorXcd>(z_.vector, z_.vlen);
+}
+
 CConjugateOrthogonalCGSolver::CConjugateOrthogonalCGSolver()
 	: CIterativeLinearSolver<complex128_t, float64_t>()
 {
@@ -65,8 +74,15 @@ SGVector<complex128_t> CConjugateOrthogonalCGSolver::solve(
 	// residual r_i=b-Ax_i, here x_0=[0], so r_0=b
 	VectorXcd r=b_map.cast<complex128_t>();
 
-	// initial direction is same as residual
-	p=r;
+	// preconditioned residual z_i=M^{-1}r_i, the residual itself if there
+	// is no preconditioner
+	VectorXcd z_;
+	const VectorXcd& z=m_preconditioner ? z_ : r;
+	if (m_preconditioner)
+		apply_preconditioner(m_preconditioner, r, z_);
+
+	// initial direction is same as preconditioned residual
+	p=z;
 
 	// the iterator for this iterative solver
 	IterativeSolverIterator<complex128_t> it(r, m_max_iteration_limit,
@@ -81,7 +97,7 @@ SGVector<complex128_t> CConjugateOrthogonalCGSolver::solve(
 		m_residuals.set_const(0.0);
 
 	// CG iteration begins
-	complex128_t r_norm2=r.transpose()*r;
+	complex128_t r_T_times_z=r.transpose()*z;
 
 	for (it.begin(r); !it.end(r); ++it)
 	{
@@ -105,7 +121,7 @@ SGVector<complex128_t> CConjugateOrthogonalCGSolver::solve(
 			break;
 
 		// compute the alpha parameter of CG
-		complex128_t alpha=r_norm2/p_T_times_Ap;
+		complex128_t alpha=r_T_times_z/p_T_times_Ap;
 
 		// update the solution vector and residual
 		// x_{i}=x_{i-1}+\alpha_{i}p
@@ -114,17 +130,21 @@ SGVector<complex128_t> CConjugateOrthogonalCGSolver::solve(
 		// r_{i}=r_{i-1}-\alpha_{i}p
 		r-=alpha*Ap;
 
-		// compute new ||r||_{2}, if zero, converged
-		complex128_t r_norm2_i=r.transpose()*r;
-		if (r_norm2_i==0.0)
+		// z_{i}=M^{-1}r_{i}
+		if (m_preconditioner)
+			apply_preconditioner(m_preconditioner, r, z_);
+
+		// compute new r^{T}z, if zero, converged
+		complex128_t r_T_times_z_i=r.transpose()*z;
+		if (r_T_times_z_i==0.0)
 			break;
 
 		// compute the beta parameter of CG
-		complex128_t beta=r_norm2_i/r_norm2;
+		complex128_t beta=r_T_times_z_i/r_T_times_z;
 
-		// update direction, and ||r||_{2}
-		r_norm2=r_norm2_i;
-		p=r+beta*p;
+		// update direction, and r^{T}z
+		r_T_times_z=r_T_times_z_i;
+		p=z+beta*p;
 	}
 
 	float64_t elapsed=time.cur_time_diff();
@@ -132,6 +152,10 @@ SGVector<complex128_t> CConjugateOrthogonalCGSolver::solve(
 	if (!it.succeeded(r))
 		SG_WARNING("Did not converge!\n");
 
+	m_num_iterations=it.get_iter_info().iteration_count;
+	m_residual_norm=it.get_iter_info().residual_norm;
+	m_convergence_rate=it.get_convergence_rate();
+
 	SG_INFO("Iteration took %ld times, residual norm=%.20lf, time elapsed=%lf\n",
 		it.get_iter_info().iteration_count, it.get_iter_info().residual_norm, elapsed);
 
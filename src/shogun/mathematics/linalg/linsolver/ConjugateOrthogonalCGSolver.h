@@ -29,6 +29,9 @@ template<class T> class SGVector;
  * Reference: Vorst, Melissen, "A Petrov-Galerkin Type Method for Solving Ax=b,
  * Where A Is Symmetric Complex". IEEE Transactions on Magnetics, Vol. 26,
  * No. 2, March 1990
+ *
+ * With a preconditioner, which has to be symmetric as well, the
+ * preconditioned COCG method is used.
  */
 class CConjugateOrthogonalCGSolver
  : public CIterativeLinearSolver<complex128_t, float64_t>
@@ -9,6 +9,7 @@
 
 #include <shogun/lib/common.h>
 #include <shogun/base/Parameter.h>
+#include <shogun/mathematics/linalg/linop/LinearOperator.h>
 #include <shogun/mathematics/linalg/linsolver/IterativeLinearSolver.h>
 
 namespace shogun
@@ -41,6 +42,10 @@ void CIterativeLinearSolver<T, ST>::init()
 		m_relative_tolerence=1E-5;
 		m_absolute_tolerence=1E-5;
 		m_store_residuals=false;
+		m_preconditioner=NULL;
+		m_num_iterations=0;
+		m_residual_norm=0.0;
+		m_convergence_rate=0.0;
 
 		this->m_parameters->add(&m_max_iteration_limit, "max_iteration_limit",
 			"Maximum number of iteration for the solver");
@@ -56,11 +61,40 @@ void CIterativeLinearSolver<T, ST>::init()
 
 		this->m_parameters->add(&m_residuals, "residuals",
 			"Residuals for each iterations");
+
+		this->m_parameters->add((CSGObject**)&m_preconditioner, "preconditioner",
+			"Preconditioner applied to the residuals");
+
+		this->m_parameters->add(&m_num_iterations, "num_iterations",
+			"Number of iterations of the last solve");
+
+		this->m_parameters->add(&m_residual_norm, "residual_norm",
+			"Residual norm after the last solve");
+
+		this->m_parameters->add(&m_convergence_rate, "convergence_rate",
+			"Convergence rate of the last solve");
 	}
 
 template <class T, class ST>
 CIterativeLinearSolver<T, ST>::~CIterativeLinearSolver()
 	{
+		SG_UNREF(m_preconditioner);
+	}
+
+template <class T, class ST>
+void CIterativeLinearSolver<T, ST>::set_preconditioner(
+	CLinearOperator<T>* preconditioner)
+	{
+		SG_REF(preconditioner);
+		SG_UNREF(m_preconditioner);
+		m_preconditioner=preconditioner;
+	}
+
+template <class T, class ST>
+CLinearOperator<T>* CIterativeLinearSolver<T, ST>::get_preconditioner() const
+	{
+		SG_REF(m_preconditioner);
+		return m_preconditioner;
 	}
 
 template class CIterativeLinearSolver<float64_t>;
@@ -20,6 +20,13 @@ namespace shogun
  * @brief abstract template base for all iterative linear solvers such as
  * conjugate gradient (CG) solvers. provides interface for setting the
  * iteration limit, relative/absolute tolerence. solve method is abstract.
+ *
+ * Solvers which support preconditioning apply an optional preconditioner,
+ * a linear operator \f$M^{-1}\f$ approximating the inverse of the system
+ * operator, to their residuals (see CJacobiPreconditioner and
+ * CIncompleteCholeskyPreconditioner). After a solve, the number of
+ * iterations, the final residual norm and the convergence rate can be
+ * queried.
  */
 template<class T, class ST=T> class CIterativeLinearSolver : public CLinearSolver<T, ST>
 {
@@ -90,6 +97,38 @@ public:
 		return m_residuals;
 	}
 
+	/**
+	 * set the preconditioner, NULL for none
+	 *
+	 * @param preconditioner linear operator approximating the inverse of
+	 * the operators of the systems to be solved
+	 */
+	void set_preconditioner(CLinearOperator<T>* preconditioner);
+
+	/** @return the preconditioner */
+	CLinearOperator<T>* get_preconditioner() const;
+
+	/** @return number of iterations of the last solve */
+	const index_t get_num_iterations() const
+	{
+		return m_num_iterations;
+	}
+
+	/** @return residual norm after the last solve */
+	const float64_t get_residual_norm() const
+	{
+		return m_residual_norm;
+	}
+
+	/**
+	 * @return average factor by which the residual norm decreased per
+	 * iteration in the last solve
+	 */
+	const float64_t get_convergence_rate() const
+	{
+		return m_convergence_rate;
+	}
+
 	/** @return object name */
 	virtual const char* get_name() const
 	{
@@ -112,6 +151,18 @@ protected:
 
 	/** whether to store the residuals */
 	bool m_store_residuals;
+
+	/** the preconditioner */
+	CLinearOperator<T>* m_preconditioner;
+
+	/** number of iterations of the last solve */
+	index_t m_num_iterations;
+
+	/** residual norm after the last solve */
+	float64_t m_residual_norm;
+
+	/** convergence rate of the last solve */
+	float64_t m_convergence_rate;
 private:
 	/** initialize with default values and register params */
 	void init();
@@ -14,6 +14,9 @@
 
 #ifdef HAVE_EIGEN3
 #include <shogun/mathematics/eigen3.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/base/DynArray.h>
+#include <shogun/mathematics/Math.h>
 
 using namespace Eigen;
 
@@ -31,6 +34,9 @@ typedef struct _IterInfo
 
 	/** iteration count */
 	index_t iteration_count;
+
+	/** norm of the initial residual */
+	float64_t initial_residual_norm;
 } IterInfo;
 
 /**
@@ -40,6 +46,10 @@ typedef struct _IterInfo
  * absolute tolerence. They then call begin with the residual vector and
  * continue until its end returns true, i.e. either it has converged or
  * iteration count reached maximum limit.
+ *
+ * The norm of the residual seen at each iteration is recorded, so that the
+ * convergence of a solve can be inspected afterwards via
+ * get_residual_history() and get_convergence_rate().
  */
 template<class T> class IterativeSolverIterator
 {
@@ -63,10 +73,12 @@ public:
 		float64_t absolute_tolerence=1E-5)
 	: m_max_iteration_limit(max_iteration_limit),
 		m_tolerence(absolute_tolerence+relative_tolerence*b.norm()),
-		m_success(false)
+		m_success(false),
+		m_residual_history(CMath::min(max_iteration_limit, 1023)+1)
 	{
 		m_iter_info.residual_norm=std::numeric_limits<float64_t>::max();
 		m_iter_info.iteration_count=0;
+		m_iter_info.initial_residual_norm=m_iter_info.residual_norm;
 	}
 
 	/** assign operator from an IterInfo */
@@ -74,12 +86,17 @@ public:
 	{
 		m_iter_info.residual_norm=residual.norm();
 		m_iter_info.iteration_count=0;
+		m_iter_info.initial_residual_norm=m_iter_info.residual_norm;
+		m_residual_history.reset(0.0);
+		m_residual_history.append_element(m_iter_info.residual_norm);
 	}
 
 	/** @return true if converged or maximum iteration limit crossed */
 	const bool end(const VectorXt& residual)
 	{
 		m_iter_info.residual_norm=residual.norm();
+		m_residual_history.set_element(m_iter_info.residual_norm,
+			m_iter_info.iteration_count);
 
 		m_success=m_iter_info.residual_norm < m_tolerence;
 		return m_success || m_iter_info.iteration_count >= m_max_iteration_limit;
@@ -100,6 +117,42 @@ public:
 		return m_success;
 	}
 
+	/** @return tolerence on the residual norm for convergence */
+	const float64_t get_tolerence() const
+	{
+		return m_tolerence;
+	}
+
+	/**
+	 * @return the residual norms of the iterations so far, starting with
+	 * the initial residual
+	 */
+	SGVector<float64_t> get_residual_history() const
+	{
+		const index_t len=CMath::min(m_iter_info.iteration_count+1,
+			m_residual_history.get_num_elements());
+		SGVector<float64_t> history(len);
+		for (index_t i=0; i<len; ++i)
+			history[i]=m_residual_history.get_element(i);
+		return history;
+	}
+
+	/**
+	 * @return the average factor by which the residual norm decreased per
+	 * iteration, \f$(\|r_k\|/\|r_0\|)^{1/k}\f$, 0 if the initial residual
+	 * was already zero and 1 if there was no iteration
+	 */
+	const float64_t get_convergence_rate() const
+	{
+		if (m_iter_info.initial_residual_norm==0.0)
+			return 0.0;
+		if (m_iter_info.iteration_count==0)
+			return 1.0;
+
+		return CMath::pow(m_iter_info.residual_norm/m_iter_info.initial_residual_norm,
+			1.0/m_iter_info.iteration_count);
+	}
+
 	/** increment operator */
 	void operator++()
 	{
@@ -118,6 +171,9 @@ private:
 
 	/** true if converged successfully, false otherwise */
 	bool m_success;
+
+	/** residual norm of each iteration, grown as iterations are done */
+	DynArray<float64_t> m_residual_history;
 };
 
 }
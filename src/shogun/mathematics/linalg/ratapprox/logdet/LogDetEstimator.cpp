@@ -11,6 +11,7 @@
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/lib/DynamicObjectArray.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/lib/computation/engine/IndependentComputationEngine.h>
 #include <shogun/lib/computation/jobresult/ScalarResult.h>
 #include <shogun/lib/computation/aggregator/JobResultAggregator.h>
@@ -49,6 +50,7 @@ void CLogDetEstimator::init()
 	m_trace_sampler=NULL;
 	m_operator_log=NULL;
 	m_computation_engine=NULL;
+	m_block_size=1;
 
 	SG_ADD((CSGObject**)&m_trace_sampler, "trace_sampler",
 		"Trace sampler for the log operator", MS_NOT_AVAILABLE);
@@ -58,6 +60,71 @@ void CLogDetEstimator::init()
 
 	SG_ADD((CSGObject**)&m_computation_engine, "computation_engine",
 		"The computation engine for the jobs", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_block_size, "block_size",
+		"Number of trace samples whose jobs are created together",
+		MS_NOT_AVAILABLE);
+}
+
+void CLogDetEstimator::set_block_size(index_t block_size)
+{
+	REQUIRE(block_size>0, "Block size must be positive, given %d\n",
+		block_size);
+	m_block_size=block_size;
+}
+
+index_t CLogDetEstimator::get_block_size() const
+{
+	return m_block_size;
+}
+
+void CLogDetEstimator::submit_all_jobs(index_t num_estimates,
+	CDynamicObjectArray* aggregators)
+{
+	index_t num_trace_samples=m_trace_sampler->get_num_samples();
+	index_t num_samples=num_estimates*num_trace_samples;
+
+	for (index_t begin=0; begin<num_samples; begin+=m_block_size)
+	{
+		index_t end=CMath::min(begin+m_block_size, num_samples);
+
+		if (m_block_size==1)
+		{
+			index_t j=begin%num_trace_samples;
+			SG_DEBUG("Creating job for estimate %d, trace sample %d/%d\n",
+					begin/num_trace_samples, j, num_trace_samples);
+			// get the trace sampler vector
+			SGVector<float64_t> s=m_trace_sampler->sample(j);
+			// create jobs with the sample vector and store the aggregator
+			CJobResultAggregator* agg=m_operator_log->submit_jobs(s);
+			aggregators->append_element(agg);
+			SG_UNREF(agg);
+			continue;
+		}
+
+		SG_DEBUG("Computing log-determinant trace samples %d-%d/%d\n", begin,
+				end-1, num_samples);
+
+		// get the trace sampler vectors of this block, in the same order
+		SGMatrix<float64_t> block(m_trace_sampler->get_dimension(), end-begin);
+		for (index_t k=begin; k<end; ++k)
+		{
+			SGVector<float64_t> s=m_trace_sampler->sample(k%num_trace_samples);
+			memcpy(block.get_column_vector(k-begin), s.vector,
+				sizeof(float64_t)*s.vlen);
+		}
+
+		// create jobs with the sample vectors and store the aggregators
+		CDynamicObjectArray* block_aggregators
+			=m_operator_log->submit_block_jobs(block);
+		for (index_t k=0; k<block_aggregators->get_num_elements(); ++k)
+		{
+			CSGObject* agg=block_aggregators->get_element(k);
+			aggregators->append_element(agg);
+			SG_UNREF(agg);
+		}
+		SG_UNREF(block_aggregators);
+	}
 }
 
 CLogDetEstimator::~CLogDetEstimator()
@@ -89,24 +156,7 @@ SGVector<float64_t> CLogDetEstimator::sample(index_t num_estimates)
 	// for storing the aggregators that submit_jobs return
 	CDynamicObjectArray* aggregators=new CDynamicObjectArray();
 	index_t num_trace_samples=m_trace_sampler->get_num_samples();
-
-	for (index_t i=0; i<num_estimates; ++i)
-	{
-		for (index_t j=0; j<num_trace_samples; ++j)
-		{
-			SG_INFO("Computing log-determinant trace sample %d/%d\n", j,
-					num_trace_samples);
-
-			SG_DEBUG("Creating job for estimate %d, trace sample %d/%d\n", i, j,
-					num_trace_samples);
-			// get the trace sampler vector
-			SGVector<float64_t> s=m_trace_sampler->sample(j);
-			// create jobs with the sample vector and store the aggregator
-			CJobResultAggregator* agg=m_operator_log->submit_jobs(s);
-			aggregators->append_element(agg);
-			SG_UNREF(agg);
-		}
-	}
+	submit_all_jobs(num_estimates, aggregators);
 
 	REQUIRE(m_computation_engine, "Computation engine is NULL\n");
 
@@ -174,19 +224,7 @@ SGMatrix<float64_t> CLogDetEstimator::sample_without_averaging(
 	// for storing the aggregators that submit_jobs return
 	CDynamicObjectArray aggregators;
 	index_t num_trace_samples=m_trace_sampler->get_num_samples();
-
-	for (index_t i=0; i<num_estimates; ++i)
-	{
-		for (index_t j=0; j<num_trace_samples; ++j)
-		{
-			// get the trace sampler vector
-			SGVector<float64_t> s=m_trace_sampler->sample(j);
-			// create jobs with the sample vector and store the aggregator
-			CJobResultAggregator* agg=m_operator_log->submit_jobs(s);
-			aggregators.append_element(agg);
-			SG_UNREF(agg);
-		}
-	}
+	submit_all_jobs(num_estimates, &aggregators);
 
 	REQUIRE(m_computation_engine, "Computation engine is NULL\n");
 	// wait for all the jobs to be completed
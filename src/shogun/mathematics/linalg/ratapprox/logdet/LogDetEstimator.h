@@ -21,10 +21,12 @@ template<class T> class COperatorFunction;
 class CIndependentComputationEngine;
 template<class T> class SGVector;
 template<class T> class SGMatrix;
+class CDynamicObjectArray;
 
 /** @brief Class to create unbiased estimators of \f$log(\left|C\right|)=
- * trace(log(C))\f$. For each estimate, it samples trace vectors (one by one)
- * and calls submit_jobs of COperatorFunction, stores the resulting job result
+ * trace(log(C))\f$. For each estimate, it samples trace vectors (one by one,
+ * or in blocks, see set_block_size) and calls submit_jobs of
+ * COperatorFunction, stores the resulting job result
  * aggregator instances, calls wait_for_all of CIndependentComputationEngine
  * to ensure that the job result aggregators are all up to date. Then simply
  * computes running averages over the estimates
@@ -67,6 +69,19 @@ public:
 	 */
 	SGMatrix<float64_t> sample_without_averaging(index_t num_estimates);
 
+	/**
+	 * set the number of trace samples whose jobs are created together by
+	 * COperatorFunction::submit_block_jobs. Operator functions such as
+	 * CLogRationalApproximationCGM solve for such a block with one operator
+	 * application per iteration. Default 1, one job per trace sample
+	 *
+	 * @param block_size the number of trace samples per block
+	 */
+	void set_block_size(index_t block_size);
+
+	/** @return the number of trace samples per block */
+	index_t get_block_size() const;
+
 	/** @return object name */
 	virtual const char* get_name() const
 	{
@@ -83,8 +98,21 @@ private:
 	/** the computation engine for the independent jobs */
 	CIndependentComputationEngine* m_computation_engine;
 
+	/** the number of trace samples whose jobs are created together */
+	index_t m_block_size;
+
 	/** initialize with default values and register params */
 	void init();
+
+	/**
+	 * creates the jobs for all trace samples of num_estimates estimates,
+	 * block_size samples at a time, and appends their aggregators in the
+	 * order of the samples
+	 *
+	 * @param num_estimates the number of log-det estimates to be computed
+	 * @param aggregators the array to append the aggregators to
+	 */
+	void submit_all_jobs(index_t num_estimates, CDynamicObjectArray* aggregators);
 };
 
 }
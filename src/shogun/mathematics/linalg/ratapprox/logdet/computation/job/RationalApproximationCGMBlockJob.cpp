@@ -0,0 +1,155 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_EIGEN3
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/DynamicObjectArray.h>
+#include <shogun/lib/computation/aggregator/JobResultAggregator.h>
+#include <shogun/lib/computation/jobresult/ScalarResult.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/linalg/linop/LinearOperator.h>
+#include <shogun/mathematics/linalg/linsolver/CGMShiftedFamilySolver.h>
+#include <shogun/mathematics/linalg/ratapprox/logdet/computation/job/RationalApproximationCGMBlockJob.h>
+#include <shogun/base/Parameter.h>
+
+using namespace Eigen;
+
+namespace shogun
+{
+
+CRationalApproximationCGMBlockJob::CRationalApproximationCGMBlockJob()
+	: CIndependentJob()
+{
+	init();
+}
+
+CRationalApproximationCGMBlockJob::CRationalApproximationCGMBlockJob(
+	CDynamicObjectArray* aggregators,
+	CCGMShiftedFamilySolver* linear_solver,
+	CLinearOperator<float64_t>* linear_operator,
+	SGMatrix<float64_t> vectors,
+	SGVector<complex128_t> shifts,
+	SGVector<complex128_t> weights,
+	float64_t const_multiplier)
+	: CIndependentJob()
+{
+	init();
+
+	m_aggregators=aggregators;
+	SG_REF(m_aggregators);
+
+	m_linear_solver=linear_solver;
+	SG_REF(m_linear_solver);
+
+	m_operator=linear_operator;
+	SG_REF(m_operator);
+
+	m_vectors=vectors;
+
+	m_shifts=shifts;
+	m_weights=weights;
+	m_const_multiplier=const_multiplier;
+}
+
+void CRationalApproximationCGMBlockJob::init()
+{
+	m_aggregators=NULL;
+	m_linear_solver=NULL;
+	m_operator=NULL;
+	m_const_multiplier=0.0;
+
+	SG_ADD((CSGObject**)&m_aggregators, "job_result_aggregators",
+		"Job result aggregators, one per sample vector", MS_NOT_AVAILABLE);
+
+	SG_ADD((CSGObject**)&m_linear_solver, "linear_solver",
+		"Linear solver for complex-shifted system", MS_NOT_AVAILABLE);
+
+	SG_ADD((CSGObject**)&m_operator, "linear_operator",
+		"Linear operator", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_vectors, "trace_samples",
+		"Sample vectors to apply linear operator on", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_shifts, "complex_shifts",
+		"Shifts in the linear systems to be solved", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_weights, "complex_weights",
+		"Weights to be multiplied to the solution vector", MS_NOT_AVAILABLE);
+
+	SG_ADD(&m_const_multiplier, "constant_multiplier",
+		"Constant multiplier to be multiplied with the final solution", MS_NOT_AVAILABLE);
+}
+
+CRationalApproximationCGMBlockJob::~CRationalApproximationCGMBlockJob()
+{
+	SG_UNREF(m_aggregators);
+	SG_UNREF(m_linear_solver);
+	SG_UNREF(m_operator);
+}
+
+void CRationalApproximationCGMBlockJob::compute()
+{
+	SG_DEBUG("Entering\n");
+
+	REQUIRE(m_aggregators, "Job result aggregators are not set!\n");
+	REQUIRE(m_operator, "Operator is not set!\n");
+	REQUIRE(m_vectors.matrix, "Vectors are not set!\n");
+	REQUIRE(m_shifts.vector, "Shifts are not set!\n");
+	REQUIRE(m_weights.vector, "Weights are not set!\n");
+	REQUIRE(m_operator->get_dimension()==m_vectors.num_rows,
+		"Dimension mismatch! %d vs %d\n", m_operator->get_dimension(),
+		m_vectors.num_rows);
+	REQUIRE(m_shifts.vlen==m_weights.vlen,
+		"Number of shifts and weights are not equal!\n");
+	REQUIRE(m_aggregators->get_num_elements()==m_vectors.num_cols,
+		"Number of aggregators and vectors are not equal!\n");
+
+	// solve the linear systems with all the sample vectors
+	SGMatrix<complex128_t> mat=m_linear_solver->solve_shifted_weighted_block(
+		m_operator, m_vectors, m_shifts, m_weights);
+
+	// take out the negated imaginary part of the result before applying
+	// linear operator (see CRationalApproximation for the formula)
+	SGMatrix<float64_t> imag(mat.num_rows, mat.num_cols);
+	for (index_t i=0; i<mat.num_rows*mat.num_cols; ++i)
+		imag[i]=-mat[i].imag();
+
+	SGMatrix<float64_t> agg=m_operator->apply_block(imag);
+
+	Map<MatrixXd> map_agg(agg.matrix, agg.num_rows, agg.num_cols);
+	Map<MatrixXd> map_vectors(m_vectors.matrix, m_vectors.num_rows,
+		m_vectors.num_cols);
+
+	for (index_t i=0; i<m_vectors.num_cols; ++i)
+	{
+		// perform dot product
+		float64_t result=map_vectors.col(i).dot(map_agg.col(i));
+		result*=m_const_multiplier;
+
+		// form the final result into a scalar result and submit to the
+		// aggregator of this sample
+		CJobResultAggregator* aggregator=dynamic_cast<CJobResultAggregator*>
+			(m_aggregators->get_element(i));
+		REQUIRE(aggregator, "Job result aggregator %d is not set!\n", i);
+
+		CScalarResult<float64_t>* final_result=new CScalarResult<float64_t>(result);
+		SG_REF(final_result);
+
+		aggregator->submit_result(final_result);
+
+		SG_UNREF(final_result);
+		SG_UNREF(aggregator);
+	}
+
+	SG_DEBUG("Leaving\n");
+}
+
+}
+#endif // HAVE_EIGEN3
@@ -0,0 +1,95 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#ifndef RATIONAL_APPROXIMATION_CGM_BLOCK_JOB_H_
+#define RATIONAL_APPROXIMATION_CGM_BLOCK_JOB_H_
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_EIGEN3
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/computation/job/IndependentJob.h>
+
+namespace shogun
+{
+template<class T> class SGVector;
+template<class T> class CLinearOperator;
+class CDynamicObjectArray;
+class CCGMShiftedFamilySolver;
+
+/** @brief Implementation of independent jobs that solve the families of
+ * shifted systems of a block of sample vectors together, in rational
+ * approximation of linear operator function times a vector, using
+ * CCGMShiftedFamilySolver::solve_shifted_weighted_block. Each sample has
+ * its own aggregator, to which compute submits a CScalarResult as
+ * CRationalApproximationCGMJob does for a single sample.
+ */
+class CRationalApproximationCGMBlockJob : public CIndependentJob
+{
+public:
+	/** default constructor */
+	CRationalApproximationCGMBlockJob();
+
+	/**
+	 * constructor
+	 *
+	 * @param aggregators the scalar job result aggregators, one per sample
+	 * @param linear_solver solver for the shifted-system of this job
+	 * @param linear_operator the linear operator of the system
+	 * @param vectors the matrix whose columns are the sample vectors
+	 * @param shifts the complex shifts vector in the system
+	 * @param weights the complex weights vector in the system
+	 * @param const_multiplier the constant multiplier
+	 */
+	CRationalApproximationCGMBlockJob(CDynamicObjectArray* aggregators,
+		CCGMShiftedFamilySolver* linear_solver,
+		CLinearOperator<float64_t>* linear_operator,
+		SGMatrix<float64_t> vectors, SGVector<complex128_t> shifts,
+		SGVector<complex128_t> weights, float64_t const_multiplier);
+
+	/** destructor */
+	virtual ~CRationalApproximationCGMBlockJob();
+
+	/** implementation of compute method for the job */
+	virtual void compute();
+
+	/** @return object name */
+	virtual const char* get_name() const
+	{
+		return "RationalApproximationCGMBlockJob";
+	}
+
+private:
+	/** the scalar job result aggregators, one per sample vector */
+	CDynamicObjectArray* m_aggregators;
+
+	/** the real valued linear operator of linear system to be solved */
+	CLinearOperator<float64_t>* m_operator;
+
+	/** the sample vectors of the systems to be solved */
+	SGMatrix<float64_t> m_vectors;
+
+	/** the complex-shifted linear family solver */
+	CCGMShiftedFamilySolver* m_linear_solver;
+
+	/** the shifts in the systems to be solved */
+	SGVector<complex128_t> m_shifts;
+
+	/** the weights to be multiplied with each solution per shift */
+	SGVector<complex128_t> m_weights;
+
+	/** the constant multiplier */
+	float64_t m_const_multiplier;
+
+	/** initialize with default values and register params */
+	void init();
+};
+
+}
+
+#endif // HAVE_EIGEN3
+#endif // RATIONAL_APPROXIMATION_CGM_BLOCK_JOB_H_
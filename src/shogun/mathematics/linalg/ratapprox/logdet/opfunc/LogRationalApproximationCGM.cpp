@@ -13,11 +13,13 @@
 #include <shogun/base/Parameter.h>
 #include <shogun/lib/SGVector.h>
 #include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/DynamicObjectArray.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/linsolver/CGMShiftedFamilySolver.h>
 #include <shogun/mathematics/linalg/linop/LinearOperator.h>
 #include <shogun/mathematics/linalg/ratapprox/logdet/opfunc/LogRationalApproximationCGM.h>
 #include <shogun/mathematics/linalg/ratapprox/logdet/computation/job/RationalApproximationCGMJob.h>
+#include <shogun/mathematics/linalg/ratapprox/logdet/computation/job/RationalApproximationCGMBlockJob.h>
 #include <shogun/lib/computation/aggregator/StoreScalarAggregator.h>
 #include <shogun/lib/computation/engine/IndependentComputationEngine.h>
 
@@ -63,6 +65,17 @@ CLogRationalApproximationCGM::~CLogRationalApproximationCGM()
 	SG_UNREF(m_linear_solver);
 }
 
+void CLogRationalApproximationCGM::compute_negated_shifts()
+{
+	if (m_negated_shifts.vector==NULL)
+	{
+		m_negated_shifts=SGVector<complex128_t>(m_shifts.vlen);
+		Map<VectorXcd> shifts(m_shifts.vector, m_shifts.vlen);
+		Map<VectorXcd> negated_shifts(m_negated_shifts.vector, m_negated_shifts.vlen);
+		negated_shifts=-shifts;
+	}
+}
+
 CJobResultAggregator* CLogRationalApproximationCGM::submit_jobs(
 	SGVector<float64_t> sample)
 {
@@ -77,13 +90,7 @@ CJobResultAggregator* CLogRationalApproximationCGM::submit_jobs(
 	SG_REF(agg);
 
 	// we need to take the negation of the shifts for this case
-	if (m_negated_shifts.vector==NULL)
-	{
-		m_negated_shifts=SGVector<complex128_t>(m_shifts.vlen);
-		Map<VectorXcd> shifts(m_shifts.vector, m_shifts.vlen);
-		Map<VectorXcd> negated_shifts(m_negated_shifts.vector, m_negated_shifts.vlen);
-		negated_shifts=-shifts;
-	}
+	compute_negated_shifts();
 
 	// create one CG-M job for current sample vector which solves for all
 	// the shifts, and computes the final result and stores that in the aggregator
@@ -101,5 +108,40 @@ CJobResultAggregator* CLogRationalApproximationCGM::submit_jobs(
 	return agg;
 }
 
+CDynamicObjectArray* CLogRationalApproximationCGM::submit_block_jobs(
+	SGMatrix<float64_t> samples)
+{
+	SG_DEBUG("Entering\n");
+	REQUIRE(samples.matrix, "Samples are not initialized!\n");
+	REQUIRE(m_linear_operator, "Operator is not initialized!\n");
+	REQUIRE(m_computation_engine, "Computation engine is NULL\n");
+
+	// create one scalar aggregator per sample
+	CDynamicObjectArray* aggregators=new CDynamicObjectArray();
+	SG_REF(aggregators);
+	for (index_t i=0; i<samples.num_cols; ++i)
+		aggregators->append_element(new CStoreScalarAggregator<float64_t>());
+
+	// we need to take the negation of the shifts for this case
+	compute_negated_shifts();
+
+	// create one CG-M job for all the sample vectors which solves for all
+	// the shifts with one operator application per iteration for the whole
+	// block, and stores the final results in the aggregators
+	CRationalApproximationCGMBlockJob* job
+			=new CRationalApproximationCGMBlockJob(aggregators, m_linear_solver,
+			m_linear_operator, samples, m_negated_shifts, m_weights,
+			m_constant_multiplier);
+	SG_REF(job);
+
+	m_computation_engine->submit_job(job);
+
+	// we can safely unref the job here, computation engine takes it from here
+	SG_UNREF(job);
+
+	SG_DEBUG("Leaving\n");
+	return aggregators;
+}
+
 }
 #endif // HAVE_EIGEN3
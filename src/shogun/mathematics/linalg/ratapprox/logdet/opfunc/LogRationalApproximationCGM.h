@@ -68,6 +68,16 @@ public:
 	 */
 	virtual CJobResultAggregator* submit_jobs(SGVector<float64_t> sample);
 
+	/**
+	 * method that creates one scalar job result aggregator per sample, then
+	 * creates one job which solves the shifted systems for the whole block
+	 * of samples together, and submits the job to computation engine
+	 *
+	 * @param samples the matrix whose columns are the sample vectors
+	 * @return the array of job result aggregators, one per column
+	 */
+	virtual CDynamicObjectArray* submit_block_jobs(SGMatrix<float64_t> samples);
+
 	/** @return object name */
 	virtual const char* get_name() const
 	{
@@ -81,6 +91,9 @@ private:
 	/** negated shifts to pass to CG-M linear solver */
 	SGVector<complex128_t> m_negated_shifts;
 
+	/** computes the negated shifts if they are not computed already */
+	void compute_negated_shifts();
+
 	/** initialize with default values and register params */
 	void init();
 };
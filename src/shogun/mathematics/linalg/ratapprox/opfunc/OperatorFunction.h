@@ -13,8 +13,10 @@
 #include <shogun/lib/config.h>
 #include <shogun/base/SGObject.h>
 #include <shogun/base/Parameter.h>
+#include <shogun/lib/DynamicObjectArray.h>
 #include <shogun/mathematics/linalg/linop/LinearOperator.h>
 #include <shogun/lib/computation/engine/IndependentComputationEngine.h>
+#include <shogun/lib/computation/aggregator/JobResultAggregator.h>
 
 namespace shogun
 {
@@ -102,6 +104,33 @@ public:
 	 */
 	virtual CJobResultAggregator* submit_jobs(SGVector<T> sample) = 0;
 
+	/**
+	 * method that creates the jobs for every column of a block of samples
+	 * and returns their aggregators in the order of the columns. This
+	 * default calls submit_jobs for each column, operator functions which
+	 * can solve for a whole block at once override it
+	 *
+	 * @param samples the matrix whose columns are the sample vectors
+	 * @return the array of job result aggregators, one per column
+	 */
+	virtual CDynamicObjectArray* submit_block_jobs(SGMatrix<T> samples)
+	{
+		CDynamicObjectArray* aggregators=new CDynamicObjectArray();
+		for (index_t i=0; i<samples.num_cols; ++i)
+		{
+			SGVector<T> sample(samples.num_rows);
+			memcpy(sample.vector, samples.get_column_vector(i),
+				sizeof(T)*samples.num_rows);
+
+			CJobResultAggregator* agg=submit_jobs(sample);
+			aggregators->append_element(agg);
+			SG_UNREF(agg);
+		}
+
+		SG_REF(aggregators);
+		return aggregators;
+	}
+
 	/** @return object name */
 	virtual const char* get_name() const
 	{
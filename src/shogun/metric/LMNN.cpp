@@ -101,7 +101,7 @@ void CLMNN::train(SGMatrix<float64_t> init_transform)
 
 		// Find current set of impostors
 		SG_DEBUG("Finding impostors.\n")
-		cur_impostors = CLMNNImpl::find_impostors(x,y,L,target_nn,iter,m_correction);
+		cur_impostors = CLMNNImpl::find_impostors(x,y,L,target_nn,iter,m_correction,exact_impostors);
 		SG_DEBUG("Found %d impostors in the current set.\n", cur_impostors.size())
 
 		// (Sub-) gradient computation
@@ -14,14 +14,20 @@
 #include <shogun/multiclass/KNN.h>
 #include <shogun/preprocessor/PruneVarSubMean.h>
 #include <shogun/preprocessor/PCA.h>
+#include <shogun/base/init.h>
+#include <shogun/base/Parallel.h>
 
 #include <iterator>
+#include <algorithm>
 
 /// useful shorthands to perform operations with Eigen matrices
 
 // column-wise sum of the squared elements of a matrix
 #define SUMSQCOLS(A)	((A).array().square().colwise().sum())
 
+// number of examples per block in distance and outer product computations
+#define LMNN_BLOCK_SIZE	512
+
 using namespace shogun;
 using namespace Eigen;
 
@@ -137,30 +143,77 @@ SGMatrix<index_t> CLMNNImpl::find_target_nn(CDenseFeatures<float64_t>* x,
 
 MatrixXd CLMNNImpl::sum_outer_products(CDenseFeatures<float64_t>* x, const SGMatrix<index_t> target_nn)
 {
-	// get the number of features
-	int32_t d = x->get_num_features();
-	// initialize the sum of outer products (sop)
-	MatrixXd sop(d,d);
-	sop.setZero();
 	// map the feature matrix (each column is a feature vector) to an Eigen matrix
-	Map<const MatrixXd> X(x->get_feature_matrix().matrix, d, x->get_num_vectors());
+	Map<const MatrixXd> X(x->get_feature_matrix().matrix, x->get_num_features(), x->get_num_vectors());
 
-	// sum the outer products stored in C using the indices specified in target_nn
+	// pairs of examples and target neighbours
+	std::vector<index_t> a, b;
+	a.reserve(target_nn.num_rows*target_nn.num_cols);
+	b.reserve(target_nn.num_rows*target_nn.num_cols);
 	for (index_t i = 0; i < target_nn.num_cols; ++i)
 	{
 		for (index_t j = 0; j < target_nn.num_rows; ++j)
 		{
-			VectorXd dx = X.col(i) - X.col(target_nn(j,i));
-			sop += dx*dx.transpose();
+			a.push_back(i);
+			b.push_back(target_nn(j,i));
+		}
+	}
+
+	// sum the outer products stored in C using the indices specified in target_nn
+	return CLMNNImpl::sum_outer_products(X, a, b);
+}
+
+MatrixXd CLMNNImpl::sum_outer_products(const Map<const MatrixXd>& X,
+		const std::vector<index_t>& a, const std::vector<index_t>& b)
+{
+	ASSERT(a.size()==b.size())
+	int32_t d = X.rows();
+	index_t num_pairs = a.size();
+	int32_t num_threads = CMath::max(1, CMath::min(CLMNNImpl::get_num_threads(),
+			int32_t(num_pairs/LMNN_BLOCK_SIZE)));
+
+	// every thread sums a contiguous range of pairs, in blocks of differences
+	// dx whose outer products are added at once as dx*dx^T; the partial sums
+	// are added in order, so the result doesn't depend on scheduling
+	std::vector<MatrixXd> partial_sops(num_threads, MatrixXd::Zero(d,d));
+
+	#pragma omp parallel for num_threads(num_threads) schedule(static, 1)
+	for (int32_t t = 0; t < num_threads; ++t)
+	{
+		index_t begin = int64_t(num_pairs)*t/num_threads;
+		index_t end = int64_t(num_pairs)*(t+1)/num_threads;
+		MatrixXd dx(d, LMNN_BLOCK_SIZE);
+
+		for (index_t block = begin; block < end; block += LMNN_BLOCK_SIZE)
+		{
+			index_t size = CMath::min(end-block, index_t(LMNN_BLOCK_SIZE));
+			for (index_t i = 0; i < size; ++i)
+				dx.col(i) = X.col(a[block+i]) - X.col(b[block+i]);
+
+			partial_sops[t].noalias() += dx.leftCols(size)*dx.leftCols(size).transpose();
 		}
 	}
 
+	MatrixXd sop = MatrixXd::Zero(d,d);
+	for (int32_t t = 0; t < num_threads; ++t)
+		sop += partial_sops[t];
+
 	return sop;
 }
 
 ImpostorsSetType CLMNNImpl::find_impostors(CDenseFeatures<float64_t>* x,
 		CMulticlassLabels* y, const MatrixXd& L, const SGMatrix<index_t> target_nn,
 		const uint32_t iter, const uint32_t correction)
+{
+	// exact impostors set shared between calls to this method
+	static ImpostorsSetType Nexact;
+
+	return CLMNNImpl::find_impostors(x, y, L, target_nn, iter, correction, Nexact);
+}
+
+ImpostorsSetType CLMNNImpl::find_impostors(CDenseFeatures<float64_t>* x,
+		CMulticlassLabels* y, const MatrixXd& L, const SGMatrix<index_t> target_nn,
+		const uint32_t iter, const uint32_t correction, ImpostorsSetType& Nexact)
 {
 	SG_SDEBUG("Entering CLMNNImpl::find_impostors().\n")
 
@@ -181,8 +234,6 @@ ImpostorsSetType CLMNNImpl::find_impostors(CDenseFeatures<float64_t>* x,
 
 	// initialize impostors set
 	ImpostorsSetType N;
-	// exact impostors set shared between calls to this method
-	static ImpostorsSetType Nexact;
 
 	// impostors search
 	REQUIRE(correction>0, "The number of iterations between exact updates of the "
@@ -206,28 +257,34 @@ void CLMNNImpl::update_gradient(CDenseFeatures<float64_t>* x, MatrixXd& G,
 		const ImpostorsSetType& Nc, const ImpostorsSetType& Np, float64_t regularization)
 {
 	// compute the difference sets
-	ImpostorsSetType Np_Nc, Nc_Np;
-	set_difference(Np.begin(), Np.end(), Nc.begin(), Nc.end(), inserter(Np_Nc, Np_Nc.begin()));
-	set_difference(Nc.begin(), Nc.end(), Np.begin(), Np.end(), inserter(Nc_Np, Nc_Np.begin()));
+	std::vector<CImpostorNode> Np_Nc, Nc_Np;
+	set_difference(Np.begin(), Np.end(), Nc.begin(), Nc.end(), back_inserter(Np_Nc));
+	set_difference(Nc.begin(), Nc.end(), Np.begin(), Np.end(), back_inserter(Nc_Np));
 
 	// map the feature matrix (each column is a feature vector) to an Eigen matrix
 	Map<const MatrixXd> X(x->get_feature_matrix().matrix, x->get_num_features(), x->get_num_vectors());
 
-	// remove the gradient contributions of the impostors that were in the previous
-	// set but disappeared in the current
-	for (ImpostorsSetType::iterator it = Np_Nc.begin(); it != Np_Nc.end(); ++it)
+	// the gradient contributions of the impostors that were in the previous set but
+	// disappeared in the current are removed, the ones of the new impostors added
+	std::vector<index_t> examples, targets, impostors;
+	for (int32_t sign = -1; sign <= 1; sign += 2)
 	{
-		VectorXd dx1 = X.col(it->example) - X.col(it->target);
-		VectorXd dx2 = X.col(it->example) - X.col(it->impostor);
-		G -= regularization*(dx1*dx1.transpose() - dx2*dx2.transpose());
-	}
+		const std::vector<CImpostorNode>& triplets = sign < 0 ? Np_Nc : Nc_Np;
+		if (triplets.empty())
+			continue;
+
+		examples.resize(triplets.size());
+		targets.resize(triplets.size());
+		impostors.resize(triplets.size());
+		for (std::size_t i = 0; i < triplets.size(); ++i)
+		{
+			examples[i] = triplets[i].example;
+			targets[i] = triplets[i].target;
+			impostors[i] = triplets[i].impostor;
+		}
 
-	// add the gradient contributions of the new impostors
-	for (ImpostorsSetType::iterator it = Nc_Np.begin(); it != Nc_Np.end(); ++it)
-	{
-		VectorXd dx1 = X.col(it->example) - X.col(it->target);
-		VectorXd dx2 = X.col(it->example) - X.col(it->impostor);
-		G += regularization*(dx1*dx1.transpose() - dx2*dx2.transpose());
+		G += sign*regularization*(CLMNNImpl::sum_outer_products(X, examples, targets) -
+				CLMNNImpl::sum_outer_products(X, examples, impostors));
 	}
 }
 
@@ -340,36 +397,19 @@ MatrixXd CLMNNImpl::compute_sqdists(MatrixXd& LX, const SGMatrix<index_t> target
 	// get the number of examples
 	ASSERT(LX.cols()==target_nn.num_cols)
 	int32_t n = LX.cols();
-	// get the number of features
-	int32_t d = LX.rows();
 	// get the number of neighbors
 	int32_t k = target_nn.num_rows;
 
 	/// compute square distances to target neighbors plus margin
-
-	// create Shogun features from LX to later apply subset
-	SGMatrix<float64_t> lx_mat(LX.data(), d, n, false);
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(lx_mat);
-
-	// initialize distances
 	MatrixXd sqdists(k,n);
-	sqdists.setZero();
-	for (int32_t i = 0; i < k; ++i)
+
+	#pragma omp parallel for num_threads(CLMNNImpl::get_num_threads())
+	for (int32_t i = 0; i < n; ++i)
 	{
-		//FIXME avoid copying the rows of target_nn and access them directly. Maybe
-		//find_target_nn should be changed to return the output transposed wrt how it is
-		//done atm.
-		SGVector<index_t> subset_vec = target_nn.get_row_vector(i);
-		lx->add_subset(subset_vec);
-		// after the subset, there are still n columns, i.e. the subset is used to
-		// modify the order of the columns in x according to the target neighbors
-		sqdists.row(i) = SUMSQCOLS(LX - Map<const MatrixXd>(lx->get_feature_matrix().matrix, d, n)) + 1;
-		lx->remove_subset();
+		for (int32_t j = 0; j < k; ++j)
+			sqdists(j,i) = (LX.col(i) - LX.col(target_nn(j,i))).squaredNorm() + 1;
 	}
 
-	// clean up features used to apply subset
-	SG_UNREF(lx);
-
 	return sqdists;
 }
 
@@ -381,13 +421,16 @@ ImpostorsSetType CLMNNImpl::find_impostors_exact(MatrixXd& LX, const MatrixXd& s
 	// initialize empty impostors set
 	ImpostorsSetType N = ImpostorsSetType();
 
-	// get the number of examples from data
-	int32_t n = LX.cols();
 	// get the number of features
 	int32_t d = LX.rows();
-	// create Shogun features from LX to later apply subset
-	SGMatrix<float64_t> lx_mat(LX.data(), d, n, false);
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(lx_mat);
+	int32_t num_threads = CLMNNImpl::get_num_threads();
+
+	// squared norms of the examples, the squared distances are computed as
+	// |a|^2 + |b|^2 - 2*a^T*b for blocks of examples at once
+	VectorXd sqnorms = SUMSQCOLS(LX).transpose();
+	// largest square distance plus margin to a target neighbor of every example, a
+	// pair of examples further apart than both bounds can't form any impostor triplet
+	VectorXd bounds = sqdists.colwise().maxCoeff().transpose();
 
 	// get a vector with unique label values
 	SGVector<float64_t> unique = y->get_unique_labels();
@@ -400,34 +443,64 @@ ImpostorsSetType CLMNNImpl::find_impostors_exact(MatrixXd& LX, const MatrixXd& s
 		// get the indices of the examples that have a larger label value, so that
 		// pairwise distances are computed once
 		std::vector<index_t> gtidxs = CLMNNImpl::get_examples_gtlabel(y,unique[i]);
-
-		// get distance with features indexed by iidxs and gtidxs separated
-		CEuclideanDistance* euclidean = CLMNNImpl::setup_distance(lx,iidxs,gtidxs);
-		euclidean->set_disable_sqrt(true);
-
-		for (int32_t j = 0; j < k; ++j)
+		index_t ni = iidxs.size();
+		index_t ngt = gtidxs.size();
+
+		// gather the examples of both groups
+		MatrixXd LXi(d,ni), LXgt(d,ngt);
+		for (index_t ii = 0; ii < ni; ++ii)
+			LXi.col(ii) = LX.col(iidxs[ii]);
+		for (index_t jj = 0; jj < ngt; ++jj)
+			LXgt.col(jj) = LX.col(gtidxs[jj]);
+
+		// blocks of examples labelled as unique[i] are processed in parallel,
+		// each one collecting its triplets separately
+		index_t num_blocks = (ni+LMNN_BLOCK_SIZE-1)/LMNN_BLOCK_SIZE;
+		std::vector< std::vector<CImpostorNode> > block_impostors(num_blocks);
+
+		#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+		for (index_t block = 0; block < num_blocks; ++block)
 		{
-			for (std::size_t ii = 0; ii < iidxs.size(); ++ii)
-			{
-				for (std::size_t jj = 0; jj < gtidxs.size(); ++jj)
-				{
-					// FIXME study if using upper bounded distances can be an improvement
-					float64_t distance = euclidean->distance(ii,jj);
+			index_t ibegin = block*LMNN_BLOCK_SIZE;
+			index_t isize = CMath::min(ni-ibegin, index_t(LMNN_BLOCK_SIZE));
+			MatrixXd distances(isize, LMNN_BLOCK_SIZE);
+			std::vector<CImpostorNode>& found = block_impostors[block];
 
-					if (distance <= sqdists(j,iidxs[ii]))
-						N.insert( CImpostorNode(iidxs[ii], target_nn(j,iidxs[ii]), gtidxs[jj]) );
+			for (index_t jbegin = 0; jbegin < ngt; jbegin += LMNN_BLOCK_SIZE)
+			{
+				index_t jsize = CMath::min(ngt-jbegin, index_t(LMNN_BLOCK_SIZE));
+				distances.leftCols(jsize).noalias() =
+					LXi.middleCols(ibegin,isize).transpose()*LXgt.middleCols(jbegin,jsize);
 
-					if (distance <= sqdists(j,gtidxs[jj]))
-						N.insert( CImpostorNode(gtidxs[jj], target_nn(j,gtidxs[jj]), iidxs[ii]) );
+				for (index_t jj = 0; jj < jsize; ++jj)
+				{
+					index_t gtidx = gtidxs[jbegin+jj];
+					for (index_t ii = 0; ii < isize; ++ii)
+					{
+						index_t iidx = iidxs[ibegin+ii];
+						float64_t distance = CMath::max(0.0,
+								sqnorms[iidx] + sqnorms[gtidx] - 2*distances(ii,jj));
+
+						if (distance > bounds[iidx] && distance > bounds[gtidx])
+							continue;
+
+						for (int32_t j = 0; j < k; ++j)
+						{
+							if (distance <= sqdists(j,iidx))
+								found.push_back( CImpostorNode(iidx, target_nn(j,iidx), gtidx) );
+
+							if (distance <= sqdists(j,gtidx))
+								found.push_back( CImpostorNode(gtidx, target_nn(j,gtidx), iidx) );
+						}
+					}
 				}
 			}
 		}
 
-		SG_UNREF(euclidean);
+		for (index_t block = 0; block < num_blocks; ++block)
+			N.insert(block_impostors[block].begin(), block_impostors[block].end());
 	}
 
-	SG_UNREF(lx);
-
 	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_exact().\n")
 
 	return N;
@@ -441,24 +514,35 @@ ImpostorsSetType CLMNNImpl::find_impostors_approx(MatrixXd& LX, const MatrixXd&
 	// initialize empty impostors set
 	ImpostorsSetType N = ImpostorsSetType();
 
+	// triplets of the exact set of impostors computed last, in order
+	std::vector<CImpostorNode> triplets(Nexact.begin(), Nexact.end());
+	index_t num_triplets = triplets.size();
+
 	// compute square distances from examples to impostors
-	SGVector<float64_t> impostors_sqdists = CLMNNImpl::compute_impostors_sqdists(LX,Nexact);
+	SGVector<float64_t> impostors_sqdists = CLMNNImpl::compute_impostors_sqdists(LX,triplets);
 
-	// find in the exact set of impostors computed last, the triplets that remain impostors
-	index_t i = 0;
-	for (ImpostorsSetType::iterator it = Nexact.begin(); it != Nexact.end(); ++it)
+	// find in target_nn(:,it->example) the position of the target neighbor it->target
+	SGVector<index_t> target_idxs(num_triplets);
+	#pragma omp parallel for num_threads(CLMNNImpl::get_num_threads())
+	for (index_t i = 0; i < num_triplets; ++i)
 	{
-		// find in target_nn(:,it->example) the position of the target neighbor it->target
 		index_t target_idx = 0;
-		while (target_nn(target_idx, it->example)!=it->target && target_idx<target_nn.num_rows)
+		while (target_idx<target_nn.num_rows && target_nn(target_idx, triplets[i].example)!=triplets[i].target)
 			++target_idx;
 
-		REQUIRE(target_idx<target_nn.num_rows, "The index of the target neighbour in the "
+		target_idxs[i] = target_idx;
+	}
+
+	// find the triplets that remain impostors, they are visited in order
+	// so every insertion takes constant time
+	for (index_t i = 0; i < num_triplets; ++i)
+	{
+		REQUIRE(target_idxs[i]<target_nn.num_rows, "The index of the target neighbour in the "
 				"impostors set was not found in the target neighbours matrix. "
 				"There must be a bug in find_impostors_exact.\n")
 
-		if ( impostors_sqdists[i++] <= sqdists(target_idx, it->example) )
-			N.insert(*it);
+		if ( impostors_sqdists[i] <= sqdists(target_idxs[i], triplets[i].example) )
+			N.insert(N.end(), triplets[i]);
 	}
 
 	SG_SDEBUG("Leaving CLMNNImpl::find_impostors_approx().\n")
@@ -466,32 +550,18 @@ ImpostorsSetType CLMNNImpl::find_impostors_approx(MatrixXd& LX, const MatrixXd&
 	return N;
 }
 
-SGVector<float64_t> CLMNNImpl::compute_impostors_sqdists(MatrixXd& LX, const ImpostorsSetType& Nexact)
+SGVector<float64_t> CLMNNImpl::compute_impostors_sqdists(MatrixXd& LX,
+		const std::vector<CImpostorNode>& Nexact)
 {
-	// get the number of examples
-	int32_t n = LX.cols();
-	// get the number of features
-	int32_t d = LX.rows();
 	// get the number of impostors
-	size_t num_impostors = Nexact.size();
+	index_t num_impostors = Nexact.size();
 
 	/// compute square distances to impostors
-
-	// create Shogun features from LX and distance
-	SGMatrix<float64_t> lx_mat(LX.data(), d, n, false);
-	CDenseFeatures<float64_t>* lx = new CDenseFeatures<float64_t>(lx_mat);
-	CEuclideanDistance* euclidean = new CEuclideanDistance(lx,lx);
-	euclidean->set_disable_sqrt(true);
-
-	// initialize vector of square distances
 	SGVector<float64_t> sqdists(num_impostors);
-	// compute square distances
-	index_t i = 0;
-	for (ImpostorsSetType::iterator it = Nexact.begin(); it != Nexact.end(); ++it)
-		sqdists[i++] = euclidean->distance(it->example,it->impostor);
 
-	// clean up distance
-	SG_UNREF(euclidean);
+	#pragma omp parallel for num_threads(CLMNNImpl::get_num_threads())
+	for (index_t i = 0; i < num_impostors; ++i)
+		sqdists[i] = (LX.col(Nexact[i].example) - LX.col(Nexact[i].impostor)).squaredNorm();
 
 	return sqdists;
 }
@@ -526,22 +596,13 @@ std::vector<index_t> CLMNNImpl::get_examples_gtlabel(CMulticlassLabels* y,
 	return idxs;
 }
 
-CEuclideanDistance* CLMNNImpl::setup_distance(CDenseFeatures<float64_t>* x,
-		std::vector<index_t>& a, std::vector<index_t>& b)
+int32_t CLMNNImpl::get_num_threads()
 {
-	// create new features only containing examples whose indices are in a
-	x->add_subset(SGVector<index_t>(a.data(), a.size(), false));
-	CDenseFeatures<float64_t>* afeats = new CDenseFeatures<float64_t>(x->get_feature_matrix());
-	x->remove_subset();
-
-	// create new features only containing examples whose indices are in b
-	x->add_subset(SGVector<index_t>(b.data(), b.size(), false));
-	CDenseFeatures<float64_t>* bfeats = new CDenseFeatures<float64_t>(x->get_feature_matrix());
-	x->remove_subset();
-
-	// create and return distance
-	CEuclideanDistance* euclidean = new CEuclideanDistance(afeats,bfeats);
-	return euclidean;
+	Parallel* parallel = get_global_parallel();
+	int32_t num_threads = parallel->get_num_threads();
+	SG_UNREF(parallel);
+
+	return num_threads;
 }
 
 #endif /* HAVE_EIGEN3 */
@@ -98,6 +98,14 @@ class CLMNNImpl
 		/** find the impostors that remain after applying the transformation L */
 		static ImpostorsSetType find_impostors(CDenseFeatures<float64_t>* x, CMulticlassLabels* y, const Eigen::MatrixXd& L, const SGMatrix<index_t> target_nn, const uint32_t iter, const uint32_t correction);
 
+		/**
+		 * find the impostors that remain after applying the transformation L; the
+		 * active set Nexact is searched every correction iterations over all the
+		 * data and kept by the caller between calls, in the other iterations only
+		 * the triplets in it are checked
+		 */
+		static ImpostorsSetType find_impostors(CDenseFeatures<float64_t>* x, CMulticlassLabels* y, const Eigen::MatrixXd& L, const SGMatrix<index_t> target_nn, const uint32_t iter, const uint32_t correction, ImpostorsSetType& Nexact);
+
 		/** update the gradient using the last transition in the impostors sets */
 		static void update_gradient(CDenseFeatures<float64_t>* x, Eigen::MatrixXd& G, const ImpostorsSetType& Nc, const ImpostorsSetType& Np, float64_t mu);
 
@@ -126,10 +134,10 @@ class CLMNNImpl
 		static Eigen::MatrixXd compute_sqdists(Eigen::MatrixXd& L, const SGMatrix<index_t> target_nn);
 
 		/**
-		 * compute squared distances between examples and impostors in the given impostors set
-		 * Nexact
+		 * compute squared distances between examples and impostors in the given impostor
+		 * triplets
 		 */
-		static SGVector<float64_t> compute_impostors_sqdists(Eigen::MatrixXd& L, const ImpostorsSetType& Nexact);
+		static SGVector<float64_t> compute_impostors_sqdists(Eigen::MatrixXd& L, const std::vector<CImpostorNode>& Nexact);
 
 		/** find impostors; variant computing the impostors exactly, using all the data */
 		static ImpostorsSetType find_impostors_exact(Eigen::MatrixXd& LX, const Eigen::MatrixXd& sqdists, CMulticlassLabels* y, const SGMatrix<index_t> target_nn, int32_t k);
@@ -144,12 +152,14 @@ class CLMNNImpl
 		static std::vector<index_t> get_examples_gtlabel(CMulticlassLabels* y, float64_t yi);
 
 		/**
-		 * create Euclidean distance where the lhs features are the features in x indexed
-		 * by the elements in a, and the rhs features are the ones indexed by b; caller
-		 * is responsible of releasing memory
+		 * sum the outer products of the differences between the examples in X indexed
+		 * by the elements in a and the ones indexed by the elements in b; blocks of
+		 * differences are summed in parallel as matrix products
 		 */
-		static CEuclideanDistance* setup_distance(CDenseFeatures<float64_t>* x, std::vector<index_t>& a, std::vector<index_t>& b);
+		static Eigen::MatrixXd sum_outer_products(const Eigen::Map<const Eigen::MatrixXd>& X, const std::vector<index_t>& a, const std::vector<index_t>& b);
 
+		/** @return number of threads used for the search of impostors and the gradient */
+		static int32_t get_num_threads();
 
 }; /* class CLMNNImpl */
 
@@ -129,8 +129,10 @@ SGMatrix<index_t> CKNN::nearest_neighbors()
 		for (int32_t j=0; j<m_train_labels.vlen; j++)
 			train_idxs[j]=j;
 
-		//sort the distance vector between test example i and all train examples
-		CMath::qsort_index(dists, train_idxs, m_train_labels.vlen);
+		//select the k nearest train examples of test example i, sorted by
+		//distance
+		CMath::partial_sort_index(dists, train_idxs, m_train_labels.vlen, m_k,
+				parallel->get_num_threads());
 
 #ifdef DEBUG_KNN
 		SG_PRINT("\nQuick sort query %d\n", i)
@@ -28,6 +28,11 @@ struct mocas_data
 	uint32_t nData;
 	uint32_t nDim;
 	float64_t* new_a;
+	int32_t* cut_index;
+	int32_t* cut_offsets;
+	int32_t* cut_fill;
+	float64_t* cut_sign;
+	int32_t num_threads;
 };
 
 CMulticlassOCAS::CMulticlassOCAS() :
@@ -99,6 +104,11 @@ bool CMulticlassOCAS::train_machine(CFeatures* data)
 	user_data.nY = num_classes;
 	user_data.nDim = num_features;
 	user_data.nData = num_vectors;
+	user_data.cut_index = SG_MALLOC(int32_t, 2*(int64_t)num_vectors);
+	user_data.cut_offsets = SG_MALLOC(int32_t, num_classes+1);
+	user_data.cut_fill = SG_MALLOC(int32_t, num_classes);
+	user_data.cut_sign = SG_MALLOC(float64_t, num_vectors);
+	user_data.num_threads = parallel->get_num_threads();
 
 	ocas_return_value_T value =
 	msvm_ocas_solver(C, labels.vector, nY, nData, TolRel, TolAbs,
@@ -141,6 +151,10 @@ bool CMulticlassOCAS::train_machine(CFeatures* data)
 	SG_FREE(user_data.new_a);
 	SG_FREE(user_data.full_A);
 	SG_FREE(user_data.output_values);
+	SG_FREE(user_data.cut_index);
+	SG_FREE(user_data.cut_offsets);
+	SG_FREE(user_data.cut_fill);
+	SG_FREE(user_data.cut_sign);
 
 	return true;
 }
@@ -151,8 +165,10 @@ float64_t CMulticlassOCAS::msvm_update_W(float64_t t, void* user_data)
 	float64_t* oldW = ((mocas_data*)user_data)->oldW;
 	uint32_t nY = ((mocas_data*)user_data)->nY;
 	uint32_t nDim = ((mocas_data*)user_data)->nDim;
+	int32_t num_threads = ((mocas_data*)user_data)->num_threads;
 
-	for(uint32_t j=0; j < nY*nDim; j++)
+	#pragma omp parallel for num_threads(num_threads)
+	for(int64_t j=0; j < (int64_t) nY*nDim; j++)
 		W[j] = oldW[j]*(1-t) + t*W[j];
 
 	float64_t sq_norm_W = SGVector<float64_t>::dot(W,W,nDim*nY);
@@ -168,18 +184,30 @@ void CMulticlassOCAS::msvm_full_compute_W(float64_t *sq_norm_W, float64_t *dp_Wo
 	float64_t* full_A = ((mocas_data*)user_data)->full_A;
 	uint32_t nY = ((mocas_data*)user_data)->nY;
 	uint32_t nDim = ((mocas_data*)user_data)->nDim;
-
-	uint32_t i,j;
+	int32_t num_threads = ((mocas_data*)user_data)->num_threads;
 
 	memcpy(oldW, W, sizeof(float64_t)*nDim*nY);
 	memset(W, 0, sizeof(float64_t)*nDim*nY);
 
-	for(i=0; i<nSel; i++)
+	// W is split into blocks, every block sweeps over all the cuts
+	const int64_t len = (int64_t) nDim*nY;
+	const int64_t block_size = 4096;
+	const int64_t num_blocks = (len+block_size-1)/block_size;
+
+	#pragma omp parallel for num_threads(num_threads)
+	for(int64_t b=0; b < num_blocks; b++)
 	{
-		if(alpha[i] > 0)
+		int64_t start = b*block_size;
+		int64_t stop = CMath::min(start+block_size, len);
+
+		for(uint32_t i=0; i<nSel; i++)
 		{
-			for(j=0; j<nDim*nY; j++)
-				W[j] += alpha[i]*full_A[LIBOCAS_INDEX(j,i,nDim*nY)];
+			if(alpha[i] > 0)
+			{
+				float64_t* a = &full_A[LIBOCAS_INDEX(0,(int64_t) i,len)];
+				for(int64_t j=start; j<stop; j++)
+					W[j] += alpha[i]*a[j];
+			}
 		}
 	}
 
@@ -198,6 +226,11 @@ int CMulticlassOCAS::msvm_full_add_new_cut(float64_t *new_col_H, uint32_t *new_c
 	uint32_t nY = ((mocas_data*)user_data)->nY;
 	uint32_t nDim = ((mocas_data*)user_data)->nDim;
 	uint32_t nData = ((mocas_data*)user_data)->nData;
+	int32_t* cut_index = ((mocas_data*)user_data)->cut_index;
+	int32_t* cut_offsets = ((mocas_data*)user_data)->cut_offsets;
+	int32_t* cut_fill = ((mocas_data*)user_data)->cut_fill;
+	float64_t* cut_sign = ((mocas_data*)user_data)->cut_sign;
+	int32_t num_threads = ((mocas_data*)user_data)->num_threads;
 	CDotFeatures* features = ((mocas_data*)user_data)->features;
 
 	float64_t sq_norm_a;
@@ -205,32 +238,60 @@ int CMulticlassOCAS::msvm_full_add_new_cut(float64_t *new_col_H, uint32_t *new_c
 
 	memset(new_a, 0, sizeof(float64_t)*nDim*nY);
 
+	// Accumulate the cut one class block at a time: a violating example
+	// is added to the block of its label and subtracted from the block of
+	// the predicted label, so every block is a signed sum over a subset
+	// of examples which is computed in parallel. The subsets are formed
+	// by bucketing the examples by class once.
+	memset(cut_offsets, 0, sizeof(int32_t)*(nY+1));
+	for(i=0; i < nData; i++)
+	{
+		y = (uint32_t)(data_y[i]);
+		y2 = (uint32_t)new_cut[i];
+		if(y2 != y)
+		{
+			cut_offsets[y+1]++;
+			cut_offsets[y2+1]++;
+		}
+	}
+	for(y=0; y < nY; y++)
+		cut_offsets[y+1] += cut_offsets[y];
+
+	memcpy(cut_fill, cut_offsets, sizeof(int32_t)*nY);
 	for(i=0; i < nData; i++)
 	{
 		y = (uint32_t)(data_y[i]);
 		y2 = (uint32_t)new_cut[i];
 		if(y2 != y)
 		{
-			features->add_to_dense_vec(1.0,i,&new_a[nDim*y],nDim);
-			features->add_to_dense_vec(-1.0,i,&new_a[nDim*y2],nDim);
+			cut_index[cut_fill[y]++] = i;
+			cut_index[cut_fill[y2]++] = i;
 		}
 	}
 
+	for(y=0; y < nY; y++)
+	{
+		int32_t* sub_index = &cut_index[cut_offsets[y]];
+		int32_t num = cut_offsets[y+1]-cut_offsets[y];
+		if (num == 0)
+			continue;
+
+		for(int32_t k=0; k < num; k++)
+			cut_sign[sub_index[k]] = ((uint32_t) data_y[sub_index[k]] == y) ? 1.0 : -1.0;
+
+		features->add_to_dense_vec_subset(sub_index, num, cut_sign, &new_a[nDim*y], nDim);
+	}
+
 	// compute new_a'*new_a and insert new_a to the last column of full_A
 	sq_norm_a = SGVector<float64_t>::dot(new_a,new_a,nDim*nY);
 	for(j=0; j < nDim*nY; j++ )
 		full_A[LIBOCAS_INDEX(j,nSel,nDim*nY)] = new_a[j];
 
 	new_col_H[nSel] = sq_norm_a;
-	for(i=0; i < nSel; i++)
-	{
-		float64_t tmp = 0;
 
-		for(j=0; j < nDim*nY; j++ )
-			tmp += new_a[j]*full_A[LIBOCAS_INDEX(j,i,nDim*nY)];
-
-		new_col_H[i] = tmp;
-	}
+	#pragma omp parallel for num_threads(num_threads)
+	for(int32_t k=0; k < (int32_t) nSel; k++)
+		new_col_H[k] = SGVector<float64_t>::dot(new_a, &full_A[LIBOCAS_INDEX(0,k,nDim*nY)], nDim*nY);
 
 	return 0;
 }
@@ -22,6 +22,8 @@
 #include <shogun/preprocessor/DimensionReductionPreprocessor.h>
 #include <shogun/features/Features.h>
 #include <shogun/io/SGIO.h>
+#include <shogun/mathematics/linalg/linop/DenseMatrixOperator.h>
+#include <shogun/mathematics/linalg/eigsolver/BlockLanczosEigenSolver.h>
 
 using namespace shogun;
 
@@ -42,11 +44,20 @@ void CKernelPCA::init()
 	m_init_features = NULL;
 	m_transformation_matrix = SGMatrix<float64_t>(NULL, 0, 0, false);
 	m_bias_vector = SGVector<float64_t>(NULL, 0, false);
+	m_method = KPCA_EXACT;
+	m_num_landmarks = 100;
+	m_landmarks = SGVector<index_t>();
 
 	SG_ADD(&m_transformation_matrix, "transformation_matrix",
       "matrix used to transform data", MS_NOT_AVAILABLE);
 	SG_ADD(&m_bias_vector, "bias_vector",
       "bias vector used to transform data", MS_NOT_AVAILABLE);
+	SG_ADD((machine_int_t*) &m_method, "method",
+      "method used to compute principal components", MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_landmarks, "num_landmarks",
+      "number of randomly chosen landmarks", MS_AVAILABLE);
+	SG_ADD(&m_landmarks, "landmarks",
+      "indices of landmarks", MS_NOT_AVAILABLE);
 }
 
 void CKernelPCA::cleanup()
@@ -59,6 +70,36 @@ void CKernelPCA::cleanup()
 	m_initialized = false;
 }
 
+void CKernelPCA::set_method(EKernelPCAMethod method)
+{
+	m_method = method;
+}
+
+EKernelPCAMethod CKernelPCA::get_method() const
+{
+	return m_method;
+}
+
+void CKernelPCA::set_num_landmarks(int32_t num_landmarks)
+{
+	m_num_landmarks = num_landmarks;
+}
+
+int32_t CKernelPCA::get_num_landmarks() const
+{
+	return m_num_landmarks;
+}
+
+void CKernelPCA::set_landmarks(SGVector<index_t> landmarks)
+{
+	m_landmarks = landmarks;
+}
+
+SGVector<index_t> CKernelPCA::get_landmarks() const
+{
+	return m_landmarks;
+}
+
 CKernelPCA::~CKernelPCA()
 {
 	if (m_init_features)
@@ -69,6 +110,22 @@ bool CKernelPCA::init(CFeatures* features)
 {
 	if (!m_initialized && m_kernel)
 	{
+		if (m_method == KPCA_NYSTROM)
+		{
+			init_nystrom(features);
+			m_initialized=true;
+			SG_INFO("Done\n")
+			return true;
+		}
+
+		if (m_method == KPCA_LANCZOS)
+		{
+			init_lanczos(features);
+			m_initialized=true;
+			SG_INFO("Done\n")
+			return true;
+		}
+
 		SG_REF(features);
 		m_init_features = features;
 
@@ -124,6 +181,171 @@ bool CKernelPCA::init(CFeatures* features)
 	return false;
 }
 
+void CKernelPCA::init_nystrom(CFeatures* features)
+{
+	int32_t num_vectors = features->get_num_vectors();
+	SGVector<index_t> landmarks = m_landmarks;
+	if (landmarks.vlen==0)
+	{
+		REQUIRE(m_num_landmarks>0, "Number of landmarks (%d) should be positive\n",
+				m_num_landmarks)
+		SGVector<index_t> permutation = SGVector<index_t>::randperm_vec(num_vectors);
+		landmarks = SGVector<index_t>(CMath::min(m_num_landmarks, num_vectors));
+		for (int32_t i=0; i<landmarks.vlen; i++)
+			landmarks[i] = permutation[i];
+		CMath::qsort(landmarks.vector, landmarks.vlen);
+	}
+	for (int32_t i=0; i<landmarks.vlen; i++)
+	{
+		REQUIRE(landmarks[i]>=0 && landmarks[i]<num_vectors,
+				"Landmark index %d is out of range [0,%d)\n", landmarks[i], num_vectors)
+	}
+
+	int32_t m = landmarks.vlen;
+	REQUIRE(m_target_dim<=m, "Target dimension (%d) should not exceed number "
+			"of landmarks (%d)\n", m_target_dim, m)
+
+	CFeatures* landmark_features = features->copy_subset(landmarks);
+	SG_REF(landmark_features);
+	m_init_features = landmark_features;
+
+	SG_INFO("Computing kernel matrix of %d landmarks\n", m)
+	m_kernel->init(landmark_features, landmark_features);
+	SGMatrix<float64_t> landmark_kernel = m_kernel->get_kernel_matrix();
+	float64_t* eigenvalues = SGMatrix<float64_t>::compute_eigenvectors(
+			landmark_kernel.matrix, m, m);
+
+	// map of landmark kernel values K_MM^{-1/2} = U diag(1/sqrt(lambda)) U',
+	// discarding directions of (numerically) zero eigenvalues
+	SGMatrix<float64_t> scaled_eigenvectors(m, m);
+	float64_t tolerance = CMath::max(eigenvalues[m-1], 0.0)*m*1e-12;
+	for (int32_t i=0; i<m; i++)
+	{
+		float64_t scale = eigenvalues[i]>tolerance ? 1.0/CMath::sqrt(eigenvalues[i]) : 0.0;
+		for (int32_t j=0; j<m; j++)
+			scaled_eigenvectors.matrix[i*m+j] = landmark_kernel.matrix[i*m+j]*scale;
+	}
+	SG_FREE(eigenvalues);
+	SGMatrix<float64_t> feature_map(m, m);
+	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, m, m, m, 1.0,
+			scaled_eigenvectors.matrix, m, landmark_kernel.matrix, m,
+			0.0, feature_map.matrix, m);
+
+	// mean and scatter matrix of mapped vectors, blockwise
+	SG_INFO("Computing covariance of %d vectors in Nystroem feature space\n", num_vectors)
+	const int32_t block_size = 1024;
+	SGMatrix<float64_t> kernel_block(m, block_size);
+	SGMatrix<float64_t> mapped_block(m, block_size);
+	SGVector<float64_t> mean(m);
+	SGMatrix<float64_t> covariance(m, m);
+	mean.zero();
+	covariance.zero();
+
+	m_kernel->init(features, landmark_features);
+	for (int32_t begin=0; begin<num_vectors; begin+=block_size)
+	{
+		int32_t size = CMath::min(block_size, num_vectors-begin);
+
+		#pragma omp parallel for num_threads(parallel->get_num_threads())
+		for (int32_t i=0; i<size; i++)
+		{
+			for (int32_t j=0; j<m; j++)
+				kernel_block.matrix[i*m+j] = m_kernel->kernel(begin+i, j);
+		}
+
+		cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, size, m, 1.0,
+				feature_map.matrix, m, kernel_block.matrix, m,
+				0.0, mapped_block.matrix, m);
+		cblas_dsyrk(CblasColMajor, CblasUpper, CblasNoTrans, m, size, 1.0,
+				mapped_block.matrix, m, 1.0, covariance.matrix, m);
+		for (int32_t i=0; i<size; i++)
+		{
+			for (int32_t j=0; j<m; j++)
+				mean[j] += mapped_block.matrix[i*m+j];
+		}
+	}
+	m_kernel->cleanup();
+
+	SGVector<float64_t>::scale_vector(1.0/num_vectors, mean.vector, m);
+	for (int32_t i=0; i<m; i++)
+	{
+		for (int32_t j=0; j<=i; j++)
+		{
+			covariance.matrix[i*m+j] -= num_vectors*mean[i]*mean[j];
+			covariance.matrix[j*m+i] = covariance.matrix[i*m+j];
+		}
+	}
+
+	eigenvalues = SGMatrix<float64_t>::compute_eigenvectors(covariance.matrix, m, m);
+	SG_FREE(eigenvalues);
+
+	// transformation to the target_dim leading components stored in
+	// ascending order, bias stored in descending order as used on apply
+	m_transformation_matrix = SGMatrix<float64_t>(m, m_target_dim);
+	cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, m_target_dim, m, 1.0,
+			feature_map.matrix, m, covariance.matrix+(m-m_target_dim)*m, m,
+			0.0, m_transformation_matrix.matrix, m);
+	m_bias_vector = SGVector<float64_t>(m_target_dim);
+	for (int32_t k=0; k<m_target_dim; k++)
+	{
+		m_bias_vector[k] = -SGVector<float64_t>::dot(
+				covariance.matrix+(m-k-1)*m, mean.vector, m);
+	}
+}
+
+void CKernelPCA::init_lanczos(CFeatures* features)
+{
+#ifdef HAVE_EIGEN3
+	SG_REF(features);
+	m_init_features = features;
+
+	m_kernel->init(features,features);
+	SGMatrix<float64_t> kernel_matrix = m_kernel->get_kernel_matrix();
+	m_kernel->cleanup();
+	int32_t n = kernel_matrix.num_cols;
+	ASSERT(n==kernel_matrix.num_rows)
+	REQUIRE(m_target_dim>0 && m_target_dim<=n, "Target dimension (%d) should "
+			"be in [1,%d]\n", m_target_dim, n)
+
+	float64_t* bias_tmp = SGMatrix<float64_t>::get_column_sum(kernel_matrix.matrix, n,n);
+	SGVector<float64_t>::scale_vector(-1.0/n, bias_tmp, n);
+	float64_t s = SGVector<float64_t>::sum(bias_tmp, n)/n;
+	SGVector<float64_t>::add_scalar(-s, bias_tmp, n);
+
+	SGMatrix<float64_t>::center_matrix(kernel_matrix.matrix, n, n);
+
+	CBlockLanczosEigenSolver* eig_solver = new CBlockLanczosEigenSolver(
+			new CDenseMatrixOperator<float64_t>(kernel_matrix));
+	SG_REF(eig_solver);
+	eig_solver->set_num_eigenpairs(m_target_dim);
+	eig_solver->compute();
+	SGVector<float64_t> eigenvalues = eig_solver->get_eigenvalues();
+	SGMatrix<float64_t> eigenvectors = eig_solver->get_eigenvectors();
+	SG_UNREF(eig_solver);
+
+	// eigenvalues are computed in descending order, the transformation is
+	// stored in ascending order and the bias in descending order as used on
+	// apply
+	m_transformation_matrix = SGMatrix<float64_t>(n, m_target_dim);
+	m_bias_vector = SGVector<float64_t>(m_target_dim);
+	for (int32_t k=0; k<m_target_dim; k++)
+	{
+		//normalize and trap divide by zero and negative eigenvalues
+		float64_t scale = 1.0/CMath::sqrt(CMath::max(1e-16,eigenvalues[k]));
+		float64_t* column = m_transformation_matrix.matrix+(m_target_dim-k-1)*n;
+		for (int32_t j=0; j<n; j++)
+			column[j] = eigenvectors.matrix[k*n+j]*scale;
+
+		m_bias_vector[k] = SGVector<float64_t>::dot(column, bias_tmp, n);
+
+		float64_t mean = SGVector<float64_t>::sum(column, n)/n;
+		SGVector<float64_t>::add_scalar(-mean, column, n);
+	}
+	SG_FREE(bias_tmp);
+#else
+	SG_ERROR("KPCA_LANCZOS method requires Eigen3\n")
+#endif // HAVE_EIGEN3
+}
 
 SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 {
@@ -132,7 +354,8 @@ SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 
 	int32_t num_vectors = simple_features->get_num_vectors();
 	int32_t i,j,k;
-	int32_t n = m_transformation_matrix.num_cols;
+	int32_t n = m_transformation_matrix.num_rows;
+	int32_t num_components = m_transformation_matrix.num_cols;
 
 	m_kernel->init(features,m_init_features);
 
@@ -148,7 +371,7 @@ SGMatrix<float64_t> CKernelPCA::apply_to_feature_matrix(CFeatures* features)
 			float64_t kij = m_kernel->kernel(i,j);
 
 			for (k=0; k<m_target_dim; k++)
-				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[(n-k-1)*n+j];
+				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[(num_components-k-1)*n+j];
 		}
 	}
 
@@ -165,7 +388,8 @@ SGVector<float64_t> CKernelPCA::apply_to_feature_vector(SGVector<float64_t> vect
 	               m_init_features);
 
 	int32_t j,k;
-	int32_t n = m_transformation_matrix.num_cols;
+	int32_t n = m_transformation_matrix.num_rows;
+	int32_t num_components = m_transformation_matrix.num_cols;
 
 	for (j=0; j<m_target_dim; j++)
 		result.vector[j] = m_bias_vector.vector[j];
@@ -175,7 +399,7 @@ SGVector<float64_t> CKernelPCA::apply_to_feature_vector(SGVector<float64_t> vect
 		float64_t kj = m_kernel->kernel(0,j);
 
 		for (k=0; k<m_target_dim; k++)
-			result.vector[k] += kj*m_transformation_matrix.matrix[(n-k-1)*n+j];
+			result.vector[k] += kj*m_transformation_matrix.matrix[(num_components-k-1)*n+j];
 	}
 
 	m_kernel->cleanup();
@@ -188,7 +412,8 @@ CDenseFeatures<float64_t>* CKernelPCA::apply_to_string_features(CFeatures* featu
 
 	int32_t num_vectors = features->get_num_vectors();
 	int32_t i,j,k;
-	int32_t n = m_transformation_matrix.num_cols;
+	int32_t n = m_transformation_matrix.num_rows;
+	int32_t num_components = m_transformation_matrix.num_cols;
 
 	m_kernel->init(features,m_init_features);
 
@@ -204,7 +429,7 @@ CDenseFeatures<float64_t>* CKernelPCA::apply_to_string_features(CFeatures* featu
 			float64_t kij = m_kernel->kernel(i,j);
 
 			for (k=0; k<m_target_dim; k++)
-				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[(n-k-1)*n+j];
+				new_feature_matrix[k+i*m_target_dim] += kij*m_transformation_matrix.matrix[(num_components-k-1)*n+j];
 		}
 	}
 
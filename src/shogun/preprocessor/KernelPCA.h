@@ -24,6 +24,21 @@ namespace shogun
 class CFeatures;
 class CKernel;
 
+/** method used by KernelPCA */
+enum EKernelPCAMethod
+{
+	/** eigendecomposition of the full NxN kernel matrix */
+	KPCA_EXACT,
+	/** Nystroem approximation of the kernel matrix by M landmark vectors.
+	 * Time complexity ~NM^2, memory ~M^2
+	 */
+	KPCA_NYSTROM,
+	/** target_dim leading eigenvectors of the full NxN kernel matrix by
+	 * block Lanczos (requires Eigen3)
+	 */
+	KPCA_LANCZOS
+};
+
 /** @brief Preprocessor KernelPCA performs kernel principal component analysis
  *
  * Schoelkopf, B., Smola, A. J., & Mueller, K. R. (1999).
@@ -31,6 +46,21 @@ class CKernel;
  * Advances in kernel methods support vector learning, 1327(3), 327-352. MIT Press.
  * Retrieved from http://citeseerx.ist.psu.edu/viewdoc/summary?doi=10.1.1.32.8744
  *
+ * With KPCA_NYSTROM method the kernel matrix is approximated using M landmark
+ * vectors (Williams, C., & Seeger, M. (2001). Using the Nystroem Method to
+ * Speed Up Kernel Machines). Vectors are mapped to
+ * \f$ K_{MM}^{-1/2} k_M(x) \f$, where \f$ k_M(x) \f$ are kernel values
+ * between x and the landmarks, and linear PCA is done in that M-dimensional
+ * space. The kernel matrix between all vectors and the landmarks is processed
+ * in blocks so memory is ~M^2 rather than ~N^2 and applying the preprocessor
+ * requires kernel values to the landmarks only. Landmarks are either chosen
+ * uniformly at random (see set_num_landmarks) or given explicitly
+ * (see set_landmarks).
+ *
+ * With KPCA_LANCZOS method only the target_dim leading eigenpairs of the
+ * centered kernel matrix are computed by CBlockLanczosEigenSolver, which
+ * multiplies the kernel matrix with blocks of vectors in parallel, instead
+ * of its full eigendecomposition.
  */
 class CKernelPCA: public CDimensionReductionPreprocessor
 {
@@ -81,6 +111,38 @@ public:
 			return m_bias_vector;
 		}
 
+		/** set method
+		 * @param method KPCA_EXACT, KPCA_NYSTROM or KPCA_LANCZOS
+		 */
+		void set_method(EKernelPCAMethod method);
+
+		/** get method
+		 * @return method
+		 */
+		EKernelPCAMethod get_method() const;
+
+		/** set number of landmarks chosen uniformly at random
+		 * by KPCA_NYSTROM method
+		 * @param num_landmarks number of landmarks
+		 */
+		void set_num_landmarks(int32_t num_landmarks);
+
+		/** get number of landmarks
+		 * @return number of landmarks
+		 */
+		int32_t get_num_landmarks() const;
+
+		/** set indices of vectors used as landmarks by KPCA_NYSTROM
+		 * method, an empty vector makes landmarks be chosen at random
+		 * @param landmarks indices of landmark vectors
+		 */
+		void set_landmarks(SGVector<index_t> landmarks);
+
+		/** get indices of vectors used as landmarks
+		 * @return indices of landmarks
+		 */
+		SGVector<index_t> get_landmarks() const;
+
 		/** @return object name */
 		virtual const char* get_name() const { return "KernelPCA"; }
 
@@ -92,6 +154,16 @@ public:
 		/** default init */
 		void init();
 
+		/** initialize with Nystroem approximation
+		 * @param features features
+		 */
+		void init_nystrom(CFeatures* features);
+
+		/** initialize with leading eigenpairs computed by block Lanczos
+		 * @param features features
+		 */
+		void init_lanczos(CFeatures* features);
+
 	protected:
 
 		/** features used by init. needed for apply */
@@ -106,6 +178,15 @@ public:
 		/** true when already initialized */
 		bool m_initialized;
 
+		/** method */
+		EKernelPCAMethod m_method;
+
+		/** number of randomly chosen landmarks */
+		int32_t m_num_landmarks;
+
+		/** indices of landmarks */
+		SGVector<index_t> m_landmarks;
+
 };
 }
 #endif
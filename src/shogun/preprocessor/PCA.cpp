@@ -58,6 +58,9 @@ void CPCA::init()
 	m_thresh = 1e-6;
 	m_mem_mode = MEM_REALLOCATE;
 	m_method = AUTO;	
+	m_oversampling = 10;
+	m_num_power_iterations = 2;
+	m_block_size = 1024;
 
 	SG_ADD(&m_transformation_matrix, "transformation_matrix",
 	    "Transformation matrix (Eigenvectors of covariance matrix).",
@@ -75,6 +78,12 @@ void CPCA::init()
 		"Memory mode (in-place or reallocation).", MS_NOT_AVAILABLE);
 	SG_ADD((machine_int_t*) &m_method, "m_method", 
 		"Method used for PCA calculation", MS_NOT_AVAILABLE);
+	SG_ADD(&m_oversampling, "oversampling",
+		"Oversampling of randomized method", MS_NOT_AVAILABLE);
+	SG_ADD(&m_num_power_iterations, "num_power_iterations",
+		"Number of power iterations of randomized method", MS_NOT_AVAILABLE);
+	SG_ADD(&m_block_size, "block_size",
+		"Number of vectors processed at once", MS_NOT_AVAILABLE);
 }
 
 CPCA::~CPCA()
@@ -85,6 +94,14 @@ bool CPCA::init(CFeatures* features)
 {
 	if (!m_initialized)
 	{
+		if (features->get_feature_class()==C_STREAMING_DENSE)
+		{
+			REQUIRE(features->get_feature_type()==F_DREAL, "PCA only works with real features")
+			init_incremental((CStreamingDenseFeatures<float64_t>*) features);
+			m_initialized = true;
+			return true;
+		}
+
 		REQUIRE(features->get_feature_class()==C_DENSE, "PCA only works with dense features")
 		REQUIRE(features->get_feature_type()==F_DREAL, "PCA only works with real features")
 
@@ -114,7 +131,11 @@ bool CPCA::init(CFeatures* features)
 		if (m_method == AUTO)
 			m_method = (num_vectors>num_features) ? EVD : SVD;
 
-		if (m_method == EVD)
+		if (m_method == RANDOMIZED)
+		{
+			init_randomized(fmatrix);
+		}
+		else if (m_method == EVD)
 		{
 			// covariance matrix
 			MatrixXd cov_mat(num_features, num_features);	
@@ -239,6 +260,188 @@ bool CPCA::init(CFeatures* features)
 	return false;
 }
 
+/** computes product of covariance matrix of centered feature matrix and
+ * given basis, processing block_size vectors at once
+ */
+static void covariance_product(const Map<MatrixXd>& fmatrix, const MatrixXd& basis,
+		MatrixXd& result, int32_t block_size)
+{
+	int32_t num_vectors = fmatrix.cols();
+	result.setZero(fmatrix.rows(), basis.cols());
+	for (int32_t begin=0; begin<num_vectors; begin+=block_size)
+	{
+		int32_t size = CMath::min(block_size, num_vectors-begin);
+		MatrixXd projected = fmatrix.middleCols(begin, size).transpose()*basis;
+		result.noalias() += fmatrix.middleCols(begin, size)*projected;
+	}
+	result /= (num_vectors-1);
+}
+
+/** orthonormal basis of the range of given matrix */
+static MatrixXd orthonormal_basis(const MatrixXd& range)
+{
+	HouseholderQR<MatrixXd> qr(range);
+	return qr.householderQ()*MatrixXd::Identity(range.rows(), range.cols());
+}
+
+void CPCA::init_randomized(const Map<MatrixXd>& fmatrix)
+{
+	REQUIRE(m_mode==FIXED_NUMBER, "Randomized PCA only supports FIXED_NUMBER mode\n")
+	REQUIRE(m_block_size>0, "Block size (%d) should be positive\n", m_block_size)
+
+	int32_t num_features = fmatrix.rows();
+	int32_t num_vectors = fmatrix.cols();
+	num_dim = m_target_dim;
+	int32_t num_samples = CMath::min(num_dim+CMath::max(m_oversampling, 0),
+			CMath::min(num_features, num_vectors));
+
+	SG_INFO("Sampling range of covariance matrix with %d vectors ... ", num_samples)
+	MatrixXd range(num_features, num_samples);
+	for (int32_t j=0; j<num_samples; j++)
+	{
+		for (int32_t i=0; i<num_features; i++)
+			range(i,j) = CMath::randn_double();
+	}
+
+	MatrixXd basis = orthonormal_basis(range);
+	for (int32_t i=0; i<m_num_power_iterations; i++)
+	{
+		covariance_product(fmatrix, basis, range, m_block_size);
+		basis = orthonormal_basis(range);
+	}
+	covariance_product(fmatrix, basis, range, m_block_size);
+
+	// covariance matrix restricted to the sampled range
+	MatrixXd projected_cov = basis.transpose()*range;
+	SelfAdjointEigenSolver<MatrixXd> eigenSolve(projected_cov);
+	SG_INFO("Done\nReducing from %i to %i features..", num_features, num_dim)
+
+	m_eigenvalues_vector = SGVector<float64_t>(num_dim);
+	m_transformation_matrix = SGMatrix<float64_t>(num_features,num_dim);
+	Map<MatrixXd> transformMatrix(m_transformation_matrix.matrix, num_features, num_dim);
+	num_old_dim = num_features;
+	for (int32_t i=0; i<num_dim; i++)
+	{
+		m_eigenvalues_vector[i] = eigenSolve.eigenvalues()[num_samples-i-1];
+		transformMatrix.col(i) = basis*eigenSolve.eigenvectors().col(num_samples-i-1);
+		if (m_whitening)
+			transformMatrix.col(i) /= sqrt(m_eigenvalues_vector[i]);
+	}
+}
+
+/** updates principal components (scaled by singular values) and mean of
+ * already seen vectors with the first block_fill vectors of block
+ */
+static void update_components(const MatrixXd& block, int32_t block_fill, int32_t target_dim,
+		MatrixXd& components, VectorXd& singular_values, VectorXd& mean, int64_t& num_seen)
+{
+	int32_t num_components = components.cols();
+	int32_t num_rows = num_components+block_fill+(num_seen>0 ? 1 : 0);
+	VectorXd block_mean = block.leftCols(block_fill).rowwise().sum()/block_fill;
+
+	// rows of the matrix to be decomposed are stored in columns
+	MatrixXd stacked(block.rows(), num_rows);
+	stacked.leftCols(num_components) = components*singular_values.asDiagonal();
+	stacked.middleCols(num_components, block_fill) =
+		block.leftCols(block_fill).colwise()-block_mean;
+	if (num_seen>0)
+	{
+		stacked.col(num_rows-1) = (mean-block_mean)*
+			CMath::sqrt(float64_t(num_seen)*block_fill/(num_seen+block_fill));
+	}
+
+	// right singular vectors from the eigendecomposition of the small gram matrix
+	MatrixXd gram = stacked.transpose()*stacked;
+	SelfAdjointEigenSolver<MatrixXd> eigenSolve(gram);
+	const VectorXd& eigenvalues = eigenSolve.eigenvalues();
+	float64_t tolerance = CMath::max(eigenvalues[num_rows-1], 0.0)*num_rows*1e-14;
+	int32_t rank = 0;
+	while (rank<num_rows && rank<target_dim && eigenvalues[num_rows-rank-1]>tolerance)
+		rank++;
+
+	components.resize(block.rows(), rank);
+	singular_values.resize(rank);
+	for (int32_t i=0; i<rank; i++)
+	{
+		singular_values[i] = CMath::sqrt(eigenvalues[num_rows-i-1]);
+		components.col(i) = stacked*eigenSolve.eigenvectors().col(num_rows-i-1)/singular_values[i];
+	}
+
+	if (num_seen>0)
+		mean = (mean*num_seen+block_mean*block_fill)/(num_seen+block_fill);
+	else
+		mean = block_mean;
+	num_seen += block_fill;
+}
+
+void CPCA::init_incremental(CStreamingDenseFeatures<float64_t>* features)
+{
+	REQUIRE(m_mode==FIXED_NUMBER, "Incremental PCA only supports FIXED_NUMBER mode\n")
+	REQUIRE(m_block_size>0, "Block size (%d) should be positive\n", m_block_size)
+
+	int32_t num_features = 0;
+	int32_t block_fill = 0;
+	int64_t num_seen = 0;
+	MatrixXd block;
+	MatrixXd components;
+	VectorXd singular_values;
+	VectorXd mean;
+
+	SG_INFO("Computing principal components of streaming features ... ")
+	features->start_parser();
+	while (features->get_next_example())
+	{
+		SGVector<float64_t> vec = features->get_vector();
+		if (num_seen==0 && block_fill==0)
+		{
+			num_features = vec.vlen;
+			block.resize(num_features, m_block_size);
+			components.resize(num_features, 0);
+		}
+		REQUIRE(vec.vlen==num_features, "All vectors should have %d features, "
+			"got vector with %d\n", num_features, vec.vlen)
+
+		block.col(block_fill++) = Map<VectorXd>(vec.vector, vec.vlen);
+		features->release_example();
+
+		if (block_fill==m_block_size)
+		{
+			update_components(block, block_fill, m_target_dim,
+					components, singular_values, mean, num_seen);
+			block_fill = 0;
+		}
+	}
+	features->end_parser();
+
+	if (block_fill>0)
+	{
+		update_components(block, block_fill, m_target_dim,
+				components, singular_values, mean, num_seen);
+	}
+
+	REQUIRE(num_seen>1, "At least two vectors are required, got %ld\n", num_seen)
+	num_dim = components.cols();
+	if (num_dim<m_target_dim)
+		SG_WARNING("Data has rank %d lower than target dimension %d\n", num_dim, m_target_dim)
+	SG_INFO("Done\nReducing from %i to %i features..", num_features, num_dim)
+
+	m_mean_vector = SGVector<float64_t>(num_features);
+	Map<VectorXd>(m_mean_vector.vector, num_features) = mean;
+	m_eigenvalues_vector = SGVector<float64_t>(num_dim);
+	Map<VectorXd> eigenValues(m_eigenvalues_vector.vector, num_dim);
+	eigenValues = singular_values.cwiseProduct(singular_values)/(num_seen-1);
+
+	m_transformation_matrix = SGMatrix<float64_t>(num_features,num_dim);
+	Map<MatrixXd> transformMatrix(m_transformation_matrix.matrix, num_features, num_dim);
+	num_old_dim = num_features;
+	transformMatrix = components;
+	if (m_whitening)
+	{
+		for (int32_t i=0; i<num_dim; i++)
+			transformMatrix.col(i) /= sqrt(eigenValues[i]);
+	}
+}
+
 void CPCA::cleanup()
 {
 	m_transformation_matrix=SGMatrix<float64_t>();
@@ -343,4 +546,34 @@ void CPCA::set_memory_mode(EPCAMemoryMode e)
 	m_mem_mode = e;
 }
 
+int32_t CPCA::get_oversampling() const
+{
+	return m_oversampling;
+}
+
+void CPCA::set_oversampling(int32_t oversampling)
+{
+	m_oversampling = oversampling;
+}
+
+int32_t CPCA::get_num_power_iterations() const
+{
+	return m_num_power_iterations;
+}
+
+void CPCA::set_num_power_iterations(int32_t num_power_iterations)
+{
+	m_num_power_iterations = num_power_iterations;
+}
+
+int32_t CPCA::get_block_size() const
+{
+	return m_block_size;
+}
+
+void CPCA::set_block_size(int32_t block_size)
+{
+	m_block_size = block_size;
+}
+
 #endif // HAVE_EIGEN3
@@ -21,6 +21,7 @@
 #include <stdio.h>
 #include <shogun/preprocessor/DimensionReductionPreprocessor.h>
 #include <shogun/features/Features.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 #include <shogun/lib/common.h>
 
 namespace shogun
@@ -37,7 +38,12 @@ enum EPCAMethod
 	/** Eigenvalue decomposition of covariance matrix. 
 	 * Time complexity ~10d^3 (d-dimensions n-number of vectors) 
 	 */
-	EVD
+	EVD,
+	/** randomized SVD of data matrix processed in blocks of vectors.
+	 * Time complexity ~(2q+3)dn(t+p) (t-target dimensions, p-oversampling,
+	 * q-power iterations), additional memory ~d(t+p)
+	 */
+	RANDOMIZED
 };
 
 /** mode of pca */
@@ -91,8 +97,21 @@ enum EPCAMemoryMode
  * using the formula \f$e_i = \frac{\sqrt{d_i}}{N-1}\f$. 
  * The time complexity of this method is \f$~14DN^2\f$ and should be used when N < D.
  *
- * <em>AUTO</em> : This mode automagically chooses one of the above modes for the user
+ * <em>RANDOMIZED</em> : Randomized SVD (Halko, Martinsson, Tropp, 2011) of
+ * the feature matrix. The range of the covariance matrix is sampled by
+ * \f$T+P\f$ gaussian random vectors (P is oversampling), refined by a few power
+ * iterations and the covariance matrix is eigendecomposed within that range.
+ * Feature vectors are processed in blocks so neither the covariance matrix nor
+ * any NxT matrix is ever formed. Only FIXED_NUMBER mode is supported.
+ *
+ * <em>AUTO</em> : This mode automagically chooses one of EVD and SVD for the user
  * based on whether N > D (chooses EVD) or N < D (chooses SVD).
+ *
+ * When init is called with CStreamingDenseFeatures, incremental PCA
+ * (Ross, Lim, Lin, Yang, 2008) is done instead: vectors are read from the
+ * stream in blocks of block size vectors and the T principal components are
+ * updated with each block, so the data is passed only once and is never stored
+ * entirely. Only FIXED_NUMBER mode is supported there as well.
  * 
  * This class provides 3 modes to determine the value of T :
  *
@@ -185,10 +204,47 @@ class CPCA: public CDimensionReductionPreprocessor
 		 */
 		void set_memory_mode(EPCAMemoryMode e);
 
+		/** return the oversampling used by RANDOMIZED method */
+		int32_t get_oversampling() const;
+
+		/** set the number of additional random vectors used by
+		 * RANDOMIZED method to sample the range of covariance matrix
+		 * @param oversampling oversampling
+		 */
+		void set_oversampling(int32_t oversampling);
+
+		/** return the number of power iterations used by RANDOMIZED method */
+		int32_t get_num_power_iterations() const;
+
+		/** set the number of power iterations used by RANDOMIZED method,
+		 * more iterations give better accuracy when eigenvalues decay slowly
+		 * @param num_power_iterations number of power iterations
+		 */
+		void set_num_power_iterations(int32_t num_power_iterations);
+
+		/** return the number of vectors processed at once */
+		int32_t get_block_size() const;
+
+		/** set the number of vectors processed at once by RANDOMIZED
+		 * method and incremental PCA of streaming features
+		 * @param block_size block size
+		 */
+		void set_block_size(int32_t block_size);
+
 	protected:
 
 		void init();
 
+		/** randomized SVD of centered feature matrix
+		 * @param fmatrix centered feature matrix
+		 */
+		void init_randomized(const Eigen::Map<Eigen::MatrixXd>& fmatrix);
+
+		/** incremental PCA of streaming features
+		 * @param features streaming features
+		 */
+		void init_incremental(CStreamingDenseFeatures<float64_t>* features);
+
 	protected:
 
 		/** transformation matrix */
@@ -213,6 +269,12 @@ class CPCA: public CDimensionReductionPreprocessor
 		EPCAMemoryMode m_mem_mode;
 		/** PCA method */
 		EPCAMethod m_method;
+		/** oversampling of RANDOMIZED method */
+		int32_t m_oversampling;
+		/** number of power iterations of RANDOMIZED method */
+		int32_t m_num_power_iterations;
+		/** number of vectors processed at once */
+		int32_t m_block_size;
 };
 }
 #endif // HAVE_EIGEN3
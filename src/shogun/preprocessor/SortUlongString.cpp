@@ -60,22 +60,32 @@ bool CSortUlongString::save(FILE* f)
 /// return pointer to feature_matrix, i.e. f->get_feature_matrix();
 bool CSortUlongString::apply_to_string_features(CFeatures* f)
 {
-	int32_t i;
 	int32_t num_vec=((CStringFeatures<uint64_t>*)f)->get_num_vectors();
+	int32_t num_not_in_memory=0;
 
-	for (i=0; i<num_vec; i++)
+	// strings are sorted independently of each other
+	#pragma omp parallel for num_threads(parallel->get_num_threads()) \
+		schedule(dynamic, 64) reduction(+:num_not_in_memory)
+	for (int32_t i=0; i<num_vec; i++)
 	{
 		int32_t len=0;
 		bool free_vec;
 		uint64_t* vec=((CStringFeatures<uint64_t>*)f)->
 			get_feature_vector(i, len, free_vec);
-		ASSERT(!free_vec) // won't work with non-in-memory string features
+		if (free_vec)
+		{
+			num_not_in_memory++;
+			((CStringFeatures<uint64_t>*)f)->free_feature_vector(vec, i, free_vec);
+			continue;
+		}
 
 		SG_DEBUG("sorting string of length %i\n", len)
 
 		//CMath::qsort(vec, len);
 		CMath::radix_sort(vec, len);
 	}
+
+	ASSERT(num_not_in_memory==0) // won't work with non-in-memory string features
 	return true;
 }
 
@@ -59,21 +59,31 @@ bool CSortWordString::save(FILE* f)
 /// return pointer to feature_matrix, i.e. f->get_feature_matrix();
 bool CSortWordString::apply_to_string_features(CFeatures* f)
 {
-	int32_t i;
-	int32_t num_vec=((CStringFeatures<uint16_t>*)f)->get_num_vectors() ;
+	int32_t num_vec=((CStringFeatures<uint16_t>*)f)->get_num_vectors();
+	int32_t num_not_in_memory=0;
 
-	for (i=0; i<num_vec; i++)
+	// strings are sorted independently of each other
+	#pragma omp parallel for num_threads(parallel->get_num_threads()) \
+		schedule(dynamic, 64) reduction(+:num_not_in_memory)
+	for (int32_t i=0; i<num_vec; i++)
 	{
-		int32_t len = 0 ;
+		int32_t len=0;
 		bool free_vec;
-		uint16_t* vec = ((CStringFeatures<uint16_t>*)f)->get_feature_vector(i, len, free_vec);
-		ASSERT(!free_vec) // won't work with non-in-memory string features
+		uint16_t* vec=((CStringFeatures<uint16_t>*)f)->
+			get_feature_vector(i, len, free_vec);
+		if (free_vec)
+		{
+			num_not_in_memory++;
+			((CStringFeatures<uint16_t>*)f)->free_feature_vector(vec, i, free_vec);
+			continue;
+		}
 
 		//CMath::qsort(vec, len);
 		CMath::radix_sort(vec, len);
-
 	}
-	return true ;
+
+	ASSERT(num_not_in_memory==0) // won't work with non-in-memory string features
+	return true;
 }
 
 /// apply preproc on single feature vector
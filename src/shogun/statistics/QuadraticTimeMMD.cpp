@@ -34,6 +34,8 @@
 #include <shogun/kernel/Kernel.h>
 #include <shogun/kernel/CombinedKernel.h>
 #include <shogun/kernel/CustomKernel.h>
+#include <shogun/mathematics/linalg/linop/DenseMatrixOperator.h>
+#include <shogun/mathematics/linalg/eigsolver/BlockLanczosEigenSolver.h>
 
 using namespace shogun;
 
@@ -358,15 +360,37 @@ SGVector<float64_t> CQuadraticTimeMMD::sample_null_spectrum(index_t num_samples,
 	/* center matrix K=H*K*H */
 	K.center();
 
-	/* compute eigenvalues and select num_eigenvalues largest ones */
-	SGVector<float64_t> eigenvalues=
-			SGMatrix<float64_t>::compute_eigenvectors(K);
 	SGVector<float64_t> largest_ev(num_eigenvalues);
 
-	/* take largest EV, scale by 1/2/m on the fly and take abs value*/
-	for (index_t i=0; i<num_eigenvalues; ++i)
-		largest_ev[i]=CMath::abs(
-				1.0/2/m_m*eigenvalues[eigenvalues.vlen-1-i]);
+#ifdef HAVE_EIGEN3
+	/* few of many eigenvalues are computed by block Lanczos, which only
+	 * needs (parallel) products of K with blocks of vectors */
+	if (num_eigenvalues<K.num_rows/10)
+	{
+		CBlockLanczosEigenSolver* eig_solver=new CBlockLanczosEigenSolver(
+				new CDenseMatrixOperator<float64_t>(K));
+		SG_REF(eig_solver);
+		eig_solver->set_num_eigenpairs(num_eigenvalues);
+		eig_solver->compute();
+		SGVector<float64_t> eigenvalues=eig_solver->get_eigenvalues();
+		SG_UNREF(eig_solver);
+
+		/* largest EV come first, scale by 1/2/m and take abs value */
+		for (index_t i=0; i<num_eigenvalues; ++i)
+			largest_ev[i]=CMath::abs(1.0/2/m_m*eigenvalues[i]);
+	}
+	else
+#endif // HAVE_EIGEN3
+	{
+		/* compute eigenvalues and select num_eigenvalues largest ones */
+		SGVector<float64_t> eigenvalues=
+				SGMatrix<float64_t>::compute_eigenvectors(K);
+
+		/* take largest EV, scale by 1/2/m on the fly and take abs value*/
+		for (index_t i=0; i<num_eigenvalues; ++i)
+			largest_ev[i]=CMath::abs(
+					1.0/2/m_m*eigenvalues[eigenvalues.vlen-1-i]);
+	}
 
 	/* finally, sample from null distribution */
 	SGVector<float64_t> null_samples(num_samples);
@@ -215,6 +215,9 @@ class CQuadraticTimeMMD : public CKernelTwoSampleTest
 		 * See Gretton, A., Fukumizu, K., & Harchaoui, Z. (2011).
 		 * A fast, consistent kernel two-sample test.
 		 *
+		 * If less than a tenth of the eigenvalues are used, they are computed
+		 * by CBlockLanczosEigenSolver instead of a full eigendecomposition.
+		 *
 		 * @param num_samples number of samples to draw
 		 * @param num_eigenvalues number of eigenvalues to use to draw samples
 		 * Maximum number of 2m-1 where m is the size of both sets of samples.
@@ -10,14 +10,115 @@
 
 #include <shogun/structure/BeliefPropagation.h>
 #include <shogun/lib/DynamicObjectArray.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/io/SGIO.h>
 #include <numeric>
 #include <algorithm>
 #include <functional>
+#include <limits>
+#include <queue>
 #include <stack>
 
 using namespace shogun;
 
+void CompiledFactorGraph::compile(CFactorGraph* fg)
+{
+	SGVector<int32_t> fg_cards = fg->get_cardinalities();
+	num_vars = fg_cards.size();
+	cards.assign(fg_cards.vector, fg_cards.vector + num_vars);
+
+	CDynamicObjectArray* facs = fg->get_factors();
+	num_factors = facs->get_num_elements();
+
+	fac_edges.resize(num_factors + 1);
+	energy_index.resize(num_factors + 1);
+	fac_edges[0] = 0;
+	energy_index[0] = 0;
+	edge_var.clear();
+	edge_fac.clear();
+	edge_stride.clear();
+
+	for (int32_t fi = 0; fi < num_factors; ++fi)
+	{
+		CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(fi));
+		SGVector<int32_t> vars = fac->get_variables();
+		SGVector<int32_t> fcards = fac->get_cardinalities();
+		SG_UNREF(fac);
+
+		// the first variable of a factor changes fastest in its energy table
+		int32_t stride = 1;
+		for (int32_t vi = 0; vi < vars.size(); vi++)
+		{
+			ASSERT(fcards[vi] == cards[vars[vi]]);
+			edge_var.push_back(vars[vi]);
+			edge_fac.push_back(fi);
+			edge_stride.push_back(stride);
+			stride *= fcards[vi];
+		}
+
+		fac_edges[fi + 1] = edge_var.size();
+		energy_index[fi + 1] = energy_index[fi] + stride;
+	}
+	SG_UNREF(facs);
+
+	num_edges = edge_var.size();
+	msg_index.resize(num_edges + 1);
+	msg_index[0] = 0;
+	for (int32_t ei = 0; ei < num_edges; ++ei)
+		msg_index[ei + 1] = msg_index[ei] + cards[edge_var[ei]];
+
+	// group edges by variables
+	var_edge_index.assign(num_vars + 1, 0);
+	for (int32_t ei = 0; ei < num_edges; ++ei)
+		var_edge_index[edge_var[ei] + 1]++;
+
+	for (int32_t vi = 0; vi < num_vars; ++vi)
+		var_edge_index[vi + 1] += var_edge_index[vi];
+
+	var_edges.resize(num_edges);
+	std::vector<int32_t> pos(var_edge_index.begin(), var_edge_index.end() - 1);
+	for (int32_t ei = 0; ei < num_edges; ++ei)
+		var_edges[pos[edge_var[ei]]++] = ei;
+
+	energies.resize(energy_index[num_factors]);
+}
+
+void CompiledFactorGraph::update_energies(CFactorGraph* fg)
+{
+	CDynamicObjectArray* facs = fg->get_factors();
+	ASSERT(facs->get_num_elements() == num_factors);
+
+	for (int32_t fi = 0; fi < num_factors; ++fi)
+	{
+		CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(fi));
+		SGVector<float64_t> fenrgs = fac->get_energies();
+		SG_UNREF(fac);
+
+		ASSERT(fenrgs.size() == energy_index[fi + 1] - energy_index[fi]);
+		std::copy(fenrgs.vector, fenrgs.vector + fenrgs.vlen, energies.begin() + energy_index[fi]);
+	}
+	SG_UNREF(facs);
+}
+
+float64_t CompiledFactorGraph::evaluate_energy(const SGVector<int32_t> assignment) const
+{
+	ASSERT(assignment.size() == num_vars);
+
+	float64_t energy = 0;
+	for (int32_t fi = 0; fi < num_factors; ++fi)
+	{
+		int32_t ei = 0;
+		for (int32_t e = fac_edges[fi]; e < fac_edges[fi + 1]; ++e)
+			ei += assignment[edge_var[e]] * edge_stride[e];
+
+		energy += energies[energy_index[fi] + ei];
+	}
+
+	return energy;
+}
+
+// -----------------------------------------------------------------
+
 CBeliefPropagation::CBeliefPropagation()
 	: CMAPInferImpl()
 {
@@ -27,6 +128,9 @@ CBeliefPropagation::CBeliefPropagation()
 CBeliefPropagation::CBeliefPropagation(CFactorGraph* fg)
 	: CMAPInferImpl(fg)
 {
+	ASSERT(m_fg != NULL);
+
+	m_graph.compile(m_fg);
 }
 
 CBeliefPropagation::~CBeliefPropagation()
@@ -39,6 +143,128 @@ float64_t CBeliefPropagation::inference(SGVector<int32_t> assignment)
 	return 0;
 }
 
+void CBeliefPropagation::max_marginalize(int32_t f, int32_t e,
+	const float64_t* q_msgs, float64_t* r_f2v) const
+{
+	const float64_t* fenrgs = &m_graph.energies[m_graph.energy_index[f]];
+	int32_t begin = m_graph.fac_edges[f];
+	int32_t end = m_graph.fac_edges[f + 1];
+	int32_t card = m_graph.cards[m_graph.edge_var[e]];
+	int32_t stride = m_graph.edge_stride[e];
+
+	if (end - begin == 1)
+	{
+		for (int32_t si = 0; si < card; si++)
+			r_f2v[si] = -fenrgs[si];
+
+		return;
+	}
+
+	std::fill(r_f2v, r_f2v + card, -std::numeric_limits<float64_t>::infinity());
+
+	if (end - begin == 2)
+	{
+		// pairwise factor, one table row per state of the other variable
+		// is combined with the message at once
+		int32_t adj_e = (e == begin) ? begin + 1 : begin;
+		int32_t adj_card = m_graph.cards[m_graph.edge_var[adj_e]];
+		int32_t adj_stride = m_graph.edge_stride[adj_e];
+		const float64_t* q_v2f = q_msgs + m_graph.msg_index[adj_e];
+
+		for (int32_t ai = 0; ai < adj_card; ai++)
+		{
+			const float64_t* row = fenrgs + ai * adj_stride;
+			float64_t q = q_v2f[ai];
+			for (int32_t si = 0; si < card; si++)
+				r_f2v[si] = CMath::max(r_f2v[si], q - row[si * stride]);
+		}
+
+		return;
+	}
+
+	// walk through the energy table keeping track of states of the variables
+	int32_t num_fvars = end - begin;
+	int32_t num_assignments = m_graph.energy_index[f + 1] - m_graph.energy_index[f];
+	std::vector<int32_t> states(num_fvars, 0);
+
+	for (int32_t ei = 0; ei < num_assignments; ei++)
+	{
+		float64_t r = -fenrgs[ei];
+		for (int32_t vi = 0; vi < num_fvars; vi++)
+		{
+			if (begin + vi != e)
+				r += q_msgs[m_graph.msg_index[begin + vi] + states[vi]];
+		}
+
+		int32_t var_state = states[e - begin];
+		if (r > r_f2v[var_state])
+			r_f2v[var_state] = r;
+
+		for (int32_t vi = 0; vi < num_fvars; vi++)
+		{
+			if (++states[vi] < m_graph.cards[m_graph.edge_var[begin + vi]])
+				break;
+
+			states[vi] = 0;
+		}
+	}
+}
+
+int32_t CBeliefPropagation::conditioned_argmax(int32_t f, int32_t e, int32_t state,
+	const float64_t* q_msgs) const
+{
+	const float64_t* fenrgs = &m_graph.energies[m_graph.energy_index[f]];
+	int32_t begin = m_graph.fac_edges[f];
+	int32_t num_fvars = m_graph.fac_edges[f + 1] - begin;
+	int32_t num_assignments = m_graph.energy_index[f + 1] - m_graph.energy_index[f];
+	std::vector<int32_t> states(num_fvars, 0);
+
+	int32_t ei_max = state * m_graph.edge_stride[e];
+	float64_t marg_max = -std::numeric_limits<float64_t>::infinity();
+
+	for (int32_t ei = 0; ei < num_assignments; ei++)
+	{
+		if (states[e - begin] == state)
+		{
+			float64_t marg = -fenrgs[ei];
+			for (int32_t vi = 0; vi < num_fvars; vi++)
+			{
+				if (begin + vi != e)
+					marg += q_msgs[m_graph.msg_index[begin + vi] + states[vi]];
+			}
+
+			if (marg > marg_max)
+			{
+				marg_max = marg;
+				ei_max = ei;
+			}
+		}
+
+		for (int32_t vi = 0; vi < num_fvars; vi++)
+		{
+			if (++states[vi] < m_graph.cards[m_graph.edge_var[begin + vi]])
+				break;
+
+			states[vi] = 0;
+		}
+	}
+
+	return ei_max;
+}
+
+void CBeliefPropagation::sum_messages(int32_t v, const float64_t* r_msgs, float64_t* belief) const
+{
+	int32_t card = m_graph.cards[v];
+	std::fill(belief, belief + card, 0);
+
+	for (int32_t i = m_graph.var_edge_index[v]; i < m_graph.var_edge_index[v + 1]; ++i)
+	{
+		const float64_t* r_f2v = r_msgs + m_graph.msg_index[m_graph.var_edges[i]];
+		for (int32_t si = 0; si < card; si++)
+			belief[si] += r_f2v[si];
+	}
+}
+
 // -----------------------------------------------------------------
 
 CTreeMaxProduct::CTreeMaxProduct()
@@ -52,8 +278,6 @@ CTreeMaxProduct::CTreeMaxProduct()
 CTreeMaxProduct::CTreeMaxProduct(CFactorGraph* fg)
 	: CBeliefPropagation(fg)
 {
-	ASSERT(m_fg != NULL);
-
 	init();
 
 	CDisjointSet* dset = m_fg->get_disjoint_set();
@@ -63,150 +287,98 @@ CTreeMaxProduct::CTreeMaxProduct(CFactorGraph* fg)
 	if (!is_connected)
 		m_fg->connect_components();
 
-	get_message_order(m_msg_order, m_is_root);
-
-	// calculate lookup tables for forward messages
-	// a key is unique because a tree has only one root
-	// a var or a factor has only one edge towards root
-	for (uint32_t mi = 0; mi < m_msg_order.size(); mi++)
-	{
-		if (m_msg_order[mi]->mtype == VAR_TO_FAC) // var_to_factor
-		{
-			// <var_id, msg_id>
-			m_msg_map_var[m_msg_order[mi]->child] = mi;
-		}
-		else // factor_to_var
-		{
-			// <fac_id, msg_id>
-			m_msg_map_fac[m_msg_order[mi]->child] = mi;
-			// collect incoming msgs for each var_id
-			m_msgset_map_var[m_msg_order[mi]->parent].insert(mi);
-		}
-	}
-
+	get_message_order(m_msg_order, m_msg_types, m_is_root);
 }
 
 CTreeMaxProduct::~CTreeMaxProduct()
 {
-	if (!m_msg_order.empty())
-	{
-		for (std::vector<MessageEdge*>::iterator it = m_msg_order.begin(); it != m_msg_order.end(); ++it)
-			delete *it;
-	}
 }
 
 void CTreeMaxProduct::init()
 {
-	m_msg_order = std::vector<MessageEdge*>(m_fg->get_num_edges(), (MessageEdge*) NULL);
-	m_is_root = std::vector<bool>(m_fg->get_cardinalities().size(), false);
-	m_fw_msgs = std::vector< std::vector<float64_t> >(m_msg_order.size(),
-			std::vector<float64_t>());
-	m_bw_msgs = std::vector< std::vector<float64_t> >(m_msg_order.size(),
-			std::vector<float64_t>());
-	m_states = std::vector<int32_t>(m_fg->get_cardinalities().size(), 0);
-
-	m_msg_map_var = msg_map_type();
-	m_msg_map_fac = msg_map_type();
-	m_msgset_map_var = msgset_map_type();
+	m_msg_order = std::vector<int32_t>();
+	m_msg_types = std::vector<EEdgeType>();
+	m_is_root = std::vector<bool>();
+	m_q_msgs = std::vector<float64_t>();
+	m_r_msgs = std::vector<float64_t>();
+	m_states = std::vector<int32_t>();
 }
 
-void CTreeMaxProduct::get_message_order(std::vector<MessageEdge*>& order,
-	std::vector<bool>& is_root) const
+void CTreeMaxProduct::get_message_order(std::vector<int32_t>& order,
+	std::vector<EEdgeType>& types, std::vector<bool>& is_root) const
 {
 	ASSERT(m_fg->is_acyclic_graph());
 
-	// 1) pick up roots according to union process of disjoint sets
-	CDisjointSet* dset = m_fg->get_disjoint_set();
-	if (!dset->get_connected())
-	{
-		SG_UNREF(dset);
-		SG_ERROR("%s::get_root_indicators(): run connect_components() first!\n", get_name());
-	}
-
-	int32_t num_vars = m_fg->get_cardinalities().size();
-	if (is_root.size() != (uint32_t)num_vars)
-		is_root.resize(num_vars);
+	const CompiledFactorGraph& g = m_graph;
+	order.clear();
+	types.clear();
+	is_root.assign(g.num_vars, false);
 
-	std::fill(is_root.begin(), is_root.end(), false);
+	std::vector<bool> var_visited(g.num_vars, false);
+	std::vector<bool> fac_visited(g.num_factors, false);
 
-	for (int32_t vi = 0; vi < num_vars; vi++)
-		is_root[dset->find_set(vi)] = true;
+	// <node id, edge towards parent>, variables and factors on separate stacks
+	std::stack< std::pair<int32_t, int32_t> > var_stack;
+	std::stack< std::pair<int32_t, int32_t> > fac_stack;
 
-	SG_UNREF(dset);
-	ASSERT(std::accumulate(is_root.begin(), is_root.end(), 0) >= 1);
-
-	// 2) caculate message order
-	// <var_id, fac_id>
-	var_factor_map_type vf_map;
-	CDynamicObjectArray* facs = m_fg->get_factors();
-
-	for (int32_t fi = 0; fi < facs->get_num_elements(); ++fi)
+	// the first variable found of each connected component is its root,
+	// edges are collected from the roots to the leaves
+	for (int32_t root = 0; root < g.num_vars; root++)
 	{
-		CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(fi));
-		SGVector<int32_t> vars = fac->get_variables();
-		for (int32_t vi = 0; vi < vars.size(); vi++)
-			vf_map.insert(var_factor_map_type::value_type(vars[vi], fi));
-
-		SG_UNREF(fac);
-	}
-
-	std::stack<GraphNode*> node_stack;
-	// init node_stack with root nodes
-	for (uint32_t ni = 0; ni < is_root.size(); ni++)
-	{
-		if (is_root[ni])
-		{
-			// node_id = ni, node_type = variable, parent = none
-			node_stack.push(new GraphNode(ni, VAR_NODE, -1));
-		}
-	}
+		if (var_visited[root])
+			continue;
 
-	if (order.size() != (uint32_t)(m_fg->get_num_edges()))
-		order.resize(m_fg->get_num_edges());
+		is_root[root] = true;
+		var_visited[root] = true;
+		var_stack.push(std::make_pair(root, -1));
 
-	// find reverse order
-	int32_t eid = m_fg->get_num_edges() - 1;
-	while (!node_stack.empty())
-	{
-		GraphNode* node = node_stack.top();
-		node_stack.pop();
-
-		if (node->node_type == VAR_NODE) // child: factor -> parent: var
+		while (!var_stack.empty() || !fac_stack.empty())
 		{
-			typedef var_factor_map_type::const_iterator const_iter;
-			std::pair<const_iter, const_iter> adj_factors = vf_map.equal_range(node->node_id);
-			for (const_iter mi = adj_factors.first; mi != adj_factors.second; ++mi)
+			if (!var_stack.empty()) // child: factor -> parent: var
 			{
-				int32_t adj_factor_id = mi->second;
-				if (adj_factor_id == node->parent)
-					continue;
+				int32_t var_id = var_stack.top().first;
+				int32_t parent_edge = var_stack.top().second;
+				var_stack.pop();
 
-				order[eid--] = new MessageEdge(FAC_TO_VAR, adj_factor_id, node->node_id);
-				// add factor node to node_stack
-				node_stack.push(new GraphNode(adj_factor_id, FAC_NODE, node->node_id));
-			}
-		}
-		else // child: var -> parent: factor
-		{
-			CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(node->node_id));
-			SGVector<int32_t> vars = fac->get_variables();
-			SG_UNREF(fac);
+				for (int32_t i = g.var_edge_index[var_id]; i < g.var_edge_index[var_id + 1]; ++i)
+				{
+					int32_t e = g.var_edges[i];
+					if (e == parent_edge)
+						continue;
 
-			for (int32_t vi = 0; vi < vars.size(); vi++)
+					ASSERT(!fac_visited[g.edge_fac[e]]);
+					fac_visited[g.edge_fac[e]] = true;
+					order.push_back(e);
+					types.push_back(FAC_TO_VAR);
+					fac_stack.push(std::make_pair(g.edge_fac[e], e));
+				}
+			}
+			else // child: var -> parent: factor
 			{
-				if (vars[vi] == node->parent)
-					continue;
+				int32_t fac_id = fac_stack.top().first;
+				int32_t parent_edge = fac_stack.top().second;
+				fac_stack.pop();
 
-				order[eid--] = new MessageEdge(VAR_TO_FAC, vars[vi], node->node_id);
-				// add variable node to node_stack
-				node_stack.push(new GraphNode(vars[vi], VAR_NODE, node->node_id));
+				for (int32_t e = g.fac_edges[fac_id]; e < g.fac_edges[fac_id + 1]; ++e)
+				{
+					if (e == parent_edge)
+						continue;
+
+					ASSERT(!var_visited[g.edge_var[e]]);
+					var_visited[g.edge_var[e]] = true;
+					order.push_back(e);
+					types.push_back(VAR_TO_FAC);
+					var_stack.push(std::make_pair(g.edge_var[e], e));
+				}
 			}
 		}
-
-		delete node;
 	}
 
-	SG_UNREF(facs);
+	ASSERT(std::accumulate(is_root.begin(), is_root.end(), 0) >= 1);
+
+	// reverse order, from leaves to roots
+	std::reverse(order.begin(), order.end());
+	std::reverse(types.begin(), types.end());
 }
 
 float64_t CTreeMaxProduct::inference(SGVector<int32_t> assignment)
@@ -215,6 +387,8 @@ float64_t CTreeMaxProduct::inference(SGVector<int32_t> assignment)
 		"%s::inference(): the output assignment should be prepared as"
 		"the same size as variables!\n", get_name());
 
+	m_graph.update_energies(m_fg);
+
 	bottom_up_pass();
 	top_down_pass();
 
@@ -230,17 +404,11 @@ float64_t CTreeMaxProduct::inference(SGVector<int32_t> assignment)
 void CTreeMaxProduct::bottom_up_pass()
 {
 	SG_DEBUG("\n***enter bottom_up_pass().\n");
-	CDynamicObjectArray* facs = m_fg->get_factors();
-	SGVector<int32_t> cards = m_fg->get_cardinalities();
+	const CompiledFactorGraph& g = m_graph;
 
-	// init forward msgs to 0
-	m_fw_msgs.resize(m_msg_order.size());
-	for (uint32_t mi = 0; mi < m_msg_order.size(); ++mi)
-	{
-		// msg size is determined by var node of msg edge
-		m_fw_msgs[mi].resize(cards[m_msg_order[mi]->get_var_node()]);
-		std::fill(m_fw_msgs[mi].begin(), m_fw_msgs[mi].end(), 0);
-	}
+	// init forward msgs to 0, one more element to never have empty buffers
+	m_q_msgs.assign(g.get_msgs_size() + 1, 0);
+	m_r_msgs.assign(g.get_msgs_size() + 1, 0);
 
 	// pass msgs along the order up to root
 	// if var -> factor
@@ -252,93 +420,42 @@ void CTreeMaxProduct::bottom_up_pass()
 	// on [Nowozin et al. 2011] for more detail.
 	for (uint32_t mi = 0; mi < m_msg_order.size(); ++mi)
 	{
-		SG_DEBUG("mi = %d, mtype: %d %d -> %d\n", mi,
-			m_msg_order[mi]->mtype, m_msg_order[mi]->child, m_msg_order[mi]->parent);
+		int32_t e = m_msg_order[mi];
+		SG_DEBUG("mi = %d, mtype: %d, edge %d\n", mi, m_msg_types[mi], e);
 
-		if (m_msg_order[mi]->mtype == VAR_TO_FAC) // var -> factor
+		if (m_msg_types[mi] == VAR_TO_FAC) // var -> factor
 		{
-			uint32_t var_id = m_msg_order[mi]->child;
-			const std::set<uint32_t>& msgset_var = m_msgset_map_var[var_id];
-
 			// q_v2f = sum(r_f2v), i.e. sum all incoming f2v msgs
-			for (std::set<uint32_t>::const_iterator cit = msgset_var.begin(); cit != msgset_var.end(); cit++)
+			int32_t var_id = g.edge_var[e];
+			int32_t card = g.cards[var_id];
+			float64_t* q_v2f = &m_q_msgs[g.msg_index[e]];
+
+			for (int32_t i = g.var_edge_index[var_id]; i < g.var_edge_index[var_id + 1]; ++i)
 			{
-				std::transform(m_fw_msgs[*cit].begin(), m_fw_msgs[*cit].end(),
-					m_fw_msgs[mi].begin(),
-					m_fw_msgs[mi].begin(),
-					std::plus<float64_t>());
+				if (g.var_edges[i] == e)
+					continue;
+
+				const float64_t* r_f2v = &m_r_msgs[g.msg_index[g.var_edges[i]]];
+				for (int32_t si = 0; si < card; si++)
+					q_v2f[si] += r_f2v[si];
 			}
 		}
 		else // factor -> var
 		{
-			int32_t fac_id = m_msg_order[mi]->child;
-			int32_t var_id = m_msg_order[mi]->parent;
-
-			CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(fac_id));
-			CTableFactorType* ftype = fac->get_factor_type();
-			SGVector<int32_t> fvars = fac->get_variables();
-			SGVector<float64_t> fenrgs = fac->get_energies();
-			SG_UNREF(fac);
-
-			// find index of var_id in the factor
-			SGVector<int32_t> fvar_set = fvars.find(var_id);
-			ASSERT(fvar_set.vlen == 1);
-			int32_t var_id_index = fvar_set[0];
-
-			std::vector<float64_t> r_f2v(fenrgs.size(), 0);
-			std::vector<float64_t> r_f2v_max(cards[var_id],
-				-std::numeric_limits<float64_t>::infinity());
-
-			// TODO: optimize with index_from_new_state()
-			// marginalization
-			// r_f2v = max(-fenrg + sum_{j!=var_id} q_v2f[adj_var_state])
-			for (int32_t ei = 0; ei < fenrgs.size(); ei++)
-			{
-				r_f2v[ei] = -fenrgs[ei];
-
-				for (int32_t vi = 0; vi < fvars.size(); vi++)
-				{
-					if (vi == var_id_index)
-						continue;
-
-					uint32_t adj_msg = m_msg_map_var[fvars[vi]];
-					int32_t adj_var_state = ftype->state_from_index(ei, vi);
-
-					r_f2v[ei] += m_fw_msgs[adj_msg][adj_var_state];
-				}
-
-				// find max value for each state of var_id
-				int32_t var_state = ftype->state_from_index(ei, var_id_index);
-				if (r_f2v[ei] > r_f2v_max[var_state])
-					r_f2v_max[var_state] = r_f2v[ei];
-			}
-
-			// in max-product, final r_f2v = r_f2v_max
-			for (int32_t si = 0; si < cards[var_id]; si++)
-				m_fw_msgs[mi][si] = r_f2v_max[si];
-
-			SG_UNREF(ftype);
+			max_marginalize(g.edge_fac[e], e, &m_q_msgs[0], &m_r_msgs[g.msg_index[e]]);
 		}
 	}
-	SG_UNREF(facs);
 
 	// -energy = max(sum_{f} r_f2root)
 	m_map_energy = 0;
-	for (uint32_t ri = 0; ri < m_is_root.size(); ri++)
+	std::vector<float64_t> rmarg;
+	for (int32_t ri = 0; ri < g.num_vars; ri++)
 	{
 		if (!m_is_root[ri])
 			continue;
 
-		const std::set<uint32_t>& msgset_rt = m_msgset_map_var[ri];
-		std::vector<float64_t> rmarg(cards[ri], 0);
-		for (std::set<uint32_t>::const_iterator cit = msgset_rt.begin(); cit != msgset_rt.end(); cit++)
-		{
-			std::transform(m_fw_msgs[*cit].begin(), m_fw_msgs[*cit].end(),
-				rmarg.begin(),
-				rmarg.begin(),
-				std::plus<float64_t>());
-		}
-
+		rmarg.resize(g.cards[ri]);
+		sum_messages(ri, &m_r_msgs[0], &rmarg[0]);
 		m_map_energy += *std::max_element(rmarg.begin(), rmarg.end());
 	}
 	SG_DEBUG("***leave bottom_up_pass().\n");
@@ -347,211 +464,261 @@ void CTreeMaxProduct::bottom_up_pass()
 void CTreeMaxProduct::top_down_pass()
 {
 	SG_DEBUG("\n***enter top_down_pass().\n");
-	int32_t minf = std::numeric_limits<int32_t>::max();
-	CDynamicObjectArray* facs = m_fg->get_factors();
-	SGVector<int32_t> cards = m_fg->get_cardinalities();
-
-	// init backward msgs to 0
-	m_bw_msgs.resize(m_msg_order.size());
-	for (uint32_t mi = 0; mi < m_msg_order.size(); ++mi)
-	{
-		// msg size is determined by var node of msg edge
-		m_bw_msgs[mi].resize(cards[m_msg_order[mi]->get_var_node()]);
-		std::fill(m_bw_msgs[mi].begin(), m_bw_msgs[mi].end(), 0);
-	}
-
-	// init states to max infinity
-	m_states.resize(cards.size());
-	std::fill(m_states.begin(), m_states.end(), minf);
+	const CompiledFactorGraph& g = m_graph;
+	m_states.assign(g.num_vars, -1);
 
 	// infer states of roots first since marginal distributions of
 	// root variables are ready after bottom-up pass
-	for (uint32_t ri = 0; ri < m_is_root.size(); ri++)
+	std::vector<float64_t> rmarg;
+	for (int32_t ri = 0; ri < g.num_vars; ri++)
 	{
 		if (!m_is_root[ri])
 			continue;
 
-		const std::set<uint32_t>& msgset_rt = m_msgset_map_var[ri];
-		std::vector<float64_t> rmarg(cards[ri], 0);
-		for (std::set<uint32_t>::const_iterator cit = msgset_rt.begin(); cit != msgset_rt.end(); cit++)
-		{
-			// rmarg += m_fw_msgs[*cit]
-			std::transform(m_fw_msgs[*cit].begin(), m_fw_msgs[*cit].end(),
-				rmarg.begin(),
-				rmarg.begin(),
-				std::plus<float64_t>());
-		}
-
-		// argmax
+		rmarg.resize(g.cards[ri]);
+		sum_messages(ri, &m_r_msgs[0], &rmarg[0]);
 		m_states[ri] = static_cast<int32_t>(
 			std::max_element(rmarg.begin(), rmarg.end())
 			- rmarg.begin());
 	}
 
-	// pass msgs down to leaf
-	// if factor <- var edge
-	//   compute q_v2f
-	//   compute marginal of f
-	// else var <- factor edge
-	//   compute r_f2v
+	// pass states down to leaf: the best assignment of a factor given
+	// the state of its parent variable sets the states of its children
 	for (int32_t mi = (int32_t)(m_msg_order.size()-1); mi >= 0; --mi)
 	{
-		SG_DEBUG("mi = %d, mtype: %d %d <- %d\n", mi,
-			m_msg_order[mi]->mtype, m_msg_order[mi]->child, m_msg_order[mi]->parent);
+		if (m_msg_types[mi] != FAC_TO_VAR)
+			continue;
+
+		int32_t e = m_msg_order[mi];
+		int32_t fac_id = g.edge_fac[e];
+		int32_t var_id = g.edge_var[e];
+		ASSERT(m_states[var_id] >= 0);
+
+		int32_t ei_max = conditioned_argmax(fac_id, e, m_states[var_id], &m_q_msgs[0]);
 
-		if (m_msg_order[mi]->mtype == FAC_TO_VAR) // factor <- var
+		for (int32_t ce = g.fac_edges[fac_id]; ce < g.fac_edges[fac_id + 1]; ++ce)
 		{
-			int32_t fac_id = m_msg_order[mi]->child;
-			int32_t var_id = m_msg_order[mi]->parent;
-
-			CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(fac_id));
-			CTableFactorType* ftype = fac->get_factor_type();
-			SGVector<int32_t> fvars = fac->get_variables();
-			SGVector<float64_t> fenrgs = fac->get_energies();
-			SG_UNREF(fac);
-
-			// find index of var_id in the factor
-			SGVector<int32_t> fvar_set = fvars.find(var_id);
-			ASSERT(fvar_set.vlen == 1);
-			int32_t var_id_index = fvar_set[0];
-
-			// q_v2f = r_bw_parent2v + sum_{child!=f} r_fw_child2v
-			// make sure the state of var_id has been inferred (factor marginalization)
-			// s.t. this msg computation will condition on the known state
-			ASSERT(m_states[var_id] != minf);
-
-			// parent msg: r_bw_parent2v
-			if (m_is_root[var_id] == 0)
-			{
-				uint32_t parent_msg = m_msg_map_var[var_id];
-				std::fill(m_bw_msgs[mi].begin(), m_bw_msgs[mi].end(),
-					m_bw_msgs[parent_msg][m_states[var_id]]);
-			}
+			if (ce == e)
+				continue;
 
-			// siblings: sum_{child!=f} r_fw_child2v
-			const std::set<uint32_t>& msgset_var = m_msgset_map_var[var_id];
-			for (std::set<uint32_t>::const_iterator cit = msgset_var.begin();
-				cit != msgset_var.end(); cit++)
-			{
-				if (m_msg_order[*cit]->child == fac_id)
-					continue;
+			int32_t cvar_id = g.edge_var[ce];
+			m_states[cvar_id] = (ei_max / g.edge_stride[ce]) % g.cards[cvar_id];
+		}
+	}
 
-				for (uint32_t xi = 0; xi < m_bw_msgs[mi].size(); xi++)
-					m_bw_msgs[mi][xi] += m_fw_msgs[*cit][m_states[var_id]];
-			}
+	SG_DEBUG("***leave top_down_pass().\n");
+}
 
-			// m_states from maximizing marginal distributions of fac_id
-			// mu(f) = -E(v_state) + sum_v q_v2f
-			std::vector<float64_t> marg(fenrgs.size(), 0);
-			for (uint32_t ei = 0; ei < marg.size(); ei++)
-			{
-				int32_t nei = ftype->index_from_new_state(ei, var_id_index, m_states[var_id]);
-				marg[ei] = -fenrgs[nei];
+// -----------------------------------------------------------------
 
-				for (int32_t vi = 0; vi < fvars.size(); vi++)
-				{
-					if (vi == var_id_index)
-					{
-						int32_t var_id_state = ftype->state_from_index(ei, var_id_index);
-						if (m_states[var_id] != minf)
-							var_id_state = m_states[var_id];
-
-						marg[ei] += m_bw_msgs[mi][var_id_state];
-					}
-					else
-					{
-						uint32_t adj_id = fvars[vi];
-						uint32_t adj_msg = m_msg_map_var[adj_id];
-						int32_t adj_id_state = ftype->state_from_index(ei, vi);
-
-						marg[ei] += m_fw_msgs[adj_msg][adj_id_state];
-					}
-				}
-			}
+CLoopyMaxProduct::CLoopyMaxProduct()
+	: CBeliefPropagation()
+{
+	SG_UNSTABLE("CLoopyMaxProduct::CLoopyMaxProduct()", "\n");
 
-			int32_t ei_max = static_cast<int32_t>(
-				std::max_element(marg.begin(), marg.end())
-				- marg.begin());
+	init();
+}
 
-			// infer states of neiboring vars of f
-			for (int32_t vi = 0; vi < fvars.size(); vi++)
-			{
-				int32_t nvar_id = fvars[vi];
-				// usually parent node has been inferred
-				if (m_states[nvar_id] != minf)
-					continue;
+CLoopyMaxProduct::CLoopyMaxProduct(CFactorGraph* fg)
+	: CBeliefPropagation(fg)
+{
+	init();
+}
 
-				int32_t nvar_id_state = ftype->state_from_index(ei_max, vi);
-				m_states[nvar_id] = nvar_id_state;
-			}
+CLoopyMaxProduct::~CLoopyMaxProduct()
+{
+}
 
-			SG_UNREF(ftype);
-		}
-		else // var <- factor
+void CLoopyMaxProduct::init()
+{
+	m_schedule = RESIDUAL_SCHEDULE;
+	m_max_iter = 100;
+	m_tolerance = 1E-10;
+	m_damping = 0.0;
+}
+
+float64_t CLoopyMaxProduct::inference(SGVector<int32_t> assignment)
+{
+	REQUIRE(assignment.size() == m_fg->get_cardinalities().size(),
+		"%s::inference(): the output assignment should be prepared as"
+		"the same size as variables!\n", get_name());
+
+	m_graph.update_energies(m_fg);
+
+	// one more element to never have empty buffers
+	m_q_msgs.assign(m_graph.get_msgs_size() + 1, 0);
+	m_r_msgs.assign(m_graph.get_msgs_size() + 1, 0);
+	m_new_r_msgs.assign(m_graph.get_msgs_size() + 1, 0);
+
+	if (m_schedule == RESIDUAL_SCHEDULE)
+		residual_updates();
+	else
+		parallel_updates();
+
+	// states maximizing the max-marginals
+	std::vector<float64_t> belief;
+	for (int32_t vi = 0; vi < assignment.size(); vi++)
+	{
+		belief.resize(m_graph.cards[vi]);
+		sum_messages(vi, &m_r_msgs[0], &belief[0]);
+		assignment[vi] = static_cast<int32_t>(
+			std::max_element(belief.begin(), belief.end())
+			- belief.begin());
+	}
+
+	// there are no guarantees on graphs with cycles,
+	// so the energy of the assignment found is returned
+	m_map_energy = -m_graph.evaluate_energy(assignment);
+
+	return -m_map_energy;
+}
+
+float64_t CLoopyMaxProduct::compute_factor_message(int32_t e, float64_t* r_f2v) const
+{
+	max_marginalize(m_graph.edge_fac[e], e, &m_q_msgs[0], r_f2v);
+
+	// max-product messages are defined up to a constant,
+	// normalize such that the maximum is 0
+	int32_t card = m_graph.cards[m_graph.edge_var[e]];
+	const float64_t* old_r_f2v = &m_r_msgs[m_graph.msg_index[e]];
+	float64_t r_max = *std::max_element(r_f2v, r_f2v + card);
+	float64_t change = 0;
+
+	for (int32_t si = 0; si < card; si++)
+	{
+		r_f2v[si] -= r_max;
+		change = CMath::max(change, CMath::abs(r_f2v[si] - old_r_f2v[si]));
+	}
+
+	return change;
+}
+
+void CLoopyMaxProduct::update_var_messages(int32_t v, int32_t except_edge, float64_t* belief)
+{
+	int32_t card = m_graph.cards[v];
+	sum_messages(v, &m_r_msgs[0], belief);
+
+	// q_v2f = sum_{f' != f} r_f'2v
+	for (int32_t i = m_graph.var_edge_index[v]; i < m_graph.var_edge_index[v + 1]; ++i)
+	{
+		int32_t e = m_graph.var_edges[i];
+		if (e == except_edge)
+			continue;
+
+		float64_t* q_v2f = &m_q_msgs[m_graph.msg_index[e]];
+		const float64_t* r_f2v = &m_r_msgs[m_graph.msg_index[e]];
+		float64_t q_max = -std::numeric_limits<float64_t>::infinity();
+
+		for (int32_t si = 0; si < card; si++)
 		{
-			int32_t var_id = m_msg_order[mi]->child;
-			int32_t fac_id = m_msg_order[mi]->parent;
+			q_v2f[si] = belief[si] - r_f2v[si];
+			q_max = CMath::max(q_max, q_v2f[si]);
+		}
+
+		for (int32_t si = 0; si < card; si++)
+			q_v2f[si] -= q_max;
+	}
+}
 
-			CFactor* fac = dynamic_cast<CFactor*>(facs->get_element(fac_id));
-			CTableFactorType* ftype = fac->get_factor_type();
-			SGVector<int32_t> fvars = fac->get_variables();
-			SGVector<float64_t> fenrgs = fac->get_energies();
-			SG_UNREF(fac);
+void CLoopyMaxProduct::residual_updates()
+{
+	const CompiledFactorGraph& g = m_graph;
+	std::vector<float64_t> residuals(g.num_edges);
 
-			// find index of var_id in the factor
-			SGVector<int32_t> fvar_set = fvars.find(var_id);
-			ASSERT(fvar_set.vlen == 1);
-			int32_t var_id_index = fvar_set[0];
+	// all factor to variable messages are candidates at first
+	#pragma omp parallel for num_threads(parallel->get_num_threads())
+	for (int32_t e = 0; e < g.num_edges; e++)
+		residuals[e] = compute_factor_message(e, &m_new_r_msgs[g.msg_index[e]]);
 
-			uint32_t msg_parent = m_msg_map_fac[fac_id];
-			int32_t var_parent = m_msg_order[msg_parent]->parent;
+	// <residual, edge>, outdated entries are skipped
+	typedef std::pair<float64_t, int32_t> residual_type;
+	std::priority_queue<residual_type> queue;
+	for (int32_t e = 0; e < g.num_edges; e++)
+		queue.push(residual_type(residuals[e], e));
 
-			std::vector<float64_t> r_f2v(fenrgs.size());
-			std::vector<float64_t> r_f2v_max(cards[var_id],
-				-std::numeric_limits<float64_t>::infinity());
+	std::vector<float64_t> belief;
+	int64_t max_updates = (int64_t)m_max_iter * g.num_edges;
+	int64_t num_updates = 0;
 
-			// r_f2v = max(-fenrg + sum_{j!=var_id} q_v2f[adj_var_state])
-			for (int32_t ei = 0; ei < fenrgs.size(); ei++)
-			{
-				r_f2v[ei] = -fenrgs[ei];
+	while (!queue.empty() && num_updates < max_updates)
+	{
+		residual_type top = queue.top();
+		queue.pop();
 
-				for (int32_t vi = 0; vi < fvars.size(); vi++)
-				{
-					if (vi == var_id_index)
-						continue;
+		int32_t e = top.second;
+		if (top.first != residuals[e])
+			continue;
 
-					if (fvars[vi] == var_parent)
-					{
-						ASSERT(m_states[var_parent] != minf);
-						r_f2v[ei] += m_bw_msgs[msg_parent][m_states[var_parent]];
-					}
-					else
-					{
-						int32_t adj_id = fvars[vi];
-						uint32_t adj_msg = m_msg_map_var[adj_id];
-						int32_t adj_var_state = ftype->state_from_index(ei, vi);
-
-						if (m_states[adj_id] != minf)
-							adj_var_state = m_states[adj_id];
-
-						r_f2v[ei] += m_fw_msgs[adj_msg][adj_var_state];
-					}
-				}
+		if (top.first < m_tolerance)
+			break;
 
-				// max marginalization
-				int32_t var_id_state = ftype->state_from_index(ei, var_id_index);
-				if (r_f2v[ei] > r_f2v_max[var_id_state])
-					r_f2v_max[var_id_state] = r_f2v[ei];
-			}
+		num_updates++;
+		std::copy(m_new_r_msgs.begin() + g.msg_index[e], m_new_r_msgs.begin() + g.msg_index[e + 1],
+			m_r_msgs.begin() + g.msg_index[e]);
+		residuals[e] = 0;
+
+		// messages from the variable to its other factors change,
+		// and so do messages from these factors to their other variables
+		int32_t v = g.edge_var[e];
+		belief.resize(g.cards[v]);
+		update_var_messages(v, e, &belief[0]);
+
+		for (int32_t i = g.var_edge_index[v]; i < g.var_edge_index[v + 1]; ++i)
+		{
+			int32_t ve = g.var_edges[i];
+			if (ve == e)
+				continue;
 
-			for (int32_t si = 0; si < cards[var_id]; si++)
-				m_bw_msgs[mi][si] = r_f2v_max[si];
+			int32_t f = g.edge_fac[ve];
+			for (int32_t fe = g.fac_edges[f]; fe < g.fac_edges[f + 1]; ++fe)
+			{
+				if (fe == ve)
+					continue;
 
-			SG_UNREF(ftype);
+				residuals[fe] = compute_factor_message(fe, &m_new_r_msgs[g.msg_index[fe]]);
+				queue.push(residual_type(residuals[fe], fe));
+			}
 		}
-	} // end for msg edge
+	}
 
-	SG_UNREF(facs);
-	SG_DEBUG("***leave top_down_pass().\n");
+	SG_DEBUG("%s::residual_updates(): %d message updates\n", get_name(), (int32_t)num_updates);
 }
 
+void CLoopyMaxProduct::parallel_updates()
+{
+	const CompiledFactorGraph& g = m_graph;
+	std::vector<float64_t> residuals(g.num_edges);
+	int32_t num_threads = parallel->get_num_threads();
+
+	for (int32_t iter = 0; iter < m_max_iter; iter++)
+	{
+		#pragma omp parallel for num_threads(num_threads)
+		for (int32_t e = 0; e < g.num_edges; e++)
+			residuals[e] = compute_factor_message(e, &m_new_r_msgs[g.msg_index[e]]);
+
+		for (int32_t i = 0; i < g.get_msgs_size(); i++)
+			m_r_msgs[i] = (1 - m_damping) * m_new_r_msgs[i] + m_damping * m_r_msgs[i];
+
+		#pragma omp parallel num_threads(num_threads)
+		{
+			std::vector<float64_t> belief;
+
+			#pragma omp for
+			for (int32_t v = 0; v < g.num_vars; v++)
+			{
+				belief.resize(g.cards[v]);
+				update_var_messages(v, -1, &belief[0]);
+			}
+		}
+
+		float64_t max_residual = 0;
+		for (int32_t e = 0; e < g.num_edges; e++)
+			max_residual = CMath::max(max_residual, residuals[e]);
+
+		SG_DEBUG("%s::parallel_updates(): iteration %d, largest change %f\n",
+			get_name(), iter, max_residual);
+
+		if (max_residual < m_tolerance)
+			break;
+	}
+}
@@ -16,13 +16,6 @@
 #include <shogun/structure/MAPInference.h>
 
 #include <vector>
-#include <set>
-
-#ifdef HAVE_STD_UNORDERED_MAP
-	#include <unordered_map>
-#else
-	#include <tr1/unordered_map>
-#endif
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
@@ -30,49 +23,71 @@ namespace shogun
 {
 #define IGNORE_IN_CLASSLIST
 
-enum ENodeType
-{
-	VAR_NODE = 0,
-	FAC_NODE = 1
-};
-
 enum EEdgeType
 {
 	VAR_TO_FAC = 0,
 	FAC_TO_VAR = 1
 };
 
-struct GraphNode
+/** schedules of message updates in loopy belief propagation */
+enum ELoopySchedule
 {
-	int32_t node_id;
-	ENodeType node_type; // 1 var, 0 factor
-	int32_t parent; // where came from
-
-	GraphNode(int32_t id, ENodeType type, int32_t pa)
-		: node_id(id), node_type(type), parent(pa) { }
-	~GraphNode() { }
+	/** update the message which would change the most first [1]
+	 *
+	 * [1] Gal Elidan, Ian McGraw and Daphne Koller, Residual Belief
+	 * Propagation: Informed Scheduling for Asynchronous Message Passing, UAI 2006.
+	 */
+	RESIDUAL_SCHEDULE = 0,
+	/** update all messages at once, in parallel */
+	PARALLEL_SCHEDULE = 1
 };
 
-struct MessageEdge
+/** Flat representation of a factor graph for message passing.
+ *
+ * An edge connects a factor to one of its variables. Edges of a factor
+ * are numbered consecutively (CSR adjacency of factors), edges of
+ * a variable are listed in var_edges (CSR adjacency of variables). The
+ * messages of all edges are stored in contiguous buffers, the messages of
+ * edge e occupying the cardinality of its variable starting from msg_index[e],
+ * and the energy tables of all factors are copied into one buffer.
+ */
+struct CompiledFactorGraph
 {
-	EEdgeType mtype; // 1 var_to_factor, 0 factor_to_var
-	int32_t child;
-	int32_t parent;
-
-	MessageEdge(EEdgeType type, int32_t ch, int32_t pa)
-		: mtype(type), child(ch), parent(pa) { }
-
-	~MessageEdge() { }
-
-	inline int32_t get_var_node()
-	{
-		return mtype == VAR_TO_FAC ? child : parent;
-	}
-
-	inline int32_t get_factor_node()
-	{
-		return mtype == VAR_TO_FAC ? parent : child;
-	}
+	/** builds the adjacency structure of the factor graph */
+	void compile(CFactorGraph* fg);
+
+	/** copies the current energy tables of the factors */
+	void update_energies(CFactorGraph* fg);
+
+	/** @return energy of the assignment of all variables */
+	float64_t evaluate_energy(const SGVector<int32_t> assignment) const;
+
+	/** @return total size of the messages of all edges */
+	int32_t get_msgs_size() const { return msg_index[num_edges]; }
+
+	int32_t num_vars;
+	int32_t num_factors;
+	int32_t num_edges;
+
+	/** cardinalities of variables */
+	std::vector<int32_t> cards;
+	/** edges of factor f are fac_edges[f] to fac_edges[f+1]-1 */
+	std::vector<int32_t> fac_edges;
+	/** edges of variable v are var_edges[var_edge_index[v]] to var_edges[var_edge_index[v+1]-1] */
+	std::vector<int32_t> var_edge_index;
+	std::vector<int32_t> var_edges;
+	/** variable of an edge */
+	std::vector<int32_t> edge_var;
+	/** factor of an edge */
+	std::vector<int32_t> edge_fac;
+	/** stride of the variable of an edge in the energy table of the factor */
+	std::vector<int32_t> edge_stride;
+	/** offset of the messages of an edge */
+	std::vector<int32_t> msg_index;
+	/** offset of the energy table of a factor */
+	std::vector<int32_t> energy_index;
+	/** energy tables */
+	std::vector<float64_t> energies;
 };
 
 /** If tree structure, do exact inference, otherwise loopy belief propagation */
@@ -89,8 +104,38 @@ public:
 
 	virtual float64_t inference(SGVector<int32_t> assignment);
 
+protected:
+	/** computes max-marginalization of a factor towards a variable
+	 * r_f2v = max(-fenrg + sum_{j!=var} q_v2f[adj_var_state])
+	 *
+	 * @param f factor
+	 * @param e edge of the factor towards the variable
+	 * @param q_msgs variable to factor messages
+	 * @param r_f2v output for each state of the variable
+	 */
+	void max_marginalize(int32_t f, int32_t e, const float64_t* q_msgs, float64_t* r_f2v) const;
+
+	/** finds the best assignment of a factor with the state of one variable fixed
+	 *
+	 * @param f factor
+	 * @param e edge of the factor towards the fixed variable
+	 * @param state state of the fixed variable
+	 * @param q_msgs variable to factor messages
+	 * @return index of the assignment in the energy table
+	 */
+	int32_t conditioned_argmax(int32_t f, int32_t e, int32_t state, const float64_t* q_msgs) const;
+
+	/** sums factor to variable messages of all edges of a variable
+	 *
+	 * @param v variable
+	 * @param r_msgs factor to variable messages
+	 * @param belief output for each state of the variable
+	 */
+	void sum_messages(int32_t v, const float64_t* r_msgs, float64_t* belief) const;
+
 protected:
 	float64_t m_map_energy;
+	CompiledFactorGraph m_graph;
 };
 
 /** max-product algorithm for tree graph
@@ -103,16 +148,6 @@ protected:
  */
 IGNORE_IN_CLASSLIST class CTreeMaxProduct : public CBeliefPropagation
 {
-#ifdef HAVE_STD_UNORDERED_MAP
-	typedef std::unordered_map<uint32_t, uint32_t> msg_map_type;
-	typedef std::unordered_map<uint32_t, std::set<uint32_t> > msgset_map_type;
-	typedef std::unordered_multimap<int32_t, int32_t> var_factor_map_type;
-#else
-	typedef std::tr1::unordered_map<uint32_t, uint32_t> msg_map_type;
-	typedef std::tr1::unordered_map<uint32_t, std::set<uint32_t> > msgset_map_type;
-	typedef std::tr1::unordered_multimap<int32_t, int32_t> var_factor_map_type;
-#endif
-
 public:
 	CTreeMaxProduct();
 	CTreeMaxProduct(CFactorGraph* fg);
@@ -127,21 +162,90 @@ public:
 protected:
 	void bottom_up_pass();
 	void top_down_pass();
-	void get_message_order(std::vector<MessageEdge*>& order, std::vector<bool>& is_root) const;
+	void get_message_order(std::vector<int32_t>& order, std::vector<EEdgeType>& types,
+		std::vector<bool>& is_root) const;
 
 private:
 	void init();
 
 private:
-	std::vector<MessageEdge*> m_msg_order;
+	/** edges from leaves to roots */
+	std::vector<int32_t> m_msg_order;
+	/** direction of edges towards roots */
+	std::vector<EEdgeType> m_msg_types;
 	std::vector<bool> m_is_root;
-	std::vector< std::vector<float64_t> > m_fw_msgs;
-	std::vector< std::vector<float64_t> > m_bw_msgs;
+	std::vector<float64_t> m_q_msgs;
+	std::vector<float64_t> m_r_msgs;
 	std::vector<int32_t> m_states;
+};
 
-	msg_map_type m_msg_map_var;
-	msg_map_type m_msg_map_fac;
-	msgset_map_type m_msgset_map_var;
+/** max-product algorithm for graphs with cycles, messages are
+ * passed until they don't change any more, see section 3.2 of [1].
+ *
+ * [1] Sebastian Nowozin and Christoph H. Lampert,
+ * Structured Learning and Prediction for Computer Vision,
+ * Foundations and Trends in Computer Graphics and Vision series
+ * of now publishers, 2011.
+ */
+IGNORE_IN_CLASSLIST class CLoopyMaxProduct : public CBeliefPropagation
+{
+public:
+	CLoopyMaxProduct();
+	CLoopyMaxProduct(CFactorGraph* fg);
+
+	virtual ~CLoopyMaxProduct();
+
+	/** @return class name */
+	virtual const char* get_name() const { return "LoopyMaxProduct"; }
+
+	virtual float64_t inference(SGVector<int32_t> assignment);
+
+	/** @param schedule schedule of message updates */
+	void set_schedule(ELoopySchedule schedule) { m_schedule = schedule; }
+
+	/** @return schedule of message updates */
+	ELoopySchedule get_schedule() const { return m_schedule; }
+
+	/** @param max_iter maximum number of updates of every message */
+	void set_max_iterations(int32_t max_iter) { m_max_iter = max_iter; }
+
+	/** @return maximum number of updates of every message */
+	int32_t get_max_iterations() const { return m_max_iter; }
+
+	/** @param tolerance largest change of a message considered as converged */
+	void set_tolerance(float64_t tolerance) { m_tolerance = tolerance; }
+
+	/** @return largest change of a message considered as converged */
+	float64_t get_tolerance() const { return m_tolerance; }
+
+	/** @param damping weight of the previous message in parallel updates */
+	void set_damping(float64_t damping) { m_damping = damping; }
+
+	/** @return weight of the previous message in parallel updates */
+	float64_t get_damping() const { return m_damping; }
+
+protected:
+	void residual_updates();
+	void parallel_updates();
+
+	/** updates variable to factor messages of a variable except towards one edge */
+	void update_var_messages(int32_t v, int32_t except_edge, float64_t* belief);
+
+	/** computes a factor to variable message and how much it changes */
+	float64_t compute_factor_message(int32_t e, float64_t* r_f2v) const;
+
+private:
+	void init();
+
+private:
+	ELoopySchedule m_schedule;
+	int32_t m_max_iter;
+	float64_t m_tolerance;
+	float64_t m_damping;
+
+	std::vector<float64_t> m_q_msgs;
+	std::vector<float64_t> m_r_msgs;
+	std::vector<float64_t> m_new_r_msgs;
 };
 
 }
@@ -526,27 +526,15 @@ SGSparseVector<float64_t> CCCSOSVM::find_cutting_plane(float64_t* margin)
 	SGVector<float64_t> new_constraint(m_model->get_dim());
 	int32_t psi_size = m_model->get_dim();
 
-	index_t num_samples = m_model->get_features()->get_num_vectors();
+	CFeatures* features = m_model->get_features();
+	index_t num_samples = features->get_num_vectors();
+	SG_UNREF(features);
 	/* find cutting plane */
-	*margin = 0;
-	new_constraint.zero();
-	for (index_t i = 0; i < num_samples; i++)
-	{
-		CResultSet* result = m_model->argmax(m_w, i);
-		new_constraint.add(result->psi_truth);
-		result->psi_pred.scale(-1.0);
-		new_constraint.add(result->psi_pred);
-		/*
-		printf("%.16lf %.16lf\n",
-				SGVector<float64_t>::dot(result->psi_truth.vector, result->psi_truth.vector, result->psi_truth.vlen),
-				SGVector<float64_t>::dot(result->psi_pred.vector, result->psi_pred.vector, result->psi_pred.vlen));
-		*/
-		*margin += result->delta;
-		SG_UNREF(result);
-	}
-	/* scaling */
+	float64_t score = 0;
+	sum_argmax_results(m_w, 0, num_samples, new_constraint.vector, score, *margin);
+	/* scaling, the constraint is sum of psi_truth - psi_pred */
 	float64_t scale = 1/(float64_t)num_samples;
-	new_constraint.scale(scale);
+	new_constraint.scale(-scale);
 	*margin *= scale;
 
 	/* find the nnz elements in new_constraint */
@@ -18,9 +18,13 @@
 #include <shogun/features/Alphabet.h>
 #include <shogun/structure/Plif.h>
 #include <shogun/structure/IntronList.h>
+#include <shogun/base/init.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/lib/ShogunException.h>
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <ctype.h>
 
@@ -1015,11 +1019,10 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 		//for (int32_t i=0;i<m_N*m_seq_len*max_num_signals;i++)
       //   SG_PRINT("(%i)%0.2f ",i,seq_array[i])
 
-		CDynamicObjectArray PEN((CSGObject**) Plif_matrix, m_N, m_N, false, false) ; // 2d, CPlifBase*
-		PEN.set_array_name("PEN");
-
-		CDynamicObjectArray PEN_state_signals((CSGObject**) Plif_state_signals, m_N, max_num_signals, false, false) ; // 2d,  CPlifBase*
-		PEN_state_signals.set_array_name("state_signals");
+		// plain pointers, the element access of CDynamicObjectArray takes a
+		// reference on every lookup
+		CPlifBase** PEN = Plif_matrix ; // 2d (m_N x m_N), PEN[j+m_N*ii]
+		CPlifBase** PEN_state_signals = Plif_state_signals ; // 2d (m_N x max_num_signals)
 
 		CDynamicArray<float64_t> seq(m_N, m_seq_len) ; // 2d
 		seq.set_array_name("seq") ;
@@ -1072,7 +1075,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 				for (int32_t j=0; j<m_seq_len; j++)
 					for (int32_t k=0; k<max_num_signals; k++)
 					{
-						if ((PEN_state_signals.element(i,k)==NULL) && (k==0))
+						if ((PEN_state_signals[i+m_N*k]==NULL) && (k==0))
 						{
 							// no plif
 							if (seq_input!=NULL)
@@ -1086,13 +1089,13 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 							}
 							break ;
 						}
-						if (PEN_state_signals.element(i,k)!=NULL)
+						if (PEN_state_signals[i+m_N*k]!=NULL)
 						{
 							if (seq_input!=NULL)
 							{
 								// just one plif
 								if (CMath::is_finite(seq_input->element(i,j,k)))
-									seq.element(i,j) += ((CPlifBase*) PEN_state_signals.element(i,k))->lookup_penalty(seq_input->element(i,j,k), svm_value) ;
+									seq.element(i,j) += ((CPlifBase*) PEN_state_signals[i+m_N*k])->lookup_penalty(seq_input->element(i,j,k), svm_value) ;
 								else
 									// keep infinity values
 									seq.element(i,j) = seq_input->element(i, j, k) ;
@@ -1103,7 +1106,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 								{
 									// just one plif
 									if (CMath::is_finite(m_seq_sparse1->get_feature(i,j)))
-										seq.element(i,j) += ((CPlifBase*) PEN_state_signals.element(i,k))->lookup_penalty(m_seq_sparse1->get_feature(i,j), svm_value) ;
+										seq.element(i,j) += ((CPlifBase*) PEN_state_signals[i+m_N*k])->lookup_penalty(m_seq_sparse1->get_feature(i,j), svm_value) ;
 									else
 										// keep infinity values
 										seq.element(i,j) = m_seq_sparse1->get_feature(i, j) ;
@@ -1112,7 +1115,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 								{
 									// just one plif
 									if (CMath::is_finite(m_seq_sparse2->get_feature(i,j)))
-										seq.element(i,j) += ((CPlifBase*) PEN_state_signals.element(i,k))->lookup_penalty(m_seq_sparse2->get_feature(i,j), svm_value) ;
+										seq.element(i,j) += ((CPlifBase*) PEN_state_signals[i+m_N*k])->lookup_penalty(m_seq_sparse2->get_feature(i,j), svm_value) ;
 									else
 										// keep infinity values
 										seq.element(i,j) = m_seq_sparse2->get_feature(i, j) ;
@@ -1153,7 +1156,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 		CDynamicArray<float64_t> long_transition_content_scores_loss(m_N,m_N) ; // 2d
 		long_transition_content_scores_loss.set_array_name("long_transition_content_scores_loss");
 
-		if (nbest!=1)
+		if (nbest!=1 && long_transitions)
 		{
 			SG_ERROR("Long transitions are not supported for nbest!=1")
 			long_transitions = false ;
@@ -1202,7 +1205,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 				{
 					T_STATES ii = elem_list[i] ;
 
-					CPlifBase *penij=(CPlifBase*) PEN.element(j, ii) ;
+					CPlifBase *penij=(CPlifBase*) PEN[j+m_N*ii] ;
 					if (penij==NULL)
 					{
 						if (long_transitions)
@@ -1263,6 +1266,80 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 				}
 			SG_DEBUG("Using %i long transitions\n", num_long_transitions)
 		}
+
+		// flat tables of the penalties of all segment lengths a transition
+		// can see, for Plifs that do not depend on svm values; transitions
+		// sharing a Plif share its table
+		const float64_t** pen_table = SG_MALLOC(const float64_t*, m_N*m_N) ;
+		int32_t* pen_table_len = SG_CALLOC(int32_t, m_N*m_N) ;
+		float64_t* pen_table_values = NULL ;
+		{
+			const int32_t max_seg_len = m_seq_len>0 ? CMath::max(m_pos[m_seq_len-1]-m_pos[0], 0) : 0 ;
+
+			int32_t num_tables = 0 ;
+			const CPlifBase** table_plif = SG_MALLOC(const CPlifBase*, m_N*m_N) ;
+			int32_t* table_len = SG_MALLOC(int32_t, m_N*m_N) ;
+			int32_t* table_id = SG_MALLOC(int32_t, m_N*m_N) ;
+
+			for (int32_t j=0; j<m_N; j++)
+			{
+				for (int32_t i=0; i<trans_list_forward_cnt[j]; i++)
+				{
+					T_STATES ii = trans_list_forward[j][i] ;
+					const CPlifBase* penalty = PEN[j+m_N*ii] ;
+					table_id[j+m_N*ii] = -1 ;
+					if (penalty==NULL || penalty->uses_svm_values())
+						continue ;
+
+					int32_t len = CMath::min(look_back.element(j, ii), max_seg_len)+1 ;
+					int32_t id = 0 ;
+					while (id<num_tables && table_plif[id]!=penalty)
+						id++ ;
+					if (id==num_tables)
+					{
+						table_plif[num_tables] = penalty ;
+						table_len[num_tables++] = len ;
+					}
+					else
+						table_len[id] = CMath::max(table_len[id], len) ;
+					table_id[j+m_N*ii] = id ;
+				}
+			}
+
+			int64_t* table_offset = SG_MALLOC(int64_t, num_tables+1) ;
+			table_offset[0] = 0 ;
+			for (int32_t id=0; id<num_tables; id++)
+				table_offset[id+1] = table_offset[id]+table_len[id] ;
+
+			pen_table_values = SG_MALLOC(float64_t, table_offset[num_tables]) ;
+			for (int32_t id=0; id<num_tables; id++)
+			{
+				float64_t* values = pen_table_values+table_offset[id] ;
+				for (int32_t len=0; len<table_len[id]; len++)
+					values[len] = table_plif[id]->lookup_penalty(len, (float64_t*) NULL) ;
+			}
+
+			for (int32_t j=0; j<m_N; j++)
+			{
+				for (int32_t ii=0; ii<m_N; ii++)
+					pen_table[j+m_N*ii] = NULL ;
+				for (int32_t i=0; i<trans_list_forward_cnt[j]; i++)
+				{
+					T_STATES ii = trans_list_forward[j][i] ;
+					int32_t id = table_id[j+m_N*ii] ;
+					if (id>=0)
+					{
+						pen_table[j+m_N*ii] = pen_table_values+table_offset[id] ;
+						pen_table_len[j+m_N*ii] = table_len[id] ;
+					}
+				}
+			}
+
+			SG_FREE(table_plif);
+			SG_FREE(table_len);
+			SG_FREE(table_id);
+			SG_FREE(table_offset);
+		}
 		//SG_PRINT("max_look_back: %i \n", max_look_back)
 
 		//SG_PRINT("use_svm=%i, genestr_len: \n", use_svm, m_genestr.get_dim1())
@@ -1354,7 +1431,6 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 		//m_svm_pos_start.set_array_name("svm_pos_start") ;
 		m_num_unique_words.set_array_name("num_unique_words") ;
 
-		PEN.set_array_name("PEN") ;
 		seq.set_array_name("seq") ;
 
 		delta.set_array_name("delta") ;
@@ -1391,8 +1467,6 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 		//m_svm_pos_start.display_array() ;
 		m_num_unique_words.display_array() ;
 
-		PEN.display_size() ;
-		PEN_state_signals.display_size() ;
 		seq.display_size() ;
 		m_orf_info.display_size() ;
 
@@ -1458,7 +1532,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 				/*
 				   for (T_STATES j=0; j<m_N; j++)
 				   {
-				   CPlifBase * penalty = PEN.element(i,j) ;
+				   CPlifBase * penalty = PEN[i+m_N*j] ;
 				   int32_t num_current_svms=0;
 				   int32_t svm_ids[] = {-8, -7, -6, -5, -4, -3, -2, -1};
 				   if (penalty)
@@ -1514,7 +1588,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 					{
 						T_STATES ii = elem_list[i] ;
 
-						const CPlifBase* penalty = (CPlifBase*) PEN.element(j,ii) ;
+						const CPlifBase* penalty = (CPlifBase*) PEN[j+m_N*ii] ;
 
 						/*int32_t look_back = max_look_back ;
 						  if (0)
@@ -1544,6 +1618,44 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 							ASSERT(orf_target>=0 && orf_target<3)
 						}
 
+						const float64_t* pen_table_ = pen_table[j+m_N*ii] ;
+						if (nbest==1 && orf_target==-1 && !with_loss && (penalty==NULL || pen_table_!=NULL))
+						{
+							// the common case: every predecessor position is
+							// allowed and the penalty only depends on the
+							// segment length, so the scan over the look-back
+							// window runs on contiguous delta values and a
+							// table lookup per position
+							const int32_t* pos = m_pos.get_array() ;
+							const int32_t pos_t = pos[t] ;
+							const int32_t table_len = pen_table_len[j+m_N*ii] ;
+							const float64_t* delta_ii = &delta_array[ii*m_seq_len] ;
+							const float64_t elem_val_i = elem_val[i] ;
+
+							for (int32_t ts=t-1; ts>=0 && pos_t-pos[ts]<=look_back_; ts--)
+							{
+								float64_t val = elem_val_i ;
+								if (pen_table_!=NULL)
+								{
+									int32_t len = pos_t-pos[ts] ;
+									if (len>=0 && len<table_len)
+										val += pen_table_[len] ;
+									else
+										val += penalty->lookup_penalty(len, svm_value) ;
+								}
+
+								float64_t mval = -(val + delta_ii[ts]) ;
+								if (mval<fixedtempvv_)
+								{
+									fixedtempvv_ = mval ;
+									fixedtempii_ = ii + ts*m_N;
+									fixed_list_len = 1 ;
+									fixedtemplong = false ;
+								}
+							}
+							continue ;
+						}
+
 						int32_t orf_last_pos = m_pos[t] ;
 #ifdef DYNPROG_TIMING
 						MyTime3.start() ;
@@ -1583,16 +1695,18 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 								// BEST_PATH_TRANS
 								////////////////////////////////////////////////////////
 
-								int32_t frame = orf_from;//m_orf_info.element(ii,0);
-								lookup_content_svm_values(ts, t, m_pos[ts], m_pos[t], svm_value, frame);
-
 								float64_t pen_val = 0.0 ;
-								if (penalty)
+								int32_t len = m_pos[t]-m_pos[ts] ;
+								if (pen_table_!=NULL && len>=0 && len<pen_table_len[j+m_N*ii])
+									pen_val = pen_table_[len] ;
+								else if (penalty)
 								{
+									int32_t frame = orf_from;//m_orf_info.element(ii,0);
+									lookup_content_svm_values(ts, t, m_pos[ts], m_pos[t], svm_value, frame);
 #ifdef DYNPROG_TIMING_DETAIL
 									MyTime.start() ;
 #endif
-									pen_val = penalty->lookup_penalty(m_pos[t]-m_pos[ts], svm_value) ;
+									pen_val = penalty->lookup_penalty(len, svm_value) ;
 
 #ifdef DYNPROG_TIMING_DETAIL
 									MyTime.stop() ;
@@ -1681,7 +1795,7 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 					{
 						T_STATES ii = elem_list[i] ;
 
-						const CPlifBase* penalty = (CPlifBase*) PEN.element(j,ii) ;
+						const CPlifBase* penalty = (CPlifBase*) PEN[j+m_N*ii] ;
 
 						/*int32_t look_back = max_look_back ;
 						  if (0)
@@ -2045,9 +2159,68 @@ void CDynProg::compute_nbest_paths(int32_t max_num_signals, bool use_orf,
 
 		SG_FREE(fixedtempvv);
 		SG_FREE(fixedtempii);
+		SG_FREE(pen_table);
+		SG_FREE(pen_table_len);
+		SG_FREE(pen_table_values);
+		SG_FREE(svm_value);
 	}
 
 
+void CDynProg::compute_nbest_paths_batch(CDynamicObjectArray* dyn_progs,
+		int32_t max_num_signals, bool use_orf, int16_t nbest, bool with_loss)
+{
+	REQUIRE(dyn_progs, "No sequences given\n")
+
+	int32_t num_seqs=dyn_progs->get_num_elements();
+	CDynProg** models=SG_MALLOC(CDynProg*, num_seqs);
+	for (int32_t i=0; i<num_seqs; i++)
+	{
+		models[i]=dynamic_cast<CDynProg*>(dyn_progs->get_element(i));
+		REQUIRE(models[i], "Element %d is not a CDynProg\n", i)
+		REQUIRE(models[i]->m_svm_arrays_clean, "SVM arrays of sequence %d not clean\n", i)
+	}
+
+	Parallel* parallel=shogun::get_global_parallel();
+	int32_t num_threads=parallel->get_num_threads();
+	SG_UNREF(parallel);
+
+	// sequences differ in length, hand them out one by one; errors are
+	// raised again once all threads are done
+	char* error=NULL;
+	#pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+	for (int32_t i=0; i<num_seqs; i++)
+	{
+		if (error)
+			continue;
+
+		try
+		{
+			models[i]->compute_nbest_paths(max_num_signals, use_orf, nbest, with_loss, false);
+		}
+		catch (ShogunException& e)
+		{
+			#pragma omp critical (dynprog_batch_error)
+			{
+				if (!error)
+					error=get_strdup(e.get_exception_string());
+			}
+		}
+	}
+
+	for (int32_t i=0; i<num_seqs; i++)
+		SG_UNREF(models[i]);
+	SG_FREE(models);
+
+	if (error)
+	{
+		char msg[1024];
+		strncpy(msg, error, sizeof(msg)-1);
+		msg[sizeof(msg)-1]='\0';
+		SG_FREE(error);
+		SG_SERROR("Error decoding sequence: %s\n", msg)
+	}
+}
+
 void CDynProg::best_path_trans_deriv(
 	int32_t *my_state_seq, int32_t *my_pos_seq,
 	int32_t my_seq_len, const float64_t *seq_array, int32_t max_num_signals)
@@ -264,6 +264,9 @@ public:
 
 
 	/** run the viterbi algorithm to compute the n best viterbi paths
+	 *
+	 * nbest>1 requires long transitions to be switched off, see
+	 * long_transition_settings().
 	 *
 	 * @param max_num_signals maximal number of signals for a single state
 	 * @param use_orf whether orf shall be used
@@ -274,6 +277,25 @@ public:
 	void compute_nbest_paths(int32_t max_num_signals,
 						 bool use_orf, int16_t nbest, bool with_loss, bool with_multiple_sequences);
 
+	/** run compute_nbest_paths on many independent sequences in parallel
+	 *
+	 * Every element is a CDynProg that is completely set up for one
+	 * sequence (e.g. one genomic region); its results are available through
+	 * get_scores(), get_states() and get_positions() afterwards. Each
+	 * sequence is decoded by a single thread with its own working memory,
+	 * so Plif matrices may be shared between the elements. The number of
+	 * threads is that of the global Parallel object. An error in any of
+	 * the sequences is raised once all threads are done.
+	 *
+	 * @param dyn_progs array of CDynProg, one per sequence
+	 * @param max_num_signals maximal number of signals for a single state
+	 * @param use_orf whether orf shall be used
+	 * @param nbest number of best paths (n)
+	 * @param with_loss use loss
+	 */
+	static void compute_nbest_paths_batch(CDynamicObjectArray* dyn_progs,
+			int32_t max_num_signals, bool use_orf, int16_t nbest, bool with_loss);
+
 ////////////////////////////////////////////////////////////////////////////////
 
 	/** given a path though the state model and the corresponding
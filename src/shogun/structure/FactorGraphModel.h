@@ -120,6 +120,14 @@ public:
 	 */
 	virtual CResultSet* argmax(SGVector< float64_t > w, int32_t feat_idx, bool const training = true);
 
+	/** factor parameters are only updated when w changes, so after the
+	 * first call with some w the calls only modify the factor graph of
+	 * the given example. The examples must not share factor graphs.
+	 *
+	 * @return true unless verbose
+	 */
+	virtual bool is_argmax_thread_safe() const;
+
 	/** computes \f$ \Delta(y_{1}, y_{2}) \f$
 	 *
 	 * @param y1 an instance of structured data
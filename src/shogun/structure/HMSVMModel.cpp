@@ -76,16 +76,21 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 
 	// Translate from labels sequence to state sequence
 	SGVector< int32_t > state_seq = m_state_model->labels_to_states(label_seq);
-	m_transmission_weights.zero();
+	// Local buffers, so that joint feature vectors can be computed concurrently
+	int32_t S = m_state_model->get_num_states();
+	SGMatrix< float64_t > transmission_weights(S, S);
+	SGVector< float64_t > emission_weights(
+			S*D*(m_use_plifs ? m_num_plif_nodes : m_num_obs));
+	transmission_weights.zero();
 
 	for ( int32_t i = 0 ; i < state_seq.vlen-1 ; ++i )
-		m_transmission_weights(state_seq[i],state_seq[i+1]) += 1;
+		transmission_weights(state_seq[i],state_seq[i+1]) += 1;
 
 	SGMatrix< float64_t > obs = mf->get_feature_vector(feat_idx);
 	REQUIRE(obs.num_rows == D && obs.num_cols == state_seq.vlen,
 		"obs.num_rows (%d) != D (%d) OR obs.num_cols (%d) != state_seq.vlen (%d)\n",
 		obs.num_rows, D, obs.num_cols, state_seq.vlen)
-	m_emission_weights.zero();
+	emission_weights.zero();
 	index_t aux_idx, weight_idx;
 
 	if ( !m_use_plifs )	// Do not use PLiFs
@@ -97,17 +102,15 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 			for ( int32_t j = 0 ; j < state_seq.vlen ; ++j )
 			{
 				weight_idx = aux_idx + state_seq[j]*D*m_num_obs + obs(f,j);
-				m_emission_weights[weight_idx] += 1;
+				emission_weights[weight_idx] += 1;
 			}
 		}
 
-		m_state_model->weights_to_vector(psi, m_transmission_weights, m_emission_weights,
+		m_state_model->weights_to_vector(psi, transmission_weights, emission_weights,
 				D, m_num_obs);
 	}
 	else	// Use PLiFs
 	{
-		int32_t S = m_state_model->get_num_states();
-
 		for ( int32_t f = 0 ; f < D ; ++f )
 		{
 			aux_idx = f*m_num_plif_nodes;
@@ -132,15 +135,15 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 				weight_idx = aux_idx + state_seq[j]*D*m_num_plif_nodes;
 
 				if ( count == 0 )
-					m_emission_weights[weight_idx] += 1;
+					emission_weights[weight_idx] += 1;
 				else if ( count == m_num_plif_nodes )
-					m_emission_weights[weight_idx + m_num_plif_nodes-1] += 1;
+					emission_weights[weight_idx + m_num_plif_nodes-1] += 1;
 				else
 				{
-					m_emission_weights[weight_idx + count] +=
+					emission_weights[weight_idx + count] +=
 						(value-limits[count-1]) / (limits[count]-limits[count-1]);
 
-					m_emission_weights[weight_idx + count-1] +=
+					emission_weights[weight_idx + count-1] +=
 						(limits[count]-value) / (limits[count]-limits[count-1]);
 				}
 
@@ -148,7 +151,7 @@ SGVector< float64_t > CHMSVMModel::get_joint_feature_vector(
 			}
 		}
 
-		m_state_model->weights_to_vector(psi, m_transmission_weights, m_emission_weights,
+		m_state_model->weights_to_vector(psi, transmission_weights, emission_weights,
 				D, m_num_plif_nodes);
 	}
 
@@ -191,10 +194,12 @@ CResultSet* CHMSVMModel::argmax(
 	SGMatrix< float64_t > E(S, T);
 	E.zero();
 
+	SGVector< float64_t > emission_weights;
 	if ( !m_use_plifs )	// Do not use PLiFs
 	{
 		index_t em_idx;
-		m_state_model->reshape_emission_params(m_emission_weights, w, D, m_num_obs);
+		emission_weights = SGVector< float64_t >(S*D*m_num_obs);
+		m_state_model->reshape_emission_params(emission_weights, w, D, m_num_obs);
 
 		for ( int32_t i = 0 ; i < T ; ++i )
 		{
@@ -204,7 +209,7 @@ CResultSet* CHMSVMModel::argmax(
 				em_idx = j*m_num_obs + (index_t)CMath::round(x(j,i));
 
 				for ( int32_t s = 0 ; s < S ; ++s )
-					E(s,i) += m_emission_weights[s*D*m_num_obs + em_idx];
+					E(s,i) += emission_weights[s*D*m_num_obs + em_idx];
 			}
 		}
 	}
@@ -251,7 +256,18 @@ CResultSet* CHMSVMModel::argmax(
 	// Initialize the dynamic programming table and the traceback matrix
 	SGMatrix< float64_t >  dp(T, S);
 	SGMatrix< float64_t > trb(T, S);
-	m_state_model->reshape_transmission_params(m_transmission_weights, w);
+	SGMatrix< float64_t > transmission_weights(S, S);
+	m_state_model->reshape_transmission_params(transmission_weights, w);
+
+	// Keep the weights of the last Viterbi decoding for the getters, the
+	// buffers are replaced instead of written so that concurrent calls
+	// never modify weights in use
+	#pragma omp critical (hmsvm_viterbi_weights)
+	{
+		m_transmission_weights = transmission_weights;
+		if ( !m_use_plifs )
+			m_emission_weights = emission_weights;
+	}
 
 	for ( int32_t s = 0 ; s < S ; ++s )
 	{
@@ -284,8 +300,8 @@ CResultSet* CHMSVMModel::argmax(
 
 			for ( int32_t prev = 0 ; prev < S ; ++prev )
 			{
-				// aij = m_transmission_weights(prev, cur)
-				a = m_transmission_weights[cur*S + prev];
+				// aij = transmission_weights(prev, cur)
+				a = transmission_weights[cur*S + prev];
 
 				if ( a > -CMath::INFTY )
 				{
@@ -530,6 +546,8 @@ void CHMSVMModel::init_training()
 		m_emission_weights = SGVector< float64_t >(S*D*m_num_plif_nodes);
 	else
 		m_emission_weights = SGVector< float64_t >(S*D*m_num_obs);
+	m_transmission_weights.zero();
+	m_emission_weights.zero();
 
 	// Auxiliary variables
 
@@ -593,6 +611,12 @@ void CHMSVMModel::init_training()
 	}
 }
 
+bool CHMSVMModel::is_argmax_thread_safe() const
+{
+	// PLiFs are shared by all the examples and set from w in argmax
+	return !m_use_plifs;
+}
+
 SGMatrix< float64_t > CHMSVMModel::get_transmission_weights() const
 {
 	return m_transmission_weights;
@@ -146,13 +146,23 @@ class CHMSVMModel : public CStructuredModel
 		 */
 		virtual void init_training();
 
-		/** get transmission weights
+		/** argmax and get_joint_feature_vector work on local copies of
+		 * the transmission and emission weights, so they can be called
+		 * concurrently unless PLiFs are used
+		 *
+		 * @return whether argmax can be called concurrently
+		 */
+		virtual bool is_argmax_thread_safe() const;
+
+		/** get transmission weights used in the last Viterbi decoding,
+		 * i.e. by the last call to argmax
 		 *
 		 * @return vector with the transmission weights
 		 */
 		SGMatrix< float64_t > get_transmission_weights() const;
 
-		/** get emission weights
+		/** get emission weights used in the last Viterbi decoding,
+		 * i.e. by the last call to argmax (not set when PLiFs are used)
 		 *
 		 * @return vector with the emission weights
 		 */
@@ -184,10 +194,10 @@ class CHMSVMModel : public CStructuredModel
 		/** the state model */
 		CStateModel* m_state_model;
 
-		/** transition weights used in Viterbi */
+		/** transition weights used in the last Viterbi decoding */
 		SGMatrix< float64_t > m_transmission_weights;
 
-		/** emission weights used in Viterbi */
+		/** emission weights used in the last Viterbi decoding */
 		SGVector< float64_t > m_emission_weights;
 
 		/** number of supporting points for each PLiF */
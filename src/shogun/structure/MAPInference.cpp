@@ -11,6 +11,13 @@
 #include <shogun/structure/MAPInference.h>
 #include <shogun/structure/BeliefPropagation.h>
 #include <shogun/labels/FactorGraphLabels.h>
+#include <shogun/features/FactorGraphFeatures.h>
+#include <shogun/base/init.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/lib/ShogunException.h>
+
+#include <vector>
+#include <string.h>
 
 using namespace shogun;
 
@@ -35,8 +42,7 @@ CMAPInference::CMAPInference(CFactorGraph* fg, EMAPInferType inference_method)
 			m_infer_impl = new CTreeMaxProduct(fg);
 			break;
 		case LOOPY_MAX_PROD:
-			SG_ERROR("%s::CMAPInference(): LoopyMaxProduct has not been implemented!\n",
-				get_name());
+			m_infer_impl = new CLoopyMaxProduct(fg);
 			break;
 		case LP_RELAXATION:
 			SG_ERROR("%s::CMAPInference(): LPRelaxation has not been implemented!\n",
@@ -113,6 +119,91 @@ float64_t CMAPInference::get_energy() const
 	return m_energy;
 }
 
+CFactorGraphLabels* CMAPInference::batch_inference(CFactorGraphFeatures* samples,
+	EMAPInferType inference_method)
+{
+	REQUIRE(samples != NULL, "CMAPInference::batch_inference(): samples cannot be NULL!\n");
+	REQUIRE(inference_method == TREE_MAX_PROD || inference_method == LOOPY_MAX_PROD,
+		"CMAPInference::batch_inference(): unsupported inference method!\n");
+
+	int32_t num_samples = samples->get_num_vectors();
+	std::vector<CFactorGraphObservation*> outputs(num_samples, NULL);
+
+	// errors thrown inside the parallel region would terminate the process,
+	// so check what can be checked beforehand
+	if (inference_method == TREE_MAX_PROD)
+	{
+		for (int32_t i = 0; i < num_samples; i++)
+		{
+			CFactorGraph* fg = samples->get_sample(i);
+			bool is_acyclic = fg->is_acyclic_graph();
+			SG_UNREF(fg);
+
+			REQUIRE(is_acyclic, "CMAPInference::batch_inference(): sample %d "
+				"has cycles, please use LOOPY_MAX_PROD!\n", i);
+		}
+	}
+
+	Parallel* parallel = shogun::get_global_parallel();
+	int32_t num_threads = parallel->get_num_threads();
+	SG_UNREF(parallel);
+
+	// factor graphs don't share any state being modified by inference,
+	// remaining errors are raised again once all threads are done
+	char* error = NULL;
+	#pragma omp parallel for num_threads(num_threads) schedule(dynamic)
+	for (int32_t i = 0; i < num_samples; i++)
+	{
+		// skip the remaining samples once a thread failed
+		bool failed;
+		#pragma omp critical (map_batch_inference_error)
+		failed = error != NULL;
+
+		if (failed)
+			continue;
+
+		try
+		{
+			CFactorGraph* fg = samples->get_sample(i);
+			CMAPInference infer_met(fg, inference_method);
+			SG_UNREF(fg);
+
+			infer_met.inference();
+			outputs[i] = infer_met.get_structured_outputs();
+		}
+		catch (ShogunException& e)
+		{
+			#pragma omp critical (map_batch_inference_error)
+			{
+				if (!error)
+					error = get_strdup(e.get_exception_string());
+			}
+		}
+	}
+
+	if (error)
+	{
+		for (int32_t i = 0; i < num_samples; i++)
+			SG_UNREF(outputs[i]);
+
+		char msg[1024];
+		strncpy(msg, error, sizeof(msg)-1);
+		msg[sizeof(msg)-1] = '\0';
+		SG_FREE(error);
+		SG_SERROR("CMAPInference::batch_inference(): %s", msg);
+	}
+
+	CFactorGraphLabels* labels = new CFactorGraphLabels(num_samples);
+	SG_REF(labels);
+	for (int32_t i = 0; i < num_samples; i++)
+	{
+		labels->add_label(outputs[i]);
+		SG_UNREF(outputs[i]);
+	}
+
+	return labels;
+}
+
 //-----------------------------------------------------------------
 
 CMAPInferImpl::CMAPInferImpl() : CSGObject()
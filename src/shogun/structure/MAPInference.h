@@ -37,6 +37,7 @@ enum EMAPInferType
 };
 
 class CMAPInferImpl;
+class CFactorGraphFeatures;
 
 /** @brief Class CMAPInference performs MAP inference on a factor graph.
  * Briefly, given a factor graph model, with features \f$\bold{x}\f$,
@@ -74,6 +75,15 @@ public:
 	/** @return minimized energy */
 	float64_t get_energy() const;
 
+	/** perform inference on many factor graphs concurrently
+	 *
+	 * @param samples factor graphs, i.e. structured inputs
+	 * @param inference_method name of MAP inference method
+	 * @return structured outputs of all factor graphs
+	 */
+	static CFactorGraphLabels* batch_inference(CFactorGraphFeatures* samples,
+		EMAPInferType inference_method);
+
 private:
 	/** register parameters and initialize members */
 	void init();
@@ -63,6 +63,11 @@ SGVector< float64_t > CMulticlassModel::get_joint_feature_vector(int32_t feat_id
 	return psi;
 }
 
+bool CMulticlassModel::is_argmax_thread_safe() const
+{
+	return true;
+}
+
 CResultSet* CMulticlassModel::argmax(
 		SGVector< float64_t > w,
 		int32_t feat_idx,
@@ -74,7 +79,10 @@ CResultSet* CMulticlassModel::argmax(
 	if ( training )
 	{
 		CMulticlassSOLabels* ml = (CMulticlassSOLabels*) m_labels;
-		m_num_classes = ml->get_num_classes();
+		int32_t num_classes = ml->get_num_classes();
+		// only written once, so that concurrent calls just read it
+		if ( m_num_classes != num_classes )
+			m_num_classes = num_classes;
 	}
 	else
 	{
@@ -77,6 +77,13 @@ class CMulticlassModel : public CStructuredModel
 		 */
 		virtual CResultSet* argmax(SGVector< float64_t > w, int32_t feat_idx, bool const training = true);
 
+		/** argmax only reads the features, labels and w, the number of
+		 * classes is set on the first call in training
+		 *
+		 * @return true
+		 */
+		virtual bool is_argmax_thread_safe() const;
+
 		/** computes \f$ \Delta(y_{1}, y_{2}) \f$
 		 *
 		 * @param y1 an instance of structured data
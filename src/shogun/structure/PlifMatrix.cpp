@@ -12,15 +12,19 @@ CPlifMatrix::CPlifMatrix() : m_PEN(NULL), m_num_plifs(0), m_num_limits(0),
 
 CPlifMatrix::~CPlifMatrix()
 {
-	for (int32_t i=0; i<m_num_plifs; i++)
-		delete m_PEN[i];
-	SG_FREE(m_PEN);
-
+	// single Plifs of a transition are the ones in m_PEN
 	for (int32_t i=0; i<m_num_states*m_num_states; i++)
-		delete m_plif_matrix[i];
+	{
+		if (dynamic_cast<CPlifArray*>(m_plif_matrix[i]))
+			delete m_plif_matrix[i];
+	}
 
 	SG_FREE(m_plif_matrix);
 
+	for (int32_t i=0; i<m_num_plifs; i++)
+		delete m_PEN[i];
+	SG_FREE(m_PEN);
+
 	SG_FREE(m_state_signals);
 }
 
@@ -184,7 +188,10 @@ bool CPlifMatrix::compute_plif_matrix(SGNDArray<float64_t> penalties_array)
 	int32_t num_plifs = get_num_plifs();
 
 	for (int32_t i=0; i<m_num_states*m_num_states; i++)
-		delete  m_plif_matrix[i];
+	{
+		if (dynamic_cast<CPlifArray*>(m_plif_matrix[i]))
+			delete m_plif_matrix[i];
+	}
 	SG_FREE(m_plif_matrix);
 
 	m_num_states = num_states;
@@ -150,6 +150,11 @@ void CStructuredModel::init_training()
 	// Nothing to do here
 }
 
+bool CStructuredModel::is_argmax_thread_safe() const
+{
+	return false;
+}
+
 bool CStructuredModel::check_training_setup() const
 {
 	// Nothing to do here
@@ -192,6 +192,18 @@ class CStructuredModel : public CSGObject
 		 */
 		virtual CResultSet* argmax(SGVector< float64_t > w, int32_t feat_idx, bool const training = true) = 0;
 
+		/** whether argmax (and get_joint_feature_vector) can be called
+		 * concurrently for different examples with the same weight vector,
+		 * once a call with that weight vector has returned. The first call
+		 * may still set up state depending on w (e.g. caches), which the
+		 * following concurrent calls only read. Structured output machines
+		 * split loss-augmented inference among threads only if this holds.
+		 * In this class it returns false.
+		 *
+		 * @return whether argmax can be called concurrently
+		 */
+		virtual bool is_argmax_thread_safe() const;
+
 		/** computes \f$ \Delta(y_{\text{true}}, y_{\text{pred}}) \f$
 		 *
 		 * @param ytrue_idx index of the true label in labels
@@ -80,6 +80,18 @@ protected:
 		/** obtain regularizer (w0) matrix */
 		virtual SGMatrix<float64_t> obtain_regularizer_matrix() const;
 
+		/** get outputs of all submachines one by one, as they are
+		 * combined with the outputs of the source machine
+		 *
+		 * @param outputs array receiving the outputs of every machine
+		 * @param num_machines number of machines
+		 */
+		virtual void get_all_submachine_outputs(CBinaryLabels** outputs,
+				int32_t num_machines)
+		{
+			CMulticlassMachine::get_all_submachine_outputs(outputs, num_machines);
+		}
+
 private:
 
 		/** init defaults */
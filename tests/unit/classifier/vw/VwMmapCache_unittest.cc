@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/classifier/vw/cache/VwMmapCacheWriter.h>
+#include <shogun/classifier/vw/cache/VwMmapCacheReader.h>
+#include <shogun/classifier/vw/VwEnvironment.h>
+#include <shogun/classifier/vw/vw_example.h>
+#include <shogun/mathematics/Math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+const int32_t num_examples=20;
+
+static VwExample* create_example(int32_t i)
+{
+	VwExample* ex=new VwExample();
+	ex->ld->label=CMath::random(-1.0, 1.0) > 0 ? 1 : -1;
+	ex->ld->weight=CMath::random(0.5, 2.0);
+	ex->ld->initial=CMath::random(-1.0, 1.0);
+	ex->sorted=i%2==0;
+
+	// every third example has no tag
+	if (i%3!=0)
+	{
+		char tag[16];
+		int32_t len=snprintf(tag, sizeof(tag), "example%d", i);
+		ex->tag.push_many(tag, len);
+	}
+
+	vw_size_t namespaces[3]={'a', 'b', constant_namespace};
+	for (int32_t n=0; n<3; n++)
+	{
+		// the constant namespace has a single feature, others may be empty
+		int32_t num_feat=namespaces[n]==constant_namespace ? 1 : CMath::random(0, 7);
+		vw_size_t index=namespaces[n];
+		ex->indices.push(index);
+		ex->sum_feat_sq[index]=0;
+		for (int32_t k=0; k<num_feat; k++)
+		{
+			VwFeature f;
+			f.x=CMath::random(-1.0, 1.0);
+			f.weight_index=CMath::random(0, 1<<18);
+			ex->atomics[index].push(f);
+			ex->sum_feat_sq[index]+=f.x*f.x;
+		}
+	}
+
+	return ex;
+}
+
+static void expect_equal_examples(VwExample* expected, VwExample* ex)
+{
+	EXPECT_EQ(expected->ld->label, ex->ld->label);
+	EXPECT_EQ(expected->ld->weight, ex->ld->weight);
+	EXPECT_EQ(expected->ld->initial, ex->ld->initial);
+	EXPECT_EQ(expected->sorted, ex->sorted);
+
+	ASSERT_EQ(expected->tag.index(), ex->tag.index());
+	for (uint32_t i=0; i<expected->tag.index(); i++)
+		EXPECT_EQ(expected->tag[i], ex->tag[i]);
+
+	ASSERT_EQ(expected->indices.index(), ex->indices.index());
+	for (uint32_t i=0; i<expected->indices.index(); i++)
+	{
+		vw_size_t index=expected->indices[i];
+		EXPECT_EQ(index, ex->indices[i]);
+		EXPECT_EQ(expected->sum_feat_sq[index], ex->sum_feat_sq[index]);
+
+		ASSERT_EQ(expected->atomics[index].index(), ex->atomics[index].index());
+		for (uint32_t k=0; k<expected->atomics[index].index(); k++)
+		{
+			EXPECT_EQ(expected->atomics[index][k].x, ex->atomics[index][k].x);
+			EXPECT_EQ(expected->atomics[index][k].weight_index,
+					ex->atomics[index][k].weight_index);
+		}
+	}
+}
+
+// writes the examples to a new cache file and returns its name
+static char* write_cache(CVwEnvironment* env, VwExample** examples, std::string& tmp_name)
+{
+	char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+
+	CVwMmapCacheWriter* writer=new CVwMmapCacheWriter(fname, env);
+	for (int32_t i=0; i<num_examples; i++)
+		writer->cache_example(examples[i]);
+	SG_UNREF(writer);
+
+	return fname;
+}
+
+TEST(VwMmapCache, write_read)
+{
+	CMath::init_random(17);
+	CVwEnvironment* env=new CVwEnvironment();
+	SG_REF(env);
+
+	VwExample* examples[num_examples];
+	for (int32_t i=0; i<num_examples; i++)
+		examples[i]=create_example(i);
+
+	std::string tmp_name="/tmp/VwMmapCache_write_read.XXXXXX";
+	char* fname=write_cache(env, examples, tmp_name);
+
+	CVwMmapCacheReader* reader=new CVwMmapCacheReader(fname, env);
+	SG_REF(reader);
+	VwExample* ex=new VwExample();
+
+	for (int32_t pass=0; pass<2; pass++)
+	{
+		for (int32_t i=0; i<num_examples; i++)
+		{
+			ex->reset_members();
+			ASSERT_TRUE(reader->read_cached_example(ex));
+			expect_equal_examples(examples[i], ex);
+
+			// changes of mapped features must not survive the pass
+			for (vw_size_t* b=ex->indices.begin; b!=ex->indices.end; b++)
+			{
+				for (VwFeature* f=ex->atomics[*b].begin; f!=ex->atomics[*b].end; f++)
+					f->weight_index*=4;
+			}
+		}
+		ex->reset_members();
+		EXPECT_FALSE(reader->read_cached_example(ex));
+
+		// restarts at the first example
+		reader->check_cache_metadata();
+	}
+
+	delete ex;
+	SG_UNREF(reader);
+
+	for (int32_t i=0; i<num_examples; i++)
+		delete examples[i];
+	SG_UNREF(env);
+
+	EXPECT_EQ(0, unlink(fname));
+}
+
+TEST(VwMmapCache, truncated_file)
+{
+	CMath::init_random(17);
+	CVwEnvironment* env=new CVwEnvironment();
+	SG_REF(env);
+
+	VwExample* examples[num_examples];
+	for (int32_t i=0; i<num_examples; i++)
+		examples[i]=create_example(i);
+
+	std::string tmp_name="/tmp/VwMmapCache_truncated_file.XXXXXX";
+	char* fname=write_cache(env, examples, tmp_name);
+
+	struct stat st;
+	ASSERT_EQ(0, stat(fname, &st));
+
+	// cut into the features of the last example
+	ASSERT_EQ(0, truncate(fname, st.st_size-4));
+	CVwMmapCacheReader* reader=new CVwMmapCacheReader(fname, env);
+	SG_REF(reader);
+	VwExample* ex=new VwExample();
+	for (int32_t i=0; i<num_examples-1; i++)
+	{
+		ex->reset_members();
+		ASSERT_TRUE(reader->read_cached_example(ex));
+		expect_equal_examples(examples[i], ex);
+	}
+	ex->reset_members();
+	EXPECT_THROW(reader->read_cached_example(ex), ShogunException);
+	delete ex;
+	SG_UNREF(reader);
+
+	// cut into the header
+	ASSERT_EQ(0, truncate(fname, sizeof(uint32_t)+sizeof(vw_size_t)+2));
+	EXPECT_THROW(new CVwMmapCacheReader(fname, env), ShogunException);
+
+	ASSERT_EQ(0, truncate(fname, 0));
+	EXPECT_THROW(new CVwMmapCacheReader(fname, env), ShogunException);
+
+	for (int32_t i=0; i<num_examples; i++)
+		delete examples[i];
+	SG_UNREF(env);
+
+	EXPECT_EQ(0, unlink(fname));
+}
@@ -0,0 +1,153 @@
+#include <shogun/clustering/GMM.h>
+#include <shogun/distributions/Gaussian.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+#ifdef HAVE_LAPACK
+
+/* num_vectors vectors of each of the two blobs centered at (-offset,0)
+ * and (offset,0) */
+static SGMatrix<float64_t> two_blobs(index_t num_vectors, float64_t offset)
+{
+	SGMatrix<float64_t> data(2, 2*num_vectors);
+	for (index_t i=0; i<2*num_vectors; i++)
+	{
+		data(0, i)=(i<num_vectors ? -offset : offset)+CMath::randn_double();
+		data(1, i)=CMath::randn_double();
+	}
+	return data;
+}
+
+static CGMM* initial_gmm(ECovType cov_type)
+{
+	vector<CGaussian*> components;
+	for (index_t j=0; j<2; j++)
+	{
+		SGVector<float64_t> mean(2);
+		mean[0]=j==0 ? -1 : 1;
+		mean[1]=0.5;
+		SGMatrix<float64_t> cov(2, 2);
+		cov.zero();
+		cov(0, 0)=2;
+		cov(1, 1)=3;
+		components.push_back(new CGaussian(mean, cov, cov_type));
+	}
+	SGVector<float64_t> coefficients(2);
+	coefficients.set_const(0.5);
+
+	return new CGMM(components, coefficients);
+}
+
+TEST(GMM, batched_log_pdf)
+{
+	CMath::init_random(17);
+	SGMatrix<float64_t> points=two_blobs(20, 2);
+
+	SGVector<float64_t> mean(2);
+	mean[0]=0.3;
+	mean[1]=-0.2;
+	SGMatrix<float64_t> cov(2, 2);
+	cov(0, 0)=2;
+	cov(0, 1)=0.5;
+	cov(1, 0)=0.5;
+	cov(1, 1)=1;
+
+	ECovType cov_types[]={FULL, DIAG};
+	for (index_t c=0; c<2; c++)
+	{
+		CGaussian* gaussian=new CGaussian(mean, cov, cov_types[c]);
+		SGVector<float64_t> log_pdfs=gaussian->compute_log_PDF(points);
+
+		for (index_t i=0; i<points.num_cols; i++)
+		{
+			SGVector<float64_t> point(points.get_column_vector(i), 2, false);
+			EXPECT_NEAR(log_pdfs[i], gaussian->compute_log_PDF(point), 1E-12);
+		}
+		SG_UNREF(gaussian);
+	}
+}
+
+TEST(GMM, train_em_multithreaded)
+{
+	CMath::init_random(17);
+	/* more than one block of vectors */
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(two_blobs(300, 3));
+	SG_REF(features);
+
+	ECovType cov_types[]={FULL, DIAG, SPHERICAL};
+	for (index_t c=0; c<3; c++)
+	{
+		CGMM* gmm_single=initial_gmm(cov_types[c]);
+		gmm_single->parallel->set_num_threads(1);
+		gmm_single->train(features);
+		float64_t log_likelihood_single=gmm_single->train_em(1e-9, 50);
+
+		CGMM* gmm_multi=initial_gmm(cov_types[c]);
+		gmm_multi->parallel->set_num_threads(4);
+		gmm_multi->train(features);
+		float64_t log_likelihood_multi=gmm_multi->train_em(1e-9, 50);
+
+		EXPECT_NEAR(log_likelihood_single, log_likelihood_multi, 1E-8);
+		for (index_t j=0; j<2; j++)
+		{
+			SGVector<float64_t> mean_single=gmm_single->get_nth_mean(j);
+			SGVector<float64_t> mean_multi=gmm_multi->get_nth_mean(j);
+			for (index_t k=0; k<2; k++)
+				EXPECT_NEAR(mean_single[k], mean_multi[k], 1E-8);
+
+			SGMatrix<float64_t> cov_single=gmm_single->get_nth_cov(j);
+			SGMatrix<float64_t> cov_multi=gmm_multi->get_nth_cov(j);
+			for (index_t k=0; k<4; k++)
+				EXPECT_NEAR(cov_single[k], cov_multi[k], 1E-8);
+
+			EXPECT_NEAR(gmm_single->get_coef()[j], gmm_multi->get_coef()[j], 1E-8);
+		}
+
+		/* the blobs are found */
+		EXPECT_NEAR(CMath::abs(gmm_multi->get_nth_mean(0)[0]), 3, 0.2);
+		EXPECT_NEAR(gmm_multi->get_coef()[0], 0.5, 0.05);
+
+		SG_UNREF(gmm_single);
+		SG_UNREF(gmm_multi);
+	}
+
+	SG_UNREF(features);
+}
+
+TEST(GMM, train_em_minibatch)
+{
+	CMath::init_random(17);
+	SGMatrix<float64_t> data=two_blobs(500, 3);
+	/* interleave the blobs, batches of consecutive vectors shouldn't be
+	 * drawn from one blob only */
+	SGMatrix<float64_t> shuffled(2, data.num_cols);
+	for (index_t i=0; i<data.num_cols; i++)
+	{
+		index_t j=i%2==0 ? i/2 : data.num_cols/2+i/2;
+		shuffled(0, i)=data(0, j);
+		shuffled(1, i)=data(1, j);
+	}
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(shuffled);
+
+	CGMM* gmm=initial_gmm(FULL);
+	gmm->train(features);
+	gmm->train_em_minibatch(100, 5);
+
+	SGVector<float64_t> left=gmm->get_nth_mean(0);
+	SGVector<float64_t> right=gmm->get_nth_mean(1);
+	EXPECT_NEAR(left[0], -3, 0.2);
+	EXPECT_NEAR(left[1], 0, 0.2);
+	EXPECT_NEAR(right[0], 3, 0.2);
+	EXPECT_NEAR(right[1], 0, 0.2);
+
+	SGMatrix<float64_t> cov=gmm->get_nth_cov(0);
+	EXPECT_NEAR(cov(0, 0), 1, 0.2);
+	EXPECT_NEAR(cov(1, 1), 1, 0.2);
+	EXPECT_NEAR(gmm->get_coef()[0], 0.5, 0.05);
+
+	SG_UNREF(gmm);
+}
+#endif /* HAVE_LAPACK */
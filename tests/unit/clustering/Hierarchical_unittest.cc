@@ -0,0 +1,188 @@
+#include <shogun/clustering/Hierarchical.h>
+#include <shogun/distance/EuclideanDistance.h>
+#include <shogun/distance/ManhattanMetric.h>
+#include <shogun/distance/CustomDistance.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+#include <algorithm>
+
+using namespace shogun;
+
+/* merge distances of agglomerative clustering by definition of the linkage */
+static std::vector<float64_t> naive_merge_distances(SGMatrix<float64_t> data,
+		CDistance* distance, ELinkage linkage)
+{
+	std::vector<std::vector<int32_t> > clusters(data.num_cols);
+	for (int32_t i=0; i<data.num_cols; i++)
+		clusters[i].push_back(i);
+
+	std::vector<float64_t> merge_distances;
+	while (clusters.size()>1)
+	{
+		float64_t best=CMath::INFTY;
+		int32_t best_a=0;
+		int32_t best_b=0;
+		for (int32_t a=0; a<int32_t(clusters.size()); a++)
+		{
+			for (int32_t b=a+1; b<int32_t(clusters.size()); b++)
+			{
+				float64_t d=0;
+				if (linkage==WARD_LINKAGE)
+				{
+					float64_t n_a=clusters[a].size();
+					float64_t n_b=clusters[b].size();
+					for (int32_t k=0; k<data.num_rows; k++)
+					{
+						float64_t c_a=0;
+						float64_t c_b=0;
+						for (int32_t i=0; i<n_a; i++)
+							c_a+=data(k, clusters[a][i])/n_a;
+						for (int32_t i=0; i<n_b; i++)
+							c_b+=data(k, clusters[b][i])/n_b;
+						d+=(c_a-c_b)*(c_a-c_b);
+					}
+					d=CMath::sqrt(2*n_a*n_b/(n_a+n_b)*d);
+				}
+				else
+				{
+					d=linkage==SINGLE_LINKAGE ? CMath::INFTY : 0;
+					for (int32_t i=0; i<int32_t(clusters[a].size()); i++)
+					{
+						for (int32_t j=0; j<int32_t(clusters[b].size()); j++)
+						{
+							float64_t d_ij=distance->distance(clusters[a][i], clusters[b][j]);
+							if (linkage==SINGLE_LINKAGE)
+								d=CMath::min(d, d_ij);
+							else if (linkage==COMPLETE_LINKAGE)
+								d=CMath::max(d, d_ij);
+							else
+								d+=d_ij/(clusters[a].size()*clusters[b].size());
+						}
+					}
+				}
+
+				if (d<best)
+				{
+					best=d;
+					best_a=a;
+					best_b=b;
+				}
+			}
+		}
+
+		merge_distances.push_back(best);
+		clusters[best_a].insert(clusters[best_a].end(), clusters[best_b].begin(), clusters[best_b].end());
+		clusters.erase(clusters.begin()+best_b);
+	}
+
+	std::sort(merge_distances.begin(), merge_distances.end());
+	return merge_distances;
+}
+
+static void check_linkage(ELinkage linkage, bool manhattan, bool custom=false)
+{
+	CMath::init_random(5);
+	SGMatrix<float64_t> data(3, 40);
+	for (index_t i=0; i<data.num_rows*data.num_cols; i++)
+		data[i]=CMath::randn_double();
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CDistance* distance;
+	if (manhattan)
+		distance=new CManhattanMetric(features, features);
+	else
+		distance=new CEuclideanDistance(features, features);
+	SG_REF(distance);
+
+	std::vector<float64_t> expected=naive_merge_distances(data, distance, linkage);
+
+	CDistance* clustering_distance=distance;
+	if (custom)
+		clustering_distance=new CCustomDistance(distance);
+
+	CHierarchical* hierarchical=new CHierarchical(3, clustering_distance, linkage);
+	hierarchical->parallel->set_num_threads(3);
+	hierarchical->train();
+
+	SGMatrix<float64_t> dendrogram=hierarchical->get_dendrogram();
+	ASSERT_EQ(dendrogram.num_cols, data.num_cols-1);
+	for (index_t l=0; l<dendrogram.num_cols; l++)
+		EXPECT_NEAR(dendrogram(2, l), expected[l], custom ? 1E-5 : 1E-10);
+
+	/* the last merge joins everything */
+	EXPECT_EQ(dendrogram(3, data.num_cols-2), data.num_cols);
+
+	SG_UNREF(hierarchical);
+	SG_UNREF(distance);
+}
+
+TEST(Hierarchical, single_linkage)
+{
+	check_linkage(SINGLE_LINKAGE, true);
+}
+
+TEST(Hierarchical, complete_linkage)
+{
+	check_linkage(COMPLETE_LINKAGE, true);
+}
+
+TEST(Hierarchical, average_linkage)
+{
+	check_linkage(AVERAGE_LINKAGE, false);
+}
+
+TEST(Hierarchical, ward_linkage_centroids)
+{
+	check_linkage(WARD_LINKAGE, false);
+}
+
+TEST(Hierarchical, ward_linkage_matrix)
+{
+	check_linkage(WARD_LINKAGE, false, true);
+}
+
+TEST(Hierarchical, assignment)
+{
+	/* two groups of three points */
+	SGMatrix<float64_t> data(1, 6);
+	data[0]=0;
+	data[1]=10;
+	data[2]=1;
+	data[3]=11;
+	data[4]=3;
+	data[5]=12;
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CEuclideanDistance* distance=new CEuclideanDistance(features, features);
+	CHierarchical* hierarchical=new CHierarchical(3, distance);
+	hierarchical->train();
+
+	/* merges (0,2) at 1, (1,3) at 1, (5,7) at 1 and (6,4) at 2 */
+	SGMatrix<float64_t> dendrogram=hierarchical->get_dendrogram();
+	EXPECT_EQ(dendrogram(0, 0), 0);
+	EXPECT_EQ(dendrogram(1, 0), 2);
+	EXPECT_EQ(dendrogram(0, 1), 1);
+	EXPECT_EQ(dendrogram(1, 1), 3);
+	EXPECT_EQ(dendrogram(0, 2), 5);
+	EXPECT_EQ(dendrogram(1, 2), 7);
+	EXPECT_EQ(dendrogram(0, 3), 4);
+	EXPECT_EQ(dendrogram(1, 3), 6);
+	EXPECT_EQ(dendrogram(2, 3), 2);
+	EXPECT_EQ(dendrogram(0, 4), 8);
+	EXPECT_EQ(dendrogram(1, 4), 9);
+	EXPECT_EQ(dendrogram(3, 4), 6);
+
+	/* 4 of the merges are done for 3 clusters */
+	SGVector<int32_t> assignment(hierarchical->get_assignment().vector, 6, false);
+	EXPECT_EQ(assignment[0], 9);
+	EXPECT_EQ(assignment[2], 9);
+	EXPECT_EQ(assignment[4], 9);
+	EXPECT_EQ(assignment[1], 8);
+	EXPECT_EQ(assignment[3], 8);
+	EXPECT_EQ(assignment[5], 8);
+
+	SG_UNREF(hierarchical);
+}
@@ -86,7 +86,7 @@ void check_similarity_of_sets(const std::set<index_t>& first_set, const std::set
  */
 void fill_matrix_with_test_data(SGMatrix<float64_t>& matrix_to_fill);
 
-TEST(IsomapTest,neighbors_preserving)
+static void check_neighbors_preserving(bool approximate_neighbors)
 {
 	const index_t n_samples = 30;
 	const index_t n_dimensions = 3;
@@ -114,6 +114,7 @@ TEST(IsomapTest,neighbors_preserving)
 	CIsomap* isoEmbedder = new CIsomap();
 
 	isoEmbedder->set_k(n_neighbors);
+	isoEmbedder->set_approximate_neighbors(approximate_neighbors);
 
 	isoEmbedder->set_target_dim(n_target_dimensions);
 	EXPECT_EQ(n_target_dimensions, isoEmbedder->get_target_dim());
@@ -138,6 +139,16 @@ TEST(IsomapTest,neighbors_preserving)
 	SG_UNREF(low_dimensional_dist);
 }
 
+TEST(IsomapTest,neighbors_preserving)
+{
+	check_neighbors_preserving(false);
+}
+
+TEST(IsomapTest,neighbors_preserving_approximate)
+{
+	check_neighbors_preserving(true);
+}
+
 std::set<index_t> get_neighbors_indices(CDistance* distance_object, index_t feature_vector_index, index_t n_neighbors)
 {
 	index_t n_vectors = distance_object->get_num_vec_lhs();
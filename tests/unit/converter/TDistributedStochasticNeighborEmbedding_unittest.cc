@@ -1,6 +1,7 @@
 #include <shogun/converter/TDistributedStochasticNeighborEmbedding.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/features/DataGenerator.h>
+#include <shogun/mathematics/Math.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -38,6 +39,114 @@ TEST(TDistributedStochasticNeighborEmbeddingTest,basic)
 	SG_UNREF(high_dimensional_features);
 	SG_UNREF(low_dimensional_features);
 }
+
+/* Checks that t-SNE works with gradient computed in single precision
+ * and stopped early once the gradient norm is small enough */
+TEST(TDistributedStochasticNeighborEmbeddingTest,single_precision)
+{
+	const index_t n_samples = 60;
+	const index_t n_dimensions = 3;
+	const index_t n_target_dimensions = 2;
+	CDenseFeatures<float64_t>* high_dimensional_features =
+		new CDenseFeatures<float64_t>(CDataGenerator::generate_gaussians(n_samples, 1, n_dimensions));
+
+	CTDistributedStochasticNeighborEmbedding* embedder =
+		new CTDistributedStochasticNeighborEmbedding();
+
+	embedder->set_target_dim(n_target_dimensions);
+	embedder->set_perplexity(n_samples / 6.0);
+	embedder->set_single_precision(true);
+	EXPECT_TRUE(embedder->get_single_precision());
+	embedder->set_min_gradient_norm(1e-5);
+	EXPECT_EQ(1e-5, embedder->get_min_gradient_norm());
+
+	CDenseFeatures<float64_t>* low_dimensional_features =
+		embedder->embed(high_dimensional_features);
+
+	EXPECT_EQ(n_target_dimensions,low_dimensional_features->get_dim_feature_space());
+	EXPECT_EQ(high_dimensional_features->get_num_vectors(),low_dimensional_features->get_num_vectors());
+
+	SGMatrix<float64_t> embedding = low_dimensional_features->get_feature_matrix();
+	for (index_t i=0; i<embedding.num_rows*embedding.num_cols; i++)
+		EXPECT_FALSE(CMath::is_nan(embedding.matrix[i]));
+
+	SG_UNREF(embedder);
+	SG_UNREF(high_dimensional_features);
+	SG_UNREF(low_dimensional_features);
+}
+
+/* Embeds well separated clusters and checks that the nearest neighbors
+ * of every point in the embedding belong to its cluster */
+static void check_clusters_preserved(float64_t theta, bool single_precision)
+{
+	const index_t n_clusters = 3;
+	const index_t n_per_cluster = 25;
+	const index_t n_samples = n_clusters*n_per_cluster;
+	const index_t n_dimensions = 5;
+	const index_t n_target_dimensions = 2;
+	const index_t n_neighbors = 5;
+
+	CMath::init_random(17);
+	SGMatrix<float64_t> data(n_dimensions, n_samples);
+	for (index_t i=0; i<n_samples; i++)
+	{
+		for (index_t j=0; j<n_dimensions; j++)
+			data(j,i) = CMath::randn_double() + (j==i/n_per_cluster ? 20.0 : 0.0);
+	}
+	CDenseFeatures<float64_t>* high_dimensional_features =
+		new CDenseFeatures<float64_t>(data);
+
+	CTDistributedStochasticNeighborEmbedding* embedder =
+		new CTDistributedStochasticNeighborEmbedding();
+	embedder->set_target_dim(n_target_dimensions);
+	embedder->set_perplexity(10.0);
+	embedder->set_theta(theta);
+	embedder->set_single_precision(single_precision);
+
+	CDenseFeatures<float64_t>* low_dimensional_features =
+		embedder->embed(high_dimensional_features);
+	SGMatrix<float64_t> embedding = low_dimensional_features->get_feature_matrix();
+	ASSERT_EQ(n_target_dimensions, embedding.num_rows);
+	ASSERT_EQ(n_samples, embedding.num_cols);
+
+	SGVector<float64_t> distances(n_samples);
+	SGVector<index_t> neighbors(n_samples);
+	for (index_t i=0; i<n_samples; i++)
+	{
+		for (index_t k=0; k<n_samples; k++)
+		{
+			distances[k] = 0.0;
+			for (index_t j=0; j<n_target_dimensions; j++)
+				distances[k] += CMath::sq(embedding(j,i)-embedding(j,k));
+			neighbors[k] = k;
+		}
+		CMath::qsort_index(distances.vector, neighbors.vector, n_samples);
+
+		// the first one is the point itself
+		EXPECT_EQ(i, neighbors[0]);
+		for (index_t k=1; k<=n_neighbors; k++)
+			EXPECT_EQ(i/n_per_cluster, neighbors[k]/n_per_cluster);
+	}
+
+	SG_UNREF(embedder);
+	SG_UNREF(high_dimensional_features);
+	SG_UNREF(low_dimensional_features);
+}
+
+TEST(TDistributedStochasticNeighborEmbeddingTest,clusters_preserved_exact)
+{
+	check_clusters_preserved(0.0, false);
+}
+
+TEST(TDistributedStochasticNeighborEmbeddingTest,clusters_preserved_barnes_hut)
+{
+	check_clusters_preserved(0.5, false);
+}
+
+TEST(TDistributedStochasticNeighborEmbeddingTest,clusters_preserved_single_precision)
+{
+	check_clusters_preserved(0.5, true);
+}
 #endif // HAVE_LAPACK
 
 #endif
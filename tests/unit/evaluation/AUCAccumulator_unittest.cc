@@ -0,0 +1,96 @@
+#include <shogun/base/init.h>
+#include <shogun/labels/BinaryLabels.h>
+#include <shogun/evaluation/AUCAccumulator.h>
+#include <shogun/evaluation/ROCEvaluation.h>
+#include <shogun/mathematics/Math.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+TEST(AUCAccumulator,exact_for_binned_outputs)
+{
+	index_t num_labels=1000;
+	CBinaryLabels* gt=new CBinaryLabels(num_labels);
+	CBinaryLabels* pred=new CBinaryLabels(num_labels);
+
+	// outputs on bin centers, so that the bins don't change the ranking
+	CMath::init_random(5);
+	for (index_t i=0; i<num_labels; i++)
+	{
+		float64_t l=CMath::random(0, 3)==0 ? 1 : -1;
+		gt->set_label(i, l);
+		gt->set_value(l, i);
+
+		int32_t bin=CMath::clamp(CMath::random(0, 99)+int32_t(10*l), 0, 99);
+		pred->set_label(i, 1);
+		pred->set_value((bin+0.5)/100, i);
+	}
+
+	CROCEvaluation* roc=new CROCEvaluation();
+	float64_t auc=roc->evaluate(pred, gt);
+
+	CAUCAccumulator* acc=new CAUCAccumulator(0.0, 1.0, 100);
+	acc->parallel->set_num_threads(4);
+	acc->add(pred, gt);
+	EXPECT_NEAR(acc->get_auROC(), auc, 1E-12);
+	EXPECT_EQ(acc->get_num_positives()+acc->get_num_negatives(), num_labels);
+
+	SGMatrix<float64_t> graph=acc->get_ROC();
+	EXPECT_EQ(graph.num_cols, 101);
+	EXPECT_NEAR(CMath::area_under_curve(graph.matrix, graph.num_cols, false),
+			auc, 1E-12);
+
+	SG_UNREF(acc);
+	SG_UNREF(roc);
+	SG_UNREF(pred);
+	SG_UNREF(gt);
+}
+
+TEST(AUCAccumulator,merge)
+{
+	index_t num_labels=500;
+	CBinaryLabels* gt=new CBinaryLabels(num_labels);
+	CBinaryLabels* pred=new CBinaryLabels(num_labels);
+
+	CMath::init_random(7);
+	for (index_t i=0; i<num_labels; i++)
+	{
+		float64_t l=CMath::random(0, 1)==0 ? 1 : -1;
+		gt->set_label(i, l);
+		gt->set_value(l, i);
+		pred->set_label(i, 1);
+		pred->set_value(CMath::randn_double()+l, i);
+	}
+
+	CAUCAccumulator* all=new CAUCAccumulator(-3.0, 3.0, 64);
+	all->add(pred, gt);
+
+	// accumulators of two folds, one of them output by output
+	SGVector<index_t> first(num_labels/2);
+	first.range_fill();
+	pred->add_subset(first);
+	gt->add_subset(first);
+	CAUCAccumulator* fold=new CAUCAccumulator(-3.0, 3.0, 64);
+	fold->add(pred, gt);
+	pred->remove_subset();
+	gt->remove_subset();
+
+	CAUCAccumulator* stream=new CAUCAccumulator(-3.0, 3.0, 64);
+	for (index_t i=num_labels/2; i<num_labels; i++)
+		stream->add(pred->get_value(i), gt->get_label(i)>0);
+
+	fold->merge(stream);
+	EXPECT_EQ(fold->get_num_positives(), all->get_num_positives());
+	EXPECT_EQ(fold->get_auROC(), all->get_auROC());
+	EXPECT_EQ(fold->get_auPRC(), all->get_auPRC());
+
+	CAUCAccumulator* other_bins=new CAUCAccumulator(-3.0, 3.0, 32);
+	EXPECT_THROW(fold->merge(other_bins), ShogunException);
+
+	SG_UNREF(other_bins);
+	SG_UNREF(stream);
+	SG_UNREF(fold);
+	SG_UNREF(all);
+	SG_UNREF(pred);
+	SG_UNREF(gt);
+}
@@ -11,10 +11,44 @@
 #include <shogun/base/init.h>
 #include <shogun/labels/BinaryLabels.h>
 #include <shogun/evaluation/ROCEvaluation.h>
+#include <shogun/evaluation/PRCEvaluation.h>
+#include <shogun/mathematics/Math.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
 
+/* auROC is the probability that a positive example is ranked higher than a
+ * negative one, ties counted half */
+static float64_t pairwise_auc(CBinaryLabels* pred, CBinaryLabels* gt)
+{
+	SGVector<float64_t> values=pred->get_values();
+	SGVector<float64_t> positive_values(values.vlen);
+	SGVector<float64_t> negative_values(values.vlen);
+	index_t num_positive=0;
+	index_t num_negative=0;
+	for (index_t i=0; i<values.vlen; i++)
+	{
+		if (gt->get_label(i)>0)
+			positive_values[num_positive++]=values[i];
+		else
+			negative_values[num_negative++]=values[i];
+	}
+
+	float64_t pairs=0;
+	for (index_t i=0; i<num_positive; i++)
+	{
+		for (index_t j=0; j<num_negative; j++)
+		{
+			if (positive_values[i]>negative_values[j])
+				pairs+=1.0;
+			else if (positive_values[i]==negative_values[j])
+				pairs+=0.5;
+		}
+	}
+
+	return pairs/(float64_t(num_positive)*num_negative);
+}
+
 TEST(ROCEvaluation,one)
 {
 	index_t num_labels=10;
@@ -34,3 +68,114 @@ TEST(ROCEvaluation,one)
 	SG_UNREF(roc);
 	SG_UNREF(gt);
 }
+
+TEST(ROCEvaluation,ties_and_curve_points)
+{
+	index_t num_labels=2000;
+	CBinaryLabels* gt=new CBinaryLabels(num_labels);
+	CBinaryLabels* pred=new CBinaryLabels(num_labels);
+
+	CMath::init_random(17);
+	for (index_t i=0; i<num_labels; i++)
+	{
+		float64_t l=CMath::random(0, 2)==0 ? -1 : 1;
+		gt->set_label(i, l);
+		gt->set_value(l, i);
+
+		// few different outputs, so that there are many ties
+		float64_t value=CMath::random(-20, 20)/10.0+0.5*l;
+		pred->set_label(i, value>=0 ? 1 : -1);
+		pred->set_value(value, i);
+	}
+
+	CROCEvaluation* roc=new CROCEvaluation();
+	roc->parallel->set_num_threads(3);
+	float64_t auc=roc->evaluate(pred, gt);
+	EXPECT_NEAR(auc, pairwise_auc(pred, gt), 1E-12);
+
+	SGMatrix<float64_t> full=roc->get_ROC();
+	EXPECT_EQ(roc->get_thresholds().vlen, num_labels);
+	EXPECT_EQ(full(0, 0), 0);
+	EXPECT_EQ(full(1, 0), 0);
+	EXPECT_EQ(full(0, full.num_cols-1), 1);
+	EXPECT_EQ(full(1, full.num_cols-1), 1);
+	EXPECT_NEAR(CMath::area_under_curve(full.matrix, full.num_cols, false), auc,
+			1E-12);
+
+	// downsampled graph consists of points of the full graph
+	roc->set_num_curve_points(10);
+	EXPECT_EQ(roc->evaluate(pred, gt), auc);
+	SGMatrix<float64_t> graph=roc->get_ROC();
+	SGVector<float64_t> thresholds=roc->get_thresholds();
+	EXPECT_EQ(graph.num_cols, 10);
+	EXPECT_EQ(thresholds.vlen, 10);
+	EXPECT_EQ(graph(0, 0), 0);
+	EXPECT_EQ(graph(0, 9), 1);
+	EXPECT_EQ(graph(1, 9), 1);
+	for (index_t i=1; i<graph.num_cols; i++)
+	{
+		EXPECT_GE(graph(0, i), graph(0, i-1));
+		EXPECT_GE(graph(1, i), graph(1, i-1));
+	}
+	for (index_t i=1; i<thresholds.vlen-1; i++)
+		EXPECT_LT(thresholds[i], thresholds[i-1]);
+
+	CPRCEvaluation* prc=new CPRCEvaluation();
+	float64_t auprc=prc->evaluate(pred, gt);
+	prc->set_num_curve_points(5);
+	EXPECT_EQ(prc->evaluate(pred, gt), auprc);
+	EXPECT_EQ(prc->get_PRC().num_cols, 5);
+	EXPECT_EQ(prc->get_PRC()(1, 4), 1);
+
+	SG_UNREF(prc);
+	SG_UNREF(roc);
+	SG_UNREF(pred);
+	SG_UNREF(gt);
+}
+
+/* more than 4*2048 outputs per thread, so that the outputs are sorted by
+ * several threads */
+TEST(ROCEvaluation,parallel_sort)
+{
+	index_t num_labels=25000;
+	CBinaryLabels* gt=new CBinaryLabels(num_labels);
+	CBinaryLabels* pred=new CBinaryLabels(num_labels);
+
+	CMath::init_random(17);
+	for (index_t i=0; i<num_labels; i++)
+	{
+		float64_t l=CMath::random(0, 2)==0 ? -1 : 1;
+		gt->set_label(i, l);
+		gt->set_value(l, i);
+
+		// negative and positive outputs, every other one with many ties
+		float64_t value=CMath::randn_double()+0.5*l;
+		if (i%2==0)
+			value=CMath::round(value*10)/10;
+		pred->set_label(i, value>=0 ? 1 : -1);
+		pred->set_value(value, i);
+	}
+
+	CROCEvaluation* roc=new CROCEvaluation();
+	roc->parallel->set_num_threads(1);
+	float64_t serial_auc=roc->evaluate(pred, gt);
+	SGMatrix<float64_t> serial_graph=roc->get_ROC();
+
+	roc->parallel->set_num_threads(3);
+	float64_t auc=roc->evaluate(pred, gt);
+	EXPECT_NEAR(auc, pairwise_auc(pred, gt), 1E-12);
+	EXPECT_EQ(auc, serial_auc);
+
+	SGMatrix<float64_t> graph=roc->get_ROC();
+	ASSERT_EQ(graph.num_cols, serial_graph.num_cols);
+	for (index_t i=0; i<graph.num_rows*graph.num_cols; i++)
+		EXPECT_EQ(graph.matrix[i], serial_graph.matrix[i]);
+
+	SGVector<float64_t> thresholds=roc->get_thresholds();
+	for (index_t i=1; i<thresholds.vlen; i++)
+		EXPECT_LE(thresholds[i], thresholds[i-1]);
+
+	SG_UNREF(roc);
+	SG_UNREF(pred);
+	SG_UNREF(gt);
+}
@@ -55,3 +55,48 @@ TEST(DenseFeaturesTest,create_merged_copy)
 	SG_UNREF(features_1);
 	SG_UNREF(features_2);
 }
+
+TEST(DenseFeaturesTest,add_to_dense_vec_subset)
+{
+	index_t dim=5;
+	index_t n=101;
+
+	SGMatrix<float64_t> data(dim,n);
+	for (index_t i=0; i<dim*n; ++i)
+		data.matrix[i]=CMath::randn_double();
+
+	SGVector<float64_t> alphas(n);
+	for (index_t i=0; i<n; ++i)
+		alphas[i]=CMath::randn_double();
+
+	SGVector<int32_t> sub_index(n/2);
+	for (index_t i=0; i<sub_index.vlen; ++i)
+		sub_index[i]=2*i+1;
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+
+	SGVector<float64_t> expected(dim);
+	expected.zero();
+	for (index_t i=0; i<sub_index.vlen; ++i)
+	{
+		for (index_t j=0; j<dim; ++j)
+			expected[j]+=alphas[sub_index[i]]*data(j, sub_index[i]);
+	}
+
+	int32_t num_threads=features->parallel->get_num_threads();
+	for (int32_t t=1; t<=4; ++t)
+	{
+		features->parallel->set_num_threads(t);
+
+		SGVector<float64_t> result(dim);
+		result.set_const(1.0);
+		features->add_to_dense_vec_subset(sub_index.vector, sub_index.vlen,
+				alphas.vector, result.vector, dim);
+
+		for (index_t j=0; j<dim; ++j)
+			EXPECT_NEAR(result[j], expected[j]+1.0, 1e-12);
+	}
+	features->parallel->set_num_threads(num_threads);
+
+	SG_UNREF(features);
+}
@@ -307,3 +307,82 @@ TEST(HashedDocDotFeaturesTest, quadratic_add_to_dense)
 	SG_UNREF(hddf);
 	SG_FREE(hashes);
 }
+
+TEST(HashedDocDotFeaturesTest, precomputed_hashes)
+{
+	int32_t num_docs = 50;
+	int32_t hash_bits = 8;
+	int32_t dimension = 256;
+
+	SGStringList<char> list(num_docs, 200);
+	for (index_t i=0; i<num_docs; i++)
+	{
+		int32_t len = CMath::random(1, 200);
+		list.strings[i] = SGString<char>(len);
+		for (index_t j=0; j<len; j++)
+			list.strings[i].string[j] = CMath::random(0, 3)==0 ? ' ' : (char) CMath::random('a', 'e');
+	}
+
+	CNGramTokenizer* tokenizer = new CNGramTokenizer(3);
+	CStringFeatures<char>* doc_collection = new CStringFeatures<char>(list, RAWBYTE);
+	CHashedDocDotFeatures* hddf = new CHashedDocDotFeatures(hash_bits, doc_collection,
+			tokenizer, true, 3, 1);
+
+	SGVector<float64_t> vec(dimension);
+	for (index_t i=0; i<dimension; i++)
+		vec[i] = CMath::random(-1.0, 1.0);
+
+	SGVector<float64_t> dots(num_docs);
+	SGVector<float64_t> sum(dimension);
+	sum.zero();
+	for (index_t i=0; i<num_docs; i++)
+	{
+		dots[i] = hddf->dense_dot(i, vec.vector, dimension);
+		hddf->add_to_dense_vec(i+1, i, sum.vector, dimension);
+	}
+
+	/* the representation is charged to the counter without a pool allocator */
+	SGMemoryCounter* counter = CHashedDocDotFeatures::get_memory_counter();
+	int64_t counted_bytes = counter->get_bytes();
+
+	hddf->parallel->set_num_threads(3);
+	hddf->precompute_hashes();
+	EXPECT_TRUE(hddf->has_precomputed_hashes());
+	EXPECT_GT(hddf->get_precomputed_bytes(), 0);
+	EXPECT_EQ(counter->get_bytes(), counted_bytes+hddf->get_precomputed_bytes());
+
+	SGVector<float64_t> precomputed_sum(dimension);
+	precomputed_sum.zero();
+	for (index_t i=0; i<num_docs; i++)
+	{
+		EXPECT_EQ(hddf->dense_dot(i, vec.vector, dimension), dots[i]);
+		hddf->add_to_dense_vec(i+1, i, precomputed_sum.vector, dimension);
+	}
+	for (index_t i=0; i<dimension; i++)
+		EXPECT_EQ(precomputed_sum[i], sum[i]);
+
+	/* copies keep the representation */
+	CHashedDocDotFeatures* copy = (CHashedDocDotFeatures*) hddf->duplicate();
+	EXPECT_TRUE(copy->has_precomputed_hashes());
+	EXPECT_EQ(copy->get_precomputed_bytes(), hddf->get_precomputed_bytes());
+	EXPECT_EQ(copy->dense_dot(num_docs-1, vec.vector, dimension), dots[num_docs-1]);
+	EXPECT_EQ(counter->get_bytes(), counted_bytes+2*hddf->get_precomputed_bytes());
+	SG_UNREF(copy);
+	EXPECT_EQ(counter->get_bytes(), counted_bytes+hddf->get_precomputed_bytes());
+
+	hddf->free_precomputed_hashes();
+	EXPECT_FALSE(hddf->has_precomputed_hashes());
+	EXPECT_EQ(hddf->get_precomputed_bytes(), 0);
+	EXPECT_EQ(counter->get_bytes(), counted_bytes);
+	EXPECT_EQ(hddf->dense_dot(0, vec.vector, dimension), dots[0]);
+
+	/* precomputing fails if the counter's limit would be exceeded */
+	counter->set_limit(counted_bytes+1);
+	EXPECT_THROW(hddf->precompute_hashes(), ShogunException);
+	EXPECT_FALSE(hddf->has_precomputed_hashes());
+	EXPECT_EQ(counter->get_bytes(), counted_bytes);
+	EXPECT_EQ(hddf->dense_dot(0, vec.vector, dimension), dots[0]);
+	counter->set_limit(0);
+
+	SG_UNREF(hddf);
+}
@@ -12,6 +12,7 @@
 #include <shogun/lib/SGStringList.h>
 #include <shogun/lib/DelimiterTokenizer.h>
 #include <shogun/converter/HashedDocConverter.h>
+#include <shogun/mathematics/Math.h>
 
 #include <gtest/gtest.h>
 
@@ -157,3 +158,91 @@ TEST(StreamingHashedDocFeaturesTest, dot_tests)
 	SG_UNREF(doc_collection);
 	SG_UNREF(converter);
 }
+
+TEST(StreamingHashedDocFeaturesTest, batch_hashing)
+{
+	int32_t num_docs = 100;
+	SGStringList<char> list(num_docs, 100);
+	for (index_t i=0; i<num_docs; i++)
+	{
+		int32_t len = CMath::random(1, 100);
+		list.strings[i] = SGString<char>(len);
+		for (index_t j=0; j<len; j++)
+			list.strings[i].string[j] = CMath::random(0, 3)==0 ? ' ' : (char) CMath::random('a', 'e');
+	}
+
+	CDelimiterTokenizer* tokenizer = new CDelimiterTokenizer();
+	tokenizer->delimiters[' '] = 1;
+
+	CHashedDocConverter* converter = new CHashedDocConverter(tokenizer, 6, true);
+	CStringFeatures<char>* doc_collection = new CStringFeatures<char>(list, RAWBYTE);
+	CStreamingHashedDocDotFeatures* feats = new CStreamingHashedDocDotFeatures(doc_collection,
+			tokenizer, 6);
+	feats->parallel->set_num_threads(4);
+	feats->set_hashing_batch_size(16);
+	EXPECT_EQ(feats->get_hashing_batch_size(), 16);
+
+	index_t i = 0;
+	feats->start_parser();
+	while (feats->get_next_example())
+	{
+		SGSparseVector<float64_t> example = feats->get_vector();
+
+		SGVector<char> tmp(list.strings[i].string, list.strings[i].slen, false);
+		SGSparseVector<float64_t> converted_doc = converter->apply(tmp);
+
+		ASSERT_EQ(example.num_feat_entries, converted_doc.num_feat_entries);
+		for (index_t j=0; j<example.num_feat_entries; j++)
+		{
+			EXPECT_EQ(example.features[j].feat_index, converted_doc.features[j].feat_index);
+			EXPECT_EQ(example.features[j].entry, converted_doc.features[j].entry);
+		}
+		feats->release_example();
+		i++;
+	}
+	feats->end_parser();
+	EXPECT_EQ(i, num_docs);
+
+	SG_UNREF(feats);
+	SG_UNREF(doc_collection);
+	SG_UNREF(converter);
+}
+
+TEST(StreamingHashedDocFeaturesTest, batch_size_from_parameter)
+{
+	int32_t num_docs = 20;
+	SGStringList<char> list(num_docs, 10);
+	for (index_t i=0; i<num_docs; i++)
+	{
+		list.strings[i] = SGString<char>(10);
+		for (index_t j=0; j<10; j++)
+			list.strings[i].string[j] = j%3==0 ? ' ' : (char) ('a'+(i+j)%5);
+	}
+
+	CDelimiterTokenizer* tokenizer = new CDelimiterTokenizer();
+	tokenizer->delimiters[' '] = 1;
+
+	CStringFeatures<char>* doc_collection = new CStringFeatures<char>(list, RAWBYTE);
+	CStreamingHashedDocDotFeatures* feats = new CStreamingHashedDocDotFeatures(doc_collection,
+			tokenizer, 6);
+
+	/* as done when the features are loaded, bypassing the setter */
+	TParameter* param = feats->m_parameters->get_parameter("hashing_batch_size");
+	ASSERT_TRUE(param!=NULL);
+	*(int32_t*) param->m_parameter = 8;
+	EXPECT_EQ(feats->get_hashing_batch_size(), 8);
+
+	index_t i = 0;
+	feats->start_parser();
+	while (feats->get_next_example())
+	{
+		EXPECT_GT(feats->get_vector().num_feat_entries, 0);
+		feats->release_example();
+		i++;
+	}
+	feats->end_parser();
+	EXPECT_EQ(i, num_docs);
+
+	SG_UNREF(feats);
+	SG_UNREF(doc_collection);
+}
@@ -0,0 +1,179 @@
+#include <shogun/io/LineChunks.h>
+#include <shogun/io/CSVFile.h>
+#include <shogun/io/LibSVMFile.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseVector.h>
+#include <shogun/mathematics/Math.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+static float64_t parse_real(const char* str)
+{
+	float64_t value=0;
+	const char* end=SGLineChunks::parse(str, str+strlen(str), value);
+	EXPECT_EQ(end, str+strlen(str));
+	return value;
+}
+
+TEST(LineChunksTest, parse_real_as_strtod)
+{
+	const char* numbers[]={"0", "-0", "1", "-17", "3.25", "+2.5e3", ".5",
+		"1.", "1e-5", "6.02214076e23", "1.7976931348623157e308",
+		"4.9e-324", "0.1234567890123456789", "123456789012345678901234",
+		"2.2250738585072014e-308", "9007199254740993", "nan", "-inf"};
+
+	for (int32_t i=0; i<18; i++)
+	{
+		float64_t value=parse_real(numbers[i]);
+		float64_t expected=strtod(numbers[i], NULL);
+		if (CMath::is_nan(expected))
+			EXPECT_TRUE(CMath::is_nan(value));
+		else
+			EXPECT_EQ(value, expected) << numbers[i];
+	}
+
+	/* the shortest representation of random doubles round trips */
+	CMath::init_random(3);
+	char buf[64];
+	for (int32_t i=0; i<10000; i++)
+	{
+		float64_t x=CMath::randn_double()*CMath::pow(10.0, CMath::random(-30, 30));
+		snprintf(buf, sizeof(buf), "%.*g", CMath::random(1, 17), x);
+		EXPECT_EQ(parse_real(buf), strtod(buf, NULL)) << buf;
+	}
+}
+
+TEST(LineChunksTest, parse_stops_at_delimiter)
+{
+	const char* str="12:3.5e2,7";
+	int32_t index=0;
+	const char* p=SGLineChunks::parse(str, str+strlen(str), index);
+	EXPECT_EQ(index, 12);
+	EXPECT_EQ(*p, ':');
+
+	float64_t value=0;
+	p=SGLineChunks::parse(p+1, str+strlen(str), value);
+	EXPECT_EQ(value, 350);
+	EXPECT_EQ(*p, ',');
+
+	/* the range needn't be terminated */
+	int64_t big=0;
+	p=SGLineChunks::parse(str, str+1, big);
+	EXPECT_EQ(big, 1);
+	EXPECT_EQ(p, str+1);
+
+	const char* huge="-9223372036854775807";
+	SGLineChunks::parse(huge, huge+strlen(huge), big);
+	EXPECT_EQ(big, -9223372036854775807LL);
+}
+
+TEST(LineChunksTest, split_lines)
+{
+	const char* fname="LineChunksTest_split_lines.txt";
+	FILE* f=fopen(fname, "w");
+	fprintf(f, "header\r\n\n");
+	for (int32_t i=0; i<1000; i++)
+		fprintf(f, "%d\r\n%s", i, i%7==0 ? "\n" : "");
+	fclose(f);
+
+	f=fopen(fname, "r");
+	SGLineChunks chunks(f);
+	chunks.skip_lines(1);
+	chunks.split(7);
+
+	int32_t expected=0;
+	for (int32_t c=0; c<chunks.get_num_chunks(); c++)
+	{
+		const char* line=chunks.get_begin(c);
+		const char* line_end;
+		while ((line_end=SGLineChunks::next_line(line, chunks.get_end(c))))
+		{
+			int32_t value=-1;
+			EXPECT_EQ(SGLineChunks::parse(line, line_end, value), line_end);
+			EXPECT_EQ(value, expected++);
+			line=line_end;
+		}
+	}
+	EXPECT_EQ(expected, 1000);
+
+	fclose(f);
+	unlink(fname);
+}
+
+TEST(LineChunksTest, csv_matrix_multithreaded)
+{
+	const char* fname="LineChunksTest_csv_matrix.txt";
+	SGMatrix<float64_t> data(3, 500);
+	for (index_t i=0; i<data.num_rows*data.num_cols; i++)
+		data[i]=CMath::randn_double();
+
+	CCSVFile* fout=new CCSVFile(fname, 'w', NULL);
+	fout->set_matrix(data.matrix, data.num_rows, data.num_cols);
+	SG_UNREF(fout);
+
+	CCSVFile* fin=new CCSVFile(fname, 'r', NULL);
+	fin->parallel->set_num_threads(4);
+	SGMatrix<float64_t> data_from_file(true);
+	fin->get_matrix(data_from_file.matrix, data_from_file.num_rows, data_from_file.num_cols);
+	SG_UNREF(fin);
+
+	ASSERT_EQ(data_from_file.num_rows, data.num_rows);
+	ASSERT_EQ(data_from_file.num_cols, data.num_cols);
+	for (index_t i=0; i<data.num_rows*data.num_cols; i++)
+		EXPECT_NEAR(data_from_file[i], data[i], 1E-15*CMath::abs(data[i]));
+
+	/* transposed data has one vector per column */
+	fin=new CCSVFile(fname, 'r', NULL);
+	fin->parallel->set_num_threads(4);
+	fin->set_transpose(true);
+	SGMatrix<float64_t> transposed(true);
+	fin->get_matrix(transposed.matrix, transposed.num_rows, transposed.num_cols);
+	SG_UNREF(fin);
+
+	ASSERT_EQ(transposed.num_rows, data.num_cols);
+	ASSERT_EQ(transposed.num_cols, data.num_rows);
+	for (index_t i=0; i<data.num_rows; i++)
+	{
+		for (index_t j=0; j<data.num_cols; j++)
+			EXPECT_EQ(transposed(j, i), data_from_file(i, j));
+	}
+
+	unlink(fname);
+}
+
+TEST(LineChunksTest, libsvm_without_labels)
+{
+	const char* fname="LineChunksTest_libsvm.txt";
+	FILE* f=fopen(fname, "w");
+	fprintf(f, "1 3:0.5 10:2\r\n-1\t1:1e-3\n\n+1 2:7\n");
+	fclose(f);
+
+	CLibSVMFile* fin=new CLibSVMFile(fname, 'r', NULL);
+	fin->parallel->set_num_threads(3);
+	SGSparseVector<float64_t>* matrix=NULL;
+	int32_t num_feat=0;
+	int32_t num_vec=0;
+	float64_t* labels=NULL;
+	fin->get_sparse_matrix(matrix, num_feat, num_vec, labels, false);
+	SG_UNREF(fin);
+
+	EXPECT_EQ(num_vec, 3);
+	EXPECT_EQ(num_feat, 10);
+	EXPECT_EQ(matrix[0].num_feat_entries, 2);
+	EXPECT_EQ(matrix[0].features[1].feat_index, 9);
+	EXPECT_EQ(matrix[0].features[1].entry, 2);
+	EXPECT_EQ(matrix[1].num_feat_entries, 1);
+	EXPECT_EQ(matrix[1].features[0].feat_index, 0);
+	EXPECT_EQ(matrix[1].features[0].entry, 1e-3);
+	EXPECT_EQ(matrix[2].features[0].entry, 7);
+
+	SG_FREE(matrix);
+	unlink(fname);
+}
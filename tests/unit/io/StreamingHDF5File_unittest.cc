@@ -0,0 +1,236 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_HDF5
+#include <shogun/io/HDF5File.h>
+#include <shogun/io/streaming/StreamingHDF5File.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+#include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/mathematics/Random.h>
+
+using namespace shogun;
+
+// reads its chunks synchronously, as for a library that is not thread-safe
+template <class T> class CSynchronousHDF5File: public CStreamingHDF5File<T>
+{
+public:
+	CSynchronousHDF5File(const char* fname, const char* name,
+			const char* label_name, int32_t chunk_size)
+		: CStreamingHDF5File<T>(fname, name, label_name, chunk_size)
+	{
+		this->stop_read_ahead();
+		this->set_read_in_background(false);
+		this->reset_stream();
+	}
+};
+
+TEST(StreamingHDF5FileTest, dense_matrix_with_labels)
+{
+	std::string tmp_name="/tmp/StreamingHDF5File_dense.XXXXXX";
+	char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+
+	int32_t num_feat=7;
+	int32_t num_vec=53;
+	CRandom* rand=new CRandom();
+	SGMatrix<float64_t> data(num_feat, num_vec);
+	SGVector<float64_t> labels(num_vec);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		labels[i]=rand->random(-1, 1);
+		for (int32_t j=0; j<num_feat; j++)
+			data(j,i)=rand->random(0., 1.);
+	}
+	SG_UNREF(rand);
+
+	CHDF5File* fout=new CHDF5File(fname, 'w', "x");
+	fout->set_matrix(data.matrix, num_feat, num_vec);
+	fout->set_variable_name("y");
+	fout->set_vector(labels.vector, num_vec);
+	SG_UNREF(fout);
+
+	// chunks of 8 vectors, the last chunk is incomplete
+	CStreamingHDF5File<float64_t>* file=
+		new CStreamingHDF5File<float64_t>(fname, "x", "y", 8);
+	EXPECT_EQ(file->get_num_vectors(), num_vec);
+	EXPECT_FALSE(file->is_sparse());
+
+	CStreamingDenseFeatures<float64_t>* stream_features=
+		new CStreamingDenseFeatures<float64_t>(file, true, 4);
+
+	stream_features->start_parser();
+	int32_t i=0;
+	while (stream_features->get_next_example())
+	{
+		SGVector<float64_t> v=stream_features->get_vector();
+		EXPECT_EQ(v.vlen, num_feat);
+		for (int32_t j=0; j<num_feat; j++)
+			EXPECT_EQ(v[j], data(j,i));
+		EXPECT_EQ(stream_features->get_label(), labels[i]);
+
+		stream_features->release_example();
+		i++;
+	}
+	stream_features->end_parser();
+	EXPECT_EQ(i, num_vec);
+
+	SG_UNREF(stream_features);
+	EXPECT_EQ(unlink(fname), 0);
+}
+
+TEST(StreamingHDF5FileTest, sparse_matrix)
+{
+	std::string tmp_name="/tmp/StreamingHDF5File_sparse.XXXXXX";
+	char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+
+	int32_t num_vec=30;
+	int32_t max_num_entries=20;
+	CRandom* rand=new CRandom();
+	SGVector<int64_t> indptr(num_vec+1);
+	indptr[0]=0;
+	for (int32_t i=0; i<num_vec; i++)
+		indptr[i+1]=indptr[i]+rand->random(0, max_num_entries);
+
+	SGVector<int32_t> indices(indptr[num_vec]);
+	SGVector<float32_t> entries(indptr[num_vec]);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		for (int64_t k=indptr[i]; k<indptr[i+1]; k++)
+		{
+			indices[k]=2*(k-indptr[i])+1;
+			entries[k]=rand->random(0., 1.);
+		}
+	}
+	SG_UNREF(rand);
+
+	CHDF5File* fout=new CHDF5File(fname, 'w', "x/indptr");
+	fout->set_vector(indptr.vector, indptr.vlen);
+	fout->set_variable_name("x/indices");
+	fout->set_vector(indices.vector, indices.vlen);
+	fout->set_variable_name("x/data");
+	fout->set_vector(entries.vector, entries.vlen);
+	SG_UNREF(fout);
+
+	CStreamingHDF5File<float32_t>* file=
+		new CStreamingHDF5File<float32_t>(fname, "x", NULL, 4);
+	EXPECT_EQ(file->get_num_vectors(), num_vec);
+	EXPECT_TRUE(file->is_sparse());
+
+	CStreamingSparseFeatures<float32_t>* stream_features=
+		new CStreamingSparseFeatures<float32_t>(file, false, 4);
+
+	stream_features->start_parser();
+	int32_t i=0;
+	while (stream_features->get_next_example())
+	{
+		SGSparseVector<float32_t> v=stream_features->get_vector();
+		EXPECT_EQ(v.num_feat_entries, indptr[i+1]-indptr[i]);
+		for (int32_t j=0; j<v.num_feat_entries; j++)
+		{
+			EXPECT_EQ(v.features[j].feat_index, indices[indptr[i]+j]);
+			EXPECT_EQ(v.features[j].entry, entries[indptr[i]+j]);
+		}
+
+		stream_features->release_example();
+		i++;
+	}
+	stream_features->end_parser();
+	EXPECT_EQ(i, num_vec);
+
+	SG_UNREF(stream_features);
+	EXPECT_EQ(unlink(fname), 0);
+}
+
+static void read_and_reset(bool background)
+{
+	std::string tmp_name="/tmp/StreamingHDF5File_reset.XXXXXX";
+	char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+
+	int32_t num_feat=3;
+	int32_t num_vec=10;
+	SGMatrix<int32_t> data(num_feat, num_vec);
+	for (int32_t i=0; i<num_feat*num_vec; i++)
+		data.matrix[i]=i;
+
+	CHDF5File* fout=new CHDF5File(fname, 'w', "x");
+	fout->set_matrix(data.matrix, num_feat, num_vec);
+	SG_UNREF(fout);
+
+	CStreamingHDF5File<float64_t>* file=NULL;
+	if (background)
+		file=new CStreamingHDF5File<float64_t>(fname, "x", NULL, 3);
+	else
+		file=new CSynchronousHDF5File<float64_t>(fname, "x", NULL, 3);
+	SG_REF(file);
+	EXPECT_TRUE(file->is_seekable());
+
+	float64_t* vector=NULL;
+	int32_t len=0;
+	for (int32_t pass=0; pass<2; pass++)
+	{
+		for (int32_t i=0; i<num_vec; i++)
+		{
+			file->get_vector(vector, len);
+			EXPECT_EQ(len, num_feat);
+			for (int32_t j=0; j<num_feat; j++)
+				EXPECT_EQ(vector[j], data(j,i));
+		}
+		float64_t* last=vector;
+		file->get_vector(vector, len);
+		EXPECT_EQ(len, -1);
+		EXPECT_EQ(vector, (float64_t*) NULL);
+		SG_FREE(last);
+
+		file->reset_stream();
+	}
+
+	SG_UNREF(file);
+	EXPECT_EQ(unlink(fname), 0);
+}
+TEST(StreamingHDF5FileTest, reset_stream)
+{
+	read_and_reset(true);
+}
+
+TEST(StreamingHDF5FileTest, reset_stream_synchronous)
+{
+	read_and_reset(false);
+}
+
+TEST(StreamingHDF5FileTest, errors_close_handles)
+{
+	std::string tmp_name="/tmp/StreamingHDF5File_errors.XXXXXX";
+	char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+
+	SGVector<float64_t> data(10);
+	data.range_fill();
+	CHDF5File* fout=new CHDF5File(fname, 'w', "v");
+	fout->set_vector(data.vector, data.vlen);
+	fout->set_variable_name("g/data");
+	fout->set_vector(data.vector, data.vlen);
+	fout->set_variable_name("m");
+	fout->set_matrix(data.vector, 2, 5);
+	SG_UNREF(fout);
+
+	const ssize_t num_open=H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_ALL);
+
+	// missing dataset, vector instead of matrix, incomplete sparse group,
+	// missing labels and labels of wrong size
+	EXPECT_THROW(new CStreamingHDF5File<float64_t>(fname, "x"), ShogunException);
+	EXPECT_THROW(new CStreamingHDF5File<float64_t>(fname, "v"), ShogunException);
+	EXPECT_THROW(new CStreamingHDF5File<float64_t>(fname, "g"), ShogunException);
+	EXPECT_THROW(new CStreamingHDF5File<float64_t>(fname, "m", "y"), ShogunException);
+	EXPECT_THROW(new CStreamingHDF5File<float64_t>(fname, "m", "v"), ShogunException);
+
+	EXPECT_EQ(H5Fget_obj_count(H5F_OBJ_ALL, H5F_OBJ_ALL), num_open);
+	EXPECT_EQ(unlink(fname), 0);
+}
+#endif // HAVE_HDF5
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <unistd.h>
+#include <gtest/gtest.h>
+
+#include <shogun/lib/config.h>
+
+#ifdef HAVE_PROTOBUF
+#include <shogun/io/ProtobufFile.h>
+#include <shogun/io/streaming/StreamingProtobufFile.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
+#include <shogun/features/streaming/StreamingSparseFeatures.h>
+#include <shogun/mathematics/Random.h>
+
+using namespace shogun;
+
+TEST(StreamingProtobufFileTest, dense_matrix_with_labels)
+{
+	std::string tmp_name="/tmp/StreamingProtobufFile_dense.XXXXXX";
+	const char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+	std::string tmp_label_name="/tmp/StreamingProtobufFile_labels.XXXXXX";
+	const char* label_fname=mktemp(const_cast<char*>(tmp_label_name.c_str()));
+
+	// the matrix is written in several chunk messages, which end within
+	// vectors
+	int32_t num_feat=10;
+	int32_t num_vec=30000;
+	CRandom* rand=new CRandom();
+	SGMatrix<float64_t> data(num_feat, num_vec);
+	SGVector<float64_t> labels(num_vec);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		labels[i]=rand->random(-1, 1);
+		for (int32_t j=0; j<num_feat; j++)
+			data(j,i)=rand->random(0., 1.);
+	}
+	SG_UNREF(rand);
+
+	CProtobufFile* fout=new CProtobufFile(fname, 'w');
+	fout->set_matrix(data.matrix, num_feat, num_vec);
+	SG_UNREF(fout);
+	fout=new CProtobufFile(label_fname, 'w');
+	fout->set_vector(labels.vector, num_vec);
+	SG_UNREF(fout);
+
+	CStreamingProtobufFile<float64_t>* file=
+		new CStreamingProtobufFile<float64_t>(fname, label_fname);
+	EXPECT_EQ(file->get_num_vectors(), num_vec);
+	EXPECT_EQ(file->get_num_features(), num_feat);
+	EXPECT_FALSE(file->is_sparse());
+
+	CStreamingDenseFeatures<float64_t>* stream_features=
+		new CStreamingDenseFeatures<float64_t>(file, true, 16);
+
+	stream_features->start_parser();
+	int32_t i=0;
+	while (stream_features->get_next_example())
+	{
+		SGVector<float64_t> v=stream_features->get_vector();
+		EXPECT_EQ(v.vlen, num_feat);
+		for (int32_t j=0; j<num_feat; j++)
+			EXPECT_EQ(v[j], data(j,i));
+		EXPECT_EQ(stream_features->get_label(), labels[i]);
+
+		stream_features->release_example();
+		i++;
+	}
+	stream_features->end_parser();
+	EXPECT_EQ(i, num_vec);
+
+	SG_UNREF(stream_features);
+	EXPECT_EQ(unlink(fname), 0);
+	EXPECT_EQ(unlink(label_fname), 0);
+}
+
+TEST(StreamingProtobufFileTest, sparse_matrix)
+{
+	std::string tmp_name="/tmp/StreamingProtobufFile_sparse.XXXXXX";
+	const char* fname=mktemp(const_cast<char*>(tmp_name.c_str()));
+
+	// about 200000 entries, more than fit into one chunk message
+	int32_t num_vec=2000;
+	int32_t max_num_entries=200;
+	int32_t num_feat=2*max_num_entries;
+	CRandom* rand=new CRandom();
+	SGSparseVector<float64_t>* data=SG_MALLOC(SGSparseVector<float64_t>, num_vec);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		data[i]=SGSparseVector<float64_t>(rand->random(0, max_num_entries));
+		for (int32_t j=0; j<data[i].num_feat_entries; j++)
+		{
+			data[i].features[j].feat_index=2*j+1;
+			data[i].features[j].entry=rand->random(0., 1.);
+		}
+	}
+	SG_UNREF(rand);
+
+	CProtobufFile* fout=new CProtobufFile(fname, 'w');
+	fout->set_sparse_matrix(data, num_feat, num_vec);
+	SG_UNREF(fout);
+
+	CStreamingProtobufFile<float64_t>* file=
+		new CStreamingProtobufFile<float64_t>(fname);
+	EXPECT_EQ(file->get_num_vectors(), num_vec);
+	EXPECT_TRUE(file->is_sparse());
+
+	CStreamingSparseFeatures<float64_t>* stream_features=
+		new CStreamingSparseFeatures<float64_t>(file, false, 16);
+
+	stream_features->start_parser();
+	int32_t i=0;
+	while (stream_features->get_next_example())
+	{
+		SGSparseVector<float64_t> v=stream_features->get_vector();
+		EXPECT_EQ(v.num_feat_entries, data[i].num_feat_entries);
+		for (int32_t j=0; j<v.num_feat_entries; j++)
+		{
+			EXPECT_EQ(v.features[j].feat_index, data[i].features[j].feat_index);
+			EXPECT_EQ(v.features[j].entry, data[i].features[j].entry);
+		}
+
+		stream_features->release_example();
+		i++;
+	}
+	stream_features->end_parser();
+	EXPECT_EQ(i, num_vec);
+
+	SG_UNREF(stream_features);
+	SG_FREE(data);
+	EXPECT_EQ(unlink(fname), 0);
+}
+#endif // HAVE_PROTOBUF
@@ -1,5 +1,8 @@
 #include <shogun/kernel/CombinedKernel.h>
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 #include <shogun/io/SerializableAsciiFile.h>
 #include <gtest/gtest.h>
 
@@ -217,3 +220,78 @@ TEST(CombinedKernelTest,combination)
 	SG_UNREF(combined_list);
 	SG_UNREF(kernel_list);
 }
+
+TEST(CombinedKernelTest,fused_subkernel_evaluation)
+{
+	int32_t num_vec=10;
+	int32_t num_feat=3;
+	SGMatrix<float64_t> data(num_feat, num_vec);
+	for (index_t i=0; i<num_feat*num_vec; i++)
+		data.matrix[i]=CMath::randn_double();
+
+	CDenseFeatures<float64_t>* feats=new CDenseFeatures<float64_t>(data);
+
+	/* gaussian kernels on the same features share distances, the linear
+	 * kernel in between is evaluated on its own */
+	CCombinedKernel* combined=new CCombinedKernel();
+	combined->append_kernel(new CGaussianKernel(10, 0.5));
+	combined->append_kernel(new CLinearKernel());
+	combined->append_kernel(new CGaussianKernel(10, 2.0));
+	combined->append_kernel(new CGaussianKernel(10, 8.0));
+	combined->init(feats, feats);
+
+	SGVector<float64_t> weights(4);
+	weights[0]=0.1;
+	weights[1]=0.2;
+	weights[2]=0.3;
+	weights[3]=0.4;
+	combined->set_subkernel_weights(weights);
+
+	SGVector<int32_t> idx(num_vec);
+	SGVector<float64_t> alpha(num_vec);
+	for (index_t i=0; i<num_vec; i++)
+	{
+		idx[i]=i;
+		alpha[i]=CMath::randn_double();
+	}
+
+	SGMatrix<float64_t> block(4, num_vec);
+	SGVector<float64_t> expected_forms(4);
+	expected_forms.zero();
+
+	for (index_t k=0; k<4; k++)
+	{
+		CKernel* kernel=combined->get_kernel(k);
+		for (index_t i=0; i<num_vec; i++)
+		{
+			combined->compute_subkernel_rows(i, num_vec, idx.vector, block.matrix);
+			for (index_t j=0; j<num_vec; j++)
+			{
+				float64_t value=kernel->kernel(i, j);
+				EXPECT_NEAR(block(k, j), value, 1e-12);
+				expected_forms[k]+=alpha[i]*alpha[j]*value;
+			}
+		}
+		SG_UNREF(kernel);
+	}
+
+	for (index_t i=0; i<num_vec; i++)
+	{
+		for (index_t j=0; j<num_vec; j++)
+		{
+			combined->compute_subkernel_rows(i, 1, &idx[j], block.matrix);
+			float64_t expected=0;
+			for (index_t k=0; k<4; k++)
+				expected+=weights[k]*block(k, 0);
+
+			EXPECT_NEAR(combined->kernel(i, j), expected, 1e-12);
+		}
+	}
+
+	SGVector<float64_t> forms=combined->compute_subkernel_quadratic_forms(
+			num_vec, idx.vector, alpha.vector);
+	for (index_t k=0; k<4; k++)
+		EXPECT_NEAR(forms[k], expected_forms[k], 1e-10);
+
+	SG_UNREF(combined);
+}
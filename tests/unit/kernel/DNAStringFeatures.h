@@ -0,0 +1,27 @@
+#ifndef __DNA_STRING_FEATURES_H__
+#define __DNA_STRING_FEATURES_H__
+
+#include <shogun/features/StringFeatures.h>
+#include <shogun/lib/SGStringList.h>
+#include <shogun/mathematics/Math.h>
+
+namespace shogun {
+
+	/** random DNA strings of equal length, drawn from the shogun RNG */
+	inline CStringFeatures<char>* create_dna_features(int32_t num_vec, int32_t len)
+	{
+		const char acgt[]="ACGT";
+		SGStringList<char> list(num_vec, len);
+		for (int32_t i=0; i<num_vec; i++)
+		{
+			list.strings[i]=SGString<char>(len);
+			for (int32_t j=0; j<len; j++)
+				list.strings[i].string[j]=acgt[CMath::random(0, 3)];
+		}
+
+		return new CStringFeatures<char>(list, DNA);
+	}
+
+}  // namespace shogun
+
+#endif // __DNA_STRING_FEATURES_H__
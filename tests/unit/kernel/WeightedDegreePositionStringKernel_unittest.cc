@@ -0,0 +1,69 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "kernel/DNAStringFeatures.h"
+#include <shogun/kernel/string/WeightedDegreePositionStringKernel.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parallel.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+static void check_parallel_normal(EOptimizationType opt_type)
+{
+	CMath::init_random(17);
+
+	const int32_t num_vec=30;
+	const int32_t len=60;
+	const int32_t degree=8;
+
+	CStringFeatures<char>* feats=create_dna_features(num_vec, len);
+	CWeightedDegreePositionStringKernel* kernel=
+		new CWeightedDegreePositionStringKernel(10, degree);
+	SG_REF(kernel);
+
+	SGVector<int32_t> shifts(len);
+	for (int32_t i=0; i<len; i++)
+		shifts[i]=CMath::random(0, 4);
+	kernel->set_shifts(shifts);
+	kernel->set_optimization_type(opt_type);
+	kernel->init(feats, feats);
+
+	SGVector<int32_t> idx(num_vec);
+	SGVector<float64_t> alphas(num_vec);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		idx[i]=i;
+		alphas[i]=(i%7==0) ? 0.0 : CMath::random(-1.0, 1.0);
+	}
+
+	// the trees built by several threads equal the ones built serially
+	kernel->parallel->set_num_threads(1);
+	kernel->init_optimization(num_vec, idx.vector, alphas.vector);
+	SGVector<float64_t> serial(num_vec);
+	for (int32_t j=0; j<num_vec; j++)
+		serial[j]=kernel->compute_optimized(j);
+	kernel->delete_optimization();
+
+	kernel->parallel->set_num_threads(4);
+	kernel->init_optimization(num_vec, idx.vector, alphas.vector);
+	for (int32_t j=0; j<num_vec; j++)
+		EXPECT_NEAR(kernel->compute_optimized(j), serial[j], 1E-12);
+	kernel->delete_optimization();
+
+	SG_UNREF(kernel);
+}
+
+TEST(WeightedDegreePositionStringKernel, parallel_normal_slow)
+{
+	check_parallel_normal(SLOWBUTMEMEFFICIENT);
+}
+
+TEST(WeightedDegreePositionStringKernel, parallel_normal_fast)
+{
+	check_parallel_normal(FASTBUTMEMHUNGRY);
+}
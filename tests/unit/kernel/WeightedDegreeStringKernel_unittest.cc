@@ -0,0 +1,59 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include "kernel/DNAStringFeatures.h"
+#include <shogun/kernel/string/WeightedDegreeStringKernel.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parallel.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+TEST(WeightedDegreeStringKernel, parallel_normal)
+{
+	CMath::init_random(17);
+
+	const int32_t num_vec=30;
+	const int32_t len=60;
+	const int32_t degree=8;
+
+	CStringFeatures<char>* feats=create_dna_features(num_vec, len);
+	CWeightedDegreeStringKernel* kernel=
+		new CWeightedDegreeStringKernel(feats, feats, degree);
+	SG_REF(kernel);
+
+	SGVector<int32_t> idx(num_vec);
+	SGVector<float64_t> alphas(num_vec);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		idx[i]=i;
+		alphas[i]=(i%7==0) ? 0.0 : CMath::random(-1.0, 1.0);
+	}
+
+	// the normal built by several threads equals the one built serially
+	kernel->parallel->set_num_threads(1);
+	kernel->init_optimization(num_vec, idx.vector, alphas.vector);
+	SGVector<float64_t> serial(num_vec);
+	for (int32_t j=0; j<num_vec; j++)
+		serial[j]=kernel->compute_optimized(j);
+	kernel->delete_optimization();
+
+	kernel->parallel->set_num_threads(4);
+	kernel->init_optimization(num_vec, idx.vector, alphas.vector);
+	for (int32_t j=0; j<num_vec; j++)
+	{
+		float64_t expected=0;
+		for (int32_t i=0; i<num_vec; i++)
+			expected+=alphas[i]*kernel->kernel(i, j);
+
+		EXPECT_NEAR(kernel->compute_optimized(j), serial[j], 1E-12);
+		EXPECT_NEAR(serial[j], expected, 1E-5);
+	}
+	kernel->delete_optimization();
+
+	SG_UNREF(kernel);
+}
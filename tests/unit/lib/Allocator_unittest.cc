@@ -0,0 +1,276 @@
+#include <shogun/lib/Allocator.h>
+#include <shogun/lib/memory.h>
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/ShogunException.h>
+#include <shogun/mathematics/Math.h>
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+using namespace shogun;
+
+TEST(AllocatorTest,pool_allocate_reallocate)
+{
+	SGPoolAllocator allocator;
+
+	/* pooled and large blocks */
+	size_t sizes[]={0, 1, 24, 100, 1000, 4096, 100000};
+	for (int32_t i=0; i<7; i++)
+	{
+		char* p=(char*) allocator.allocate(sizes[i]);
+		ASSERT_TRUE(p!=NULL);
+		EXPECT_TRUE(allocator.owns(p));
+		EXPECT_EQ(SGPoolAllocator::get_block_size(p), sizes[i]);
+		EXPECT_EQ((size_t) p % 16, 0);
+		memset(p, i, sizes[i]);
+
+		p=(char*) allocator.reallocate(p, sizes[i]+5000);
+		for (size_t j=0; j<sizes[i]; j++)
+			EXPECT_EQ(p[j], i);
+		EXPECT_EQ(SGPoolAllocator::get_block_size(p), sizes[i]+5000);
+
+		p=(char*) allocator.reallocate(p, 10);
+		for (size_t j=0; j<CMath::min(sizes[i], size_t(10)); j++)
+			EXPECT_EQ(p[j], i);
+		allocator.deallocate(p);
+	}
+
+	char* foreign=(char*) malloc(64);
+	memset(foreign, 0, 64);
+	EXPECT_FALSE(allocator.owns(foreign+16));
+	free(foreign);
+	EXPECT_EQ(allocator.get_num_blocks(), 0);
+}
+
+TEST(AllocatorTest,pool_owns)
+{
+	SGPoolAllocator allocator;
+	SGPoolAllocator other;
+
+	char* small=(char*) allocator.allocate(100);
+	char* large=(char*) allocator.allocate(100000);
+	EXPECT_EQ(allocator.get_num_blocks(), 2);
+
+	/* ownership is decided without looking at the memory around a
+	 * pointer, so a forged header isn't taken for a block */
+	char* foreign=(char*) malloc(256);
+	memcpy(foreign, small-16, 16);
+	memcpy(foreign+128, large-16, 16);
+	EXPECT_FALSE(allocator.owns(foreign+16));
+	EXPECT_FALSE(allocator.owns(foreign+144));
+	free(foreign);
+
+	/* only the start of a large block is owned */
+	EXPECT_TRUE(allocator.owns(large));
+	EXPECT_FALSE(allocator.owns(large+4096));
+	EXPECT_FALSE(other.owns(small));
+	EXPECT_FALSE(other.owns(large));
+
+	allocator.deallocate(small);
+	allocator.deallocate(large);
+	EXPECT_FALSE(allocator.owns(large));
+	EXPECT_EQ(allocator.get_num_blocks(), 0);
+}
+
+TEST(AllocatorTest,pool_aligned)
+{
+	SGPoolAllocator allocator;
+	size_t alignments[]={16, 32, 64, 4096};
+	for (int32_t i=0; i<4; i++)
+	{
+		void* p=allocator.allocate(100, alignments[i]);
+		EXPECT_EQ((size_t) p % alignments[i], 0);
+		EXPECT_TRUE(allocator.owns(p));
+		allocator.deallocate(p);
+	}
+
+	float64_t* v=SG_ALIGNED_MALLOC(float64_t, 7, 64);
+	EXPECT_EQ((size_t) v % 64, 0);
+	SG_FREE(v);
+}
+
+TEST(AllocatorTest,pool_reuses_blocks)
+{
+	SGPoolAllocator allocator;
+	void* blocks[1000];
+	for (int32_t round=0; round<3; round++)
+	{
+		for (int32_t i=0; i<1000; i++)
+			blocks[i]=allocator.allocate(48);
+		for (int32_t i=0; i<1000; i++)
+			allocator.deallocate(blocks[i]);
+	}
+
+	/* 1000 blocks of 64 bytes fit into two slabs */
+	EXPECT_LE(allocator.get_slab_bytes(), size_t(2<<16));
+}
+
+TEST(AllocatorTest,pool_multithreaded)
+{
+	SGPoolAllocator allocator;
+	int32_t failures=0;
+
+	#pragma omp parallel for num_threads(4) reduction(+:failures)
+	for (int32_t t=0; t<4; t++)
+	{
+		int32_t* blocks[200];
+		for (int32_t round=0; round<20; round++)
+		{
+			for (int32_t i=0; i<200; i++)
+			{
+				int32_t len=1+(i*7+t)%50;
+				blocks[i]=(int32_t*) allocator.allocate(sizeof(int32_t)*len);
+				for (int32_t j=0; j<len; j++)
+					blocks[i][j]=t*1000+i;
+			}
+			for (int32_t i=0; i<200; i++)
+			{
+				int32_t len=1+(i*7+t)%50;
+				for (int32_t j=0; j<len; j++)
+					failures+=blocks[i][j]!=t*1000+i;
+				allocator.deallocate(blocks[i]);
+			}
+		}
+	}
+
+	EXPECT_EQ(failures, 0);
+}
+
+TEST(AllocatorTest,memory_counter)
+{
+	SGPoolAllocator allocator;
+	SGMemoryCounter counter("test", 10000);
+	SGMemoryCounter* total=get_total_memory_counter();
+	int64_t total_before=total->get_bytes();
+
+	void* outside=allocator.allocate(100);
+	void* a;
+	void* b;
+	{
+		SGMemoryCounterScope scope(&counter);
+		a=allocator.allocate(1000);
+		b=allocator.allocate(5000);
+		EXPECT_EQ(counter.get_bytes(), 6000);
+		EXPECT_EQ(counter.get_num_allocations(), 2);
+		EXPECT_EQ(total->get_bytes(), total_before+6100);
+
+		EXPECT_THROW(allocator.allocate(5000), ShogunException);
+		EXPECT_EQ(counter.get_bytes(), 6000);
+		EXPECT_EQ(total->get_bytes(), total_before+6100);
+	}
+
+	/* blocks are released from the counter they were charged to */
+	allocator.deallocate(b);
+	EXPECT_EQ(counter.get_bytes(), 1000);
+	EXPECT_EQ(counter.get_peak_bytes(), 6000);
+	counter.reset_peak();
+	EXPECT_EQ(counter.get_peak_bytes(), 1000);
+
+	allocator.deallocate(a);
+	allocator.deallocate(outside);
+	EXPECT_EQ(counter.get_bytes(), 0);
+	EXPECT_EQ(total->get_bytes(), total_before);
+}
+
+TEST(AllocatorTest,arena)
+{
+	SGArena arena(1024);
+
+	float64_t* a=arena.allocate<float64_t>(10);
+	EXPECT_EQ((size_t) a % 16, 0);
+	EXPECT_EQ(arena.get_used(), 80);
+
+	char* first;
+	{
+		SGArenaScope scope(arena);
+		first=(char*) arena.allocate(500);
+		/* larger than a chunk */
+		arena.allocate(3000, 64);
+		EXPECT_EQ(arena.get_used(), 3580);
+	}
+	EXPECT_EQ(arena.get_used(), 80);
+	size_t capacity=arena.get_capacity();
+
+	/* memory given back is handed out again without new chunks */
+	{
+		SGArenaScope scope(arena);
+		EXPECT_EQ((char*) arena.allocate(500), first);
+		arena.allocate(3000, 64);
+	}
+	EXPECT_EQ(arena.get_capacity(), capacity);
+
+	arena.reset();
+	EXPECT_EQ(arena.get_used(), 0);
+	EXPECT_EQ((float64_t*) arena.allocate<float64_t>(10), a);
+}
+
+TEST(AllocatorTest,global_allocator)
+{
+	/* blocks allocated before the allocator is installed stay with malloc */
+	char* before=SG_MALLOC(char, 100);
+	float64_t* before_aligned=SG_ALIGNED_MALLOC(float64_t, 10, 64);
+
+	SGPoolAllocator allocator;
+	SGMemoryCounter counter("test");
+	set_global_allocator(&allocator);
+	EXPECT_EQ(get_global_allocator(), &allocator);
+	EXPECT_FALSE(allocator.owns(before));
+
+	int32_t* small;
+	float64_t* large;
+	float64_t* aligned;
+	{
+		SGMemoryCounterScope scope(&counter);
+		small=SG_MALLOC(int32_t, 10);
+		large=SG_CALLOC(float64_t, 10000);
+		aligned=SG_ALIGNED_MALLOC(float64_t, 7, 64);
+	}
+	EXPECT_TRUE(allocator.owns(small));
+	EXPECT_TRUE(allocator.owns(large));
+	EXPECT_TRUE(allocator.owns(aligned));
+	EXPECT_EQ((size_t) aligned % 64, 0);
+	EXPECT_EQ(counter.get_bytes(), int64_t(10*sizeof(int32_t)+
+		10000*sizeof(float64_t)+7*sizeof(float64_t)));
+	EXPECT_EQ(allocator.get_num_blocks(), 3);
+	for (int32_t i=0; i<10000; i++)
+		EXPECT_EQ(large[i], 0);
+
+	for (int32_t i=0; i<10; i++)
+		small[i]=i;
+	small=SG_REALLOC(int32_t, small, 10, 5000);
+	EXPECT_TRUE(allocator.owns(small));
+	for (int32_t i=0; i<10; i++)
+		EXPECT_EQ(small[i], i);
+
+	/* reallocating and freeing blocks of malloc */
+	before[99]=1;
+	before=SG_REALLOC(char, before, 100, 200);
+	EXPECT_FALSE(allocator.owns(before));
+	EXPECT_EQ(before[99], 1);
+	SG_FREE(before);
+	SG_FREE(before_aligned);
+
+	{
+		SGVector<float64_t> v(100);
+		v.zero();
+		EXPECT_EQ(allocator.get_num_blocks(), 4);
+
+		/* the allocator can't be uninstalled while blocks are in use */
+		EXPECT_THROW(set_global_allocator(NULL), ShogunException);
+		EXPECT_EQ(get_global_allocator(), &allocator);
+	}
+
+	SG_FREE(small);
+	SG_FREE(large);
+	SG_FREE(aligned);
+	EXPECT_EQ(allocator.get_num_blocks(), 0);
+	EXPECT_EQ(counter.get_bytes(), 0);
+
+	set_global_allocator(NULL);
+	EXPECT_EQ(get_global_allocator(), (SGAllocator*) NULL);
+
+	char* after=SG_MALLOC(char, 10);
+	EXPECT_FALSE(allocator.owns(after));
+	SG_FREE(after);
+}
@@ -133,3 +133,30 @@ TEST(SGMatrixTest,get_diagonal_vector_rectangular_matrix)
 	EXPECT_EQ(diag[0], 8);
 	EXPECT_EQ(diag[1], 5);
 }
+
+#ifdef HAVE_CXX11
+TEST(SGMatrixTest,move)
+{
+	SGMatrix<float64_t> a(2, 3);
+	a.set_const(2.5);
+	float64_t* data = a.matrix;
+	SGMatrix<float64_t> b = a;
+	EXPECT_EQ(2, a.ref_count());
+
+	SGMatrix<float64_t> c(std::move(a));
+	EXPECT_TRUE(a.matrix==NULL);
+	EXPECT_EQ(0, a.num_rows);
+	EXPECT_EQ(0, a.num_cols);
+	EXPECT_EQ(data, c.matrix);
+	EXPECT_EQ(2, c.ref_count());
+
+	SGMatrix<float64_t> d(4, 4);
+	d = std::move(c);
+	EXPECT_TRUE(c.matrix==NULL);
+	EXPECT_EQ(data, d.matrix);
+	EXPECT_EQ(2, d.num_rows);
+	EXPECT_EQ(3, d.num_cols);
+	EXPECT_EQ(2, d.ref_count());
+	EXPECT_EQ(2.5, d(1,2));
+}
+#endif // HAVE_CXX11
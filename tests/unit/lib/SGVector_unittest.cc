@@ -387,3 +387,33 @@ TEST(SGVectorTest,is_sorted_2)
 
 	EXPECT_EQ(v.is_sorted(), true);
 }
+
+#ifdef HAVE_CXX11
+TEST(SGVectorTest,move)
+{
+	SGVector<float64_t> a(3);
+	a.set_const(1.5);
+	float64_t* data = a.vector;
+	SGVector<float64_t> b = a;
+	EXPECT_EQ(2, a.ref_count());
+
+	SGVector<float64_t> c(std::move(a));
+	EXPECT_TRUE(a.vector==NULL);
+	EXPECT_EQ(0, a.vlen);
+	EXPECT_EQ(data, c.vector);
+	EXPECT_EQ(3, c.vlen);
+	EXPECT_EQ(2, c.ref_count());
+
+	SGVector<float64_t> d(5);
+	d = std::move(c);
+	EXPECT_TRUE(c.vector==NULL);
+	EXPECT_EQ(data, d.vector);
+	EXPECT_EQ(3, d.vlen);
+	EXPECT_EQ(2, d.ref_count());
+	EXPECT_EQ(1.5, d[2]);
+
+	d = b;
+	EXPECT_EQ(data, d.vector);
+	EXPECT_EQ(2, b.ref_count());
+}
+#endif // HAVE_CXX11
@@ -364,3 +364,108 @@ TEST(CMath, fequals_close_to_zero)
 	EXPECT_FALSE(CMath::fequals<float64_t>(CMath::F_MIN_VAL64, 0.000000001f, eps));
 	EXPECT_FALSE(CMath::fequals<float64_t>(-CMath::F_MIN_VAL64, 0.000000001f, eps));
 }
+
+TEST(CMath, parallel_sort_index)
+{
+	CMath::init_random(17);
+	const index_t size=100000;
+	SGVector<float64_t> values(size);
+	SGVector<float64_t> sorted(size);
+	SGVector<index_t> index(size);
+	for (index_t i=0; i<size; i++)
+	{
+		values[i]=CMath::random(-500, 500)/7.0;
+		sorted[i]=values[i];
+		index[i]=i;
+	}
+
+	CMath::parallel_sort_index(sorted.vector, index.vector, size, 5);
+	for (index_t i=0; i<size; i++)
+	{
+		EXPECT_EQ(sorted[i], values[index[i]]);
+		if (i>0)
+		{
+			EXPECT_LE(sorted[i-1], sorted[i]);
+		}
+	}
+}
+
+TEST(CMath, lsd_radix_sort)
+{
+	CMath::init_random(17);
+	const index_t size=50000;
+	SGVector<float64_t> values(size);
+	SGVector<float64_t> sorted(size);
+	SGVector<int32_t> ints(size);
+	SGVector<index_t> index(size);
+	for (index_t i=0; i<size; i++)
+	{
+		values[i]=CMath::randn_double()*CMath::pow(10.0, CMath::random(-5, 5));
+		if (i%10==0)
+			values[i]=CMath::random(-3, 3);
+		sorted[i]=values[i];
+		ints[i]=CMath::random(-100000, 100000);
+		index[i]=i;
+	}
+
+	CMath::lsd_radix_sort_index(sorted.vector, index.vector, size, 3);
+	for (index_t i=0; i<size; i++)
+	{
+		EXPECT_EQ(sorted[i], values[index[i]]);
+		if (i>0)
+		{
+			EXPECT_LE(sorted[i-1], sorted[i]);
+			// stable
+			if (sorted[i-1]==sorted[i] && sorted[i]!=0)
+			{
+				EXPECT_LT(index[i-1], index[i]);
+			}
+		}
+	}
+
+	CMath::lsd_radix_sort(ints.vector, size, 3);
+	for (index_t i=1; i<size; i++)
+		EXPECT_LE(ints[i-1], ints[i]);
+}
+
+TEST(CMath, partial_sort_index)
+{
+	CMath::init_random(17);
+	const index_t size=70000;
+	SGVector<float64_t> values(size);
+	SGVector<float64_t> selected(size);
+	SGVector<index_t> index(size);
+	for (index_t i=0; i<size; i++)
+	{
+		values[i]=CMath::random(0, 1000);
+		selected[i]=values[i];
+		index[i]=i;
+	}
+
+	SGVector<float64_t> sorted=values.clone();
+	sorted.qsort();
+
+	const index_t k=1234;
+	CMath::partial_sort_index(selected.vector, index.vector, size, k, 4);
+	for (index_t i=0; i<size; i++)
+	{
+		EXPECT_EQ(selected[i], values[index[i]]);
+		if (i<k)
+		{
+			EXPECT_EQ(selected[i], sorted[i]);
+		}
+		else
+		{
+			EXPECT_GE(selected[i], sorted[k-1]);
+		}
+	}
+
+	const index_t n=size/2;
+	selected=values.clone();
+	CMath::parallel_nth_element(selected.vector, size, n, 4);
+	EXPECT_EQ(selected[n], sorted[n]);
+	for (index_t i=0; i<n; i++)
+		EXPECT_LE(selected[i], selected[n]);
+	for (index_t i=n+1; i<size; i++)
+		EXPECT_GE(selected[i], selected[n]);
+}
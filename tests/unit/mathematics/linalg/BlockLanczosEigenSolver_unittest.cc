@@ -0,0 +1,144 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/common.h>
+
+#ifdef HAVE_EIGEN3
+
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/DenseMatrixOperator.h>
+#include <shogun/mathematics/linalg/eigsolver/BlockLanczosEigenSolver.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+using namespace Eigen;
+
+TEST(BlockLanczosEigenSolver, compute_dense_matrix)
+{
+	CMath::init_random(17);
+
+	const index_t size=300;
+	const index_t k=6;
+
+	SGMatrix<float64_t> m(size, size);
+	for (index_t i=0; i<size; ++i)
+	{
+		for (index_t j=0; j<=i; ++j)
+		{
+			m(i,j)=CMath::random(-1.0, 1.0);
+			m(j,i)=m(i,j);
+		}
+	}
+	Map<MatrixXd> map_m(m.matrix, size, size);
+	SelfAdjointEigenSolver<MatrixXd> direct(map_m);
+
+	CDenseMatrixOperator<float64_t>* A=new CDenseMatrixOperator<float64_t>(m);
+	CBlockLanczosEigenSolver* eig_solver=new CBlockLanczosEigenSolver(A);
+	SG_REF(eig_solver);
+	eig_solver->set_num_eigenpairs(k);
+	eig_solver->set_block_size(3);
+
+	for (index_t largest=0; largest<2; ++largest)
+	{
+		eig_solver->set_compute_largest(largest);
+		eig_solver->compute();
+
+		SGVector<float64_t> eigenvalues=eig_solver->get_eigenvalues();
+		SGMatrix<float64_t> eigenvectors=eig_solver->get_eigenvectors();
+		Map<MatrixXd> X(eigenvectors.matrix, size, k);
+
+		EXPECT_EQ(eigenvalues.vlen, k);
+		for (index_t i=0; i<k; ++i)
+		{
+			const index_t j=largest ? size-1-i : i;
+			EXPECT_NEAR(eigenvalues[i], direct.eigenvalues()[j], 1E-8);
+			EXPECT_NEAR((map_m*X.col(i)-eigenvalues[i]*X.col(i)).norm(),
+				0.0, 1E-6);
+		}
+		EXPECT_NEAR((X.transpose()*X-MatrixXd::Identity(k, k)).norm(), 0.0,
+			1E-10);
+	}
+
+	EXPECT_NEAR(eig_solver->get_max_eigenvalue(), direct.eigenvalues()[size-1],
+		1E-8);
+	EXPECT_NEAR(eig_solver->get_min_eigenvalue(), direct.eigenvalues()[0],
+		1E-8);
+
+	SG_UNREF(eig_solver);
+}
+
+TEST(BlockLanczosEigenSolver, compute_sparse_diag_matrix_restarted)
+{
+	CMath::init_random(17);
+
+	const index_t size=300;
+	const index_t k=5;
+
+	SGSparseMatrix<float64_t> sm(size, size);
+	CSparseMatrixOperator<float64_t>* A=new CSparseMatrixOperator<float64_t>(sm);
+
+	SGVector<float64_t> diag(size);
+	for (index_t i=0; i<size; ++i)
+		diag[i]=i+1;
+	A->set_diagonal(diag);
+
+	CBlockLanczosEigenSolver* eig_solver=new CBlockLanczosEigenSolver(A);
+	SG_REF(eig_solver);
+	eig_solver->set_num_eigenpairs(k);
+	eig_solver->set_block_size(2);
+	eig_solver->set_max_basis_size(16);
+
+	eig_solver->set_compute_largest(false);
+	eig_solver->compute();
+	SGVector<float64_t> eigenvalues=eig_solver->get_eigenvalues();
+
+	EXPECT_GT(eig_solver->get_num_restarts(), 0);
+	for (index_t i=0; i<k; ++i)
+		EXPECT_NEAR(eigenvalues[i], i+1, 1E-8);
+
+	eig_solver->set_compute_largest(true);
+	eig_solver->compute();
+	eigenvalues=eig_solver->get_eigenvalues();
+
+	EXPECT_GT(eig_solver->get_num_restarts(), 0);
+	for (index_t i=0; i<k; ++i)
+		EXPECT_NEAR(eigenvalues[i], size-i, 1E-8);
+
+	SG_UNREF(eig_solver);
+}
+
+TEST(BlockLanczosEigenSolver, compute_small_matrix)
+{
+	CMath::init_random(17);
+
+	const index_t size=4;
+	SGMatrix<float64_t> m(size, size);
+	m.zero();
+	for (index_t i=0; i<size; ++i)
+		m(i,i)=i+1;
+	m(0,1)=m(1,0)=0.5;
+
+	CDenseMatrixOperator<float64_t>* A=new CDenseMatrixOperator<float64_t>(m);
+	CBlockLanczosEigenSolver* eig_solver=new CBlockLanczosEigenSolver(A);
+	SG_REF(eig_solver);
+	eig_solver->set_num_eigenpairs(2);
+	eig_solver->compute();
+
+	// the dimension does not exceed the basis size, computed densely
+	SGVector<float64_t> eigenvalues=eig_solver->get_eigenvalues();
+	EXPECT_EQ(eig_solver->get_num_restarts(), 0);
+	EXPECT_NEAR(eigenvalues[0], 4.0, 1E-12);
+	EXPECT_NEAR(eigenvalues[1], 3.0, 1E-12);
+
+	SG_UNREF(eig_solver);
+}
+#endif // HAVE_EIGEN3
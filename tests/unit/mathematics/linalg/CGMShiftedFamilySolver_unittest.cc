@@ -171,4 +171,67 @@ TEST(CGMShiftedFamilySolver, solve_shifted_weight_complex_shift)
 	SG_UNREF(A);
 	SG_UNREF(B);
 }
+TEST(CGMShiftedFamilySolver, solve_shifted_weighted_block)
+{
+	const int32_t size=50;
+	const int32_t num_vectors=5;
+	SGMatrix<float64_t> m(size, size);
+	m.set_const(0.0);
+
+	// tridiagonal symmetric positive definite matrix
+	for (index_t i=0; i<size; ++i)
+	{
+		m(i,i)=4.0+i*0.1;
+		if (i>0)
+			m(i,i-1)=m(i-1,i)=-1.0;
+	}
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+	CSparseMatrixOperator<float64_t>* A
+		=new CSparseMatrixOperator<float64_t>(mat);
+	A->parallel->set_num_threads(3);
+
+	// vectors of the systems, one of them zero
+	SGMatrix<float64_t> b(size, num_vectors);
+	CMath::init_random(1);
+	for (index_t i=0; i<size*num_vectors; ++i)
+		b[i]=CMath::randn_double();
+	for (index_t i=0; i<size; ++i)
+		b(i, 2)=0.0;
+
+	// complex shifts and weights
+	SGVector<complex128_t> shifts(3);
+	SGVector<complex128_t> weights(3);
+	for (index_t i=0; i<shifts.vlen; ++i)
+	{
+		shifts[i]=complex128_t(-i*0.5, i+1.0);
+		weights[i]=complex128_t(1.0, -i*0.3);
+	}
+
+	CCGMShiftedFamilySolver cg_m_linear_solver;
+	cg_m_linear_solver.parallel->set_num_threads(3);
+	SGMatrix<complex128_t> x_block=cg_m_linear_solver.solve_shifted_weighted_block(
+		A, b, shifts, weights);
+
+	EXPECT_EQ(x_block.num_rows, size);
+	EXPECT_EQ(x_block.num_cols, num_vectors);
+
+	// each column is the solution of the single vector solver
+	for (index_t j=0; j<num_vectors; ++j)
+	{
+		SGVector<float64_t> b_j(b.get_column_vector(j), size, false);
+		SGVector<complex128_t> x=cg_m_linear_solver.solve_shifted_weighted(
+			A, b_j, shifts, weights);
+
+		for (index_t i=0; i<size; ++i)
+		{
+			EXPECT_NEAR(x_block(i, j).real(), x[i].real(), 1E-10);
+			EXPECT_NEAR(x_block(i, j).imag(), x[i].imag(), 1E-10);
+		}
+	}
+
+	SG_UNREF(A);
+}
+
 #endif //HAVE_EIGEN3
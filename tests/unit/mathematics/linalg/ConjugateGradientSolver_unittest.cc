@@ -16,6 +16,8 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/JacobiPreconditioner.h>
+#include <shogun/mathematics/linalg/linop/IncompleteCholeskyPreconditioner.h>
 #include <shogun/mathematics/linalg/linsolver/ConjugateGradientSolver.h>
 #include <gtest/gtest.h>
 
@@ -51,4 +53,92 @@ TEST(ConjugateGradientSolver, solve)
 
 	SG_UNREF(A);
 }
+
+/* tridiagonal matrix with strongly varying diagonal */
+static SGMatrix<float64_t> badly_scaled_tridiagonal(index_t size)
+{
+	SGMatrix<float64_t> m(size, size);
+	m.set_const(0.0);
+	for (index_t i=0; i<size; ++i)
+	{
+		m(i,i)=2.0+(i%10)*(i%10)*100.0;
+		if (i>0)
+		{
+			m(i,i-1)=-1.0;
+			m(i-1,i)=-1.0;
+		}
+	}
+	return m;
+}
+
+TEST(ConjugateGradientSolver, solve_jacobi_preconditioned)
+{
+	const int32_t size=200;
+	SGMatrix<float64_t> m=badly_scaled_tridiagonal(size);
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+
+	CSparseMatrixOperator<float64_t>* A
+		=new CSparseMatrixOperator<float64_t>(mat);
+
+	SGVector<float64_t> b(size);
+	b.set_const(1.0);
+
+	Map<MatrixXd> map_m(m.matrix, m.num_rows, m.num_cols);
+	Map<VectorXd> map_b(b.vector, b.vlen);
+	VectorXd expected=map_m.llt().solve(map_b);
+
+	CConjugateGradientSolver linear_solver;
+	linear_solver.set_relative_tolerence(1E-10);
+	linear_solver.set_absolute_tolerence(1E-10);
+
+	SGVector<float64_t> x=linear_solver.solve(A, b);
+	Map<VectorXd> map_x(x.vector, x.vlen);
+	EXPECT_NEAR((map_x-expected).norm(), 0.0, 1E-8);
+	index_t num_iterations=linear_solver.get_num_iterations();
+
+	linear_solver.set_preconditioner(new CJacobiPreconditioner<float64_t>(A));
+	SGVector<float64_t> x_precond=linear_solver.solve(A, b);
+	Map<VectorXd> map_x_precond(x_precond.vector, x_precond.vlen);
+	EXPECT_NEAR((map_x_precond-expected).norm(), 0.0, 1E-8);
+	EXPECT_LT(linear_solver.get_num_iterations(), num_iterations);
+	EXPECT_LT(linear_solver.get_residual_norm(), 1E-10*(1.0+map_b.norm()));
+	EXPECT_GT(linear_solver.get_convergence_rate(), 0.0);
+	EXPECT_LT(linear_solver.get_convergence_rate(), 1.0);
+
+	SG_UNREF(A);
+}
+
+TEST(ConjugateGradientSolver, solve_incomplete_cholesky_preconditioned)
+{
+	const int32_t size=200;
+	SGMatrix<float64_t> m=badly_scaled_tridiagonal(size);
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+
+	CSparseMatrixOperator<float64_t>* A
+		=new CSparseMatrixOperator<float64_t>(mat);
+
+	SGVector<float64_t> b(size);
+	for (index_t i=0; i<size; ++i)
+		b[i]=i%3;
+
+	CConjugateGradientSolver linear_solver(true);
+	linear_solver.set_preconditioner(new CIncompleteCholeskyPreconditioner(A));
+
+	// the incomplete Cholesky factor of a tridiagonal matrix is exact,
+	// so the preconditioned system is solved at once
+	SGVector<float64_t> x=linear_solver.solve(A, b);
+	EXPECT_LE(linear_solver.get_num_iterations(), 1);
+
+	Map<VectorXd> map_x(x.vector, x.vlen);
+	Map<MatrixXd> map_m(m.matrix, m.num_rows, m.num_cols);
+	Map<VectorXd> map_b(b.vector, b.vlen);
+	EXPECT_NEAR(linear_solver.get_residuals()[0], map_b.norm(), 1E-12);
+	EXPECT_NEAR((map_x-map_m.llt().solve(map_b)).norm(), 0.0, 1E-10);
+
+	SG_UNREF(A);
+}
 #endif //HAVE_EIGEN3
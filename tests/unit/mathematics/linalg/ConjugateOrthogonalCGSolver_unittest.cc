@@ -15,6 +15,7 @@
 #include <shogun/mathematics/Math.h>
 #include <shogun/mathematics/eigen3.h>
 #include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/JacobiPreconditioner.h>
 #include <shogun/mathematics/linalg/linsolver/ConjugateOrthogonalCGSolver.h>
 #include <gtest/gtest.h>
 
@@ -58,4 +59,44 @@ TEST(ConjugateOrthogonalCGSolver, solve)
 	SG_UNREF(A);
 	SG_UNREF(cocg_linear_solver);
 }
+
+TEST(ConjugateOrthogonalCGSolver, solve_jacobi_preconditioned)
+{
+	const int32_t size=10;
+	SGSparseMatrix<complex128_t> m(size, size);
+	CSparseMatrixOperator<complex128_t>* A=new CSparseMatrixOperator<complex128_t>(m);
+
+	// diagonal non-Hermintian matrix with random complex entries
+	SGVector<complex128_t> diag(size);
+	sg_rand->set_seed(100.0);
+	for (index_t i=0; i<size; ++i)
+	{
+		float64_t real=sg_rand->std_normal_distrib();
+		float64_t imag=sg_rand->std_normal_distrib();
+		diag[i]=complex128_t(real, imag);
+	}
+	A->set_diagonal(diag);
+
+	// vector b of the system
+	SGVector<float64_t> b(size);
+	for (index_t i=0; i<size; ++i)
+		b[i]=sg_rand->std_normal_distrib();
+
+	// the Jacobi preconditioner of a diagonal matrix is its exact inverse
+	CConjugateOrthogonalCGSolver* cocg_linear_solver
+		=new CConjugateOrthogonalCGSolver();
+	cocg_linear_solver->set_preconditioner(new CJacobiPreconditioner<complex128_t>(A));
+	const SGVector<complex128_t>& x=cocg_linear_solver->solve(A, b);
+	EXPECT_LE(cocg_linear_solver->get_num_iterations(), 1);
+
+	const SGVector<complex128_t>& Ax=A->apply(x);
+
+	Map<VectorXd> map_b(b.vector, b.vlen);
+	Map<VectorXcd> map_Ax(Ax.vector, Ax.vlen);
+
+	EXPECT_NEAR((map_b.cast<complex128_t>()-map_Ax).norm(), 0.0, 1E-10);
+
+	SG_UNREF(A);
+	SG_UNREF(cocg_linear_solver);
+}
 #endif //HAVE_EIGEN3
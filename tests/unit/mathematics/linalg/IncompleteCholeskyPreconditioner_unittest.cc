@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/lib/common.h>
+
+#ifdef HAVE_EIGEN3
+#include <shogun/lib/SGVector.h>
+#include <shogun/lib/SGMatrix.h>
+#include <shogun/lib/SGSparseMatrix.h>
+#include <shogun/features/SparseFeatures.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/mathematics/eigen3.h>
+#include <shogun/mathematics/linalg/linop/SparseMatrixOperator.h>
+#include <shogun/mathematics/linalg/linop/IncompleteCholeskyPreconditioner.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+using namespace Eigen;
+
+TEST(IncompleteCholeskyPreconditioner, apply_tridiagonal)
+{
+	const index_t size=50;
+	SGMatrix<float64_t> m(size, size);
+	m.set_const(0.0);
+	for (index_t i=0; i<size; ++i)
+	{
+		m(i,i)=4.0+i;
+		if (i>0)
+		{
+			m(i,i-1)=-1.0;
+			m(i-1,i)=-1.0;
+		}
+	}
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+	CSparseMatrixOperator<float64_t> op(mat);
+
+	// there is no fill-in, so the factorization is the exact Cholesky one
+	CIncompleteCholeskyPreconditioner precond(&op);
+	EXPECT_EQ(precond.get_num_nonzeros(), 2*size-1);
+	EXPECT_EQ(precond.get_shift(), 0.0);
+
+	SGVector<float64_t> b(size);
+	for (index_t i=0; i<size; ++i)
+		b[i]=CMath::sin(i);
+
+	SGVector<float64_t> x=precond.apply(b);
+	Map<VectorXd> map_x(x.vector, x.vlen);
+	Map<MatrixXd> map_m(m.matrix, m.num_rows, m.num_cols);
+	Map<VectorXd> map_b(b.vector, b.vlen);
+
+	EXPECT_NEAR((map_x-map_m.llt().solve(map_b)).norm(), 0.0, 1E-12);
+}
+
+TEST(IncompleteCholeskyPreconditioner, apply_laplacian)
+{
+	// 2d Laplacian on a grid, whose factor drops the fill-in
+	const index_t n=10;
+	const index_t size=n*n;
+	SGMatrix<float64_t> m(size, size);
+	m.set_const(0.0);
+	for (index_t i=0; i<n; ++i)
+	{
+		for (index_t j=0; j<n; ++j)
+		{
+			const index_t k=i*n+j;
+			m(k,k)=4.0;
+			if (j>0)
+				m(k,k-1)=m(k-1,k)=-1.0;
+			if (i>0)
+				m(k,k-n)=m(k-n,k)=-1.0;
+		}
+	}
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+	CSparseMatrixOperator<float64_t> op(mat);
+
+	CIncompleteCholeskyPreconditioner precond(&op);
+	EXPECT_EQ(precond.get_num_nonzeros(), size+2*n*(n-1));
+
+	// the preconditioner is symmetric positive-definite and closer to the
+	// inverse than the identity
+	SGVector<float64_t> b(size);
+	SGVector<float64_t> c(size);
+	CMath::init_random(1);
+	for (index_t i=0; i<size; ++i)
+	{
+		b[i]=CMath::randn_double();
+		c[i]=CMath::randn_double();
+	}
+
+	SGVector<float64_t> Mb=precond.apply(b);
+	SGVector<float64_t> Mc=precond.apply(c);
+	Map<VectorXd> map_b(b.vector, size);
+	Map<VectorXd> map_c(c.vector, size);
+	Map<VectorXd> map_Mb(Mb.vector, size);
+	Map<VectorXd> map_Mc(Mc.vector, size);
+
+	EXPECT_NEAR(map_b.dot(map_Mc), map_c.dot(map_Mb), 1E-12);
+	EXPECT_GT(map_b.dot(map_Mb), 0.0);
+
+	Map<MatrixXd> map_m(m.matrix, m.num_rows, m.num_cols);
+	EXPECT_LT((map_m*map_Mb-map_b).norm(), 0.5*map_b.norm());
+}
+#endif //HAVE_EIGEN3
@@ -301,6 +301,104 @@ TEST(LogDetEstimator, sample_ratapp_probing_sampler_cgm)
 	SG_UNREF(e);
 }
 
+TEST(LogDetEstimator, sample_ratapp_probing_sampler_cgm_block)
+{
+	CSerialComputationEngine* e=new CSerialComputationEngine;
+	SG_REF(e);
+
+	const index_t size=16;
+	SGMatrix<float64_t> mat(size, size);
+	mat.set_const(0.0);
+	for (index_t i=0; i<size; ++i)
+	{
+		float64_t value=CMath::abs(sg_rand->std_normal_distrib())*1000;
+		mat(i,i)=value<1.0?10.0:value;
+	}
+
+	mat(0,5)=mat(5,0)=1.0;
+	mat(0,7)=mat(7,0)=1.0;
+	mat(0,11)=mat(11,0)=1.0;
+	mat(1,8)=mat(8,1)=1.0;
+	mat(1,10)=mat(10,1)=1.0;
+	mat(1,11)=mat(11,1)=1.0;
+	mat(1,12)=mat(12,1)=1.0;
+	mat(2,8)=mat(8,2)=1.0;
+	mat(2,11)=mat(11,2)=1.0;
+	mat(2,13)=mat(13,2)=1.0;
+	mat(2,14)=mat(14,2)=1.0;
+	mat(3,8)=mat(8,3)=1.0;
+	mat(3,12)=mat(12,3)=1.0;
+	mat(3,15)=mat(15,3)=1.0;
+	mat(4,8)=mat(8,4)=1.0;
+	mat(4,14)=mat(14,4)=1.0;
+	mat(4,15)=mat(15,4)=1.0;
+	mat(5,11)=mat(11,5)=1.0;
+	mat(5,10)=mat(10,5)=1.0;
+	mat(6,10)=mat(10,6)=1.0;
+	mat(6,12)=mat(12,6)=1.0;
+	mat(7,11)=mat(11,7)=1.0;
+	mat(7,13)=mat(13,7)=1.0;
+	mat(8,11)=mat(11,8)=1.0;
+	mat(8,15)=mat(15,8)=1.0;
+	mat(9,13)=mat(13,9)=1.0;
+	mat(9,14)=mat(14,9)=1.0;
+
+	float64_t actual_result=CStatistics::log_det(mat);
+	float64_t accuracy=1E-15;
+
+	CSparseFeatures<float64_t> feat(mat);
+	SGSparseMatrix<float64_t> sm=feat.get_sparse_feature_matrix();
+
+	CSparseMatrixOperator<float64_t>* op=new CSparseMatrixOperator<float64_t>(sm);
+	SG_REF(op);
+
+	CLanczosEigenSolver* eig_solver=new CLanczosEigenSolver(op);
+	SG_REF(eig_solver);
+
+	CCGMShiftedFamilySolver* linear_solver=new CCGMShiftedFamilySolver();
+	SG_REF(linear_solver);
+
+	CLogRationalApproximationCGM *op_func
+		=new CLogRationalApproximationCGM(op, e, eig_solver, linear_solver, accuracy);
+	SG_REF(op_func);
+
+	CProbingSampler* trace_sampler=new CProbingSampler(op, 1, NATURAL, DISTANCE_TWO);
+	SG_REF(trace_sampler);
+
+	CLogDetEstimator estimator(trace_sampler, op_func, e);
+	const index_t num_estimates=3;
+	sg_rand->set_seed(1);
+	SGMatrix<float64_t> samples=estimator.sample_without_averaging(num_estimates);
+
+	// blocks which span several estimates give the same samples
+	sg_rand->set_seed(1);
+	estimator.set_block_size(5);
+	SGMatrix<float64_t> block_samples
+		=estimator.sample_without_averaging(num_estimates);
+
+	EXPECT_EQ(block_samples.num_rows, samples.num_rows);
+	EXPECT_EQ(block_samples.num_cols, samples.num_cols);
+	for (index_t i=0; i<samples.num_rows*samples.num_cols; ++i)
+		EXPECT_NEAR(block_samples[i], samples[i], 1E-8);
+
+	const index_t num_block_estimates=10;
+	SGVector<float64_t> estimates=estimator.sample(num_block_estimates);
+
+	float64_t result=0.0;
+	for (index_t i=0; i<num_block_estimates; ++i)
+		result+=estimates[i];
+	result/=num_block_estimates;
+
+	EXPECT_NEAR(result, actual_result, 1E-3);
+
+	SG_UNREF(trace_sampler);
+	SG_UNREF(eig_solver);
+	SG_UNREF(linear_solver);
+	SG_UNREF(op_func);
+	SG_UNREF(op);
+	SG_UNREF(e);
+}
+
 TEST(LogDetEstimator, sample_ratapp_big_diag_matrix)
 {
 	CSerialComputationEngine* e=new CSerialComputationEngine;
@@ -270,4 +270,75 @@ TEST(SparseMatrixOperator, get_sparsity_structure)
 	delete sp_struct1;
 	delete sp_struct2;
 }
+TEST(SparseMatrixOperator, apply_block)
+{
+	const index_t size=30;
+	const index_t num_vectors=7;
+	SGMatrix<float64_t> m(size, size);
+	m.set_const(0.0);
+
+	CMath::init_random(1);
+	for (index_t i=0; i<size; ++i)
+	{
+		for (index_t j=0; j<size; ++j)
+		{
+			if (CMath::random(0, 3)==0)
+				m(i,j)=CMath::randn_double();
+		}
+	}
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+	CSparseMatrixOperator<float64_t> op(mat);
+	op.parallel->set_num_threads(4);
+
+	SGMatrix<float64_t> b(size, num_vectors);
+	for (index_t i=0; i<size*num_vectors; ++i)
+		b[i]=CMath::randn_double();
+
+	SGMatrix<float64_t> result=op.apply_block(b);
+	EXPECT_EQ(result.num_rows, size);
+	EXPECT_EQ(result.num_cols, num_vectors);
+
+	// same as applying the operator to each column
+	for (index_t j=0; j<num_vectors; ++j)
+	{
+		SGVector<float64_t> col=op.apply(
+			SGVector<float64_t>(b.get_column_vector(j), size, false));
+		for (index_t i=0; i<size; ++i)
+			EXPECT_NEAR(result(i, j), col[i], 1E-14);
+	}
+}
+
+TEST(SparseMatrixOperator, apply_multithreaded)
+{
+	const index_t size=3000;
+	SGMatrix<float64_t> m(size, size);
+	m.set_const(0.0);
+
+	CMath::init_random(1);
+	for (index_t i=0; i<size; ++i)
+	{
+		m(i,i)=CMath::randn_double();
+		const index_t num_entries=CMath::random(0, 10);
+		for (index_t k=0; k<num_entries; ++k)
+			m(i,CMath::random(0, size-1))=CMath::randn_double();
+	}
+
+	CSparseFeatures<float64_t> feat(m);
+	SGSparseMatrix<float64_t> mat=feat.get_sparse_feature_matrix();
+	CSparseMatrixOperator<float64_t> op(mat);
+	op.parallel->set_num_threads(4);
+
+	SGVector<float64_t> b(size);
+	for (index_t i=0; i<size; ++i)
+		b[i]=CMath::randn_double();
+
+	// same sums in the same order as the serial product
+	SGVector<float64_t> result=op.apply(b);
+	SGVector<float64_t> expected=mat*b;
+	for (index_t i=0; i<size; ++i)
+		EXPECT_EQ(result[i], expected[i]);
+}
+
 #endif // HAVE_EIGEN3
@@ -10,6 +10,7 @@
 #include <shogun/metric/LMNNImpl.h>
 #include <shogun/features/DenseFeatures.h>
 #include <shogun/labels/MulticlassLabels.h>
+#include <shogun/mathematics/Math.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -191,4 +192,70 @@ TEST(LMNNImpl,find_impostors_exact)
 	SG_UNREF(labels)
 }
 
+bool equal_impostors(const ImpostorsSetType& a, const ImpostorsSetType& b)
+{
+	if (a.size()!=b.size())
+		return false;
+
+	for (ImpostorsSetType::const_iterator ia=a.begin(), ib=b.begin(); ia!=a.end(); ia++, ib++)
+	{
+		if (ia->example!=ib->example || ia->target!=ib->target || ia->impostor!=ib->impostor)
+			return false;
+	}
+
+	return true;
+}
+
+TEST(LMNNImpl,find_impostors_random)
+{
+	CMath::init_random(17);
+
+	// three classes of random vectors, more than a block of them
+	int32_t d=3;
+	int32_t n=1200;
+	SGMatrix<float64_t> feat_mat(d,n);
+	SGVector<float64_t> lab_vec(n);
+	for (int32_t i=0; i<n; i++)
+	{
+		lab_vec[i]=i%3;
+		for (int32_t j=0; j<d; j++)
+			feat_mat(j,i)=CMath::random(-1.0,1.0)+0.5*lab_vec[i];
+	}
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(feat_mat);
+	CMulticlassLabels* labels=new CMulticlassLabels(lab_vec);
+
+	int32_t k=2;
+	SGMatrix<index_t> target_nn=CLMNNImpl::find_target_nn(features,labels,k);
+
+	Eigen::MatrixXd L=Eigen::MatrixXd::Random(d,d);
+	ImpostorsSetType Nexact;
+	ImpostorsSetType impostors=CLMNNImpl::find_impostors(features,labels,L,target_nn,0,2,Nexact);
+
+	// exhaustive search of the impostor triplets
+	Eigen::Map<const Eigen::MatrixXd> X(feat_mat.matrix,d,n);
+	Eigen::MatrixXd LX=L*X;
+	ImpostorsSetType impostors_gt;
+	for (index_t i=0; i<n; i++)
+	{
+		for (int32_t j=0; j<k; j++)
+		{
+			float64_t target_sqdist=(LX.col(i)-LX.col(target_nn(j,i))).squaredNorm()+1;
+			for (index_t l=0; l<n; l++)
+			{
+				if (lab_vec[l]!=lab_vec[i] && (LX.col(i)-LX.col(l)).squaredNorm()<=target_sqdist)
+					impostors_gt.insert(CImpostorNode(i,target_nn(j,i),l));
+			}
+		}
+	}
+
+	EXPECT_TRUE(equal_impostors(impostors_gt, impostors));
+
+	// the approximate search with the same transform finds the same triplets
+	ImpostorsSetType impostors_approx=CLMNNImpl::find_impostors(features,labels,L,target_nn,1,2,Nexact);
+	EXPECT_TRUE(equal_impostors(impostors_approx, impostors));
+
+	SG_UNREF(features)
+	SG_UNREF(labels)
+}
+
 #endif /* HAVE_EIGEN3 */
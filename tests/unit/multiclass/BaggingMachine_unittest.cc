@@ -4,11 +4,16 @@
 #include <shogun/lib/config.h>
 #include <shogun/machine/BaggingMachine.h>
 #include <shogun/ensemble/MajorityVote.h>
+#include <shogun/classifier/LDA.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/labels/BinaryLabels.h>
 #include <gtest/gtest.h>
 
-#ifdef USE_REFERENCE_COUNTING
 using namespace shogun;
+
+#ifdef USE_REFERENCE_COUNTING
 using ::testing::Return;
+using ::testing::Invoke;
 
 /** gmock REV 443 and freebsd doesn't play nicely */
 #ifdef FREEBSD
@@ -19,7 +24,6 @@ TEST(BaggingMachine, mock_train)
 {
 	using ::testing::NiceMock;
 	using ::testing::_;
-	using ::testing::InSequence;
 	using ::testing::Mock;
 	using ::testing::DefaultValue;
 
@@ -43,21 +47,78 @@ TEST(BaggingMachine, mock_train)
 	ON_CALL(features, get_num_vectors())
 		.WillByDefault(Return(100));
 
-	{
-		InSequence s;
-		for (int i = 0; i < num_bags; i++) {
-			EXPECT_CALL(mm, clone())
-				.Times(1)
-				.WillRepeatedly(Return(&mm));
-
-			EXPECT_CALL(mm, train_machine(_))
-				.Times(1)
-				.WillRepeatedly(Return(true));
-		}
-	}
+	/* every bag trains on views of its own */
+	ON_CALL(features, duplicate())
+		.WillByDefault(Invoke([]() -> CFeatures* {
+			return new NiceMock<MockCFeatures>(); }));
+	ON_CALL(labels, clone())
+		.WillByDefault(Invoke([]() -> CSGObject* {
+			CSGObject* l = new NiceMock<MockCLabels>(); SG_REF(l); return l; }));
+
+	/* bags may be trained concurrently, so clone() and train() of
+	 * different bags do not necessarily alternate */
+	EXPECT_CALL(mm, clone())
+		.Times(num_bags)
+		.WillRepeatedly(Return(&mm));
+
+	EXPECT_CALL(mm, train_machine(_))
+		.Times(num_bags)
+		.WillRepeatedly(Return(true));
 
 	bm->train();
 
 	SG_UNREF(bm);
 }
 #endif
+
+#ifdef HAVE_LAPACK
+static SGVector<float64_t> train_bags(CDenseFeatures<float64_t>* features,
+		CBinaryLabels* labels, int32_t num_threads)
+{
+	CBaggingMachine* bm = new CBaggingMachine(features, labels);
+	bm->set_machine(new CLDA());
+	bm->set_bag_size(30);
+	bm->set_num_bags(8);
+	bm->set_max_concurrent_bags(3);
+	bm->set_combination_rule(new CMajorityVote());
+	bm->parallel->set_num_threads(num_threads);
+
+	CMath::init_random(17);
+	bm->train();
+
+	CBinaryLabels* pred = bm->apply_binary(features);
+	SGVector<float64_t> result = pred->get_labels();
+	bm->parallel->set_num_threads(1);
+
+	SG_UNREF(pred);
+	SG_UNREF(bm);
+	return result;
+}
+
+TEST(BaggingMachine, parallel_train_reproducible)
+{
+	index_t num_vec = 50;
+	SGMatrix<float64_t> data(2, num_vec);
+	SGVector<float64_t> lab(num_vec);
+	for (index_t i = 0; i < num_vec; i++)
+	{
+		lab[i] = i % 2 ? 1 : -1;
+		data(0, i) = CMath::randn_double() + lab[i];
+		data(1, i) = CMath::randn_double() - lab[i];
+	}
+
+	CDenseFeatures<float64_t>* features = new CDenseFeatures<float64_t>(data);
+	CBinaryLabels* labels = new CBinaryLabels(lab);
+	SG_REF(features);
+	SG_REF(labels);
+
+	SGVector<float64_t> serial = train_bags(features, labels, 1);
+	SGVector<float64_t> parallel = train_bags(features, labels, 4);
+
+	for (index_t i = 0; i < num_vec; i++)
+		EXPECT_EQ(serial[i], parallel[i]);
+
+	SG_UNREF(labels);
+	SG_UNREF(features);
+}
+#endif /* HAVE_LAPACK */
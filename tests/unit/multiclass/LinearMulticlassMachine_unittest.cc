@@ -0,0 +1,90 @@
+#include <shogun/machine/LinearMulticlassMachine.h>
+#include <shogun/multiclass/MulticlassOneVsOneStrategy.h>
+#include <shogun/multiclass/MulticlassOneVsRestStrategy.h>
+#include <shogun/classifier/LDA.h>
+#include <shogun/features/DenseFeatures.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+#ifdef HAVE_LAPACK
+static CMulticlassLabels* train_and_apply(CMulticlassStrategy* strategy,
+		CDenseFeatures<float64_t>* features, CMulticlassLabels* labels,
+		int32_t num_threads, int32_t max_concurrent)
+{
+	CLDA* lda=new CLDA();
+	CLinearMulticlassMachine* machine=new CLinearMulticlassMachine(strategy,
+			features, lda, labels);
+	machine->parallel->set_num_threads(num_threads);
+	machine->set_max_concurrent_machines(max_concurrent);
+	machine->train();
+
+	CMulticlassLabels* pred=machine->apply_multiclass(features);
+	machine->parallel->set_num_threads(1);
+	SG_UNREF(machine);
+
+	return pred;
+}
+
+static void check_parallel_training(bool one_vs_one)
+{
+	index_t num_vec=60;
+	index_t num_class=4;
+	index_t num_feat=num_class;
+
+	SGMatrix<float64_t> matrix(num_feat, num_vec);
+	CMulticlassLabels* labels=new CMulticlassLabels(num_vec);
+	for (index_t i=0; i<num_vec; ++i)
+	{
+		index_t label=i%num_class;
+		for (index_t j=0; j<num_feat; ++j)
+			matrix(j, i)=CMath::randn_double();
+
+		matrix(label, i)+=5;
+		labels->set_label(i, label);
+	}
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(matrix);
+	SG_REF(features);
+	SG_REF(labels);
+
+	CMulticlassStrategy* serial_strategy=one_vs_one ?
+		(CMulticlassStrategy*) new CMulticlassOneVsOneStrategy() :
+		(CMulticlassStrategy*) new CMulticlassOneVsRestStrategy();
+	CMulticlassLabels* serial=train_and_apply(serial_strategy, features,
+			labels, 1, 0);
+
+	CMulticlassStrategy* parallel_strategy=one_vs_one ?
+		(CMulticlassStrategy*) new CMulticlassOneVsOneStrategy() :
+		(CMulticlassStrategy*) new CMulticlassOneVsRestStrategy();
+	CMulticlassLabels* parallel=train_and_apply(parallel_strategy, features,
+			labels, 4, 3);
+
+	EXPECT_EQ(serial->get_num_labels(), parallel->get_num_labels());
+	for (index_t i=0; i<num_vec; ++i)
+	{
+		EXPECT_EQ(serial->get_label(i), parallel->get_label(i));
+
+		SGVector<float64_t> c_serial=serial->get_multiclass_confidences(i);
+		SGVector<float64_t> c_parallel=parallel->get_multiclass_confidences(i);
+		ASSERT_EQ(c_serial.vlen, c_parallel.vlen);
+		for (index_t j=0; j<c_serial.vlen; ++j)
+			EXPECT_NEAR(c_serial[j], c_parallel[j], 1e-10);
+	}
+
+	SG_UNREF(serial);
+	SG_UNREF(parallel);
+	SG_UNREF(labels);
+	SG_UNREF(features);
+}
+
+TEST(LinearMulticlassMachineTest,parallel_train_one_vs_rest)
+{
+	check_parallel_training(false);
+}
+
+TEST(LinearMulticlassMachineTest,parallel_train_one_vs_one)
+{
+	check_parallel_training(true);
+}
+#endif /* HAVE_LAPACK */
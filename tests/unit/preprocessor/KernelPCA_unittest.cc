@@ -4,6 +4,8 @@
 #include <shogun/kernel/Kernel.h>
 
 #include <shogun/kernel/GaussianKernel.h>
+#include <shogun/kernel/LinearKernel.h>
+#include <shogun/preprocessor/PCA.h>
 #include <iostream>
 #include <shogun/lib/SGMatrix.h>
 #include <shogun/features/Features.h>
@@ -48,4 +50,146 @@ TEST(KernelPCA, DISABLED_apply_to_feature_matrix_input)
 	for (index_t i = 0; i < num_features * num_vectors; ++i)
 		EXPECT_LE(CMath::abs(embedding.matrix[i] - s * resdata[i]), 1E-6);
 }
+
+#ifdef HAVE_EIGEN3
+/* with linear kernel and all vectors used as landmarks Nystroem
+ * approximation is exact and kernel PCA is the same as linear PCA */
+TEST(KernelPCA, nystrom_linear_kernel_vs_PCA)
+{
+	const index_t num_features = 4;
+	const index_t num_vectors = 30;
+	SGMatrix<float64_t> data(num_features, num_vectors);
+	for (index_t i=0; i<num_features*num_vectors; i++)
+		data.matrix[i] = (i%num_features+1)*CMath::randn_double();
+
+	CDenseFeatures<float64_t>* feats = new CDenseFeatures<float64_t>(data.clone());
+	CDenseFeatures<float64_t>* kpca_feats = new CDenseFeatures<float64_t>(data.clone());
+	CDenseFeatures<float64_t>* pca_feats = new CDenseFeatures<float64_t>(data.clone());
+	// kernels release the features they were initialized with
+	SG_REF(feats);
+	SG_REF(kpca_feats);
+
+	SGVector<index_t> landmarks(num_vectors);
+	landmarks.range_fill();
+
+	CKernelPCA* kpca = new CKernelPCA(new CLinearKernel());
+	kpca->set_method(KPCA_NYSTROM);
+	kpca->set_landmarks(landmarks);
+	kpca->set_target_dim(2);
+	kpca->init(feats);
+	SGMatrix<float64_t> embedding = kpca->apply_to_feature_matrix(kpca_feats);
+
+	CPCA* pca = new CPCA();
+	pca->set_target_dim(2);
+	pca->init(feats);
+	SGMatrix<float64_t> expected = pca->apply_to_feature_matrix(pca_feats);
+
+	ASSERT_EQ(2, embedding.num_rows);
+	ASSERT_EQ(num_vectors, embedding.num_cols);
+	for (index_t i=0; i<2; i++)
+	{
+		// PCA orders components by ascending, kernel PCA by descending
+		// eigenvalue, allow embedding with opposite sign
+		index_t r = 1-i;
+		float64_t s = CMath::sign(embedding(i,0)*expected(r,0));
+		for (index_t j=0; j<num_vectors; j++)
+			EXPECT_NEAR(expected(r,j), s*embedding(i,j), 1e-8);
+	}
+
+	SG_UNREF(pca);
+	SG_UNREF(kpca);
+	SG_UNREF(pca_feats);
+	SG_UNREF(kpca_feats);
+	SG_UNREF(feats);
+}
+
+TEST(KernelPCA, nystrom_random_landmarks)
+{
+	const index_t num_features = 3;
+	const index_t num_vectors = 200;
+	SGMatrix<float64_t> data(num_features, num_vectors);
+	for (index_t i=0; i<num_features*num_vectors; i++)
+		data.matrix[i] = CMath::randn_double();
+
+	CDenseFeatures<float64_t>* feats = new CDenseFeatures<float64_t>(data);
+	SG_REF(feats);
+	CGaussianKernel* kernel = new CGaussianKernel();
+	kernel->set_width(2);
+	CKernelPCA* kpca = new CKernelPCA(kernel);
+	kpca->set_method(KPCA_NYSTROM);
+	kpca->set_num_landmarks(20);
+	kpca->set_target_dim(3);
+	kpca->init(feats);
+
+	EXPECT_EQ(20, kpca->get_transformation_matrix().num_rows);
+	EXPECT_EQ(3, kpca->get_transformation_matrix().num_cols);
+
+	SGMatrix<float64_t> embedding = kpca->apply_to_feature_matrix(feats);
+	EXPECT_EQ(3, embedding.num_rows);
+	EXPECT_EQ(num_vectors, embedding.num_cols);
+
+	// embedding of training vectors is centered
+	for (index_t i=0; i<3; i++)
+	{
+		float64_t sum = 0;
+		for (index_t j=0; j<num_vectors; j++)
+			sum += embedding(i,j);
+		EXPECT_NEAR(0.0, sum/num_vectors, 1e-8);
+	}
+
+	SG_UNREF(kpca);
+	SG_UNREF(feats);
+}
+/* with linear kernel kernel PCA is the same as linear PCA */
+TEST(KernelPCA, lanczos_linear_kernel_vs_PCA)
+{
+	CMath::init_random(17);
+
+	const index_t num_features = 4;
+	const index_t num_vectors = 30;
+	SGMatrix<float64_t> data(num_features, num_vectors);
+	for (index_t i=0; i<num_features*num_vectors; i++)
+		data.matrix[i] = (i%num_features+1)*CMath::randn_double();
+
+	CDenseFeatures<float64_t>* feats = new CDenseFeatures<float64_t>(data.clone());
+	CDenseFeatures<float64_t>* kpca_feats = new CDenseFeatures<float64_t>(data.clone());
+	CDenseFeatures<float64_t>* pca_feats = new CDenseFeatures<float64_t>(data.clone());
+	// kernels release the features they were initialized with
+	SG_REF(feats);
+	SG_REF(kpca_feats);
+
+	CKernelPCA* kpca = new CKernelPCA(new CLinearKernel());
+	kpca->set_method(KPCA_LANCZOS);
+	kpca->set_target_dim(2);
+	kpca->init(feats);
+
+	EXPECT_EQ(num_vectors, kpca->get_transformation_matrix().num_rows);
+	EXPECT_EQ(2, kpca->get_transformation_matrix().num_cols);
+
+	SGMatrix<float64_t> embedding = kpca->apply_to_feature_matrix(kpca_feats);
+
+	CPCA* pca = new CPCA();
+	pca->set_target_dim(2);
+	pca->init(feats);
+	SGMatrix<float64_t> expected = pca->apply_to_feature_matrix(pca_feats);
+
+	ASSERT_EQ(2, embedding.num_rows);
+	ASSERT_EQ(num_vectors, embedding.num_cols);
+	for (index_t i=0; i<2; i++)
+	{
+		// PCA orders components by ascending, kernel PCA by descending
+		// eigenvalue, allow embedding with opposite sign
+		index_t r = 1-i;
+		float64_t s = CMath::sign(embedding(i,0)*expected(r,0));
+		for (index_t j=0; j<num_vectors; j++)
+			EXPECT_NEAR(expected(r,j), s*embedding(i,j), 1e-8);
+	}
+
+	SG_UNREF(pca);
+	SG_UNREF(kpca);
+	SG_UNREF(pca_feats);
+	SG_UNREF(kpca_feats);
+	SG_UNREF(feats);
+}
+#endif // HAVE_EIGEN3
 #endif // HAVE_LAPACK
@@ -36,6 +36,7 @@
 
 #ifdef HAVE_EIGEN3
 #include <shogun/preprocessor/PCA.h>
+#include <shogun/features/streaming/StreamingDenseFeatures.h>
 
 using namespace shogun;
 
@@ -483,4 +484,109 @@ TEST(PCA, PCA_apply_to_feature_vector_methodTest)
 	SG_UNREF(pca);
 	SG_UNREF(features);
 }
+
+/** generates num_vectors vectors of dimension num_features lying in
+ * a random subspace of dimension rank, shifted by some offset
+ */
+static SGMatrix<float64_t> generate_low_rank_data(int32_t num_features,
+		int32_t num_vectors, int32_t rank)
+{
+	SGMatrix<float64_t> basis(num_features, rank);
+	for (index_t i=0; i<num_features*rank; i++)
+		basis.matrix[i] = CMath::randn_double();
+
+	SGMatrix<float64_t> data(num_features, num_vectors);
+	for (index_t j=0; j<num_vectors; j++)
+	{
+		for (index_t i=0; i<num_features; i++)
+			data(i,j) = i;
+		for (index_t r=0; r<rank; r++)
+		{
+			float64_t coefficient = (rank-r)*CMath::randn_double();
+			for (index_t i=0; i<num_features; i++)
+				data(i,j) += coefficient*basis(i,r);
+		}
+	}
+	return data;
+}
+
+/** checks that transformation matrices match up to signs of columns */
+static void compare_transformations(SGMatrix<float64_t> expected,
+		SGMatrix<float64_t> actual, float64_t epsilon)
+{
+	ASSERT_EQ(expected.num_rows, actual.num_rows);
+	ASSERT_EQ(expected.num_cols, actual.num_cols);
+	for (index_t j=0; j<expected.num_cols; j++)
+	{
+		float64_t sign = CMath::sign(expected(0,j)*actual(0,j));
+		for (index_t i=0; i<expected.num_rows; i++)
+			EXPECT_NEAR(expected(i,j), sign*actual(i,j), epsilon);
+	}
+}
+
+TEST(PCA, PCA_randomized_vs_SVD)
+{
+	SGMatrix<float64_t> data = generate_low_rank_data(20, 100, 4);
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CPCA* pca=new CPCA(SVD);
+	pca->set_target_dim(3);
+	pca->init(features);
+
+	CPCA* randomized_pca=new CPCA(RANDOMIZED);
+	randomized_pca->set_target_dim(3);
+	randomized_pca->set_oversampling(2);
+	randomized_pca->set_block_size(16);
+	randomized_pca->init(features);
+
+	SGVector<float64_t> eigenvalues=pca->get_eigenvalues();
+	SGVector<float64_t> randomized_eigenvalues=randomized_pca->get_eigenvalues();
+	EXPECT_EQ(3, randomized_eigenvalues.vlen);
+	for (index_t i=0; i<3; i++)
+		EXPECT_NEAR(eigenvalues[i], randomized_eigenvalues[i], 1e-9);
+
+	compare_transformations(pca->get_transformation_matrix(),
+			randomized_pca->get_transformation_matrix(), 1e-9);
+
+	SG_UNREF(randomized_pca);
+	SG_UNREF(pca);
+	SG_UNREF(features);
+}
+
+TEST(PCA, PCA_incremental_streaming_vs_SVD)
+{
+	SGMatrix<float64_t> data = generate_low_rank_data(10, 50, 2);
+
+	CDenseFeatures<float64_t>* features=new CDenseFeatures<float64_t>(data);
+	CPCA* pca=new CPCA(SVD);
+	pca->set_target_dim(2);
+	pca->init(features);
+
+	CStreamingDenseFeatures<float64_t>* streaming_features=
+		new CStreamingDenseFeatures<float64_t>(features);
+	SG_REF(streaming_features);
+	CPCA* incremental_pca=new CPCA();
+	incremental_pca->set_target_dim(2);
+	incremental_pca->set_block_size(7);
+	incremental_pca->init(streaming_features);
+
+	SGVector<float64_t> mean=pca->get_mean();
+	SGVector<float64_t> incremental_mean=incremental_pca->get_mean();
+	for (index_t i=0; i<mean.vlen; i++)
+		EXPECT_NEAR(mean[i], incremental_mean[i], 1e-9);
+
+	SGVector<float64_t> eigenvalues=pca->get_eigenvalues();
+	SGVector<float64_t> incremental_eigenvalues=incremental_pca->get_eigenvalues();
+	EXPECT_EQ(2, incremental_eigenvalues.vlen);
+	for (index_t i=0; i<2; i++)
+		EXPECT_NEAR(eigenvalues[i], incremental_eigenvalues[i], 1e-9);
+
+	compare_transformations(pca->get_transformation_matrix(),
+			incremental_pca->get_transformation_matrix(), 1e-9);
+
+	SG_UNREF(incremental_pca);
+	SG_UNREF(streaming_features);
+	SG_UNREF(pca);
+	SG_UNREF(features);
+}
 #endif //HAVE_EIGEN3
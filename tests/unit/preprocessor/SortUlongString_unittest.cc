@@ -0,0 +1,65 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/preprocessor/SortUlongString.h>
+#include <shogun/features/StringFeatures.h>
+#include <shogun/lib/SGStringList.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parallel.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+TEST(SortUlongString, apply_to_string_features)
+{
+	// enough strings to be split among several threads
+	const int32_t num_vec=500;
+	const int32_t max_len=50;
+
+	SGStringList<uint64_t> list(num_vec, max_len);
+	SGStringList<uint64_t> sorted(num_vec, max_len);
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		int32_t len=CMath::random(0, max_len);
+		list.strings[i]=SGString<uint64_t>(len);
+		sorted.strings[i]=SGString<uint64_t>(len);
+		for (int32_t j=0; j<len; j++)
+		{
+			list.strings[i].string[j]=CMath::random(0, 1000000);
+			sorted.strings[i].string[j]=list.strings[i].string[j];
+		}
+		CMath::qsort(sorted.strings[i].string, len);
+	}
+
+	CStringFeatures<uint64_t>* feats=new CStringFeatures<uint64_t>(list, RAWBYTE);
+	SG_REF(feats);
+	CSortUlongString* preproc=new CSortUlongString();
+	preproc->parallel->set_num_threads(4);
+	EXPECT_TRUE(preproc->init(feats));
+
+	// init does not change the features
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		SGVector<uint64_t> vec=feats->get_feature_vector(i);
+		for (int32_t j=0; j<vec.vlen; j++)
+			EXPECT_EQ(vec[j], list.strings[i].string[j]);
+	}
+
+	feats->add_preprocessor(preproc);
+	EXPECT_TRUE(feats->apply_preprocessor());
+	EXPECT_EQ(feats->get_feature_type(), F_ULONG);
+
+	for (int32_t i=0; i<num_vec; i++)
+	{
+		SGVector<uint64_t> vec=feats->get_feature_vector(i);
+		EXPECT_EQ(vec.vlen, sorted.strings[i].slen);
+		for (int32_t j=0; j<vec.vlen; j++)
+			EXPECT_EQ(vec[j], sorted.strings[i].string[j]);
+	}
+
+	SG_UNREF(feats);
+}
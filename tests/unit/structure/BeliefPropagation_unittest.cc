@@ -10,6 +10,8 @@
 #include <shogun/structure/Factor.h>
 #include <shogun/labels/FactorGraphLabels.h>
 #include <shogun/structure/MAPInference.h>
+#include <shogun/structure/BeliefPropagation.h>
+#include <shogun/features/FactorGraphFeatures.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -36,6 +38,69 @@ float64_t hamming_loss(SGVector<int32_t> y_truth, SGVector<int32_t> y_pred)
 	return (loss / y_truth.vlen);
 }
 
+// N x N grid of binary variables with random energies, with all edges
+// of the grid if loopy, otherwise only with a spanning tree of it. With
+// dominant unaries every variable prefers one state by more than its (at
+// most four) pairwise factors can change, so the MAP assignment is known
+// and max-product finds it on the loopy grid as well.
+CFactorGraph* random_grid(int32_t N, bool loopy, bool dominant_unaries=false)
+{
+	SGVector<int32_t> card(2);
+	card[0] = 2;
+	card[1] = 2;
+	SGVector<float64_t> w;
+	CTableFactorType* factortype = new CTableFactorType(0, card, w);
+	SG_REF(factortype);
+
+	SGVector<int32_t> card1(1);
+	card1[0] = 2;
+	SGVector<float64_t> w1;
+	CTableFactorType* factortype1 = new CTableFactorType(1, card1, w1);
+	SG_REF(factortype1);
+
+	SGVector<int32_t> vc(N*N);
+	SGVector<int32_t>::fill_vector(vc.vector, vc.vlen, 2);
+	CFactorGraph* fg = new CFactorGraph(vc);
+	SG_REF(fg);
+
+	for (int32_t y = 0; y < N; ++y)
+		for (int32_t x = 0; x < N; ++x)
+		{
+			SGVector<float64_t> data(2);
+			data[0] = CMath::random(0.0, 1.0);
+			data[1] = CMath::random(0.0, 1.0);
+			if (dominant_unaries)
+				data[CMath::random(0, 1)] += 4.0;
+
+			SGVector<int32_t> var_index(1);
+			var_index[0] = grid_to_index(x,y,N);
+			fg->add_factor(new CFactor(factortype1, var_index, data));
+
+			for (int32_t dir = 0; dir < 2; ++dir)
+			{
+				if ((dir == 0 && x == 0) || (dir == 1 && (y == 0 || (x > 0 && !loopy))))
+					continue;
+
+				SGVector<float64_t> data2(4);
+				for (int32_t di = 0; di < 4; ++di)
+					data2[di] = CMath::random(0.0, 1.0);
+
+				SGVector<int32_t> var_index2(2);
+				var_index2[0] = grid_to_index(x,y,N);
+				var_index2[1] = dir == 0 ? grid_to_index(x-1,y,N) : grid_to_index(x,y-1,N);
+				fg->add_factor(new CFactor(factortype, var_index2, data2));
+			}
+		}
+
+	SG_UNREF(factortype);
+	SG_UNREF(factortype1);
+
+	fg->compute_energies();
+	fg->connect_components();
+
+	return fg;
+}
+
 TEST(BeliefPropagation, tree_max_product_string)
 {
 	// ftype
@@ -419,3 +484,199 @@ TEST(BeliefPropagation, tree_max_product_multi_states)
 	SG_UNREF(factortype3);
 }
 
+
+TEST(BeliefPropagation, loopy_max_product_tree)
+{
+	CMath::init_random(17);
+	for (int32_t rani = 0; rani < 10; rani++)
+	{
+		CFactorGraph* fg = random_grid(4, false);
+		EXPECT_TRUE(fg->is_tree_graph());
+
+		CMAPInference tree_infer(fg, TREE_MAX_PROD);
+		tree_infer.inference();
+
+		// max-product is exact on trees whatever the schedule
+		CMAPInference loopy_infer(fg, LOOPY_MAX_PROD);
+		loopy_infer.inference();
+
+		CFactorGraphObservation* fg_observ = loopy_infer.get_structured_outputs();
+		SGVector<int32_t> assignment = fg_observ->get_data();
+
+		EXPECT_NEAR(tree_infer.get_energy(), loopy_infer.get_energy(), 1E-10);
+		EXPECT_NEAR(fg->evaluate_energy(assignment), loopy_infer.get_energy(), 1E-10);
+
+		SG_UNREF(fg_observ);
+		SG_UNREF(fg);
+	}
+}
+
+TEST(BeliefPropagation, loopy_max_product_grid)
+{
+	CMath::init_random(17);
+	for (int32_t rani = 0; rani < 10; rani++)
+	{
+		CFactorGraph* fg = random_grid(3, true, true);
+		EXPECT_FALSE(fg->is_acyclic_graph());
+
+		// find minimum energy by exhaustive search
+		SGVector<int32_t> test_var(9);
+		float64_t min_energy = std::numeric_limits<float64_t>::infinity();
+		for (int32_t state = 0; state < (1 << 9); ++state)
+		{
+			for (int32_t vi = 0; vi < 9; ++vi)
+				test_var[vi] = (state >> vi) & 1;
+
+			min_energy = CMath::min(min_energy, fg->evaluate_energy(test_var));
+		}
+
+		CMAPInference infer_met(fg, LOOPY_MAX_PROD);
+		infer_met.inference();
+
+		CFactorGraphObservation* fg_observ = infer_met.get_structured_outputs();
+		SGVector<int32_t> assignment = fg_observ->get_data();
+
+		EXPECT_NEAR(fg->evaluate_energy(assignment), infer_met.get_energy(), 1E-10);
+		EXPECT_NEAR(min_energy, infer_met.get_energy(), 1E-10);
+
+		SG_UNREF(fg_observ);
+		SG_UNREF(fg);
+	}
+}
+
+TEST(BeliefPropagation, loopy_max_product_parallel_schedule)
+{
+	CMath::init_random(17);
+	for (int32_t rani = 0; rani < 10; rani++)
+	{
+		CFactorGraph* fg = random_grid(4, rani % 2 == 1, true);
+
+		CMAPInference infer_met(fg, LOOPY_MAX_PROD);
+		infer_met.inference();
+
+		CLoopyMaxProduct parallel_bp(fg);
+		parallel_bp.set_schedule(PARALLEL_SCHEDULE);
+		EXPECT_EQ(parallel_bp.get_schedule(), PARALLEL_SCHEDULE);
+
+		SGVector<int32_t> assignment(fg->get_num_vars());
+		float64_t energy = parallel_bp.inference(assignment);
+
+		EXPECT_NEAR(infer_met.get_energy(), energy, 1E-10);
+		EXPECT_NEAR(fg->evaluate_energy(assignment), energy, 1E-10);
+
+		SG_UNREF(fg);
+	}
+}
+
+TEST(BeliefPropagation, loopy_max_product_damping)
+{
+	CMath::init_random(17);
+	for (int32_t rani = 0; rani < 10; rani++)
+	{
+		CFactorGraph* fg = random_grid(4, false);
+
+		CMAPInference tree_infer(fg, TREE_MAX_PROD);
+		tree_infer.inference();
+
+		// damped messages converge to the same fixed point, only slower
+		CLoopyMaxProduct damped_bp(fg);
+		damped_bp.set_schedule(PARALLEL_SCHEDULE);
+		damped_bp.set_damping(0.5);
+		damped_bp.set_max_iterations(1000);
+		EXPECT_EQ(damped_bp.get_damping(), 0.5);
+
+		SGVector<int32_t> assignment(fg->get_num_vars());
+		float64_t energy = damped_bp.inference(assignment);
+
+		EXPECT_NEAR(tree_infer.get_energy(), energy, 1E-8);
+		EXPECT_NEAR(fg->evaluate_energy(assignment), energy, 1E-10);
+
+		SG_UNREF(fg);
+	}
+}
+
+TEST(BeliefPropagation, batch_inference)
+{
+	CMath::init_random(17);
+	int32_t num_samples = 8;
+	CFactorGraphFeatures* samples = new CFactorGraphFeatures(num_samples);
+	SG_REF(samples);
+
+	for (int32_t i = 0; i < num_samples; ++i)
+	{
+		CFactorGraph* fg = random_grid(3, false);
+		samples->add_sample(fg);
+		SG_UNREF(fg);
+	}
+
+	CFactorGraphLabels* outputs = CMAPInference::batch_inference(samples, TREE_MAX_PROD);
+	EXPECT_EQ(outputs->get_num_labels(), num_samples);
+
+	for (int32_t i = 0; i < num_samples; ++i)
+	{
+		CFactorGraph* fg = samples->get_sample(i);
+		CMAPInference infer_met(fg, TREE_MAX_PROD);
+		infer_met.inference();
+
+		CFactorGraphObservation* fg_observ = infer_met.get_structured_outputs();
+		CFactorGraphObservation* batch_observ = CFactorGraphObservation::obtain_from_generic(
+			outputs->get_label(i));
+
+		SGVector<int32_t> assignment = fg_observ->get_data();
+		SGVector<int32_t> batch_assignment = batch_observ->get_data();
+		for (int32_t vi = 0; vi < assignment.size(); ++vi)
+			EXPECT_EQ(assignment[vi], batch_assignment[vi]);
+
+		SG_UNREF(batch_observ);
+		SG_UNREF(fg_observ);
+		SG_UNREF(fg);
+	}
+
+	SG_UNREF(outputs);
+	SG_UNREF(samples);
+}
+
+TEST(BeliefPropagation, batch_inference_loopy)
+{
+	CMath::init_random(17);
+	int32_t num_samples = 8;
+	CFactorGraphFeatures* samples = new CFactorGraphFeatures(num_samples);
+	SG_REF(samples);
+
+	for (int32_t i = 0; i < num_samples; ++i)
+	{
+		CFactorGraph* fg = random_grid(3, true);
+		samples->add_sample(fg);
+		SG_UNREF(fg);
+	}
+
+	// tree max-product can't handle the cycles, which must be reported
+	// as an error instead of terminating inside the parallel region
+	EXPECT_THROW(CMAPInference::batch_inference(samples, TREE_MAX_PROD), ShogunException);
+
+	CFactorGraphLabels* outputs = CMAPInference::batch_inference(samples, LOOPY_MAX_PROD);
+	EXPECT_EQ(outputs->get_num_labels(), num_samples);
+
+	for (int32_t i = 0; i < num_samples; ++i)
+	{
+		CFactorGraph* fg = samples->get_sample(i);
+		CMAPInference infer_met(fg, LOOPY_MAX_PROD);
+		infer_met.inference();
+
+		CFactorGraphObservation* fg_observ = infer_met.get_structured_outputs();
+		CFactorGraphObservation* batch_observ = CFactorGraphObservation::obtain_from_generic(
+			outputs->get_label(i));
+
+		SGVector<int32_t> assignment = fg_observ->get_data();
+		SGVector<int32_t> batch_assignment = batch_observ->get_data();
+		for (int32_t vi = 0; vi < assignment.size(); ++vi)
+			EXPECT_EQ(assignment[vi], batch_assignment[vi]);
+
+		SG_UNREF(batch_observ);
+		SG_UNREF(fg_observ);
+		SG_UNREF(fg);
+	}
+
+	SG_UNREF(outputs);
+	SG_UNREF(samples);
+}
@@ -0,0 +1,327 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/structure/DynProg.h>
+#include <shogun/structure/PlifMatrix.h>
+#include <shogun/structure/PlifBase.h>
+#include <shogun/lib/DynamicObjectArray.h>
+#include <shogun/lib/SGNDArray.h>
+#include <shogun/mathematics/Math.h>
+#include <shogun/base/Parallel.h>
+#include <shogun/base/init.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+const int32_t num_states=3;
+
+// reports to use svm values, which keeps compute_nbest_paths from
+// tabulating the penalties of the wrapped Plif, so decoding takes the
+// lookup_penalty path with exactly the same penalties
+class CSVMPlifWrapper : public CPlifBase
+{
+public:
+	CSVMPlifWrapper(CPlifBase* plif) : CPlifBase(), m_plif(plif) {}
+
+	virtual float64_t lookup_penalty(float64_t p_value, float64_t* svm_values) const
+	{
+		return m_plif->lookup_penalty(p_value, svm_values);
+	}
+
+	virtual float64_t lookup_penalty(int32_t p_value, float64_t* svm_values) const
+	{
+		return m_plif->lookup_penalty(p_value, svm_values);
+	}
+
+	virtual void penalty_clear_derivative() { m_plif->penalty_clear_derivative(); }
+
+	virtual void penalty_add_derivative(float64_t p_value, float64_t* svm_values, float64_t factor)
+	{
+		m_plif->penalty_add_derivative(p_value, svm_values, factor);
+	}
+
+	virtual float64_t get_max_value() const { return m_plif->get_max_value(); }
+	virtual float64_t get_min_value() const { return m_plif->get_min_value(); }
+
+	virtual void get_used_svms(int32_t* num_svms, int32_t* svm_ids)
+	{
+		m_plif->get_used_svms(num_svms, svm_ids);
+	}
+
+	virtual bool uses_svm_values() const { return true; }
+	virtual int32_t get_max_id() const { return m_plif->get_max_id(); }
+	virtual void list_plif() const { m_plif->list_plif(); }
+	virtual const char* get_name() const { return "SVMPlifWrapper"; }
+
+private:
+	CPlifBase* m_plif;
+};
+
+// two length Plifs: self transitions share the first, transitions to a
+// higher state share the second, transitions to a lower state have none
+static CPlifMatrix* create_plif_matrix()
+{
+	const int32_t num_limits=4;
+	CPlifMatrix* pm=new CPlifMatrix();
+	SG_REF(pm);
+	pm->create_plifs(2, num_limits);
+
+	for (int32_t i=0; i<2; i++)
+	{
+		CPlif* plif=pm->get_PEN()[i];
+		SGVector<float64_t> limits(num_limits);
+		SGVector<float64_t> penalties(num_limits);
+		for (int32_t k=0; k<num_limits; k++)
+		{
+			limits[k]=1+k*(5+5*i);
+			penalties[k]=CMath::random(-1.0, 1.0);
+		}
+		plif->set_plif_limits(limits);
+		plif->set_plif_penalty(penalties);
+		plif->set_min_value(1);
+		plif->set_max_value(limits[num_limits-1]);
+	}
+
+	index_t* dims=SG_MALLOC(index_t, 3);
+	dims[0]=num_states;
+	dims[1]=num_states;
+	dims[2]=1;
+	SGNDArray<float64_t> plif_ids(dims, 3);
+	for (int32_t from=0; from<num_states; from++)
+	{
+		for (int32_t to=0; to<num_states; to++)
+		{
+			float64_t id=0;
+			if (from==to)
+				id=1;
+			else if (from<to)
+				id=2;
+			plif_ids.array[to+num_states*from]=id;
+		}
+	}
+	pm->compute_plif_matrix(plif_ids);
+
+	SGMatrix<int32_t> state_signals(1, num_states);
+	state_signals.zero();
+	pm->compute_signal_plifs(state_signals);
+
+	return pm;
+}
+
+static CDynProg* create_model(CPlifMatrix* pm, int32_t seq_len)
+{
+	CDynProg* dyn_prog=new CDynProg();
+	SG_REF(dyn_prog);
+	dyn_prog->set_num_states(num_states);
+	// the look-back of transitions without Plif goes back to the start
+	dyn_prog->long_transition_settings(false, 1000, 0);
+
+	SGVector<int32_t> pos(seq_len);
+	for (int32_t i=0; i<seq_len; i++)
+		pos[i]=3*i+CMath::random(0, 2);
+	dyn_prog->set_pos(pos);
+
+	SGVector<char> genestr(pos[seq_len-1]+1);
+	SGVector<char>::fill_vector(genestr.vector, genestr.vlen, 'a');
+	dyn_prog->set_gene_string(genestr);
+	dyn_prog->init_content_svm_value_array(dyn_prog->get_num_svms());
+
+	SGVector<float64_t> p(num_states);
+	SGVector<float64_t> q(num_states);
+	for (int32_t i=0; i<num_states; i++)
+	{
+		p[i]=CMath::random(-1.0, 1.0);
+		q[i]=CMath::random(-1.0, 1.0);
+	}
+	dyn_prog->set_p_vector(p);
+	dyn_prog->set_q_vector(q);
+
+	// all transitions as (from, to, score), sorted by target state
+	SGMatrix<float64_t> a_trans(num_states*num_states, 3);
+	for (int32_t to=0; to<num_states; to++)
+	{
+		for (int32_t from=0; from<num_states; from++)
+		{
+			int32_t i=from+num_states*to;
+			a_trans(i, 0)=from;
+			a_trans(i, 1)=to;
+			a_trans(i, 2)=CMath::random(-1.0, 1.0);
+		}
+	}
+	dyn_prog->set_a_trans_matrix(a_trans);
+
+	SGMatrix<int32_t> orf_info(num_states, 2);
+	orf_info.set_const(-1);
+	dyn_prog->set_orf_info(orf_info);
+
+	index_t* dims=SG_MALLOC(index_t, 3);
+	dims[0]=num_states;
+	dims[1]=seq_len;
+	dims[2]=1;
+	SGNDArray<float64_t> observations(dims, 3);
+	for (int32_t i=0; i<num_states*seq_len; i++)
+		observations.array[i]=CMath::random(-1.0, 1.0);
+	dyn_prog->set_observation_matrix(observations);
+
+	dyn_prog->set_plif_matrices(pm);
+
+	return dyn_prog;
+}
+
+static void expect_equal_paths(CDynProg* dyn_prog, SGVector<float64_t> scores,
+		SGMatrix<int32_t> states, SGMatrix<int32_t> positions)
+{
+	SGVector<float64_t> other_scores=dyn_prog->get_scores();
+	SGMatrix<int32_t> other_states=dyn_prog->get_states();
+	SGMatrix<int32_t> other_positions=dyn_prog->get_positions();
+
+	ASSERT_EQ(scores.vlen, other_scores.vlen);
+	ASSERT_EQ(states.num_rows, other_states.num_rows);
+	ASSERT_EQ(states.num_cols, other_states.num_cols);
+
+	for (int32_t i=0; i<scores.vlen; i++)
+		EXPECT_NEAR(scores[i], other_scores[i], 1E-12);
+
+	for (int32_t i=0; i<states.num_rows*states.num_cols; i++)
+	{
+		EXPECT_EQ(states.matrix[i], other_states.matrix[i]);
+		EXPECT_EQ(positions.matrix[i], other_positions.matrix[i]);
+	}
+}
+
+static void decode_with_and_without_tables(int16_t nbest)
+{
+	CMath::init_random(17);
+	CPlifMatrix* pm=create_plif_matrix();
+
+	for (int32_t run=0; run<5; run++)
+	{
+		CDynProg* dyn_prog=create_model(pm, 40+10*run);
+
+		dyn_prog->compute_nbest_paths(1, false, nbest, false, false);
+		SGVector<float64_t> scores=dyn_prog->get_scores();
+		SGMatrix<int32_t> states=dyn_prog->get_states();
+		SGMatrix<int32_t> positions=dyn_prog->get_positions();
+
+		EXPECT_EQ(scores.vlen, nbest);
+		EXPECT_TRUE(CMath::is_finite(scores[0]));
+		for (int32_t k=1; k<nbest; k++)
+			EXPECT_GE(scores[k-1], scores[k]);
+
+		// same model, but no Plif can be tabulated
+		CPlifBase** plif_matrix=pm->get_plif_matrix();
+		CPlifBase* plifs[num_states*num_states];
+		for (int32_t i=0; i<num_states*num_states; i++)
+		{
+			plifs[i]=plif_matrix[i];
+			if (plifs[i])
+				plif_matrix[i]=new CSVMPlifWrapper(plifs[i]);
+		}
+
+		dyn_prog->compute_nbest_paths(1, false, nbest, false, false);
+		expect_equal_paths(dyn_prog, scores, states, positions);
+
+		for (int32_t i=0; i<num_states*num_states; i++)
+		{
+			if (plifs[i])
+				delete plif_matrix[i];
+			plif_matrix[i]=plifs[i];
+		}
+
+		SG_UNREF(dyn_prog);
+	}
+
+	SG_UNREF(pm);
+}
+
+TEST(DynProg, best_path_penalty_tables)
+{
+	decode_with_and_without_tables(1);
+}
+
+TEST(DynProg, nbest_paths_penalty_tables)
+{
+	decode_with_and_without_tables(3);
+}
+
+TEST(DynProg, nbest_paths_first_is_best_path)
+{
+	CMath::init_random(17);
+	CPlifMatrix* pm=create_plif_matrix();
+	CDynProg* dyn_prog=create_model(pm, 60);
+
+	dyn_prog->compute_nbest_paths(1, false, 1, false, false);
+	SGVector<float64_t> scores=dyn_prog->get_scores();
+	SGMatrix<int32_t> states=dyn_prog->get_states();
+	SGMatrix<int32_t> positions=dyn_prog->get_positions();
+
+	dyn_prog->compute_nbest_paths(1, false, 2, false, false);
+	SGVector<float64_t> nbest_scores=dyn_prog->get_scores();
+	SGMatrix<int32_t> nbest_states=dyn_prog->get_states();
+	SGMatrix<int32_t> nbest_positions=dyn_prog->get_positions();
+
+	// paths are stored one after the other
+	EXPECT_NEAR(scores[0], nbest_scores[0], 1E-12);
+	for (int32_t i=0; i<states.num_cols; i++)
+	{
+		EXPECT_EQ(states.matrix[i], nbest_states.matrix[i]);
+		EXPECT_EQ(positions.matrix[i], nbest_positions.matrix[i]);
+	}
+
+	SG_UNREF(dyn_prog);
+	SG_UNREF(pm);
+}
+
+TEST(DynProg, compute_nbest_paths_batch)
+{
+	CMath::init_random(17);
+	CPlifMatrix* pm=create_plif_matrix();
+
+	const int32_t num_seqs=6;
+	CDynamicObjectArray* dyn_progs=new CDynamicObjectArray();
+	SG_REF(dyn_progs);
+	for (int32_t i=0; i<num_seqs; i++)
+	{
+		CDynProg* dyn_prog=create_model(pm, 20+15*i);
+		dyn_progs->push_back(dyn_prog);
+		SG_UNREF(dyn_prog);
+	}
+
+	Parallel* parallel=get_global_parallel();
+	int32_t num_threads=parallel->get_num_threads();
+	parallel->set_num_threads(4);
+
+	for (int16_t nbest=1; nbest<=2; nbest++)
+	{
+		CDynProg::compute_nbest_paths_batch(dyn_progs, 1, false, nbest, false);
+
+		for (int32_t i=0; i<num_seqs; i++)
+		{
+			CDynProg* dyn_prog=(CDynProg*) dyn_progs->get_element(i);
+			SGVector<float64_t> scores=dyn_prog->get_scores();
+			SGMatrix<int32_t> states=dyn_prog->get_states();
+			SGMatrix<int32_t> positions=dyn_prog->get_positions();
+			EXPECT_EQ(scores.vlen, nbest);
+
+			dyn_prog->compute_nbest_paths(1, false, nbest, false, false);
+			expect_equal_paths(dyn_prog, scores, states, positions);
+			SG_UNREF(dyn_prog);
+		}
+	}
+
+	// errors of single sequences are raised by the batch call
+	CDynProg* dyn_prog=(CDynProg*) dyn_progs->get_element(num_seqs/2);
+	dyn_prog->long_transition_settings(true, 1000, 0);
+	EXPECT_THROW(CDynProg::compute_nbest_paths_batch(dyn_progs, 1, false, 2, false),
+			ShogunException);
+	SG_UNREF(dyn_prog);
+
+	parallel->set_num_threads(num_threads);
+	SG_UNREF(parallel);
+	SG_UNREF(dyn_progs);
+	SG_UNREF(pm);
+}
@@ -0,0 +1,64 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ */
+
+#include <shogun/structure/HMSVMModel.h>
+#include <shogun/structure/DualLibQPBMSOSVM.h>
+#include <shogun/structure/StateModel.h>
+#include <shogun/structure/StateModelTypes.h>
+#include <shogun/features/MatrixFeatures.h>
+#include <shogun/structure/SequenceLabels.h>
+#include <shogun/base/Parallel.h>
+#include <gtest/gtest.h>
+
+using namespace shogun;
+
+TEST(HMSVMModel, viterbi_weights_after_training)
+{
+	float64_t features_dat[] = {0,1,1, 2,1,2, 0,1,0, 0,2,2};
+	SGMatrix<float64_t> features_mat(features_dat,1,12,false);
+	CMatrixFeatures<float64_t>* features = new CMatrixFeatures<float64_t>(features_mat,3,4);
+
+	int32_t labels_dat[] = {0,0,0, 1,1,1, 0,0,0, 1,1,1};
+	SGVector<int32_t> labels_vec(labels_dat,12,false);
+	CSequenceLabels* labels = new CSequenceLabels(labels_vec,3,4,2);
+
+	int32_t num_obs = 3;
+	CHMSVMModel* model = new CHMSVMModel(features, labels, SMT_TWO_STATE, num_obs);
+	SG_REF(model);
+	CDualLibQPBMSOSVM* sosvm = new CDualLibQPBMSOSVM(model, labels, 5000);
+	SG_REF(sosvm);
+	// loss-augmented inference runs concurrently
+	sosvm->parallel->set_num_threads(2);
+	sosvm->train();
+
+	// decoding with the learnt w sets the weights returned by the getters
+	CStructuredLabels* out = sosvm->apply_structured();
+	SG_UNREF(out);
+
+	SGVector<float64_t> w = sosvm->get_w();
+	CStateModel* state_model = model->get_state_model();
+	int32_t S = state_model->get_num_states();
+
+	SGMatrix<float64_t> transmission_weights(S,S);
+	state_model->reshape_transmission_params(transmission_weights, w);
+	SGMatrix<float64_t> model_transmission_weights = model->get_transmission_weights();
+	ASSERT_EQ(model_transmission_weights.num_rows, S);
+	ASSERT_EQ(model_transmission_weights.num_cols, S);
+	for (int32_t i = 0; i < S*S; ++i)
+		EXPECT_EQ(model_transmission_weights[i], transmission_weights[i]);
+
+	SGVector<float64_t> emission_weights(S*num_obs);
+	state_model->reshape_emission_params(emission_weights, w, 1, num_obs);
+	SGVector<float64_t> model_emission_weights = model->get_emission_weights();
+	ASSERT_EQ(model_emission_weights.vlen, S*num_obs);
+	for (int32_t i = 0; i < S*num_obs; ++i)
+		EXPECT_EQ(model_emission_weights[i], emission_weights[i]);
+
+	SG_UNREF(state_model);
+	SG_UNREF(sosvm);
+	SG_UNREF(model);
+}
@@ -9,6 +9,10 @@
 #include <shogun/labels/FactorGraphLabels.h>
 #include <shogun/structure/StochasticSOSVM.h>
 #include <shogun/structure/SOSVMHelper.h>
+#include <shogun/structure/MulticlassModel.h>
+#include <shogun/structure/MulticlassSOLabels.h>
+#include <shogun/features/DenseFeatures.h>
+#include <shogun/mathematics/Math.h>
 #include <gtest/gtest.h>
 
 using namespace shogun;
@@ -93,3 +97,44 @@ TEST(SOSVM, sgd_check_w_helper)
 	SG_UNREF(instances);
 	SG_UNREF(factortype);
 }
+
+TEST(SOSVM, risk_multithreaded)
+{
+	int32_t num_samples = 50;
+	int32_t num_feats = 3;
+	int32_t num_classes = 4;
+
+	SGMatrix<float64_t> feats(num_feats, num_samples);
+	SGVector<float64_t> labs(num_samples);
+	for (int32_t i = 0; i < num_samples; ++i)
+	{
+		labs[i] = i % num_classes;
+		for (int32_t j = 0; j < num_feats; ++j)
+			feats(j,i) = CMath::random(-1.0, 1.0) + labs[i];
+	}
+
+	CDenseFeatures<float64_t>* features = new CDenseFeatures<float64_t>(feats);
+	CMulticlassSOLabels* labels = new CMulticlassSOLabels(labs);
+	CMulticlassModel* model = new CMulticlassModel(features, labels);
+	CStochasticSOSVM* sosvm = new CStochasticSOSVM(model, labels);
+	SG_REF(sosvm);
+
+	int32_t dim = model->get_dim();
+	SGVector<float64_t> w(dim);
+	for (int32_t i = 0; i < dim; ++i)
+		w[i] = CMath::random(-1.0, 1.0);
+
+	SGVector<float64_t> subgrad(dim);
+	sosvm->parallel->set_num_threads(1);
+	float64_t risk = sosvm->risk(subgrad.vector, w.vector);
+
+	SGVector<float64_t> subgrad_mt(dim);
+	sosvm->parallel->set_num_threads(4);
+	float64_t risk_mt = sosvm->risk(subgrad_mt.vector, w.vector);
+
+	EXPECT_NEAR(risk, risk_mt, 1E-10);
+	for (int32_t i = 0; i < dim; ++i)
+		EXPECT_NEAR(subgrad[i], subgrad_mt[i], 1E-10);
+
+	SG_UNREF(sosvm);
+}